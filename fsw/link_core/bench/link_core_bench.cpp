@@ -0,0 +1,337 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Measure the link core library's per-frame costs
+**
+**  Notes:
+**    1. Each benchmark reports the library's heap allocations per iteration
+**       in allocs_per_iter. The library is meant to run in the radio tasks'
+**       frame loops so anything but 0 is a regression. The count comes from
+**       wrapping malloc at link time (see CMakeLists.txt) and is only
+**       reported on Linux.
+**    2. Buffers are set up before the timed loops and the inputs don't
+**       depend on time or random seeds so runs can be compared.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "lora_frame.h"
+#include "lora_toa.h"
+#include "pkt_map.h"
+}
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define BENCH_PKT_SIZE    128   /* Same as LORA_DEMO_PACKET_SIZE */
+#define BENCH_RADIO_CNT     4
+
+
+/*****************************/
+/** Allocation Counting     **/
+/*****************************/
+
+static uint64_t AllocCnt = 0;
+
+#ifdef LINK_CORE_BENCH_WRAP_MALLOC
+
+extern "C" {
+
+void *__real_malloc(size_t Size);
+void *__real_calloc(size_t Cnt, size_t Size);
+void *__real_realloc(void *Ptr, size_t Size);
+
+void *__wrap_malloc(size_t Size)
+{
+   AllocCnt++;
+   return __real_malloc(Size);
+}
+
+void *__wrap_calloc(size_t Cnt, size_t Size)
+{
+   AllocCnt++;
+   return __real_calloc(Cnt, Size);
+}
+
+void *__wrap_realloc(void *Ptr, size_t Size)
+{
+   AllocCnt++;
+   return __real_realloc(Ptr, Size);
+}
+
+} /* extern "C" */
+
+#endif
+
+
+/******************************************************************************
+** Function: ReportAllocs
+**
+*/
+static void ReportAllocs(benchmark::State &State, uint64_t StartAllocCnt)
+{
+
+#ifdef LINK_CORE_BENCH_WRAP_MALLOC
+   State.counters["allocs_per_iter"] = benchmark::Counter((double)(AllocCnt - StartAllocCnt),
+                                                          benchmark::Counter::kAvgIterations);
+#else
+   (void)State;
+   (void)StartAllocCnt;
+#endif
+
+} /* End ReportAllocs() */
+
+
+/******************************************************************************
+** Function: BM_FrameEncode
+**
+** Encode a header and copy in a payload of range(0) bytes. range(1) selects
+** the hop mask field.
+**
+*/
+static void BM_FrameEncode(benchmark::State &State)
+{
+
+   uint8_t  Frame[LORA_FRAME_MAX_LEN];
+   uint8_t  Payload[LORA_FRAME_MAX_LEN];
+   uint16_t PayloadLen = (uint16_t)State.range(0);
+   uint16_t HdrLen;
+   LORA_FRAME_Hdr_t Hdr;
+   uint64_t StartAllocCnt = AllocCnt;
+
+   memset(Payload, 0xA5, sizeof(Payload));
+   Hdr.Type    = LORA_FRAME_TYPE_FILE_DATA;
+   Hdr.Flags   = State.range(1) ? LORA_FRAME_FLAG_HOP_MASK : 0;
+   Hdr.Seq     = 0;
+   Hdr.HopMask = 0x0F0F0F0F;
+
+   for (auto _ : State)
+   {
+      Hdr.Seq++;
+      HdrLen = LORA_FRAME_EncodeHdr(Frame, &Hdr);
+      memcpy(&Frame[HdrLen], Payload, PayloadLen);
+      benchmark::DoNotOptimize(Frame);
+      benchmark::ClobberMemory();
+   }
+
+   State.SetItemsProcessed(State.iterations());
+   State.SetBytesProcessed(State.iterations()*PayloadLen);
+   ReportAllocs(State, StartAllocCnt);
+
+} /* End BM_FrameEncode() */
+BENCHMARK(BM_FrameEncode)->ArgsProduct({{0, BENCH_PKT_SIZE, LORA_FRAME_MAX_LEN-LORA_FRAME_MAX_HDR_LEN}, {0, 1}});
+
+
+/******************************************************************************
+** Function: BM_FrameDecode
+**
+** Decode a header and copy out a payload of range(0) bytes. range(1) selects
+** the hop mask field.
+**
+*/
+static void BM_FrameDecode(benchmark::State &State)
+{
+
+   uint8_t  Frame[LORA_FRAME_MAX_LEN];
+   uint8_t  Payload[LORA_FRAME_MAX_LEN];
+   uint16_t PayloadLen = (uint16_t)State.range(0);
+   uint16_t FrameLen;
+   uint16_t HdrLen;
+   LORA_FRAME_Hdr_t Hdr;
+   uint64_t StartAllocCnt = AllocCnt;
+
+   Hdr.Type    = LORA_FRAME_TYPE_FILE_DATA;
+   Hdr.Flags   = State.range(1) ? LORA_FRAME_FLAG_HOP_MASK : 0;
+   Hdr.Seq     = 1234;
+   Hdr.HopMask = 0x0F0F0F0F;
+   FrameLen = LORA_FRAME_EncodeHdr(Frame, &Hdr) + PayloadLen;
+   memset(&Frame[FrameLen-PayloadLen], 0xA5, PayloadLen);
+
+   for (auto _ : State)
+   {
+      benchmark::DoNotOptimize(Frame);
+      HdrLen = LORA_FRAME_DecodeHdr(Frame, FrameLen, &Hdr);
+      memcpy(Payload, &Frame[HdrLen], FrameLen - HdrLen);
+      benchmark::DoNotOptimize(Hdr);
+      benchmark::DoNotOptimize(Payload);
+   }
+
+   State.SetItemsProcessed(State.iterations());
+   State.SetBytesProcessed(State.iterations()*PayloadLen);
+   ReportAllocs(State, StartAllocCnt);
+
+} /* End BM_FrameDecode() */
+BENCHMARK(BM_FrameDecode)->ArgsProduct({{0, BENCH_PKT_SIZE, LORA_FRAME_MAX_LEN-LORA_FRAME_MAX_HDR_LEN}, {0, 1}});
+
+
+/******************************************************************************
+** Function: BM_Reassemble
+**
+** Reassemble a range(0) packet transfer striped over BENCH_RADIO_CNT radios
+** on the same channel so every packet arrives once per radio, the way the
+** striped receive does: decode, check the packet map, copy the first copy
+** into place and drop the others.
+**
+** Notes:
+**   1. Each iteration is one whole transfer. Items are received frames and
+**      bytes are reassembled file bytes.
+**
+*/
+static void BM_Reassemble(benchmark::State &State)
+{
+
+   uint32_t PktCnt = (uint32_t)State.range(0);
+   uint32_t FrameCnt = PktCnt*BENCH_RADIO_CNT;
+   uint32_t i;
+   uint16_t HdrLen;
+   uint16_t FrameLen = 0;
+   LORA_FRAME_Hdr_t Hdr;
+   uint64_t StartAllocCnt;
+
+   std::vector<uint8_t> Frames((size_t)FrameCnt*LORA_FRAME_MAX_LEN);
+   std::vector<uint8_t> File((size_t)PktCnt*BENCH_PKT_SIZE);
+   std::vector<PKT_MAP_Class_t> PktMap(1);
+
+   /* Each radio's copy of a packet is delayed by a few frames like radios
+   ** with different queue depths */
+   Hdr.Type    = LORA_FRAME_TYPE_FILE_DATA;
+   Hdr.Flags   = 0;
+   Hdr.HopMask = 0;
+   for (i=0; i < FrameCnt; i++)
+   {
+      uint32_t Radio = i % BENCH_RADIO_CNT;
+      uint32_t Pkt   = i / BENCH_RADIO_CNT;
+      Pkt = (Pkt >= Radio*3) ? Pkt - Radio*3 : Pkt;
+      Hdr.Seq  = (uint16_t)(Pkt + 1);
+      FrameLen = LORA_FRAME_EncodeHdr(&Frames[(size_t)i*LORA_FRAME_MAX_LEN], &Hdr);
+      memset(&Frames[(size_t)i*LORA_FRAME_MAX_LEN + FrameLen], (int)Pkt, BENCH_PKT_SIZE);
+      FrameLen += BENCH_PKT_SIZE;
+   }
+
+   StartAllocCnt = AllocCnt;
+   for (auto _ : State)
+   {
+      PKT_MAP_Clear(&PktMap[0]);
+      for (i=0; i < FrameCnt; i++)
+      {
+         const uint8_t *Frame = &Frames[(size_t)i*LORA_FRAME_MAX_LEN];
+         HdrLen = LORA_FRAME_DecodeHdr(Frame, FrameLen, &Hdr);
+         if (Hdr.Seq > 0 && Hdr.Seq <= PktCnt && PKT_MAP_Set(&PktMap[0], Hdr.Seq))
+         {
+            memcpy(&File[(size_t)(Hdr.Seq-1)*BENCH_PKT_SIZE], &Frame[HdrLen], FrameLen - HdrLen);
+         }
+      }
+      benchmark::DoNotOptimize(PKT_MAP_NextMissing(&PktMap[0], 1, (uint16_t)PktCnt));
+      benchmark::ClobberMemory();
+   }
+
+   State.SetItemsProcessed(State.iterations()*FrameCnt);
+   State.SetBytesProcessed(State.iterations()*PktCnt*BENCH_PKT_SIZE);
+   ReportAllocs(State, StartAllocCnt);
+
+} /* End BM_Reassemble() */
+BENCHMARK(BM_Reassemble)->Arg(64)->Arg(1024)->Arg(PKT_MAP_MAX_PKT_CNT);
+
+
+/******************************************************************************
+** Function: BM_NextMissing
+**
+** Find the gaps in a PKT_MAP_MAX_PKT_CNT packet map with a missing packet
+** every range(0) packets
+**
+*/
+static void BM_NextMissing(benchmark::State &State)
+{
+
+   uint32_t Gap = (uint32_t)State.range(0);
+   uint32_t i;
+   uint32_t GapCnt = 0;
+   uint16_t Seq;
+   std::vector<PKT_MAP_Class_t> PktMap(1);
+   uint64_t StartAllocCnt;
+
+   PKT_MAP_Clear(&PktMap[0]);
+   for (i=1; i <= PKT_MAP_MAX_PKT_CNT; i++)
+   {
+      if (i % Gap != 0)
+      {
+         PKT_MAP_Set(&PktMap[0], (uint16_t)i);
+      }
+   }
+
+   StartAllocCnt = AllocCnt;
+   for (auto _ : State)
+   {
+      GapCnt = 0;
+      Seq = PKT_MAP_NextMissing(&PktMap[0], 1, PKT_MAP_MAX_PKT_CNT);
+      while (Seq != 0)
+      {
+         GapCnt++;
+         Seq = (Seq < PKT_MAP_MAX_PKT_CNT) ? PKT_MAP_NextMissing(&PktMap[0], Seq+1, PKT_MAP_MAX_PKT_CNT) : 0;
+      }
+      benchmark::DoNotOptimize(GapCnt);
+   }
+
+   State.counters["gaps"] = GapCnt;
+   State.SetItemsProcessed(State.iterations()*PKT_MAP_MAX_PKT_CNT);
+   ReportAllocs(State, StartAllocCnt);
+
+} /* End BM_NextMissing() */
+BENCHMARK(BM_NextMissing)->Arg(16)->Arg(1024)->Arg(PKT_MAP_MAX_PKT_CNT+1);
+
+
+/******************************************************************************
+** Function: BM_TimeOnAir
+**
+** Time-on-air of a full frame for each SX128x spreading factor at 812 kHz,
+** coding rate 4/5
+**
+*/
+static void BM_TimeOnAir(benchmark::State &State)
+{
+
+   uint8_t  Sf;
+   uint32_t ToaSum = 0;
+   uint64_t StartAllocCnt = AllocCnt;
+
+   for (auto _ : State)
+   {
+      for (Sf=5; Sf <= 12; Sf++)
+      {
+         ToaSum += LORA_TOA_TimeOnAir((uint8_t)(Sf << 4), 0x18, 0x01, 12, LORA_FRAME_MAX_LEN);
+      }
+      benchmark::DoNotOptimize(ToaSum);
+   }
+
+   State.SetItemsProcessed(State.iterations()*8);
+   ReportAllocs(State, StartAllocCnt);
+
+} /* End BM_TimeOnAir() */
+BENCHMARK(BM_TimeOnAir);
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,454 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    End-to-end file transfer benchmark over the simulated channel
+**
+**  Notes:
+**    1. A transmitter and receiver pair run the demo file transfer (see
+**       lora_tx.c SendDemoFile()) through the link core frame codec, the
+**       sim_chan.h channel model and a packet map reassembly. Time on the
+**       air is simulated from the modulation's time-on-air so a sweep of
+**       several hours of link time runs in seconds.
+**    2. A frame's latency runs from the transmitter taking its packet to the
+**       receiver writing it: the turnaround gap, the time-on-air and the
+**       measured host processing. Lost frames have no latency.
+**    3. The time-on-air limit is the goodput of back-to-back frames that
+**       carry nothing but file data in LORA_FRAME_MAX_LEN byte payloads.
+**       Efficiency is the measured goodput over this limit so it shows the
+**       cost of headers, short last packets, gaps and losses.
+**    4. CPU per megabyte is the process CPU time of the transfer loop,
+**       including the channel model, over the file size.
+**    5. Results are written as JSON, see PrintResult(). The sweep, seed and
+**       turnaround gap are fixed by the command line so runs can be
+**       compared across protocol changes.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lora_frame.h"
+#include "lora_toa.h"
+#include "pkt_map.h"
+#include "sim_chan.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define BENCH_PKT_SIZE      128   /* Same as LORA_DEMO_PACKET_SIZE */
+#define BENCH_PREAMBLE_LEN   12   /* Same as LORA_DEFAULT_PREAMBLE_LEN */
+#define BENCH_SNR_MEAN_DB    10
+#define BENCH_SNR_STD_DEV_DB  2
+
+#define BENCH_ARRAY_LEN(a)  (sizeof(a)/sizeof((a)[0]))
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef struct
+{
+
+   uint8_t      SpreadingFactor;   /* SX128x register encodings */
+   uint8_t      Bandwidth;
+   uint8_t      CodingRate;
+   uint32_t     BandwidthKhz;
+   const char  *CodingRateStr;
+
+} Modulation_t;
+
+
+typedef struct
+{
+
+   uint32_t  FileLen;
+   uint32_t  PktCnt;
+   uint32_t  FrameCnt;
+   uint32_t  LostFrameCnt;
+   uint32_t  DeliveredPktCnt;
+   bool      FileStartRcvd;
+   bool      Verified;
+   uint64_t  TransferUsec;
+   double    GoodputBps;
+   double    LimitBps;
+   double    Efficiency;
+   uint64_t  LatencyP50Usec;
+   uint64_t  LatencyP99Usec;
+   double    CpuUsecPerMb;
+
+} Result_t;
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static int      CompareU64(const void *a, const void *b);
+static uint64_t ClockNsec(clockid_t ClockId);
+static void     PrintResult(FILE *Out, const Modulation_t *Mod, uint32_t LossPpt, const Result_t *Result, bool First);
+static bool     RunTransfer(const Modulation_t *Mod, uint32_t LossPpt, uint32_t FileLen, Result_t *Result);
+static void     Usage(const char *Prog);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static const Modulation_t Modulation[] =
+{
+   { 0x50, 0x0A, 0x01, 1625, "4/5" },
+   { 0x70, 0x18, 0x01,  812, "4/5" },
+   { 0x70, 0x18, 0x04,  812, "4/8" },
+   { 0x90, 0x18, 0x01,  812, "4/5" },
+   { 0x90, 0x34, 0x01,  203, "4/5" },
+   { 0xC0, 0x34, 0x01,  203, "4/5" },
+};
+
+static const uint32_t LossPpt[] = { 0, 10, 100 };
+static const uint32_t FileLen[] = { 4096, 65536, 1048576 };
+
+static uint32_t Seed      = 1;
+static uint32_t TxGapUsec = 0;
+
+
+/******************************************************************************
+** Function: main
+**
+*/
+int main(int argc, char *argv[])
+{
+
+   FILE     *Out = stdout;
+   Result_t  Result;
+   bool      First = true;
+   bool      Quick = false;
+   size_t    ModIdx, LossIdx, FileIdx;
+   size_t    FileLenCnt = BENCH_ARRAY_LEN(FileLen);
+   int       Opt;
+
+   while ((Opt = getopt(argc, argv, "o:g:s:q")) != -1)
+   {
+      switch (Opt)
+      {
+         case 'o':
+            Out = fopen(optarg, "w");
+            if (Out == NULL)
+            {
+               perror(optarg);
+               return 1;
+            }
+            break;
+         case 'g':
+            TxGapUsec = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+         case 's':
+            Seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+         case 'q':
+            Quick = true;
+            break;
+         default:
+            Usage(argv[0]);
+            return 1;
+      }
+   }
+
+   if (Quick)
+   {
+      FileLenCnt = 2;   /* Skip the largest file */
+   }
+
+   fprintf(Out, "{\n  \"benchmark\": \"link_e2e\",\n  \"packet_size\": %u,\n  \"preamble_len\": %u,\n"
+                "  \"tx_gap_usec\": %u,\n  \"seed\": %u,\n  \"results\": [\n",
+           BENCH_PKT_SIZE, BENCH_PREAMBLE_LEN, (unsigned)TxGapUsec, (unsigned)Seed);
+
+   for (ModIdx=0; ModIdx < BENCH_ARRAY_LEN(Modulation); ModIdx++)
+   {
+      for (LossIdx=0; LossIdx < BENCH_ARRAY_LEN(LossPpt); LossIdx++)
+      {
+         for (FileIdx=0; FileIdx < FileLenCnt; FileIdx++)
+         {
+            if (!RunTransfer(&Modulation[ModIdx], LossPpt[LossIdx], FileLen[FileIdx], &Result))
+            {
+               fprintf(stderr, "Transfer setup failed\n");
+               return 1;
+            }
+            PrintResult(Out, &Modulation[ModIdx], LossPpt[LossIdx], &Result, First);
+            First = false;
+         }
+      }
+   }
+
+   fprintf(Out, "\n  ]\n}\n");
+
+   if (Out != stdout)
+   {
+      fclose(Out);
+   }
+
+   return 0;
+
+} /* End main() */
+
+
+/******************************************************************************
+** Function: RunTransfer
+**
+** Notes:
+**   1. The transmitter's radio is busy until a frame's time-on-air ends so
+**      frame N+1 starts TxGapUsec after frame N ends.
+**   2. Only the receiver's copy of the file is compared with the sent file,
+**      packets lost on the air are left as gaps like the demo receiver.
+**
+*/
+static bool RunTransfer(const Modulation_t *Mod, uint32_t LossPpt, uint32_t FileLen, Result_t *Result)
+{
+
+   SIM_CHAN_Class_t SimChan;
+   SIM_CHAN_Cfg_t   ChanCfg = { LossPpt, 0, 0, 0, BENCH_SNR_MEAN_DB, BENCH_SNR_STD_DEV_DB };
+   PKT_MAP_Class_t *PktMap;
+   LORA_FRAME_Hdr_t TxHdr, RxHdr;
+   uint8_t  *TxFile, *RxFile;
+   uint64_t *Latency;
+   uint32_t  LatencyCnt = 0;
+   uint8_t   Frame[LORA_FRAME_MAX_LEN];
+   uint16_t  FrameLen, HdrLen, DataLen;
+   uint32_t  Pkt, i;
+   uint32_t  ToaUsec;
+   uint64_t  NowUsec = 0;
+   uint64_t  CpuStart;
+   uint64_t  FrameStart;
+   uint64_t  FrameNsec;
+   uint32_t  RcvdPktCnt = 0;
+   uint64_t  RcvdByteCnt = 0;
+   int8_t    Snr;
+   char      PktCntText[12];
+   char      RxText[sizeof(PktCntText)];
+
+   memset(Result, 0, sizeof(Result_t));
+   Result->FileLen = FileLen;
+   Result->PktCnt  = (FileLen + BENCH_PKT_SIZE - 1) / BENCH_PKT_SIZE;
+   if (Result->PktCnt > PKT_MAP_MAX_PKT_CNT)
+   {
+      return false;
+   }
+
+   TxFile  = malloc(FileLen);
+   RxFile  = calloc(1, FileLen);
+   PktMap  = malloc(sizeof(PKT_MAP_Class_t));
+   Latency = malloc((Result->PktCnt + 1)*sizeof(uint64_t));
+   if (TxFile == NULL || RxFile == NULL || PktMap == NULL || Latency == NULL)
+   {
+      free(TxFile); free(RxFile); free(PktMap); free(Latency);
+      return false;
+   }
+
+   for (i=0; i < FileLen; i++)
+   {
+      TxFile[i] = (uint8_t)(i*131 + (i >> 8));
+   }
+
+   SIM_CHAN_Constructor(&SimChan, &ChanCfg, Seed);
+   PKT_MAP_Clear(PktMap);
+
+   TxHdr.Flags   = 0;
+   TxHdr.HopMask = 0;
+
+   CpuStart = ClockNsec(CLOCK_PROCESS_CPUTIME_ID);
+
+   /* Packet 0 is the file start frame */
+   for (Pkt=0; Pkt <= Result->PktCnt; Pkt++)
+   {
+
+      FrameStart = ClockNsec(CLOCK_MONOTONIC);
+
+      TxHdr.Seq = (uint16_t)Pkt;
+      if (Pkt == 0)
+      {
+         TxHdr.Type = LORA_FRAME_TYPE_FILE_START;
+         DataLen = (uint16_t)snprintf(PktCntText, sizeof(PktCntText), "%u", (unsigned)Result->PktCnt);
+         HdrLen  = LORA_FRAME_EncodeHdr(Frame, &TxHdr);
+         memcpy(&Frame[HdrLen], PktCntText, DataLen);
+      }
+      else
+      {
+         TxHdr.Type = LORA_FRAME_TYPE_FILE_DATA;
+         DataLen = (Pkt < Result->PktCnt) ? BENCH_PKT_SIZE : (uint16_t)(FileLen - (Pkt-1)*BENCH_PKT_SIZE);
+         HdrLen  = LORA_FRAME_EncodeHdr(Frame, &TxHdr);
+         memcpy(&Frame[HdrLen], &TxFile[(Pkt-1)*BENCH_PKT_SIZE], DataLen);
+      }
+      FrameLen = HdrLen + DataLen;
+
+      ToaUsec = LORA_TOA_TimeOnAir(Mod->SpreadingFactor, Mod->Bandwidth, Mod->CodingRate,
+                                   BENCH_PREAMBLE_LEN, FrameLen);
+      Result->FrameCnt++;
+
+      if (SIM_CHAN_Delivers(&SimChan, Mod->SpreadingFactor, &Snr))
+      {
+         HdrLen = LORA_FRAME_DecodeHdr(Frame, FrameLen, &RxHdr);
+         if (HdrLen > 0)
+         {
+            if (RxHdr.Type == LORA_FRAME_TYPE_FILE_START)
+            {
+               /* The payload isn't terminated */
+               DataLen = FrameLen - HdrLen;
+               if (DataLen >= sizeof(RxText))
+               {
+                  DataLen = sizeof(RxText) - 1;
+               }
+               memcpy(RxText, &Frame[HdrLen], DataLen);
+               RxText[DataLen] = '\0';
+               Result->FileStartRcvd = (strtoul(RxText, NULL, 10) == Result->PktCnt);
+            }
+            else if (RxHdr.Type == LORA_FRAME_TYPE_FILE_DATA && RxHdr.Seq <= Result->PktCnt &&
+                     PKT_MAP_Set(PktMap, RxHdr.Seq))
+            {
+               memcpy(&RxFile[(RxHdr.Seq-1)*BENCH_PKT_SIZE], &Frame[HdrLen], FrameLen - HdrLen);
+               RcvdPktCnt++;
+            }
+         }
+         FrameNsec = ClockNsec(CLOCK_MONOTONIC) - FrameStart;
+         Latency[LatencyCnt++] = TxGapUsec + ToaUsec + FrameNsec/1000;
+      }
+      else
+      {
+         Result->LostFrameCnt++;
+      }
+
+      NowUsec += TxGapUsec + ToaUsec;
+
+   } /* End frame loop */
+
+   Result->CpuUsecPerMb = ((ClockNsec(CLOCK_PROCESS_CPUTIME_ID) - CpuStart)/1000.0)/(FileLen/1048576.0);
+
+   Result->DeliveredPktCnt = RcvdPktCnt;
+   Result->TransferUsec    = NowUsec;
+
+   Result->Verified = true;
+   for (Pkt=1; Pkt <= Result->PktCnt; Pkt++)
+   {
+      if (PKT_MAP_Test(PktMap, (uint16_t)Pkt))
+      {
+         DataLen = (Pkt < Result->PktCnt) ? BENCH_PKT_SIZE : (uint16_t)(FileLen - (Pkt-1)*BENCH_PKT_SIZE);
+         if (memcmp(&RxFile[(Pkt-1)*BENCH_PKT_SIZE], &TxFile[(Pkt-1)*BENCH_PKT_SIZE], DataLen) != 0)
+         {
+            Result->Verified = false;
+         }
+         RcvdByteCnt += DataLen;
+      }
+   }
+
+   Result->GoodputBps = (NowUsec > 0) ? (8.0*RcvdByteCnt*1e6)/NowUsec : 0.0;
+   Result->LimitBps   = (8.0*LORA_FRAME_MAX_LEN*1e6) /
+                        LORA_TOA_TimeOnAir(Mod->SpreadingFactor, Mod->Bandwidth, Mod->CodingRate,
+                                           BENCH_PREAMBLE_LEN, LORA_FRAME_MAX_LEN);
+   Result->Efficiency = Result->GoodputBps/Result->LimitBps;
+
+   if (LatencyCnt > 0)
+   {
+      qsort(Latency, LatencyCnt, sizeof(uint64_t), CompareU64);
+      Result->LatencyP50Usec = Latency[(LatencyCnt-1)*50/100];
+      Result->LatencyP99Usec = Latency[(LatencyCnt-1)*99/100];
+   }
+
+   free(TxFile);
+   free(RxFile);
+   free(PktMap);
+   free(Latency);
+
+   return true;
+
+} /* End RunTransfer() */
+
+
+/******************************************************************************
+** Function: PrintResult
+**
+*/
+static void PrintResult(FILE *Out, const Modulation_t *Mod, uint32_t LossPpt, const Result_t *Result, bool First)
+{
+
+   fprintf(Out, "%s    {\"file_bytes\": %u, \"sf\": %u, \"bw_khz\": %u, \"cr\": \"%s\", \"loss_ppt\": %u,\n"
+                "     \"pkt_cnt\": %u, \"frame_cnt\": %u, \"lost_frame_cnt\": %u, \"delivered_pkt_cnt\": %u,\n"
+                "     \"file_start_rcvd\": %s, \"verified\": %s, \"transfer_usec\": %llu,\n"
+                "     \"goodput_bps\": %.1f, \"toa_limit_bps\": %.1f, \"efficiency\": %.4f,\n"
+                "     \"latency_p50_usec\": %llu, \"latency_p99_usec\": %llu, \"cpu_usec_per_mb\": %.1f}",
+           First ? "" : ",\n",
+           (unsigned)Result->FileLen, (unsigned)(Mod->SpreadingFactor >> 4), (unsigned)Mod->BandwidthKhz,
+           Mod->CodingRateStr, (unsigned)LossPpt,
+           (unsigned)Result->PktCnt, (unsigned)Result->FrameCnt, (unsigned)Result->LostFrameCnt,
+           (unsigned)Result->DeliveredPktCnt,
+           Result->FileStartRcvd ? "true" : "false", Result->Verified ? "true" : "false",
+           (unsigned long long)Result->TransferUsec,
+           Result->GoodputBps, Result->LimitBps, Result->Efficiency,
+           (unsigned long long)Result->LatencyP50Usec, (unsigned long long)Result->LatencyP99Usec,
+           Result->CpuUsecPerMb);
+
+} /* End PrintResult() */
+
+
+/******************************************************************************
+** Function: ClockNsec
+**
+*/
+static uint64_t ClockNsec(clockid_t ClockId)
+{
+
+   struct timespec Now;
+
+   clock_gettime(ClockId, &Now);
+
+   return (uint64_t)Now.tv_sec*1000000000 + (uint64_t)Now.tv_nsec;
+
+} /* End ClockNsec() */
+
+
+/******************************************************************************
+** Function: CompareU64
+**
+*/
+static int CompareU64(const void *a, const void *b)
+{
+
+   uint64_t x = *(const uint64_t *)a;
+   uint64_t y = *(const uint64_t *)b;
+
+   return (x > y) - (x < y);
+
+} /* End CompareU64() */
+
+
+/******************************************************************************
+** Function: Usage
+**
+*/
+static void Usage(const char *Prog)
+{
+
+   fprintf(stderr, "Usage: %s [-o results.json] [-g tx_gap_usec] [-s seed] [-q]\n"
+                   "  -q  Quick sweep without the largest file\n", Prog);
+
+} /* End Usage() */
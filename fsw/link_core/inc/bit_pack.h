@@ -0,0 +1,216 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the bit stream writer and reader used by the packed payload
+**    encoders
+**
+**  Notes:
+**    1. The encoders and decoders generated by tools/eds_pack_gen.py call
+**       these with a constant field width so the functions are inline and
+**       the compiler specializes each call.
+**    2. Fields are written most significant bit first with no padding
+**       between them. The last byte is padded with zero bits.
+**    3. Writing past the buffer or reading past the input sets Overflow
+**       rather than failing each call, the caller checks it once at the
+**       end.
+**
+*/
+
+#ifndef _bit_pack_
+#define _bit_pack_
+
+/*
+** Includes
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+typedef struct
+{
+
+   uint8_t   *Buf;
+   uint16_t  BufLen;
+   uint16_t  Len;        /* Whole bytes written */
+   uint8_t   AccBits;    /* Bits in Acc not yet written, less than 8 between calls */
+   bool      Overflow;
+   uint64_t  Acc;
+
+} BIT_PACK_Writer_t;
+
+
+typedef struct
+{
+
+   const uint8_t *Buf;
+   uint16_t  BufLen;
+   uint16_t  Len;        /* Whole bytes read */
+   uint8_t   AccBits;
+   bool      Overflow;
+   uint64_t  Acc;
+
+} BIT_PACK_Reader_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: BIT_PACK_WriterInit
+**
+*/
+static inline void BIT_PACK_WriterInit(BIT_PACK_Writer_t *Writer, uint8_t *Buf, uint16_t BufLen)
+{
+
+   Writer->Buf      = Buf;
+   Writer->BufLen   = BufLen;
+   Writer->Len      = 0;
+   Writer->AccBits  = 0;
+   Writer->Overflow = false;
+   Writer->Acc      = 0;
+
+} /* End BIT_PACK_WriterInit() */
+
+
+/******************************************************************************
+** Function: BIT_PACK_Put
+**
+** Write the low Bits bits of Value
+**
+** Notes:
+**   1. Bits is 1 to 32.
+**
+*/
+static inline void BIT_PACK_Put(BIT_PACK_Writer_t *Writer, uint32_t Value, unsigned Bits)
+{
+
+   Writer->Acc = (Writer->Acc << Bits) | (Value & (UINT32_C(0xFFFFFFFF) >> (32 - Bits)));
+   Writer->AccBits += Bits;
+
+   while (Writer->AccBits >= 8)
+   {
+      Writer->AccBits -= 8;
+      if (Writer->Len < Writer->BufLen)
+      {
+         Writer->Buf[Writer->Len++] = (uint8_t)(Writer->Acc >> Writer->AccBits);
+      }
+      else
+      {
+         Writer->Overflow = true;
+      }
+   }
+
+} /* End BIT_PACK_Put() */
+
+
+/******************************************************************************
+** Function: BIT_PACK_WriterEnd
+**
+** Write the last partial byte and return the packed length
+**
+** Notes:
+**   1. Returns 0 if the fields didn't fit the buffer.
+**
+*/
+static inline uint16_t BIT_PACK_WriterEnd(BIT_PACK_Writer_t *Writer)
+{
+
+   if (Writer->AccBits > 0)
+   {
+      BIT_PACK_Put(Writer, 0, 8 - Writer->AccBits);
+   }
+
+   return Writer->Overflow ? 0 : Writer->Len;
+
+} /* End BIT_PACK_WriterEnd() */
+
+
+/******************************************************************************
+** Function: BIT_PACK_ReaderInit
+**
+*/
+static inline void BIT_PACK_ReaderInit(BIT_PACK_Reader_t *Reader, const uint8_t *Buf, uint16_t BufLen)
+{
+
+   Reader->Buf      = Buf;
+   Reader->BufLen   = BufLen;
+   Reader->Len      = 0;
+   Reader->AccBits  = 0;
+   Reader->Overflow = false;
+   Reader->Acc      = 0;
+
+} /* End BIT_PACK_ReaderInit() */
+
+
+/******************************************************************************
+** Function: BIT_PACK_Get
+**
+** Read a Bits bit field
+**
+** Notes:
+**   1. Bits is 1 to 32. Bits past the input read as zero.
+**
+*/
+static inline uint32_t BIT_PACK_Get(BIT_PACK_Reader_t *Reader, unsigned Bits)
+{
+
+   while (Reader->AccBits < Bits)
+   {
+      Reader->Acc <<= 8;
+      if (Reader->Len < Reader->BufLen)
+      {
+         Reader->Acc |= Reader->Buf[Reader->Len++];
+      }
+      else
+      {
+         Reader->Overflow = true;
+      }
+      Reader->AccBits += 8;
+   }
+
+   Reader->AccBits -= Bits;
+
+   return (uint32_t)(Reader->Acc >> Reader->AccBits) & (UINT32_C(0xFFFFFFFF) >> (32 - Bits));
+
+} /* End BIT_PACK_Get() */
+
+
+/******************************************************************************
+** Function: BIT_PACK_ReaderEnd
+**
+** Return the number of bytes read
+**
+** Notes:
+**   1. Returns 0 if the fields ran past the input.
+**
+*/
+static inline uint16_t BIT_PACK_ReaderEnd(const BIT_PACK_Reader_t *Reader)
+{
+
+   return Reader->Overflow ? 0 : Reader->Len;
+
+} /* End BIT_PACK_ReaderEnd() */
+
+
+#endif /* _bit_pack_ */
@@ -0,0 +1,188 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the software bus message header compressor
+**
+**  Notes:
+**    1. A telemetry message's CCSDS primary header, secondary header and
+**       time stamp are a large share of a small LoRa frame. Most of the
+**       header is the same in every message of a stream so the compressor
+**       keeps a context for each of the last HDR_COMP_CTX_CNT streams and
+**       sends a message's header as changes from its context's reference
+**       header. The expander keeps the same contexts and rebuilds the
+**       exact original header.
+**    2. A compressed message starts with a one byte descriptor:
+**         Bits 7-5: Kind, see HDR_COMP_KIND_*
+**         Bits 4-2: Context
+**         Bits 1-0: Context generation
+**       It's followed by:
+**         RAW:   The whole message, the header couldn't be compressed
+**         FULL:  The whole message, its header becomes the context's
+**                reference header
+**         COMP:  The sequence count delta (1 byte), the time delta (0 to 3
+**                bytes, big endian) and the message's data
+**    3. The deltas are from the reference header rather than the previous
+**       message so a lost frame doesn't change how the next one is
+**       rebuilt. The length field is implied by the message length.
+**    4. The compressor sends a FULL header when the stream's static header
+**       bytes change, the deltas don't fit or RefreshCnt messages have used
+**       the reference. A lost FULL header changes the generation so the
+**       expander drops the context's messages until the next FULL one
+**       rather than rebuilding them from an old reference.
+**    5. The header is HdrLen bytes and the time stamp is the
+**       HDR_COMP_TIME_LEN bytes at TimeOffset. The time stamp is
+**       treated as one big endian integer so the deltas are exact in any
+**       time format. Messages whose CCSDS length field doesn't match their
+**       length are sent RAW so the rebuilt header is always exact.
+**    6. An object is used in one direction by one task.
+**
+*/
+
+#ifndef _hdr_comp_
+#define _hdr_comp_
+
+/*
+** Includes
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define HDR_COMP_CTX_CNT      8
+#define HDR_COMP_MAX_HDR_LEN  32
+#define HDR_COMP_TIME_LEN     6
+#define HDR_COMP_MAX_OVERHEAD (1 + HDR_COMP_MAX_HDR_LEN)  /* Bytes more than the message in the worst case */
+
+#define HDR_COMP_KIND_RAW   0
+#define HDR_COMP_KIND_FULL  1
+#define HDR_COMP_KIND_COMP  2   /* COMP + N has N time delta bytes, N is 0 to 3 */
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+typedef struct
+{
+
+   bool      Valid;
+   uint8_t   Gen;
+   uint16_t  UseCnt;    /* Compressor: messages sent with the reference */
+   uint32_t  LastUse;   /* Compressor: least recently used context is replaced */
+   uint16_t  RefSeq;
+   uint64_t  RefTime;
+   uint8_t   Hdr[HDR_COMP_MAX_HDR_LEN];
+
+} HDR_COMP_Ctx_t;
+
+
+/******************************************************************************
+** HDR_COMP_Class
+*/
+typedef struct
+{
+
+   uint16_t  HdrLen;
+   uint16_t  TimeOffset;
+   uint16_t  RefreshCnt;
+   uint32_t  UseClock;
+
+   /* Compressor */
+   uint32_t  RawCnt;
+   uint32_t  FullCnt;
+   uint32_t  CompCnt;
+   uint64_t  MsgByteCnt;       /* Message bytes in */
+   uint64_t  CompByteCnt;      /* Compressed message bytes out */
+
+   /* Expander */
+   uint32_t  ExpandCnt;
+   uint32_t  CtxErrCnt;        /* Compressed header with no matching reference */
+   uint32_t  FormatErrCnt;
+
+   HDR_COMP_Ctx_t Ctx[HDR_COMP_CTX_CNT];
+
+} HDR_COMP_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: HDR_COMP_Constructor
+**
+** Initialize a header compressor or expander
+**
+** Notes:
+**   1. HdrLen is at most HDR_COMP_MAX_HDR_LEN and must include the time
+**      stamp. RefreshCnt is at most 255. The compressor and the expander
+**      must use the same HdrLen and TimeOffset.
+**
+*/
+void HDR_COMP_Constructor(HDR_COMP_Class_t *HdrComp, uint16_t HdrLen, uint16_t TimeOffset, uint16_t RefreshCnt);
+
+
+/******************************************************************************
+** Function: HDR_COMP_Reset
+**
+** Forget the contexts and clear the counts
+**
+** Notes:
+**   1. The compressor's next message of each stream has a FULL header.
+**
+*/
+void HDR_COMP_Reset(HDR_COMP_Class_t *HdrComp);
+
+
+/******************************************************************************
+** Function: HDR_COMP_Compress
+**
+** Compress the header of the MsgLen byte message Msg into Out and return the
+** compressed message's length
+**
+** Notes:
+**   1. Returns 0 if the compressed message is longer than OutMax. The
+**      contexts aren't changed so a message that isn't sent doesn't
+**      become a reference.
+**
+*/
+uint16_t HDR_COMP_Compress(HDR_COMP_Class_t *HdrComp, const uint8_t *Msg, uint16_t MsgLen,
+                           uint8_t *Out, uint16_t OutMax);
+
+
+/******************************************************************************
+** Function: HDR_COMP_Expand
+**
+** Rebuild the message compressed in the InLen bytes of In into Msg and
+** return its length
+**
+** Notes:
+**   1. Returns 0 and counts the error if the message can't be rebuilt or
+**      is longer than MsgMax.
+**
+*/
+uint16_t HDR_COMP_Expand(HDR_COMP_Class_t *HdrComp, const uint8_t *In, uint16_t InLen,
+                         uint8_t *Msg, uint16_t MsgMax);
+
+
+#endif /* _hdr_comp_ */
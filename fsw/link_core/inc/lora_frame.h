@@ -0,0 +1,155 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the over-the-air LoRa frame header
+**
+**  Notes:
+**    1. Every radio payload starts with a header that identifies the frame
+**       type and carries a sequence number. The sequence number lets both
+**       ends of a link derive the same frequency hop slot.
+**    2. Header layout (big endian):
+**         Type (1), Flags (1), Seq (2), optional fields selected by Flags
+**    3. Optional fields are appended in flag bit order.
+**    4. Times are the low 32 bits of the sender's clock in microseconds.
+**       They wrap every 71 minutes so only differences between nearby times
+**       are meaningful, see latency.h.
+**    5. Part of the link core library so it has no cFE or OSAL dependencies,
+**       see link_core/CMakeLists.txt.
+**    6. The route field addresses a frame to a node beyond the sender's
+**       range. Seq, the hop mask and the times stay link local, a relay
+**       sends the frame with its own. See relay.h.
+**
+*/
+
+#ifndef _lora_frame_
+#define _lora_frame_
+
+/*
+** Includes
+*/
+
+#include <stdint.h>
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define LORA_FRAME_MAX_LEN      255
+#define LORA_FRAME_MIN_HDR_LEN    4
+#define LORA_FRAME_MAX_HDR_LEN   30
+
+/*
+** Frame types
+*/
+
+#define LORA_FRAME_TYPE_FILE_START  1  /* Payload is the file packet count as text */
+#define LORA_FRAME_TYPE_FILE_DATA   2  /* Payload is file data, Seq 1 is the first packet */
+#define LORA_FRAME_TYPE_LINK_TEST   3  /* Payload is PRBS data, Seq is the frame's index in the test */
+#define LORA_FRAME_TYPE_SB_MSG      4  /* Payload is a software bus message with a compressed header, see hdr_comp.h */
+#define LORA_FRAME_TYPE_SB_STORED   5  /* Payload is a big endian replay count and an SB_MSG payload, see store.h */
+#define LORA_FRAME_TYPE_FILE_SEG    6  /* Payload is a big endian file offset (4) and file data, see len_opt.h */
+#define LORA_FRAME_TYPE_RX_REPORT   7  /* Payload is the big endian count of file segments received (2), Seq is the request's */
+#define LORA_FRAME_TYPE_BEACON      8  /* Payload is the sender's routes as Dst (1), HopCnt (1), NextHop (1), see relay.h */
+
+#define LORA_FRAME_SEG_OFFSET_LEN   4
+#define LORA_FRAME_REPORT_LEN       2
+#define LORA_FRAME_ROUTE_LEN        6
+
+#define LORA_FRAME_NODE_NONE        0     /* Not a node, a node ID of 0 disables routing */
+#define LORA_FRAME_NODE_BROADCAST   0xFF
+
+/*
+** Header flags
+*/
+
+#define LORA_FRAME_FLAG_HOP_MASK   0x01  /* Hop channel blacklist mask (4 bytes) follows */
+#define LORA_FRAME_FLAG_TIMESTAMP  0x02  /* Time the frame's data was queued (4 bytes) follows */
+#define LORA_FRAME_FLAG_TIME_EXCH  0x04  /* Clock exchange echo, echo receive and transmit times (12 bytes) follow */
+#define LORA_FRAME_FLAG_REPORT_REQ 0x08  /* Receiver answers with an RX_REPORT frame, no field */
+#define LORA_FRAME_FLAG_ROUTE      0x10  /* Route (6 bytes) follows */
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+/*
+** Route field layout (big endian):
+**   Src (1), Dst (1), NextHop (1), HopCnt (1), MsgId (2)
+*/
+typedef struct
+{
+
+   uint8_t   Src;       /* Node that originated the frame */
+   uint8_t   Dst;       /* Final destination */
+   uint8_t   NextHop;   /* Node that receives this hop, the only one that forwards it */
+   uint8_t   HopCnt;    /* Hops taken before this one */
+   uint16_t  MsgId;     /* Set by Src, Src and MsgId identify the frame end to end */
+
+} LORA_FRAME_Route_t;
+
+
+typedef struct
+{
+
+   uint8_t   Type;
+   uint8_t   Flags;
+   uint16_t  Seq;
+   uint32_t  HopMask;   /* Valid when LORA_FRAME_FLAG_HOP_MASK is set */
+   uint32_t  Timestamp; /* Valid when LORA_FRAME_FLAG_TIMESTAMP is set */
+
+   /* Valid when LORA_FRAME_FLAG_TIME_EXCH is set */
+   uint32_t  ExchEcho;  /* ExchTx of the last exchange received from the peer */
+   uint32_t  ExchRx;    /* When that exchange was received */
+   uint32_t  ExchTx;    /* When this frame was encoded */
+
+   LORA_FRAME_Route_t Route;  /* Valid when LORA_FRAME_FLAG_ROUTE is set */
+
+} LORA_FRAME_Hdr_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: LORA_FRAME_EncodeHdr
+**
+** Write the header to the start of a frame buffer
+**
+** Notes:
+**   1. Frame must have room for LORA_FRAME_MAX_HDR_LEN bytes.
+**   2. Returns the encoded header length.
+**
+*/
+uint16_t LORA_FRAME_EncodeHdr(uint8_t *Frame, const LORA_FRAME_Hdr_t *Hdr);
+
+
+/******************************************************************************
+** Function: LORA_FRAME_DecodeHdr
+**
+** Read the header from the start of a received frame
+**
+** Notes:
+**   1. Returns the header length or 0 if the frame is too short to hold the
+**      header described by its flags.
+**
+*/
+uint16_t LORA_FRAME_DecodeHdr(const uint8_t *Frame, uint16_t FrameLen, LORA_FRAME_Hdr_t *Hdr);
+
+
+#endif /* _lora_frame_ */
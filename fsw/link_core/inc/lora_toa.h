@@ -0,0 +1,82 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the LoRa time-on-air calculations
+**
+**  Notes:
+**    1. The modulation parameters use the SX128x register encodings. See the
+**       SX1280 datasheet section 7.4.4.
+**    2. Used by the simulated radio to pace frames and by the app to size
+**       timeouts and report airtime.
+**
+*/
+
+#ifndef _lora_toa_
+#define _lora_toa_
+
+/*
+** Includes
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: LORA_TOA_TimeOnAir
+**
+** Return the LoRa time-on-air in microseconds of a frame with an explicit
+** header, CRC and a preamble of PreambleLen symbols.
+**
+** Notes:
+**   1. Returns 0 if the modulation parameters are invalid.
+**
+*/
+uint32_t LORA_TOA_TimeOnAir(uint8_t SpreadingFactor, uint8_t Bandwidth, uint8_t CodingRate,
+                            uint16_t PreambleLen, uint16_t PayloadLen);
+
+
+/******************************************************************************
+** Function: LORA_TOA_FrameTimeOnAir
+**
+** Return the LoRa time-on-air in microseconds of a frame with CRC, a preamble
+** of PreambleLen symbols and an explicit or implicit header.
+**
+** Notes:
+**   1. An implicit header frame doesn't send the 20 bit header so both ends
+**      must be configured with the payload length and coding rate.
+**   2. Returns 0 if the modulation parameters are invalid.
+**
+*/
+uint32_t LORA_TOA_FrameTimeOnAir(uint8_t SpreadingFactor, uint8_t Bandwidth, uint8_t CodingRate,
+                                 uint16_t PreambleLen, bool ImplicitHeader, uint16_t PayloadLen);
+
+
+/******************************************************************************
+** Function: LORA_TOA_SymbolNsec
+**
+** Return the LoRa symbol time in nanoseconds or 0 if the spreading factor or
+** bandwidth is invalid.
+**
+*/
+uint32_t LORA_TOA_SymbolNsec(uint8_t SpreadingFactor, uint8_t Bandwidth);
+
+
+#endif /* _lora_toa_ */
@@ -0,0 +1,148 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the goodput optimal payload length estimator
+**
+**  Notes:
+**    1. A longer frame spreads its fixed overhead (preamble, header, CRC)
+**       over more data but is more likely to be corrupted. The estimator
+**       models a frame as lost when any of its bytes is corrupted, so a
+**       frame of N bytes arrives with probability q^N where q is the
+**       probability a byte survives.
+**    2. Each window of frames sent with one payload length and the count
+**       the receiver reports gives a packet error rate and from it q. The
+**       byte loss 1-q is smoothed over windows so one window doesn't swing
+**       the length, and since it doesn't depend on the length it predicts
+**       the loss of every candidate length.
+**    3. The chosen length maximizes expected goodput L*q^(H+L)/TOA(H+L)
+**       over the candidate lengths, H being the frame bytes besides the
+**       payload and TOA the LoRa time-on-air. The length only changes if
+**       the best candidate beats the current one by PKT_LEN_HYSTERESIS.
+**    4. Efficiency is goodput relative to loss-free frames of the maximum
+**       length, in parts per thousand. The prediction is for the chosen
+**       length and the achieved value is the last window's.
+**    5. Probabilities are Q30 fixed point so it doesn't need libm and
+**       gives the same result on every target.
+**    6. Part of the link core library so it has no cFE or OSAL
+**       dependencies. The caller provides any locking.
+**
+*/
+
+#ifndef _pkt_len_
+#define _pkt_len_
+
+/*
+** Includes
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define PKT_LEN_MAX_CAND     32
+#define PKT_LEN_Q30_ONE      (1UL << 30)
+#define PKT_LEN_EWMA_SHIFT    2     /* Each window has a 1/4 weight in the byte loss */
+#define PKT_LEN_HYSTERESIS   32     /* Switch when the best length's goodput is 1/32 higher */
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** PKT_LEN_Class
+*/
+typedef struct
+{
+
+   uint16_t  OverheadLen;    /* Frame bytes besides the payload */
+   uint16_t  CandCnt;
+   uint16_t  CandLen[PKT_LEN_MAX_CAND];
+   uint32_t  CandToaUsec[PKT_LEN_MAX_CAND];
+   uint32_t  RefToaUsec;     /* Maximum length frame, the efficiency reference */
+
+   bool      LossValid;
+   uint32_t  ByteLossQ30;    /* Smoothed probability a frame byte is corrupted */
+
+   uint16_t  CandIdx;        /* Current length */
+   uint16_t  PredictedPpt;
+   uint16_t  AchievedPpt;
+
+} PKT_LEN_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: PKT_LEN_Init
+**
+** Set up the candidate lengths for a transfer's modulation
+**
+** Notes:
+**   1. The candidates are MinLen to MaxLen in Step increments plus MaxLen.
+**      MinLen is raised to Step if it's lower and at most PKT_LEN_MAX_CAND
+**      candidates are kept.
+**   2. The modulation parameters use the SX128x register encodings, see
+**      lora_toa.h.
+**   3. Starts at the maximum length with no loss estimate.
+**
+*/
+void PKT_LEN_Init(PKT_LEN_Class_t *PktLen, uint8_t SpreadingFactor, uint8_t Bandwidth,
+                  uint8_t CodingRate, uint16_t PreambleLen, uint16_t OverheadLen,
+                  uint16_t MinLen, uint16_t MaxLen, uint16_t Step);
+
+
+/******************************************************************************
+** Function: PKT_LEN_Len
+**
+** Return the payload length to send
+**
+*/
+uint16_t PKT_LEN_Len(const PKT_LEN_Class_t *PktLen);
+
+
+/******************************************************************************
+** Function: PKT_LEN_RecordWindow
+**
+** Update the loss estimate with a window of frames and return the payload
+** length for the next window
+**
+** Notes:
+**   1. SentCnt frames of the current length were sent and RcvdCnt of them
+**      were received. A window with no frames is ignored.
+**
+*/
+uint16_t PKT_LEN_RecordWindow(PKT_LEN_Class_t *PktLen, uint32_t SentCnt, uint32_t RcvdCnt);
+
+
+/******************************************************************************
+** Function: PKT_LEN_ByteLossPpm
+**
+** Return the smoothed byte loss in parts per million
+**
+*/
+uint32_t PKT_LEN_ByteLossPpm(const PKT_LEN_Class_t *PktLen);
+
+
+#endif /* _pkt_len_ */
@@ -0,0 +1,114 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the packet map used to reassemble a transfer
+**
+**  Notes:
+**    1. A transfer of up to PKT_MAP_MAX_PKT_CNT packets can arrive out of
+**       order and more than once, for example when it's striped across
+**       several radios. The map has a bit for each sequence number so the
+**       receiver can drop copies of a packet it has already written and
+**       knows when the transfer is complete.
+**    2. Sequence number 0 is the transfer's start frame and is never set.
+**    3. The caller provides any locking.
+**
+*/
+
+#ifndef _pkt_map_
+#define _pkt_map_
+
+/*
+** Includes
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define PKT_MAP_MAX_PKT_CNT  0xFFFF   /* Frame sequence numbers are 16 bits */
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** PKT_MAP_Class
+*/
+typedef struct
+{
+
+   uint32_t  SetCnt;
+   uint8_t   Bits[(PKT_MAP_MAX_PKT_CNT+8)/8];   /* Bit N set when packet N was received */
+
+} PKT_MAP_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: PKT_MAP_Clear
+**
+** Clear the map for a new transfer
+**
+*/
+void PKT_MAP_Clear(PKT_MAP_Class_t *PktMap);
+
+
+/******************************************************************************
+** Function: PKT_MAP_Test
+**
+** Return whether packet Seq has been received
+**
+*/
+bool PKT_MAP_Test(const PKT_MAP_Class_t *PktMap, uint16_t Seq);
+
+
+/******************************************************************************
+** Function: PKT_MAP_Set
+**
+** Record that packet Seq has been received
+**
+** Notes:
+**   1. Returns false if Seq is 0 or was already set.
+**
+*/
+bool PKT_MAP_Set(PKT_MAP_Class_t *PktMap, uint16_t Seq);
+
+
+/******************************************************************************
+** Function: PKT_MAP_NextMissing
+**
+** Return the first packet from Seq through PktCnt that hasn't been received
+** or 0 if they all have
+**
+** Notes:
+**   1. Received bytes are skipped a byte at a time so a mostly complete map
+**      is scanned quickly.
+**
+*/
+uint16_t PKT_MAP_NextMissing(const PKT_MAP_Class_t *PktMap, uint16_t Seq, uint16_t PktCnt);
+
+
+#endif /* _pkt_map_ */
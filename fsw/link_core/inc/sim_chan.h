@@ -0,0 +1,111 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the simulated LoRa channel model
+**
+**  Notes:
+**    1. The model applies independent loss, Gilbert-Elliott burst loss and
+**       a gaussian SNR to each frame. Frames with an SNR below the spreading
+**       factor's demodulation limit are lost.
+**    2. Used by the simulated radio (radio_sim.h) and by the host link
+**       benchmarks so both see the same loss patterns.
+**    3. A small xorshift generator is used so runs are repeatable for a
+**       given seed. The gaussian SNR is approximated by summing 12 uniform
+**       samples which avoids a libm dependency.
+**
+*/
+
+#ifndef _sim_chan_
+#define _sim_chan_
+
+/*
+** Includes
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/*
+** Channel model configuration. Probabilities are in parts per thousand
+** and are applied to each frame.
+*/
+typedef struct
+{
+
+   uint32_t  LossPpt;         /* Independent loss                  */
+   uint32_t  BurstEnterPpt;   /* Good to bad state transition      */
+   uint32_t  BurstExitPpt;    /* Bad to good state transition      */
+   uint32_t  BurstLossPpt;    /* Loss while in the bad state       */
+   int32_t   SnrMeanDb;
+   int32_t   SnrStdDevDb;
+
+} SIM_CHAN_Cfg_t;
+
+
+/******************************************************************************
+** SIM_CHAN_Class
+*/
+typedef struct
+{
+
+   SIM_CHAN_Cfg_t  Cfg;
+
+   bool      BurstState;
+   uint32_t  RandState;
+   uint32_t  BurstCnt;      /* Transitions to the bad state */
+
+} SIM_CHAN_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: SIM_CHAN_Constructor
+**
+** Initialize the channel to a known state
+**
+** Notes:
+**   1. A Seed of 0 is replaced by 1 because the xorshift state must be
+**      non-zero.
+**
+*/
+void SIM_CHAN_Constructor(SIM_CHAN_Class_t *SimChan, const SIM_CHAN_Cfg_t *Cfg, uint32_t Seed);
+
+
+/******************************************************************************
+** Function: SIM_CHAN_Delivers
+**
+** Return whether the next frame sent with SpreadingFactor is delivered and
+** its SNR
+**
+** Notes:
+**   1. SpreadingFactor uses the SX128x register encoding.
+**   2. Snr is written even when the frame is lost.
+**
+*/
+bool SIM_CHAN_Delivers(SIM_CHAN_Class_t *SimChan, uint8_t SpreadingFactor, int8_t *Snr);
+
+
+#endif /* _sim_chan_ */
@@ -0,0 +1,408 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the software bus message header compressor
+**
+**  Notes:
+**    1. See hdr_comp.h file prologue.
+**    2. CCSDS primary header bytes 2-3 are the sequence flags (2 bits) and
+**       the sequence count (14 bits), bytes 4-5 are the length minus 7.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "hdr_comp.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define CCSDS_SEQ_MASK      0x3FFF
+#define CCSDS_LEN_OFFSET    4
+#define CCSDS_MIN_HDR_LEN   6
+#define TIME_MASK           0xFFFFFFFFFFFFull   /* HDR_COMP_TIME_LEN bytes */
+#define MAX_SEQ_DELTA       0xFF
+#define MAX_TIME_DELTA_LEN  3
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static HDR_COMP_Ctx_t *FindCtx(HDR_COMP_Class_t *HdrComp, const uint8_t *Msg);
+static uint16_t GetSeq(const uint8_t *Hdr);
+static uint64_t GetTime(const HDR_COMP_Class_t *HdrComp, const uint8_t *Hdr);
+static void     SetTime(const HDR_COMP_Class_t *HdrComp, uint8_t *Hdr, uint64_t Time);
+static bool     StaticMatch(const HDR_COMP_Class_t *HdrComp, const uint8_t *Hdr, const uint8_t *RefHdr);
+
+
+/******************************************************************************
+** Function: HDR_COMP_Constructor
+**
+*/
+void HDR_COMP_Constructor(HDR_COMP_Class_t *HdrComp, uint16_t HdrLen, uint16_t TimeOffset, uint16_t RefreshCnt)
+{
+
+   memset(HdrComp, 0, sizeof(HDR_COMP_Class_t));
+
+   HdrComp->HdrLen     = (HdrLen < HDR_COMP_MAX_HDR_LEN) ? HdrLen : HDR_COMP_MAX_HDR_LEN;
+   HdrComp->TimeOffset = TimeOffset;
+   HdrComp->RefreshCnt = (RefreshCnt < MAX_SEQ_DELTA) ? RefreshCnt : MAX_SEQ_DELTA;
+
+   /* A header too short for the fields is always sent RAW */
+   if (HdrComp->HdrLen < CCSDS_MIN_HDR_LEN || TimeOffset < CCSDS_MIN_HDR_LEN ||
+       TimeOffset + HDR_COMP_TIME_LEN > HdrComp->HdrLen)
+   {
+      HdrComp->HdrLen = 0;
+   }
+
+} /* End HDR_COMP_Constructor() */
+
+
+/******************************************************************************
+** Function: HDR_COMP_Reset
+**
+*/
+void HDR_COMP_Reset(HDR_COMP_Class_t *HdrComp)
+{
+
+   uint16_t i;
+
+   HdrComp->UseClock     = 0;
+   HdrComp->RawCnt       = 0;
+   HdrComp->FullCnt      = 0;
+   HdrComp->CompCnt      = 0;
+   HdrComp->MsgByteCnt   = 0;
+   HdrComp->CompByteCnt  = 0;
+   HdrComp->ExpandCnt    = 0;
+   HdrComp->CtxErrCnt    = 0;
+   HdrComp->FormatErrCnt = 0;
+
+   /* The generations continue so an expander's old context can't match */
+   for (i=0; i < HDR_COMP_CTX_CNT; i++)
+   {
+      HdrComp->Ctx[i].Valid = false;
+   }
+
+} /* End HDR_COMP_Reset() */
+
+
+/******************************************************************************
+** Function: HDR_COMP_Compress
+**
+*/
+uint16_t HDR_COMP_Compress(HDR_COMP_Class_t *HdrComp, const uint8_t *Msg, uint16_t MsgLen,
+                           uint8_t *Out, uint16_t OutMax)
+{
+
+   uint16_t HdrLen = HdrComp->HdrLen;
+   uint16_t DataLen;
+   uint16_t OutLen;
+   uint16_t SeqDelta;
+   uint64_t TimeDelta;
+   uint8_t  TimeLen;
+   uint8_t  CtxIdx;
+   uint8_t  i;
+   HDR_COMP_Ctx_t *Ctx;
+
+   if (HdrLen == 0 || MsgLen < HdrLen ||
+       ((Msg[CCSDS_LEN_OFFSET] << 8) | Msg[CCSDS_LEN_OFFSET+1]) != MsgLen - 7)
+   {
+
+      if (MsgLen + 1 > OutMax)
+      {
+         return 0;
+      }
+      Out[0] = HDR_COMP_KIND_RAW << 5;
+      memcpy(&Out[1], Msg, MsgLen);
+      OutLen = MsgLen + 1;
+      HdrComp->RawCnt++;
+
+   }
+   else
+   {
+
+      DataLen = MsgLen - HdrLen;
+      Ctx     = FindCtx(HdrComp, Msg);
+      CtxIdx  = (uint8_t)(Ctx - HdrComp->Ctx);
+
+      SeqDelta  = (GetSeq(Msg) - Ctx->RefSeq) & CCSDS_SEQ_MASK;
+      TimeDelta = (GetTime(HdrComp, Msg) - Ctx->RefTime) & TIME_MASK;
+
+      if (Ctx->Valid && Ctx->UseCnt < HdrComp->RefreshCnt && SeqDelta <= MAX_SEQ_DELTA &&
+          TimeDelta < (1ul << (8*MAX_TIME_DELTA_LEN)) && StaticMatch(HdrComp, Msg, Ctx->Hdr))
+      {
+
+         for (TimeLen=0; TimeLen < MAX_TIME_DELTA_LEN && (TimeDelta >> (8*TimeLen)) != 0; TimeLen++);
+
+         OutLen = 2 + TimeLen + DataLen;
+         if (OutLen > OutMax)
+         {
+            return 0;
+         }
+
+         Out[0] = (uint8_t)(((HDR_COMP_KIND_COMP + TimeLen) << 5) | (CtxIdx << 2) | Ctx->Gen);
+         Out[1] = (uint8_t)SeqDelta;
+         for (i=0; i < TimeLen; i++)
+         {
+            Out[2+i] = (uint8_t)(TimeDelta >> (8*(TimeLen-1-i)));
+         }
+         memcpy(&Out[2+TimeLen], &Msg[HdrLen], DataLen);
+
+         Ctx->UseCnt++;
+         HdrComp->CompCnt++;
+
+      }
+      else
+      {
+
+         OutLen = MsgLen + 1;
+         if (OutLen > OutMax)
+         {
+            return 0;
+         }
+
+         Ctx->Valid   = true;
+         Ctx->Gen     = (Ctx->Gen + 1) & 0x03;
+         Ctx->UseCnt  = 0;
+         Ctx->RefSeq  = GetSeq(Msg);
+         Ctx->RefTime = GetTime(HdrComp, Msg);
+         memcpy(Ctx->Hdr, Msg, HdrLen);
+
+         Out[0] = (uint8_t)((HDR_COMP_KIND_FULL << 5) | (CtxIdx << 2) | Ctx->Gen);
+         memcpy(&Out[1], Msg, MsgLen);
+         HdrComp->FullCnt++;
+
+      }
+
+      Ctx->LastUse = ++HdrComp->UseClock;
+
+   }
+
+   HdrComp->MsgByteCnt  += MsgLen;
+   HdrComp->CompByteCnt += OutLen;
+
+   return OutLen;
+
+} /* End HDR_COMP_Compress() */
+
+
+/******************************************************************************
+** Function: HDR_COMP_Expand
+**
+*/
+uint16_t HDR_COMP_Expand(HDR_COMP_Class_t *HdrComp, const uint8_t *In, uint16_t InLen,
+                         uint8_t *Msg, uint16_t MsgMax)
+{
+
+   uint16_t HdrLen = HdrComp->HdrLen;
+   uint16_t MsgLen;
+   uint16_t Seq;
+   uint64_t TimeDelta = 0;
+   uint8_t  Kind;
+   uint8_t  TimeLen;
+   uint8_t  i;
+   HDR_COMP_Ctx_t *Ctx;
+
+   if (InLen < 1)
+   {
+      HdrComp->FormatErrCnt++;
+      return 0;
+   }
+
+   Kind = In[0] >> 5;
+   Ctx  = &HdrComp->Ctx[(In[0] >> 2) & (HDR_COMP_CTX_CNT-1)];
+
+   if (Kind == HDR_COMP_KIND_RAW || Kind == HDR_COMP_KIND_FULL)
+   {
+
+      MsgLen = InLen - 1;
+      if (MsgLen > MsgMax || (Kind == HDR_COMP_KIND_FULL && (HdrLen == 0 || MsgLen < HdrLen)))
+      {
+         HdrComp->FormatErrCnt++;
+         return 0;
+      }
+
+      memcpy(Msg, &In[1], MsgLen);
+
+      if (Kind == HDR_COMP_KIND_FULL)
+      {
+         Ctx->Valid   = true;
+         Ctx->Gen     = In[0] & 0x03;
+         Ctx->RefSeq  = GetSeq(Msg);
+         Ctx->RefTime = GetTime(HdrComp, Msg);
+         memcpy(Ctx->Hdr, Msg, HdrLen);
+      }
+
+   }
+   else
+   {
+
+      TimeLen = Kind - HDR_COMP_KIND_COMP;
+      if (TimeLen > MAX_TIME_DELTA_LEN || InLen < 2 + TimeLen ||
+          HdrLen + InLen - 2 - TimeLen > MsgMax)
+      {
+         HdrComp->FormatErrCnt++;
+         return 0;
+      }
+
+      if (!Ctx->Valid || Ctx->Gen != (In[0] & 0x03))
+      {
+         HdrComp->CtxErrCnt++;
+         return 0;
+      }
+
+      for (i=0; i < TimeLen; i++)
+      {
+         TimeDelta = (TimeDelta << 8) | In[2+i];
+      }
+
+      MsgLen = HdrLen + InLen - 2 - TimeLen;
+      memcpy(Msg, Ctx->Hdr, HdrLen);
+      memcpy(&Msg[HdrLen], &In[2+TimeLen], InLen - 2 - TimeLen);
+
+      Seq = (Ctx->RefSeq + In[1]) & CCSDS_SEQ_MASK;
+      Msg[2] = (uint8_t)((Msg[2] & ~(CCSDS_SEQ_MASK >> 8)) | (Seq >> 8));
+      Msg[3] = (uint8_t)Seq;
+      Msg[CCSDS_LEN_OFFSET]   = (uint8_t)((MsgLen - 7) >> 8);
+      Msg[CCSDS_LEN_OFFSET+1] = (uint8_t)(MsgLen - 7);
+      SetTime(HdrComp, Msg, Ctx->RefTime + TimeDelta);
+
+   }
+
+   HdrComp->ExpandCnt++;
+
+   return MsgLen;
+
+} /* End HDR_COMP_Expand() */
+
+
+/******************************************************************************
+** Function: FindCtx
+**
+** Return the stream's context or the context to replace with it
+**
+** Notes:
+**   1. A stream is identified by the CCSDS stream ID, the first two header
+**      bytes. An unused context is taken before the least recently used
+**      one is replaced.
+**
+*/
+static HDR_COMP_Ctx_t *FindCtx(HDR_COMP_Class_t *HdrComp, const uint8_t *Msg)
+{
+
+   HDR_COMP_Ctx_t *Ctx;
+   HDR_COMP_Ctx_t *Free   = NULL;
+   HDR_COMP_Ctx_t *Oldest = &HdrComp->Ctx[0];
+   uint16_t i;
+
+   for (i=0; i < HDR_COMP_CTX_CNT; i++)
+   {
+      Ctx = &HdrComp->Ctx[i];
+      if (!Ctx->Valid)
+      {
+         Free = Ctx;
+      }
+      else if (Ctx->Hdr[0] == Msg[0] && Ctx->Hdr[1] == Msg[1])
+      {
+         return Ctx;
+      }
+      else if (Ctx->LastUse < Oldest->LastUse)
+      {
+         Oldest = Ctx;
+      }
+   }
+
+   return (Free != NULL) ? Free : Oldest;
+
+} /* End FindCtx() */
+
+
+/******************************************************************************
+** Function: GetSeq
+**
+*/
+static uint16_t GetSeq(const uint8_t *Hdr)
+{
+
+   return ((Hdr[2] << 8) | Hdr[3]) & CCSDS_SEQ_MASK;
+
+} /* End GetSeq() */
+
+
+/******************************************************************************
+** Function: GetTime
+**
+*/
+static uint64_t GetTime(const HDR_COMP_Class_t *HdrComp, const uint8_t *Hdr)
+{
+
+   uint64_t Time = 0;
+   uint16_t i;
+
+   for (i=0; i < HDR_COMP_TIME_LEN; i++)
+   {
+      Time = (Time << 8) | Hdr[HdrComp->TimeOffset + i];
+   }
+
+   return Time;
+
+} /* End GetTime() */
+
+
+/******************************************************************************
+** Function: SetTime
+**
+*/
+static void SetTime(const HDR_COMP_Class_t *HdrComp, uint8_t *Hdr, uint64_t Time)
+{
+
+   uint16_t i;
+
+   for (i=HDR_COMP_TIME_LEN; i > 0; i--)
+   {
+      Hdr[HdrComp->TimeOffset + i - 1] = (uint8_t)Time;
+      Time >>= 8;
+   }
+
+} /* End SetTime() */
+
+
+/******************************************************************************
+** Function: StaticMatch
+**
+** Return whether the header bytes other than the sequence count, length
+** and time stamp match the reference header
+**
+*/
+static bool StaticMatch(const HDR_COMP_Class_t *HdrComp, const uint8_t *Hdr, const uint8_t *RefHdr)
+{
+
+   if (Hdr[0] != RefHdr[0] || Hdr[1] != RefHdr[1] ||
+       ((Hdr[2] ^ RefHdr[2]) & ~(CCSDS_SEQ_MASK >> 8) & 0xFF) != 0)
+   {
+      return false;
+   }
+
+   return memcmp(&Hdr[CCSDS_MIN_HDR_LEN], &RefHdr[CCSDS_MIN_HDR_LEN], HdrComp->TimeOffset - CCSDS_MIN_HDR_LEN) == 0 &&
+          memcmp(&Hdr[HdrComp->TimeOffset + HDR_COMP_TIME_LEN], &RefHdr[HdrComp->TimeOffset + HDR_COMP_TIME_LEN],
+                 HdrComp->HdrLen - HdrComp->TimeOffset - HDR_COMP_TIME_LEN) == 0;
+
+} /* End StaticMatch() */
@@ -0,0 +1,189 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the over-the-air LoRa frame header
+**
+**  Notes:
+**    1. See lora_frame.h file prologue.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "lora_frame.h"
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static uint32_t GetUint32(const uint8_t *Buf);
+static void PutUint32(uint8_t *Buf, uint32_t Value);
+
+
+/******************************************************************************
+** Function: LORA_FRAME_EncodeHdr
+**
+*/
+uint16_t LORA_FRAME_EncodeHdr(uint8_t *Frame, const LORA_FRAME_Hdr_t *Hdr)
+{
+
+   uint16_t HdrLen = LORA_FRAME_MIN_HDR_LEN;
+
+   Frame[0] = Hdr->Type;
+   Frame[1] = Hdr->Flags;
+   Frame[2] = (uint8_t)(Hdr->Seq >> 8);
+   Frame[3] = (uint8_t)(Hdr->Seq);
+
+   if (Hdr->Flags & LORA_FRAME_FLAG_HOP_MASK)
+   {
+      PutUint32(&Frame[HdrLen], Hdr->HopMask);
+      HdrLen += 4;
+   }
+
+   if (Hdr->Flags & LORA_FRAME_FLAG_TIMESTAMP)
+   {
+      PutUint32(&Frame[HdrLen], Hdr->Timestamp);
+      HdrLen += 4;
+   }
+
+   if (Hdr->Flags & LORA_FRAME_FLAG_TIME_EXCH)
+   {
+      PutUint32(&Frame[HdrLen],   Hdr->ExchEcho);
+      PutUint32(&Frame[HdrLen+4], Hdr->ExchRx);
+      PutUint32(&Frame[HdrLen+8], Hdr->ExchTx);
+      HdrLen += 12;
+   }
+
+   if (Hdr->Flags & LORA_FRAME_FLAG_ROUTE)
+   {
+      Frame[HdrLen]   = Hdr->Route.Src;
+      Frame[HdrLen+1] = Hdr->Route.Dst;
+      Frame[HdrLen+2] = Hdr->Route.NextHop;
+      Frame[HdrLen+3] = Hdr->Route.HopCnt;
+      Frame[HdrLen+4] = (uint8_t)(Hdr->Route.MsgId >> 8);
+      Frame[HdrLen+5] = (uint8_t)(Hdr->Route.MsgId);
+      HdrLen += LORA_FRAME_ROUTE_LEN;
+   }
+
+   return HdrLen;
+
+} /* End LORA_FRAME_EncodeHdr() */
+
+
+/******************************************************************************
+** Function: LORA_FRAME_DecodeHdr
+**
+*/
+uint16_t LORA_FRAME_DecodeHdr(const uint8_t *Frame, uint16_t FrameLen, LORA_FRAME_Hdr_t *Hdr)
+{
+
+   uint16_t HdrLen = LORA_FRAME_MIN_HDR_LEN;
+
+   if (FrameLen < LORA_FRAME_MIN_HDR_LEN)
+   {
+      return 0;
+   }
+
+   Hdr->Type      = Frame[0];
+   Hdr->Flags     = Frame[1];
+   Hdr->Seq       = ((uint16_t)Frame[2] << 8) | Frame[3];
+   Hdr->HopMask   = 0;
+   Hdr->Timestamp = 0;
+   Hdr->ExchEcho  = 0;
+   Hdr->ExchRx    = 0;
+   Hdr->ExchTx    = 0;
+   memset(&Hdr->Route, 0, sizeof(Hdr->Route));
+
+   if (Hdr->Flags & LORA_FRAME_FLAG_HOP_MASK)
+   {
+      if (FrameLen < HdrLen + 4)
+      {
+         return 0;
+      }
+      Hdr->HopMask = GetUint32(&Frame[HdrLen]);
+      HdrLen += 4;
+   }
+
+   if (Hdr->Flags & LORA_FRAME_FLAG_TIMESTAMP)
+   {
+      if (FrameLen < HdrLen + 4)
+      {
+         return 0;
+      }
+      Hdr->Timestamp = GetUint32(&Frame[HdrLen]);
+      HdrLen += 4;
+   }
+
+   if (Hdr->Flags & LORA_FRAME_FLAG_TIME_EXCH)
+   {
+      if (FrameLen < HdrLen + 12)
+      {
+         return 0;
+      }
+      Hdr->ExchEcho = GetUint32(&Frame[HdrLen]);
+      Hdr->ExchRx   = GetUint32(&Frame[HdrLen+4]);
+      Hdr->ExchTx   = GetUint32(&Frame[HdrLen+8]);
+      HdrLen += 12;
+   }
+
+   if (Hdr->Flags & LORA_FRAME_FLAG_ROUTE)
+   {
+      if (FrameLen < HdrLen + LORA_FRAME_ROUTE_LEN)
+      {
+         return 0;
+      }
+      Hdr->Route.Src     = Frame[HdrLen];
+      Hdr->Route.Dst     = Frame[HdrLen+1];
+      Hdr->Route.NextHop = Frame[HdrLen+2];
+      Hdr->Route.HopCnt  = Frame[HdrLen+3];
+      Hdr->Route.MsgId   = ((uint16_t)Frame[HdrLen+4] << 8) | Frame[HdrLen+5];
+      HdrLen += LORA_FRAME_ROUTE_LEN;
+   }
+
+   return HdrLen;
+
+} /* End LORA_FRAME_DecodeHdr() */
+
+
+/******************************************************************************
+** Function: GetUint32
+**
+*/
+static uint32_t GetUint32(const uint8_t *Buf)
+{
+
+   return ((uint32_t)Buf[0] << 24) | ((uint32_t)Buf[1] << 16) |
+          ((uint32_t)Buf[2] << 8) | (uint32_t)Buf[3];
+
+} /* End GetUint32() */
+
+
+/******************************************************************************
+** Function: PutUint32
+**
+*/
+static void PutUint32(uint8_t *Buf, uint32_t Value)
+{
+
+   Buf[0] = (uint8_t)(Value >> 24);
+   Buf[1] = (uint8_t)(Value >> 16);
+   Buf[2] = (uint8_t)(Value >> 8);
+   Buf[3] = (uint8_t)(Value);
+
+} /* End PutUint32() */
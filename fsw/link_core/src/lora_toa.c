@@ -0,0 +1,135 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the LoRa time-on-air calculations
+**
+**  Notes:
+**    1. See lora_toa.h file prologue.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include "lora_toa.h"
+
+
+/******************************************************************************
+** Function: LORA_TOA_TimeOnAir
+**
+*/
+uint32_t LORA_TOA_TimeOnAir(uint8_t SpreadingFactor, uint8_t Bandwidth, uint8_t CodingRate,
+                            uint16_t PreambleLen, uint16_t PayloadLen)
+{
+
+   return LORA_TOA_FrameTimeOnAir(SpreadingFactor, Bandwidth, CodingRate, PreambleLen, false, PayloadLen);
+
+} /* End LORA_TOA_TimeOnAir() */
+
+
+/******************************************************************************
+** Function: LORA_TOA_FrameTimeOnAir
+**
+** Notes:
+**   1. The symbol count is computed in quarter symbols to keep the
+**      fractional preamble terms exact.
+**
+*/
+uint32_t LORA_TOA_FrameTimeOnAir(uint8_t SpreadingFactor, uint8_t Bandwidth, uint8_t CodingRate,
+                                 uint16_t PreambleLen, bool ImplicitHeader, uint16_t PayloadLen)
+{
+
+   uint32_t Sf = SpreadingFactor >> 4;
+   uint32_t Cr = CodingRate & 0x07;
+   int32_t  PayloadBits;
+   uint32_t BitsPerSymbol;
+   uint32_t SymbolCntX4;
+   uint32_t SymbolNsec = LORA_TOA_SymbolNsec(SpreadingFactor, Bandwidth);
+
+   /* Long interleaving coding rates use the same redundancy as 4/5, 4/6 and 4/8 */
+   if (Cr == 7)
+   {
+      Cr = 4;
+   }
+   else if (Cr > 4)
+   {
+      Cr -= 4;
+   }
+
+   if (SymbolNsec == 0 || Cr == 0)
+   {
+      return 0;
+   }
+
+   PayloadBits   = 8*PayloadLen + 16 - 4*Sf;  /* CRC on */
+   BitsPerSymbol = 4*Sf;
+
+   if (!ImplicitHeader)
+   {
+      PayloadBits += 20;
+   }
+
+   if (Sf < 7)
+   {
+      SymbolCntX4 = 4*(uint32_t)PreambleLen + 25 + 32;
+   }
+   else
+   {
+      PayloadBits += 8;
+      SymbolCntX4  = 4*(uint32_t)PreambleLen + 17 + 32;
+      if (Sf > 10)
+      {
+         BitsPerSymbol = 4*(Sf-2);
+      }
+   }
+
+   if (PayloadBits > 0)
+   {
+      SymbolCntX4 += 4*((PayloadBits + BitsPerSymbol - 1)/BitsPerSymbol)*(Cr + 4);
+   }
+
+   return (uint32_t)(((uint64_t)SymbolCntX4*SymbolNsec)/4000);
+
+} /* End LORA_TOA_FrameTimeOnAir() */
+
+
+/******************************************************************************
+** Function: LORA_TOA_SymbolNsec
+**
+*/
+uint32_t LORA_TOA_SymbolNsec(uint8_t SpreadingFactor, uint8_t Bandwidth)
+{
+
+   uint32_t BandwidthHz;
+   uint32_t Sf = SpreadingFactor >> 4;
+
+   switch (Bandwidth)
+   {
+      case 0x34: BandwidthHz =  203125; break;
+      case 0x26: BandwidthHz =  406250; break;
+      case 0x18: BandwidthHz =  812500; break;
+      case 0x0A: BandwidthHz = 1625000; break;
+      default:   BandwidthHz = 0;
+   }
+
+   if (BandwidthHz == 0 || Sf < 5 || Sf > 12)
+   {
+      return 0;
+   }
+
+   return (uint32_t)(((uint64_t)1000000000 << Sf)/BandwidthHz);
+
+} /* End LORA_TOA_SymbolNsec() */
@@ -0,0 +1,286 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the goodput optimal payload length estimator
+**
+**  Notes:
+**    1. See pkt_len.h file prologue.
+**    2. A window's byte survival q is the N'th root of its frame success
+**       rate. It's found by bisection on q^N, which takes 30 steps of a
+**       handful of multiplies for the frame lengths LoRa allows.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "lora_toa.h"
+#include "pkt_len.h"
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static uint16_t Efficiency(const PKT_LEN_Class_t *PktLen, uint16_t CandIdx, uint32_t SuccessQ30);
+static uint64_t Goodput(const PKT_LEN_Class_t *PktLen, uint16_t CandIdx, uint32_t ByteSurvivalQ30);
+static uint32_t PowQ30(uint32_t X, uint16_t N);
+static uint32_t RootQ30(uint32_t X, uint16_t N);
+
+
+/******************************************************************************
+** Function: PKT_LEN_Init
+**
+*/
+void PKT_LEN_Init(PKT_LEN_Class_t *PktLen, uint8_t SpreadingFactor, uint8_t Bandwidth,
+                  uint8_t CodingRate, uint16_t PreambleLen, uint16_t OverheadLen,
+                  uint16_t MinLen, uint16_t MaxLen, uint16_t Step)
+{
+
+   uint16_t Len;
+   uint16_t i;
+
+   memset(PktLen, 0, sizeof(PKT_LEN_Class_t));
+
+   PktLen->OverheadLen = OverheadLen;
+
+   if (Step == 0)
+   {
+      Step = 1;
+   }
+   if (MaxLen == 0)
+   {
+      MaxLen = 1;
+   }
+
+   for (Len = (MinLen < Step ? Step : MinLen);
+        Len < MaxLen && PktLen->CandCnt < (PKT_LEN_MAX_CAND-1); Len += Step)
+   {
+      PktLen->CandLen[PktLen->CandCnt++] = Len;
+   }
+   PktLen->CandLen[PktLen->CandCnt++] = MaxLen;
+
+   for (i=0; i < PktLen->CandCnt; i++)
+   {
+      PktLen->CandToaUsec[i] = LORA_TOA_TimeOnAir(SpreadingFactor, Bandwidth, CodingRate, PreambleLen,
+                                                  OverheadLen + PktLen->CandLen[i]);
+      if (PktLen->CandToaUsec[i] == 0)
+      {
+         PktLen->CandToaUsec[i] = 1;   /* Invalid modulation, keeps the ratios defined */
+      }
+   }
+
+   PktLen->CandIdx      = PktLen->CandCnt - 1;
+   PktLen->RefToaUsec   = PktLen->CandToaUsec[PktLen->CandIdx];
+   PktLen->PredictedPpt = 1000;
+
+} /* End PKT_LEN_Init() */
+
+
+/******************************************************************************
+** Function: PKT_LEN_Len
+**
+*/
+uint16_t PKT_LEN_Len(const PKT_LEN_Class_t *PktLen)
+{
+
+   return PktLen->CandLen[PktLen->CandIdx];
+
+} /* End PKT_LEN_Len() */
+
+
+/******************************************************************************
+** Function: PKT_LEN_RecordWindow
+**
+** Notes:
+**   1. A window with no frames received counts as half a frame received so
+**      the byte loss stays below 1 and the shortest length is chosen.
+**
+*/
+uint16_t PKT_LEN_RecordWindow(PKT_LEN_Class_t *PktLen, uint32_t SentCnt, uint32_t RcvdCnt)
+{
+
+   uint32_t SuccessQ30;
+   uint32_t ByteLossQ30;
+   uint32_t ByteSurvivalQ30;
+   uint64_t BestGoodput = 0;
+   uint64_t CandGoodput;
+   uint64_t CurGoodput;
+   uint16_t BestIdx = PktLen->CandIdx;
+   uint16_t i;
+
+   if (SentCnt == 0)
+   {
+      return PKT_LEN_Len(PktLen);
+   }
+   if (RcvdCnt > SentCnt)
+   {
+      RcvdCnt = SentCnt;
+   }
+
+   SuccessQ30 = (uint32_t)(((uint64_t)RcvdCnt << 30) / SentCnt);
+   PktLen->AchievedPpt = Efficiency(PktLen, PktLen->CandIdx, SuccessQ30);
+
+   if (RcvdCnt == 0)
+   {
+      SuccessQ30 = (uint32_t)(PKT_LEN_Q30_ONE / (2 * (uint64_t)SentCnt));
+   }
+   ByteLossQ30 = PKT_LEN_Q30_ONE - RootQ30(SuccessQ30, PktLen->OverheadLen + PKT_LEN_Len(PktLen));
+
+   if (PktLen->LossValid)
+   {
+      PktLen->ByteLossQ30 = (uint32_t)((int64_t)PktLen->ByteLossQ30 +
+                                       ((int64_t)ByteLossQ30 - (int64_t)PktLen->ByteLossQ30) / (1 << PKT_LEN_EWMA_SHIFT));
+   }
+   else
+   {
+      PktLen->ByteLossQ30 = ByteLossQ30;
+      PktLen->LossValid   = true;
+   }
+
+   ByteSurvivalQ30 = PKT_LEN_Q30_ONE - PktLen->ByteLossQ30;
+
+   for (i=0; i < PktLen->CandCnt; i++)
+   {
+      CandGoodput = Goodput(PktLen, i, ByteSurvivalQ30);
+      if (CandGoodput > BestGoodput)
+      {
+         BestGoodput = CandGoodput;
+         BestIdx     = i;
+      }
+   }
+
+   CurGoodput = Goodput(PktLen, PktLen->CandIdx, ByteSurvivalQ30);
+   if (BestGoodput > CurGoodput + CurGoodput/PKT_LEN_HYSTERESIS)
+   {
+      PktLen->CandIdx = BestIdx;
+   }
+
+   PktLen->PredictedPpt = Efficiency(PktLen, PktLen->CandIdx,
+                                     PowQ30(ByteSurvivalQ30, PktLen->OverheadLen + PKT_LEN_Len(PktLen)));
+
+   return PKT_LEN_Len(PktLen);
+
+} /* End PKT_LEN_RecordWindow() */
+
+
+/******************************************************************************
+** Function: PKT_LEN_ByteLossPpm
+**
+*/
+uint32_t PKT_LEN_ByteLossPpm(const PKT_LEN_Class_t *PktLen)
+{
+
+   return (uint32_t)(((uint64_t)PktLen->ByteLossQ30 * 1000000) >> 30);
+
+} /* End PKT_LEN_ByteLossPpm() */
+
+
+/******************************************************************************
+** Function: Efficiency
+**
+** Return the goodput of a candidate with a frame success rate relative to
+** loss-free maximum length frames, in parts per thousand
+**
+** Notes:
+**   1. Len*Success is reduced to Q10 before the airtime product so nothing
+**      overflows for the longest LoRa frames.
+**
+*/
+static uint16_t Efficiency(const PKT_LEN_Class_t *PktLen, uint16_t CandIdx, uint32_t SuccessQ30)
+{
+
+   uint64_t Num = (((uint64_t)PktLen->CandLen[CandIdx] * SuccessQ30) >> 20) * PktLen->RefToaUsec * 1000;
+   uint64_t Den = ((uint64_t)PktLen->CandLen[PktLen->CandCnt-1] * PktLen->CandToaUsec[CandIdx]) << 10;
+
+   return (uint16_t)(Num / Den);
+
+} /* End Efficiency() */
+
+
+/******************************************************************************
+** Function: Goodput
+**
+** Return a candidate's expected payload bytes per microsecond, scaled by 2^30
+**
+*/
+static uint64_t Goodput(const PKT_LEN_Class_t *PktLen, uint16_t CandIdx, uint32_t ByteSurvivalQ30)
+{
+
+   uint32_t SuccessQ30 = PowQ30(ByteSurvivalQ30, PktLen->OverheadLen + PktLen->CandLen[CandIdx]);
+
+   return ((uint64_t)PktLen->CandLen[CandIdx] * SuccessQ30) / PktLen->CandToaUsec[CandIdx];
+
+} /* End Goodput() */
+
+
+/******************************************************************************
+** Function: PowQ30
+**
+** Return X^N for a Q30 probability X
+**
+*/
+static uint32_t PowQ30(uint32_t X, uint16_t N)
+{
+
+   uint64_t Result = PKT_LEN_Q30_ONE;
+   uint64_t Square = X;
+
+   while (N)
+   {
+      if (N & 1)
+      {
+         Result = (Result * Square) >> 30;
+      }
+      Square = (Square * Square) >> 30;
+      N >>= 1;
+   }
+
+   return (uint32_t)Result;
+
+} /* End PowQ30() */
+
+
+/******************************************************************************
+** Function: RootQ30
+**
+** Return the largest Q30 probability whose N'th power doesn't exceed X
+**
+*/
+static uint32_t RootQ30(uint32_t X, uint16_t N)
+{
+
+   uint32_t Low  = 0;
+   uint32_t High = PKT_LEN_Q30_ONE;
+   uint32_t Mid;
+
+   while (Low < High)
+   {
+      Mid = Low + (High - Low + 1)/2;
+      if (PowQ30(Mid, N) <= X)
+      {
+         Low = Mid;
+      }
+      else
+      {
+         High = Mid - 1;
+      }
+   }
+
+   return Low;
+
+} /* End RootQ30() */
@@ -0,0 +1,104 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the packet map used to reassemble a transfer
+**
+**  Notes:
+**    1. See pkt_map.h file prologue.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "pkt_map.h"
+
+
+/******************************************************************************
+** Function: PKT_MAP_Clear
+**
+*/
+void PKT_MAP_Clear(PKT_MAP_Class_t *PktMap)
+{
+
+   memset(PktMap, 0, sizeof(PKT_MAP_Class_t));
+
+} /* End PKT_MAP_Clear() */
+
+
+/******************************************************************************
+** Function: PKT_MAP_Test
+**
+*/
+bool PKT_MAP_Test(const PKT_MAP_Class_t *PktMap, uint16_t Seq)
+{
+
+   return (PktMap->Bits[Seq/8] & (1 << (Seq%8))) != 0;
+
+} /* End PKT_MAP_Test() */
+
+
+/******************************************************************************
+** Function: PKT_MAP_Set
+**
+*/
+bool PKT_MAP_Set(PKT_MAP_Class_t *PktMap, uint16_t Seq)
+{
+
+   uint8_t SeqBit = (uint8_t)(1 << (Seq%8));
+
+   if (Seq == 0 || (PktMap->Bits[Seq/8] & SeqBit))
+   {
+      return false;
+   }
+
+   PktMap->Bits[Seq/8] |= SeqBit;
+   PktMap->SetCnt++;
+
+   return true;
+
+} /* End PKT_MAP_Set() */
+
+
+/******************************************************************************
+** Function: PKT_MAP_NextMissing
+**
+*/
+uint16_t PKT_MAP_NextMissing(const PKT_MAP_Class_t *PktMap, uint16_t Seq, uint16_t PktCnt)
+{
+
+   uint32_t i = (Seq > 0) ? Seq : 1;
+
+   while (i <= PktCnt)
+   {
+      if (i%8 == 0 && PktMap->Bits[i/8] == 0xFF)
+      {
+         i += 8;
+      }
+      else if (!PKT_MAP_Test(PktMap, (uint16_t)i))
+      {
+         return (uint16_t)i;
+      }
+      else
+      {
+         i++;
+      }
+   }
+
+   return 0;
+
+} /* End PKT_MAP_NextMissing() */
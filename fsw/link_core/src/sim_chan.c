@@ -0,0 +1,124 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the simulated LoRa channel model
+**
+**  Notes:
+**    1. See sim_chan.h file prologue.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "sim_chan.h"
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static uint32_t Rand(SIM_CHAN_Class_t *SimChan);
+
+
+/******************************************************************************
+** Function: SIM_CHAN_Constructor
+**
+*/
+void SIM_CHAN_Constructor(SIM_CHAN_Class_t *SimChan, const SIM_CHAN_Cfg_t *Cfg, uint32_t Seed)
+{
+
+   memset(SimChan, 0, sizeof(SIM_CHAN_Class_t));
+
+   SimChan->Cfg       = *Cfg;
+   SimChan->RandState = (Seed == 0) ? 1 : Seed;
+
+} /* End SIM_CHAN_Constructor() */
+
+
+/******************************************************************************
+** Function: SIM_CHAN_Delivers
+**
+*/
+bool SIM_CHAN_Delivers(SIM_CHAN_Class_t *SimChan, uint8_t SpreadingFactor, int8_t *Snr)
+{
+
+   const SIM_CHAN_Cfg_t *Cfg = &SimChan->Cfg;
+   int32_t  Gaussian = 0;
+   int32_t  SnrDb10;
+   int32_t  LimitDb10;
+   uint16_t i;
+
+   if (SimChan->BurstState)
+   {
+      if ((Rand(SimChan) % 1000) < Cfg->BurstExitPpt)
+      {
+         SimChan->BurstState = false;
+      }
+   }
+   else if ((Rand(SimChan) % 1000) < Cfg->BurstEnterPpt)
+   {
+      SimChan->BurstState = true;
+      SimChan->BurstCnt++;
+   }
+
+   if (SimChan->BurstState && (Rand(SimChan) % 1000) < Cfg->BurstLossPpt)
+   {
+      return false;
+   }
+
+   if ((Rand(SimChan) % 1000) < Cfg->LossPpt)
+   {
+      return false;
+   }
+
+   for (i=0; i < 12; i++)
+   {
+      Gaussian += (int32_t)(Rand(SimChan) % 1000);
+   }
+   Gaussian -= 6000;  /* Standard normal in thousandths */
+
+   SnrDb10   = Cfg->SnrMeanDb*10 + (Cfg->SnrStdDevDb*Gaussian)/100;
+   LimitDb10 = -25*((SpreadingFactor >> 4) - 4);
+
+   *Snr = (int8_t)(SnrDb10/10);
+
+   return (SnrDb10 >= LimitDb10);
+
+} /* End SIM_CHAN_Delivers() */
+
+
+/******************************************************************************
+** Function: Rand
+**
+** Xorshift32 pseudo random number generator
+**
+*/
+static uint32_t Rand(SIM_CHAN_Class_t *SimChan)
+{
+
+   uint32_t x = SimChan->RandState;
+
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+
+   SimChan->RandState = x;
+
+   return x;
+
+} /* End Rand() */
@@ -0,0 +1,368 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Host unit tests for the link core library
+**
+**  Notes:
+**    1. Run by ctest, see link_core/CMakeLists.txt. Each failed check
+**       prints its location and the program exits with a failure status.
+**    2. The time-on-air reference values were computed from the SX1280
+**       datasheet section 7.4.4 formula in floating point, not from
+**       lora_toa.c, so they catch a formula error. The library truncates
+**       the symbol time to nanoseconds so a result may be 1us short.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "hdr_comp.h"
+#include "lora_frame.h"
+#include "lora_toa.h"
+#include "pkt_map.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define CHECK(Cond)  Check((Cond), #Cond, __FILE__, __LINE__)
+
+#define TEST_ARRAY_LEN(a)  (sizeof(a)/sizeof((a)[0]))
+
+/* cFE telemetry header: CCSDS primary (6), time (6), spare (4) */
+#define TEST_TLM_HDR_LEN     16
+#define TEST_TLM_TIME_OFFSET  6
+#define TEST_TLM_DATA_LEN    20
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef struct
+{
+
+   uint8_t   SpreadingFactor;   /* SX128x register encodings */
+   uint8_t   Bandwidth;
+   uint8_t   CodingRate;
+   uint16_t  PreambleLen;
+   bool      ImplicitHeader;
+   uint16_t  PayloadLen;
+   uint32_t  RefUsec;
+
+} TOA_Ref_t;
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void Check(bool Cond, const char *CondStr, const char *File, int Line);
+static void BuildTlmMsg(uint8_t *Msg, uint16_t StreamId, uint16_t Seq, uint64_t Time, uint8_t Fill);
+static void TestLoraFrame(void);
+static void TestPktMap(void);
+static void TestLoraToa(void);
+static void TestHdrComp(void);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static unsigned int CheckCnt;
+static unsigned int FailCnt;
+
+static const TOA_Ref_t ToaRef[] =
+{
+   { 0x70, 0x0A, 0x01, 12, false,  10,    3485 },   /* SF7,  1625 kHz,   CR 4/5 */
+   { 0xC0, 0x34, 0x04,  8, false, 255, 8635628 },   /* SF12, 203.125 kHz, CR 4/8 */
+   { 0x50, 0x18, 0x02, 12, true,   20,    2924 },   /* SF5,  812.5 kHz,  CR 4/6 */
+   { 0x90, 0x26, 0x01, 12, false,  64,  125085 },   /* SF9,  406.25 kHz, CR 4/5 */
+   { 0x90, 0x26, 0x01, 12, true,   64,  118784 }
+};
+
+
+/******************************************************************************
+** Function: main
+**
+*/
+int main(void)
+{
+
+   TestLoraFrame();
+   TestPktMap();
+   TestLoraToa();
+   TestHdrComp();
+
+   printf("link_core_test: %u checks, %u failed\n", CheckCnt, FailCnt);
+
+   return (FailCnt == 0) ? 0 : 1;
+
+} /* End main() */
+
+
+/******************************************************************************
+** Function: TestLoraFrame
+**
+** Encode and decode a header with every combination of optional fields
+**
+*/
+static void TestLoraFrame(void)
+{
+
+   LORA_FRAME_Hdr_t Hdr;
+   LORA_FRAME_Hdr_t DecHdr;
+   uint8_t  Frame[LORA_FRAME_MAX_LEN];
+   uint16_t HdrLen;
+   uint8_t  Flags;
+
+   for (Flags=0; Flags < 0x20; Flags++)
+   {
+
+      memset(&Hdr, 0, sizeof(Hdr));
+      Hdr.Type      = LORA_FRAME_TYPE_SB_MSG;
+      Hdr.Flags     = Flags;
+      Hdr.Seq       = 0xA55A;
+      Hdr.HopMask   = (Flags & LORA_FRAME_FLAG_HOP_MASK)  ? 0x80000001 : 0;
+      Hdr.Timestamp = (Flags & LORA_FRAME_FLAG_TIMESTAMP) ? 0xDEADBEEF : 0;
+      if (Flags & LORA_FRAME_FLAG_TIME_EXCH)
+      {
+         Hdr.ExchEcho = 0x01020304;
+         Hdr.ExchRx   = 0xFFFFFFFF;
+         Hdr.ExchTx   = 0x10203040;
+      }
+      if (Flags & LORA_FRAME_FLAG_ROUTE)
+      {
+         Hdr.Route.Src     = 1;
+         Hdr.Route.Dst     = LORA_FRAME_NODE_BROADCAST;
+         Hdr.Route.NextHop = 7;
+         Hdr.Route.HopCnt  = 3;
+         Hdr.Route.MsgId   = 0xFFFE;
+      }
+
+      HdrLen = LORA_FRAME_EncodeHdr(Frame, &Hdr);
+      CHECK(HdrLen >= LORA_FRAME_MIN_HDR_LEN && HdrLen <= LORA_FRAME_MAX_HDR_LEN);
+
+      memset(&DecHdr, 0, sizeof(DecHdr));
+      CHECK(LORA_FRAME_DecodeHdr(Frame, HdrLen, &DecHdr) == HdrLen);
+      CHECK(DecHdr.Type  == Hdr.Type);
+      CHECK(DecHdr.Flags == Hdr.Flags);
+      CHECK(DecHdr.Seq   == Hdr.Seq);
+      if (Flags & LORA_FRAME_FLAG_HOP_MASK)
+      {
+         CHECK(DecHdr.HopMask == Hdr.HopMask);
+      }
+      if (Flags & LORA_FRAME_FLAG_TIMESTAMP)
+      {
+         CHECK(DecHdr.Timestamp == Hdr.Timestamp);
+      }
+      if (Flags & LORA_FRAME_FLAG_TIME_EXCH)
+      {
+         CHECK(DecHdr.ExchEcho == Hdr.ExchEcho);
+         CHECK(DecHdr.ExchRx   == Hdr.ExchRx);
+         CHECK(DecHdr.ExchTx   == Hdr.ExchTx);
+      }
+      if (Flags & LORA_FRAME_FLAG_ROUTE)
+      {
+         CHECK(memcmp(&DecHdr.Route, &Hdr.Route, sizeof(Hdr.Route)) == 0);
+      }
+
+      /* A frame cut inside the header is rejected */
+      CHECK(LORA_FRAME_DecodeHdr(Frame, HdrLen-1, &DecHdr) == 0);
+
+   } /* End flags loop */
+
+} /* End TestLoraFrame() */
+
+
+/******************************************************************************
+** Function: TestPktMap
+**
+*/
+static void TestPktMap(void)
+{
+
+   static PKT_MAP_Class_t PktMap;
+   uint32_t Seq;
+
+   PKT_MAP_Clear(&PktMap);
+
+   CHECK(!PKT_MAP_Set(&PktMap, 0));
+   CHECK(PKT_MAP_NextMissing(&PktMap, 0, 10) == 1);
+
+   for (Seq=1; Seq <= 20; Seq++)
+   {
+      if (Seq != 9 && Seq != 16)
+      {
+         CHECK(PKT_MAP_Set(&PktMap, (uint16_t)Seq));
+      }
+   }
+   CHECK(!PKT_MAP_Set(&PktMap, 5));
+   CHECK(PktMap.SetCnt == 18);
+   CHECK(PKT_MAP_Test(&PktMap, 8) && !PKT_MAP_Test(&PktMap, 9));
+
+   CHECK(PKT_MAP_NextMissing(&PktMap, 1, 20)  == 9);
+   CHECK(PKT_MAP_NextMissing(&PktMap, 10, 20) == 16);
+   CHECK(PKT_MAP_NextMissing(&PktMap, 17, 20) == 0);
+   CHECK(PKT_MAP_NextMissing(&PktMap, 17, 21) == 21);
+   CHECK(PKT_MAP_NextMissing(&PktMap, 1, 8)   == 0);
+
+   /* A complete transfer of the largest size */
+   PKT_MAP_Clear(&PktMap);
+   for (Seq=1; Seq <= PKT_MAP_MAX_PKT_CNT; Seq++)
+   {
+      PKT_MAP_Set(&PktMap, (uint16_t)Seq);
+   }
+   CHECK(PktMap.SetCnt == PKT_MAP_MAX_PKT_CNT);
+   CHECK(PKT_MAP_NextMissing(&PktMap, 1, PKT_MAP_MAX_PKT_CNT) == 0);
+
+} /* End TestPktMap() */
+
+
+/******************************************************************************
+** Function: TestLoraToa
+**
+*/
+static void TestLoraToa(void)
+{
+
+   const TOA_Ref_t *Ref;
+   uint32_t Usec;
+   uint16_t i;
+
+   for (i=0; i < TEST_ARRAY_LEN(ToaRef); i++)
+   {
+      Ref  = &ToaRef[i];
+      Usec = LORA_TOA_FrameTimeOnAir(Ref->SpreadingFactor, Ref->Bandwidth, Ref->CodingRate,
+                                     Ref->PreambleLen, Ref->ImplicitHeader, Ref->PayloadLen);
+      CHECK(Usec <= Ref->RefUsec && Usec + 1 >= Ref->RefUsec);
+   }
+
+   CHECK(LORA_TOA_TimeOnAir(0x70, 0x0A, 0x01, 12, 10) ==
+         LORA_TOA_FrameTimeOnAir(0x70, 0x0A, 0x01, 12, false, 10));
+
+   CHECK(LORA_TOA_SymbolNsec(0x70, 0x0A) == 78769);
+   CHECK(LORA_TOA_SymbolNsec(0x70, 0x55) == 0);
+   CHECK(LORA_TOA_FrameTimeOnAir(0xD0, 0x0A, 0x01, 12, false, 10) == 0);
+   CHECK(LORA_TOA_FrameTimeOnAir(0x70, 0x0A, 0x00, 12, false, 10) == 0);
+
+} /* End TestLoraToa() */
+
+
+/******************************************************************************
+** Function: TestHdrComp
+**
+** Compress and expand two interleaved telemetry streams
+**
+*/
+static void TestHdrComp(void)
+{
+
+   static HDR_COMP_Class_t Comp;
+   static HDR_COMP_Class_t Exp;
+   uint8_t  Msg[TEST_TLM_HDR_LEN + TEST_TLM_DATA_LEN];
+   uint8_t  Out[sizeof(Msg) + HDR_COMP_MAX_OVERHEAD];
+   uint8_t  ExpMsg[sizeof(Msg)];
+   uint16_t OutLen;
+   uint16_t i;
+
+   HDR_COMP_Constructor(&Comp, TEST_TLM_HDR_LEN, TEST_TLM_TIME_OFFSET, 16);
+   HDR_COMP_Constructor(&Exp,  TEST_TLM_HDR_LEN, TEST_TLM_TIME_OFFSET, 16);
+
+   for (i=0; i < 40; i++)
+   {
+
+      BuildTlmMsg(Msg, (i%2) ? 0x0881 : 0x0882, 0x3FF0 + i/2, 0x0000FFFFFFF0ull + 1000*i, (uint8_t)i);
+
+      OutLen = HDR_COMP_Compress(&Comp, Msg, sizeof(Msg), Out, sizeof(Out));
+      CHECK(OutLen > 0);
+      CHECK(HDR_COMP_Expand(&Exp, Out, OutLen, ExpMsg, sizeof(ExpMsg)) == sizeof(Msg));
+      CHECK(memcmp(ExpMsg, Msg, sizeof(Msg)) == 0);
+
+   }
+
+   CHECK(Comp.FullCnt >= 2);
+   CHECK(Comp.CompCnt > Comp.FullCnt);
+   CHECK(Comp.CompByteCnt < Comp.MsgByteCnt);
+   CHECK(Exp.CtxErrCnt == 0 && Exp.FormatErrCnt == 0);
+
+   /* A length field that doesn't match the message is sent whole */
+   BuildTlmMsg(Msg, 0x0881, 1, 0, 0);
+   Msg[5]++;
+   OutLen = HDR_COMP_Compress(&Comp, Msg, sizeof(Msg), Out, sizeof(Out));
+   CHECK(OutLen == sizeof(Msg) + 1 && (Out[0] >> 5) == HDR_COMP_KIND_RAW);
+   CHECK(HDR_COMP_Expand(&Exp, Out, OutLen, ExpMsg, sizeof(ExpMsg)) == sizeof(Msg));
+   CHECK(memcmp(ExpMsg, Msg, sizeof(Msg)) == 0);
+
+   /* A compressed header without its reference isn't rebuilt */
+   HDR_COMP_Reset(&Exp);
+   BuildTlmMsg(Msg, 0x0881, 0x3FF0 + 20, 0x0000FFFFFFF0ull + 40000, 0);
+   OutLen = HDR_COMP_Compress(&Comp, Msg, sizeof(Msg), Out, sizeof(Out));
+   CHECK(OutLen > 0 && (Out[0] >> 5) >= HDR_COMP_KIND_COMP);
+   CHECK(HDR_COMP_Expand(&Exp, Out, OutLen, ExpMsg, sizeof(ExpMsg)) == 0);
+   CHECK(Exp.CtxErrCnt == 1);
+
+} /* End TestHdrComp() */
+
+
+/******************************************************************************
+** Function: BuildTlmMsg
+**
+*/
+static void BuildTlmMsg(uint8_t *Msg, uint16_t StreamId, uint16_t Seq, uint64_t Time, uint8_t Fill)
+{
+
+   uint16_t MsgLen = TEST_TLM_HDR_LEN + TEST_TLM_DATA_LEN;
+   uint16_t i;
+
+   Msg[0] = (uint8_t)(StreamId >> 8);
+   Msg[1] = (uint8_t)StreamId;
+   Msg[2] = (uint8_t)(0xC0 | ((Seq >> 8) & 0x3F));
+   Msg[3] = (uint8_t)Seq;
+   Msg[4] = (uint8_t)((MsgLen-7) >> 8);
+   Msg[5] = (uint8_t)(MsgLen-7);
+
+   for (i=0; i < HDR_COMP_TIME_LEN; i++)
+   {
+      Msg[TEST_TLM_TIME_OFFSET+i] = (uint8_t)(Time >> (8*(HDR_COMP_TIME_LEN-1-i)));
+   }
+   memset(&Msg[TEST_TLM_TIME_OFFSET+HDR_COMP_TIME_LEN], 0, TEST_TLM_HDR_LEN-TEST_TLM_TIME_OFFSET-HDR_COMP_TIME_LEN);
+   memset(&Msg[TEST_TLM_HDR_LEN], Fill, TEST_TLM_DATA_LEN);
+
+} /* End BuildTlmMsg() */
+
+
+/******************************************************************************
+** Function: Check
+**
+*/
+static void Check(bool Cond, const char *CondStr, const char *File, int Line)
+{
+
+   CheckCnt++;
+   if (!Cond)
+   {
+      FailCnt++;
+      printf("%s:%d: check failed: %s\n", File, Line, CondStr);
+   }
+
+} /* End Check() */
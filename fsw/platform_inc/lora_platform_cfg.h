@@ -34,5 +34,9 @@
 #define LORA_APP_PLATFORM_REV 0
 #define LORA_INI_FILENAME     "/cf/lora_ini.json"
 
+#define LORA_DEMO_PACKET_SIZE  128   /* PACKET_SIZE in lora_tx.cpp and lora_rx.cpp */
+
+#define LORA_RADIO_MAX  4   /* RADIO_n_* init file parameters exist for each radio */
+
 
 #endif /* _lora_platform_cfg_ */
@@ -47,6 +47,12 @@
 #define  LORA_APP_MAJOR_VER   1
 #define  LORA_APP_MINOR_VER   0
 
+/*
+** Radio defaults for every driver backend
+*/
+
+#define  LORA_DEFAULT_PREAMBLE_LEN  12   /* Symbols, used until a valid init file or command value is set */
+
 
 /******************************************************************************
 ** Init File declarations create:
@@ -72,12 +78,34 @@
 
 #define CFG_CMD_PIPE_NAME    APP_CMD_PIPE_NAME
 #define CFG_CMD_PIPE_DEPTH   APP_CMD_PIPE_DEPTH
+#define CFG_CMD_BATCH_MAX    APP_CMD_BATCH_MAX
 
 #define CFG_LORA_CMD_TOPICID         LORA_CMD_TOPICID
 #define CFG_BC_SCH_1_HZ_TOPICID      BC_SCH_1_HZ_TOPICID
 #define CFG_LORA_STATUS_TLM_TOPICID  LORA_STATUS_TLM_TOPICID
 #define CFG_LORA_RADIO_TLM_TOPICID   LORA_RADIO_TLM_TOPICID
+#define CFG_LORA_RADIO_STATS_TLM_TOPICID  LORA_RADIO_STATS_TLM_TOPICID
+#define CFG_LORA_HOP_TLM_TOPICID     LORA_HOP_TLM_TOPICID
+#define CFG_LORA_LINK_TEST_TLM_TOPICID  LORA_LINK_TEST_TLM_TOPICID
+#define CFG_LORA_RX_DUTY_TLM_TOPICID    LORA_RX_DUTY_TLM_TOPICID
+#define CFG_LORA_STRIPE_TLM_TOPICID     LORA_STRIPE_TLM_TOPICID
+#define CFG_LORA_RX_DIV_TLM_TOPICID     LORA_RX_DIV_TLM_TOPICID
+#define CFG_LORA_LOAD_GEN_TOPICID       LORA_LOAD_GEN_TOPICID
+#define CFG_LORA_LOAD_GEN_TLM_TOPICID   LORA_LOAD_GEN_TLM_TOPICID
+#define CFG_LORA_QOS_TLM_TOPICID        LORA_QOS_TLM_TOPICID
+#define CFG_LORA_STORE_TLM_TOPICID      LORA_STORE_TLM_TOPICID
+#define CFG_LORA_RX_WRITER_TLM_TOPICID  LORA_RX_WRITER_TLM_TOPICID
+#define CFG_LORA_LATENCY_TLM_TOPICID    LORA_LATENCY_TLM_TOPICID
+#define CFG_LORA_LEN_OPT_TLM_TOPICID    LORA_LEN_OPT_TLM_TOPICID
+#define CFG_LORA_RELAY_TLM_TOPICID      LORA_RELAY_TLM_TOPICID
+
+#define CFG_RADIO_CHILD_SEM_NAME   RADIO_CHILD_SEM_NAME
+#define CFG_RADIO_CHILD_NAME       RADIO_CHILD_NAME
+#define CFG_RADIO_CHILD_PERF_ID    RADIO_CHILD_PERF_ID
+#define CFG_RADIO_CHILD_STACK_SIZE RADIO_CHILD_STACK_SIZE
+#define CFG_RADIO_CHILD_PRIORITY   RADIO_CHILD_PRIORITY
 
+#define CFG_RX_CHILD_SEM_NAME   RX_CHILD_SEM_NAME
 #define CFG_RX_CHILD_NAME       RX_CHILD_NAME
 #define CFG_RX_CHILD_PERF_ID    RX_CHILD_PERF_ID
 #define CFG_RX_CHILD_STACK_SIZE RX_CHILD_STACK_SIZE
@@ -89,20 +117,146 @@
 #define CFG_TX_CHILD_STACK_SIZE TX_CHILD_STACK_SIZE
 #define CFG_TX_CHILD_PRIORITY   TX_CHILD_PRIORITY
 
+#define CFG_LOAD_GEN_CHILD_SEM_NAME   LOAD_GEN_CHILD_SEM_NAME
+#define CFG_LOAD_GEN_CHILD_NAME       LOAD_GEN_CHILD_NAME
+#define CFG_LOAD_GEN_CHILD_PERF_ID    LOAD_GEN_CHILD_PERF_ID
+#define CFG_LOAD_GEN_CHILD_STACK_SIZE LOAD_GEN_CHILD_STACK_SIZE
+#define CFG_LOAD_GEN_CHILD_PRIORITY   LOAD_GEN_CHILD_PRIORITY
+
+#define CFG_RX_WRITER_CHILD_SEM_NAME   RX_WRITER_CHILD_SEM_NAME
+#define CFG_RX_WRITER_CHILD_NAME       RX_WRITER_CHILD_NAME
+#define CFG_RX_WRITER_CHILD_PERF_ID    RX_WRITER_CHILD_PERF_ID
+#define CFG_RX_WRITER_CHILD_STACK_SIZE RX_WRITER_CHILD_STACK_SIZE
+#define CFG_RX_WRITER_CHILD_PRIORITY   RX_WRITER_CHILD_PRIORITY
+#define CFG_RX_WRITER_BLOCK_CNT        RX_WRITER_BLOCK_CNT
+#define CFG_RX_WRITER_FLUSH_MS         RX_WRITER_FLUSH_MS
+
+#define CFG_HDR_COMP_REFRESH_CNT  HDR_COMP_REFRESH_CNT
+
+#define CFG_QOS_CLASSES      QOS_CLASSES
+#define CFG_QOS_MID_MAP      QOS_MID_MAP
+#define CFG_QOS_AIRTIME_PPT  QOS_AIRTIME_PPT
+
+#define CFG_STORE_DIR              STORE_DIR
+#define CFG_STORE_SEGMENT_CNT      STORE_SEGMENT_CNT
+#define CFG_STORE_SYNC_CNT         STORE_SYNC_CNT
+#define CFG_STORE_SYNC_MS          STORE_SYNC_MS
+#define CFG_STORE_ACK_TIMEOUT_MS   STORE_ACK_TIMEOUT_MS
+#define CFG_STORE_LINK_TIMEOUT_MS  STORE_LINK_TIMEOUT_MS
+
+#define CFG_RX_DEMO_FILE  RX_DEMO_FILE
+#define CFG_TX_DEMO_FILE  TX_DEMO_FILE
+#define CFG_STRIPE_RX_FILE  STRIPE_RX_FILE
+
+#define CFG_RADIO_CNT          RADIO_CNT
 #define CFG_RADIO_FREQUENCY    RADIO_FREQUENCY
 #define CFG_RADIO_LORA_SF      RADIO_LORA_SF
 #define CFG_RADIO_LORA_BW      RADIO_LORA_BW
 #define CFG_RADIO_LORA_CR      RADIO_LORA_CR
+#define CFG_RADIO_LORA_PREAMBLE_LEN  RADIO_LORA_PREAMBLE_LEN
+#define CFG_RADIO_LORA_HEADER_TYPE   RADIO_LORA_HEADER_TYPE
+#define CFG_RADIO_LORA_PAYLOAD_LEN   RADIO_LORA_PAYLOAD_LEN
+
+#define CFG_RADIO_0_BACKEND         RADIO_0_BACKEND
+#define CFG_RADIO_0_SPI_DEV         RADIO_0_SPI_DEV
+#define CFG_RADIO_0_PINS            RADIO_0_PINS
+#define CFG_RADIO_0_SIM_LOCAL_PORT  RADIO_0_SIM_LOCAL_PORT
+#define CFG_RADIO_0_SIM_PEER_PORT   RADIO_0_SIM_PEER_PORT
+#define CFG_RADIO_0_FREQ_OFFSET     RADIO_0_FREQ_OFFSET
+
+#define CFG_RADIO_1_BACKEND         RADIO_1_BACKEND
+#define CFG_RADIO_1_SPI_DEV         RADIO_1_SPI_DEV
+#define CFG_RADIO_1_PINS            RADIO_1_PINS
+#define CFG_RADIO_1_SIM_LOCAL_PORT  RADIO_1_SIM_LOCAL_PORT
+#define CFG_RADIO_1_SIM_PEER_PORT   RADIO_1_SIM_PEER_PORT
+#define CFG_RADIO_1_FREQ_OFFSET     RADIO_1_FREQ_OFFSET
+#define CFG_RADIO_1_CMD_TOPICID     RADIO_1_CMD_TOPICID
+
+#define CFG_RADIO_2_BACKEND         RADIO_2_BACKEND
+#define CFG_RADIO_2_SPI_DEV         RADIO_2_SPI_DEV
+#define CFG_RADIO_2_PINS            RADIO_2_PINS
+#define CFG_RADIO_2_SIM_LOCAL_PORT  RADIO_2_SIM_LOCAL_PORT
+#define CFG_RADIO_2_SIM_PEER_PORT   RADIO_2_SIM_PEER_PORT
+#define CFG_RADIO_2_FREQ_OFFSET     RADIO_2_FREQ_OFFSET
+#define CFG_RADIO_2_CMD_TOPICID     RADIO_2_CMD_TOPICID
+
+#define CFG_RADIO_3_BACKEND         RADIO_3_BACKEND
+#define CFG_RADIO_3_SPI_DEV         RADIO_3_SPI_DEV
+#define CFG_RADIO_3_PINS            RADIO_3_PINS
+#define CFG_RADIO_3_SIM_LOCAL_PORT  RADIO_3_SIM_LOCAL_PORT
+#define CFG_RADIO_3_SIM_PEER_PORT   RADIO_3_SIM_PEER_PORT
+#define CFG_RADIO_3_FREQ_OFFSET     RADIO_3_FREQ_OFFSET
+#define CFG_RADIO_3_CMD_TOPICID     RADIO_3_CMD_TOPICID
+
+#define CFG_SIM_SEED              SIM_SEED
+#define CFG_SIM_LOSS_PPT          SIM_LOSS_PPT
+#define CFG_SIM_BURST_ENTER_PPT   SIM_BURST_ENTER_PPT
+#define CFG_SIM_BURST_EXIT_PPT    SIM_BURST_EXIT_PPT
+#define CFG_SIM_BURST_LOSS_PPT    SIM_BURST_LOSS_PPT
+#define CFG_SIM_SNR_MEAN_DB       SIM_SNR_MEAN_DB
+#define CFG_SIM_SNR_STD_DEV_DB    SIM_SNR_STD_DEV_DB
+
+#define CFG_HOP_DWELL_FRAMES      HOP_DWELL_FRAMES
+#define CFG_HOP_CHANNEL_CNT       HOP_CHANNEL_CNT
+#define CFG_HOP_BASE_FREQ_KHZ     HOP_BASE_FREQ_KHZ
+#define CFG_HOP_SPACING_KHZ       HOP_SPACING_KHZ
+#define CFG_HOP_SEED              HOP_SEED
+#define CFG_HOP_SLOT_GUARD_MS     HOP_SLOT_GUARD_MS
+#define CFG_HOP_PER_LIMIT_PCT     HOP_PER_LIMIT_PCT
+#define CFG_HOP_PER_MIN_FRAMES    HOP_PER_MIN_FRAMES
+
+#define CFG_LINK_TEST_SWEEP        LINK_TEST_SWEEP
+#define CFG_LINK_TEST_STEP_GAP_MS  LINK_TEST_STEP_GAP_MS
+#define CFG_LINK_TEST_FILE         LINK_TEST_FILE
+
+#define CFG_RX_DUTY_PERIOD_MS      RX_DUTY_PERIOD_MS
+
+#define CFG_LATENCY_TIMESTAMPS     LATENCY_TIMESTAMPS
+#define CFG_LATENCY_EXCHANGE_MS    LATENCY_EXCHANGE_MS
+
+#define CFG_LEN_OPT_WINDOW           LEN_OPT_WINDOW
+#define CFG_LEN_OPT_REPORT_GUARD_MS  LEN_OPT_REPORT_GUARD_MS
+
+#define CFG_RELAY_NODE_ID            RELAY_NODE_ID
+#define CFG_RELAY_BRIDGE_DST         RELAY_BRIDGE_DST
+#define CFG_RELAY_ROUTES             RELAY_ROUTES
+#define CFG_RELAY_HOP_CLASSES        RELAY_HOP_CLASSES
+#define CFG_RELAY_MAX_HOPS           RELAY_MAX_HOPS
+#define CFG_RELAY_BEACON_SEC         RELAY_BEACON_SEC
+#define CFG_RELAY_ROUTE_TIMEOUT_SEC  RELAY_ROUTE_TIMEOUT_SEC
+
+#define CFG_EVT_SUM_INTERVAL_SEC   EVT_SUM_INTERVAL_SEC
 
 #define APP_CONFIG(XX) \
    XX(APP_CFE_NAME,char*) \
    XX(APP_PERF_ID,uint32) \
    XX(APP_CMD_PIPE_NAME,char*) \
    XX(APP_CMD_PIPE_DEPTH,uint32) \
+   XX(APP_CMD_BATCH_MAX,uint32) \
    XX(LORA_CMD_TOPICID,uint32) \
    XX(BC_SCH_1_HZ_TOPICID,uint32) \
    XX(LORA_STATUS_TLM_TOPICID,uint32) \
    XX(LORA_RADIO_TLM_TOPICID,uint32) \
+   XX(LORA_RADIO_STATS_TLM_TOPICID,uint32) \
+   XX(LORA_HOP_TLM_TOPICID,uint32) \
+   XX(LORA_LINK_TEST_TLM_TOPICID,uint32) \
+   XX(LORA_RX_DUTY_TLM_TOPICID,uint32) \
+   XX(LORA_STRIPE_TLM_TOPICID,uint32) \
+   XX(LORA_RX_DIV_TLM_TOPICID,uint32) \
+   XX(LORA_LOAD_GEN_TOPICID,uint32) \
+   XX(LORA_LOAD_GEN_TLM_TOPICID,uint32) \
+   XX(LORA_QOS_TLM_TOPICID,uint32) \
+   XX(LORA_STORE_TLM_TOPICID,uint32) \
+   XX(LORA_RX_WRITER_TLM_TOPICID,uint32) \
+   XX(LORA_LATENCY_TLM_TOPICID,uint32) \
+   XX(LORA_LEN_OPT_TLM_TOPICID,uint32) \
+   XX(LORA_RELAY_TLM_TOPICID,uint32) \
+   XX(RADIO_CHILD_SEM_NAME,char*) \
+   XX(RADIO_CHILD_NAME,char*) \
+   XX(RADIO_CHILD_PERF_ID,uint32) \
+   XX(RADIO_CHILD_STACK_SIZE,uint32) \
+   XX(RADIO_CHILD_PRIORITY,uint32) \
+   XX(RX_CHILD_SEM_NAME,char*) \
    XX(RX_CHILD_NAME,char*) \
    XX(RX_CHILD_PERF_ID,uint32) \
    XX(RX_CHILD_STACK_SIZE,uint32) \
@@ -112,10 +266,97 @@
    XX(TX_CHILD_PERF_ID,uint32) \
    XX(TX_CHILD_STACK_SIZE,uint32) \
    XX(TX_CHILD_PRIORITY,uint32) \
+   XX(LOAD_GEN_CHILD_SEM_NAME,char*) \
+   XX(LOAD_GEN_CHILD_NAME,char*) \
+   XX(LOAD_GEN_CHILD_PERF_ID,uint32) \
+   XX(LOAD_GEN_CHILD_STACK_SIZE,uint32) \
+   XX(LOAD_GEN_CHILD_PRIORITY,uint32) \
+   XX(RX_WRITER_CHILD_SEM_NAME,char*) \
+   XX(RX_WRITER_CHILD_NAME,char*) \
+   XX(RX_WRITER_CHILD_PERF_ID,uint32) \
+   XX(RX_WRITER_CHILD_STACK_SIZE,uint32) \
+   XX(RX_WRITER_CHILD_PRIORITY,uint32) \
+   XX(RX_WRITER_BLOCK_CNT,uint32) \
+   XX(RX_WRITER_FLUSH_MS,uint32) \
+   XX(HDR_COMP_REFRESH_CNT,uint32) \
+   XX(QOS_CLASSES,char*) \
+   XX(QOS_MID_MAP,char*) \
+   XX(QOS_AIRTIME_PPT,uint32) \
+   XX(STORE_DIR,char*) \
+   XX(STORE_SEGMENT_CNT,uint32) \
+   XX(STORE_SYNC_CNT,uint32) \
+   XX(STORE_SYNC_MS,uint32) \
+   XX(STORE_ACK_TIMEOUT_MS,uint32) \
+   XX(STORE_LINK_TIMEOUT_MS,uint32) \
+   XX(RX_DEMO_FILE,char*) \
+   XX(TX_DEMO_FILE,char*) \
+   XX(STRIPE_RX_FILE,char*) \
+   XX(RADIO_CNT,uint32) \
    XX(RADIO_FREQUENCY,uint32) \
    XX(RADIO_LORA_SF,uint32) \
    XX(RADIO_LORA_BW,uint32) \
-   XX(RADIO_LORA_CR,uint32)
+   XX(RADIO_LORA_CR,uint32) \
+   XX(RADIO_LORA_PREAMBLE_LEN,uint32) \
+   XX(RADIO_LORA_HEADER_TYPE,uint32) \
+   XX(RADIO_LORA_PAYLOAD_LEN,uint32) \
+   XX(RADIO_0_BACKEND,char*) \
+   XX(RADIO_0_SPI_DEV,char*) \
+   XX(RADIO_0_PINS,char*) \
+   XX(RADIO_0_SIM_LOCAL_PORT,uint32) \
+   XX(RADIO_0_SIM_PEER_PORT,uint32) \
+   XX(RADIO_0_FREQ_OFFSET,uint32) \
+   XX(RADIO_1_BACKEND,char*) \
+   XX(RADIO_1_SPI_DEV,char*) \
+   XX(RADIO_1_PINS,char*) \
+   XX(RADIO_1_SIM_LOCAL_PORT,uint32) \
+   XX(RADIO_1_SIM_PEER_PORT,uint32) \
+   XX(RADIO_1_FREQ_OFFSET,uint32) \
+   XX(RADIO_1_CMD_TOPICID,uint32) \
+   XX(RADIO_2_BACKEND,char*) \
+   XX(RADIO_2_SPI_DEV,char*) \
+   XX(RADIO_2_PINS,char*) \
+   XX(RADIO_2_SIM_LOCAL_PORT,uint32) \
+   XX(RADIO_2_SIM_PEER_PORT,uint32) \
+   XX(RADIO_2_FREQ_OFFSET,uint32) \
+   XX(RADIO_2_CMD_TOPICID,uint32) \
+   XX(RADIO_3_BACKEND,char*) \
+   XX(RADIO_3_SPI_DEV,char*) \
+   XX(RADIO_3_PINS,char*) \
+   XX(RADIO_3_SIM_LOCAL_PORT,uint32) \
+   XX(RADIO_3_SIM_PEER_PORT,uint32) \
+   XX(RADIO_3_FREQ_OFFSET,uint32) \
+   XX(RADIO_3_CMD_TOPICID,uint32) \
+   XX(SIM_SEED,uint32) \
+   XX(SIM_LOSS_PPT,uint32) \
+   XX(SIM_BURST_ENTER_PPT,uint32) \
+   XX(SIM_BURST_EXIT_PPT,uint32) \
+   XX(SIM_BURST_LOSS_PPT,uint32) \
+   XX(SIM_SNR_MEAN_DB,uint32) \
+   XX(SIM_SNR_STD_DEV_DB,uint32) \
+   XX(HOP_DWELL_FRAMES,uint32) \
+   XX(HOP_CHANNEL_CNT,uint32) \
+   XX(HOP_BASE_FREQ_KHZ,uint32) \
+   XX(HOP_SPACING_KHZ,uint32) \
+   XX(HOP_SEED,uint32) \
+   XX(HOP_SLOT_GUARD_MS,uint32) \
+   XX(HOP_PER_LIMIT_PCT,uint32) \
+   XX(HOP_PER_MIN_FRAMES,uint32) \
+   XX(LINK_TEST_SWEEP,char*) \
+   XX(LINK_TEST_STEP_GAP_MS,uint32) \
+   XX(LINK_TEST_FILE,char*) \
+   XX(RX_DUTY_PERIOD_MS,uint32) \
+   XX(LATENCY_TIMESTAMPS,uint32) \
+   XX(LATENCY_EXCHANGE_MS,uint32) \
+   XX(LEN_OPT_WINDOW,uint32) \
+   XX(LEN_OPT_REPORT_GUARD_MS,uint32) \
+   XX(RELAY_NODE_ID,uint32) \
+   XX(RELAY_BRIDGE_DST,uint32) \
+   XX(RELAY_ROUTES,char*) \
+   XX(RELAY_HOP_CLASSES,char*) \
+   XX(RELAY_MAX_HOPS,uint32) \
+   XX(RELAY_BEACON_SEC,uint32) \
+   XX(RELAY_ROUTE_TIMEOUT_SEC,uint32) \
+   XX(EVT_SUM_INTERVAL_SEC,uint32)
    
 DECLARE_ENUM(Config,APP_CONFIG)
 
@@ -132,5 +373,22 @@ DECLARE_ENUM(Config,APP_CONFIG)
 #define LORA_RX_BASE_EID   (APP_C_FW_APP_BASE_EID + 20)
 #define LORA_TX_BASE_EID   (APP_C_FW_APP_BASE_EID + 40)
 #define RADIO_IF_BASE_EID  (APP_C_FW_APP_BASE_EID + 60)
+#define RADIO_DRV_BASE_EID (APP_C_FW_APP_BASE_EID + 80)
+#define RADIO_SIM_BASE_EID (APP_C_FW_APP_BASE_EID + 100)
+#define FREQ_HOP_BASE_EID  (APP_C_FW_APP_BASE_EID + 120)
+#define RADIO_TASK_BASE_EID (APP_C_FW_APP_BASE_EID + 140)
+#define LINK_TEST_BASE_EID  (APP_C_FW_APP_BASE_EID + 160)
+#define RX_DUTY_BASE_EID    (APP_C_FW_APP_BASE_EID + 180)
+#define FRAME_TRACE_BASE_EID (APP_C_FW_APP_BASE_EID + 200)
+#define RADIO_INST_BASE_EID  (APP_C_FW_APP_BASE_EID + 220)
+#define STRIPE_BASE_EID      (APP_C_FW_APP_BASE_EID + 240)
+#define RX_DIV_BASE_EID      (APP_C_FW_APP_BASE_EID + 260)
+#define LOAD_GEN_BASE_EID    (APP_C_FW_APP_BASE_EID + 280)
+#define QOS_BASE_EID         (APP_C_FW_APP_BASE_EID + 300)
+#define STORE_BASE_EID       (APP_C_FW_APP_BASE_EID + 320)
+#define RX_WRITER_BASE_EID   (APP_C_FW_APP_BASE_EID + 340)
+#define LATENCY_BASE_EID     (APP_C_FW_APP_BASE_EID + 360)
+#define LEN_OPT_BASE_EID     (APP_C_FW_APP_BASE_EID + 380)
+#define RELAY_BASE_EID       (APP_C_FW_APP_BASE_EID + 400)
 
 #endif /* _app_cfg_ */
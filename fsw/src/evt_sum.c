@@ -0,0 +1,172 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the Event Summarizer Class methods
+**
+**  Notes:
+**    1. See evt_sum.h file prologue.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "freq_hop.h"
+#include "lora_rx.h"
+#include "lora_tx.h"
+#include "evt_sum.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef struct
+{
+
+   uint16      EventId;
+   uint16      EventType;
+   const char *Text;
+
+} EventDef_t;
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static EVT_SUM_Class_t *EvtSum = NULL;
+
+/* Must match EVT_SUM_Id_t order */
+static const EventDef_t EventDef[EVT_SUM_ID_CNT] =
+{
+   { LORA_TX_CHILD_TASK_EID, CFE_EVS_EventType_INFORMATION, "Tx child task waiting for semaphore" },
+   { LORA_RX_CHILD_TASK_EID, CFE_EVS_EventType_INFORMATION, "Rx child task waiting for semaphore" },
+   { LORA_RX_HOP_SYNC_EID,   CFE_EVS_EventType_INFORMATION, "Lost hop sync, waiting on frame"     },
+   { LORA_RX_HOP_SYNC_EID,   CFE_EVS_EventType_INFORMATION, "Hop sync acquired on frame"          },
+   { FREQ_HOP_TUNE_EID,      CFE_EVS_EventType_ERROR,       "Error tuning radio to hop frequency for frame" }
+};
+
+
+/******************************************************************************
+** Function: EVT_SUM_Constructor
+**
+** Initialize the Event Summarizer object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**   2. An interval of 0 sends a summary every second.
+**
+*/
+void EVT_SUM_Constructor(EVT_SUM_Class_t *EvtSumPtr, INITBL_Class_t *IniTbl)
+{
+
+   uint16 Id;
+
+   EvtSum = EvtSumPtr;
+
+   memset(EvtSum, 0, sizeof(EVT_SUM_Class_t));
+
+   for (Id=0; Id < EVT_SUM_ID_CNT; Id++)
+   {
+      atomic_init(&EvtSum->Counter[Id].Count, 0);
+      atomic_init(&EvtSum->Counter[Id].FirstValue, 0);
+      atomic_init(&EvtSum->Counter[Id].LastValue, 0);
+   }
+
+   EvtSum->IntervalSec = INITBL_GetIntConfig(IniTbl, CFG_EVT_SUM_INTERVAL_SEC);
+   if (EvtSum->IntervalSec == 0)
+   {
+      EvtSum->IntervalSec = 1;
+   }
+
+   OS_GetLocalTime(&EvtSum->IntervalStart);
+
+} /* End EVT_SUM_Constructor() */
+
+
+/******************************************************************************
+** Function: EVT_SUM_Count
+**
+*/
+void EVT_SUM_Count(EVT_SUM_Id_t Id, int32 Value)
+{
+
+   EVT_SUM_Counter_t *Counter = &EvtSum->Counter[Id];
+
+   if (atomic_fetch_add_explicit(&Counter->Count, 1, memory_order_relaxed) == 0)
+   {
+      atomic_store_explicit(&Counter->FirstValue, Value, memory_order_relaxed);
+   }
+   atomic_store_explicit(&Counter->LastValue, Value, memory_order_relaxed);
+
+} /* End EVT_SUM_Count() */
+
+
+/******************************************************************************
+** Function: EVT_SUM_Tick
+**
+** Notes:
+**   1. The rate uses the measured interval because the 1 Hz wakeup
+**      message can be delayed.
+**
+*/
+void EVT_SUM_Tick(void)
+{
+
+   uint16    Id;
+   uint32    Count;
+   uint32    IntervalMs;
+   uint32    RateMilli;
+   OS_time_t CurrentTime;
+   EVT_SUM_Counter_t *Counter;
+
+   if (++EvtSum->TickCnt < EvtSum->IntervalSec)
+   {
+      return;
+   }
+   EvtSum->TickCnt = 0;
+
+   OS_GetLocalTime(&CurrentTime);
+   IntervalMs = (uint32)OS_TimeGetTotalMilliseconds(OS_TimeSubtract(CurrentTime, EvtSum->IntervalStart));
+   EvtSum->IntervalStart = CurrentTime;
+
+   for (Id=0; Id < EVT_SUM_ID_CNT; Id++)
+   {
+
+      Counter = &EvtSum->Counter[Id];
+      Count   = atomic_exchange_explicit(&Counter->Count, 0, memory_order_relaxed);
+
+      if (Count > 0)
+      {
+         RateMilli = (IntervalMs > 0) ? (uint32)(((uint64)Count*1000000) / IntervalMs) : 0;
+         CFE_EVS_SendEvent(EventDef[Id].EventId, EventDef[Id].EventType,
+                           "%s: %u in %u.%03us (%u.%03u/s), first %d, last %d", EventDef[Id].Text,
+                           (unsigned int)Count, (unsigned int)(IntervalMs/1000), (unsigned int)(IntervalMs%1000),
+                           (unsigned int)(RateMilli/1000), (unsigned int)(RateMilli%1000),
+                           (int)atomic_load_explicit(&Counter->FirstValue, memory_order_relaxed),
+                           (int)atomic_load_explicit(&Counter->LastValue, memory_order_relaxed));
+      }
+
+   } /* End event loop */
+
+} /* End EVT_SUM_Tick() */
@@ -0,0 +1,139 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the event summarizer class
+**
+**  Notes:
+**    1. Events that can occur once per frame or once per child task loop
+**       are counted instead of sent. Counting an event is an atomic
+**       increment plus stores of the event's value, there is no string
+**       formatting and no call to the event service.
+**    2. The main task sends one summary event per summarized event every
+**       EVT_SUM_INTERVAL_SEC seconds if the event occurred. The summary
+**       uses the original event ID and type and reports the count, rate
+**       and the first and last values of the interval.
+**    3. The first value is captured by whichever call finds the count at
+**       zero so an occurrence that races with the summary may be reported
+**       in either interval. Counts are never lost.
+**
+*/
+
+#ifndef _evt_sum_
+#define _evt_sum_
+
+/*
+** Includes
+*/
+
+#include <stdatomic.h>
+#include "app_cfg.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+typedef enum
+{
+
+   EVT_SUM_TX_CHILD_WAIT = 0,    /* Value is the previous semaphore status */
+   EVT_SUM_RX_CHILD_WAIT,
+   EVT_SUM_RX_HOP_SYNC_LOST,     /* Value is the frame index being waited on */
+   EVT_SUM_RX_HOP_SYNC_ACQUIRED, /* Value is the frame index */
+   EVT_SUM_HOP_TUNE_ERR,         /* Value is the frame sequence number */
+   EVT_SUM_ID_CNT
+
+} EVT_SUM_Id_t;
+
+
+typedef struct
+{
+
+   _Alignas(64) atomic_uint Count;
+   atomic_int  FirstValue;
+   atomic_int  LastValue;
+
+} EVT_SUM_Counter_t;
+
+
+/******************************************************************************
+** EVT_SUM_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Class State Data
+   */
+
+   EVT_SUM_Counter_t Counter[EVT_SUM_ID_CNT];
+
+   /* Only accessed by the main task */
+   uint32     IntervalSec;
+   uint32     TickCnt;
+   OS_time_t  IntervalStart;
+
+} EVT_SUM_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: EVT_SUM_Constructor
+**
+** Initialize the Event Summarizer object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void EVT_SUM_Constructor(EVT_SUM_Class_t *EvtSumPtr, INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: EVT_SUM_Count
+**
+** Count one occurrence of a summarized event
+**
+** Notes:
+**   1. Safe to call from any task.
+**
+*/
+void EVT_SUM_Count(EVT_SUM_Id_t Id, int32 Value);
+
+
+/******************************************************************************
+** Function: EVT_SUM_Tick
+**
+** Send the summary events when the interval has elapsed
+**
+** Notes:
+**   1. Called by the main task at 1 Hz.
+**
+*/
+void EVT_SUM_Tick(void);
+
+
+#endif /* _evt_sum_ */
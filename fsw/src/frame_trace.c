@@ -0,0 +1,386 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the Frame Trace Class methods
+**
+**  Notes:
+**    1. See frame_trace.h file prologue.
+**    2. Each ring has one writer, the task that owns it. The writer fills
+**       the entry and then publishes it with a release store of the head.
+**       The reader copies an entry and then rereads the head to check that
+**       the writer hadn't started to overwrite it.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "frame_trace.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define FRAME_TRACE_RING_MASK  (FRAME_TRACE_RING_LEN - 1)
+#define TRACE_FILE_LINE_LEN    256
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static bool RadioRecorded(uint16 Radio);
+static uint32 WriteRing(osal_id_t FileHandle, uint16 Radio, uint16 Task, bool *FirstEvent);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static FRAME_TRACE_Class_t *FrameTrace = NULL;
+
+static const char *TaskName[FRAME_TRACE_TASK_CNT] =
+{
+   "Radio",
+   "Tx",
+   "Rx"
+};
+
+static const char *StageName[FRAME_TRACE_STAGE_CNT] =
+{
+   "TxEnqueue",
+   "TxEncode",
+   "TxRadioWait",
+   "TxSend",
+   "TxDone",
+   "RxRadioWait",
+   "RxReceive",
+   "RxDecode",
+   "RxDiskWrite"
+};
+
+
+/******************************************************************************
+** Function: FRAME_TRACE_Constructor
+**
+** Initialize the Frame Trace object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void FRAME_TRACE_Constructor(FRAME_TRACE_Class_t *FrameTracePtr)
+{
+
+   uint16 Radio;
+   uint16 Task;
+
+   FrameTrace = FrameTracePtr;
+
+   memset(FrameTrace, 0, sizeof(FRAME_TRACE_Class_t));
+
+   atomic_init(&FrameTrace->Enabled, false);
+   for (Radio=0; Radio < LORA_RADIO_MAX; Radio++)
+   {
+      for (Task=0; Task < FRAME_TRACE_TASK_CNT; Task++)
+      {
+         atomic_init(&FrameTrace->Ring[Radio][Task].Head, 0);
+      }
+   }
+
+} /* End FRAME_TRACE_Constructor() */
+
+
+/******************************************************************************
+** Function: FRAME_TRACE_Enabled
+**
+*/
+bool FRAME_TRACE_Enabled(void)
+{
+
+   return atomic_load_explicit(&FrameTrace->Enabled, memory_order_relaxed);
+
+} /* End FRAME_TRACE_Enabled() */
+
+
+/******************************************************************************
+** Function: FRAME_TRACE_Record
+**
+*/
+void FRAME_TRACE_Record(uint8 Radio, FRAME_TRACE_Task_t Task, FRAME_TRACE_Stage_t Stage, uint16 Seq, uint8 Len,
+                        const OS_time_t *StartTime)
+{
+
+   OS_time_t CurrentTime;
+
+   if (!atomic_load_explicit(&FrameTrace->Enabled, memory_order_relaxed))
+   {
+      return;
+   }
+
+   OS_GetLocalTime(&CurrentTime);
+   FRAME_TRACE_RecordSpan(Radio, Task, Stage, Seq, Len, (StartTime != NULL ? StartTime : &CurrentTime), &CurrentTime);
+
+} /* End FRAME_TRACE_Record() */
+
+
+/******************************************************************************
+** Function: FRAME_TRACE_RecordSpan
+**
+*/
+void FRAME_TRACE_RecordSpan(uint8 Radio, FRAME_TRACE_Task_t Task, FRAME_TRACE_Stage_t Stage,
+                            uint16 Seq, uint8 Len, const OS_time_t *StartTime, const OS_time_t *EndTime)
+{
+
+   FRAME_TRACE_Ring_t  *Ring;
+   FRAME_TRACE_Entry_t *Entry;
+   unsigned int Head;
+
+   if (!atomic_load_explicit(&FrameTrace->Enabled, memory_order_relaxed))
+   {
+      return;
+   }
+
+   Ring  = &FrameTrace->Ring[Radio][Task];
+   Head  = atomic_load_explicit(&Ring->Head, memory_order_relaxed);
+   Entry = &Ring->Entry[Head & FRAME_TRACE_RING_MASK];
+
+   Entry->StartUsec = OS_TimeGetTotalMicroseconds(*StartTime);
+   Entry->DurUsec   = (uint32)OS_TimeGetTotalMicroseconds(OS_TimeSubtract(*EndTime, *StartTime));
+   Entry->Seq       = Seq;
+   Entry->Stage     = (uint8)Stage;
+   Entry->Len       = Len;
+
+   atomic_store_explicit(&Ring->Head, Head+1, memory_order_release);
+
+} /* End FRAME_TRACE_RecordSpan() */
+
+
+/******************************************************************************
+** Function: FRAME_TRACE_ConfigCmd
+**
+*/
+bool FRAME_TRACE_ConfigCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const LORA_ConfigFrameTrace_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_ConfigFrameTrace_t);
+
+   uint16 Radio;
+   uint16 Task;
+
+   if (Cmd->Enable)
+   {
+      for (Radio=0; Radio < LORA_RADIO_MAX; Radio++)
+      {
+         for (Task=0; Task < FRAME_TRACE_TASK_CNT; Task++)
+         {
+            FrameTrace->Base[Radio][Task] = atomic_load_explicit(&FrameTrace->Ring[Radio][Task].Head,
+                                                                 memory_order_acquire);
+         }
+      }
+   }
+
+   atomic_store_explicit(&FrameTrace->Enabled, (Cmd->Enable != 0), memory_order_relaxed);
+
+   CFE_EVS_SendEvent(FRAME_TRACE_CONFIG_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                     "Frame trace %s", (Cmd->Enable ? "enabled" : "disabled"));
+
+   return true;
+
+} /* End FRAME_TRACE_ConfigCmd() */
+
+
+/******************************************************************************
+** Function: FRAME_TRACE_WriteFileCmd
+**
+** Write the rings to a Chrome trace event JSON file
+**
+** Notes:
+**   1. Timestamps are OSAL local time in microseconds.
+**
+*/
+bool FRAME_TRACE_WriteFileCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const LORA_WriteFrameTraceFile_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_WriteFrameTraceFile_t);
+
+   bool      RetStatus = false;
+   bool      FirstEvent = true;
+   int32     SysStatus;
+   osal_id_t FileHandle;
+   char      Line[TRACE_FILE_LINE_LEN];
+   size_t    LineLen;
+   uint16    Radio;
+   uint16    Task;
+   uint32    EventCnt = 0;
+
+   SysStatus = OS_OpenCreate(&FileHandle, Cmd->Filename, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_WRITE_ONLY);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+
+      LineLen = snprintf(Line, sizeof(Line), "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+      OS_write(FileHandle, Line, LineLen);
+
+      for (Radio=0; Radio < LORA_RADIO_MAX; Radio++)
+      {
+
+         if (!RadioRecorded(Radio))
+         {
+            continue;
+         }
+
+         LineLen = snprintf(Line, sizeof(Line),
+                            "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"Radio %u\"}}",
+                            (FirstEvent ? "" : ",\n"), (unsigned int)Radio, (unsigned int)Radio);
+         OS_write(FileHandle, Line, LineLen);
+         FirstEvent = false;
+
+         for (Task=0; Task < FRAME_TRACE_TASK_CNT; Task++)
+         {
+            LineLen = snprintf(Line, sizeof(Line),
+                               ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                               (unsigned int)Radio, (unsigned int)Task, TaskName[Task]);
+            OS_write(FileHandle, Line, LineLen);
+         }
+
+         for (Task=0; Task < FRAME_TRACE_TASK_CNT; Task++)
+         {
+            EventCnt += WriteRing(FileHandle, Radio, Task, &FirstEvent);
+         }
+
+      } /* End radio loop */
+
+      LineLen = snprintf(Line, sizeof(Line), "\n]}\n");
+      OS_write(FileHandle, Line, LineLen);
+
+      OS_close(FileHandle);
+
+      RetStatus = true;
+      CFE_EVS_SendEvent(FRAME_TRACE_WRITE_FILE_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                        "Wrote %d frame trace events to %s", EventCnt, Cmd->Filename);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(FRAME_TRACE_WRITE_FILE_CMD_EID, CFE_EVS_EventType_ERROR,
+                        "Write frame trace failed, error creating %s, Status = %d",
+                        Cmd->Filename, SysStatus);
+   }
+
+   return RetStatus;
+
+} /* End FRAME_TRACE_WriteFileCmd() */
+
+
+/******************************************************************************
+** Function: RadioRecorded
+**
+** Return true if any of the radio's rings has entries since tracing was
+** enabled
+**
+*/
+static bool RadioRecorded(uint16 Radio)
+{
+
+   uint16 Task;
+
+   for (Task=0; Task < FRAME_TRACE_TASK_CNT; Task++)
+   {
+      if (atomic_load_explicit(&FrameTrace->Ring[Radio][Task].Head, memory_order_acquire) !=
+          FrameTrace->Base[Radio][Task])
+      {
+         return true;
+      }
+   }
+
+   return false;
+
+} /* End RadioRecorded() */
+
+
+/******************************************************************************
+** Function: WriteRing
+**
+** Write one radio task's ring entries oldest first and return the number written
+**
+** Notes:
+**   1. The writer overwrites entry i while it fills entry i+RING_LEN so a
+**      copy is only valid if the head hadn't reached i+RING_LEN after it
+**      was made.
+**
+*/
+static uint32 WriteRing(osal_id_t FileHandle, uint16 Radio, uint16 Task, bool *FirstEvent)
+{
+
+   FRAME_TRACE_Ring_t  *Ring = &FrameTrace->Ring[Radio][Task];
+   FRAME_TRACE_Entry_t Entry;
+   unsigned int Head = atomic_load_explicit(&Ring->Head, memory_order_acquire);
+   unsigned int First = FrameTrace->Base[Radio][Task];
+   unsigned int i;
+   char    Line[TRACE_FILE_LINE_LEN];
+   size_t  LineLen;
+   uint32  EventCnt = 0;
+
+   if (Head - First > FRAME_TRACE_RING_LEN)
+   {
+      First = Head - FRAME_TRACE_RING_LEN;
+   }
+
+   for (i=First; i != Head; i++)
+   {
+
+      Entry = Ring->Entry[i & FRAME_TRACE_RING_MASK];
+      atomic_thread_fence(memory_order_acquire);
+      if (atomic_load_explicit(&Ring->Head, memory_order_relaxed) - i >= FRAME_TRACE_RING_LEN)
+      {
+         continue;
+      }
+
+      if (Entry.Stage >= FRAME_TRACE_STAGE_CNT)
+      {
+         continue;
+      }
+
+      if (Entry.DurUsec > 0)
+      {
+         LineLen = snprintf(Line, sizeof(Line),
+                            "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lu,\"pid\":%u,\"tid\":%u,"
+                            "\"args\":{\"seq\":%u,\"len\":%u}}",
+                            (*FirstEvent ? "" : ",\n"), StageName[Entry.Stage], (long long)Entry.StartUsec,
+                            (unsigned long)Entry.DurUsec, (unsigned int)Radio, (unsigned int)Task,
+                            (unsigned int)Entry.Seq, (unsigned int)Entry.Len);
+      }
+      else
+      {
+         LineLen = snprintf(Line, sizeof(Line),
+                            "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%lld,\"pid\":%u,\"tid\":%u,"
+                            "\"args\":{\"seq\":%u,\"len\":%u}}",
+                            (*FirstEvent ? "" : ",\n"), StageName[Entry.Stage], (long long)Entry.StartUsec,
+                            (unsigned int)Radio, (unsigned int)Task,
+                            (unsigned int)Entry.Seq, (unsigned int)Entry.Len);
+      }
+      OS_write(FileHandle, Line, LineLen);
+      *FirstEvent = false;
+      EventCnt++;
+
+   } /* End entry loop */
+
+   return EventCnt;
+
+} /* End WriteRing() */
@@ -0,0 +1,213 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the frame trace class
+**
+**  Notes:
+**    1. When enabled, each task records the stages a frame passes through
+**       in its own preallocated ring. Recording is a relaxed load of the
+**       enable flag when disabled and an entry copy plus a release store
+**       when enabled. There are no locks and no allocation.
+**    2. The stages are:
+**         Tx:    Enqueue, Encode, RadioWait, Send (write to TxDone), TxDone
+**         Rx:    RadioWait, Receive (listen to RxDone and FIFO read),
+**                Decode (header and sequence tracking), DiskWrite
+**       The SX128x library blocks from the SPI write to TxDone and from
+**       the receive to the FIFO read so those stages can't be split.
+**    3. Entries are identified by the frame sequence number so one frame
+**       can be followed across the Tx, Rx and radio task rings.
+**    4. The write command dumps the rings as Chrome trace event JSON that
+**       can be loaded into chrome://tracing or Perfetto. Each radio is a
+**       process and each of its tasks is a thread. Each stage is a complete
+**       ("X") event and instants have no duration. Radios that didn't record
+**       anything are omitted. The rings keep running while they're dumped and entries
+**       that are overwritten during the copy are skipped.
+**
+*/
+
+#ifndef _frame_trace_
+#define _frame_trace_
+
+/*
+** Includes
+*/
+
+#include <stdatomic.h>
+#include "app_cfg.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define FRAME_TRACE_RING_LEN  1024   /* Entries per radio task, must be a power of 2 */
+
+
+/*
+** Event Message IDs
+*/
+
+#define FRAME_TRACE_CONFIG_CMD_EID      (FRAME_TRACE_BASE_EID + 0)
+#define FRAME_TRACE_WRITE_FILE_CMD_EID  (FRAME_TRACE_BASE_EID + 1)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+typedef enum
+{
+
+   FRAME_TRACE_TASK_RADIO = 0,
+   FRAME_TRACE_TASK_TX,
+   FRAME_TRACE_TASK_RX,
+   FRAME_TRACE_TASK_CNT
+
+} FRAME_TRACE_Task_t;
+
+
+typedef enum
+{
+
+   FRAME_TRACE_TX_ENQUEUE = 0,
+   FRAME_TRACE_TX_ENCODE,
+   FRAME_TRACE_TX_RADIO_WAIT,
+   FRAME_TRACE_TX_SEND,
+   FRAME_TRACE_TX_DONE,
+   FRAME_TRACE_RX_RADIO_WAIT,
+   FRAME_TRACE_RX_RECEIVE,
+   FRAME_TRACE_RX_DECODE,
+   FRAME_TRACE_RX_DISK_WRITE,
+   FRAME_TRACE_STAGE_CNT
+
+} FRAME_TRACE_Stage_t;
+
+
+typedef struct
+{
+
+   int64   StartUsec;
+   uint32  DurUsec;     /* 0 for an instant */
+   uint16  Seq;
+   uint8   Stage;
+   uint8   Len;         /* Frame length */
+
+} FRAME_TRACE_Entry_t;
+
+
+typedef struct
+{
+
+   _Alignas(64) atomic_uint Head;   /* Free running, only written by the owning task */
+   FRAME_TRACE_Entry_t Entry[FRAME_TRACE_RING_LEN];
+
+} FRAME_TRACE_Ring_t;
+
+
+/******************************************************************************
+** FRAME_TRACE_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Class State Data
+   */
+
+   atomic_bool  Enabled;
+   uint32       Base[LORA_RADIO_MAX][FRAME_TRACE_TASK_CNT];   /* Ring heads when tracing was enabled */
+
+   FRAME_TRACE_Ring_t Ring[LORA_RADIO_MAX][FRAME_TRACE_TASK_CNT];
+
+} FRAME_TRACE_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: FRAME_TRACE_Constructor
+**
+** Initialize the Frame Trace object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**   2. Tracing starts disabled.
+**
+*/
+void FRAME_TRACE_Constructor(FRAME_TRACE_Class_t *FrameTracePtr);
+
+
+/******************************************************************************
+** Function: FRAME_TRACE_Enabled
+**
+*/
+bool FRAME_TRACE_Enabled(void);
+
+
+/******************************************************************************
+** Function: FRAME_TRACE_Record
+**
+** Record a stage that started at StartTime and ended now in the calling
+** task's ring
+**
+** Notes:
+**   1. A NULL StartTime records an instant.
+**   2. Does nothing if tracing is disabled.
+**
+*/
+void FRAME_TRACE_Record(uint8 Radio, FRAME_TRACE_Task_t Task, FRAME_TRACE_Stage_t Stage, uint16 Seq, uint8 Len,
+                        const OS_time_t *StartTime);
+
+
+/******************************************************************************
+** Function: FRAME_TRACE_RecordSpan
+**
+** Record a stage that started at StartTime and ended at EndTime in the
+** calling task's ring
+**
+** Notes:
+**   1. Does nothing if tracing is disabled.
+**
+*/
+void FRAME_TRACE_RecordSpan(uint8 Radio, FRAME_TRACE_Task_t Task, FRAME_TRACE_Stage_t Stage,
+                            uint16 Seq, uint8 Len, const OS_time_t *StartTime, const OS_time_t *EndTime);
+
+
+/******************************************************************************
+** Function: FRAME_TRACE_ConfigCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**   2. Enabling discards the entries recorded before it.
+*/
+bool FRAME_TRACE_ConfigCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: FRAME_TRACE_WriteFileCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool FRAME_TRACE_WriteFileCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _frame_trace_ */
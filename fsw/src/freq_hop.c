@@ -0,0 +1,471 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the Frequency Hopping Class methods
+**
+**  Notes:
+**    1. See freq_hop.h file prologue.
+**    2. The permutation uses its own xorshift32 generator so the hop
+**       sequence doesn't depend on the C library rand() implementation of
+**       either end of the link.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "evt_sum.h"
+#include "radio_task.h"
+#include "freq_hop.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/* Convenience macros */
+#define  INITBL_OBJ   (FreqHop->IniTbl)
+
+#define  CHANNEL_BIT(Channel)  (1UL << (Channel))
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void   BuildSequence(FREQ_HOP_Class_t *FreqHop, uint32 Seed);
+static void   BuildSlotChannels(FREQ_HOP_Class_t *FreqHop);
+static uint8  ChannelPer(const FREQ_HOP_ChannelStats_t *ChannelStats);
+static uint8  SeqChannel(const FREQ_HOP_Class_t *FreqHop, uint16 Seq);
+static uint32 NextRand(uint32 *State);
+
+
+/******************************************************************************
+** Function: FREQ_HOP_Constructor
+**
+** Initialize the Frequency Hopping object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**   2. The hop sequence is computed from the JSON init file parameters.
+**
+*/
+void FREQ_HOP_Constructor(FREQ_HOP_Class_t *FreqHop, INITBL_Class_t *IniTbl,
+                          const RADIO_INST_Cfg_t *Inst, RADIO_TASK_Class_t *RadioTask)
+{
+
+   uint32 BaseFreqKhz;
+   uint32 SpacingKhz;
+   uint16 Channel;
+
+   memset(FreqHop, 0, sizeof(FREQ_HOP_Class_t));
+
+   FreqHop->IniTbl    = IniTbl;
+   FreqHop->RadioTask = RadioTask;
+   FreqHop->Radio     = Inst->Index;
+
+   FreqHop->DwellFrames  = INITBL_GetIntConfig(INITBL_OBJ, CFG_HOP_DWELL_FRAMES);
+   FreqHop->ChannelCnt   = INITBL_GetIntConfig(INITBL_OBJ, CFG_HOP_CHANNEL_CNT);
+   FreqHop->PerLimitPct  = INITBL_GetIntConfig(INITBL_OBJ, CFG_HOP_PER_LIMIT_PCT);
+   FreqHop->PerMinFrames = INITBL_GetIntConfig(INITBL_OBJ, CFG_HOP_PER_MIN_FRAMES);
+   BaseFreqKhz = INITBL_GetIntConfig(INITBL_OBJ, CFG_HOP_BASE_FREQ_KHZ);
+   SpacingKhz  = INITBL_GetIntConfig(INITBL_OBJ, CFG_HOP_SPACING_KHZ);
+
+   if (FreqHop->ChannelCnt < 1 || FreqHop->ChannelCnt > FREQ_HOP_MAX_CHANNELS)
+   {
+      CFE_EVS_SendEvent(FREQ_HOP_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Invalid hop channel count %d, must be between 1 and %d. Hopping disabled",
+                        FreqHop->ChannelCnt, FREQ_HOP_MAX_CHANNELS);
+      FreqHop->ChannelCnt  = 1;
+      FreqHop->DwellFrames = 0;
+   }
+
+   for (Channel=0; Channel < FreqHop->ChannelCnt; Channel++)
+   {
+      FreqHop->ChannelFreq[Channel] = (BaseFreqKhz + Channel*SpacingKhz) * 1000UL;
+   }
+
+   BuildSequence(FreqHop, INITBL_GetIntConfig(INITBL_OBJ, CFG_HOP_SEED));
+   BuildSlotChannels(FreqHop);
+
+   CFE_MSG_Init(CFE_MSG_PTR(FreqHop->HopTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_LORA_HOP_TLM_TOPICID)), sizeof(LORA_HopTlm_t));
+
+} /* End FREQ_HOP_Constructor() */
+
+
+/******************************************************************************
+** Function: FREQ_HOP_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+** Notes:
+**   1. Clears the channel statistics and the automatic blacklist.
+**
+*/
+void FREQ_HOP_ResetStatus(FREQ_HOP_Class_t *FreqHop)
+{
+
+   memset(FreqHop->ChannelStats, 0, sizeof(FreqHop->ChannelStats));
+
+   FreqHop->AutoBlacklistMask = 0;
+   FreqHop->RetuneCnt    = 0;
+   FreqHop->RetuneErrCnt = 0;
+
+} /* End FREQ_HOP_ResetStatus() */
+
+
+/******************************************************************************
+** Function: FREQ_HOP_Enabled
+**
+*/
+bool FREQ_HOP_Enabled(const FREQ_HOP_Class_t *FreqHop)
+{
+
+   return (FreqHop->DwellFrames > 0);
+
+} /* End FREQ_HOP_Enabled() */
+
+
+/******************************************************************************
+** Function: FREQ_HOP_CycleLen
+**
+** Return the number of frames in one pass through the hop sequence
+**
+*/
+uint32 FREQ_HOP_CycleLen(const FREQ_HOP_Class_t *FreqHop)
+{
+
+   return (uint32)FreqHop->DwellFrames * FreqHop->ChannelCnt;
+
+} /* End FREQ_HOP_CycleLen() */
+
+
+/******************************************************************************
+** Function: FREQ_HOP_GetBlacklist
+**
+*/
+uint32 FREQ_HOP_GetBlacklist(const FREQ_HOP_Class_t *FreqHop)
+{
+
+   return FreqHop->BlacklistMask;
+
+} /* End FREQ_HOP_GetBlacklist() */
+
+
+/******************************************************************************
+** Function: FREQ_HOP_SetBlacklist
+**
+** Notes:
+**   1. Returns false and leaves the blacklist unchanged if the mask would
+**      remove every channel.
+**
+*/
+bool FREQ_HOP_SetBlacklist(FREQ_HOP_Class_t *FreqHop, uint32 BlacklistMask)
+{
+
+   uint32 ChannelMask = (FreqHop->ChannelCnt < 32) ? (CHANNEL_BIT(FreqHop->ChannelCnt) - 1) : UINT32_MAX;
+
+   if ((BlacklistMask & ChannelMask) == ChannelMask)
+   {
+      return false;
+   }
+
+   if (BlacklistMask != FreqHop->BlacklistMask)
+   {
+      FreqHop->BlacklistMask = BlacklistMask;
+      BuildSlotChannels(FreqHop);
+   }
+
+   return true;
+
+} /* End FREQ_HOP_SetBlacklist() */
+
+
+/******************************************************************************
+** Function: FREQ_HOP_Start
+**
+** Prepare for a new transfer.
+**
+*/
+void FREQ_HOP_Start(FREQ_HOP_Class_t *FreqHop)
+{
+
+   FreqHop->TunedFreq = 0;
+
+} /* End FREQ_HOP_Start() */
+
+
+/******************************************************************************
+** Function: FREQ_HOP_Tune
+**
+** Tune the radio to the channel used by the frame with sequence number Seq.
+**
+** Notes:
+**   1. The radio is only reprogrammed if the channel changes so dwelling on
+**      a channel costs nothing.
+**
+*/
+bool FREQ_HOP_Tune(FREQ_HOP_Class_t *FreqHop, RADIO_TASK_Client_t Client, uint16 Seq)
+{
+
+   bool   RetStatus = true;
+   uint32 Freq = FreqHop->ChannelFreq[SeqChannel(FreqHop, Seq)];
+
+   if (Freq != FreqHop->TunedFreq)
+   {
+      RetStatus = RADIO_TASK_SetRadioFrequency(FreqHop->RadioTask, Client, Freq);
+      if (RetStatus)
+      {
+         FreqHop->TunedFreq = Freq;
+         FreqHop->RetuneCnt++;
+      }
+      else
+      {
+         FreqHop->TunedFreq = 0;
+         FreqHop->RetuneErrCnt++;
+         EVT_SUM_Count(EVT_SUM_HOP_TUNE_ERR, Seq);
+      }
+   }
+
+   return RetStatus;
+
+} /* End FREQ_HOP_Tune() */
+
+
+/******************************************************************************
+** Function: FREQ_HOP_RecordFrame
+**
+** Record the outcome of the frame slot Seq on its channel
+**
+** Notes:
+**   1. A channel is added to the automatic blacklist once it has at least
+**      PerMinFrames frames and its PER exceeds PerLimitPct. The event is
+**      only sent when the channel is first flagged.
+**
+*/
+void FREQ_HOP_RecordFrame(FREQ_HOP_Class_t *FreqHop, uint16 Seq, bool Lost)
+{
+
+   uint8 Channel = SeqChannel(FreqHop, Seq);
+   FREQ_HOP_ChannelStats_t *ChannelStats = &FreqHop->ChannelStats[Channel];
+
+   ChannelStats->FrameCnt++;
+   if (!Lost)
+   {
+      return;
+   }
+
+   ChannelStats->LostCnt++;
+
+   if ((FreqHop->AutoBlacklistMask & CHANNEL_BIT(Channel)) == 0 &&
+       ChannelStats->FrameCnt >= FreqHop->PerMinFrames &&
+       ChannelPer(ChannelStats) > FreqHop->PerLimitPct)
+   {
+      FreqHop->AutoBlacklistMask |= CHANNEL_BIT(Channel);
+      CFE_EVS_SendEvent(FREQ_HOP_AUTO_BLACKLIST_EID, CFE_EVS_EventType_INFORMATION,
+                        "Hop channel %d (%u kHz) PER %d%% exceeds %d%% limit. Recommended blacklist 0x%08X",
+                        Channel, (unsigned int)(FreqHop->ChannelFreq[Channel]/1000), ChannelPer(ChannelStats),
+                        (int)FreqHop->PerLimitPct, (unsigned int)(FreqHop->AutoBlacklistMask | FreqHop->BlacklistMask));
+   }
+
+} /* End FREQ_HOP_RecordFrame() */
+
+
+/******************************************************************************
+** Function: FREQ_HOP_SetBlacklistCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**   2. The new blacklist takes effect with the next frame.
+*/
+bool FREQ_HOP_SetBlacklistCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   FREQ_HOP_Class_t *FreqHop = (FREQ_HOP_Class_t *)ObjDataPtr;
+   const LORA_SetHopBlacklist_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_SetHopBlacklist_t);
+
+   bool RetStatus = FREQ_HOP_SetBlacklist(FreqHop, Cmd->BlacklistMask);
+
+   if (RetStatus)
+   {
+      CFE_EVS_SendEvent(FREQ_HOP_SET_BLACKLIST_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                        "Hop channel blacklist set to 0x%08X", (unsigned int)Cmd->BlacklistMask);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(FREQ_HOP_SET_BLACKLIST_CMD_EID, CFE_EVS_EventType_ERROR,
+                        "Set hop channel blacklist command rejected, mask 0x%08X removes all %d channels",
+                        (unsigned int)Cmd->BlacklistMask, FreqHop->ChannelCnt);
+   }
+
+   return RetStatus;
+
+} /* End FREQ_HOP_SetBlacklistCmd() */
+
+
+/******************************************************************************
+** Function: FREQ_HOP_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool FREQ_HOP_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   FREQ_HOP_Class_t *FreqHop = (FREQ_HOP_Class_t *)ObjDataPtr;
+   LORA_HopTlm_Payload_t *HopTlmPayload = &FreqHop->HopTlm.Payload;
+   uint16 Channel;
+
+   memset(HopTlmPayload, 0, sizeof(LORA_HopTlm_Payload_t));
+
+   HopTlmPayload->Radio             = FreqHop->Radio;
+   HopTlmPayload->DwellFrames       = FreqHop->DwellFrames;
+   HopTlmPayload->ChannelCnt        = FreqHop->ChannelCnt;
+   HopTlmPayload->BlacklistMask     = FreqHop->BlacklistMask;
+   HopTlmPayload->AutoBlacklistMask = FreqHop->AutoBlacklistMask;
+   HopTlmPayload->RetuneCnt         = FreqHop->RetuneCnt;
+   HopTlmPayload->RetuneErrCnt      = FreqHop->RetuneErrCnt;
+
+   for (Channel=0; Channel < FreqHop->ChannelCnt; Channel++)
+   {
+      HopTlmPayload->ChannelFrameCnt[Channel] = FreqHop->ChannelStats[Channel].FrameCnt;
+      HopTlmPayload->ChannelLostCnt[Channel]  = FreqHop->ChannelStats[Channel].LostCnt;
+      HopTlmPayload->ChannelPer[Channel]      = ChannelPer(&FreqHop->ChannelStats[Channel]);
+   }
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(FreqHop->HopTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(FreqHop->HopTlm.TelemetryHeader), true);
+
+   CFE_EVS_SendEvent(FREQ_HOP_SEND_TLM_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                     "Sent frequency hopping telemetry message");
+   return true;
+
+} /* End FREQ_HOP_SendTlmCmd() */
+
+
+/******************************************************************************
+** Function: BuildSequence
+**
+** Notes:
+**   1. Fisher-Yates shuffle of the channel indices.
+**   2. A seed of zero would lock the generator at zero so it's replaced.
+*/
+static void BuildSequence(FREQ_HOP_Class_t *FreqHop, uint32 Seed)
+{
+
+   uint32 RandState = (Seed == 0) ? 1 : Seed;
+   uint16 i;
+   uint16 j;
+   uint8  Channel;
+
+   for (i=0; i < FreqHop->ChannelCnt; i++)
+   {
+      FreqHop->Sequence[i] = i;
+   }
+
+   for (i=FreqHop->ChannelCnt-1; i > 0; i--)
+   {
+      j = NextRand(&RandState) % (i+1);
+      Channel = FreqHop->Sequence[i];
+      FreqHop->Sequence[i] = FreqHop->Sequence[j];
+      FreqHop->Sequence[j] = Channel;
+   }
+
+} /* End BuildSequence() */
+
+
+/******************************************************************************
+** Function: BuildSlotChannels
+**
+** Notes:
+**   1. Each blacklisted slot takes the next usable channel in the hop
+**      sequence so slots that use good channels are unchanged. A receiver
+**      that hasn't adopted a new blacklist yet still hears those slots.
+**   2. FREQ_HOP_SetBlacklist() guarantees at least one usable channel.
+*/
+static void BuildSlotChannels(FREQ_HOP_Class_t *FreqHop)
+{
+
+   uint16 Slot;
+   uint16 Next;
+
+   for (Slot=0; Slot < FreqHop->ChannelCnt; Slot++)
+   {
+      Next = Slot;
+      while (FreqHop->BlacklistMask & CHANNEL_BIT(FreqHop->Sequence[Next]))
+      {
+         Next = (Next + 1) % FreqHop->ChannelCnt;
+      }
+      FreqHop->SlotChannel[Slot] = FreqHop->Sequence[Next];
+   }
+
+} /* End BuildSlotChannels() */
+
+
+/******************************************************************************
+** Function: ChannelPer
+**
+** Return the channel's packet error rate as a percentage.
+*/
+static uint8 ChannelPer(const FREQ_HOP_ChannelStats_t *ChannelStats)
+{
+
+   return (ChannelStats->FrameCnt == 0) ? 0 : (uint8)((ChannelStats->LostCnt * 100ULL) / ChannelStats->FrameCnt);
+
+} /* End ChannelPer() */
+
+
+/******************************************************************************
+** Function: SeqChannel
+**
+** Return the channel used by the frame with sequence number Seq.
+**
+** Notes:
+**   1. Everything uses slot 0 when hopping is disabled.
+*/
+static uint8 SeqChannel(const FREQ_HOP_Class_t *FreqHop, uint16 Seq)
+{
+
+   uint16 Slot = 0;
+
+   if (FreqHop->DwellFrames > 0)
+   {
+      Slot = (Seq / FreqHop->DwellFrames) % FreqHop->ChannelCnt;
+   }
+
+   return FreqHop->SlotChannel[Slot];
+
+} /* End SeqChannel() */
+
+
+/******************************************************************************
+** Function: NextRand
+**
+*/
+static uint32 NextRand(uint32 *State)
+{
+
+   uint32 x = *State;
+
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+   *State = x;
+
+   return x;
+
+} /* End NextRand() */
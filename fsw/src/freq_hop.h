@@ -0,0 +1,254 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the frequency hopping scheduler class
+**
+**  Notes:
+**    1. The hop sequence is a seeded permutation of the channel list that
+**       is computed once by the constructor. Both ends of a link use the
+**       same JSON init file values so they compute the same sequence.
+**    2. The channel for a frame is selected by its sequence number:
+**       Sequence[(Seq/DwellFrames) % ChannelCnt]. DwellFrames=1 hops every
+**       frame and DwellFrames=0 disables hopping.
+**    3. Blacklisted channels are replaced by the next usable channel in the
+**       hop sequence. The slot to channel map is recomputed only when the
+**       blacklist changes so a hop is a table lookup.
+**    4. Retuning only calls RADIO_TASK_SetRadioFrequency(), which is a single
+**       SX1280 SPI command, and is skipped when the channel doesn't change.
+**    5. The receiver measures the per-channel packet error rate (PER) and
+**       flags channels over the PER limit in AutoBlacklistMask. The link has
+**       no return path so the transmitter's blacklist is set by command.
+**       The transmitter sends its blacklist in every frame header and the
+**       receiver adopts it so both ends stay synchronized.
+**
+*/
+
+#ifndef _freq_hop_
+#define _freq_hop_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "radio_task.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define FREQ_HOP_MAX_CHANNELS  32  /* Blacklist is a uint32 mask, must match lora.xml arrays */
+
+
+/*
+** Event Message IDs
+*/
+
+#define FREQ_HOP_CONSTRUCTOR_EID        (FREQ_HOP_BASE_EID + 0)
+#define FREQ_HOP_SET_BLACKLIST_CMD_EID  (FREQ_HOP_BASE_EID + 1)
+#define FREQ_HOP_SEND_TLM_CMD_EID       (FREQ_HOP_BASE_EID + 2)
+#define FREQ_HOP_AUTO_BLACKLIST_EID     (FREQ_HOP_BASE_EID + 3)
+#define FREQ_HOP_TUNE_EID               (FREQ_HOP_BASE_EID + 4)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+typedef struct
+{
+
+   uint32  FrameCnt;
+   uint32  LostCnt;
+
+} FREQ_HOP_ChannelStats_t;
+
+
+/******************************************************************************
+** FREQ_HOP_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Framework References
+   */
+
+   INITBL_Class_t *IniTbl;
+
+   /*
+   ** Object References
+   */
+
+   RADIO_TASK_Class_t *RadioTask;
+
+   /*
+   ** Telemetry Packets
+   */
+
+   LORA_HopTlm_t  HopTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   uint8   Radio;
+
+   uint16  DwellFrames;
+   uint16  ChannelCnt;
+   uint32  ChannelFreq[FREQ_HOP_MAX_CHANNELS];    /* Hz */
+   uint8   Sequence[FREQ_HOP_MAX_CHANNELS];       /* Seeded channel permutation */
+   uint8   SlotChannel[FREQ_HOP_MAX_CHANNELS];    /* Sequence with blacklist applied */
+
+   uint32  BlacklistMask;
+   uint32  AutoBlacklistMask;
+   uint32  PerLimitPct;
+   uint32  PerMinFrames;
+
+   uint32  TunedFreq;
+   uint32  RetuneCnt;
+   uint32  RetuneErrCnt;
+
+   FREQ_HOP_ChannelStats_t  ChannelStats[FREQ_HOP_MAX_CHANNELS];
+
+} FREQ_HOP_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: FREQ_HOP_Constructor
+**
+** Initialize the Frequency Hopping object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**   2. The hop sequence is computed from the JSON init file parameters.
+**
+*/
+void FREQ_HOP_Constructor(FREQ_HOP_Class_t *FreqHop, INITBL_Class_t *IniTbl,
+                          const RADIO_INST_Cfg_t *Inst, RADIO_TASK_Class_t *RadioTask);
+
+
+/******************************************************************************
+** Function: FREQ_HOP_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+** Notes:
+**   1. Clears the channel statistics and the automatic blacklist.
+**
+*/
+void FREQ_HOP_ResetStatus(FREQ_HOP_Class_t *FreqHop);
+
+
+/******************************************************************************
+** Function: FREQ_HOP_Enabled
+**
+*/
+bool FREQ_HOP_Enabled(const FREQ_HOP_Class_t *FreqHop);
+
+
+/******************************************************************************
+** Function: FREQ_HOP_CycleLen
+**
+** Return the number of frames in one pass through the hop sequence
+**
+*/
+uint32 FREQ_HOP_CycleLen(const FREQ_HOP_Class_t *FreqHop);
+
+
+/******************************************************************************
+** Function: FREQ_HOP_GetBlacklist
+**
+*/
+uint32 FREQ_HOP_GetBlacklist(const FREQ_HOP_Class_t *FreqHop);
+
+
+/******************************************************************************
+** Function: FREQ_HOP_SetBlacklist
+**
+** Notes:
+**   1. Returns false and leaves the blacklist unchanged if the mask would
+**      remove every channel.
+**
+*/
+bool FREQ_HOP_SetBlacklist(FREQ_HOP_Class_t *FreqHop, uint32 BlacklistMask);
+
+
+/******************************************************************************
+** Function: FREQ_HOP_Start
+**
+** Prepare for a new transfer.
+**
+** Notes:
+**   1. Forces the next FREQ_HOP_Tune() to program the radio because other
+**      objects may have changed the radio frequency.
+**
+*/
+void FREQ_HOP_Start(FREQ_HOP_Class_t *FreqHop);
+
+
+/******************************************************************************
+** Function: FREQ_HOP_Tune
+**
+** Tune the radio to the channel used by the frame with sequence number Seq.
+**
+** Notes:
+**   1. The radio is only reprogrammed if the channel changes.
+**
+*/
+bool FREQ_HOP_Tune(FREQ_HOP_Class_t *FreqHop, RADIO_TASK_Client_t Client, uint16 Seq);
+
+
+/******************************************************************************
+** Function: FREQ_HOP_RecordFrame
+**
+** Record the outcome of the frame slot Seq on its channel
+**
+** Notes:
+**   1. Lost is always false on the transmitter.
+**   2. Updates AutoBlacklistMask when the channel exceeds the PER limit.
+**
+*/
+void FREQ_HOP_RecordFrame(FREQ_HOP_Class_t *FreqHop, uint16 Seq, bool Lost);
+
+
+/******************************************************************************
+** Function: FREQ_HOP_SetBlacklistCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool FREQ_HOP_SetBlacklistCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: FREQ_HOP_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool FREQ_HOP_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _freq_hop_ */
@@ -0,0 +1,427 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the Latency Class methods
+**
+**  Notes:
+**    1. See latency.h file prologue.
+**    2. With t1 the local exchange time a reply echoes, t2 and t3 the
+**       peer's receive and transmit times and t4 the reply's receive time,
+**       the round trip is (t4-t1)-(t3-t2) and the peer's offset is
+**       (t2-t1) less half the round trip.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "latency.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define LATENCY_MUTEX_NAME  "LORA_LAT_MUT"
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void LoadStatsTlm(LORA_LinkLatencyStats_t *StatsTlm, const LATENCY_Stats_t *Stats);
+static bool MatchSentExch(LATENCY_Class_t *Latency, uint32 ExchTx);
+static void RecordExch(LATENCY_Class_t *Latency, uint32 RttUsec, uint32 Offset);
+static void RecordSample(LATENCY_Stats_t *Stats, uint32 Usec);
+static void ResetStats(LATENCY_Stats_t *Stats);
+
+
+/******************************************************************************
+** Function: LATENCY_Constructor
+**
+** Initialize the Latency object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void LATENCY_Constructor(LATENCY_Class_t *Latency, INITBL_Class_t *IniTbl,
+                         const RADIO_INST_Cfg_t *Inst)
+{
+
+   int32 SysStatus;
+   char  MutexName[OS_MAX_API_NAME];
+
+   memset(Latency, 0, sizeof(LATENCY_Class_t));
+
+   Latency->Timestamps   = (INITBL_GetIntConfig(IniTbl, CFG_LATENCY_TIMESTAMPS) != 0);
+   Latency->ExchangeUsec = INITBL_GetIntConfig(IniTbl, CFG_LATENCY_EXCHANGE_MS) * 1000;
+
+   /* Without exchanges the clocks are taken to be synchronized */
+   Latency->OffsetValid = (Latency->ExchangeUsec == 0);
+
+   ResetStats(&Latency->OneWay);
+   ResetStats(&Latency->Rtt);
+
+   RADIO_INST_Name(MutexName, sizeof(MutexName), LATENCY_MUTEX_NAME, Inst);
+   SysStatus = OS_MutSemCreate(&Latency->MutexId, MutexName, 0);
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(LATENCY_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating latency mutex %s, Status = %d", MutexName, SysStatus);
+   }
+
+   CFE_MSG_Init(CFE_MSG_PTR(Latency->LatencyTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_LORA_LATENCY_TLM_TOPICID)), sizeof(LORA_LatencyTlm_t));
+   Latency->LatencyTlm.Payload.Radio = Inst->Index;
+
+} /* End LATENCY_Constructor() */
+
+
+/******************************************************************************
+** Function: LATENCY_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+*/
+void LATENCY_ResetStatus(LATENCY_Class_t *Latency)
+{
+
+   OS_MutSemTake(Latency->MutexId);
+
+   Latency->ExchSentCnt      = 0;
+   Latency->ExchRcvdCnt      = 0;
+   Latency->ExchUnmatchedCnt = 0;
+   Latency->StampedRxCnt     = 0;
+   Latency->NoOffsetCnt      = 0;
+   Latency->NegativeCnt      = 0;
+   ResetStats(&Latency->OneWay);
+   ResetStats(&Latency->Rtt);
+
+   OS_MutSemGive(Latency->MutexId);
+
+} /* End LATENCY_ResetStatus() */
+
+
+/******************************************************************************
+** Function: LATENCY_StampLen
+**
+*/
+uint16 LATENCY_StampLen(const LATENCY_Class_t *Latency)
+{
+
+   return Latency->Timestamps ? 4 : 0;
+
+} /* End LATENCY_StampLen() */
+
+
+/******************************************************************************
+** Function: LATENCY_MaxStampLen
+**
+*/
+uint16 LATENCY_MaxStampLen(const LATENCY_Class_t *Latency)
+{
+
+   return LATENCY_StampLen(Latency) + (Latency->ExchangeUsec ? 12 : 0);
+
+} /* End LATENCY_MaxStampLen() */
+
+
+/******************************************************************************
+** Function: LATENCY_StampTx
+**
+** Notes:
+**   1. A pending peer exchange is echoed once, a reply that's lost isn't
+**      repeated since the peer's next exchange replaces it.
+**
+*/
+void LATENCY_StampTx(LATENCY_Class_t *Latency, LORA_FRAME_Hdr_t *FrameHdr,
+                     int64 EnqueueUsec, int64 EncodeUsec)
+{
+
+   if (Latency->Timestamps && FrameHdr->Type != LORA_FRAME_TYPE_SB_STORED)
+   {
+      FrameHdr->Flags    |= LORA_FRAME_FLAG_TIMESTAMP;
+      FrameHdr->Timestamp = (uint32)((EnqueueUsec != 0) ? EnqueueUsec : EncodeUsec);
+   }
+
+   if (Latency->ExchangeUsec == 0 || (EncodeUsec - Latency->LastExchUsec) < Latency->ExchangeUsec)
+   {
+      return;
+   }
+
+   Latency->LastExchUsec = EncodeUsec;
+
+   FrameHdr->Flags  |= LORA_FRAME_FLAG_TIME_EXCH;
+   FrameHdr->ExchTx  = (uint32)EncodeUsec;
+
+   OS_MutSemTake(Latency->MutexId);
+
+   if (Latency->PeerExchValid)
+   {
+      FrameHdr->ExchEcho = Latency->PeerExchTx;
+      FrameHdr->ExchRx   = Latency->PeerExchRx;
+      Latency->PeerExchValid = false;
+   }
+   else
+   {
+      FrameHdr->ExchEcho = 0;
+      FrameHdr->ExchRx   = 0;
+   }
+
+   Latency->SentExch[Latency->SentExchIdx]      = FrameHdr->ExchTx;
+   Latency->SentExchValid[Latency->SentExchIdx] = true;
+   Latency->SentExchIdx = (Latency->SentExchIdx + 1) % LATENCY_EXCH_HIST;
+   Latency->ExchSentCnt++;
+
+   OS_MutSemGive(Latency->MutexId);
+
+} /* End LATENCY_StampTx() */
+
+
+/******************************************************************************
+** Function: LATENCY_RecordRx
+**
+** Notes:
+**   1. A round trip below 0 is only possible if a clock stepped, the
+**      exchange is discarded.
+**
+*/
+void LATENCY_RecordRx(LATENCY_Class_t *Latency, const LORA_FRAME_Hdr_t *FrameHdr,
+                      int64 RxUsec)
+{
+
+   uint32 RxTime = (uint32)RxUsec;
+   int32  RttUsec;
+   int32  OneWayUsec;
+
+   if ((FrameHdr->Flags & (LORA_FRAME_FLAG_TIMESTAMP | LORA_FRAME_FLAG_TIME_EXCH)) == 0)
+   {
+      return;
+   }
+
+   OS_MutSemTake(Latency->MutexId);
+
+   if (FrameHdr->Flags & LORA_FRAME_FLAG_TIME_EXCH)
+   {
+      Latency->ExchRcvdCnt++;
+      Latency->PeerExchTx    = FrameHdr->ExchTx;
+      Latency->PeerExchRx    = RxTime;
+      Latency->PeerExchValid = true;
+
+      if (MatchSentExch(Latency, FrameHdr->ExchEcho))
+      {
+         RttUsec = (int32)(RxTime - FrameHdr->ExchEcho) - (int32)(FrameHdr->ExchTx - FrameHdr->ExchRx);
+         if (RttUsec >= 0)
+         {
+            RecordExch(Latency, (uint32)RttUsec, (FrameHdr->ExchRx - FrameHdr->ExchEcho) - (uint32)(RttUsec / 2));
+         }
+      }
+      else
+      {
+         Latency->ExchUnmatchedCnt++;
+      }
+   }
+
+   if (FrameHdr->Flags & LORA_FRAME_FLAG_TIMESTAMP)
+   {
+      Latency->StampedRxCnt++;
+      if (Latency->OffsetValid)
+      {
+         OneWayUsec = (int32)(RxTime - FrameHdr->Timestamp + Latency->Offset);
+         if (OneWayUsec < 0)
+         {
+            Latency->NegativeCnt++;
+            OneWayUsec = 0;
+         }
+         RecordSample(&Latency->OneWay, (uint32)OneWayUsec);
+      }
+      else
+      {
+         Latency->NoOffsetCnt++;
+      }
+   }
+
+   OS_MutSemGive(Latency->MutexId);
+
+} /* End LATENCY_RecordRx() */
+
+
+/******************************************************************************
+** Function: LATENCY_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool LATENCY_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   LATENCY_Class_t *Latency = (LATENCY_Class_t *)ObjDataPtr;
+   LORA_LatencyTlm_Payload_t *LatencyTlmPayload = &Latency->LatencyTlm.Payload;
+
+   OS_MutSemTake(Latency->MutexId);
+
+   LatencyTlmPayload->Timestamps       = Latency->Timestamps;
+   LatencyTlmPayload->OffsetValid      = Latency->OffsetValid;
+   LatencyTlmPayload->ExchangeMs       = Latency->ExchangeUsec / 1000;
+   LatencyTlmPayload->ClockOffsetUsec  = (int32)Latency->Offset;
+   LatencyTlmPayload->OffsetRttUsec    = Latency->OffsetRttUsec;
+   LatencyTlmPayload->ExchSentCnt      = Latency->ExchSentCnt;
+   LatencyTlmPayload->ExchRcvdCnt      = Latency->ExchRcvdCnt;
+   LatencyTlmPayload->ExchUnmatchedCnt = Latency->ExchUnmatchedCnt;
+   LatencyTlmPayload->StampedRxCnt     = Latency->StampedRxCnt;
+   LatencyTlmPayload->NoOffsetCnt      = Latency->NoOffsetCnt;
+   LatencyTlmPayload->NegativeCnt      = Latency->NegativeCnt;
+   LoadStatsTlm(&LatencyTlmPayload->OneWay, &Latency->OneWay);
+   LoadStatsTlm(&LatencyTlmPayload->Rtt, &Latency->Rtt);
+
+   OS_MutSemGive(Latency->MutexId);
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(Latency->LatencyTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(Latency->LatencyTlm.TelemetryHeader), true);
+
+   CFE_EVS_SendEvent(LATENCY_SEND_TLM_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                     "Sent radio %u latency telemetry message", LatencyTlmPayload->Radio);
+   return true;
+
+} /* End LATENCY_SendTlmCmd() */
+
+
+/******************************************************************************
+** Function: LoadStatsTlm
+**
+*/
+static void LoadStatsTlm(LORA_LinkLatencyStats_t *StatsTlm, const LATENCY_Stats_t *Stats)
+{
+
+   StatsTlm->Cnt      = Stats->Cnt;
+   StatsTlm->MinUsec  = Stats->Cnt ? Stats->MinUsec : 0;
+   StatsTlm->AvgUsec  = Stats->Cnt ? (uint32)(Stats->TotalUsec/Stats->Cnt) : 0;
+   StatsTlm->MaxUsec  = Stats->MaxUsec;
+   StatsTlm->LastUsec = Stats->LastUsec;
+
+   memcpy(StatsTlm->Hist, Stats->Hist, sizeof(Stats->Hist));
+
+} /* End LoadStatsTlm() */
+
+
+/******************************************************************************
+** Function: MatchSentExch
+**
+** Return whether ExchTx is one of the recent exchanges this end sent
+**
+** Notes:
+**   1. A matched exchange is cleared so a duplicate reply isn't counted.
+**
+*/
+static bool MatchSentExch(LATENCY_Class_t *Latency, uint32 ExchTx)
+{
+
+   uint16 i;
+
+   for (i=0; i < LATENCY_EXCH_HIST; i++)
+   {
+      if (Latency->SentExchValid[i] && Latency->SentExch[i] == ExchTx)
+      {
+         Latency->SentExchValid[i] = false;
+         return true;
+      }
+   }
+
+   return false;
+
+} /* End MatchSentExch() */
+
+
+/******************************************************************************
+** Function: RecordExch
+**
+** Record a round trip and update the offset estimate
+**
+** Notes:
+**   1. Without exchanges configured the offset stays 0, a peer's replies
+**      can't match since none are sent.
+**
+*/
+static void RecordExch(LATENCY_Class_t *Latency, uint32 RttUsec, uint32 Offset)
+{
+
+   uint16 Best = 0;
+   uint16 i;
+
+   RecordSample(&Latency->Rtt, RttUsec);
+
+   Latency->Sample[Latency->SampleIdx].RttUsec = RttUsec;
+   Latency->Sample[Latency->SampleIdx].Offset  = Offset;
+   Latency->SampleIdx = (Latency->SampleIdx + 1) % LATENCY_FILTER_LEN;
+   if (Latency->SampleCnt < LATENCY_FILTER_LEN)
+   {
+      Latency->SampleCnt++;
+   }
+
+   for (i=1; i < Latency->SampleCnt; i++)
+   {
+      if (Latency->Sample[i].RttUsec < Latency->Sample[Best].RttUsec)
+      {
+         Best = i;
+      }
+   }
+
+   Latency->Offset        = Latency->Sample[Best].Offset;
+   Latency->OffsetRttUsec = Latency->Sample[Best].RttUsec;
+   Latency->OffsetValid   = true;
+
+} /* End RecordExch() */
+
+
+/******************************************************************************
+** Function: RecordSample
+**
+** Notes:
+**   1. The histogram bin is floor(log2(usec)) limited to the last bin.
+*/
+static void RecordSample(LATENCY_Stats_t *Stats, uint32 Usec)
+{
+
+   uint32 Scaled;
+   uint16 Bin = 0;
+
+   Stats->Cnt++;
+   Stats->TotalUsec += Usec;
+   Stats->LastUsec   = Usec;
+   if (Usec < Stats->MinUsec) Stats->MinUsec = Usec;
+   if (Usec > Stats->MaxUsec) Stats->MaxUsec = Usec;
+
+   for (Scaled = Usec; Scaled > 1 && Bin < (LATENCY_HIST_BINS-1); Scaled >>= 1)
+   {
+      Bin++;
+   }
+   Stats->Hist[Bin]++;
+
+} /* End RecordSample() */
+
+
+/******************************************************************************
+** Function: ResetStats
+**
+*/
+static void ResetStats(LATENCY_Stats_t *Stats)
+{
+
+   memset(Stats, 0, sizeof(LATENCY_Stats_t));
+   Stats->MinUsec = 0xFFFFFFFF;
+
+} /* End ResetStats() */
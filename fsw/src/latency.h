@@ -0,0 +1,251 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the link latency measurement class
+**
+**  Notes:
+**    1. When LATENCY_TIMESTAMPS is set the Tx task stamps each frame header
+**       with the time its data was queued for the radio: a bridged
+**       message's QoS enqueue time or, for file and link test frames, the
+**       encode time. The receiver's one-way latency sample is the receive
+**       time less the stamp, corrected by the clock offset estimate, so it
+**       includes the QoS queueing delay of bridged messages.
+**    2. Replayed stored messages aren't stamped, their latency is the
+**       outage rather than the link's.
+**    3. Every LATENCY_EXCHANGE_MS a frame also carries a clock exchange:
+**       its encode time, the last exchange time received from the peer and
+**       when it was received. These are the NTP origin, receive and transmit
+**       times so the end receiving the reply gets the round trip excluding
+**       the peer's hold time and the peer's clock offset. Exchanges ride on
+**       the frames each end sends so they need traffic in both directions.
+**    4. A reply is only used if it echoes one of the last
+**       LATENCY_EXCH_HIST exchanges this end sent. The offset estimate is
+**       the offset of the shortest round trip of the last
+**       LATENCY_FILTER_LEN replies since queueing inflates a round trip and
+**       biases its offset.
+**    5. LATENCY_EXCHANGE_MS 0 disables exchanges and the clocks are assumed
+**       to be synchronized, for example by cFE time.
+**    6. Times are the local clock's microseconds truncated to 32 bits and
+**       all the arithmetic is modulo 2^32 so the two clocks don't need a
+**       common epoch. A latency over 35 minutes can't be measured.
+**    7. The Tx task, the Rx task and the main task share the object
+**       through its mutex, it's only held to update a few counters.
+**
+*/
+
+#ifndef _latency_
+#define _latency_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "lora_frame.h"
+#include "radio_inst.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Histogram bin N counts samples of [2^N, 2^(N+1)) microseconds. Bin 0
+** includes samples under 1us and the last bin includes everything over
+** its lower bound. Must match the LinkLatencyHist array size in lora.xml.
+*/
+#define LATENCY_HIST_BINS   24
+
+#define LATENCY_EXCH_HIST    4   /* Sent exchanges a reply may echo */
+#define LATENCY_FILTER_LEN   8   /* Replies searched for the shortest round trip */
+
+
+/*
+** Event Message IDs
+*/
+
+#define LATENCY_CONSTRUCTOR_EID   (LATENCY_BASE_EID + 0)
+#define LATENCY_SEND_TLM_CMD_EID  (LATENCY_BASE_EID + 1)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+
+typedef struct
+{
+
+   uint32  Cnt;
+   uint32  MinUsec;
+   uint32  MaxUsec;
+   uint32  LastUsec;
+   uint64  TotalUsec;
+   uint32  Hist[LATENCY_HIST_BINS];
+
+} LATENCY_Stats_t;
+
+
+typedef struct
+{
+
+   uint32  RttUsec;
+   uint32  Offset;      /* Peer clock less the local clock, modulo 2^32 */
+
+} LATENCY_Sample_t;
+
+
+/******************************************************************************
+** LATENCY_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Telemetry Packets
+   */
+
+   LORA_LatencyTlm_t  LatencyTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   osal_id_t  MutexId;
+   bool       Timestamps;
+   uint32     ExchangeUsec;       /* 0 when exchanges are disabled */
+
+   /* Exchanges, written by the Tx task */
+   int64      LastExchUsec;
+   uint16     SentExchIdx;
+   uint32     SentExch[LATENCY_EXCH_HIST];
+   bool       SentExchValid[LATENCY_EXCH_HIST];
+   uint32     ExchSentCnt;
+
+   /* Exchanges, written by the Rx task */
+   bool       PeerExchValid;      /* A peer exchange is waiting to be echoed */
+   uint32     PeerExchTx;
+   uint32     PeerExchRx;
+   uint32     ExchRcvdCnt;
+   uint32     ExchUnmatchedCnt;
+   uint16     SampleIdx;
+   uint16     SampleCnt;
+   LATENCY_Sample_t Sample[LATENCY_FILTER_LEN];
+   bool       OffsetValid;
+   uint32     Offset;
+   uint32     OffsetRttUsec;
+
+   uint32     StampedRxCnt;
+   uint32     NoOffsetCnt;        /* Stamped frames received before an offset estimate */
+   uint32     NegativeCnt;        /* Samples below 0 due to offset error, counted as 0 */
+   LATENCY_Stats_t OneWay;
+   LATENCY_Stats_t Rtt;
+
+} LATENCY_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: LATENCY_Constructor
+**
+** Initialize the Latency object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void LATENCY_Constructor(LATENCY_Class_t *Latency, INITBL_Class_t *IniTbl,
+                         const RADIO_INST_Cfg_t *Inst);
+
+
+/******************************************************************************
+** Function: LATENCY_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+** Notes:
+**   1. Clears the statistics, the offset estimate is kept.
+**
+*/
+void LATENCY_ResetStatus(LATENCY_Class_t *Latency);
+
+
+/******************************************************************************
+** Function: LATENCY_StampLen
+**
+** Return the header bytes the timestamp adds to each sent frame
+**
+** Notes:
+**   1. Excludes the occasional clock exchange.
+**
+*/
+uint16 LATENCY_StampLen(const LATENCY_Class_t *Latency);
+
+
+/******************************************************************************
+** Function: LATENCY_MaxStampLen
+**
+** Return the most header bytes the timestamp and clock exchange add to a
+** sent frame
+**
+*/
+uint16 LATENCY_MaxStampLen(const LATENCY_Class_t *Latency);
+
+
+/******************************************************************************
+** Function: LATENCY_StampTx
+**
+** Add the timestamp and any due clock exchange to a frame header
+**
+** Notes:
+**   1. Called by the Tx task just before the header is encoded.
+**   2. EnqueueUsec is the local time the frame's data was queued, 0 if it's
+**      being sent as it's queued.
+**
+*/
+void LATENCY_StampTx(LATENCY_Class_t *Latency, LORA_FRAME_Hdr_t *FrameHdr,
+                     int64 EnqueueUsec, int64 EncodeUsec);
+
+
+/******************************************************************************
+** Function: LATENCY_RecordRx
+**
+** Record the latency samples of a received frame
+**
+** Notes:
+**   1. Called by the Rx task for each accepted frame.
+**
+*/
+void LATENCY_RecordRx(LATENCY_Class_t *Latency, const LORA_FRAME_Hdr_t *FrameHdr,
+                      int64 RxUsec);
+
+
+/******************************************************************************
+** Function: LATENCY_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool LATENCY_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _latency_ */
@@ -0,0 +1,293 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the Length Optimizer Class methods
+**
+**  Notes:
+**    1. See len_opt.h file prologue.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "len_opt.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define LEN_OPT_MUTEX_NAME  "LORA_LEN_MUT"
+
+
+/******************************************************************************
+** Function: LEN_OPT_Constructor
+**
+** Initialize the length optimizer object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void LEN_OPT_Constructor(LEN_OPT_Class_t *LenOpt, INITBL_Class_t *IniTbl,
+                         const RADIO_INST_Cfg_t *Inst)
+{
+
+   int32 SysStatus;
+   char  MutexName[OS_MAX_API_NAME];
+
+   memset(LenOpt, 0, sizeof(LEN_OPT_Class_t));
+
+   LenOpt->WindowLen     = INITBL_GetIntConfig(IniTbl, CFG_LEN_OPT_WINDOW);
+   LenOpt->ReportGuardMs = INITBL_GetIntConfig(IniTbl, CFG_LEN_OPT_REPORT_GUARD_MS);
+
+   RADIO_INST_Name(MutexName, sizeof(MutexName), LEN_OPT_MUTEX_NAME, Inst);
+   SysStatus = OS_MutSemCreate(&LenOpt->MutexId, MutexName, 0);
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(LEN_OPT_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating length optimizer mutex %s, Status = %d", MutexName, SysStatus);
+   }
+
+   CFE_MSG_Init(CFE_MSG_PTR(LenOpt->LenOptTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_LORA_LEN_OPT_TLM_TOPICID)), sizeof(LORA_LenOptTlm_t));
+   LenOpt->LenOptTlm.Payload.Radio = Inst->Index;
+
+} /* End LEN_OPT_Constructor() */
+
+
+/******************************************************************************
+** Function: LEN_OPT_Enabled
+**
+*/
+bool LEN_OPT_Enabled(const LEN_OPT_Class_t *LenOpt)
+{
+
+   return (LenOpt->WindowLen != 0);
+
+} /* End LEN_OPT_Enabled() */
+
+
+/******************************************************************************
+** Function: LEN_OPT_WindowLen
+**
+*/
+uint16 LEN_OPT_WindowLen(const LEN_OPT_Class_t *LenOpt)
+{
+
+   return LenOpt->WindowLen;
+
+} /* End LEN_OPT_WindowLen() */
+
+
+/******************************************************************************
+** Function: LEN_OPT_ReportTimeoutMs
+**
+*/
+uint32 LEN_OPT_ReportTimeoutMs(const LEN_OPT_Class_t *LenOpt)
+{
+
+   return LenOpt->ReportTimeoutMs;
+
+} /* End LEN_OPT_ReportTimeoutMs() */
+
+
+/******************************************************************************
+** Function: LEN_OPT_Start
+**
+*/
+uint16 LEN_OPT_Start(LEN_OPT_Class_t *LenOpt, const RADIO_IF_Class_t *RadioIf, uint16 OverheadLen)
+{
+
+   const LORA_SetModulationParams_CmdPayload_t *Modulation = RADIO_IF_GetModulation(RadioIf);
+   uint16 Len;
+
+   OS_MutSemTake(LenOpt->MutexId);
+
+   PKT_LEN_Init(&LenOpt->PktLen, Modulation->SpreadingFactor, Modulation->Bandwidth,
+                Modulation->CodingRate, RADIO_IF_PreambleLen(RadioIf), OverheadLen,
+                LEN_OPT_MIN_LEN, LEN_OPT_MAX_LEN, LEN_OPT_STEP);
+
+   LenOpt->ReportTimeoutMs = (RADIO_IF_TimeOnAir(RadioIf, LORA_FRAME_MIN_HDR_LEN + LORA_FRAME_REPORT_LEN) + 999)/1000 +
+                             LenOpt->ReportGuardMs;
+   LenOpt->Active        = true;
+   LenOpt->ReportSentCnt = 0;
+   LenOpt->ReportRcvdCnt = 0;
+   LenOpt->TransferCnt++;
+   Len = PKT_LEN_Len(&LenOpt->PktLen);
+
+   OS_MutSemGive(LenOpt->MutexId);
+
+   return Len;
+
+} /* End LEN_OPT_Start() */
+
+
+/******************************************************************************
+** Function: LEN_OPT_RecordReport
+**
+** Notes:
+**   1. A report counting more segments than were sent comes from a
+**      receiver that didn't start with this transfer. It's counted and
+**      the next window is measured from it.
+**
+*/
+uint16 LEN_OPT_RecordReport(LEN_OPT_Class_t *LenOpt, uint32 SentCnt, uint16 RcvdCnt)
+{
+
+   uint32 WindowSentCnt;
+   uint16 WindowRcvdCnt;
+   uint16 PrevLen;
+   uint16 Len;
+
+   OS_MutSemTake(LenOpt->MutexId);
+
+   WindowSentCnt = SentCnt - LenOpt->ReportSentCnt;
+   WindowRcvdCnt = RcvdCnt - LenOpt->ReportRcvdCnt;
+   LenOpt->ReportSentCnt = SentCnt;
+   LenOpt->ReportRcvdCnt = RcvdCnt;
+
+   if (WindowRcvdCnt > WindowSentCnt)
+   {
+      LenOpt->ReportErrCnt++;
+      Len = PKT_LEN_Len(&LenOpt->PktLen);
+   }
+   else
+   {
+      PrevLen = PKT_LEN_Len(&LenOpt->PktLen);
+      Len = PKT_LEN_RecordWindow(&LenOpt->PktLen, WindowSentCnt, WindowRcvdCnt);
+      if (Len != PrevLen)
+      {
+         LenOpt->LenChangeCnt++;
+      }
+      LenOpt->WindowCnt++;
+      LenOpt->LastSentCnt = WindowSentCnt;
+      LenOpt->LastRcvdCnt = WindowRcvdCnt;
+   }
+
+   OS_MutSemGive(LenOpt->MutexId);
+
+   return Len;
+
+} /* End LEN_OPT_RecordReport() */
+
+
+/******************************************************************************
+** Function: LEN_OPT_RecordMissedReport
+**
+*/
+void LEN_OPT_RecordMissedReport(LEN_OPT_Class_t *LenOpt)
+{
+
+   OS_MutSemTake(LenOpt->MutexId);
+   LenOpt->ReportMissCnt++;
+   OS_MutSemGive(LenOpt->MutexId);
+
+} /* End LEN_OPT_RecordMissedReport() */
+
+
+/******************************************************************************
+** Function: LEN_OPT_RecordReportTx
+**
+*/
+void LEN_OPT_RecordReportTx(LEN_OPT_Class_t *LenOpt)
+{
+
+   OS_MutSemTake(LenOpt->MutexId);
+   LenOpt->ReportTxCnt++;
+   OS_MutSemGive(LenOpt->MutexId);
+
+} /* End LEN_OPT_RecordReportTx() */
+
+
+/******************************************************************************
+** Function: LEN_OPT_Stop
+**
+*/
+void LEN_OPT_Stop(LEN_OPT_Class_t *LenOpt)
+{
+
+   OS_MutSemTake(LenOpt->MutexId);
+   LenOpt->Active = false;
+   OS_MutSemGive(LenOpt->MutexId);
+
+} /* End LEN_OPT_Stop() */
+
+
+/******************************************************************************
+** Function: LEN_OPT_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+*/
+void LEN_OPT_ResetStatus(LEN_OPT_Class_t *LenOpt)
+{
+
+   OS_MutSemTake(LenOpt->MutexId);
+
+   LenOpt->TransferCnt   = 0;
+   LenOpt->WindowCnt     = 0;
+   LenOpt->ReportMissCnt = 0;
+   LenOpt->ReportErrCnt  = 0;
+   LenOpt->LenChangeCnt  = 0;
+   LenOpt->ReportTxCnt   = 0;
+
+   OS_MutSemGive(LenOpt->MutexId);
+
+} /* End LEN_OPT_ResetStatus() */
+
+
+/******************************************************************************
+** Function: LEN_OPT_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool LEN_OPT_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   LEN_OPT_Class_t *LenOpt = (LEN_OPT_Class_t *)ObjDataPtr;
+   LORA_LenOptTlm_Payload_t *LenOptTlmPayload = &LenOpt->LenOptTlm.Payload;
+
+   OS_MutSemTake(LenOpt->MutexId);
+
+   LenOptTlmPayload->Active          = LenOpt->Active;
+   LenOptTlmPayload->WindowLen       = LenOpt->WindowLen;
+   LenOptTlmPayload->PayloadLen      = PKT_LEN_Len(&LenOpt->PktLen);
+   LenOptTlmPayload->PredictedEffPpt = LenOpt->PktLen.PredictedPpt;
+   LenOptTlmPayload->AchievedEffPpt  = LenOpt->PktLen.AchievedPpt;
+   LenOptTlmPayload->ByteLossPpm     = PKT_LEN_ByteLossPpm(&LenOpt->PktLen);
+   LenOptTlmPayload->ReportTimeoutMs = LenOpt->ReportTimeoutMs;
+   LenOptTlmPayload->TransferCnt     = LenOpt->TransferCnt;
+   LenOptTlmPayload->WindowCnt       = LenOpt->WindowCnt;
+   LenOptTlmPayload->ReportMissCnt   = LenOpt->ReportMissCnt;
+   LenOptTlmPayload->ReportErrCnt    = LenOpt->ReportErrCnt;
+   LenOptTlmPayload->LenChangeCnt    = LenOpt->LenChangeCnt;
+   LenOptTlmPayload->LastSentCnt     = LenOpt->LastSentCnt;
+   LenOptTlmPayload->LastRcvdCnt     = LenOpt->LastRcvdCnt;
+   LenOptTlmPayload->ReportTxCnt     = LenOpt->ReportTxCnt;
+
+   OS_MutSemGive(LenOpt->MutexId);
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(LenOpt->LenOptTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(LenOpt->LenOptTlm.TelemetryHeader), true);
+
+   CFE_EVS_SendEvent(LEN_OPT_SEND_TLM_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                     "Sent radio %u length optimizer telemetry message", LenOptTlmPayload->Radio);
+   return true;
+
+} /* End LEN_OPT_SendTlmCmd() */
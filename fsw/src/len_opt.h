@@ -0,0 +1,234 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the file transfer payload length optimizer class
+**
+**  Notes:
+**    1. When LEN_OPT_WINDOW is set the demo file isn't sent in fixed
+**       LORA_DEMO_PACKET_SIZE packets. The transmitter picks the payload
+**       length for each window of LEN_OPT_WINDOW frames that maximizes the
+**       expected goodput for the measured loss, see pkt_len.h.
+**    2. The file start frame carries the file size in bytes as text and
+**       each FILE_SEG frame carries its file offset, so the receiver can
+**       place segments of any length after losses.
+**    3. A window's last frame sets LORA_FRAME_FLAG_REPORT_REQ. The receiver
+**       answers at once with an RX_REPORT frame holding the number of
+**       segments it has received in the transfer and the transmitter waits
+**       the report's time on air plus LEN_OPT_REPORT_GUARD_MS for it. The
+**       count is cumulative so a lost request or report only merges its
+**       window into the next one.
+**    4. The report exchange doesn't fit the hop slots so hopping transfers
+**       use fixed packets. Both ends of a link must use the same
+**       LEN_OPT_WINDOW.
+**    5. The transmitting node's Rx task must not be receiving on the radio
+**       during a transfer or it could take the reports.
+**    6. The Tx task, the Rx task and the main task share the object
+**       through its mutex.
+**
+*/
+
+#ifndef _len_opt_
+#define _len_opt_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "lora_frame.h"
+#include "pkt_len.h"
+#include "radio_if.h"
+#include "radio_inst.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define LEN_OPT_MIN_LEN   32
+#define LEN_OPT_STEP      16
+#define LEN_OPT_MAX_LEN   (LORA_FRAME_MAX_LEN - LORA_FRAME_MAX_HDR_LEN - LORA_FRAME_SEG_OFFSET_LEN)
+
+
+/*
+** Event Message IDs
+*/
+
+#define LEN_OPT_CONSTRUCTOR_EID   (LEN_OPT_BASE_EID + 0)
+#define LEN_OPT_SEND_TLM_CMD_EID  (LEN_OPT_BASE_EID + 1)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+
+/******************************************************************************
+** LEN_OPT_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Telemetry Packets
+   */
+
+   LORA_LenOptTlm_t  LenOptTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   osal_id_t  MutexId;
+   uint16     WindowLen;          /* 0 sends fixed packets */
+   uint32     ReportGuardMs;
+   uint32     ReportTimeoutMs;
+
+   bool       Active;
+   PKT_LEN_Class_t PktLen;
+   uint32     ReportSentCnt;      /* Transmitter's frames sent at the last report */
+   uint16     ReportRcvdCnt;      /* Receiver's segments received at the last report */
+
+   uint32     TransferCnt;
+   uint32     WindowCnt;          /* Reports used for the estimate */
+   uint32     ReportMissCnt;
+   uint32     ReportErrCnt;       /* Reports counting more frames than were sent */
+   uint32     LenChangeCnt;
+   uint32     LastSentCnt;
+   uint32     LastRcvdCnt;
+   uint32     ReportTxCnt;        /* Reports sent by this end as the receiver */
+
+} LEN_OPT_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: LEN_OPT_Constructor
+**
+** Initialize the length optimizer object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void LEN_OPT_Constructor(LEN_OPT_Class_t *LenOpt, INITBL_Class_t *IniTbl,
+                         const RADIO_INST_Cfg_t *Inst);
+
+
+/******************************************************************************
+** Function: LEN_OPT_Enabled
+**
+** Return whether the demo file is sent with optimized payload lengths
+**
+*/
+bool LEN_OPT_Enabled(const LEN_OPT_Class_t *LenOpt);
+
+
+/******************************************************************************
+** Function: LEN_OPT_WindowLen
+**
+*/
+uint16 LEN_OPT_WindowLen(const LEN_OPT_Class_t *LenOpt);
+
+
+/******************************************************************************
+** Function: LEN_OPT_ReportTimeoutMs
+**
+** Return how long the transmitter waits for a report after its request
+**
+** Notes:
+**   1. Set by LEN_OPT_Start() for the transfer's modulation.
+**
+*/
+uint32 LEN_OPT_ReportTimeoutMs(const LEN_OPT_Class_t *LenOpt);
+
+
+/******************************************************************************
+** Function: LEN_OPT_Start
+**
+** Start a transfer and return its first payload length
+**
+** Notes:
+**   1. Called by the Tx task. OverheadLen is a segment frame's bytes
+**      besides the file data.
+**
+*/
+uint16 LEN_OPT_Start(LEN_OPT_Class_t *LenOpt, const RADIO_IF_Class_t *RadioIf, uint16 OverheadLen);
+
+
+/******************************************************************************
+** Function: LEN_OPT_RecordReport
+**
+** Record a receiver report and return the payload length for the next window
+**
+** Notes:
+**   1. SentCnt is the number of segment frames sent in the transfer up to
+**      and including the request, RcvdCnt is the report's count.
+**
+*/
+uint16 LEN_OPT_RecordReport(LEN_OPT_Class_t *LenOpt, uint32 SentCnt, uint16 RcvdCnt);
+
+
+/******************************************************************************
+** Function: LEN_OPT_RecordMissedReport
+**
+*/
+void LEN_OPT_RecordMissedReport(LEN_OPT_Class_t *LenOpt);
+
+
+/******************************************************************************
+** Function: LEN_OPT_RecordReportTx
+**
+** Count a report sent by the receiver
+**
+*/
+void LEN_OPT_RecordReportTx(LEN_OPT_Class_t *LenOpt);
+
+
+/******************************************************************************
+** Function: LEN_OPT_Stop
+**
+** End the transfer, the last length and efficiencies stay in telemetry
+**
+*/
+void LEN_OPT_Stop(LEN_OPT_Class_t *LenOpt);
+
+
+/******************************************************************************
+** Function: LEN_OPT_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+*/
+void LEN_OPT_ResetStatus(LEN_OPT_Class_t *LenOpt);
+
+
+/******************************************************************************
+** Function: LEN_OPT_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool LEN_OPT_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _len_opt_ */
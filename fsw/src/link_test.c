@@ -0,0 +1,674 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the link test class
+**
+**  Notes:
+**    1. The PRBS is a PRBS-15 (x^15 + x^14 + 1) sequence that is computed
+**       once into a table. Each frame's data starts at an offset derived
+**       from its frame index so every frame can be checked on its own and
+**       a lost frame doesn't affect the check of the next one.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radio_if.h"
+#include "rx_duty.h"
+#include "link_test.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/* Convenience macros */
+#define  INITBL_OBJ   (LinkTest->IniTbl)
+
+#define  RESULT_FILE_LINE_LEN  256
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void   BuildPrbsTbl(LINK_TEST_Class_t *LinkTest);
+static uint16 CountBitErrs(const uint8 *Data, const uint8 *Expected, uint16 DataLen);
+static void   LoadTlm(LINK_TEST_Class_t *LinkTest);
+static void   ParseSweep(LINK_TEST_Class_t *LinkTest, const char *SweepStr);
+static void   WriteResultFile(LINK_TEST_Class_t *LinkTest);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static const uint8 NibbleBitCnt[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+
+/******************************************************************************
+** Function: LINK_TEST_Constructor
+**
+** Initialize the Link Test object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**   2. Invalid sweep steps are reported and skipped.
+**
+*/
+void LINK_TEST_Constructor(LINK_TEST_Class_t *LinkTest, INITBL_Class_t *IniTbl,
+                           const RADIO_INST_Cfg_t *Inst, RADIO_TASK_Class_t *RadioTask,
+                           RADIO_IF_Class_t *RadioIf, RX_DUTY_Class_t *RxDuty)
+{
+
+   memset(LinkTest, 0, sizeof(LINK_TEST_Class_t));
+
+   LinkTest->IniTbl    = IniTbl;
+   LinkTest->RadioTask = RadioTask;
+   LinkTest->RadioIf   = RadioIf;
+   LinkTest->RxDuty    = RxDuty;
+   LinkTest->Radio     = Inst->Index;
+
+   LinkTest->StepGapMs = INITBL_GetIntConfig(INITBL_OBJ, CFG_LINK_TEST_STEP_GAP_MS);
+   RADIO_INST_Path(LinkTest->ResultFile, sizeof(LinkTest->ResultFile),
+                   INITBL_GetStrConfig(INITBL_OBJ, CFG_LINK_TEST_FILE), Inst);
+
+   ParseSweep(LinkTest, INITBL_GetStrConfig(INITBL_OBJ, CFG_LINK_TEST_SWEEP));
+   BuildPrbsTbl(LinkTest);
+
+   CFE_MSG_Init(CFE_MSG_PTR(LinkTest->LinkTestTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_LORA_LINK_TEST_TLM_TOPICID)), sizeof(LORA_LinkTestTlm_t));
+
+} /* End LINK_TEST_Constructor() */
+
+
+/******************************************************************************
+** Function: LINK_TEST_Start
+**
+** Load the test configuration and clear the results.
+**
+** Notes:
+**   1. Called by the lora_tx and lora_rx start link test commands.
+**   2. Returns false if a test is active or the command parameters are
+**      invalid.
+**
+*/
+bool LINK_TEST_Start(LINK_TEST_Class_t *LinkTest, LORA_LinkTestRole_Enum_t Role, const LORA_StartLinkTest_CmdPayload_t *Cmd)
+{
+
+   const LORA_SetModulationParams_CmdPayload_t *Modulation;
+   uint16 StepIdx;
+
+   if (LinkTest->Active)
+   {
+      CFE_EVS_SendEvent(LINK_TEST_START_EID, CFE_EVS_EventType_ERROR,
+                        "Start link test rejected, a link test is already active");
+      return false;
+   }
+
+   if (Cmd->FramesPerStep == 0 || Cmd->DataLen == 0 || Cmd->DataLen > LINK_TEST_MAX_DATA_LEN)
+   {
+      CFE_EVS_SendEvent(LINK_TEST_START_EID, CFE_EVS_EventType_ERROR,
+                        "Start link test rejected, invalid frames per step %d or data length %d. Data length must be between 1 and %d",
+                        Cmd->FramesPerStep, Cmd->DataLen, LINK_TEST_MAX_DATA_LEN);
+      return false;
+   }
+
+   if (Cmd->Sweep && LinkTest->SweepStepCnt == 0)
+   {
+      CFE_EVS_SendEvent(LINK_TEST_START_EID, CFE_EVS_EventType_ERROR,
+                        "Start link test rejected, no valid sweep steps are defined");
+      return false;
+   }
+
+   memset(LinkTest->Step, 0, sizeof(LinkTest->Step));
+
+   if (Cmd->Sweep)
+   {
+      LinkTest->StepCnt = LinkTest->SweepStepCnt;
+      for (StepIdx=0; StepIdx < LinkTest->StepCnt; StepIdx++)
+      {
+         LinkTest->Step[StepIdx].SpreadingFactor = LinkTest->SweepStep[StepIdx].SpreadingFactor;
+         LinkTest->Step[StepIdx].Bandwidth       = LinkTest->SweepStep[StepIdx].Bandwidth;
+         LinkTest->Step[StepIdx].CodingRate      = LinkTest->SweepStep[StepIdx].CodingRate;
+      }
+   }
+   else
+   {
+      Modulation = RADIO_IF_GetModulation(LinkTest->RadioIf);
+      LinkTest->StepCnt = 1;
+      LinkTest->Step[0].SpreadingFactor = Modulation->SpreadingFactor;
+      LinkTest->Step[0].Bandwidth       = Modulation->Bandwidth;
+      LinkTest->Step[0].CodingRate      = Modulation->CodingRate;
+   }
+
+   for (StepIdx=0; StepIdx < LinkTest->StepCnt; StepIdx++)
+   {
+      LinkTest->Step[StepIdx].TimeOnAirUsec = LORA_TOA_TimeOnAir(LinkTest->Step[StepIdx].SpreadingFactor,
+                                                                 LinkTest->Step[StepIdx].Bandwidth,
+                                                                 LinkTest->Step[StepIdx].CodingRate,
+                                                                 RX_DUTY_PreambleLen(LinkTest->RxDuty, LinkTest->Step[StepIdx].SpreadingFactor,
+                                                                                     LinkTest->Step[StepIdx].Bandwidth),
+                                                                 LORA_FRAME_MAX_HDR_LEN + Cmd->DataLen);
+   }
+
+   LinkTest->Role          = Role;
+   LinkTest->FramesPerStep = Cmd->FramesPerStep;
+   LinkTest->DataLen       = Cmd->DataLen;
+   LinkTest->CurStep       = 0;
+   LinkTest->Active        = true;
+
+   CFE_EVS_SendEvent(LINK_TEST_START_EID, CFE_EVS_EventType_INFORMATION,
+                     "Radio %u link test started: %s, %d steps, %d frames per step, %d data bytes per frame",
+                     LinkTest->Radio, (Role == LORA_LinkTestRole_TX ? "transmit" : "receive"),
+                     LinkTest->StepCnt, LinkTest->FramesPerStep, LinkTest->DataLen);
+
+   return true;
+
+} /* End LINK_TEST_Start() */
+
+
+/******************************************************************************
+** Function: LINK_TEST_Cancel
+**
+*/
+void LINK_TEST_Cancel(LINK_TEST_Class_t *LinkTest)
+{
+
+   LinkTest->Active = false;
+
+} /* End LINK_TEST_Cancel() */
+
+
+/******************************************************************************
+** Function: LINK_TEST_Stop
+**
+** End the test, restore the radio's configured modulation and report the
+** results.
+**
+*/
+void LINK_TEST_Stop(LINK_TEST_Class_t *LinkTest, RADIO_TASK_Client_t Client)
+{
+
+   const LORA_SetModulationParams_CmdPayload_t *Modulation = RADIO_IF_GetModulation(LinkTest->RadioIf);
+
+   if (RADIO_TASK_SetModulationParams(LinkTest->RadioTask, Client, Modulation->SpreadingFactor,
+                                      Modulation->Bandwidth, Modulation->CodingRate))
+   {
+      RX_DUTY_ConfigRadio(LinkTest->RxDuty, Client, Modulation);
+   }
+
+   WriteResultFile(LinkTest);
+   LinkTest->Active = false;
+   LINK_TEST_SendTlmCmd(LinkTest, NULL);
+
+   CFE_EVS_SendEvent(LINK_TEST_STOP_EID, CFE_EVS_EventType_INFORMATION,
+                     "Radio %u link test ended, results written to %s", LinkTest->Radio, LinkTest->ResultFile);
+
+} /* End LINK_TEST_Stop() */
+
+
+/******************************************************************************
+** Functions: Test configuration
+**
+*/
+uint16 LINK_TEST_StepCnt(const LINK_TEST_Class_t *LinkTest)
+{
+   return LinkTest->StepCnt;
+}
+
+uint16 LINK_TEST_FramesPerStep(const LINK_TEST_Class_t *LinkTest)
+{
+   return LinkTest->FramesPerStep;
+}
+
+uint16 LINK_TEST_DataLen(const LINK_TEST_Class_t *LinkTest)
+{
+   return LinkTest->DataLen;
+}
+
+uint32 LINK_TEST_StepGapMs(const LINK_TEST_Class_t *LinkTest)
+{
+   return LinkTest->StepGapMs;
+}
+
+
+/******************************************************************************
+** Function: LINK_TEST_BeginStep
+**
+** Program the radio with the step's modulation and make it the current step
+**
+*/
+bool LINK_TEST_BeginStep(LINK_TEST_Class_t *LinkTest, RADIO_TASK_Client_t Client, uint16 StepIdx)
+{
+
+   bool RetStatus;
+   LINK_TEST_Step_t *Step = &LinkTest->Step[StepIdx];
+   LORA_SetModulationParams_CmdPayload_t Modulation;
+
+   LinkTest->CurStep = StepIdx;
+
+   Modulation.SpreadingFactor = Step->SpreadingFactor;
+   Modulation.Bandwidth       = Step->Bandwidth;
+   Modulation.CodingRate      = Step->CodingRate;
+
+   RetStatus = RADIO_TASK_SetModulationParams(LinkTest->RadioTask, Client, Step->SpreadingFactor, Step->Bandwidth, Step->CodingRate);
+   if (RetStatus)
+   {
+      RetStatus = RX_DUTY_ConfigRadio(LinkTest->RxDuty, Client, &Modulation);
+   }
+
+   if (RetStatus)
+   {
+      CFE_EVS_SendEvent(LINK_TEST_STEP_EID, CFE_EVS_EventType_INFORMATION,
+                        "Link test step %d: SF=%d, BW=%d, CR=%d, time-on-air %d usec",
+                        StepIdx, Step->SpreadingFactor, Step->Bandwidth, Step->CodingRate,
+                        Step->TimeOnAirUsec);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(LINK_TEST_STEP_EID, CFE_EVS_EventType_ERROR,
+                        "Link test step %d: Error setting modulation SF=%d, BW=%d, CR=%d",
+                        StepIdx, Step->SpreadingFactor, Step->Bandwidth, Step->CodingRate);
+   }
+
+   return RetStatus;
+
+} /* End LINK_TEST_BeginStep() */
+
+
+/******************************************************************************
+** Function: LINK_TEST_SlotMs
+**
+*/
+uint32 LINK_TEST_SlotMs(const LINK_TEST_Class_t *LinkTest)
+{
+
+   return (LinkTest->Step[LinkTest->CurStep].TimeOnAirUsec + 999) / 1000 + LINK_TEST_SLOT_MARGIN_MS;
+
+} /* End LINK_TEST_SlotMs() */
+
+
+/******************************************************************************
+** Function: LINK_TEST_FillData
+**
+*/
+void LINK_TEST_FillData(const LINK_TEST_Class_t *LinkTest, uint32 FrameIdx, uint8 *Data)
+{
+
+   uint32 Offset = (FrameIdx * LinkTest->DataLen) & (LINK_TEST_PRBS_TBL_LEN - 1);
+
+   memcpy(Data, &LinkTest->PrbsTbl[Offset], LinkTest->DataLen);
+
+} /* End LINK_TEST_FillData() */
+
+
+/******************************************************************************
+** Function: LINK_TEST_RecordTx
+**
+*/
+void LINK_TEST_RecordTx(LINK_TEST_Class_t *LinkTest, bool Sent)
+{
+
+   LINK_TEST_Step_t *Step = &LinkTest->Step[LinkTest->CurStep];
+
+   if (Sent)
+   {
+      OS_GetLocalTime(&Step->LastFrameTime);
+      if (Step->FrameCnt == 0)
+      {
+         Step->FirstFrameTime = Step->LastFrameTime;
+      }
+      Step->FrameCnt++;
+   }
+   else
+   {
+      Step->LostCnt++;
+   }
+
+} /* End LINK_TEST_RecordTx() */
+
+
+/******************************************************************************
+** Function: LINK_TEST_RecordRx
+**
+** Notes:
+**   1. A frame with the wrong data length counts every expected bit as an
+**      error.
+*/
+void LINK_TEST_RecordRx(LINK_TEST_Class_t *LinkTest, uint32 FrameIdx, const uint8 *Data, uint16 DataLen, int8 Rssi, int8 Snr)
+{
+
+   LINK_TEST_Step_t *Step = &LinkTest->Step[LinkTest->CurStep];
+   uint32 Offset = (FrameIdx * LinkTest->DataLen) & (LINK_TEST_PRBS_TBL_LEN - 1);
+
+   OS_GetLocalTime(&Step->LastFrameTime);
+   if (Step->FrameCnt == 0)
+   {
+      Step->FirstFrameTime = Step->LastFrameTime;
+      Step->SnrMin = Snr;
+      Step->SnrMax = Snr;
+   }
+   Step->FrameCnt++;
+
+   if (DataLen == LinkTest->DataLen)
+   {
+      Step->BitErrCnt += CountBitErrs(Data, &LinkTest->PrbsTbl[Offset], DataLen);
+   }
+   else
+   {
+      Step->BitErrCnt += LinkTest->DataLen * 8;
+   }
+
+   Step->SnrSum  += Snr;
+   Step->RssiSum += Rssi;
+   if (Snr < Step->SnrMin) Step->SnrMin = Snr;
+   if (Snr > Step->SnrMax) Step->SnrMax = Snr;
+
+} /* End LINK_TEST_RecordRx() */
+
+
+/******************************************************************************
+** Function: LINK_TEST_EndStep
+**
+** Notes:
+**   1. The receiver's lost count is the number of the step's frames that
+**      weren't received.
+**   2. Throughput is measured from the start of the first frame to the end
+**      of the last frame so it includes the per-frame overhead.
+*/
+void LINK_TEST_EndStep(LINK_TEST_Class_t *LinkTest)
+{
+
+   LINK_TEST_Step_t *Step = &LinkTest->Step[LinkTest->CurStep];
+   uint32 ElapsedMs;
+   uint32 FrameTotal;
+
+   if (LinkTest->Role == LORA_LinkTestRole_RX)
+   {
+      Step->LostCnt = (Step->FrameCnt < LinkTest->FramesPerStep) ? (LinkTest->FramesPerStep - Step->FrameCnt) : 0;
+   }
+
+   FrameTotal   = Step->FrameCnt + Step->LostCnt;
+   Step->PerPpt = FrameTotal ? (uint16)((Step->LostCnt * 1000ULL) / FrameTotal) : 0;
+
+   Step->ThroughputBps = 0;
+   if (Step->FrameCnt > 0)
+   {
+      ElapsedMs = OS_TimeGetTotalMilliseconds(OS_TimeSubtract(Step->LastFrameTime, Step->FirstFrameTime)) +
+                  (Step->TimeOnAirUsec + 999) / 1000;
+      if (ElapsedMs > 0)
+      {
+         Step->ThroughputBps = (uint32)(((uint64)Step->FrameCnt * LinkTest->DataLen * 8 * 1000) / ElapsedMs);
+      }
+   }
+
+   CFE_EVS_SendEvent(LINK_TEST_STEP_EID, CFE_EVS_EventType_INFORMATION,
+                     "Link test step %d result: %d frames, %d lost, PER %d.%d%%, %d bit errors, %d bps, SNR avg %d min %d",
+                     LinkTest->CurStep, Step->FrameCnt, Step->LostCnt, Step->PerPpt/10, Step->PerPpt%10,
+                     Step->BitErrCnt, Step->ThroughputBps,
+                     (Step->FrameCnt ? Step->SnrSum/(int32)Step->FrameCnt : 0), Step->SnrMin);
+
+   LINK_TEST_SendTlmCmd(LinkTest, NULL);
+
+} /* End LINK_TEST_EndStep() */
+
+
+/******************************************************************************
+** Function: LINK_TEST_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**   2. Also called by the test loops after each step.
+*/
+bool LINK_TEST_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   LINK_TEST_Class_t *LinkTest = (LINK_TEST_Class_t *)ObjDataPtr;
+
+   LoadTlm(LinkTest);
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(LinkTest->LinkTestTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(LinkTest->LinkTestTlm.TelemetryHeader), true);
+
+   if (MsgPtr != NULL)
+   {
+      CFE_EVS_SendEvent(LINK_TEST_SEND_TLM_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                        "Sent radio %u link test telemetry message", LinkTest->Radio);
+   }
+
+   return true;
+
+} /* End LINK_TEST_SendTlmCmd() */
+
+
+/******************************************************************************
+** Function: BuildPrbsTbl
+**
+** Notes:
+**   1. The table is longer than LINK_TEST_PRBS_TBL_LEN so a frame's data
+**      never wraps.
+*/
+static void BuildPrbsTbl(LINK_TEST_Class_t *LinkTest)
+{
+
+   uint16 Lfsr = 0x7FFF;
+   uint16 Bit;
+   uint16 i;
+   uint16 j;
+   uint8  Byte;
+
+   for (i=0; i < sizeof(LinkTest->PrbsTbl); i++)
+   {
+      Byte = 0;
+      for (j=0; j < 8; j++)
+      {
+         Bit  = ((Lfsr >> 14) ^ (Lfsr >> 13)) & 1;
+         Lfsr = ((Lfsr << 1) | Bit) & 0x7FFF;
+         Byte = (Byte << 1) | Bit;
+      }
+      LinkTest->PrbsTbl[i] = Byte;
+   }
+
+} /* End BuildPrbsTbl() */
+
+
+/******************************************************************************
+** Function: CountBitErrs
+**
+*/
+static uint16 CountBitErrs(const uint8 *Data, const uint8 *Expected, uint16 DataLen)
+{
+
+   uint16 BitErrCnt = 0;
+   uint8  Diff;
+   uint16 i;
+
+   for (i=0; i < DataLen; i++)
+   {
+      Diff = Data[i] ^ Expected[i];
+      BitErrCnt += NibbleBitCnt[Diff & 0x0F] + NibbleBitCnt[Diff >> 4];
+   }
+
+   return BitErrCnt;
+
+} /* End CountBitErrs() */
+
+
+/******************************************************************************
+** Function: LoadTlm
+**
+*/
+static void LoadTlm(LINK_TEST_Class_t *LinkTest)
+{
+
+   LORA_LinkTestTlm_Payload_t *LinkTestTlmPayload = &LinkTest->LinkTestTlm.Payload;
+   LORA_LinkTestStep_t *StepTlm;
+   const LINK_TEST_Step_t *Step;
+   uint16 StepIdx;
+
+   memset(LinkTestTlmPayload, 0, sizeof(LORA_LinkTestTlm_Payload_t));
+
+   LinkTestTlmPayload->Radio         = LinkTest->Radio;
+   LinkTestTlmPayload->Active        = LinkTest->Active;
+   LinkTestTlmPayload->Role          = LinkTest->Role;
+   LinkTestTlmPayload->StepCnt       = LinkTest->StepCnt;
+   LinkTestTlmPayload->CurStep       = LinkTest->CurStep;
+   LinkTestTlmPayload->FramesPerStep = LinkTest->FramesPerStep;
+   LinkTestTlmPayload->DataLen       = LinkTest->DataLen;
+
+   for (StepIdx=0; StepIdx < LinkTest->StepCnt; StepIdx++)
+   {
+
+      Step    = &LinkTest->Step[StepIdx];
+      StepTlm = &LinkTestTlmPayload->Step[StepIdx];
+
+      StepTlm->SpreadingFactor = Step->SpreadingFactor;
+      StepTlm->Bandwidth       = Step->Bandwidth;
+      StepTlm->CodingRate      = Step->CodingRate;
+      StepTlm->FrameCnt        = Step->FrameCnt;
+      StepTlm->LostCnt         = Step->LostCnt;
+      StepTlm->BitErrCnt       = Step->BitErrCnt;
+      StepTlm->PerPpt          = Step->PerPpt;
+      StepTlm->ThroughputBps   = Step->ThroughputBps;
+      if (Step->FrameCnt > 0)
+      {
+         StepTlm->SnrAvg  = Step->SnrSum / (int32)Step->FrameCnt;
+         StepTlm->SnrMin  = Step->SnrMin;
+         StepTlm->SnrMax  = Step->SnrMax;
+         StepTlm->RssiAvg = Step->RssiSum / (int32)Step->FrameCnt;
+      }
+
+   } /* End step loop */
+
+} /* End LoadTlm() */
+
+
+/******************************************************************************
+** Function: ParseSweep
+**
+** Notes:
+**   1. SweepStr is a comma separated list of SF/BW/CR triplets, for example
+**      "112/10/4,144/10/4".
+**   2. A step is valid if the time-on-air model accepts its parameters.
+*/
+static void ParseSweep(LINK_TEST_Class_t *LinkTest, const char *SweepStr)
+{
+
+   const char *Next = SweepStr;
+   char  *End;
+   uint32 Param[3];
+   uint16 i;
+
+   while (*Next != '\0' && LinkTest->SweepStepCnt < LINK_TEST_MAX_STEPS)
+   {
+
+      for (i=0; i < 3; i++)
+      {
+         Param[i] = strtoul(Next, &End, 0);
+         if (End == Next || (i < 2 && *End != '/'))
+         {
+            break;
+         }
+         Next = (i < 2) ? End + 1 : End;
+      }
+
+      if (i == 3 && Param[0] <= 0xFF && Param[1] <= 0xFF && Param[2] <= 0xFF &&
+          LORA_TOA_TimeOnAir(Param[0], Param[1], Param[2], LORA_DEFAULT_PREAMBLE_LEN, LORA_FRAME_MAX_LEN) != 0)
+      {
+         LinkTest->SweepStep[LinkTest->SweepStepCnt].SpreadingFactor = Param[0];
+         LinkTest->SweepStep[LinkTest->SweepStepCnt].Bandwidth       = Param[1];
+         LinkTest->SweepStep[LinkTest->SweepStepCnt].CodingRate      = Param[2];
+         LinkTest->SweepStepCnt++;
+      }
+      else
+      {
+         CFE_EVS_SendEvent(LINK_TEST_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                           "Skipped invalid link test sweep step %d in \"%s\"",
+                           LinkTest->SweepStepCnt, SweepStr);
+      }
+
+      /* Skip to the next step */
+      while (*Next != '\0' && *Next != ',')
+      {
+         Next++;
+      }
+      if (*Next == ',')
+      {
+         Next++;
+      }
+
+   } /* End step loop */
+
+} /* End ParseSweep() */
+
+
+/******************************************************************************
+** Function: WriteResultFile
+**
+** Notes:
+**   1. One row per step. BER is the bit error ratio of the frames that were
+**      received.
+*/
+static void WriteResultFile(LINK_TEST_Class_t *LinkTest)
+{
+
+   int32     SysStatus;
+   osal_id_t FileHandle;
+   char      Line[RESULT_FILE_LINE_LEN];
+   size_t    LineLen;
+   uint16    StepIdx;
+   uint32    BitCnt;
+   const LINK_TEST_Step_t *Step;
+
+   SysStatus = OS_OpenCreate(&FileHandle, LinkTest->ResultFile, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_WRITE_ONLY);
+
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(LINK_TEST_STOP_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating link test result file %s, Status = %d",
+                        LinkTest->ResultFile, SysStatus);
+      return;
+   }
+
+   LineLen = snprintf(Line, sizeof(Line), "Step,SpreadingFactor,Bandwidth,CodingRate,TimeOnAirUsec,"
+                      "FrameCnt,LostCnt,PerPct,BitErrCnt,Ber,ThroughputBps,SnrAvg,SnrMin,SnrMax,RssiAvg\n");
+   OS_write(FileHandle, Line, LineLen);
+
+   for (StepIdx=0; StepIdx < LinkTest->StepCnt; StepIdx++)
+   {
+
+      Step   = &LinkTest->Step[StepIdx];
+      BitCnt = Step->FrameCnt * LinkTest->DataLen * 8;
+
+      LineLen = snprintf(Line, sizeof(Line), "%u,%u,%u,%u,%lu,%lu,%lu,%.1f,%lu,%.3e,%lu,%ld,%d,%d,%ld\n",
+                         StepIdx, Step->SpreadingFactor, Step->Bandwidth, Step->CodingRate,
+                         (unsigned long)Step->TimeOnAirUsec, (unsigned long)Step->FrameCnt,
+                         (unsigned long)Step->LostCnt, Step->PerPpt / 10.0, (unsigned long)Step->BitErrCnt,
+                         (BitCnt ? (double)Step->BitErrCnt / BitCnt : 0.0), (unsigned long)Step->ThroughputBps,
+                         (long)(Step->FrameCnt ? Step->SnrSum / (int32)Step->FrameCnt : 0),
+                         Step->SnrMin, Step->SnrMax,
+                         (long)(Step->FrameCnt ? Step->RssiSum / (int32)Step->FrameCnt : 0));
+      OS_write(FileHandle, Line, LineLen);
+
+   } /* End step loop */
+
+   OS_close(FileHandle);
+
+} /* End WriteResultFile() */
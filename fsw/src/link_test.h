@@ -0,0 +1,291 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the link test class
+**
+**  Notes:
+**    1. A link test sends FramesPerStep PRBS filled frames for each step of
+**       a modulation sweep. The lora_tx and lora_rx objects run the test
+**       loops and this object owns the test configuration, the PRBS pattern
+**       and the per-step results.
+**    2. The frame sequence number is the frame's index in the whole test so
+**       the receiver knows which step and PRBS offset a frame belongs to
+**       without any extra header fields.
+**    3. The sweep steps are defined by the LINK_TEST_SWEEP JSON init file
+**       string: comma separated SF/BW/CR triplets using the SX128x register
+**       encodings. Both ends of a link must use the same sweep. A test
+**       without a sweep has one step using the current radio configuration.
+**    4. The receiver waits indefinitely for the first step so it must be
+**       started before the transmitter and the first step should be the
+**       most robust setting.
+**    5. The radio drops frames with CRC errors so the bit error count only
+**       covers frames that passed the CRC. It detects corruption that the
+**       CRC misses and errors in the frame handling software.
+**
+*/
+
+#ifndef _link_test_
+#define _link_test_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "lora_frame.h"
+#include "radio_inst.h"
+#include "radio_task.h"
+#include "radio_if.h"
+#include "rx_duty.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define LINK_TEST_MAX_STEPS       16     /* Must match lora.xml LinkTestStepTbl */
+#define LINK_TEST_MAX_DATA_LEN    (LORA_FRAME_MAX_LEN - LORA_FRAME_MAX_HDR_LEN)
+#define LINK_TEST_PRBS_TBL_LEN    4096   /* Must be a power of 2 */
+#define LINK_TEST_SLOT_MARGIN_MS  2      /* Transmitter per-frame processing allowance */
+
+
+/*
+** Event Message IDs
+*/
+
+#define LINK_TEST_CONSTRUCTOR_EID   (LINK_TEST_BASE_EID + 0)
+#define LINK_TEST_START_EID         (LINK_TEST_BASE_EID + 1)
+#define LINK_TEST_STEP_EID          (LINK_TEST_BASE_EID + 2)
+#define LINK_TEST_STOP_EID          (LINK_TEST_BASE_EID + 3)
+#define LINK_TEST_SEND_TLM_CMD_EID  (LINK_TEST_BASE_EID + 4)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+typedef struct
+{
+
+   uint8   SpreadingFactor;
+   uint8   Bandwidth;
+   uint8   CodingRate;
+   uint32  TimeOnAirUsec;   /* Full link test frame */
+
+   uint32  FrameCnt;        /* Frames sent or received */
+   uint32  LostCnt;         /* Send errors or frames not received */
+   uint32  BitErrCnt;
+   int32   SnrSum;
+   int32   RssiSum;
+   int8    SnrMin;
+   int8    SnrMax;
+
+   OS_time_t FirstFrameTime;
+   OS_time_t LastFrameTime;
+
+   uint16  PerPpt;          /* Packet error rate parts per thousand */
+   uint32  ThroughputBps;   /* Payload bits per second */
+
+} LINK_TEST_Step_t;
+
+
+/******************************************************************************
+** LINK_TEST_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Framework References
+   */
+
+   INITBL_Class_t *IniTbl;
+
+   /*
+   ** Object References
+   */
+
+   RADIO_TASK_Class_t *RadioTask;
+   RADIO_IF_Class_t   *RadioIf;
+   RX_DUTY_Class_t    *RxDuty;
+
+   /*
+   ** Telemetry Packets
+   */
+
+   LORA_LinkTestTlm_t  LinkTestTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   uint8   Radio;
+   uint16  SweepStepCnt;
+   LORA_SetModulationParams_CmdPayload_t SweepStep[LINK_TEST_MAX_STEPS];
+   uint32  StepGapMs;
+
+   bool    Active;
+   LORA_LinkTestRole_Enum_t Role;
+   uint16  FramesPerStep;
+   uint16  DataLen;
+   uint16  StepCnt;
+   uint16  CurStep;
+   LINK_TEST_Step_t Step[LINK_TEST_MAX_STEPS];
+
+   char    ResultFile[OS_MAX_PATH_LEN];
+
+   uint8   PrbsTbl[LINK_TEST_PRBS_TBL_LEN + LINK_TEST_MAX_DATA_LEN];
+
+} LINK_TEST_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: LINK_TEST_Constructor
+**
+** Initialize the Link Test object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**   2. Invalid sweep steps are reported and skipped.
+**
+*/
+void LINK_TEST_Constructor(LINK_TEST_Class_t *LinkTest, INITBL_Class_t *IniTbl,
+                           const RADIO_INST_Cfg_t *Inst, RADIO_TASK_Class_t *RadioTask,
+                           RADIO_IF_Class_t *RadioIf, RX_DUTY_Class_t *RxDuty);
+
+
+/******************************************************************************
+** Function: LINK_TEST_Start
+**
+** Load the test configuration and clear the results.
+**
+** Notes:
+**   1. Called by the lora_tx and lora_rx start link test commands.
+**   2. Returns false if a test is active or the command parameters are
+**      invalid.
+**
+*/
+bool LINK_TEST_Start(LINK_TEST_Class_t *LinkTest, LORA_LinkTestRole_Enum_t Role, const LORA_StartLinkTest_CmdPayload_t *Cmd);
+
+
+/******************************************************************************
+** Function: LINK_TEST_Cancel
+**
+** End a test that was started but never run
+**
+*/
+void LINK_TEST_Cancel(LINK_TEST_Class_t *LinkTest);
+
+
+/******************************************************************************
+** Function: LINK_TEST_Stop
+**
+** End the test, restore the radio's configured modulation and report the
+** results.
+**
+** Notes:
+**   1. The results are written to the LINK_TEST_FILE CSV file and sent in
+**      link test telemetry.
+**
+*/
+void LINK_TEST_Stop(LINK_TEST_Class_t *LinkTest, RADIO_TASK_Client_t Client);
+
+
+/******************************************************************************
+** Functions: Test configuration
+**
+*/
+uint16 LINK_TEST_StepCnt(const LINK_TEST_Class_t *LinkTest);
+uint16 LINK_TEST_FramesPerStep(const LINK_TEST_Class_t *LinkTest);
+uint16 LINK_TEST_DataLen(const LINK_TEST_Class_t *LinkTest);
+uint32 LINK_TEST_StepGapMs(const LINK_TEST_Class_t *LinkTest);
+
+
+/******************************************************************************
+** Function: LINK_TEST_BeginStep
+**
+** Program the radio with the step's modulation and make it the current step
+**
+*/
+bool LINK_TEST_BeginStep(LINK_TEST_Class_t *LinkTest, RADIO_TASK_Client_t Client, uint16 StepIdx);
+
+
+/******************************************************************************
+** Function: LINK_TEST_SlotMs
+**
+** Return the time between frames of the current step in milliseconds
+**
+*/
+uint32 LINK_TEST_SlotMs(const LINK_TEST_Class_t *LinkTest);
+
+
+/******************************************************************************
+** Function: LINK_TEST_FillData
+**
+** Copy the PRBS data for the frame with index FrameIdx into Data
+**
+** Notes:
+**   1. Data must have room for LINK_TEST_DataLen() bytes.
+**
+*/
+void LINK_TEST_FillData(const LINK_TEST_Class_t *LinkTest, uint32 FrameIdx, uint8 *Data);
+
+
+/******************************************************************************
+** Function: LINK_TEST_RecordTx
+**
+** Record the outcome of sending a frame in the current step
+**
+*/
+void LINK_TEST_RecordTx(LINK_TEST_Class_t *LinkTest, bool Sent);
+
+
+/******************************************************************************
+** Function: LINK_TEST_RecordRx
+**
+** Check a received frame's data against the PRBS and record it in the
+** current step
+**
+*/
+void LINK_TEST_RecordRx(LINK_TEST_Class_t *LinkTest, uint32 FrameIdx, const uint8 *Data, uint16 DataLen, int8 Rssi, int8 Snr);
+
+
+/******************************************************************************
+** Function: LINK_TEST_EndStep
+**
+** Compute the current step's PER and throughput and report them
+**
+*/
+void LINK_TEST_EndStep(LINK_TEST_Class_t *LinkTest);
+
+
+/******************************************************************************
+** Function: LINK_TEST_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool LINK_TEST_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _link_test_ */
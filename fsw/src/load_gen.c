@@ -0,0 +1,602 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the software bus load generator class
+**
+**  Notes:
+**    1. The Tx queue uses the same single producer, single consumer ring as
+**       the radio task's request queues, see radio_task.c.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "load_gen.h"
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static const char *SizeDistStr[] =
+{
+   "fixed",
+   "uniform",
+   "bimodal"
+};
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void   Drain(LOAD_GEN_Class_t *LoadGen);
+static uint32 DelayUsec(const CFE_TIME_SysTime_t *SendTime);
+static uint32 ElapsedMs(LOAD_GEN_Class_t *LoadGen);
+static void   Generate(LOAD_GEN_Class_t *LoadGen);
+static uint16 MsgDataLen(LOAD_GEN_Class_t *LoadGen);
+static uint32 Rand(LOAD_GEN_Class_t *LoadGen);
+static void   SendMsg(LOAD_GEN_Class_t *LoadGen);
+
+
+/******************************************************************************
+** Function: LOAD_GEN_Constructor
+**
+*/
+void LOAD_GEN_Constructor(LOAD_GEN_Class_t *LoadGen, INITBL_Class_t *IniTbl, QOS_Class_t *Qos)
+{
+
+   int32 SysStatus;
+   const char *SemName = INITBL_GetStrConfig(IniTbl, CFG_LOAD_GEN_CHILD_SEM_NAME);
+   uint16 i;
+
+   memset(LoadGen, 0, sizeof(LOAD_GEN_Class_t));
+
+   LoadGen->Qos = Qos;
+
+   atomic_init(&LoadGen->Active, false);
+   atomic_init(&LoadGen->Sending, false);
+   atomic_init(&LoadGen->SentCnt, 0);
+   atomic_init(&LoadGen->PipeRcvdCnt, 0);
+   atomic_init(&LoadGen->TxQueuedCnt, 0);
+   atomic_init(&LoadGen->RadioSentCnt, 0);
+   atomic_init(&LoadGen->RadioErrCnt, 0);
+
+   SysStatus = OS_CountSemCreate(&LoadGen->WakeUpSemaphore, SemName, 0, 0);
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(LOAD_GEN_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Load generator child error creating semaphore %s, Status = %d", SemName, SysStatus);
+   }
+
+   /* The data is a counting pattern that's the same for every message */
+   for (i=0; i < LOAD_GEN_MAX_DATA_LEN; i++)
+   {
+      LoadGen->LoadGenMsg.Payload.Data[i] = (uint8)i;
+   }
+
+   LoadGen->MsgId = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_LORA_LOAD_GEN_TOPICID));
+   CFE_MSG_Init(CFE_MSG_PTR(LoadGen->LoadGenMsg.TelemetryHeader), LoadGen->MsgId, sizeof(LORA_LoadGenMsg_t));
+   CFE_MSG_Init(CFE_MSG_PTR(LoadGen->LoadGenTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_LORA_LOAD_GEN_TLM_TOPICID)), sizeof(LORA_LoadGenTlm_t));
+
+} /* End LOAD_GEN_Constructor() */
+
+
+/******************************************************************************
+** Function: LOAD_GEN_ChildTask
+**
+** Notes:
+**   1. Returning false causes the child task to terminate.
+**
+*/
+bool LOAD_GEN_ChildTask(LOAD_GEN_Class_t *LoadGen)
+{
+
+   LoadGen->RunStatus = CFE_SUCCESS;
+
+   while (LoadGen->RunStatus == CFE_SUCCESS)
+   {
+
+      LoadGen->RunStatus = OS_CountSemTake(LoadGen->WakeUpSemaphore);  // Pend until the start command gives semaphore
+
+      if (LoadGen->RunStatus == OS_SUCCESS && LOAD_GEN_Active(LoadGen))
+      {
+
+         Generate(LoadGen);
+         Drain(LoadGen);
+
+         OS_GetLocalTime(&LoadGen->EndTime);
+         atomic_store_explicit(&LoadGen->Active, false, memory_order_relaxed);
+
+         CFE_EVS_SendEvent(LOAD_GEN_STOP_EID, CFE_EVS_EventType_INFORMATION,
+                           "Load generator run ended after %u ms: sent %u, received %u, queued %u, "
+                           "queue drops %u, radio sent %u",
+                           ElapsedMs(LoadGen),
+                           atomic_load_explicit(&LoadGen->SentCnt, memory_order_relaxed),
+                           atomic_load_explicit(&LoadGen->PipeRcvdCnt, memory_order_relaxed),
+                           atomic_load_explicit(&LoadGen->TxQueuedCnt, memory_order_relaxed),
+                           LoadGen->TxQueueDropCnt,
+                           atomic_load_explicit(&LoadGen->RadioSentCnt, memory_order_relaxed));
+
+         LOAD_GEN_SendTlmCmd(LoadGen, NULL);
+
+      }
+
+   }
+
+   CFE_EVS_SendEvent(LOAD_GEN_CHILD_TASK_EID, CFE_EVS_EventType_ERROR,
+                     "Load generator child task terminating, semaphore status = %d", LoadGen->RunStatus);
+
+   return false;
+
+} /* End LOAD_GEN_ChildTask() */
+
+
+/******************************************************************************
+** Function: LOAD_GEN_Start
+**
+*/
+bool LOAD_GEN_Start(LOAD_GEN_Class_t *LoadGen, const LORA_StartLoadGen_CmdPayload_t *Cfg)
+{
+
+   int32 SysStatus;
+
+   if (LOAD_GEN_Active(LoadGen))
+   {
+      CFE_EVS_SendEvent(LOAD_GEN_START_EID, CFE_EVS_EventType_ERROR,
+                        "Start load generator rejected, a run is active");
+      return false;
+   }
+
+   if (Cfg->RateHz == 0 || Cfg->SizeDist > LORA_LoadGenSizeDist_BIMODAL || Cfg->MinLen > Cfg->MaxLen ||
+       Cfg->MaxLen > LOAD_GEN_MAX_DATA_LEN || Cfg->ForwardPct > 100)
+   {
+      CFE_EVS_SendEvent(LOAD_GEN_START_EID, CFE_EVS_EventType_ERROR,
+                        "Start load generator rejected, invalid rate %u Hz, size distribution %u, "
+                        "length %u to %u (max %u) or forward percent %u",
+                        Cfg->RateHz, Cfg->SizeDist, Cfg->MinLen, Cfg->MaxLen,
+                        (unsigned int)LOAD_GEN_MAX_DATA_LEN, Cfg->ForwardPct);
+      return false;
+   }
+
+   LoadGen->Cfg       = *Cfg;
+   LoadGen->RunCnt++;
+   LoadGen->RandState = (Cfg->Seed == 0) ? 1 : Cfg->Seed;
+
+   atomic_store_explicit(&LoadGen->SentCnt,      0, memory_order_relaxed);
+   atomic_store_explicit(&LoadGen->PipeRcvdCnt,  0, memory_order_relaxed);
+   atomic_store_explicit(&LoadGen->TxQueuedCnt,  0, memory_order_relaxed);
+   atomic_store_explicit(&LoadGen->RadioSentCnt, 0, memory_order_relaxed);
+   atomic_store_explicit(&LoadGen->RadioErrCnt,  0, memory_order_relaxed);
+   LoadGen->SbErrCnt          = 0;
+   LoadGen->TxQueueDropCnt    = 0;
+   LoadGen->TxQueuePeak       = 0;
+   LoadGen->PipeDelaySumUsec  = 0;
+   LoadGen->PipeDelayMaxUsec  = 0;
+   LoadGen->RadioDelaySumUsec = 0;
+   LoadGen->RadioDelayMaxUsec = 0;
+   LoadGen->LoadGenMsg.Payload.Seq = 0;
+
+   OS_GetLocalTime(&LoadGen->StartTime);
+   LoadGen->EndTime = LoadGen->StartTime;
+
+   atomic_store_explicit(&LoadGen->Sending, true, memory_order_relaxed);
+   atomic_store_explicit(&LoadGen->Active, true, memory_order_relaxed);
+
+   SysStatus = OS_CountSemGive(LoadGen->WakeUpSemaphore);
+   if (SysStatus != OS_SUCCESS)
+   {
+      atomic_store_explicit(&LoadGen->Sending, false, memory_order_relaxed);
+      atomic_store_explicit(&LoadGen->Active, false, memory_order_relaxed);
+      CFE_EVS_SendEvent(LOAD_GEN_START_EID, CFE_EVS_EventType_ERROR,
+                        "Error starting load generator, semaphore status = %d", SysStatus);
+      return false;
+   }
+
+   CFE_EVS_SendEvent(LOAD_GEN_START_EID, CFE_EVS_EventType_INFORMATION,
+                     "Load generator started: %u Hz for %u sec, %s length %u to %u, %u%% forwarded over radio %u",
+                     Cfg->RateHz, Cfg->DurationSec, SizeDistStr[Cfg->SizeDist], Cfg->MinLen, Cfg->MaxLen,
+                     Cfg->ForwardPct, Cfg->Radio);
+
+   return true;
+
+} /* End LOAD_GEN_Start() */
+
+
+/******************************************************************************
+** Function: LOAD_GEN_Active
+**
+*/
+bool LOAD_GEN_Active(LOAD_GEN_Class_t *LoadGen)
+{
+
+   return atomic_load_explicit(&LoadGen->Active, memory_order_relaxed);
+
+} /* End LOAD_GEN_Active() */
+
+
+/******************************************************************************
+** Function: LOAD_GEN_ProcessMsg
+**
+*/
+void LOAD_GEN_ProcessMsg(LOAD_GEN_Class_t *LoadGen, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const LORA_LoadGenMsg_Payload_t *Payload = &((const LORA_LoadGenMsg_t *)MsgPtr)->Payload;
+   CFE_TIME_SysTime_t SendTime;
+   uint16 QueueLen;
+   uint32 Delay;
+
+   if (!LOAD_GEN_Active(LoadGen))
+   {
+      return;
+   }
+
+   CFE_MSG_GetMsgTime(MsgPtr, &SendTime);
+   Delay = DelayUsec(&SendTime);
+
+   atomic_fetch_add_explicit(&LoadGen->PipeRcvdCnt, 1, memory_order_relaxed);
+   LoadGen->PipeDelaySumUsec += Delay;
+   if (Delay > LoadGen->PipeDelayMaxUsec)
+   {
+      LoadGen->PipeDelayMaxUsec = Delay;
+   }
+
+   if (Payload->Forward)
+   {
+      if (QOS_Enqueue(LoadGen->Qos, MsgPtr, LoadGen->RunCnt))
+      {
+         atomic_fetch_add_explicit(&LoadGen->TxQueuedCnt, 1, memory_order_relaxed);
+         QueueLen = QOS_QueueLen(LoadGen->Qos);
+         if (QueueLen > LoadGen->TxQueuePeak)
+         {
+            LoadGen->TxQueuePeak = QueueLen;
+         }
+      }
+      else
+      {
+         LoadGen->TxQueueDropCnt++;
+      }
+   } /* End if forward */
+
+} /* End LOAD_GEN_ProcessMsg() */
+
+
+/******************************************************************************
+** Function: LOAD_GEN_RecordTx
+**
+*/
+void LOAD_GEN_RecordTx(LOAD_GEN_Class_t *LoadGen, const QOS_TxMsg_t *TxMsg, bool Sent)
+{
+
+   uint32 Delay;
+
+   if (!CFE_SB_MsgId_Equal(TxMsg->MsgId, LoadGen->MsgId) || TxMsg->Tag != LoadGen->RunCnt)
+   {
+      return;
+   }
+
+   if (Sent)
+   {
+      Delay = DelayUsec(&TxMsg->MsgTime);
+      LoadGen->RadioDelaySumUsec += Delay;
+      if (Delay > LoadGen->RadioDelayMaxUsec)
+      {
+         LoadGen->RadioDelayMaxUsec = Delay;
+      }
+      atomic_fetch_add_explicit(&LoadGen->RadioSentCnt, 1, memory_order_relaxed);
+   }
+   else
+   {
+      atomic_fetch_add_explicit(&LoadGen->RadioErrCnt, 1, memory_order_relaxed);
+   }
+
+} /* End LOAD_GEN_RecordTx() */
+
+
+/******************************************************************************
+** Function: LOAD_GEN_StopCmd
+**
+*/
+bool LOAD_GEN_StopCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   LOAD_GEN_Class_t *LoadGen = (LOAD_GEN_Class_t *)ObjDataPtr;
+
+   if (!LOAD_GEN_Active(LoadGen))
+   {
+      CFE_EVS_SendEvent(LOAD_GEN_STOP_EID, CFE_EVS_EventType_ERROR,
+                        "Stop load generator ignored, no run is active");
+      return false;
+   }
+
+   atomic_store_explicit(&LoadGen->Sending, false, memory_order_relaxed);
+
+   CFE_EVS_SendEvent(LOAD_GEN_STOP_EID, CFE_EVS_EventType_INFORMATION,
+                     "Load generator stopping after %u messages",
+                     atomic_load_explicit(&LoadGen->SentCnt, memory_order_relaxed));
+
+   return true;
+
+} /* End LOAD_GEN_StopCmd() */
+
+
+/******************************************************************************
+** Function: LOAD_GEN_SendTlmCmd
+**
+** Notes:
+**   1. The pipe lost count is only exact after a run, while a run is active
+**      it includes the messages waiting in the pipe.
+**
+*/
+bool LOAD_GEN_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   LOAD_GEN_Class_t *LoadGen = (LOAD_GEN_Class_t *)ObjDataPtr;
+   LORA_LoadGenTlm_Payload_t *Payload = &LoadGen->LoadGenTlm.Payload;
+   uint32 SentCnt      = atomic_load_explicit(&LoadGen->SentCnt, memory_order_relaxed);
+   uint32 PipeRcvdCnt  = atomic_load_explicit(&LoadGen->PipeRcvdCnt, memory_order_relaxed);
+   uint32 RadioSentCnt = atomic_load_explicit(&LoadGen->RadioSentCnt, memory_order_relaxed);
+   uint32 Elapsed      = ElapsedMs(LoadGen);
+
+   Payload->Active     = LOAD_GEN_Active(LoadGen);
+   Payload->SizeDist   = LoadGen->Cfg.SizeDist;
+   Payload->ForwardPct = LoadGen->Cfg.ForwardPct;
+   Payload->Radio      = LoadGen->Cfg.Radio;
+   Payload->RateHz     = LoadGen->Cfg.RateHz;
+   Payload->ElapsedMs  = Elapsed;
+
+   Payload->SentCnt     = SentCnt;
+   Payload->SbErrCnt    = LoadGen->SbErrCnt;
+   Payload->PipeRcvdCnt = PipeRcvdCnt;
+   Payload->PipeLostCnt = (SentCnt > PipeRcvdCnt) ? (SentCnt - PipeRcvdCnt) : 0;
+   Payload->PipeRateHz  = (Elapsed > 0) ? (uint32)(((uint64)PipeRcvdCnt * 1000) / Elapsed) : 0;
+
+   Payload->TxQueuedCnt    = atomic_load_explicit(&LoadGen->TxQueuedCnt, memory_order_relaxed);
+   Payload->TxQueueDropCnt = LoadGen->TxQueueDropCnt;
+   Payload->TxQueuePeak    = LoadGen->TxQueuePeak;
+   Payload->RadioSentCnt   = RadioSentCnt;
+   Payload->RadioErrCnt    = atomic_load_explicit(&LoadGen->RadioErrCnt, memory_order_relaxed);
+
+   Payload->PipeDelayAvgUsec  = (PipeRcvdCnt > 0) ? (uint32)(LoadGen->PipeDelaySumUsec / PipeRcvdCnt) : 0;
+   Payload->PipeDelayMaxUsec  = LoadGen->PipeDelayMaxUsec;
+   Payload->RadioDelayAvgUsec = (RadioSentCnt > 0) ? (uint32)(LoadGen->RadioDelaySumUsec / RadioSentCnt) : 0;
+   Payload->RadioDelayMaxUsec = LoadGen->RadioDelayMaxUsec;
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(LoadGen->LoadGenTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(LoadGen->LoadGenTlm.TelemetryHeader), true);
+
+   return true;
+
+} /* End LOAD_GEN_SendTlmCmd() */
+
+
+/******************************************************************************
+** Function: Drain
+**
+** Wait for the messages in the pipe and the Tx queue to be processed
+**
+** Notes:
+**   1. Messages lost to a pipe overflow or a Tx queue drop never arrive so
+**      the wait also ends when no stage has made progress for
+**      LOAD_GEN_DRAIN_MS.
+**
+*/
+static void Drain(LOAD_GEN_Class_t *LoadGen)
+{
+
+   uint32 SentCnt = atomic_load_explicit(&LoadGen->SentCnt, memory_order_relaxed);
+   uint32 PipeRcvdCnt;
+   uint32 TxDoneCnt;
+   uint32 Progress;
+   uint32 LastProgress = 0;
+   uint32 QuietMs = 0;
+
+   while (QuietMs < LOAD_GEN_DRAIN_MS)
+   {
+
+      PipeRcvdCnt = atomic_load_explicit(&LoadGen->PipeRcvdCnt, memory_order_relaxed);
+      TxDoneCnt   = atomic_load_explicit(&LoadGen->RadioSentCnt, memory_order_relaxed) +
+                    atomic_load_explicit(&LoadGen->RadioErrCnt, memory_order_relaxed);
+
+      if (PipeRcvdCnt >= SentCnt &&
+          TxDoneCnt >= atomic_load_explicit(&LoadGen->TxQueuedCnt, memory_order_relaxed))
+      {
+         break;
+      }
+
+      Progress = PipeRcvdCnt + TxDoneCnt;
+      QuietMs  = (Progress == LastProgress) ? (QuietMs + LOAD_GEN_TICK_MS) : 0;
+      LastProgress = Progress;
+
+      OS_TaskDelay(LOAD_GEN_TICK_MS);
+
+   }
+
+} /* End Drain() */
+
+
+/******************************************************************************
+** Function: DelayUsec
+**
+** Return the time since SendTime
+**
+*/
+static uint32 DelayUsec(const CFE_TIME_SysTime_t *SendTime)
+{
+
+   CFE_TIME_SysTime_t Delay = CFE_TIME_Subtract(CFE_TIME_GetTime(), *SendTime);
+
+   return Delay.Seconds * 1000000 + CFE_TIME_Sub2MicroSecs(Delay.Subseconds);
+
+} /* End DelayUsec() */
+
+
+/******************************************************************************
+** Function: ElapsedMs
+**
+*/
+static uint32 ElapsedMs(LOAD_GEN_Class_t *LoadGen)
+{
+
+   OS_time_t EndTime;
+
+   if (LOAD_GEN_Active(LoadGen))
+   {
+      OS_GetLocalTime(&EndTime);
+   }
+   else
+   {
+      EndTime = LoadGen->EndTime;
+   }
+
+   return (uint32)OS_TimeGetTotalMilliseconds(OS_TimeSubtract(EndTime, LoadGen->StartTime));
+
+} /* End ElapsedMs() */
+
+
+/******************************************************************************
+** Function: Generate
+**
+** Send messages at the commanded rate until the duration has passed or the
+** run is stopped
+**
+** Notes:
+**   1. The messages due since the start are sent each tick so a late tick,
+**      for example when higher priority tasks hold the CPU, catches up and
+**      the average rate is the commanded rate.
+**
+*/
+static void Generate(LOAD_GEN_Class_t *LoadGen)
+{
+
+   uint64 DurationMs = (uint64)LoadGen->Cfg.DurationSec * 1000;
+   uint64 Elapsed;
+   uint64 DueCnt;
+
+   while (atomic_load_explicit(&LoadGen->Sending, memory_order_relaxed))
+   {
+
+      Elapsed = ElapsedMs(LoadGen);
+      if (DurationMs > 0 && Elapsed >= DurationMs)
+      {
+         break;
+      }
+
+      DueCnt = (Elapsed * LoadGen->Cfg.RateHz) / 1000 + 1;
+      while (LoadGen->LoadGenMsg.Payload.Seq < DueCnt &&
+             atomic_load_explicit(&LoadGen->Sending, memory_order_relaxed))
+      {
+         SendMsg(LoadGen);
+      }
+
+      OS_TaskDelay(LOAD_GEN_TICK_MS);
+
+   }
+
+   atomic_store_explicit(&LoadGen->Sending, false, memory_order_relaxed);
+
+} /* End Generate() */
+
+
+/******************************************************************************
+** Function: MsgDataLen
+**
+*/
+static uint16 MsgDataLen(LOAD_GEN_Class_t *LoadGen)
+{
+
+   const LORA_StartLoadGen_CmdPayload_t *Cfg = &LoadGen->Cfg;
+   uint16 DataLen;
+
+   switch (Cfg->SizeDist)
+   {
+      case LORA_LoadGenSizeDist_UNIFORM:
+         DataLen = Cfg->MinLen + (uint16)(Rand(LoadGen) % (Cfg->MaxLen - Cfg->MinLen + 1));
+         break;
+      case LORA_LoadGenSizeDist_BIMODAL:
+         DataLen = ((Rand(LoadGen) & 0x07) == 0) ? Cfg->MaxLen : Cfg->MinLen;
+         break;
+      default:
+         DataLen = Cfg->MaxLen;
+         break;
+   }
+
+   return DataLen;
+
+} /* End MsgDataLen() */
+
+
+/******************************************************************************
+** Function: Rand
+**
+** Notes:
+**   1. Xorshift32, the same generator as the simulated channel.
+**
+*/
+static uint32 Rand(LOAD_GEN_Class_t *LoadGen)
+{
+
+   uint32 x = LoadGen->RandState;
+
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+   LoadGen->RandState = x;
+
+   return x;
+
+} /* End Rand() */
+
+
+/******************************************************************************
+** Function: SendMsg
+**
+** Notes:
+**   1. The message is shortened to its data length so the pipe and the
+**      SB buffer pool carry the commanded sizes.
+**
+*/
+static void SendMsg(LOAD_GEN_Class_t *LoadGen)
+{
+
+   LORA_LoadGenMsg_Payload_t *Payload = &LoadGen->LoadGenMsg.Payload;
+   CFE_MSG_Message_t *MsgPtr = CFE_MSG_PTR(LoadGen->LoadGenMsg.TelemetryHeader);
+   int32 SysStatus;
+
+   Payload->Seq++;
+   Payload->DataLen = MsgDataLen(LoadGen);
+   Payload->Forward = (Rand(LoadGen) % 100) < LoadGen->Cfg.ForwardPct;
+
+   CFE_MSG_SetSize(MsgPtr, offsetof(LORA_LoadGenMsg_t, Payload.Data) + Payload->DataLen);
+   CFE_SB_TimeStampMsg(MsgPtr);
+   SysStatus = CFE_SB_TransmitMsg(MsgPtr, true);
+
+   if (SysStatus == CFE_SUCCESS)
+   {
+      atomic_fetch_add_explicit(&LoadGen->SentCnt, 1, memory_order_relaxed);
+   }
+   else
+   {
+      LoadGen->SbErrCnt++;
+   }
+
+} /* End SendMsg() */
+
@@ -0,0 +1,247 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the software bus load generator class
+**
+**  Notes:
+**    1. The load generator finds where the app saturates. Its child task
+**       sends LoadGenMsg messages at a commanded rate and length
+**       distribution to a topic the app subscribes to on its command pipe,
+**       so they compete with commands for CMD_PIPE_DEPTH slots and
+**       CMD_BATCH_MAX batches.
+**    2. A ForwardPct share of the messages is forwarded over a radio like
+**       telemetry bridged to the ground. ProcessCommands queues them with the
+**       QoS scheduler (qos.h) so they share the radio with the other bridged
+**       topics, LORA_LOAD_GEN_TOPICID must be in QOS_MID_MAP. The radio's Tx
+**       task sends them as LORA_FRAME_TYPE_SB_MSG frames and a receiving
+**       radio's bridge receive rebuilds and republishes them.
+**    3. Each message is counted where it's sent, where ProcessCommands
+**       receives it, where it's queued and where the radio has sent it. The
+**       drops between the stages are:
+**       - Pipe: SB doesn't report a full pipe to the sender so a message
+**         that was sent but never received was lost to a pipe overflow.
+**         The count is exact once the pipe has drained after a run.
+**       - Tx queue: Forwarded messages the QoS scheduler downsampled or
+**         didn't find room for. Queued messages that the scheduler shed
+**         later are the queued count less the radio's counts.
+**       - Radio: Frames the radio task failed to send.
+**    4. The delays use the message header's time stamp so they include the
+**       time spent waiting in the pipe, in the Tx queue and on the air.
+**    5. Each counter is written by one task so the stages don't share a
+**       lock. The counts are atomic because the generator task reads them
+**       to tell when the pipe and the Tx queue have drained. Telemetry may
+**       be one message out of date while a run is active.
+**    6. A run stays active after the generator stops until the messages in
+**       the pipe and the Tx queue have been processed or the stages make no
+**       progress for LOAD_GEN_DRAIN_MS, then the run's telemetry is sent.
+**    7. The same seed gives the same lengths and forwarding decisions so
+**       runs with different pipe depths and task priorities can be
+**       compared.
+**
+*/
+
+#ifndef _load_gen_
+#define _load_gen_
+
+/*
+** Includes
+*/
+
+#include <stdatomic.h>
+#include "app_cfg.h"
+#include "qos.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define LOAD_GEN_MAX_DATA_LEN  (sizeof(LORA_LoadGenData_t))
+#define LOAD_GEN_TICK_MS       10    /* Generator send period, messages due in a tick are sent together */
+#define LOAD_GEN_DRAIN_MS      1000  /* A run ends when its stages make no progress for this long */
+
+
+/*
+** Event Message IDs
+*/
+
+#define LOAD_GEN_CONSTRUCTOR_EID  (LOAD_GEN_BASE_EID + 0)
+#define LOAD_GEN_START_EID        (LOAD_GEN_BASE_EID + 1)
+#define LOAD_GEN_STOP_EID         (LOAD_GEN_BASE_EID + 2)
+#define LOAD_GEN_CHILD_TASK_EID   (LOAD_GEN_BASE_EID + 3)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+
+/******************************************************************************
+** LOAD_GEN_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Telemetry Packets
+   */
+
+   LORA_LoadGenMsg_t  LoadGenMsg;
+   LORA_LoadGenTlm_t  LoadGenTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   atomic_bool  Active;          /* Run is active, includes draining the stages */
+   atomic_bool  Sending;         /* Generator is sending, cleared by the stop command */
+   int32        RunStatus;
+   osal_id_t    WakeUpSemaphore;
+   QOS_Class_t  *Qos;
+   CFE_SB_MsgId_t MsgId;
+
+   LORA_StartLoadGen_CmdPayload_t Cfg;
+   uint32       RunCnt;          /* Queue tag, messages from an earlier run aren't counted */
+   uint32       RandState;
+   OS_time_t    StartTime;
+   OS_time_t    EndTime;
+
+   /* Generator task */
+   atomic_uint  SentCnt;
+   uint32       SbErrCnt;
+
+   /* Main task */
+   atomic_uint  PipeRcvdCnt;
+   atomic_uint  TxQueuedCnt;
+   uint32       TxQueueDropCnt;
+   uint16       TxQueuePeak;
+   uint64       PipeDelaySumUsec;
+   uint32       PipeDelayMaxUsec;
+
+   /* Radio Tx task */
+   atomic_uint  RadioSentCnt;
+   atomic_uint  RadioErrCnt;
+   uint64       RadioDelaySumUsec;
+   uint32       RadioDelayMaxUsec;
+
+} LOAD_GEN_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: LOAD_GEN_Constructor
+**
+** Initialize the Load Generator object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void LOAD_GEN_Constructor(LOAD_GEN_Class_t *LoadGen, INITBL_Class_t *IniTbl, QOS_Class_t *Qos);
+
+
+/******************************************************************************
+** Function: LOAD_GEN_ChildTask
+**
+** Notes:
+**   1. Called by the app's child manager callback for the generator.
+**
+*/
+bool LOAD_GEN_ChildTask(LOAD_GEN_Class_t *LoadGen);
+
+
+/******************************************************************************
+** Function: LOAD_GEN_Start
+**
+** Check the configuration, clear the counters and wake the generator task
+**
+** Notes:
+**   1. Called by the app's start load generator command after it has
+**      started the QoS scheduler on the forwarding radio. The caller then
+**      starts the radio's Tx task.
+**   2. Returns false if a run is active or the configuration is invalid.
+**
+*/
+bool LOAD_GEN_Start(LOAD_GEN_Class_t *LoadGen, const LORA_StartLoadGen_CmdPayload_t *Cfg);
+
+
+/******************************************************************************
+** Function: LOAD_GEN_Active
+**
+** Notes:
+**   1. Checked by the forwarding radio's Tx task loop. A run is active until
+**      its messages have drained, see the prologue.
+**
+*/
+bool LOAD_GEN_Active(LOAD_GEN_Class_t *LoadGen);
+
+
+/******************************************************************************
+** Function: LOAD_GEN_ProcessMsg
+**
+** Count a load message received by ProcessCommands and queue it with the
+** QoS scheduler if it's forwarded
+**
+** Notes:
+**   1. Only called by the main task.
+**   2. Messages received while no run is active, for example load messages
+**      republished by a receiving node's bridge, are ignored.
+**
+*/
+void LOAD_GEN_ProcessMsg(LOAD_GEN_Class_t *LoadGen, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: LOAD_GEN_RecordTx
+**
+** Record the result of sending a forwarded message
+**
+** Notes:
+**   1. Called by the bridging radio's Tx task for every bridged message,
+**      messages of other topics and earlier runs are ignored.
+**
+*/
+void LOAD_GEN_RecordTx(LOAD_GEN_Class_t *LoadGen, const QOS_TxMsg_t *TxMsg, bool Sent);
+
+
+/******************************************************************************
+** Function: LOAD_GEN_StopCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**   2. The generator stops at its next tick. The forwarding radio sends the
+**      messages that are already queued.
+*/
+bool LOAD_GEN_StopCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: LOAD_GEN_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**   2. Also sent when a run ends.
+*/
+bool LOAD_GEN_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _load_gen_ */
@@ -16,11 +16,27 @@
 **    Implement the LoRa application
 **
 **  Notes:
-**    1. Three contained objects perform the following functions: 
-**       - radio_if: Configure and control the SX128x radio object
-**       - lora_rx: Receive and process data from the SX128x radio object
-**       - lora_tx: Transmitt data to the SX128x radio object
-**    2. The radio object is defined in the SX128x library
+**    1. Each of the RADIO_CNT radios has its own set of objects and child
+**       tasks, see LORA_APP_Radio_t. The main per-radio objects are:
+**       - radio_drv: Time the SX128x library or simulated radio calls
+**       - radio_task: Own the radio and serialize the other objects' calls
+**       - radio_if: Configure and control the radio
+**       - lora_rx: Receive and process data from the radio
+**       - lora_tx: Transmit data to the radio
+**       The metrics, frame trace and event summary objects are shared by
+**       all of the radios.
+**    2. The radio object is defined in the SX128x library. It drives a
+**       single device so at most one radio can use the SX128X backend, the
+**       others must use the simulated radio.
+**    3. Multiple SX128X radios need a library that takes a device handle.
+**       Until then LoadRadios() rejects the configuration.
+**    4. A striped transfer uses several radios at once so its commands
+**       are app commands rather than radio commands, see stripe.h.
+**    5. The load generator's messages arrive on the command pipe like
+**       commands so they measure the pipe and ProcessCommands, see
+**       load_gen.h.
+**    6. The relay is shared by every radio's bridges, a relay can receive
+**       on one radio and forward on another. See relay.h.
 **
 */
 
@@ -41,19 +57,37 @@
 /* Convenience macros */
 #define  INITBL_OBJ      (&(LoraApp.IniTbl))
 #define  CMDMGR_OBJ      (&(LoraApp.CmdMgr))
-#define  CHILDMGR_OBJ    (&(LoraApp.ChildMgr))
-#define  RX_CHILDMGR_OBJ (&(LoraApp.RxChildMgr))
-#define  TX_CHILDMGR_OBJ (&(LoraApp.TxChildMgr))
-#define  RADIO_IF_OBJ    (&(LoraApp.RadioIf))
-#define  LORA_RX_OBJ     (&(LoraApp.LoraRx))
-#define  LORA_TX_OBJ     (&(LoraApp.LoraTx))
+#define  LORA_METRICS_OBJ (&(LoraApp.Metrics))
+#define  FRAME_TRACE_OBJ (&(LoraApp.FrameTrace))
+#define  EVT_SUM_OBJ     (&(LoraApp.EvtSum))
+#define  STRIPE_OBJ      (&(LoraApp.Stripe))
+#define  RX_DIV_OBJ      (&(LoraApp.RxDiv))
+#define  RX_WRITER_OBJ   (&(LoraApp.RxWriter))
+#define  STORE_OBJ       (&(LoraApp.Store))
+#define  QOS_OBJ         (&(LoraApp.Qos))
+#define  LOAD_GEN_OBJ    (&(LoraApp.LoadGen))
+#define  RELAY_OBJ       (&(LoraApp.Relay))
 
 /*******************************/
 /** Local Function Prototypes **/
 /*******************************/
 
 static int32 InitApp(void);
+static bool  LoadRadios(void);
+static int32 InitRadio(LORA_APP_Radio_t *Radio);
+static void  RegisterRadioCmds(CMDMGR_Class_t *CmdMgr, LORA_APP_Radio_t *Radio);
+static bool  StartStripe(LORA_StripeRole_Enum_t Role, uint8 RadioMask);
+static bool  StartTxStripeCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+static bool  StartRxStripeCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+static bool  StartLoadGenCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+static bool  LoadGenChildTask(CHILDMGR_Class_t *ChildMgr);
+static LORA_APP_Radio_t *ChildRadio(const CHILDMGR_Class_t *ChildMgr);
+static bool  RadioChildTask(CHILDMGR_Class_t *ChildMgr);
+static bool  RxChildTask(CHILDMGR_Class_t *ChildMgr);
+static bool  RxWriterChildTask(CHILDMGR_Class_t *ChildMgr);
+static bool  TxChildTask(CHILDMGR_Class_t *ChildMgr);
 static int32 ProcessCommands(void);
+static void ProcessMsg(const CFE_SB_Buffer_t *SbBufPtr);
 static void SendStatusTlm(void);
 
 
@@ -68,16 +102,6 @@ static void SendStatusTlm(void);
 DEFINE_ENUM(Config,APP_CONFIG)  
 
 
-static CFE_EVS_BinFilter_t  EventFilters[] =
-{  
-   // Use CFE_EVS_NO_FILTER to see all events
-   /* Event ID                Mask */
-   {LORA_RX_CHILD_TASK_EID,   CFE_EVS_FIRST_4_STOP},
-   {LORA_TX_CHILD_TASK_EID,   CFE_EVS_FIRST_4_STOP}
-
-};
-
-
 /*****************/
 /** Global Data **/
 /*****************/
@@ -94,8 +118,8 @@ void LORA_AppMain(void)
    uint32 RunStatus = CFE_ES_RunStatus_APP_ERROR;
 
 
-   CFE_EVS_Register(EventFilters, sizeof(EventFilters)/sizeof(CFE_EVS_BinFilter_t),
-                    CFE_EVS_EventFilter_BINARY);
+   /* Repetitive events are rate limited by the event summarizer, not EVS filters */
+   CFE_EVS_Register(NULL, 0, CFE_EVS_EventFilter_BINARY);
 
    if (InitApp() == CFE_SUCCESS) /* Performs initial CFE_ES_PerfLogEntry() call */
    {  
@@ -153,15 +177,43 @@ bool LORA_APP_NoOpCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 bool LORA_APP_ResetAppCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
 
+   LORA_APP_Radio_t *Radio;
+   uint16 i;
+
    CFE_EVS_ResetAllFilters();
    
    CMDMGR_ResetStatus(CMDMGR_OBJ);
-   CHILDMGR_ResetStatus(RX_CHILDMGR_OBJ);
-   CHILDMGR_ResetStatus(TX_CHILDMGR_OBJ);
    
-   RADIO_IF_ResetStatus();
-   LORA_RX_ResetStatus();
-   LORA_TX_ResetStatus();
+   for (i=0; i < LoraApp.RadioCnt; i++)
+   {
+      
+      Radio = &LoraApp.Radio[i];
+      
+      CMDMGR_ResetStatus(&Radio->CmdMgr);
+      CHILDMGR_ResetStatus(&Radio->RadioChildMgr);
+      CHILDMGR_ResetStatus(&Radio->RxChildMgr);
+      CHILDMGR_ResetStatus(&Radio->TxChildMgr);
+   
+      RADIO_TASK_ResetStatus(&Radio->RadioTask);
+      RADIO_IF_ResetStatus(&Radio->RadioIf);
+      FREQ_HOP_ResetStatus(&Radio->FreqHop);
+      RX_DUTY_ResetStatus(&Radio->RxDuty);
+      LATENCY_ResetStatus(&Radio->Latency);
+      LEN_OPT_ResetStatus(&Radio->LenOpt);
+   
+   }
+   LORA_METRICS_ResetStatus();
+   RX_DIV_ResetStatus(RX_DIV_OBJ);
+   RX_WRITER_ResetStatus(RX_WRITER_OBJ);
+   CHILDMGR_ResetStatus(&LoraApp.RxWriterChildMgr);
+   
+   LoraApp.CmdBatchCnt      = 0;
+   LoraApp.CmdMsgCnt        = 0;
+   LoraApp.CmdBatchLimitCnt = 0;
+   LoraApp.CmdPipeHighWater = 0;
+   LoraApp.CmdBatchLastUsec = 0;
+   LoraApp.CmdBatchMaxUsec  = 0;
+   LoraApp.CmdBatchUsecSum  = 0;
    
    return true;
 
@@ -175,8 +227,8 @@ bool LORA_APP_ResetAppCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 static int32 InitApp(void)
 {
 
-   int32 Status = APP_C_FW_CFS_ERROR;
-   
+   int32  Status = APP_C_FW_CFS_ERROR;
+   uint16 i;
    CHILDMGR_TaskInit_t ChildTaskInit;
    
    CFE_ES_PerfLogEntry(LoraApp.PerfId);
@@ -185,36 +237,64 @@ static int32 InitApp(void)
    ** Initialize objects 
    */
 
-   if (INITBL_Constructor(&LoraApp.IniTbl, LORA_INI_FILENAME, &IniCfgEnum))
+   if (INITBL_Constructor(&LoraApp.IniTbl, LORA_INI_FILENAME, &IniCfgEnum) && LoadRadios())
    {
 
       LoraApp.PerfId   = INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_PERF_ID);
       LoraApp.CmdMid   = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_LORA_CMD_TOPICID));
       LoraApp.OneHzMid = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_BC_SCH_1_HZ_TOPICID));
+      LoraApp.LoadGenMid = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_LORA_LOAD_GEN_TOPICID));
+      
+      LoraApp.CmdBatchMax = INITBL_GetIntConfig(INITBL_OBJ, CFG_CMD_BATCH_MAX);
+      if (LoraApp.CmdBatchMax == 0)
+      {
+         LoraApp.CmdBatchMax = 1;
+      }
       
       /*
       ** Initialize contained objects
       */
       
-      RADIO_IF_Constructor(RADIO_IF_OBJ, &LoraApp.IniTbl);
-
-      /* Child Manager constructor sends error events */
-
-      LORA_RX_Constructor(LORA_RX_OBJ);
-      ChildTaskInit.TaskName  = INITBL_GetStrConfig(INITBL_OBJ, CFG_RX_CHILD_NAME);
-      ChildTaskInit.StackSize = INITBL_GetIntConfig(INITBL_OBJ, CFG_RX_CHILD_STACK_SIZE);
-      ChildTaskInit.Priority  = INITBL_GetIntConfig(INITBL_OBJ, CFG_RX_CHILD_PRIORITY);
-      ChildTaskInit.PerfId    = INITBL_GetIntConfig(INITBL_OBJ, CFG_RX_CHILD_PERF_ID);
-      Status = CHILDMGR_Constructor(RX_CHILDMGR_OBJ, ChildMgr_TaskMainCallback,
-                                    LORA_RX_ChildTask, &ChildTaskInit); 
-
-      LORA_TX_Constructor(LORA_TX_OBJ, INITBL_GetStrConfig(INITBL_OBJ, CFG_TX_CHILD_SEM_NAME));
-      ChildTaskInit.TaskName  = INITBL_GetStrConfig(INITBL_OBJ, CFG_TX_CHILD_NAME);
-      ChildTaskInit.StackSize = INITBL_GetIntConfig(INITBL_OBJ, CFG_TX_CHILD_STACK_SIZE);
-      ChildTaskInit.Priority  = INITBL_GetIntConfig(INITBL_OBJ, CFG_TX_CHILD_PRIORITY);
-      ChildTaskInit.PerfId    = INITBL_GetIntConfig(INITBL_OBJ, CFG_TX_CHILD_PERF_ID);
-      Status = CHILDMGR_Constructor(TX_CHILDMGR_OBJ, ChildMgr_TaskMainCallback,
-                                    LORA_TX_ChildTask, &ChildTaskInit); 
+      LORA_METRICS_Constructor(LORA_METRICS_OBJ);
+      FRAME_TRACE_Constructor(FRAME_TRACE_OBJ);
+      EVT_SUM_Constructor(EVT_SUM_OBJ, &LoraApp.IniTbl);
+      RX_WRITER_Constructor(RX_WRITER_OBJ, &LoraApp.IniTbl);
+      STRIPE_Constructor(STRIPE_OBJ, &LoraApp.IniTbl, RX_WRITER_OBJ);
+      RX_DIV_Constructor(RX_DIV_OBJ, &LoraApp.IniTbl);
+      STORE_Constructor(STORE_OBJ, &LoraApp.IniTbl);
+      QOS_Constructor(QOS_OBJ, &LoraApp.IniTbl, STORE_OBJ);
+      LOAD_GEN_Constructor(LOAD_GEN_OBJ, &LoraApp.IniTbl, QOS_OBJ);
+      RELAY_Constructor(RELAY_OBJ, &LoraApp.IniTbl, QOS_OBJ);
+
+      for (i=0; i < LoraApp.RadioCnt; i++)
+      {
+         Status = InitRadio(&LoraApp.Radio[i]);
+         if (Status != CFE_SUCCESS)
+         {
+            break;
+         }
+      }
+      
+      if (Status == CFE_SUCCESS)
+      {
+         ChildTaskInit.TaskName  = INITBL_GetStrConfig(INITBL_OBJ, CFG_LOAD_GEN_CHILD_NAME);
+         ChildTaskInit.StackSize = INITBL_GetIntConfig(INITBL_OBJ, CFG_LOAD_GEN_CHILD_STACK_SIZE);
+         ChildTaskInit.Priority  = INITBL_GetIntConfig(INITBL_OBJ, CFG_LOAD_GEN_CHILD_PRIORITY);
+         ChildTaskInit.PerfId    = INITBL_GetIntConfig(INITBL_OBJ, CFG_LOAD_GEN_CHILD_PERF_ID);
+         Status = CHILDMGR_Constructor(&LoraApp.LoadGenChildMgr, ChildMgr_TaskMainCallback,
+                                       LoadGenChildTask, &ChildTaskInit); 
+      }
+      
+      if (Status == CFE_SUCCESS)
+      {
+         ChildTaskInit.TaskName  = INITBL_GetStrConfig(INITBL_OBJ, CFG_RX_WRITER_CHILD_NAME);
+         ChildTaskInit.StackSize = INITBL_GetIntConfig(INITBL_OBJ, CFG_RX_WRITER_CHILD_STACK_SIZE);
+         ChildTaskInit.Priority  = INITBL_GetIntConfig(INITBL_OBJ, CFG_RX_WRITER_CHILD_PRIORITY);
+         ChildTaskInit.PerfId    = INITBL_GetIntConfig(INITBL_OBJ, CFG_RX_WRITER_CHILD_PERF_ID);
+         Status = CHILDMGR_Constructor(&LoraApp.RxWriterChildMgr, ChildMgr_TaskMainCallback,
+                                       RxWriterChildTask, &ChildTaskInit); 
+      }
+      
    } /* End if INITBL Constructed */
   
    if (Status == CFE_SUCCESS)
@@ -227,21 +307,46 @@ static int32 InitApp(void)
       CFE_SB_CreatePipe(&LoraApp.CmdPipe, INITBL_GetIntConfig(INITBL_OBJ, CFG_CMD_PIPE_DEPTH), INITBL_GetStrConfig(INITBL_OBJ, CFG_CMD_PIPE_NAME));  
       CFE_SB_Subscribe(LoraApp.CmdMid,   LoraApp.CmdPipe);
       CFE_SB_Subscribe(LoraApp.OneHzMid, LoraApp.CmdPipe);
+      CFE_SB_Subscribe(LoraApp.LoadGenMid, LoraApp.CmdPipe);
+      for (i=0; i < LoraApp.Qos.MidCnt; i++)
+      {
+         if (!CFE_SB_MsgId_Equal(LoraApp.Qos.Mid[i].MsgId, LoraApp.LoadGenMid))
+         {
+            CFE_SB_Subscribe(LoraApp.Qos.Mid[i].MsgId, LoraApp.CmdPipe);
+         }
+      }
 
       CMDMGR_Constructor(CMDMGR_OBJ);
       CMDMGR_RegisterFunc(CMDMGR_OBJ, CMDMGR_NOOP_CMD_FC,   NULL, LORA_APP_NoOpCmd,     0);
       CMDMGR_RegisterFunc(CMDMGR_OBJ, CMDMGR_RESET_CMD_FC,  NULL, LORA_APP_ResetAppCmd, 0);
+      RegisterRadioCmds(CMDMGR_OBJ, &LoraApp.Radio[0]);
+
+      for (i=1; i < LoraApp.RadioCnt; i++)
+      {
+         CFE_SB_Subscribe(LoraApp.Radio[i].CmdMid, LoraApp.CmdPipe);
+         CMDMGR_Constructor(&LoraApp.Radio[i].CmdMgr);
+         CMDMGR_RegisterFunc(&LoraApp.Radio[i].CmdMgr, CMDMGR_NOOP_CMD_FC,  NULL, LORA_APP_NoOpCmd,     0);
+         CMDMGR_RegisterFunc(&LoraApp.Radio[i].CmdMgr, CMDMGR_RESET_CMD_FC, NULL, LORA_APP_ResetAppCmd, 0);
+         RegisterRadioCmds(&LoraApp.Radio[i].CmdMgr, &LoraApp.Radio[i]);
+      }
 
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SEND_RADIO_TLM_CC,           RADIO_IF_OBJ, RADIO_IF_SendRadioTlmCmd,          0);
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SET_LOW_NOISE_AMP_MODE_CC,   RADIO_IF_OBJ, RADIO_IF_SetLowNoiseAmpModeCmd,    sizeof(LORA_SetLowNoiseAmpMode_CmdPayload_t));
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SET_MODULATION_PARAMS_CC,    RADIO_IF_OBJ, RADIO_IF_SetModulationParamsCmd,   sizeof(LORA_SetModulationParams_CmdPayload_t));
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SET_POWER_AMP_RAMP_TIME_CC,  RADIO_IF_OBJ, RADIO_IF_SetPowerAmpRampTimeCmd,   sizeof(LORA_SetPowerAmpRampTime_CmdPayload_t));
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SET_POWER_REGULATOR_MODE_CC, RADIO_IF_OBJ, RADIO_IF_SetPowerRegulatorModeCmd, sizeof(LORA_SetPowerRegulatorMode_CmdPayload_t));
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SET_RADIO_FREQUENCY_CC,      RADIO_IF_OBJ, RADIO_IF_SetRadioFrequencyCmd,     sizeof(LORA_SetRadioFrequency_CmdPayload_t));
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SET_STANDBY_MODE_CC,         RADIO_IF_OBJ, RADIO_IF_SetStandbyModeCmd,        sizeof(LORA_SetStandbyMode_CmdPayload_t));
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_CONFIG_FRAME_TRACE_CC,     FRAME_TRACE_OBJ, FRAME_TRACE_ConfigCmd,    sizeof(LORA_ConfigFrameTrace_CmdPayload_t));
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_WRITE_FRAME_TRACE_FILE_CC, FRAME_TRACE_OBJ, FRAME_TRACE_WriteFileCmd, sizeof(LORA_WriteFrameTraceFile_CmdPayload_t));
 
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_START_TX_DEMO_CC, LORA_TX_OBJ, LORA_TX_StartDemoCmd, 0);
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_STOP_TX_DEMO_CC,  LORA_TX_OBJ, LORA_TX_StopDemoCmd,  0);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_START_TX_STRIPE_CC, NULL,       StartTxStripeCmd,   sizeof(LORA_StartStripe_CmdPayload_t));
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_START_RX_STRIPE_CC, NULL,       StartRxStripeCmd,   sizeof(LORA_StartStripe_CmdPayload_t));
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_STOP_STRIPE_CC,     STRIPE_OBJ, STRIPE_StopCmd,     0);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SEND_STRIPE_TLM_CC, STRIPE_OBJ, STRIPE_SendTlmCmd,  0);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SEND_RX_DIV_TLM_CC, RX_DIV_OBJ, RX_DIV_SendTlmCmd,  0);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SEND_RX_WRITER_TLM_CC, RX_WRITER_OBJ, RX_WRITER_SendTlmCmd, 0);
+
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_START_LOAD_GEN_CC,    NULL,         StartLoadGenCmd,     sizeof(LORA_StartLoadGen_CmdPayload_t));
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_STOP_LOAD_GEN_CC,     LOAD_GEN_OBJ, LOAD_GEN_StopCmd,    0);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SEND_LOAD_GEN_TLM_CC, LOAD_GEN_OBJ, LOAD_GEN_SendTlmCmd, 0);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SEND_QOS_TLM_CC,      QOS_OBJ,      QOS_SendTlmCmd,      0);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_ACK_STORE_CC,         STORE_OBJ,    STORE_AckCmd,        sizeof(LORA_AckStore_CmdPayload_t));
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SEND_STORE_TLM_CC,    STORE_OBJ,    STORE_SendTlmCmd,    0);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, LORA_SEND_RELAY_TLM_CC,    RELAY_OBJ,    RELAY_SendTlmCmd,    0);
 
       CFE_MSG_Init(CFE_MSG_PTR(LoraApp.StatusTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_LORA_STATUS_TLM_TOPICID)), sizeof(LORA_StatusTlm_t));
    
@@ -249,8 +354,8 @@ static int32 InitApp(void)
       ** Application startup event message
       */
       CFE_EVS_SendEvent(LORA_APP_INIT_APP_EID, CFE_EVS_EventType_INFORMATION,
-                        "LORA  App Initialized. Version %d.%d.%d",
-                        LORA_APP_MAJOR_VER, LORA_APP_MINOR_VER, LORA_APP_PLATFORM_REV);
+                        "LORA  App Initialized with %d radio(s). Version %d.%d.%d",
+                        LoraApp.RadioCnt, LORA_APP_MAJOR_VER, LORA_APP_MINOR_VER, LORA_APP_PLATFORM_REV);
                         
    } /* End if CHILDMGR constructed */
    
@@ -259,66 +364,519 @@ static int32 InitApp(void)
 } /* End of InitApp() */
 
 
+/******************************************************************************
+** Function: LoadRadios
+**
+** Load the radio instance configurations from the init file
+**
+** Notes:
+**   1. The SX128X library calls don't take a device so at most one radio can
+**      use it. A second SX128X radio fails the app init rather than sharing
+**      the first radio's device.
+**
+*/
+static bool LoadRadios(void)
+{
+
+   uint16 i;
+   int16  Sx128xRadio = -1;
+
+   LoraApp.RadioCnt = RADIO_INST_GetRadioCnt(INITBL_OBJ);
+   if (LoraApp.RadioCnt == 0)
+   {
+      return false;
+   }
+
+   for (i=0; i < LoraApp.RadioCnt; i++)
+   {
+      if (!RADIO_INST_Load(&LoraApp.Radio[i].Inst, i, INITBL_OBJ))
+      {
+         return false;
+      }
+      if (LoraApp.Radio[i].Inst.Backend == LORA_RadioBackend_SX128X)
+      {
+         if (Sx128xRadio >= 0)
+         {
+            CFE_EVS_SendEvent(LORA_APP_INIT_APP_EID, CFE_EVS_EventType_ERROR,
+                              "Radio %d can't use the %s backend, radio %d already drives the only supported device",
+                              i, RADIO_INST_BACKEND_SX128X_STR, Sx128xRadio);
+            return false;
+         }
+         Sx128xRadio = i;
+      }
+   }
+
+   for (i=0; i < LoraApp.RadioCnt; i++)
+   {
+      LoraApp.Radio[i].CmdMid = CFE_SB_ValueToMsgId(LoraApp.Radio[i].Inst.CmdTopicId);
+   }
+
+   return true;
+
+} /* End LoadRadios() */
+
+
+/******************************************************************************
+** Function: InitRadio
+**
+** Construct a radio's objects and start its child tasks
+**
+** Notes:
+**   1. Objects are constructed before the objects that reference them.
+**   2. Child task names get the radio index appended, see radio_inst.h.
+**
+*/
+static int32 InitRadio(LORA_APP_Radio_t *Radio)
+{
+
+   int32 Status;
+   char  TaskName[OS_MAX_API_NAME];
+   const RADIO_INST_Cfg_t *Inst = &Radio->Inst;
+   CHILDMGR_TaskInit_t ChildTaskInit;
+
+   RADIO_DRV_Constructor(&Radio->RadioDrv, INITBL_OBJ, Inst);
+   RADIO_TASK_Constructor(&Radio->RadioTask, INITBL_OBJ, Inst, &Radio->RadioDrv);
+   RX_DUTY_Constructor(&Radio->RxDuty, INITBL_OBJ, Inst, &Radio->RadioTask);
+   FREQ_HOP_Constructor(&Radio->FreqHop, INITBL_OBJ, Inst, &Radio->RadioTask);
+   RADIO_IF_Constructor(&Radio->RadioIf, INITBL_OBJ, Inst, &Radio->RadioTask,
+                        &Radio->RadioDrv, &Radio->RxDuty);
+   LINK_TEST_Constructor(&Radio->LinkTest, INITBL_OBJ, Inst, &Radio->RadioTask,
+                         &Radio->RadioIf, &Radio->RxDuty);
+   LATENCY_Constructor(&Radio->Latency, INITBL_OBJ, Inst);
+   LEN_OPT_Constructor(&Radio->LenOpt, INITBL_OBJ, Inst);
+
+   /* Child Manager constructor sends error events */
+
+   ChildTaskInit.TaskName  = RADIO_INST_Name(TaskName, sizeof(TaskName), INITBL_GetStrConfig(INITBL_OBJ, CFG_RADIO_CHILD_NAME), Inst);
+   ChildTaskInit.StackSize = INITBL_GetIntConfig(INITBL_OBJ, CFG_RADIO_CHILD_STACK_SIZE);
+   ChildTaskInit.Priority  = INITBL_GetIntConfig(INITBL_OBJ, CFG_RADIO_CHILD_PRIORITY);
+   ChildTaskInit.PerfId    = INITBL_GetIntConfig(INITBL_OBJ, CFG_RADIO_CHILD_PERF_ID);
+   Status = CHILDMGR_Constructor(&Radio->RadioChildMgr, ChildMgr_TaskMainCallback,
+                                 RadioChildTask, &ChildTaskInit); 
+
+   if (Status == CFE_SUCCESS)
+   {
+      LORA_RX_Constructor(&Radio->LoraRx, INITBL_OBJ, Inst, &Radio->RadioTask, &Radio->RadioIf,
+                          &Radio->FreqHop, &Radio->LinkTest, &Radio->RxDuty, &Radio->Latency,
+                          &Radio->LenOpt, STRIPE_OBJ, RX_DIV_OBJ, STORE_OBJ, RX_WRITER_OBJ, RELAY_OBJ);
+      ChildTaskInit.TaskName  = RADIO_INST_Name(TaskName, sizeof(TaskName), INITBL_GetStrConfig(INITBL_OBJ, CFG_RX_CHILD_NAME), Inst);
+      ChildTaskInit.StackSize = INITBL_GetIntConfig(INITBL_OBJ, CFG_RX_CHILD_STACK_SIZE);
+      ChildTaskInit.Priority  = INITBL_GetIntConfig(INITBL_OBJ, CFG_RX_CHILD_PRIORITY);
+      ChildTaskInit.PerfId    = INITBL_GetIntConfig(INITBL_OBJ, CFG_RX_CHILD_PERF_ID);
+      Status = CHILDMGR_Constructor(&Radio->RxChildMgr, ChildMgr_TaskMainCallback,
+                                    RxChildTask, &ChildTaskInit); 
+   }
+
+   if (Status == CFE_SUCCESS)
+   {
+      LORA_TX_Constructor(&Radio->LoraTx, INITBL_OBJ, Inst, &Radio->RadioTask, &Radio->RadioIf,
+                          &Radio->FreqHop, &Radio->LinkTest, &Radio->Latency, &Radio->LenOpt,
+                          STRIPE_OBJ, LOAD_GEN_OBJ, QOS_OBJ, RELAY_OBJ);
+      ChildTaskInit.TaskName  = RADIO_INST_Name(TaskName, sizeof(TaskName), INITBL_GetStrConfig(INITBL_OBJ, CFG_TX_CHILD_NAME), Inst);
+      ChildTaskInit.StackSize = INITBL_GetIntConfig(INITBL_OBJ, CFG_TX_CHILD_STACK_SIZE);
+      ChildTaskInit.Priority  = INITBL_GetIntConfig(INITBL_OBJ, CFG_TX_CHILD_PRIORITY);
+      ChildTaskInit.PerfId    = INITBL_GetIntConfig(INITBL_OBJ, CFG_TX_CHILD_PERF_ID);
+      Status = CHILDMGR_Constructor(&Radio->TxChildMgr, ChildMgr_TaskMainCallback,
+                                    TxChildTask, &ChildTaskInit); 
+   }
+
+   return Status;
+
+} /* End InitRadio() */
+
+
+/******************************************************************************
+** Function: RegisterRadioCmds
+**
+** Register a radio's object commands with CmdMgr
+**
+*/
+static void RegisterRadioCmds(CMDMGR_Class_t *CmdMgr, LORA_APP_Radio_t *Radio)
+{
+
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SEND_RADIO_TLM_CC,           &Radio->RadioIf, RADIO_IF_SendRadioTlmCmd,          0);
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SET_LOW_NOISE_AMP_MODE_CC,   &Radio->RadioIf, RADIO_IF_SetLowNoiseAmpModeCmd,    sizeof(LORA_SetLowNoiseAmpMode_CmdPayload_t));
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SET_MODULATION_PARAMS_CC,    &Radio->RadioIf, RADIO_IF_SetModulationParamsCmd,   sizeof(LORA_SetModulationParams_CmdPayload_t));
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SET_POWER_AMP_RAMP_TIME_CC,  &Radio->RadioIf, RADIO_IF_SetPowerAmpRampTimeCmd,   sizeof(LORA_SetPowerAmpRampTime_CmdPayload_t));
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SET_POWER_REGULATOR_MODE_CC, &Radio->RadioIf, RADIO_IF_SetPowerRegulatorModeCmd, sizeof(LORA_SetPowerRegulatorMode_CmdPayload_t));
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SET_RADIO_FREQUENCY_CC,      &Radio->RadioIf, RADIO_IF_SetRadioFrequencyCmd,     sizeof(LORA_SetRadioFrequency_CmdPayload_t));
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SET_STANDBY_MODE_CC,         &Radio->RadioIf, RADIO_IF_SetStandbyModeCmd,        sizeof(LORA_SetStandbyMode_CmdPayload_t));
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SET_PACKET_PARAMS_CC,        &Radio->RadioIf, RADIO_IF_SetPacketParamsCmd,       sizeof(LORA_SetPacketParams_CmdPayload_t));
+
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SEND_RADIO_STATS_TLM_CC,     &Radio->RadioDrv, RADIO_DRV_SendStatsTlmCmd,   0);
+   CMDMGR_RegisterFunc(CmdMgr, LORA_WRITE_RADIO_STATS_FILE_CC,   &Radio->RadioDrv, RADIO_DRV_WriteStatsFileCmd, sizeof(LORA_WriteRadioStatsFile_CmdPayload_t));
+
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SET_HOP_BLACKLIST_CC, &Radio->FreqHop, FREQ_HOP_SetBlacklistCmd, sizeof(LORA_SetHopBlacklist_CmdPayload_t));
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SEND_HOP_TLM_CC,      &Radio->FreqHop, FREQ_HOP_SendTlmCmd,      0);
+
+   CMDMGR_RegisterFunc(CmdMgr, LORA_START_TX_DEMO_CC, &Radio->LoraTx, LORA_TX_StartDemoCmd, 0);
+   CMDMGR_RegisterFunc(CmdMgr, LORA_STOP_TX_DEMO_CC,  &Radio->LoraTx, LORA_TX_StopDemoCmd,  0);
+   CMDMGR_RegisterFunc(CmdMgr, LORA_START_RX_DEMO_CC, &Radio->LoraRx, LORA_RX_StartDemoCmd, 0);
+   CMDMGR_RegisterFunc(CmdMgr, LORA_STOP_RX_DEMO_CC,  &Radio->LoraRx, LORA_RX_StopDemoCmd,  0);
+   CMDMGR_RegisterFunc(CmdMgr, LORA_START_RX_BRIDGE_CC, &Radio->LoraRx, LORA_RX_StartBridgeCmd, 0);
+   CMDMGR_RegisterFunc(CmdMgr, LORA_START_TX_BRIDGE_CC, &Radio->LoraTx, LORA_TX_StartBridgeCmd, 0);
+
+   CMDMGR_RegisterFunc(CmdMgr, LORA_START_TX_LINK_TEST_CC, &Radio->LoraTx,   LORA_TX_StartLinkTestCmd, sizeof(LORA_StartLinkTest_CmdPayload_t));
+   CMDMGR_RegisterFunc(CmdMgr, LORA_START_RX_LINK_TEST_CC, &Radio->LoraRx,   LORA_RX_StartLinkTestCmd, sizeof(LORA_StartLinkTest_CmdPayload_t));
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SEND_LINK_TEST_TLM_CC, &Radio->LinkTest, LINK_TEST_SendTlmCmd,     0);
+
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SET_RX_DUTY_CYCLE_CC, &Radio->RxDuty, RX_DUTY_SetPeriodCmd, sizeof(LORA_SetRxDutyCycle_CmdPayload_t));
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SEND_RX_DUTY_TLM_CC,  &Radio->RxDuty, RX_DUTY_SendTlmCmd,   0);
+
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SEND_LATENCY_TLM_CC,  &Radio->Latency, LATENCY_SendTlmCmd, 0);
+   CMDMGR_RegisterFunc(CmdMgr, LORA_SEND_LEN_OPT_TLM_CC,  &Radio->LenOpt,  LEN_OPT_SendTlmCmd, 0);
+
+} /* End RegisterRadioCmds() */
+
+
+/******************************************************************************
+** Function: StartStripe
+**
+** Start a striped transfer on the radios in RadioMask
+**
+** Notes:
+**   1. Each radio must exist, be idle on the transfer's side and not be
+**      hopping. The striped transfer must be started on the receiving node
+**      first.
+**   2. A radio whose task can't be started is released so the transfer
+**      ends when the others finish.
+**   3. Receiving radios on the same channel hear the same frames and
+**      the receive diversity combiner keeps one copy, see rx_div.h.
+**
+*/
+static bool StartStripe(LORA_StripeRole_Enum_t Role, uint8 RadioMask)
+{
+
+   LORA_APP_Radio_t *Radio;
+   const char *RoleStr = (Role == LORA_StripeRole_TX) ? "Tx" : "Rx";
+   bool   Busy;
+   bool   Started;
+   uint16 StartCnt = 0;
+   uint16 i;
+
+   if (RadioMask == 0 || (RadioMask >> LoraApp.RadioCnt) != 0)
+   {
+      CFE_EVS_SendEvent(LORA_APP_START_STRIPE_EID, CFE_EVS_EventType_ERROR,
+                        "Start %s stripe rejected, invalid radio mask 0x%02X for %d radio(s)",
+                        RoleStr, RadioMask, LoraApp.RadioCnt);
+      return false;
+   }
+
+   for (i=0; i < LoraApp.RadioCnt; i++)
+   {
+      if (RadioMask & (1 << i))
+      {
+         Radio = &LoraApp.Radio[i];
+         Busy  = (Role == LORA_StripeRole_TX) ? Radio->LoraTx.DemoActive : Radio->LoraRx.DemoActive;
+         if (Busy || FREQ_HOP_Enabled(&Radio->FreqHop))
+         {
+            CFE_EVS_SendEvent(LORA_APP_START_STRIPE_EID, CFE_EVS_EventType_ERROR,
+                              "Start %s stripe rejected, radio %d is %s", RoleStr, i,
+                              (Busy ? "busy" : "frequency hopping"));
+            return false;
+         }
+      }
+   }
+
+   if (!STRIPE_Start(STRIPE_OBJ, Role, RadioMask))
+   {
+      return false;
+   }
+
+   if (Role == LORA_StripeRole_RX)
+   {
+      RX_DIV_Start(RX_DIV_OBJ);
+   }
+
+   for (i=0; i < LoraApp.RadioCnt; i++)
+   {
+      if (RadioMask & (1 << i))
+      {
+         Radio   = &LoraApp.Radio[i];
+         Started = (Role == LORA_StripeRole_TX) ? LORA_TX_StartStripe(&Radio->LoraTx) :
+                                                  LORA_RX_StartStripe(&Radio->LoraRx);
+         if (Started)
+         {
+            StartCnt++;
+         }
+         else
+         {
+            STRIPE_RadioDone(STRIPE_OBJ, i);
+         }
+      }
+   }
+
+   return (StartCnt > 0);
+
+} /* End StartStripe() */
+
+
+/******************************************************************************
+** Functions: StartTxStripeCmd, StartRxStripeCmd
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**
+*/
+static bool StartTxStripeCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const LORA_StartStripe_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_StartTxStripe_t);
+
+   return StartStripe(LORA_StripeRole_TX, Cmd->RadioMask);
+
+} /* End StartTxStripeCmd() */
+
+static bool StartRxStripeCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const LORA_StartStripe_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_StartRxStripe_t);
+
+   return StartStripe(LORA_StripeRole_RX, Cmd->RadioMask);
+
+} /* End StartRxStripeCmd() */
+
+
+/******************************************************************************
+** Function: StartLoadGenCmd
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**   2. The forwarding radio must exist and be idle when messages are
+**      forwarded, and no other radio can be bridging since the forwarded
+**      messages go through the QoS scheduler. A run without forwarding
+**      only loads the command pipe and doesn't use a radio.
+**
+*/
+static bool StartLoadGenCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const LORA_StartLoadGen_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_StartLoadGen_t);
+   LORA_APP_Radio_t *Radio;
+
+   if (Cmd->ForwardPct > 0)
+   {
+      if (Cmd->Radio >= LoraApp.RadioCnt)
+      {
+         CFE_EVS_SendEvent(LORA_APP_START_LOAD_GEN_EID, CFE_EVS_EventType_ERROR,
+                           "Start load generator rejected, invalid radio %d for %d radio(s)",
+                           Cmd->Radio, LoraApp.RadioCnt);
+         return false;
+      }
+      if (LoraApp.Radio[Cmd->Radio].LoraTx.DemoActive)
+      {
+         CFE_EVS_SendEvent(LORA_APP_START_LOAD_GEN_EID, CFE_EVS_EventType_ERROR,
+                           "Start load generator rejected, radio %d is busy", Cmd->Radio);
+         return false;
+      }
+      if (!QOS_Start(QOS_OBJ, Cmd->Radio, false, false))
+      {
+         return false;
+      }
+   }
+
+   if (!LOAD_GEN_Start(LOAD_GEN_OBJ, Cmd))
+   {
+      if (Cmd->ForwardPct > 0)
+      {
+         QOS_Stop(QOS_OBJ);
+      }
+      return false;
+   }
+
+   if (Cmd->ForwardPct > 0)
+   {
+      Radio = &LoraApp.Radio[Cmd->Radio];
+      if (!LORA_TX_StartLoadGen(&Radio->LoraTx))
+      {
+         LOAD_GEN_StopCmd(LOAD_GEN_OBJ, NULL);
+         QOS_Stop(QOS_OBJ);
+         return false;
+      }
+   }
+
+   return true;
+
+} /* End StartLoadGenCmd() */
+
+
+/******************************************************************************
+** Function: ChildRadio
+**
+** Return the radio that owns ChildMgr
+**
+** Notes:
+**   1. The child manager task functions only receive the child manager so
+**      the radio is found from its address.
+**
+*/
+static LORA_APP_Radio_t *ChildRadio(const CHILDMGR_Class_t *ChildMgr)
+{
+
+   LORA_APP_Radio_t *Radio;
+   uint16 i;
+
+   for (i=0; i < LORA_RADIO_MAX; i++)
+   {
+      Radio = &LoraApp.Radio[i];
+      if (ChildMgr == &Radio->RadioChildMgr || ChildMgr == &Radio->RxChildMgr ||
+          ChildMgr == &Radio->TxChildMgr)
+      {
+         return Radio;
+      }
+   }
+
+   return NULL;
+
+} /* End ChildRadio() */
+
+
+/******************************************************************************
+** Functions: RadioChildTask, RxChildTask, TxChildTask
+**
+** Child manager task functions that run the radio's object task function
+**
+*/
+static bool RadioChildTask(CHILDMGR_Class_t *ChildMgr)
+{
+
+   return RADIO_TASK_ChildTask(&ChildRadio(ChildMgr)->RadioTask);
+
+} /* End RadioChildTask() */
+
+static bool RxChildTask(CHILDMGR_Class_t *ChildMgr)
+{
+
+   return LORA_RX_ChildTask(&ChildRadio(ChildMgr)->LoraRx);
+
+} /* End RxChildTask() */
+
+static bool TxChildTask(CHILDMGR_Class_t *ChildMgr)
+{
+
+   return LORA_TX_ChildTask(&ChildRadio(ChildMgr)->LoraTx);
+
+} /* End TxChildTask() */
+
+
+/******************************************************************************
+** Function: LoadGenChildTask
+**
+*/
+static bool LoadGenChildTask(CHILDMGR_Class_t *ChildMgr)
+{
+
+   return LOAD_GEN_ChildTask(LOAD_GEN_OBJ);
+
+} /* End LoadGenChildTask() */
+
+
+/******************************************************************************
+** Function: RxWriterChildTask
+**
+*/
+static bool RxWriterChildTask(CHILDMGR_Class_t *ChildMgr)
+{
+
+   return RX_WRITER_ChildTask(RX_WRITER_OBJ);
+
+} /* End RxWriterChildTask() */
+
+
 /******************************************************************************
 ** Function: ProcessCommands
 **
+** Notes:
+**   1. Pends for the first message and then polls until the pipe is empty or
+**      CmdBatchMax messages have been processed. The whole batch is inside
+**      one performance log entry/exit pair and the radio command completions
+**      are processed once per batch.
+**   2. SB releases a buffer on the next receive so each message is
+**      dispatched before the next one is read.
+**   3. Invalid message IDs are counted and reported in one event per batch
+**      so a flood of unexpected messages can't flood the event service.
+**   4. The pipe high-water mark is the largest batch. A batch that reaches
+**      CmdBatchMax is counted as limited because the pipe may have held more
+**      messages than were drained.
+**
 */
 static int32 ProcessCommands(void)
 {
 
    int32  RetStatus = CFE_ES_RunStatus_APP_RUN;
    int32  SysStatus;
+   uint32 MsgCnt = 0;
+   uint32 BatchUsec;
+   uint16 i;
 
    CFE_SB_Buffer_t* SbBufPtr;
-   CFE_SB_MsgId_t   MsgId = CFE_SB_INVALID_MSG_ID;
+   OS_time_t        StartTime;
+   OS_time_t        EndTime;
    
 
+   LoraApp.BatchInvalidMidCnt = 0;
+   
    CFE_ES_PerfLogExit(LoraApp.PerfId);
    SysStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, LoraApp.CmdPipe, CFE_SB_PEND_FOREVER);
    CFE_ES_PerfLogEntry(LoraApp.PerfId);
 
-   if (SysStatus == CFE_SUCCESS)
+   OS_GetLocalTime(&StartTime);
+   
+   while (SysStatus == CFE_SUCCESS)
    {
       
-      SysStatus = CFE_MSG_GetMsgId(&SbBufPtr->Msg, &MsgId);
+      ProcessMsg(SbBufPtr);
+      
+      if (++MsgCnt >= LoraApp.CmdBatchMax)
+      {
+         LoraApp.CmdBatchLimitCnt++;
+         break;
+      }
+      
+      SysStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, LoraApp.CmdPipe, CFE_SB_POLL);
    
-      if (SysStatus == CFE_SUCCESS)
+   } /* End batch loop */ 
+   
+   if (MsgCnt > 0)
+   {
+      
+      if (LoraApp.BatchInvalidMidCnt > 0)
       {
-  
-         if (CFE_SB_MsgId_Equal(MsgId, LoraApp.CmdMid)) 
-         {
-            
-            CMDMGR_DispatchFunc(CMDMGR_OBJ, &SbBufPtr->Msg);
-         
-         } 
-         else if (CFE_SB_MsgId_Equal(MsgId, LoraApp.OneHzMid))
-         {
-
-            SendStatusTlm();
-            
-         }
-         else
-         {
-            
-            CFE_EVS_SendEvent(LORA_APP_INVALID_MID_EID, CFE_EVS_EventType_ERROR,
-                              "Received invalid command packet, MID = 0x%04X",
-                              CFE_SB_MsgIdToValue(MsgId));
-         } 
+         CFE_EVS_SendEvent(LORA_APP_INVALID_MID_EID, CFE_EVS_EventType_ERROR,
+                           "Received %d invalid command packet(s), last MID = 0x%04X",
+                           LoraApp.BatchInvalidMidCnt, CFE_SB_MsgIdToValue(LoraApp.BatchInvalidMid));
+      }
+      
+      for (i=0; i < LoraApp.RadioCnt; i++)
+      {
+         RADIO_TASK_ProcessCmdCompletions(&LoraApp.Radio[i].RadioTask);
+      }
 
+      OS_GetLocalTime(&EndTime);
+      BatchUsec = (uint32)OS_TimeGetTotalMicroseconds(OS_TimeSubtract(EndTime, StartTime));
+      
+      LoraApp.CmdBatchCnt++;
+      LoraApp.CmdMsgCnt += MsgCnt;
+      LoraApp.CmdBatchUsecSum += BatchUsec;
+      LoraApp.CmdBatchLastUsec = BatchUsec;
+      if (BatchUsec > LoraApp.CmdBatchMaxUsec)
+      {
+         LoraApp.CmdBatchMaxUsec = BatchUsec;
       }
-      else
+      if (MsgCnt > LoraApp.CmdPipeHighWater)
       {
-         
-         CFE_EVS_SendEvent(LORA_APP_INVALID_MID_EID, CFE_EVS_EventType_ERROR,
-                           "CFE couldn't retrieve message ID from the message, Status = %d", SysStatus);
+         LoraApp.CmdPipeHighWater = MsgCnt;
       }
+      LORA_METRICS_SetPeak(0, LORA_METRICS_TASK_APP, LORA_METRICS_CMD_PIPE_PEAK, MsgCnt);
       
-   } /* Valid SB receive */ 
-   else 
+   } /* End if messages processed */
+   
+   if (SysStatus != CFE_SUCCESS && SysStatus != CFE_SB_NO_MESSAGE)
    {
    
-         CFE_ES_WriteToSysLog("LORA App software bus error. Status = 0x%08X\n", SysStatus);   /* Use SysLog, events may not be working */
-         RetStatus = CFE_ES_RunStatus_APP_ERROR;
+      CFE_ES_WriteToSysLog("LORA App software bus error. Status = 0x%08X\n", SysStatus);   /* Use SysLog, events may not be working */
+      RetStatus = CFE_ES_RunStatus_APP_ERROR;
+   
    }  
       
    return RetStatus;
@@ -326,6 +884,83 @@ static int32 ProcessCommands(void)
 } /* End ProcessCommands() */
 
 
+/******************************************************************************
+** Function: ProcessMsg
+**
+** Dispatch one message received on the command pipe
+**
+*/
+static void ProcessMsg(const CFE_SB_Buffer_t *SbBufPtr)
+{
+
+   int32  SysStatus;
+   uint16 i;
+   CFE_SB_MsgId_t MsgId = CFE_SB_INVALID_MSG_ID;
+   
+   
+   SysStatus = CFE_MSG_GetMsgId(&SbBufPtr->Msg, &MsgId);
+   
+   if (SysStatus == CFE_SUCCESS)
+   {
+  
+      if (CFE_SB_MsgId_Equal(MsgId, LoraApp.CmdMid)) 
+      {
+            
+         CMDMGR_DispatchFunc(CMDMGR_OBJ, &SbBufPtr->Msg);
+         
+      } 
+      else if (CFE_SB_MsgId_Equal(MsgId, LoraApp.OneHzMid))
+      {
+
+         SendStatusTlm();
+         EVT_SUM_Tick();
+         QOS_Manage(QOS_OBJ);
+         RELAY_Manage(RELAY_OBJ);
+            
+      }
+      else if (CFE_SB_MsgId_Equal(MsgId, LoraApp.LoadGenMid))
+      {
+
+         LOAD_GEN_ProcessMsg(LOAD_GEN_OBJ, &SbBufPtr->Msg);
+
+      }
+      else if (QOS_Bridged(QOS_OBJ, MsgId))
+      {
+
+         QOS_Enqueue(QOS_OBJ, &SbBufPtr->Msg, 0);
+
+      }
+      else
+      {
+            
+         for (i=1; i < LoraApp.RadioCnt; i++)
+         {
+            if (CFE_SB_MsgId_Equal(MsgId, LoraApp.Radio[i].CmdMid))
+            {
+               CMDMGR_DispatchFunc(&LoraApp.Radio[i].CmdMgr, &SbBufPtr->Msg);
+               break;
+            }
+         }
+         
+         if (i >= LoraApp.RadioCnt)
+         {
+            LoraApp.BatchInvalidMidCnt++;
+            LoraApp.BatchInvalidMid = MsgId;
+         }
+            
+      } 
+
+   }
+   else
+   {
+         
+      CFE_EVS_SendEvent(LORA_APP_INVALID_MID_EID, CFE_EVS_EventType_ERROR,
+                        "CFE couldn't retrieve message ID from the message, Status = %d", SysStatus);
+   }
+
+} /* End ProcessMsg() */
+
+
 /******************************************************************************
 ** Function: SendStatusTlm
 **
@@ -334,9 +969,23 @@ static void SendStatusTlm(void)
 {
    
    LORA_StatusTlm_Payload_t *StatusTlmPayload = &LoraApp.StatusTlm.Payload;
+   LORA_METRICS_Sample_t    Metrics;
+   uint16 i;
    
    StatusTlmPayload->ValidCmdCnt   = LoraApp.CmdMgr.ValidCmdCnt;
    StatusTlmPayload->InvalidCmdCnt = LoraApp.CmdMgr.InvalidCmdCnt;
+   StatusTlmPayload->RxDemoActive  = false;
+   StatusTlmPayload->TxDemoActive  = false;
+   for (i=0; i < LoraApp.RadioCnt; i++)
+   {
+      if (i > 0)
+      {
+         StatusTlmPayload->ValidCmdCnt   += LoraApp.Radio[i].CmdMgr.ValidCmdCnt;
+         StatusTlmPayload->InvalidCmdCnt += LoraApp.Radio[i].CmdMgr.InvalidCmdCnt;
+      }
+      StatusTlmPayload->RxDemoActive |= LoraApp.Radio[i].LoraRx.DemoActive;
+      StatusTlmPayload->TxDemoActive |= LoraApp.Radio[i].LoraTx.DemoActive;
+   }
 
    /*
    ** Radio Interface Object
@@ -345,19 +994,37 @@ static void SendStatusTlm(void)
    StatusTlmPayload->RadioInit = SX128X_Initialized();
 
    /*
-   ** Rx Object
+   ** Rx and Tx Objects. Demo active is set if any radio's demo is active
+   ** and the counts are totals over all radios.
    */ 
 
-   StatusTlmPayload->RxPktCnt    = LoraApp.LoraRx.PktCnt;
-   StatusTlmPayload->RxPktErrCnt = LoraApp.LoraRx.PktErrCnt;
+   LORA_METRICS_Sample(&Metrics);
+   
+   StatusTlmPayload->RxPktCnt     = Metrics.RxFrameCnt;
+   StatusTlmPayload->RxPktErrCnt  = Metrics.RxErrCnt;
+   
+   StatusTlmPayload->TxPktCnt     = Metrics.TxFrameCnt;
+   StatusTlmPayload->TxPktErrCnt  = Metrics.TxErrCnt;
+
+   StatusTlmPayload->TxGoodputBps   = Metrics.TxGoodputBps;
+   StatusTlmPayload->RxGoodputBps   = Metrics.RxGoodputBps;
+   StatusTlmPayload->AirtimePpt     = Metrics.AirtimePpt;
+   StatusTlmPayload->RetransmitPpt  = Metrics.RetransmitPpt;
+   StatusTlmPayload->RadioQueuePeak = Metrics.RadioQueuePeak;
+   StatusTlmPayload->CmdPipePeak    = Metrics.CmdPipePeak;
 
    /*
-   ** Tx Object
+   ** Command Pipe
    */ 
    
-   StatusTlmPayload->TxDemoActive = LoraApp.LoraTx.DemoActive;
-   StatusTlmPayload->TxPktCnt     = LoraApp.LoraTx.PktCnt;
-   StatusTlmPayload->TxPktErrCnt  = LoraApp.LoraTx.PktErrCnt;
+   StatusTlmPayload->CmdBatchMax      = LoraApp.CmdBatchMax;
+   StatusTlmPayload->CmdBatchCnt      = LoraApp.CmdBatchCnt;
+   StatusTlmPayload->CmdBatchLimitCnt = LoraApp.CmdBatchLimitCnt;
+   StatusTlmPayload->CmdPipeHighWater = LoraApp.CmdPipeHighWater;
+   StatusTlmPayload->CmdBatchLastUsec = LoraApp.CmdBatchLastUsec;
+   StatusTlmPayload->CmdBatchMaxUsec  = LoraApp.CmdBatchMaxUsec;
+   StatusTlmPayload->CmdBatchAvgUsec  = (LoraApp.CmdBatchCnt > 0) ? (uint32)(LoraApp.CmdBatchUsecSum/LoraApp.CmdBatchCnt) : 0;
+   StatusTlmPayload->CmdMsgCnt        = LoraApp.CmdMsgCnt;
       
    CFE_SB_TimeStampMsg(CFE_MSG_PTR(LoraApp.StatusTlm.TelemetryHeader));
    CFE_SB_TransmitMsg(CFE_MSG_PTR(LoraApp.StatusTlm.TelemetryHeader), true);
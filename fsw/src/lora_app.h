@@ -28,7 +28,25 @@
 */
 
 #include "app_cfg.h"
+#include "evt_sum.h"
+#include "frame_trace.h"
+#include "freq_hop.h"
+#include "latency.h"
+#include "len_opt.h"
+#include "link_test.h"
+#include "load_gen.h"
+#include "lora_metrics.h"
+#include "qos.h"
+#include "radio_drv.h"
+#include "radio_inst.h"
 #include "radio_if.h"
+#include "radio_task.h"
+#include "relay.h"
+#include "rx_div.h"
+#include "rx_duty.h"
+#include "rx_writer.h"
+#include "store.h"
+#include "stripe.h"
 #include "lora_rx.h"
 #include "lora_tx.h"
 
@@ -44,6 +62,8 @@
 #define LORA_APP_NOOP_EID        (LORA_APP_BASE_EID + 1)
 #define LORA_APP_EXIT_EID        (LORA_APP_BASE_EID + 2)
 #define LORA_APP_INVALID_MID_EID (LORA_APP_BASE_EID + 3)
+#define LORA_APP_START_STRIPE_EID (LORA_APP_BASE_EID + 4)
+#define LORA_APP_START_LOAD_GEN_EID (LORA_APP_BASE_EID + 5)
 
 
 /**********************/
@@ -53,6 +73,36 @@
 // Command and Tlemetry packets are defined in lora_tx.xml
 
 
+/******************************************************************************
+** LORA_APP_Radio
+**
+** Objects and child tasks serving one radio. Radio 0's commands use the app's
+** command manager and topic, the other radios have their own.
+*/
+typedef struct
+{
+
+   RADIO_INST_Cfg_t   Inst;
+   CMDMGR_Class_t     CmdMgr;
+   CFE_SB_MsgId_t     CmdMid;
+   CHILDMGR_Class_t   RadioChildMgr;
+   CHILDMGR_Class_t   RxChildMgr;
+   CHILDMGR_Class_t   TxChildMgr;
+
+   RADIO_DRV_Class_t  RadioDrv;
+   RADIO_TASK_Class_t RadioTask;
+   RADIO_IF_Class_t   RadioIf;
+   FREQ_HOP_Class_t   FreqHop;
+   LINK_TEST_Class_t  LinkTest;
+   RX_DUTY_Class_t    RxDuty;
+   LATENCY_Class_t    Latency;
+   LEN_OPT_Class_t    LenOpt;
+   LORA_RX_Class_t    LoraRx;
+   LORA_TX_Class_t    LoraTx;
+
+} LORA_APP_Radio_t;
+
+
 /******************************************************************************
 ** LORA_Class
 */
@@ -66,8 +116,8 @@ typedef struct
    INITBL_Class_t    IniTbl;
    CFE_SB_PipeId_t   CmdPipe;
    CMDMGR_Class_t    CmdMgr;
-   CHILDMGR_Class_t  RxChildMgr;
-   CHILDMGR_Class_t  TxChildMgr;
+   CHILDMGR_Class_t  LoadGenChildMgr;
+   CHILDMGR_Class_t  RxWriterChildMgr;
    
    /*
    ** Telemetry Packets
@@ -82,10 +132,32 @@ typedef struct
    uint32             PerfId;
    CFE_SB_MsgId_t     CmdMid;
    CFE_SB_MsgId_t     OneHzMid;
+   CFE_SB_MsgId_t     LoadGenMid;
    
-   RADIO_IF_Class_t   RadioIf;
-   LORA_RX_Class_t    LoraRx;
-   LORA_TX_Class_t    LoraTx;
+   uint32             CmdBatchMax;       /* Messages processed per wakeup, 1 is one message at a time */
+   uint32             CmdBatchCnt;
+   uint32             CmdMsgCnt;
+   uint32             CmdBatchLimitCnt;  /* Batches that reached CmdBatchMax */
+   uint32             CmdPipeHighWater;  /* Largest batch */
+   uint32             CmdBatchLastUsec;
+   uint32             CmdBatchMaxUsec;
+   uint64             CmdBatchUsecSum;
+   uint32             BatchInvalidMidCnt;
+   CFE_SB_MsgId_t     BatchInvalidMid;
+   
+   LORA_METRICS_Class_t Metrics;
+   FRAME_TRACE_Class_t  FrameTrace;
+   EVT_SUM_Class_t      EvtSum;
+   STRIPE_Class_t       Stripe;
+   RX_DIV_Class_t       RxDiv;
+   RX_WRITER_Class_t    RxWriter;
+   STORE_Class_t        Store;
+   QOS_Class_t          Qos;
+   LOAD_GEN_Class_t     LoadGen;
+   RELAY_Class_t        Relay;
+   
+   uint8                RadioCnt;
+   LORA_APP_Radio_t     Radio[LORA_RADIO_MAX];
   
 } LORA_APP_Class_t;
 
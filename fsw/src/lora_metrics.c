@@ -0,0 +1,252 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the Metrics Registry Class methods
+**
+**  Notes:
+**    1. See lora_metrics.h file prologue.
+**    2. Relaxed ordering is sufficient because each counter is independent
+**       and a sample only needs every update to show up eventually.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "lora_metrics.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static uint32 Rate(uint32 Delta, uint32 Scale, uint64 IntervalUsec);
+static uint32 SumCounter(LORA_METRICS_Counter_t Counter);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static LORA_METRICS_Class_t *LoraMetrics = NULL;
+
+
+/******************************************************************************
+** Function: LORA_METRICS_Constructor
+**
+** Initialize the Metrics object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void LORA_METRICS_Constructor(LORA_METRICS_Class_t *LoraMetricsPtr)
+{
+
+   LORA_METRICS_Slot_t *Slot;
+   uint16 Radio;
+   uint16 Task;
+   uint16 i;
+
+   LoraMetrics = LoraMetricsPtr;
+
+   memset(LoraMetrics, 0, sizeof(LORA_METRICS_Class_t));
+
+   for (Radio=0; Radio < LORA_RADIO_MAX; Radio++)
+   {
+      for (Task=0; Task < LORA_METRICS_TASK_CNT; Task++)
+      {
+         Slot = &LoraMetrics->Slot[Radio][Task];
+         for (i=0; i < LORA_METRICS_COUNTER_CNT; i++)
+         {
+            atomic_init(&Slot->Counter[i], 0);
+         }
+         for (i=0; i < LORA_METRICS_GAUGE_CNT; i++)
+         {
+            atomic_init(&Slot->Gauge[i], 0);
+         }
+      }
+   }
+
+   OS_GetLocalTime(&LoraMetrics->PrevTime);
+
+} /* End LORA_METRICS_Constructor() */
+
+
+/******************************************************************************
+** Function: LORA_METRICS_ResetStatus
+**
+*/
+void LORA_METRICS_ResetStatus(void)
+{
+
+   uint16 i;
+
+   for (i=0; i < LORA_METRICS_COUNTER_CNT; i++)
+   {
+      LoraMetrics->Base[i] = SumCounter(i);
+   }
+
+} /* End LORA_METRICS_ResetStatus() */
+
+
+/******************************************************************************
+** Function: LORA_METRICS_Add
+**
+*/
+void LORA_METRICS_Add(uint8 Radio, LORA_METRICS_Task_t Task, LORA_METRICS_Counter_t Counter, uint32 Value)
+{
+
+   atomic_fetch_add_explicit(&LoraMetrics->Slot[Radio][Task].Counter[Counter], Value, memory_order_relaxed);
+
+} /* End LORA_METRICS_Add() */
+
+
+/******************************************************************************
+** Function: LORA_METRICS_SetPeak
+**
+** Notes:
+**   1. The compare and exchange only retries if the sampler cleared the
+**      gauge between the load and the exchange.
+**
+*/
+void LORA_METRICS_SetPeak(uint8 Radio, LORA_METRICS_Task_t Task, LORA_METRICS_Gauge_t Gauge, uint32 Value)
+{
+
+   atomic_uint *GaugePtr = &LoraMetrics->Slot[Radio][Task].Gauge[Gauge];
+   unsigned int Peak = atomic_load_explicit(GaugePtr, memory_order_relaxed);
+
+   while (Value > Peak &&
+          !atomic_compare_exchange_weak_explicit(GaugePtr, &Peak, Value, memory_order_relaxed, memory_order_relaxed));
+
+} /* End LORA_METRICS_SetPeak() */
+
+
+/******************************************************************************
+** Function: LORA_METRICS_Sample
+**
+*/
+void LORA_METRICS_Sample(LORA_METRICS_Sample_t *Sample)
+{
+
+   uint16    Radio;
+   uint16    Task;
+   uint16    i;
+   uint32    Total[LORA_METRICS_COUNTER_CNT];
+   uint32    Delta[LORA_METRICS_COUNTER_CNT];
+   uint32    Peak[LORA_METRICS_GAUGE_CNT];
+   uint32    Value;
+   uint64    IntervalUsec;
+   OS_time_t CurrentTime;
+
+   OS_GetLocalTime(&CurrentTime);
+   IntervalUsec = OS_TimeGetTotalMicroseconds(OS_TimeSubtract(CurrentTime, LoraMetrics->PrevTime));
+   LoraMetrics->PrevTime = CurrentTime;
+
+   for (i=0; i < LORA_METRICS_COUNTER_CNT; i++)
+   {
+      Total[i] = SumCounter(i);
+      Delta[i] = Total[i] - LoraMetrics->Prev[i];
+      LoraMetrics->Prev[i] = Total[i];
+   }
+
+   for (i=0; i < LORA_METRICS_GAUGE_CNT; i++)
+   {
+      Peak[i] = 0;
+      for (Radio=0; Radio < LORA_RADIO_MAX; Radio++)
+      {
+         for (Task=0; Task < LORA_METRICS_TASK_CNT; Task++)
+         {
+            Value = atomic_exchange_explicit(&LoraMetrics->Slot[Radio][Task].Gauge[i], 0, memory_order_relaxed);
+            if (Value > Peak[i])
+            {
+               Peak[i] = Value;
+            }
+         }
+      }
+   }
+
+   Sample->TxFrameCnt = Total[LORA_METRICS_TX_FRAME] - LoraMetrics->Base[LORA_METRICS_TX_FRAME];
+   Sample->TxErrCnt   = Total[LORA_METRICS_TX_ERR]   - LoraMetrics->Base[LORA_METRICS_TX_ERR];
+   Sample->RxFrameCnt = Total[LORA_METRICS_RX_FRAME] - LoraMetrics->Base[LORA_METRICS_RX_FRAME];
+   Sample->RxErrCnt   = Total[LORA_METRICS_RX_ERR]   - LoraMetrics->Base[LORA_METRICS_RX_ERR];
+
+   Sample->TxGoodputBps = Rate(Delta[LORA_METRICS_TX_DATA_BYTE], 8000000, IntervalUsec);
+   Sample->RxGoodputBps = Rate(Delta[LORA_METRICS_RX_DATA_BYTE], 8000000, IntervalUsec);
+   Sample->AirtimePpt   = (uint16)Rate(Delta[LORA_METRICS_TX_AIR_USEC] + Delta[LORA_METRICS_RX_AIR_USEC],
+                                       1000, IntervalUsec);
+
+   Sample->RetransmitPpt = 0;
+   if (Delta[LORA_METRICS_TX_FRAME] > 0)
+   {
+      Sample->RetransmitPpt = (uint16)(((uint64)Delta[LORA_METRICS_TX_RETRANSMIT]*1000) / Delta[LORA_METRICS_TX_FRAME]);
+   }
+
+   Sample->RadioQueuePeak = (uint16)Peak[LORA_METRICS_RADIO_QUEUE_PEAK];
+   Sample->CmdPipePeak    = (uint16)Peak[LORA_METRICS_CMD_PIPE_PEAK];
+
+} /* End LORA_METRICS_Sample() */
+
+
+/******************************************************************************
+** Function: Rate
+**
+** Return Delta*Scale per IntervalUsec
+**
+*/
+static uint32 Rate(uint32 Delta, uint32 Scale, uint64 IntervalUsec)
+{
+
+   if (IntervalUsec == 0)
+   {
+      return 0;
+   }
+
+   return (uint32)(((uint64)Delta*Scale) / IntervalUsec);
+
+} /* End Rate() */
+
+
+/******************************************************************************
+** Function: SumCounter
+**
+** Return the sum of a counter over every radio and task
+**
+*/
+static uint32 SumCounter(LORA_METRICS_Counter_t Counter)
+{
+
+   uint16 Radio;
+   uint16 Task;
+   uint32 Total = 0;
+
+   for (Radio=0; Radio < LORA_RADIO_MAX; Radio++)
+   {
+      for (Task=0; Task < LORA_METRICS_TASK_CNT; Task++)
+      {
+         Total += atomic_load_explicit(&LoraMetrics->Slot[Radio][Task].Counter[Counter], memory_order_relaxed);
+      }
+   }
+
+   return Total;
+
+} /* End SumCounter() */
@@ -0,0 +1,207 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the metrics registry class
+**
+**  Notes:
+**    1. Each radio's tasks update counters and gauges in their own slot. Slots are
+**       aligned to a cache line so tasks never write to the same line and
+**       an update is a single relaxed atomic operation with no locks.
+**    2. Only the main task samples the registry. A sample sums every slot
+**       and computes rates from the change since the previous sample so
+**       the writers never reset anything.
+**    3. Counters are 32 bits so they're lock-free on every target. They
+**       wrap but the unsigned sample deltas stay correct as long as a
+**       counter changes by less than 2^32 between samples.
+**    4. Gauges hold the peak value since the last sample. The sampler
+**       clears them so each sample reports the peak of its own interval.
+**    5. A sample combines all of the radios. The main task's slot is
+**       radio 0's LORA_METRICS_TASK_APP.
+**
+*/
+
+#ifndef _lora_metrics_
+#define _lora_metrics_
+
+/*
+** Includes
+*/
+
+#include <stdatomic.h>
+#include "app_cfg.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define LORA_METRICS_CACHE_LINE_LEN  64
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+typedef enum
+{
+
+   LORA_METRICS_TASK_APP = 0,
+   LORA_METRICS_TASK_RADIO,
+   LORA_METRICS_TASK_TX,
+   LORA_METRICS_TASK_RX,
+   LORA_METRICS_TASK_CNT
+
+} LORA_METRICS_Task_t;
+
+
+typedef enum
+{
+
+   LORA_METRICS_TX_FRAME = 0,
+   LORA_METRICS_TX_ERR,
+   LORA_METRICS_TX_DATA_BYTE,     /* Frame data excluding the frame header */
+   LORA_METRICS_TX_RETRANSMIT,    /* Frames sent again after a failed attempt */
+   LORA_METRICS_RX_FRAME,
+   LORA_METRICS_RX_ERR,
+   LORA_METRICS_RX_DATA_BYTE,
+   LORA_METRICS_TX_AIR_USEC,      /* Computed time on air of sent frames */
+   LORA_METRICS_RX_AIR_USEC,      /* Computed time on air of received frames */
+   LORA_METRICS_COUNTER_CNT
+
+} LORA_METRICS_Counter_t;
+
+
+typedef enum
+{
+
+   LORA_METRICS_RADIO_QUEUE_PEAK = 0,   /* Radio task requests waiting to be served */
+   LORA_METRICS_CMD_PIPE_PEAK,          /* Command pipe messages drained in one batch */
+   LORA_METRICS_GAUGE_CNT
+
+} LORA_METRICS_Gauge_t;
+
+
+typedef struct
+{
+
+   _Alignas(LORA_METRICS_CACHE_LINE_LEN) atomic_uint Counter[LORA_METRICS_COUNTER_CNT];
+   atomic_uint Gauge[LORA_METRICS_GAUGE_CNT];
+
+} LORA_METRICS_Slot_t;
+
+
+typedef struct
+{
+
+   uint32  TxFrameCnt;       /* Since the last reset */
+   uint32  TxErrCnt;
+   uint32  RxFrameCnt;
+   uint32  RxErrCnt;
+
+   uint32  TxGoodputBps;     /* Rates over the last sample interval */
+   uint32  RxGoodputBps;
+   uint16  AirtimePpt;       /* Parts per thousand of the interval the radio was on air */
+   uint16  RetransmitPpt;    /* Parts per thousand of the frames sent */
+   uint16  RadioQueuePeak;
+   uint16  CmdPipePeak;
+
+} LORA_METRICS_Sample_t;
+
+
+/******************************************************************************
+** LORA_METRICS_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Class State Data
+   */
+
+   LORA_METRICS_Slot_t Slot[LORA_RADIO_MAX][LORA_METRICS_TASK_CNT];
+
+   /* Only accessed by the sampling task */
+   uint32     Prev[LORA_METRICS_COUNTER_CNT];
+   uint32     Base[LORA_METRICS_COUNTER_CNT];
+   OS_time_t  PrevTime;
+
+} LORA_METRICS_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: LORA_METRICS_Constructor
+**
+** Initialize the Metrics object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function and before the
+**      child tasks are created.
+**
+*/
+void LORA_METRICS_Constructor(LORA_METRICS_Class_t *LoraMetricsPtr);
+
+
+/******************************************************************************
+** Function: LORA_METRICS_ResetStatus
+**
+** Reset the counts reported by LORA_METRICS_Sample() to zero
+**
+** Notes:
+**   1. Must be called by the sampling task. The counters keep running and
+**      the current totals become the new baseline.
+**
+*/
+void LORA_METRICS_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: LORA_METRICS_Add
+**
+** Add Value to one of the calling task's counters
+**
+*/
+void LORA_METRICS_Add(uint8 Radio, LORA_METRICS_Task_t Task, LORA_METRICS_Counter_t Counter, uint32 Value);
+
+
+/******************************************************************************
+** Function: LORA_METRICS_SetPeak
+**
+** Raise one of the calling task's gauges to Value if it's below Value
+**
+*/
+void LORA_METRICS_SetPeak(uint8 Radio, LORA_METRICS_Task_t Task, LORA_METRICS_Gauge_t Gauge, uint32 Value);
+
+
+/******************************************************************************
+** Function: LORA_METRICS_Sample
+**
+** Sum the slots and compute the rates since the previous sample
+**
+** Notes:
+**   1. Must only be called by one task. The first sample's rates cover the
+**      time since the constructor.
+**
+*/
+void LORA_METRICS_Sample(LORA_METRICS_Sample_t *Sample);
+
+
+#endif /* _lora_metrics_ */
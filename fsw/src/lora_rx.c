@@ -24,6 +24,15 @@
 ** Includes
 */
 
+#include <stdlib.h>
+#include "frame_trace.h"
+#include "evt_sum.h"
+#include "freq_hop.h"
+#include "link_test.h"
+#include "lora_frame.h"
+#include "lora_metrics.h"
+#include "radio_if.h"
+#include "rx_duty.h"
 #include "lora_rx.h"
 
 
@@ -41,12 +50,15 @@
 /** Local File Function Prototypes **/
 /************************************/
 
-
-/*****************/
-/** Global Data **/
-/*****************/
-
-static LORA_RX_Class_t *LoraRx;
+static bool ReceiveDemoFile(LORA_RX_Class_t *LoraRx);
+static bool ReceiveLinkTest(LORA_RX_Class_t *LoraRx);
+static void ReceiveStripe(LORA_RX_Class_t *LoraRx);
+static void ReceiveBridge(LORA_RX_Class_t *LoraRx);
+static bool ReceiveFrame(LORA_RX_Class_t *LoraRx, uint8 *Frame, uint8 *FrameLen, LORA_FRAME_Hdr_t *FrameHdr,
+                         uint16 *HdrLen, uint32 *FrameIdx, uint32 MaxTimeoutMs);
+static void SendReport(LORA_RX_Class_t *LoraRx, uint16 Seq, uint16 SegRcvdCnt);
+static HDR_COMP_Class_t *SrcHdrExp(LORA_RX_Class_t *LoraRx, uint8 Src);
+static void StartReceive(LORA_RX_Class_t *LoraRx);
 
 
 /******************************************************************************
@@ -58,13 +70,58 @@ static LORA_RX_Class_t *LoraRx;
 **   1. This must be called prior to any other member functions.
 **
 */
-void LORA_RX_Constructor(LORA_RX_Class_t *LoraRxPtr)
+void LORA_RX_Constructor(LORA_RX_Class_t *LoraRx, INITBL_Class_t *IniTbl,
+                         const RADIO_INST_Cfg_t *Inst, RADIO_TASK_Class_t *RadioTask,
+                         RADIO_IF_Class_t *RadioIf, FREQ_HOP_Class_t *FreqHop,
+                         LINK_TEST_Class_t *LinkTest, RX_DUTY_Class_t *RxDuty,
+                         LATENCY_Class_t *Latency, LEN_OPT_Class_t *LenOpt, STRIPE_Class_t *Stripe,
+                         RX_DIV_Class_t *RxDiv, STORE_Class_t *Store, RX_WRITER_Class_t *RxWriter,
+                         RELAY_Class_t *Relay)
 {
 
-   LoraRx = LoraRxPtr;
-   
+   int32  SysStatus;
+   char   SemName[OS_MAX_API_NAME];
+   uint16 i;
+
    memset(LoraRx, 0, sizeof(LORA_RX_Class_t));
    
+   LoraRx->RadioTask = RadioTask;
+   LoraRx->RadioIf   = RadioIf;
+   LoraRx->FreqHop   = FreqHop;
+   LoraRx->LinkTest  = LinkTest;
+   LoraRx->RxDuty    = RxDuty;
+   LoraRx->Latency   = Latency;
+   LoraRx->LenOpt    = LenOpt;
+   LoraRx->Stripe    = Stripe;
+   LoraRx->RxDiv     = RxDiv;
+   LoraRx->Store     = Store;
+   LoraRx->RxWriter  = RxWriter;
+   LoraRx->Relay     = Relay;
+   LoraRx->Radio     = Inst->Index;
+
+   RADIO_INST_Path(LoraRx->DemoFile, sizeof(LoraRx->DemoFile), INITBL_GetStrConfig(IniTbl, CFG_RX_DEMO_FILE), Inst);
+   RADIO_INST_Name(SemName, sizeof(SemName), INITBL_GetStrConfig(IniTbl, CFG_RX_CHILD_SEM_NAME), Inst);
+   LoraRx->HopGuardMs = INITBL_GetIntConfig(IniTbl, CFG_HOP_SLOT_GUARD_MS);
+
+   HDR_COMP_Constructor(&LoraRx->HdrExp, sizeof(CFE_MSG_TelemetryHeader_t), sizeof(CFE_MSG_Message_t),
+                        INITBL_GetIntConfig(IniTbl, CFG_HDR_COMP_REFRESH_CNT));
+   HDR_COMP_Constructor(&LoraRx->StoreHdrExp, sizeof(CFE_MSG_TelemetryHeader_t), sizeof(CFE_MSG_Message_t),
+                        INITBL_GetIntConfig(IniTbl, CFG_HDR_COMP_REFRESH_CNT));
+   for (i=0; i < LORA_RX_MAX_SRC; i++)
+   {
+      HDR_COMP_Constructor(&LoraRx->SrcHdrExp[i], sizeof(CFE_MSG_TelemetryHeader_t), sizeof(CFE_MSG_Message_t),
+                           INITBL_GetIntConfig(IniTbl, CFG_HDR_COMP_REFRESH_CNT));
+   }
+   TLM_PACK_Constructor(&LoraRx->TlmUnpack, IniTbl);
+
+   SysStatus = OS_CountSemCreate(&LoraRx->WakeUpSemaphore, SemName, 0, 0);
+   
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent (LORA_RX_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                         "Rx child error creating semaphore %s, Status = %d", SemName, SysStatus);
+   }
+
 } /* End LORA_RX_Constructor() */
 
 
@@ -73,20 +130,43 @@ void LORA_RX_Constructor(LORA_RX_Class_t *LoraRxPtr)
 **
 ** Notes:
 **   1. Returning false causes the child task to terminate.
-**   2. Information events are sent because this is instructional code and the
-**      events provide feedback. The events are filtered so they won't flood
-**      the ground. A reset app command resets the event filter.  
+**   2. The waiting for semaphore information event is instructional
+**      feedback. It's summarized so it can't flood the ground.
 */
-bool LORA_RX_ChildTask(CHILDMGR_Class_t *ChildMgr)
+bool LORA_RX_ChildTask(LORA_RX_Class_t *LoraRx)
 {
 
-   // TODO: Add Rx child task logic (see end of file) May not need a child task if callbacks from driver are used
-   while (true)
+   LoraRx->RunStatus = CFE_SUCCESS;
+   
+   while (LoraRx->RunStatus == CFE_SUCCESS)
    {  
-      LoraRx->PktCnt++;
-      CFE_EVS_SendEvent (LORA_RX_CHILD_TASK_EID, CFE_EVS_EventType_INFORMATION,
-                         "Rx child task execution. Msgcnt = %d", LoraRx->PktCnt);
-      OS_TaskDelay(2000);
+      EVT_SUM_Count(EVT_SUM_RX_CHILD_WAIT, LoraRx->RunStatus);
+      LoraRx->RunStatus = OS_CountSemTake(LoraRx->WakeUpSemaphore);  // Pend until parent app gives semaphore
+
+      if (RADIO_IF_InitRadio(LoraRx->RadioIf, RADIO_TASK_CLIENT_RX))
+      {
+         switch (LoraRx->Mode)
+         {
+            case LORA_RX_MODE_LINK_TEST:
+               ReceiveLinkTest(LoraRx);
+               break;
+            case LORA_RX_MODE_STRIPE:
+               ReceiveStripe(LoraRx);
+               break;
+            case LORA_RX_MODE_BRIDGE:
+               ReceiveBridge(LoraRx);
+               break;
+            default:
+               ReceiveDemoFile(LoraRx);
+               break;
+         }
+      }
+      if (LoraRx->Mode == LORA_RX_MODE_STRIPE)
+      {
+         STRIPE_RadioDone(LoraRx->Stripe, LoraRx->Radio);
+      }
+      LoraRx->DemoActive = false;
+
    }
 
    return true;
@@ -95,18 +175,936 @@ bool LORA_RX_ChildTask(CHILDMGR_Class_t *ChildMgr)
 
 
 /******************************************************************************
-** Function: LORA_RX_ResetStatus
+** Function: LORA_RX_StartDemoCmd
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**   2. The child task state is set before it's woken up.
+*/
+bool LORA_RX_StartDemoCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+   LORA_RX_Class_t *LoraRx = (LORA_RX_Class_t *)DataObjPtr;
+   bool   RetStatus = false;
+   uint32 SysStatus;
+      
+   if (LoraRx->DemoActive)
+   {
+      CFE_EVS_SendEvent(LORA_RX_START_DEMO_EID, CFE_EVS_EventType_ERROR,
+                        "Start Rx demo rejected, radio %u receive is active", LoraRx->Radio);
+      return false;
+   }
+
+   if (!RADIO_TASK_CheckFrameSupport(LoraRx->RadioTask, "Start Rx demo"))
+   {
+      return false;
+   }
+
+   LoraRx->Mode       = LORA_RX_MODE_DEMO;
+   LoraRx->DemoActive = true;
+
+   SysStatus = OS_CountSemGive(LoraRx->WakeUpSemaphore);
+   
+   if (SysStatus == OS_SUCCESS)
+   {
+      RetStatus = true;
+      CFE_EVS_SendEvent (LORA_RX_START_DEMO_EID, CFE_EVS_EventType_INFORMATION,
+                         "Radio %u LoRa Rx demo started", LoraRx->Radio);
+   }
+   else
+   {
+      LoraRx->DemoActive = false;
+      CFE_EVS_SendEvent (LORA_RX_START_DEMO_EID, CFE_EVS_EventType_ERROR,
+                         "Error starting LoRa Rx demo, semaphore status = %d", SysStatus);
+   }
+
+   return RetStatus;
+   
+} /* LORA_RX_StartDemoCmd() */
+
+
+/******************************************************************************
+** Function: LORA_RX_StartLinkTestCmd
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**   2. The child task state is set before it's woken up.
+*/
+bool LORA_RX_StartLinkTestCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   LORA_RX_Class_t *LoraRx = (LORA_RX_Class_t *)DataObjPtr;
+   const LORA_StartLinkTest_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_StartRxLinkTest_t);
+
+   bool   RetStatus = false;
+   uint32 SysStatus;
+
+   if (LoraRx->DemoActive)
+   {
+      CFE_EVS_SendEvent(LORA_RX_LINK_TEST_EID, CFE_EVS_EventType_ERROR,
+                        "Start Rx link test rejected, an Rx demo or link test is active");
+      return false;
+   }
+
+   if (!RADIO_TASK_CheckFrameSupport(LoraRx->RadioTask, "Start Rx link test"))
+   {
+      return false;
+   }
+
+   if (LINK_TEST_Start(LoraRx->LinkTest, LORA_LinkTestRole_RX, Cmd))
+   {
+
+      LoraRx->Mode       = LORA_RX_MODE_LINK_TEST;
+      LoraRx->DemoActive = true;
+
+      SysStatus = OS_CountSemGive(LoraRx->WakeUpSemaphore);
+
+      if (SysStatus == OS_SUCCESS)
+      {
+         RetStatus = true;
+      }
+      else
+      {
+         LoraRx->DemoActive = false;
+         LINK_TEST_Cancel(LoraRx->LinkTest);
+         CFE_EVS_SendEvent(LORA_RX_LINK_TEST_EID, CFE_EVS_EventType_ERROR,
+                           "Error starting Rx link test, semaphore status = %d", SysStatus);
+      }
+
+   }
+
+   return RetStatus;
+
+} /* LORA_RX_StartLinkTestCmd() */
+
+
+/******************************************************************************
+** Function: LORA_RX_StartStripe
+**
+** Notes:
+**   1. The caller checks that the radio is idle and isn't hopping.
+**
+*/
+bool LORA_RX_StartStripe(LORA_RX_Class_t *LoraRx)
+{
+
+   bool   RetStatus = false;
+   uint32 SysStatus;
+
+   if (!RADIO_TASK_CheckFrameSupport(LoraRx->RadioTask, "Start Rx stripe"))
+   {
+      return false;
+   }
+
+   LoraRx->Mode       = LORA_RX_MODE_STRIPE;
+   LoraRx->DemoActive = true;
+
+   SysStatus = OS_CountSemGive(LoraRx->WakeUpSemaphore);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+      RetStatus = true;
+   }
+   else
+   {
+      LoraRx->DemoActive = false;
+      CFE_EVS_SendEvent(LORA_RX_STRIPE_EID, CFE_EVS_EventType_ERROR,
+                        "Error starting radio %u striped receive, semaphore status = %d",
+                        LoraRx->Radio, SysStatus);
+   }
+
+   return RetStatus;
+
+} /* End LORA_RX_StartStripe() */
+
+
+/******************************************************************************
+** Function: LORA_RX_StartBridgeCmd
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+*/
+bool LORA_RX_StartBridgeCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   LORA_RX_Class_t *LoraRx = (LORA_RX_Class_t *)DataObjPtr;
+   bool   RetStatus = false;
+   uint32 SysStatus;
+
+   if (LoraRx->DemoActive)
+   {
+      CFE_EVS_SendEvent(LORA_RX_BRIDGE_EID, CFE_EVS_EventType_ERROR,
+                        "Start Rx bridge rejected, radio %u receive is active", LoraRx->Radio);
+      return false;
+   }
+
+   if (!RADIO_TASK_CheckFrameSupport(LoraRx->RadioTask, "Start Rx bridge"))
+   {
+      return false;
+   }
+
+   LoraRx->Mode       = LORA_RX_MODE_BRIDGE;
+   LoraRx->DemoActive = true;
+
+   SysStatus = OS_CountSemGive(LoraRx->WakeUpSemaphore);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+      RetStatus = true;
+      CFE_EVS_SendEvent(LORA_RX_BRIDGE_EID, CFE_EVS_EventType_INFORMATION,
+                        "Radio %u Rx bridge started", LoraRx->Radio);
+   }
+   else
+   {
+      LoraRx->DemoActive = false;
+      CFE_EVS_SendEvent(LORA_RX_BRIDGE_EID, CFE_EVS_EventType_ERROR,
+                        "Error starting radio %u Rx bridge, semaphore status = %d",
+                        LoraRx->Radio, SysStatus);
+   }
+
+   return RetStatus;
+
+} /* End LORA_RX_StartBridgeCmd() */
+
+
+/******************************************************************************
+** Function: LORA_RX_StopDemoCmd
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+*/
+bool LORA_RX_StopDemoCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+   
+   LORA_RX_Class_t *LoraRx = (LORA_RX_Class_t *)DataObjPtr;
+
+   LoraRx->DemoActive = false;
+   CFE_EVS_SendEvent (LORA_RX_STOP_DEMO_EID, CFE_EVS_EventType_INFORMATION,
+                      "Radio %u LoRa Rx demo stopped", LoraRx->Radio);
+   return true;
+
+} /* LORA_RX_StopDemoCmd() */
+
+
+/******************************************************************************
+** Function: ReceiveDemoFile
+**
+** Notes:
+**   1. Follows the rxDone callback in lora_rx.cpp (see end of file). The
+**      file start frame contains the number of file packets as text.
+**   2. Data frame N is written at file offset (N-1)*LORA_DEMO_PACKET_SIZE
+**      so lost packets leave a gap rather than shifting the rest of the file.
+**   3. The receive timeout lets a stop demo command end the transfer.
+**   4. The writer task writes the file (rx_writer.h), a write here only
+**      copies the data and is counted as an error if it was dropped.
+**   5. With LEN_OPT_WINDOW set and no hopping the file start frame
+**      contains the file size as text and the data arrives in FILE_SEG
+**      frames carrying their file offset. A report request is answered
+**      before the segment is written to keep the transmitter's wait short.
+**      See len_opt.h.
+**   6. The fixed packet file start frame also has the file size and the
+**      implicit header frame length, see lora_tx.c SendDemoFile(). A
+**      transmitter that doesn't send them leaves both 0. Data frames are
+**      trimmed to the packet size and the file end which removes an
+**      implicit header frame's padding.
+**   7. The transmitter repeats an implicit header transfer's file start
+**      frame, the repeats are ignored. The transmitter pauses before the
+**      first data frame so the hop slot timing restarts with it. If no
+**      frame is heard for LORA_RX_IMPLICIT_TIMEOUT_MS the receiver returns
+**      to an explicit header so it isn't left deaf to explicit frames.
+*/
+static bool ReceiveDemoFile(LORA_RX_Class_t *LoraRx)
+{
+
+   bool      Segmented = LEN_OPT_Enabled(LoraRx->LenOpt) && !FREQ_HOP_Enabled(LoraRx->FreqHop);
+   bool      ReceivedFirstPkt = false;
+   uint32    ExpectedPktCnt = 0;
+   uint32    ExpectedByteCnt = 0;
+   uint32    FilePktCnt = 0;
+   uint32    FileByteCnt = 0;
+   uint32    FileOffset;
+   uint32    FixedLen = 0;
+   uint16    SegRcvdCnt = 0;
+   uint32    FrameIdx;
+   uint8     FrameLen;
+   uint16    HdrLen;
+   uint16    DataLen;
+   uint8     Frame[LORA_FRAME_MAX_LEN+1];  /* Allow for packet count string terminator */
+   char     *FileStartText;
+   OS_time_t WriteTime;
+   OS_time_t CurrentTime;
+   LORA_FRAME_Hdr_t FrameHdr;
+
+   if (!RX_WRITER_Open(LoraRx->RxWriter, LoraRx->Radio, LoraRx->DemoFile))
+   {
+      return false;
+   }
+
+   StartReceive(LoraRx);
+   LoraRx->HopSlotMs = (RADIO_IF_TimeOnAir(LoraRx->RadioIf, LORA_FRAME_MAX_HDR_LEN+LORA_DEMO_PACKET_SIZE) + 999) / 1000;
+
+   while (LoraRx->DemoActive)
+   {
+
+      if (!ReceiveFrame(LoraRx, Frame, &FrameLen, &FrameHdr, &HdrLen, &FrameIdx, LORA_RX_RECEIVE_TIMEOUT_MS))
+      {
+         RX_WRITER_Poll(LoraRx->RxWriter, LoraRx->Radio);
+         if (ReceivedFirstPkt && LoraRx->HopSynced && LoraRx->NextFrameIdx > ExpectedPktCnt)
+         {
+            break;  /* Last frame's slot has passed */
+         }
+         if (FixedLen > 0)
+         {
+            OS_GetLocalTime(&CurrentTime);
+            if (OS_TimeGetTotalMilliseconds(OS_TimeSubtract(CurrentTime, LoraRx->LastFrameTime)) >= LORA_RX_IMPLICIT_TIMEOUT_MS)
+            {
+               RADIO_TASK_SetHeaderType(LoraRx->RadioTask, RADIO_TASK_CLIENT_RX, LORA_HeaderType_EXPLICIT, 0);
+               FixedLen = 0;
+               LoraRx->HopSlotMs = (RADIO_IF_TimeOnAir(LoraRx->RadioIf, LORA_FRAME_MAX_HDR_LEN+LORA_DEMO_PACKET_SIZE) + 999) / 1000;
+               CFE_EVS_SendEvent(LORA_RX_DEMO_FILE_EID, CFE_EVS_EventType_ERROR,
+                                 "No implicit header frame for %d ms, returned to an explicit header",
+                                 LORA_RX_IMPLICIT_TIMEOUT_MS);
+            }
+         }
+         continue;
+      }
+
+      DataLen = FrameLen - HdrLen;
+
+      if (FrameHdr.Type == LORA_FRAME_TYPE_FILE_START)
+      {
+         if (!ReceivedFirstPkt)
+         {
+            Frame[FrameLen]  = '\0';
+            ReceivedFirstPkt = true;
+            if (Segmented)
+            {
+               ExpectedByteCnt = strtoul((const char *)&Frame[HdrLen], NULL, 10);
+               CFE_EVS_SendEvent(LORA_RX_DEMO_FILE_EID, CFE_EVS_EventType_INFORMATION,
+                                 "Receiving %u bytes in segments into %s", (unsigned int)ExpectedByteCnt, LoraRx->DemoFile);
+            }
+            else
+            {
+               ExpectedPktCnt  = strtoul((const char *)&Frame[HdrLen], &FileStartText, 10);
+               ExpectedByteCnt = strtoul(FileStartText, &FileStartText, 10);
+               FixedLen        = strtoul(FileStartText, NULL, 10);
+               if (FixedLen > LORA_FRAME_MAX_LEN ||
+                   (FixedLen > 0 && !RADIO_TASK_SetHeaderType(LoraRx->RadioTask, RADIO_TASK_CLIENT_RX,
+                                                              LORA_HeaderType_IMPLICIT, (uint8)FixedLen)))
+               {
+                  CFE_EVS_SendEvent(LORA_RX_DEMO_FILE_EID, CFE_EVS_EventType_ERROR,
+                                    "Error setting an implicit header with length %u, data frames won't be heard",
+                                    (unsigned int)FixedLen);
+                  FixedLen = 0;
+               }
+               if (FixedLen > 0)
+               {
+                  LoraRx->HopSlotMs = (RADIO_IF_ImplicitTimeOnAir(LoraRx->RadioIf, (uint8)FixedLen) + 999) / 1000;
+                  LoraRx->HopSynced = false;   /* Resynchronize on the first data frame after the turnaround */
+               }
+               CFE_EVS_SendEvent(LORA_RX_DEMO_FILE_EID, CFE_EVS_EventType_INFORMATION,
+                                 "Receiving %d packets into %s with %s header", ExpectedPktCnt, LoraRx->DemoFile,
+                                 (FixedLen > 0 ? "an implicit" : "an explicit"));
+            }
+         }
+         continue;
+      }
+
+      if (Segmented)
+      {
+         if (FrameHdr.Type != LORA_FRAME_TYPE_FILE_SEG || DataLen < LORA_FRAME_SEG_OFFSET_LEN)
+         {
+            LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_ERR, 1);
+            continue;
+         }
+         SegRcvdCnt++;
+         if (FrameHdr.Flags & LORA_FRAME_FLAG_REPORT_REQ)
+         {
+            SendReport(LoraRx, FrameHdr.Seq, SegRcvdCnt);
+         }
+         FileOffset = ((uint32)Frame[HdrLen] << 24) | ((uint32)Frame[HdrLen+1] << 16) |
+                      ((uint32)Frame[HdrLen+2] << 8) | (uint32)Frame[HdrLen+3];
+         HdrLen  += LORA_FRAME_SEG_OFFSET_LEN;
+         DataLen -= LORA_FRAME_SEG_OFFSET_LEN;
+      }
+      else
+      {
+         if (FrameHdr.Type != LORA_FRAME_TYPE_FILE_DATA || FrameIdx == 0)
+         {
+            LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_ERR, 1);
+            continue;
+         }
+         FileOffset = (FrameIdx-1)*LORA_DEMO_PACKET_SIZE;
+         if (DataLen > LORA_DEMO_PACKET_SIZE)
+         {
+            DataLen = LORA_DEMO_PACKET_SIZE;
+         }
+         if (ExpectedByteCnt > 0 && FileOffset + DataLen > ExpectedByteCnt)
+         {
+            if (FileOffset >= ExpectedByteCnt)
+            {
+               LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_ERR, 1);
+               continue;
+            }
+            DataLen = ExpectedByteCnt - FileOffset;
+         }
+      }
+
+      OS_GetLocalTime(&WriteTime);
+      if (RX_WRITER_Write(LoraRx->RxWriter, LoraRx->Radio, FileOffset, &Frame[HdrLen], DataLen))
+      {
+         FRAME_TRACE_Record(LoraRx->Radio, FRAME_TRACE_TASK_RX, FRAME_TRACE_RX_DISK_WRITE, FrameHdr.Seq, FrameLen, &WriteTime);
+         LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_FRAME, 1);
+         LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_DATA_BYTE, DataLen);
+         FilePktCnt++;
+         FileByteCnt += DataLen;
+      }
+      else
+      {
+         LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_ERR, 1);
+      }
+
+      if (ReceivedFirstPkt &&
+          (Segmented ? (FileOffset + DataLen >= ExpectedByteCnt) : (FrameIdx >= ExpectedPktCnt)))
+      {
+         break;
+      }
+
+   } /* End receive loop */
+
+   RX_WRITER_Close(LoraRx->RxWriter, LoraRx->Radio);
+
+   if (FixedLen > 0)
+   {
+      RADIO_TASK_SetHeaderType(LoraRx->RadioTask, RADIO_TASK_CLIENT_RX, LORA_HeaderType_EXPLICIT, 0);
+   }
+
+   if (Segmented)
+   {
+      CFE_EVS_SendEvent(LORA_RX_DEMO_FILE_EID, CFE_EVS_EventType_INFORMATION,
+                        "Receive demo %s: received %u of %u bytes in %u segments, last RSSI %d, SNR %d",
+                        (LoraRx->DemoActive ? "complete" : "stopped"), (unsigned int)FileByteCnt,
+                        (unsigned int)ExpectedByteCnt, (unsigned int)FilePktCnt, LoraRx->LastRssi, LoraRx->LastSnr);
+
+      return (ReceivedFirstPkt && FileByteCnt == ExpectedByteCnt);
+   }
+
+   CFE_EVS_SendEvent(LORA_RX_DEMO_FILE_EID, CFE_EVS_EventType_INFORMATION,
+                     "Receive demo %s: received %d of %d packets, last RSSI %d, SNR %d",
+                     (LoraRx->DemoActive ? "complete" : "stopped"), FilePktCnt, ExpectedPktCnt,
+                     LoraRx->LastRssi, LoraRx->LastSnr);
+
+   return (ReceivedFirstPkt && FilePktCnt == ExpectedPktCnt);
+
+} /* End ReceiveDemoFile() */
+
+
+/******************************************************************************
+** Function: ReceiveLinkTest
+**
+** Notes:
+**   1. The receiver follows the transmitter's steps using the frame index:
+**      frames [Step*FramesPerStep, (Step+1)*FramesPerStep) belong to Step.
+**   2. A step ends when its last frame is received or when the time for
+**      its remaining frames has passed. The deadline is measured from the
+**      last frame received, or from the start of the step if none has
+**      been received, so it doesn't depend on the two ends' clocks.
+**   3. The first step waits until its first frame is received.
+**   4. A frame from a later step ends the current step. This happens when
+**      consecutive steps use the same modulation.
+*/
+static bool ReceiveLinkTest(LORA_RX_Class_t *LoraRx)
+{
+
+   LINK_TEST_Class_t *LinkTest = LoraRx->LinkTest;
+
+   bool      FrameRcvd;
+   uint16    StepIdx = 0;
+   uint16    StepCnt = LINK_TEST_StepCnt(LinkTest);
+   uint16    FramesPerStep = LINK_TEST_FramesPerStep(LinkTest);
+   uint32    StepEndIdx = FramesPerStep;
+   uint32    DeadlineMs = 0;   /* 0 waits without a deadline */
+   uint32    ElapsedMs;
+   uint32    TimeoutMs;
+   uint32    FrameIdx;
+   uint8     FrameLen;
+   uint16    HdrLen;
+   uint8     Frame[LORA_FRAME_MAX_LEN];
+   OS_time_t AnchorTime;
+   OS_time_t CurrentTime;
+   LORA_FRAME_Hdr_t FrameHdr;
+
+   StartReceive(LoraRx);
+   LINK_TEST_BeginStep(LinkTest, RADIO_TASK_CLIENT_RX, StepIdx);
+   LoraRx->HopSlotMs = LINK_TEST_SlotMs(LinkTest);
+   OS_GetLocalTime(&AnchorTime);
+
+   while (LoraRx->DemoActive && StepIdx < StepCnt)
+   {
+
+      TimeoutMs = LORA_RX_RECEIVE_TIMEOUT_MS;
+      ElapsedMs = 0;
+      if (DeadlineMs > 0)
+      {
+         OS_GetLocalTime(&CurrentTime);
+         ElapsedMs = OS_TimeGetTotalMilliseconds(OS_TimeSubtract(CurrentTime, AnchorTime));
+         if (ElapsedMs < DeadlineMs && DeadlineMs - ElapsedMs < TimeoutMs)
+         {
+            TimeoutMs = DeadlineMs - ElapsedMs;
+         }
+      }
+
+      FrameRcvd = false;
+      if (DeadlineMs > 0 && ElapsedMs >= DeadlineMs)
+      {
+         FrameIdx = StepEndIdx;   /* Deadline passed, advance to the next step */
+      }
+      else
+      {
+         if (!ReceiveFrame(LoraRx, Frame, &FrameLen, &FrameHdr, &HdrLen, &FrameIdx, TimeoutMs))
+         {
+            continue;
+         }
+         if (FrameHdr.Type != LORA_FRAME_TYPE_LINK_TEST)
+         {
+            LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_ERR, 1);
+            continue;
+         }
+         FrameRcvd = true;
+      }
+
+      while (FrameIdx >= StepEndIdx && StepIdx < StepCnt)
+      {
+         LINK_TEST_EndStep(LinkTest);
+         if (++StepIdx < StepCnt)
+         {
+            LINK_TEST_BeginStep(LinkTest, RADIO_TASK_CLIENT_RX, StepIdx);
+            LoraRx->HopSlotMs = LINK_TEST_SlotMs(LinkTest);
+            StepEndIdx += FramesPerStep;
+            OS_GetLocalTime(&AnchorTime);
+            DeadlineMs = LINK_TEST_StepGapMs(LinkTest) + FramesPerStep * LoraRx->HopSlotMs + LoraRx->HopGuardMs;
+         }
+      }
+
+      if (FrameRcvd && StepIdx < StepCnt)
+      {
+
+         LINK_TEST_RecordRx(LinkTest, FrameIdx, &Frame[HdrLen], FrameLen - HdrLen, LoraRx->LastRssi, LoraRx->LastSnr);
+         LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_FRAME, 1);
+         LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_DATA_BYTE, FrameLen - HdrLen);
+
+         OS_GetLocalTime(&AnchorTime);
+         DeadlineMs = (StepEndIdx - 1 - FrameIdx) * LoraRx->HopSlotMs + LoraRx->HopGuardMs;
+         if (FrameIdx == StepEndIdx - 1)
+         {
+            DeadlineMs = 1;   /* Last frame of the step, end it on the next pass */
+         }
+
+      }
+
+   } /* End receive loop */
+
+   if (StepIdx < StepCnt)
+   {
+      LINK_TEST_EndStep(LinkTest);
+   }
+   LINK_TEST_Stop(LinkTest, RADIO_TASK_CLIENT_RX);
+
+   return (StepIdx == StepCnt);
+
+} /* End ReceiveLinkTest() */
+
+
+/******************************************************************************
+** Function: ReceiveStripe
+**
+** Pass received frames to the striped transfer until it ends
+**
+** Notes:
+**   1. The stripe object merges the radios' frames into one file, see
+**      stripe.h. Each radio only sees part of the sequence numbers so the
+**      per-radio sequence tracking just drops stale frames.
+**   2. Frames pass through the receive diversity combiner first so a
+**      frame received by several radios is only written once.
+**   3. The receive timeout lets a stop command end the transfer.
+**
+*/
+static void ReceiveStripe(LORA_RX_Class_t *LoraRx)
+{
+
+   uint32    FrameIdx;
+   uint8     FrameLen;
+   uint16    HdrLen;
+   uint8     Frame[LORA_FRAME_MAX_LEN];
+   LORA_FRAME_Hdr_t FrameHdr;
+
+   StartReceive(LoraRx);
+
+   while (LoraRx->DemoActive && STRIPE_Active(LoraRx->Stripe))
+   {
+
+      if (!ReceiveFrame(LoraRx, Frame, &FrameLen, &FrameHdr, &HdrLen, &FrameIdx, LORA_RX_RECEIVE_TIMEOUT_MS))
+      {
+         STRIPE_PollRx(LoraRx->Stripe);
+         continue;
+      }
+
+      LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_FRAME, 1);
+      if (RX_DIV_Accept(LoraRx->RxDiv, LoraRx->Radio, FrameHdr.Seq, LoraRx->LastSnr))
+      {
+         STRIPE_RecordRx(LoraRx->Stripe, LoraRx->Radio, &FrameHdr, &Frame[HdrLen], FrameLen - HdrLen,
+                         RADIO_IF_TimeOnAir(LoraRx->RadioIf, FrameLen));
+         LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_DATA_BYTE, FrameLen - HdrLen);
+      }
+
+   } /* End receive loop */
+
+} /* End ReceiveStripe() */
+
+
+/******************************************************************************
+** Function: ReceiveBridge
+**
+** Rebuild received software bus messages and republish them
+**
+** Notes:
+**   1. The message header is rebuilt exactly, including the sender's
+**      sequence count, so the message is sent without changing it. See
+**      hdr_comp.h for the header compression.
+**   2. Messages are dropped until the first full header of their stream
+**      arrives, and after a full header is lost until the next one.
+**   3. The receive timeout lets a stop demo command end the receive.
+**   4. Replayed messages are only republished in replay count order, the
+**      sender resends from the first one that's not acknowledged (see
+**      store.h). The last one republished is reported for the ground's
+**      acknowledgement.
+**   5. Frames with a route field go to the relay first, it forwards the
+**      ones for other nodes and drops beacons and duplicates (see
+**      relay.h). Each source's messages have their own header context.
+**   6. Bit-packed telemetry payloads are unpacked after the header is
+**      rebuilt, see tlm_pack.h.
+**
+*/
+static void ReceiveBridge(LORA_RX_Class_t *LoraRx)
+{
+
+   uint32    FrameIdx;
+   uint32    MsgCnt = 0;
+   uint8     FrameLen;
+   uint16    HdrLen;
+   uint16    MsgLen;
+   uint16    StoreSeq;
+   uint16    i;
+   uint32    CtxErrCnt;
+   uint32    FormatErrCnt;
+   uint8     Frame[LORA_FRAME_MAX_LEN];
+   uint32    MsgBuf[(LORA_FRAME_MAX_LEN + HDR_COMP_MAX_HDR_LEN + 3)/4];   /* Aligned for the message header */
+   LORA_FRAME_Hdr_t FrameHdr;
+   HDR_COMP_Class_t *HdrExp;
+
+   StartReceive(LoraRx);
+   HDR_COMP_Reset(&LoraRx->HdrExp);
+   HDR_COMP_Reset(&LoraRx->StoreHdrExp);
+   for (i=0; i < LORA_RX_MAX_SRC; i++)
+   {
+      HDR_COMP_Reset(&LoraRx->SrcHdrExp[i]);
+      LoraRx->SrcNode[i] = LORA_FRAME_NODE_NONE;
+   }
+   LoraRx->NextSrc = 0;
+   LoraRx->StoreSeqValid = false;
+   LoraRx->StoreSkipCnt  = 0;
+   LoraRx->HopSlotMs = (RADIO_IF_TimeOnAir(LoraRx->RadioIf, LORA_FRAME_MAX_LEN) + 999) / 1000;
+
+   while (LoraRx->DemoActive)
+   {
+
+      if (!ReceiveFrame(LoraRx, Frame, &FrameLen, &FrameHdr, &HdrLen, &FrameIdx, LORA_RX_RECEIVE_TIMEOUT_MS))
+      {
+         continue;
+      }
+
+      HdrExp = &LoraRx->HdrExp;
+      if (FrameHdr.Flags & LORA_FRAME_FLAG_ROUTE)
+      {
+         if (!RELAY_Receive(LoraRx->Relay, &FrameHdr, &Frame[HdrLen], FrameLen - HdrLen))
+         {
+            continue;
+         }
+         HdrExp = SrcHdrExp(LoraRx, FrameHdr.Route.Src);
+      }
+
+      MsgLen = 0;
+      if (FrameHdr.Type == LORA_FRAME_TYPE_SB_MSG)
+      {
+         MsgLen = HDR_COMP_Expand(HdrExp, &Frame[HdrLen], FrameLen - HdrLen,
+                                  (uint8 *)MsgBuf, sizeof(MsgBuf));
+      }
+      else if (FrameHdr.Type == LORA_FRAME_TYPE_SB_STORED && (FrameLen - HdrLen) > STORE_SEQ_LEN)
+      {
+         StoreSeq = (Frame[HdrLen] << 8) | Frame[HdrLen+1];
+         if (!LoraRx->StoreSeqValid || StoreSeq == (uint16)(LoraRx->StoreSeq + 1) || StoreSeq == 1)
+         {
+            MsgLen = HDR_COMP_Expand(&LoraRx->StoreHdrExp, &Frame[HdrLen+STORE_SEQ_LEN], FrameLen - HdrLen - STORE_SEQ_LEN,
+                                     (uint8 *)MsgBuf, sizeof(MsgBuf));
+            if (MsgLen > 0)
+            {
+               LoraRx->StoreSeqValid = true;
+               LoraRx->StoreSeq      = StoreSeq;
+               STORE_RecordRx(LoraRx->Store, StoreSeq);
+            }
+         }
+         else
+         {
+            LoraRx->StoreSkipCnt++;
+         }
+      }
+
+      if (MsgLen > 0)
+      {
+         MsgLen = TLM_PACK_Unpack(&LoraRx->TlmUnpack, (CFE_MSG_Message_t *)MsgBuf, MsgLen, sizeof(MsgBuf));
+      }
+
+      if (MsgLen > 0 && CFE_SB_TransmitMsg((const CFE_MSG_Message_t *)MsgBuf, false) == CFE_SUCCESS)
+      {
+         LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_FRAME, 1);
+         LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_DATA_BYTE, MsgLen);
+         MsgCnt++;
+      }
+      else
+      {
+         LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_ERR, 1);
+      }
+
+   } /* End receive loop */
+
+   CtxErrCnt    = LoraRx->HdrExp.CtxErrCnt + LoraRx->StoreHdrExp.CtxErrCnt;
+   FormatErrCnt = LoraRx->HdrExp.FormatErrCnt + LoraRx->StoreHdrExp.FormatErrCnt;
+   for (i=0; i < LORA_RX_MAX_SRC; i++)
+   {
+      CtxErrCnt    += LoraRx->SrcHdrExp[i].CtxErrCnt;
+      FormatErrCnt += LoraRx->SrcHdrExp[i].FormatErrCnt;
+   }
+
+   CFE_EVS_SendEvent(LORA_RX_BRIDGE_EID, CFE_EVS_EventType_INFORMATION,
+                     "Radio %u Rx bridge stopped: republished %u messages, %u without a header context, "
+                     "%u malformed, %u replays out of sequence, last RSSI %d, SNR %d", LoraRx->Radio, MsgCnt,
+                     CtxErrCnt, FormatErrCnt, LoraRx->StoreSkipCnt, LoraRx->LastRssi, LoraRx->LastSnr);
+
+} /* End ReceiveBridge() */
+
+
+/******************************************************************************
+** Function: SrcHdrExp
+**
+** Return the header expander for a routed message's source node
+**
+** Notes:
+**   1. A new source takes over the least recently added source's context,
+**      its next message with a full header rebuilds it.
+**
+*/
+static HDR_COMP_Class_t *SrcHdrExp(LORA_RX_Class_t *LoraRx, uint8 Src)
+{
+
+   uint16 i;
+
+   for (i=0; i < LORA_RX_MAX_SRC; i++)
+   {
+      if (LoraRx->SrcNode[i] == Src)
+      {
+         return &LoraRx->SrcHdrExp[i];
+      }
+   }
+
+   i = LoraRx->NextSrc;
+   LoraRx->NextSrc = (LoraRx->NextSrc + 1) % LORA_RX_MAX_SRC;
+   LoraRx->SrcNode[i] = Src;
+   HDR_COMP_Reset(&LoraRx->SrcHdrExp[i]);
+
+   return &LoraRx->SrcHdrExp[i];
+
+} /* End SrcHdrExp() */
+
+
+/******************************************************************************
+** Function: StartReceive
+**
+** Reset the frame sequence and hop tracking for a new transfer
+**
+*/
+static void StartReceive(LORA_RX_Class_t *LoraRx)
+{
+
+   LoraRx->FrameRcvd    = false;
+   LoraRx->HopSynced    = false;
+   LoraRx->HopMissCnt   = 0;
+   LoraRx->NextFrameIdx = 0;
+   FREQ_HOP_Start(LoraRx->FreqHop);
+
+} /* End StartReceive() */
+
+
+/******************************************************************************
+** Function: ReceiveFrame
+**
+** Receive the next frame and return its header length and 32-bit frame index.
+**
+** Notes:
+**   1. When hopping, the receiver tunes to the channel of the next expected
+**      frame and waits until the end of that frame's slot. A slot is the
+**      time-on-air of a full frame plus a guard time. Slot deadlines are
+**      measured from the last frame received so clock differences between
+**      the two ends don't accumulate.
+**   2. A full hop cycle without a frame drops sync. The receiver then parks
+**      on one channel until the transmitter hops back to it.
+**   3. Frames older than the next expected frame are duplicates and are
+**      dropped.
+**   4. Frame must have room for LORA_FRAME_MAX_LEN bytes.
+**   5. Every receive call is reported to rx_duty for the energy estimate.
+**   6. Accepted frames are reported to latency for their timestamps.
+**   7. Routed frames come from any neighbour so a receiver that isn't
+**      hopping follows the sequence of the last frame's sender.
+*/
+static bool ReceiveFrame(LORA_RX_Class_t *LoraRx, uint8 *Frame, uint8 *FrameLen, LORA_FRAME_Hdr_t *FrameHdr,
+                         uint16 *HdrLen, uint32 *FrameIdx, uint32 MaxTimeoutMs)
+{
+
+   FREQ_HOP_Class_t *FreqHop = LoraRx->FreqHop;
+   bool      Hopping = FREQ_HOP_Enabled(FreqHop);
+   uint32    TimeoutMs = MaxTimeoutMs;
+   uint32    ElapsedMs;
+   uint32    DeadlineMs;
+   uint16    SeqDelta;
+   bool      Rcvd;
+   OS_time_t StartTime;
+   OS_time_t CurrentTime;
+
+   if (Hopping)
+   {
+      FREQ_HOP_Tune(FreqHop, RADIO_TASK_CLIENT_RX, (uint16)LoraRx->NextFrameIdx);
+      if (LoraRx->HopSynced)
+      {
+         OS_GetLocalTime(&CurrentTime);
+         ElapsedMs  = OS_TimeGetTotalMilliseconds(OS_TimeSubtract(CurrentTime, LoraRx->LastFrameTime));
+         DeadlineMs = (LoraRx->NextFrameIdx - LoraRx->LastFrameIdx) * LoraRx->HopSlotMs + LoraRx->HopGuardMs;
+         TimeoutMs  = (DeadlineMs > ElapsedMs) ? (DeadlineMs - ElapsedMs) : 1;
+         if (TimeoutMs > MaxTimeoutMs)
+         {
+            TimeoutMs = MaxTimeoutMs;
+         }
+      }
+   }
+
+   OS_GetLocalTime(&StartTime);
+   Rcvd = RADIO_TASK_ReceivePayload(LoraRx->RadioTask, RADIO_TASK_CLIENT_RX, Frame, FrameLen, LORA_FRAME_MAX_LEN,
+                                    &LoraRx->LastRssi, &LoraRx->LastSnr, TimeoutMs);
+   OS_GetLocalTime(&CurrentTime);
+   RX_DUTY_RecordListen(LoraRx->RxDuty, (uint32)OS_TimeGetTotalMicroseconds(OS_TimeSubtract(CurrentTime, StartTime)),
+                        Rcvd ? *FrameLen : 0);
+
+   if (!Rcvd)
+   {
+      if (Hopping && LoraRx->HopSynced)
+      {
+         FREQ_HOP_RecordFrame(FreqHop, (uint16)LoraRx->NextFrameIdx, true);
+         LoraRx->NextFrameIdx++;
+         if (++LoraRx->HopMissCnt >= FREQ_HOP_CycleLen(FreqHop))
+         {
+            LoraRx->HopSynced = false;
+            EVT_SUM_Count(EVT_SUM_RX_HOP_SYNC_LOST, (int32)LoraRx->NextFrameIdx);
+         }
+      }
+      return false;
+   }
+
+   *HdrLen = LORA_FRAME_DecodeHdr(Frame, *FrameLen, FrameHdr);
+   if (*HdrLen == 0)
+   {
+      LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_ERR, 1);
+      return false;
+   }
+
+   if (!LoraRx->FrameRcvd || (!Hopping && (FrameHdr->Flags & LORA_FRAME_FLAG_ROUTE)))
+   {
+      LoraRx->NextFrameIdx = FrameHdr->Seq;
+      LoraRx->FrameRcvd    = true;
+   }
+
+   SeqDelta = FrameHdr->Seq - (uint16)LoraRx->NextFrameIdx;
+   if (SeqDelta >= 0x8000)
+   {
+      return false;
+   }
+   *FrameIdx = LoraRx->NextFrameIdx + SeqDelta;
+
+   if (Hopping)
+   {
+      if (LoraRx->HopSynced)
+      {
+         while (LoraRx->NextFrameIdx != *FrameIdx)
+         {
+            FREQ_HOP_RecordFrame(FreqHop, (uint16)LoraRx->NextFrameIdx++, true);
+         }
+      }
+      else
+      {
+         EVT_SUM_Count(EVT_SUM_RX_HOP_SYNC_ACQUIRED, (int32)*FrameIdx);
+      }
+      FREQ_HOP_RecordFrame(FreqHop, FrameHdr->Seq, false);
+      if (FrameHdr->Flags & LORA_FRAME_FLAG_HOP_MASK)
+      {
+         FREQ_HOP_SetBlacklist(FreqHop, FrameHdr->HopMask);
+      }
+      LoraRx->HopSynced  = true;
+      LoraRx->HopMissCnt = 0;
+   }
+
+   LoraRx->LastFrameIdx  = *FrameIdx;
+   LoraRx->LastFrameTime = CurrentTime;
+   LoraRx->NextFrameIdx  = *FrameIdx + 1;
+
+   LATENCY_RecordRx(LoraRx->Latency, FrameHdr, OS_TimeGetTotalMicroseconds(CurrentTime));
+
+   FRAME_TRACE_Record(LoraRx->Radio, FRAME_TRACE_TASK_RX, FRAME_TRACE_RX_DECODE, FrameHdr->Seq, *FrameLen, &CurrentTime);
+
+   return true;
+
+} /* End ReceiveFrame() */
+
+
+/******************************************************************************
+** Function: SendReport
 **
-** Reset counters and status flags to a known reset state.
+** Answer a length optimizer report request with the transfer's segment count
 **
+** Notes:
+**   1. The report reuses the request's sequence number so it goes out on
+**      the channel the request arrived on. See len_opt.h.
 */
-void LORA_RX_ResetStatus(void)
+static void SendReport(LORA_RX_Class_t *LoraRx, uint16 Seq, uint16 SegRcvdCnt)
 {
 
-   LoraRx->PktCnt    = 0;
-   LoraRx->PktErrCnt = 0;
+   uint16 FrameLen;
+   uint8  Frame[LORA_FRAME_MAX_HDR_LEN + LORA_FRAME_REPORT_LEN];
+   LORA_FRAME_Hdr_t FrameHdr;
+
+   memset(&FrameHdr, 0, sizeof(FrameHdr));
+   FrameHdr.Type = LORA_FRAME_TYPE_RX_REPORT;
+   FrameHdr.Seq  = Seq;
+
+   FrameLen = LORA_FRAME_EncodeHdr(Frame, &FrameHdr);
+   Frame[FrameLen++] = (uint8)(SegRcvdCnt >> 8);
+   Frame[FrameLen++] = (uint8)(SegRcvdCnt);
+
+   if (RADIO_TASK_SendPayload(LoraRx->RadioTask, RADIO_TASK_CLIENT_RX, Frame, FrameLen, LORA_RX_SEND_TIMEOUT_MS))
+   {
+      LEN_OPT_RecordReportTx(LoraRx->LenOpt);
+   }
+   else
+   {
+      LORA_METRICS_Add(LoraRx->Radio, LORA_METRICS_TASK_RX, LORA_METRICS_RX_ERR, 1);
+   }
 
-} /* End LORA_RX_ResetStatus() */
+} /* End SendReport() */
 
 
 /** lora_rx.cpp
@@ -28,13 +28,32 @@
 */
 
 #include "app_cfg.h"
-#include "radio.h"
+#include "radio_inst.h"
+#include "radio_task.h"
+#include "radio_if.h"
+#include "freq_hop.h"
+#include "hdr_comp.h"
+#include "latency.h"
+#include "len_opt.h"
+#include "link_test.h"
+#include "rx_duty.h"
+#include "rx_div.h"
+#include "stripe.h"
+#include "store.h"
+#include "rx_writer.h"
+#include "relay.h"
+#include "tlm_pack.h"
 
 
 /***********************/
 /** Macro Definitions **/
 /***********************/
 
+#define LORA_RX_RECEIVE_TIMEOUT_MS  1000
+#define LORA_RX_SEND_TIMEOUT_MS     1000  /* Length optimizer reports, see len_opt.h */
+#define LORA_RX_MAX_SRC             4     /* Routed message sources with their own header context */
+#define LORA_RX_IMPLICIT_TIMEOUT_MS 5000  /* No implicit header frame for this long returns to an explicit header */
+
 
 /*
 ** Event Message IDs
@@ -45,17 +64,91 @@
 #define LORA_RX_CHILD_TASK_EID            (LORA_RX_BASE_EID + 2)
 #define LORA_RX_START_DEMO_EID            (LORA_RX_BASE_EID + 3)
 #define LORA_RX_STOP_DEMO_EID             (LORA_RX_BASE_EID + 4)
+#define LORA_RX_DEMO_FILE_EID             (LORA_RX_BASE_EID + 5)
+#define LORA_RX_HOP_SYNC_EID              (LORA_RX_BASE_EID + 6)
+#define LORA_RX_LINK_TEST_EID             (LORA_RX_BASE_EID + 7)
+#define LORA_RX_STRIPE_EID                (LORA_RX_BASE_EID + 8)
+#define LORA_RX_BRIDGE_EID                (LORA_RX_BASE_EID + 9)
 
 /**********************/
 /** Type Definitions **/
 /**********************/
 
+typedef enum
+{
+
+   LORA_RX_MODE_DEMO = 0,
+   LORA_RX_MODE_LINK_TEST,
+   LORA_RX_MODE_STRIPE,    /* Receive this radio's share of a striped transfer */
+   LORA_RX_MODE_BRIDGE     /* Republish received software bus messages */
+
+} LORA_RX_Mode_t;
+
+
 typedef struct
 {
 
-   uint32  PktCnt;
-   uint32  PktErrCnt;
+   /*
+   ** Object References
+   */
+
+   RADIO_TASK_Class_t *RadioTask;
+   RADIO_IF_Class_t   *RadioIf;
+   FREQ_HOP_Class_t   *FreqHop;
+   LINK_TEST_Class_t  *LinkTest;
+   RX_DUTY_Class_t    *RxDuty;
+   LATENCY_Class_t    *Latency;
+   LEN_OPT_Class_t    *LenOpt;
+   STRIPE_Class_t     *Stripe;
+   RX_DIV_Class_t     *RxDiv;
+   STORE_Class_t      *Store;
+   RX_WRITER_Class_t  *RxWriter;
+   RELAY_Class_t      *Relay;
+
+   /*
+   ** Class State Data
+   */
+
+   uint8   Radio;
+   int32   RunStatus;
+   uint32  WakeUpSemaphore;
+
+   bool    DemoActive;
+   LORA_RX_Mode_t Mode;
+   int8    LastRssi;
+   int8    LastSnr;
    
+   char    DemoFile[OS_MAX_PATH_LEN];
+
+   HDR_COMP_Class_t HdrExp;   /* Rebuilds bridged message headers */
+   HDR_COMP_Class_t StoreHdrExp;
+   HDR_COMP_Class_t SrcHdrExp[LORA_RX_MAX_SRC];   /* Routed messages, by source node */
+   TLM_PACK_Class_t TlmUnpack;
+   uint8   SrcNode[LORA_RX_MAX_SRC];
+   uint8   NextSrc;
+   bool    StoreSeqValid;
+   uint16  StoreSeq;          /* Last replayed message republished */
+   uint32  StoreSkipCnt;      /* Replays out of sequence */
+
+   /*
+   ** Frame sequence tracking. Frame indices are sequence numbers
+   ** extended to 32 bits.
+   */
+
+   bool      FrameRcvd;
+   uint32    NextFrameIdx;
+   uint32    LastFrameIdx;
+   OS_time_t LastFrameTime;
+
+   /*
+   ** Frequency hopping receive state
+   */
+
+   bool    HopSynced;
+   uint32  HopMissCnt;
+   uint32  HopSlotMs;
+   uint32  HopGuardMs;
+
 } LORA_RX_Class_t;
 
 
@@ -73,23 +166,74 @@ typedef struct
 **   1. This must be called prior to any other member functions.
 **
 */
-void LORA_RX_Constructor(LORA_RX_Class_t *LoraRxPtr);
+void LORA_RX_Constructor(LORA_RX_Class_t *LoraRx, INITBL_Class_t *IniTbl,
+                         const RADIO_INST_Cfg_t *Inst, RADIO_TASK_Class_t *RadioTask,
+                         RADIO_IF_Class_t *RadioIf, FREQ_HOP_Class_t *FreqHop,
+                         LINK_TEST_Class_t *LinkTest, RX_DUTY_Class_t *RxDuty,
+                         LATENCY_Class_t *Latency, LEN_OPT_Class_t *LenOpt, STRIPE_Class_t *Stripe,
+                         RX_DIV_Class_t *RxDiv, STORE_Class_t *Store, RX_WRITER_Class_t *RxWriter,
+                         RELAY_Class_t *Relay);
 
 
 /******************************************************************************
 ** Function: LORA_RX_ChildTask
 **
+** Notes:
+**   1. Called by the app's child manager callback for the radio.
+**
 */
-bool LORA_RX_ChildTask(CHILDMGR_Class_t *ChildMgr);
+bool LORA_RX_ChildTask(LORA_RX_Class_t *LoraRx);
 
 
 /******************************************************************************
-** Function: LORA_RX_ResetStatus
+** Function: LORA_RX_StartDemoCmd
 **
-** Reset counters and status flags to a known reset state.
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+*/
+bool LORA_RX_StartDemoCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: LORA_RX_StartLinkTestCmd
 **
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+*/
+bool LORA_RX_StartLinkTestCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: LORA_RX_StartStripe
+**
+** Start receiving this radio's share of a striped transfer
+**
+** Notes:
+**   1. Called by the app's start stripe command after STRIPE_Start().
+**
+*/
+bool LORA_RX_StartStripe(LORA_RX_Class_t *LoraRx);
+
+
+/******************************************************************************
+** Function: LORA_RX_StartBridgeCmd
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**   2. Received software bus message frames are rebuilt and republished
+**      on the software bus until a stop demo command.
+*/
+bool LORA_RX_StartBridgeCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: LORA_RX_StopDemoCmd
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**   2. Also stops a link test and a bridge receive
 */
-void LORA_RX_ResetStatus(void);
+bool LORA_RX_StopDemoCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
 
 
 #endif /* _lora_rx_ */
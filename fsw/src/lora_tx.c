@@ -24,6 +24,16 @@
 ** Includes
 */
 
+#include <stdio.h>
+#include <string.h>
+#include "frame_trace.h"
+#include "evt_sum.h"
+#include "freq_hop.h"
+#include "link_test.h"
+#include "load_gen.h"
+#include "lora_frame.h"
+#include "lora_metrics.h"
+#include "radio_if.h"
 #include "lora_tx.h"
 
 
@@ -41,14 +51,15 @@
 /** Local File Function Prototypes **/
 /************************************/
 
-static bool RunDemoScript(void);
-
-
-/*****************/
-/** Global Data **/
-/*****************/
-
-static LORA_TX_Class_t *LoraTx;
+static bool RunDemoScript(LORA_TX_Class_t *LoraTx);
+static bool RunLinkTest(LORA_TX_Class_t *LoraTx);
+static bool SendDemoFile(LORA_TX_Class_t *LoraTx);
+static bool SendFileSegs(LORA_TX_Class_t *LoraTx, osal_id_t FileHandle, uint32 FileSize);
+static bool SendStripe(LORA_TX_Class_t *LoraTx);
+static bool SendBridge(LORA_TX_Class_t *LoraTx);
+static bool SendFrame(LORA_TX_Class_t *LoraTx, uint8 Type, uint8 Flags, uint16 Seq, const uint8 *Data,
+                      uint16 DataLen, int64 EnqueueUsec, const LORA_FRAME_Route_t *Route);
+static bool ReceiveReport(LORA_TX_Class_t *LoraTx, uint16 Seq, uint16 *RcvdCnt);
 
 
 /******************************************************************************
@@ -60,15 +71,34 @@ static LORA_TX_Class_t *LoraTx;
 **   1. This must be called prior to any other member functions.
 **
 */
-void LORA_TX_Constructor(LORA_TX_Class_t *LoraTxPtr, const char *SemName)
+void LORA_TX_Constructor(LORA_TX_Class_t *LoraTx, INITBL_Class_t *IniTbl,
+                         const RADIO_INST_Cfg_t *Inst, RADIO_TASK_Class_t *RadioTask,
+                         RADIO_IF_Class_t *RadioIf, FREQ_HOP_Class_t *FreqHop,
+                         LINK_TEST_Class_t *LinkTest, LATENCY_Class_t *Latency, LEN_OPT_Class_t *LenOpt,
+                         STRIPE_Class_t *Stripe, LOAD_GEN_Class_t *LoadGen, QOS_Class_t *Qos,
+                         RELAY_Class_t *Relay)
 {
    
    int32 SysStatus;
-   
-   LoraTx = LoraTxPtr;
+   char  SemName[OS_MAX_API_NAME];
    
    memset(LoraTx, 0, sizeof(LORA_TX_Class_t));
    
+   LoraTx->RadioTask = RadioTask;
+   LoraTx->RadioIf   = RadioIf;
+   LoraTx->FreqHop   = FreqHop;
+   LoraTx->LinkTest  = LinkTest;
+   LoraTx->Latency   = Latency;
+   LoraTx->LenOpt    = LenOpt;
+   LoraTx->Stripe    = Stripe;
+   LoraTx->LoadGen   = LoadGen;
+   LoraTx->Qos       = Qos;
+   LoraTx->Relay     = Relay;
+   LoraTx->Radio     = Inst->Index;
+   
+   strncpy(LoraTx->DemoFile, INITBL_GetStrConfig(IniTbl, CFG_TX_DEMO_FILE), OS_MAX_PATH_LEN-1);
+   RADIO_INST_Name(SemName, sizeof(SemName), INITBL_GetStrConfig(IniTbl, CFG_TX_CHILD_SEM_NAME), Inst);
+   
    SysStatus = OS_CountSemCreate(&LoraTx->WakeUpSemaphore, SemName, 0, 0);
    
    if (SysStatus != OS_SUCCESS)
@@ -85,22 +115,46 @@ void LORA_TX_Constructor(LORA_TX_Class_t *LoraTxPtr, const char *SemName)
 **
 ** Notes:
 **   1. Returning false causes the child task to terminate.
-**   2. Information events are sent because this is instructional code and the
-**      events provide feedback. The events are filtered so they won't flood
-**      the ground. A reset app command resets the event filter.  
+**   2. The waiting for semaphore information event is instructional
+**      feedback. It's summarized so it can't flood the ground.
 */
-bool LORA_TX_ChildTask(CHILDMGR_Class_t *ChildMgr)
+bool LORA_TX_ChildTask(LORA_TX_Class_t *LoraTx)
 {
 
    LoraTx->RunStatus = CFE_SUCCESS;
    
    while (LoraTx->RunStatus == CFE_SUCCESS)
    {  
-      CFE_EVS_SendEvent (LORA_TX_CHILD_TASK_EID, CFE_EVS_EventType_INFORMATION,
-                         "Tx child task waiting for semaphore");
+      EVT_SUM_Count(EVT_SUM_TX_CHILD_WAIT, LoraTx->RunStatus);
       LoraTx->RunStatus = OS_CountSemTake(LoraTx->WakeUpSemaphore);  // Pend until parent app gives semaphore
 
-      RunDemoScript();
+      switch (LoraTx->Mode)
+      {
+         case LORA_TX_MODE_LINK_TEST:
+            if (RADIO_IF_InitRadio(LoraTx->RadioIf, RADIO_TASK_CLIENT_TX))
+            {
+               RunLinkTest(LoraTx);
+            }
+            break;
+         case LORA_TX_MODE_STRIPE:
+            if (RADIO_IF_InitRadio(LoraTx->RadioIf, RADIO_TASK_CLIENT_TX))
+            {
+               SendStripe(LoraTx);
+            }
+            STRIPE_RadioDone(LoraTx->Stripe, LoraTx->Radio);
+            break;
+         case LORA_TX_MODE_LOAD_GEN:
+         case LORA_TX_MODE_BRIDGE:
+            if (RADIO_IF_InitRadio(LoraTx->RadioIf, RADIO_TASK_CLIENT_TX))
+            {
+               SendBridge(LoraTx);
+            }
+            QOS_Stop(LoraTx->Qos);
+            break;
+         default:
+            RunDemoScript(LoraTx);
+            break;
+      }
       LoraTx->DemoActive = false;
 
    }
@@ -110,44 +164,45 @@ bool LORA_TX_ChildTask(CHILDMGR_Class_t *ChildMgr)
 } /* End LORA_TX_ChildTask() */
 
 
-/******************************************************************************
-** Function: LORA_TX_ResetStatus
-**
-** Reset counters and status flags to a known reset state.
-**
-*/
-void LORA_TX_ResetStatus(void)
-{
-
-   LoraTx->PktCnt    = 0;
-   LoraTx->PktErrCnt = 0;
-
-} /* End LORA_TX_ResetStatus() */
-
-
 /******************************************************************************
 ** Function: LORA_TX_StartDemoCmd
 **
 ** Notes:
 **   1. Signature must match CMDMGR_CmdFuncPtr_t
-**   2. DataObjPtr is not used
+**   2. The child task state is set before it's woken up.
 */
 bool LORA_TX_StartDemoCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
 {
+   LORA_TX_Class_t *LoraTx = (LORA_TX_Class_t *)DataObjPtr;
    bool   RetStatus = false;
    uint32 SysStatus;
       
+   if (LoraTx->DemoActive)
+   {
+      CFE_EVS_SendEvent(LORA_TX_START_DEMO_EID, CFE_EVS_EventType_ERROR,
+                        "Start Tx demo rejected, radio %u transmit is active", LoraTx->Radio);
+      return false;
+   }
+
+   if (!RADIO_TASK_CheckFrameSupport(LoraTx->RadioTask, "Start Tx demo"))
+   {
+      return false;
+   }
+
+   LoraTx->Mode       = LORA_TX_MODE_DEMO;
+   LoraTx->DemoActive = true;
+
    SysStatus = OS_CountSemGive(LoraTx->WakeUpSemaphore);  // Pend until parent app gives semaphore
    
    if (SysStatus == OS_SUCCESS)
    {
       RetStatus = true;
-      LoraTx->DemoActive = true;
       CFE_EVS_SendEvent (LORA_TX_START_DEMO_EID, CFE_EVS_EventType_INFORMATION,
-                         "LoRa Tx demo started");
+                         "Radio %u LoRa Tx demo started", LoraTx->Radio);
    }
    else
    {
+      LoraTx->DemoActive = false;
       CFE_EVS_SendEvent (LORA_TX_START_DEMO_EID, CFE_EVS_EventType_INFORMATION,
                          "Error starting LoRa Tx demo, semaphore status = %d", SysStatus);
    }
@@ -157,19 +212,208 @@ bool LORA_TX_StartDemoCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
 } /* LORA_TX_StartDemoCmd() */
 
 
+/******************************************************************************
+** Function: LORA_TX_StartLinkTestCmd
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**   2. The child task state is set before it's woken up.
+*/
+bool LORA_TX_StartLinkTestCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   LORA_TX_Class_t *LoraTx = (LORA_TX_Class_t *)DataObjPtr;
+   const LORA_StartLinkTest_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_StartTxLinkTest_t);
+
+   bool   RetStatus = false;
+   uint32 SysStatus;
+
+   if (LoraTx->DemoActive)
+   {
+      CFE_EVS_SendEvent(LORA_TX_LINK_TEST_EID, CFE_EVS_EventType_ERROR,
+                        "Start Tx link test rejected, a Tx demo or link test is active");
+      return false;
+   }
+
+   if (!RADIO_TASK_CheckFrameSupport(LoraTx->RadioTask, "Start Tx link test"))
+   {
+      return false;
+   }
+
+   if (LINK_TEST_Start(LoraTx->LinkTest, LORA_LinkTestRole_TX, Cmd))
+   {
+
+      LoraTx->Mode       = LORA_TX_MODE_LINK_TEST;
+      LoraTx->DemoActive = true;
+
+      SysStatus = OS_CountSemGive(LoraTx->WakeUpSemaphore);
+
+      if (SysStatus == OS_SUCCESS)
+      {
+         RetStatus = true;
+      }
+      else
+      {
+         LoraTx->DemoActive = false;
+         LINK_TEST_Cancel(LoraTx->LinkTest);
+         CFE_EVS_SendEvent(LORA_TX_LINK_TEST_EID, CFE_EVS_EventType_ERROR,
+                           "Error starting Tx link test, semaphore status = %d", SysStatus);
+      }
+
+   }
+
+   return RetStatus;
+
+} /* LORA_TX_StartLinkTestCmd() */
+
+
+/******************************************************************************
+** Function: LORA_TX_StartStripe
+**
+** Notes:
+**   1. The caller checks that the radio is idle and isn't hopping.
+**
+*/
+bool LORA_TX_StartStripe(LORA_TX_Class_t *LoraTx)
+{
+
+   bool   RetStatus = false;
+   uint32 SysStatus;
+
+   if (!RADIO_TASK_CheckFrameSupport(LoraTx->RadioTask, "Start Tx stripe"))
+   {
+      return false;
+   }
+
+   LoraTx->Mode       = LORA_TX_MODE_STRIPE;
+   LoraTx->DemoActive = true;
+
+   SysStatus = OS_CountSemGive(LoraTx->WakeUpSemaphore);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+      RetStatus = true;
+   }
+   else
+   {
+      LoraTx->DemoActive = false;
+      CFE_EVS_SendEvent(LORA_TX_STRIPE_EID, CFE_EVS_EventType_ERROR,
+                        "Error starting radio %u striped transmit, semaphore status = %d",
+                        LoraTx->Radio, SysStatus);
+   }
+
+   return RetStatus;
+
+} /* End LORA_TX_StartStripe() */
+
+
+/******************************************************************************
+** Function: LORA_TX_StartLoadGen
+**
+** Notes:
+**   1. The caller checks that the radio is idle.
+**
+*/
+bool LORA_TX_StartLoadGen(LORA_TX_Class_t *LoraTx)
+{
+
+   bool   RetStatus = false;
+   uint32 SysStatus;
+
+   if (!RADIO_TASK_CheckFrameSupport(LoraTx->RadioTask, "Start load generator"))
+   {
+      return false;
+   }
+
+   LoraTx->Mode       = LORA_TX_MODE_LOAD_GEN;
+   LoraTx->DemoActive = true;
+
+   SysStatus = OS_CountSemGive(LoraTx->WakeUpSemaphore);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+      RetStatus = true;
+   }
+   else
+   {
+      LoraTx->DemoActive = false;
+      CFE_EVS_SendEvent(LORA_TX_LOAD_GEN_EID, CFE_EVS_EventType_ERROR,
+                        "Error starting radio %u load generator transmit, semaphore status = %d",
+                        LoraTx->Radio, SysStatus);
+   }
+
+   return RetStatus;
+
+} /* End LORA_TX_StartLoadGen() */
+
+
+/******************************************************************************
+** Function: LORA_TX_StartBridgeCmd
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+*/
+bool LORA_TX_StartBridgeCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   LORA_TX_Class_t *LoraTx = (LORA_TX_Class_t *)DataObjPtr;
+   bool   RetStatus = false;
+   uint32 SysStatus;
+
+   if (LoraTx->DemoActive)
+   {
+      CFE_EVS_SendEvent(LORA_TX_BRIDGE_EID, CFE_EVS_EventType_ERROR,
+                        "Start Tx bridge rejected, radio %u transmit is active", LoraTx->Radio);
+      return false;
+   }
+
+   if (!RADIO_TASK_CheckFrameSupport(LoraTx->RadioTask, "Start Tx bridge"))
+   {
+      return false;
+   }
+
+   if (!QOS_Start(LoraTx->Qos, LoraTx->Radio, true, RELAY_Enabled(LoraTx->Relay)))
+   {
+      return false;
+   }
+
+   LoraTx->Mode       = LORA_TX_MODE_BRIDGE;
+   LoraTx->DemoActive = true;
+
+   SysStatus = OS_CountSemGive(LoraTx->WakeUpSemaphore);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+      RetStatus = true;
+   }
+   else
+   {
+      LoraTx->DemoActive = false;
+      QOS_Stop(LoraTx->Qos);
+      CFE_EVS_SendEvent(LORA_TX_BRIDGE_EID, CFE_EVS_EventType_ERROR,
+                        "Error starting radio %u Tx bridge, semaphore status = %d",
+                        LoraTx->Radio, SysStatus);
+   }
+
+   return RetStatus;
+
+} /* End LORA_TX_StartBridgeCmd() */
+
+
 /******************************************************************************
 ** Function: LORA_TX_StopDemoCmd
 **
 ** Notes:
 **   1. Signature must match CMDMGR_CmdFuncPtr_t
-**   2. DataObjPtr is not used
 */
 bool LORA_TX_StopDemoCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
 {
    
+   LORA_TX_Class_t *LoraTx = (LORA_TX_Class_t *)DataObjPtr;
+
    LoraTx->DemoActive = false;
    CFE_EVS_SendEvent (LORA_TX_STOP_DEMO_EID, CFE_EVS_EventType_INFORMATION,
-                      "LoRa Tx demo stopped");
+                      "Radio %u LoRa Tx demo stopped", LoraTx->Radio);
    return true;
 
 } /* LORA_TX_StopDemoCmd() */
@@ -182,14 +426,14 @@ bool LORA_TX_StopDemoCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
 **   1. This function is based on lora_tx.cpp. The original code is used as
 **      comment blocks. s
 */
-static bool RunDemoScript(void)
+static bool RunDemoScript(LORA_TX_Class_t *LoraTx)
 {
    
    bool RetStatus = false;
    bool RadioStatus;
    
    CFE_EVS_SendEvent (LORA_TX_STOP_DEMO_EID, CFE_EVS_EventType_INFORMATION,
-                      "Starting transmit demo");
+                      "Starting radio %u transmit demo", LoraTx->Radio);
    
    /** lora_tx.cpp
       // Pins based on hardware configuration
@@ -215,7 +459,7 @@ static bool RunDemoScript(void)
       puts("SetTxParams done");
    lora_tx.cpp **/
 
-   RadioStatus = RADIO_SetStandbyMode(SX128X_StandbyMode_XOSC);
+   RadioStatus = RADIO_TASK_SetStandbyMode(LoraTx->RadioTask, RADIO_TASK_CLIENT_TX, SX128X_StandbyMode_XOSC);
    if (RadioStatus)
    {
       CFE_EVS_SendEvent(LORA_TX_DEMO_SCRIPT_EID, CFE_EVS_EventType_INFORMATION,
@@ -228,7 +472,7 @@ static bool RunDemoScript(void)
    }
    OS_TaskDelay(1000);
 
-   RadioStatus = RADIO_SetPowerRegulatorMode(SX128X_PowerRegulatorMode_USE_LDO);
+   RadioStatus = RADIO_TASK_SetPowerRegulatorMode(LoraTx->RadioTask, RADIO_TASK_CLIENT_TX, SX128X_PowerRegulatorMode_USE_LDO);
    if (RadioStatus)
    {
       CFE_EVS_SendEvent(LORA_TX_DEMO_SCRIPT_EID, CFE_EVS_EventType_INFORMATION,
@@ -241,7 +485,7 @@ static bool RunDemoScript(void)
    }
    OS_TaskDelay(1000);
 
-   RadioStatus = RADIO_SetLowNoiseAmpMode(SX128X_LowNoiseAmpMode_HIGH_SENSITIVITY);
+   RadioStatus = RADIO_TASK_SetLowNoiseAmpMode(LoraTx->RadioTask, RADIO_TASK_CLIENT_TX, SX128X_LowNoiseAmpMode_HIGH_SENSITIVITY);
    if (RadioStatus)
    {
       CFE_EVS_SendEvent(LORA_TX_DEMO_SCRIPT_EID, CFE_EVS_EventType_INFORMATION,
@@ -254,7 +498,7 @@ static bool RunDemoScript(void)
    }
    OS_TaskDelay(1000);
 
-   RadioStatus = RADIO_SetPowerAmpRampTime(SX128X_PowerAmpRampTime_20_US);
+   RadioStatus = RADIO_TASK_SetPowerAmpRampTime(LoraTx->RadioTask, RADIO_TASK_CLIENT_TX, SX128X_PowerAmpRampTime_20_US);
    if (RadioStatus)
    {
       CFE_EVS_SendEvent(LORA_TX_DEMO_SCRIPT_EID, CFE_EVS_EventType_INFORMATION,
@@ -389,8 +633,527 @@ static bool RunDemoScript(void)
       }
    lora_tx.cpp **/
 
+   if (RADIO_IF_InitRadio(LoraTx->RadioIf, RADIO_TASK_CLIENT_TX))
+   {
+      RetStatus = SendDemoFile(LoraTx);
+   }
+
    return RetStatus;
 
 } /* RunDemoScript() */
 
 
+/******************************************************************************
+** Function: RunLinkTest
+**
+** Notes:
+**   1. Each step starts with a gap that gives the receiver time to switch to
+**      the step's modulation.
+**   2. Frame sequence numbers count frames across all steps, see
+**      link_test.h.
+*/
+static bool RunLinkTest(LORA_TX_Class_t *LoraTx)
+{
+
+   LINK_TEST_Class_t *LinkTest = LoraTx->LinkTest;
+   uint16 StepIdx;
+   uint16 StepCnt = LINK_TEST_StepCnt(LinkTest);
+   uint16 FramesPerStep = LINK_TEST_FramesPerStep(LinkTest);
+   uint16 DataLen = LINK_TEST_DataLen(LinkTest);
+   uint16 Frame;
+   uint32 FrameIdx = 0;
+   uint8  Data[LINK_TEST_MAX_DATA_LEN];
+
+   FREQ_HOP_Start(LoraTx->FreqHop);
+
+   for (StepIdx=0; StepIdx < StepCnt && LoraTx->DemoActive; StepIdx++)
+   {
+
+      if (!LINK_TEST_BeginStep(LinkTest, RADIO_TASK_CLIENT_TX, StepIdx))
+      {
+         break;
+      }
+      OS_TaskDelay(LINK_TEST_StepGapMs(LinkTest));
+
+      for (Frame=0; Frame < FramesPerStep && LoraTx->DemoActive; Frame++, FrameIdx++)
+      {
+         LINK_TEST_FillData(LinkTest, FrameIdx, Data);
+         LINK_TEST_RecordTx(LinkTest, SendFrame(LoraTx, LORA_FRAME_TYPE_LINK_TEST, 0, (uint16)FrameIdx, Data, DataLen, 0, NULL));
+      }
+
+      LINK_TEST_EndStep(LinkTest);
+
+   } /* End step loop */
+
+   LINK_TEST_Stop(LinkTest, RADIO_TASK_CLIENT_TX);
+
+   return (StepIdx == StepCnt);
+
+} /* End RunLinkTest() */
+
+
+/******************************************************************************
+** Function: SendDemoFile
+**
+** Notes:
+**   1. Follows lora_tx.cpp: the first packet contains the number of file
+**      packets as text followed by the file in LORA_DEMO_PACKET_SIZE packets.
+**      Each packet is sent in a frame whose sequence number is the packet's
+**      position so the receiver can place it in the file after losses.
+**   2. SendPayload() returns after txDone so the lora_tx.cpp time-on-air
+**      sleep isn't needed.
+**   3. The transfer ends early if a stop demo command is received.
+**   4. With LEN_OPT_WINDOW set the file is sent in segments of optimized
+**      length instead, see len_opt.h. Hopping transfers keep the fixed
+**      packets.
+**   5. The file start frame also has the file size and the implicit header
+**      frame length as text, 0 when the packets use an explicit header.
+**      After it both ends switch to an implicit header and each data frame
+**      is padded to the length. The receiver trims the padding using the
+**      file size. Without the LoRa header and its length check a receiver
+**      that missed the file start frame hears none of the data frames so
+**      it's sent LORA_TX_FILE_START_CNT times, and the first data frame
+**      waits LORA_TX_IMPLICIT_TURNAROUND_MS for the receiver's switch.
+*/
+static bool SendDemoFile(LORA_TX_Class_t *LoraTx)
+{
+
+   bool       RetStatus;
+   int32      SysStatus;
+   osal_id_t  FileHandle;
+   os_fstat_t FileStats;
+   uint32     FilePktCnt;
+   uint32     SentPktCnt = 0;
+   uint16     Seq = 0;
+   int32      ReadLen;
+   uint16     DataFrameLen;
+   uint16     i;
+   char       FileStartText[36];
+   uint8      Packet[LORA_DEMO_PACKET_SIZE];
+   const LORA_SetPacketParams_CmdPayload_t *PacketParams = RADIO_IF_GetPacketParams(LoraTx->RadioIf);
+
+   SysStatus = OS_stat(LoraTx->DemoFile, &FileStats);
+   if (SysStatus == OS_SUCCESS)
+   {
+      SysStatus = OS_OpenCreate(&FileHandle, LoraTx->DemoFile, OS_FILE_FLAG_NONE, OS_READ_ONLY);
+   }
+
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(LORA_TX_DEMO_FILE_EID, CFE_EVS_EventType_ERROR,
+                        "Error opening transmit demo file %s, Status = %d", LoraTx->DemoFile, SysStatus);
+      return false;
+   }
+
+   if (LEN_OPT_Enabled(LoraTx->LenOpt) && !FREQ_HOP_Enabled(LoraTx->FreqHop))
+   {
+      RetStatus = SendFileSegs(LoraTx, FileHandle, OS_FILESTAT_SIZE(FileStats));
+      OS_close(FileHandle);
+      return RetStatus;
+   }
+
+   FilePktCnt = (OS_FILESTAT_SIZE(FileStats) + LORA_DEMO_PACKET_SIZE - 1) / LORA_DEMO_PACKET_SIZE;
+
+   CFE_EVS_SendEvent(LORA_TX_DEMO_FILE_EID, CFE_EVS_EventType_INFORMATION,
+                     "Sending %d packets (%d bytes) from %s", FilePktCnt,
+                     (int)OS_FILESTAT_SIZE(FileStats), LoraTx->DemoFile);
+
+   LoraTx->FixedLen = 0;
+   if (PacketParams->HeaderType == LORA_HeaderType_IMPLICIT)
+   {
+      DataFrameLen = LORA_FRAME_MIN_HDR_LEN + LATENCY_MaxStampLen(LoraTx->Latency) +
+                     (FREQ_HOP_Enabled(LoraTx->FreqHop) ? 4 : 0) + LORA_DEMO_PACKET_SIZE;
+      if (PacketParams->PayloadLen >= DataFrameLen)
+      {
+         LoraTx->FixedLen = PacketParams->PayloadLen;
+      }
+      else
+      {
+         CFE_EVS_SendEvent(LORA_TX_DEMO_FILE_EID, CFE_EVS_EventType_ERROR,
+                           "Implicit header length %d is shorter than the %d byte data frames, using an explicit header",
+                           PacketParams->PayloadLen, DataFrameLen);
+      }
+   }
+
+   FREQ_HOP_Start(LoraTx->FreqHop);
+
+   snprintf(FileStartText, sizeof(FileStartText), "%u %u %u", (unsigned int)FilePktCnt,
+            (unsigned int)OS_FILESTAT_SIZE(FileStats), LoraTx->FixedLen);
+   for (i=0; i < ((LoraTx->FixedLen > 0) ? LORA_TX_FILE_START_CNT : 1); i++)
+   {
+      SendFrame(LoraTx, LORA_FRAME_TYPE_FILE_START, 0, Seq, (uint8 *)FileStartText, strlen(FileStartText), 0, NULL);
+   }
+
+   if (LoraTx->FixedLen > 0)
+   {
+      if (!RADIO_TASK_SetHeaderType(LoraTx->RadioTask, RADIO_TASK_CLIENT_TX, LORA_HeaderType_IMPLICIT, LoraTx->FixedLen))
+      {
+         CFE_EVS_SendEvent(LORA_TX_DEMO_FILE_EID, CFE_EVS_EventType_ERROR,
+                           "Error setting an implicit header with length %d, transfer abandoned", LoraTx->FixedLen);
+         LoraTx->FixedLen = 0;
+         OS_close(FileHandle);
+         return false;
+      }
+      OS_TaskDelay(LORA_TX_IMPLICIT_TURNAROUND_MS);
+   }
+
+   while (LoraTx->DemoActive)
+   {
+
+      ReadLen = OS_read(FileHandle, Packet, LORA_DEMO_PACKET_SIZE);
+      if (ReadLen <= 0)
+      {
+         break;
+      }
+
+      if (SendFrame(LoraTx, LORA_FRAME_TYPE_FILE_DATA, 0, ++Seq, Packet, ReadLen, 0, NULL))
+      {
+         SentPktCnt++;
+      }
+
+   } /* End packet loop */
+
+   OS_close(FileHandle);
+
+   if (LoraTx->FixedLen > 0)
+   {
+      LoraTx->FixedLen = 0;
+      RADIO_TASK_SetHeaderType(LoraTx->RadioTask, RADIO_TASK_CLIENT_TX, LORA_HeaderType_EXPLICIT, 0);
+   }
+
+   CFE_EVS_SendEvent(LORA_TX_DEMO_FILE_EID, CFE_EVS_EventType_INFORMATION,
+                     "Transmit demo %s: sent %d of %d packets",
+                     (LoraTx->DemoActive ? "complete" : "stopped"), SentPktCnt, FilePktCnt);
+
+   return (SentPktCnt == FilePktCnt);
+
+} /* End SendDemoFile() */
+
+
+/******************************************************************************
+** Function: SendFileSegs
+**
+** Send the demo file in segments whose length is chosen for each window
+**
+** Notes:
+**   1. See len_opt.h for the protocol. The file start frame contains the
+**      file size as text and segment frames are numbered from 1.
+**   2. The file's last segment always requests a report so the last
+**      window is measured too.
+**   3. The segment frame overhead excludes the occasional clock exchange.
+*/
+static bool SendFileSegs(LORA_TX_Class_t *LoraTx, osal_id_t FileHandle, uint32 FileSize)
+{
+
+   LEN_OPT_Class_t *LenOpt = LoraTx->LenOpt;
+   bool   Sent;
+   bool   ReportReq;
+   uint16 Seq = 0;
+   uint16 SegLen;
+   uint16 WindowFrameCnt = 0;
+   uint16 RcvdCnt;
+   uint32 Offset = 0;
+   uint32 SentCnt = 0;
+   uint32 SentByteCnt = 0;
+   int32  ReadLen;
+   char   FileSizeText[12];
+   uint8  Seg[LORA_FRAME_SEG_OFFSET_LEN + LEN_OPT_MAX_LEN];
+
+   CFE_EVS_SendEvent(LORA_TX_DEMO_FILE_EID, CFE_EVS_EventType_INFORMATION,
+                     "Sending %u bytes from %s with optimized payload lengths",
+                     (unsigned int)FileSize, LoraTx->DemoFile);
+
+   FREQ_HOP_Start(LoraTx->FreqHop);
+
+   snprintf(FileSizeText, sizeof(FileSizeText), "%u", (unsigned int)FileSize);
+   SendFrame(LoraTx, LORA_FRAME_TYPE_FILE_START, 0, Seq, (uint8 *)FileSizeText, strlen(FileSizeText), 0, NULL);
+
+   SegLen = LEN_OPT_Start(LenOpt, LoraTx->RadioIf, LORA_FRAME_MIN_HDR_LEN + LATENCY_StampLen(LoraTx->Latency) +
+                                                   LORA_FRAME_SEG_OFFSET_LEN);
+
+   while (LoraTx->DemoActive && Offset < FileSize)
+   {
+
+      ReadLen = OS_read(FileHandle, &Seg[LORA_FRAME_SEG_OFFSET_LEN], SegLen);
+      if (ReadLen <= 0)
+      {
+         break;
+      }
+
+      Seg[0] = (uint8)(Offset >> 24);
+      Seg[1] = (uint8)(Offset >> 16);
+      Seg[2] = (uint8)(Offset >> 8);
+      Seg[3] = (uint8)(Offset);
+      Offset += ReadLen;
+
+      ReportReq = (++WindowFrameCnt >= LEN_OPT_WindowLen(LenOpt) || Offset >= FileSize);
+
+      Sent = SendFrame(LoraTx, LORA_FRAME_TYPE_FILE_SEG, ReportReq ? LORA_FRAME_FLAG_REPORT_REQ : 0, ++Seq,
+                       Seg, LORA_FRAME_SEG_OFFSET_LEN + ReadLen, 0, NULL);
+      if (Sent)
+      {
+         SentCnt++;
+         SentByteCnt += ReadLen;
+      }
+
+      if (ReportReq)
+      {
+         WindowFrameCnt = 0;
+         if (Sent && ReceiveReport(LoraTx, Seq, &RcvdCnt))
+         {
+            SegLen = LEN_OPT_RecordReport(LenOpt, SentCnt, RcvdCnt);
+         }
+         else
+         {
+            LEN_OPT_RecordMissedReport(LenOpt);
+         }
+      }
+
+   } /* End segment loop */
+
+   LEN_OPT_Stop(LenOpt);
+
+   CFE_EVS_SendEvent(LORA_TX_DEMO_FILE_EID, CFE_EVS_EventType_INFORMATION,
+                     "Transmit demo %s: sent %u of %u bytes in %u frames, last payload length %u",
+                     (LoraTx->DemoActive ? "complete" : "stopped"), (unsigned int)SentByteCnt,
+                     (unsigned int)FileSize, (unsigned int)SentCnt, SegLen);
+
+   return (SentByteCnt == FileSize);
+
+} /* End SendFileSegs() */
+
+
+/******************************************************************************
+** Function: SendStripe
+**
+** Send frames claimed from the striped transfer until there are none left
+**
+** Notes:
+**   1. See stripe.h for how packets are shared between the radios. Striped
+**      radios don't hop so a frame's header only has the latency fields.
+**   2. A stop demo command stops this radio and leaves its packets to the
+**      other radios.
+**
+*/
+static bool SendStripe(LORA_TX_Class_t *LoraTx)
+{
+
+   bool   Sent;
+   uint8  Type;
+   uint16 Seq;
+   uint16 DataLen;
+   uint8  Packet[LORA_DEMO_PACKET_SIZE];
+
+   while (LoraTx->DemoActive &&
+          STRIPE_NextTxPkt(LoraTx->Stripe, LoraTx->Radio, &Type, &Seq, Packet, &DataLen))
+   {
+      Sent = SendFrame(LoraTx, Type, 0, Seq, Packet, DataLen, 0, NULL);
+      STRIPE_RecordTx(LoraTx->Stripe, LoraTx->Radio, Seq, Sent, DataLen,
+                      RADIO_IF_TimeOnAir(LoraTx->RadioIf, LoraTx->HdrLen + DataLen));
+   }
+
+   return LoraTx->DemoActive;
+
+} /* End SendStripe() */
+
+
+/******************************************************************************
+** Function: SendBridge
+**
+** Send the QoS scheduler's messages until a stop demo command or, for a load
+** generator run, until the run has drained
+**
+** Notes:
+**   1. See qos.h and load_gen.h. Messages still queued when the bridge
+**      stops are shed by QOS_Stop().
+**   2. Replays from the store share the frame sequence with live messages
+**      so the receiver's frame and hop tracking sees one stream.
+**   3. With relaying enabled a bridge sends beacons between messages,
+**      addresses its own messages with a route field and sends the frames
+**      the Rx bridge queued for forwarding. See relay.h.
+**   4. A replay the store resends after an ack timeout is counted as a
+**      retransmit in the radio metrics.
+**
+*/
+static bool SendBridge(LORA_TX_Class_t *LoraTx)
+{
+
+   bool   Sent;
+   uint8  Type;
+   uint16 Seq = 0;
+   uint16 BeaconLen;
+   uint8  Beacon[RELAY_MAX_BEACON_LEN];
+   QOS_TxMsg_t TxMsg;
+   LORA_FRAME_Route_t Route;
+   const LORA_FRAME_Route_t *TxRoute;
+
+   while (LoraTx->DemoActive)
+   {
+      if (LoraTx->Mode == LORA_TX_MODE_BRIDGE && RELAY_NextBeacon(LoraTx->Relay, &Route, Beacon, &BeaconLen))
+      {
+         RELAY_RecordBeaconTx(LoraTx->Relay, SendFrame(LoraTx, LORA_FRAME_TYPE_BEACON, 0, Seq++,
+                                                       Beacon, BeaconLen, 0, &Route));
+      }
+
+      if (QOS_NextTx(LoraTx->Qos, &TxMsg))
+      {
+         if (TxMsg.FwdType != 0)
+         {
+            Type    = TxMsg.FwdType;
+            TxRoute = &TxMsg.Route;
+         }
+         else
+         {
+            Type    = TxMsg.Stored ? LORA_FRAME_TYPE_SB_STORED : LORA_FRAME_TYPE_SB_MSG;
+            TxRoute = (LoraTx->Mode == LORA_TX_MODE_BRIDGE && RELAY_Originate(LoraTx->Relay, &Route)) ? &Route : NULL;
+         }
+         Sent = SendFrame(LoraTx, Type, 0, Seq++, TxMsg.Data, TxMsg.DataLen, TxMsg.EnqueueUsec, TxRoute);
+         if (Sent && TxMsg.Resend)
+         {
+            LORA_METRICS_Add(LoraTx->Radio, LORA_METRICS_TASK_TX, LORA_METRICS_TX_RETRANSMIT, 1);
+         }
+         QOS_RecordTx(LoraTx->Qos, &TxMsg, Sent,
+                      RADIO_IF_TimeOnAir(LoraTx->RadioIf, LoraTx->HdrLen + TxMsg.DataLen));
+         LOAD_GEN_RecordTx(LoraTx->LoadGen, &TxMsg, Sent);
+      }
+      else if (LoraTx->Mode == LORA_TX_MODE_LOAD_GEN && !LOAD_GEN_Active(LoraTx->LoadGen))
+      {
+         break;
+      }
+   }
+
+   return LoraTx->DemoActive;
+
+} /* End SendBridge() */
+
+
+/******************************************************************************
+** Function: SendFrame
+**
+** Notes:
+**   1. When hopping, the radio is tuned to the frame's hop channel and the
+**      frame carries the current channel blacklist so the receiver follows
+**      blacklist changes.
+**   2. EnqueueUsec is when the frame's data was queued for the radio, 0 if
+**      it's queued by this call. See latency.h.
+**   3. The header length varies with its optional fields, it's saved in
+**      HdrLen for the caller's time on air.
+**   4. Flags are the caller's header flags that have no field, for
+**      example a report request.
+**   5. With an implicit header the frame is padded to FixedLen.
+**   6. Route is NULL for a frame without a route field.
+*/
+static bool SendFrame(LORA_TX_Class_t *LoraTx, uint8 Type, uint8 Flags, uint16 Seq, const uint8 *Data,
+                      uint16 DataLen, int64 EnqueueUsec, const LORA_FRAME_Route_t *Route)
+{
+
+   bool   RetStatus = false;
+   uint16 FrameLen;
+   uint8  Frame[LORA_FRAME_MAX_LEN];
+   OS_time_t EncodeTime;
+   LORA_FRAME_Hdr_t FrameHdr;
+
+   FRAME_TRACE_Record(LoraTx->Radio, FRAME_TRACE_TASK_TX, FRAME_TRACE_TX_ENQUEUE, Seq, (uint8)DataLen, NULL);
+
+   FrameHdr.Type    = Type;
+   FrameHdr.Flags   = Flags;
+   FrameHdr.Seq     = Seq;
+   FrameHdr.HopMask = 0;
+
+   if (Route != NULL)
+   {
+      FrameHdr.Flags |= LORA_FRAME_FLAG_ROUTE;
+      FrameHdr.Route  = *Route;
+   }
+
+   if (FREQ_HOP_Enabled(LoraTx->FreqHop))
+   {
+      FrameHdr.Flags  |= LORA_FRAME_FLAG_HOP_MASK;
+      FrameHdr.HopMask = FREQ_HOP_GetBlacklist(LoraTx->FreqHop);
+      if (FREQ_HOP_Tune(LoraTx->FreqHop, RADIO_TASK_CLIENT_TX, Seq))
+      {
+         FREQ_HOP_RecordFrame(LoraTx->FreqHop, Seq, false);
+      }
+      else
+      {
+         LORA_METRICS_Add(LoraTx->Radio, LORA_METRICS_TASK_TX, LORA_METRICS_TX_ERR, 1);
+         return false;
+      }
+   }
+
+   OS_GetLocalTime(&EncodeTime);
+   LATENCY_StampTx(LoraTx->Latency, &FrameHdr, EnqueueUsec, OS_TimeGetTotalMicroseconds(EncodeTime));
+   FrameLen = LORA_FRAME_EncodeHdr(Frame, &FrameHdr);
+   LoraTx->HdrLen = FrameLen;
+   memcpy(&Frame[FrameLen], Data, DataLen);
+   FrameLen += DataLen;
+   if (LoraTx->FixedLen > 0)
+   {
+      if (FrameLen > LoraTx->FixedLen)
+      {
+         LORA_METRICS_Add(LoraTx->Radio, LORA_METRICS_TASK_TX, LORA_METRICS_TX_ERR, 1);
+         return false;
+      }
+      memset(&Frame[FrameLen], 0, LoraTx->FixedLen - FrameLen);
+      FrameLen = LoraTx->FixedLen;
+   }
+   FRAME_TRACE_Record(LoraTx->Radio, FRAME_TRACE_TASK_TX, FRAME_TRACE_TX_ENCODE, Seq, (uint8)FrameLen, &EncodeTime);
+
+   RetStatus = RADIO_TASK_SendPayload(LoraTx->RadioTask, RADIO_TASK_CLIENT_TX, Frame, FrameLen, LORA_TX_SEND_TIMEOUT_MS);
+
+   if (RetStatus)
+   {
+      LORA_METRICS_Add(LoraTx->Radio, LORA_METRICS_TASK_TX, LORA_METRICS_TX_FRAME, 1);
+      LORA_METRICS_Add(LoraTx->Radio, LORA_METRICS_TASK_TX, LORA_METRICS_TX_DATA_BYTE, DataLen);
+   }
+   else
+   {
+      LORA_METRICS_Add(LoraTx->Radio, LORA_METRICS_TASK_TX, LORA_METRICS_TX_ERR, 1);
+   }
+
+   return RetStatus;
+
+} /* End SendFrame() */
+
+
+/******************************************************************************
+** Function: ReceiveReport
+**
+** Wait for the receiver's report answering the frame sent with Seq
+**
+** Notes:
+**   1. Called right after the request's txDone. The receiver answers on
+**      the same channel so the radio doesn't need to be retuned.
+**   2. Returns false if no matching report arrives within the report
+**      timeout, a late report is dropped by the next wait.
+*/
+static bool ReceiveReport(LORA_TX_Class_t *LoraTx, uint16 Seq, uint16 *RcvdCnt)
+{
+
+   uint8  Frame[LORA_FRAME_MAX_LEN];
+   uint8  FrameLen;
+   uint16 HdrLen;
+   int8   Rssi;
+   int8   Snr;
+   LORA_FRAME_Hdr_t FrameHdr;
+
+   if (!RADIO_TASK_ReceivePayload(LoraTx->RadioTask, RADIO_TASK_CLIENT_TX, Frame, &FrameLen, LORA_FRAME_MAX_LEN,
+                                  &Rssi, &Snr, LEN_OPT_ReportTimeoutMs(LoraTx->LenOpt)))
+   {
+      return false;
+   }
+
+   HdrLen = LORA_FRAME_DecodeHdr(Frame, FrameLen, &FrameHdr);
+   if (HdrLen == 0 || FrameHdr.Type != LORA_FRAME_TYPE_RX_REPORT || FrameHdr.Seq != Seq ||
+       FrameLen < HdrLen + LORA_FRAME_REPORT_LEN)
+   {
+      return false;
+   }
+
+   *RcvdCnt = (Frame[HdrLen] << 8) | Frame[HdrLen+1];
+
+   return true;
+
+} /* End ReceiveReport() */
+
+
@@ -28,13 +28,31 @@
 */
 
 #include "app_cfg.h"
-#include "radio.h"
+#include "radio_inst.h"
+#include "radio_task.h"
+#include "radio_if.h"
+#include "freq_hop.h"
+#include "latency.h"
+#include "len_opt.h"
+#include "link_test.h"
+#include "load_gen.h"
+#include "qos.h"
+#include "relay.h"
+#include "stripe.h"
 
 
 /***********************/
 /** Macro Definitions **/
 /***********************/
 
+#define LORA_TX_SEND_TIMEOUT_MS  1000  /* Same as lora_tx.cpp */
+
+/* An implicit header transfer's file start frame is repeated and the first
+** data frame waits at least one radio task receive slice for the receiver
+** to switch its header, see lora_tx.c SendDemoFile() */
+#define LORA_TX_FILE_START_CNT          3
+#define LORA_TX_IMPLICIT_TURNAROUND_MS  RADIO_TASK_RX_SLICE_MS
+
 
 /*
 ** Event Message IDs
@@ -46,19 +64,60 @@
 #define LORA_TX_START_DEMO_EID            (LORA_TX_BASE_EID + 3)
 #define LORA_TX_DEMO_SCRIPT_EID           (LORA_TX_BASE_EID + 4)
 #define LORA_TX_STOP_DEMO_EID             (LORA_TX_BASE_EID + 5)
+#define LORA_TX_DEMO_FILE_EID             (LORA_TX_BASE_EID + 6)
+#define LORA_TX_LINK_TEST_EID             (LORA_TX_BASE_EID + 7)
+#define LORA_TX_STRIPE_EID                (LORA_TX_BASE_EID + 8)
+#define LORA_TX_LOAD_GEN_EID              (LORA_TX_BASE_EID + 9)
+#define LORA_TX_BRIDGE_EID                (LORA_TX_BASE_EID + 10)
 
 /**********************/
 /** Type Definitions **/
 /**********************/
 
+typedef enum
+{
+
+   LORA_TX_MODE_DEMO = 0,
+   LORA_TX_MODE_LINK_TEST,
+   LORA_TX_MODE_STRIPE,    /* Send this radio's share of a striped transfer */
+   LORA_TX_MODE_LOAD_GEN,  /* Send the load generator's forwarded messages */
+   LORA_TX_MODE_BRIDGE     /* Send the QoS scheduler's bridged messages */
+
+} LORA_TX_Mode_t;
+
+
 typedef struct
 {
+
+   /*
+   ** Object References
+   */
+
+   RADIO_TASK_Class_t *RadioTask;
+   RADIO_IF_Class_t   *RadioIf;
+   FREQ_HOP_Class_t   *FreqHop;
+   LINK_TEST_Class_t  *LinkTest;
+   LATENCY_Class_t    *Latency;
+   LEN_OPT_Class_t    *LenOpt;
+   STRIPE_Class_t     *Stripe;
+   LOAD_GEN_Class_t   *LoadGen;
+   QOS_Class_t        *Qos;
+   RELAY_Class_t      *Relay;
+
+   /*
+   ** Class State Data
+   */
+
+   uint8   Radio;
    int32   RunStatus;
    uint32  WakeUpSemaphore;
    
    bool    DemoActive;
-   uint32  PktCnt;
-   uint32  PktErrCnt;
+   LORA_TX_Mode_t Mode;
+   uint16  HdrLen;          /* Header length of the last frame encoded */
+   uint8   FixedLen;        /* Implicit header frame length, 0 sends variable length frames */
+   
+   char    DemoFile[OS_MAX_PATH_LEN];
    
 } LORA_TX_Class_t;
 
@@ -77,33 +136,77 @@ typedef struct
 **   1. This must be called prior to any other member functions.
 **
 */
-void LORA_TX_Constructor(LORA_TX_Class_t *LoraTxPtr, const char *SemName);
+void LORA_TX_Constructor(LORA_TX_Class_t *LoraTx, INITBL_Class_t *IniTbl,
+                         const RADIO_INST_Cfg_t *Inst, RADIO_TASK_Class_t *RadioTask,
+                         RADIO_IF_Class_t *RadioIf, FREQ_HOP_Class_t *FreqHop,
+                         LINK_TEST_Class_t *LinkTest, LATENCY_Class_t *Latency, LEN_OPT_Class_t *LenOpt,
+                         STRIPE_Class_t *Stripe, LOAD_GEN_Class_t *LoadGen, QOS_Class_t *Qos,
+                         RELAY_Class_t *Relay);
 
 
 /******************************************************************************
 ** Function: LORA_TX_ChildTask
 **
+** Notes:
+**   1. Called by the app's child manager callback for the radio.
+**
 */
-bool LORA_TX_ChildTask(CHILDMGR_Class_t *ChildMgr);
+bool LORA_TX_ChildTask(LORA_TX_Class_t *LoraTx);
 
 
 /******************************************************************************
-** Function: LORA_TX_ResetStatus
+** Function: LORA_TX_StartDemoCmd
 **
-** Reset counters and status flags to a known reset state.
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+*/
+bool LORA_TX_StartDemoCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: LORA_TX_StartLinkTestCmd
 **
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**   2. The receiver must be started first, see link_test.h.
 */
-void LORA_TX_ResetStatus(void);
+bool LORA_TX_StartLinkTestCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
 
 
 /******************************************************************************
-** Function: LORA_TX_StartDemoCmd
+** Function: LORA_TX_StartStripe
+**
+** Start sending this radio's share of a striped transfer
+**
+** Notes:
+**   1. Called by the app's start stripe command after STRIPE_Start().
+**
+*/
+bool LORA_TX_StartStripe(LORA_TX_Class_t *LoraTx);
+
+
+/******************************************************************************
+** Function: LORA_TX_StartLoadGen
+**
+** Start sending the load generator's forwarded messages
+**
+** Notes:
+**   1. Called by the app's start load generator command after QOS_Start()
+**      and LOAD_GEN_Start(). The task stops when the run has drained.
+**
+*/
+bool LORA_TX_StartLoadGen(LORA_TX_Class_t *LoraTx);
+
+
+/******************************************************************************
+** Function: LORA_TX_StartBridgeCmd
 **
 ** Notes:
 **   1. Signature must match CMDMGR_CmdFuncPtr_t
-**   2. DataObjPtr is not used
+**   2. Sends the QOS_MID_MAP topics, see qos.h, until a stop demo command.
+**      Only one radio bridges at a time.
 */
-bool LORA_TX_StartDemoCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+bool LORA_TX_StartBridgeCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
 
 
 /******************************************************************************
@@ -111,7 +214,7 @@ bool LORA_TX_StartDemoCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
 **
 ** Notes:
 **   1. Signature must match CMDMGR_CmdFuncPtr_t
-**   2. DataObjPtr is not used
+**   2. Also stops a link test
 */
 bool LORA_TX_StopDemoCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
 
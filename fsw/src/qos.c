@@ -0,0 +1,1084 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the bridged message quality of service scheduler
+**
+**  Notes:
+**    1. The queue is short so the earliest deadline is found with a scan
+**       rather than a heap, a scan also sheds every expired message on the
+**       way.
+**    2. The airtime budget is a token bucket of microseconds filled at
+**       AirtimePpt per thousand of real time and holding at most one
+**       second's budget. A frame is sent when the bucket isn't empty and
+**       its airtime is taken afterwards so the long term share is exact.
+**    3. While the link is down nothing is on the air so the budget isn't
+**       used and messages are stored as soon as they're queued.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "qos.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define QOS_MUTEX_NAME   "LORA_QOS_MUT"
+#define QOS_TX_SEM_NAME  "LORA_QOS_SEM"
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static QOS_Entry_t *AllocEntry(QOS_Class_t *Qos, uint8 Priority);
+static bool   Before(const QOS_Class_t *Qos, const QOS_Entry_t *A, const QOS_Entry_t *B);
+static int16  FindMid(const QOS_Class_t *Qos, CFE_SB_MsgId_t MsgId);
+static bool   NextReplay(QOS_Class_t *Qos, QOS_TxMsg_t *TxMsg);
+static int64  NowUsec(void);
+static void   ParseClasses(QOS_Class_t *Qos, const char *ClassStr);
+static void   ParseMidMap(QOS_Class_t *Qos, const char *MapStr);
+static void   ShedEntry(QOS_Class_t *Qos, QOS_Entry_t *Entry);
+static void   StoreMsg(QOS_Class_t *Qos, uint8 MidIdx, const uint32 *Msg, uint16 MsgLen);
+static void   UpdateCredit(QOS_Class_t *Qos);
+
+
+/******************************************************************************
+** Function: QOS_Constructor
+**
+*/
+void QOS_Constructor(QOS_Class_t *Qos, INITBL_Class_t *IniTbl, STORE_Class_t *Store)
+{
+
+   int32  SysStatus;
+   uint16 i;
+   uint16 j;
+
+   memset(Qos, 0, sizeof(QOS_Class_t));
+
+   Qos->Store = Store;
+
+   atomic_init(&Qos->Active, false);
+
+   SysStatus = OS_MutSemCreate(&Qos->MutexId, QOS_MUTEX_NAME, 0);
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(QOS_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating QoS mutex %s, Status = %d", QOS_MUTEX_NAME, SysStatus);
+   }
+
+   SysStatus = OS_CountSemCreate(&Qos->TxSemaphore, QOS_TX_SEM_NAME, 0, 0);
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(QOS_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating QoS semaphore %s, Status = %d", QOS_TX_SEM_NAME, SysStatus);
+   }
+
+   ParseClasses(Qos, INITBL_GetStrConfig(IniTbl, CFG_QOS_CLASSES));
+   ParseMidMap(Qos, INITBL_GetStrConfig(IniTbl, CFG_QOS_MID_MAP));
+
+   for (i=0; i < Qos->ClassCnt; i++)
+   {
+      for (j=0; j < Qos->ClassCnt; j++)
+      {
+         if (Qos->Class[j].Priority < Qos->Class[i].Priority && Qos->Rank[i] < STORE_MAX_RANK-1)
+         {
+            Qos->Rank[i]++;
+         }
+      }
+   }
+
+   Qos->AirtimePpt = INITBL_GetIntConfig(IniTbl, CFG_QOS_AIRTIME_PPT);
+   if (Qos->AirtimePpt == 0 || Qos->AirtimePpt > 1000)
+   {
+      CFE_EVS_SendEvent(QOS_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Invalid QOS_AIRTIME_PPT %u, using 1000", Qos->AirtimePpt);
+      Qos->AirtimePpt = 1000;
+   }
+
+   HDR_COMP_Constructor(&Qos->HdrComp, sizeof(CFE_MSG_TelemetryHeader_t), sizeof(CFE_MSG_Message_t),
+                        INITBL_GetIntConfig(IniTbl, CFG_HDR_COMP_REFRESH_CNT));
+   HDR_COMP_Constructor(&Qos->StoreHdrComp, sizeof(CFE_MSG_TelemetryHeader_t), sizeof(CFE_MSG_Message_t),
+                        INITBL_GetIntConfig(IniTbl, CFG_HDR_COMP_REFRESH_CNT));
+   TLM_PACK_Constructor(&Qos->TlmPack, IniTbl);
+
+   Qos->LastManageUsec = NowUsec();
+
+   CFE_MSG_Init(CFE_MSG_PTR(Qos->QosTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_LORA_QOS_TLM_TOPICID)), sizeof(LORA_QosTlm_t));
+
+} /* End QOS_Constructor() */
+
+
+/******************************************************************************
+** Function: QOS_Start
+**
+*/
+bool QOS_Start(QOS_Class_t *Qos, uint8 Radio, bool UseStore, bool Relay)
+{
+
+   uint16 i;
+
+   if (atomic_load_explicit(&Qos->Active, memory_order_relaxed))
+   {
+      CFE_EVS_SendEvent(QOS_START_EID, CFE_EVS_EventType_ERROR,
+                        "Start bridge rejected, radio %u is bridging", Qos->Radio);
+      return false;
+   }
+
+   if (Qos->MidCnt == 0 && !Relay)
+   {
+      CFE_EVS_SendEvent(QOS_START_EID, CFE_EVS_EventType_ERROR,
+                        "Start bridge rejected, QOS_MID_MAP has no topics and the node doesn't relay");
+      return false;
+   }
+
+   OS_MutSemTake(Qos->MutexId);
+
+   for (i=0; i < QOS_QUEUE_LEN; i++)
+   {
+      Qos->Queue[i].Valid = false;
+   }
+   for (i=0; i < Qos->MidCnt; i++)
+   {
+      Qos->Mid[i].Count          = 0;
+      Qos->Mid[i].InCnt          = 0;
+      Qos->Mid[i].SentCnt        = 0;
+      Qos->Mid[i].DownsampledCnt = 0;
+      Qos->Mid[i].ShedCnt        = 0;
+      Qos->Mid[i].StoredCnt      = 0;
+      Qos->Mid[i].ErrCnt         = 0;
+      Qos->Mid[i].AirUsec        = 0;
+   }
+   Qos->QueueLen        = 0;
+   Qos->QueuePeak       = 0;
+   Qos->PeriodQueuePeak = 0;
+   Qos->ExpiredCnt      = 0;
+   Qos->EvictedCnt      = 0;
+   Qos->PeriodShedCnt   = 0;
+   Qos->FwdInCnt        = 0;
+   Qos->FwdSentCnt      = 0;
+   Qos->FwdShedCnt      = 0;
+   Qos->FwdErrCnt       = 0;
+   Qos->FwdAirUsec      = 0;
+
+   OS_MutSemGive(Qos->MutexId);
+
+   Qos->Radio          = Radio;
+   Qos->UseStore       = UseStore && Qos->Store->Enabled;
+   Qos->ShedLevel      = 0;
+   Qos->LastAirUsec    = 0;
+   Qos->AirUsedPpt     = 0;
+   Qos->AirCreditUsec  = (int64)Qos->AirtimePpt * 1000;
+   Qos->CreditTimeUsec = NowUsec();
+   HDR_COMP_Reset(&Qos->HdrComp);
+   HDR_COMP_Reset(&Qos->StoreHdrComp);
+
+   atomic_store_explicit(&Qos->Active, true, memory_order_relaxed);
+
+   CFE_EVS_SendEvent(QOS_START_EID, CFE_EVS_EventType_INFORMATION,
+                     "Radio %u bridge started: %u topics in %u classes, airtime limit %u ppt, store-and-forward %s",
+                     Radio, Qos->MidCnt, Qos->ClassCnt, Qos->AirtimePpt, Qos->UseStore ? "on" : "off");
+
+   return true;
+
+} /* End QOS_Start() */
+
+
+/******************************************************************************
+** Function: QOS_Stop
+**
+*/
+void QOS_Stop(QOS_Class_t *Qos)
+{
+
+   uint32 SentCnt = 0;
+   uint32 ShedCnt = 0;
+   uint32 StoredCnt = 0;
+   uint32 DownsampledCnt = 0;
+   uint16 i;
+
+   atomic_store_explicit(&Qos->Active, false, memory_order_relaxed);
+
+   if (Qos->UseStore)
+   {
+      STORE_Flush(Qos->Store);
+   }
+
+   OS_MutSemTake(Qos->MutexId);
+
+   for (i=0; i < QOS_QUEUE_LEN; i++)
+   {
+      if (Qos->Queue[i].Valid)
+      {
+         ShedEntry(Qos, &Qos->Queue[i]);
+      }
+   }
+   for (i=0; i < Qos->MidCnt; i++)
+   {
+      SentCnt        += Qos->Mid[i].SentCnt;
+      ShedCnt        += Qos->Mid[i].ShedCnt;
+      StoredCnt      += Qos->Mid[i].StoredCnt;
+      DownsampledCnt += Qos->Mid[i].DownsampledCnt;
+   }
+
+   OS_MutSemGive(Qos->MutexId);
+
+   CFE_EVS_SendEvent(QOS_STOP_EID, CFE_EVS_EventType_INFORMATION,
+                     "Radio %u bridge stopped: sent %u, stored %u, shed %u (%u missed deadlines, %u for a full queue), "
+                     "downsampled %u, forwarded %u of %u", Qos->Radio, SentCnt, StoredCnt, ShedCnt, Qos->ExpiredCnt,
+                     Qos->EvictedCnt, DownsampledCnt, Qos->FwdSentCnt, Qos->FwdInCnt);
+
+   QOS_SendTlmCmd(Qos, NULL);
+
+} /* End QOS_Stop() */
+
+
+/******************************************************************************
+** Function: QOS_Bridged
+**
+*/
+bool QOS_Bridged(const QOS_Class_t *Qos, CFE_SB_MsgId_t MsgId)
+{
+
+   return (FindMid(Qos, MsgId) >= 0);
+
+} /* End QOS_Bridged() */
+
+
+/******************************************************************************
+** Function: QOS_Enqueue
+**
+** Notes:
+**   1. The downsample ratio of every class except priority 0 doubles with
+**      each shed level.
+**
+*/
+bool QOS_Enqueue(QOS_Class_t *Qos, const CFE_MSG_Message_t *MsgPtr, uint32 Tag)
+{
+
+   CFE_SB_MsgId_t  MsgId = CFE_SB_INVALID_MSG_ID;
+   CFE_MSG_Size_t  MsgSize = 0;
+   QOS_Mid_t      *Mid;
+   const QOS_ClassCfg_t *Class;
+   QOS_Entry_t    *Entry;
+   uint32 Ratio;
+   int16  MidIdx;
+
+   if (!atomic_load_explicit(&Qos->Active, memory_order_relaxed))
+   {
+      return false;
+   }
+
+   CFE_MSG_GetMsgId(MsgPtr, &MsgId);
+   if ((MidIdx = FindMid(Qos, MsgId)) < 0)
+   {
+      return false;
+   }
+   Mid   = &Qos->Mid[MidIdx];
+   Class = &Qos->Class[Mid->Class];
+   CFE_MSG_GetSize(MsgPtr, &MsgSize);
+
+   OS_MutSemTake(Qos->MutexId);
+
+   Mid->InCnt++;
+
+   Ratio = (Class->Priority > 0) ? ((uint32)Class->Downsample << Qos->ShedLevel) : Class->Downsample;
+   if ((Mid->Count++ % Ratio) != 0)
+   {
+      Mid->DownsampledCnt++;
+      OS_MutSemGive(Qos->MutexId);
+      return false;
+   }
+
+   if (MsgSize > QOS_MAX_MSG_LEN)
+   {
+      Mid->ShedCnt++;
+      OS_MutSemGive(Qos->MutexId);
+      return false;
+   }
+
+   if ((Entry = AllocEntry(Qos, Class->Priority)) == NULL)
+   {
+      Mid->ShedCnt++;
+      OS_MutSemGive(Qos->MutexId);
+      return false;
+   }
+
+   Entry->Mid          = (uint8)MidIdx;
+   Entry->Class        = Mid->Class;
+   Entry->FwdType      = 0;
+   Entry->MsgLen       = (uint16)MsgSize;
+   Entry->Tag          = Tag;
+   Entry->DeadlineUsec = Entry->EnqueueUsec + (int64)Class->DeadlineMs * 1000;
+   memcpy(Entry->Msg, MsgPtr, MsgSize);
+
+   OS_MutSemGive(Qos->MutexId);
+
+   OS_CountSemGive(Qos->TxSemaphore);
+
+   return true;
+
+} /* End QOS_Enqueue() */
+
+
+/******************************************************************************
+** Function: QOS_Forward
+**
+** Notes:
+**   1. The payload is copied once, from the Rx task's frame into the queue
+**      entry, and sent from there by QOS_NextTx(). Nothing touches the
+**      software bus or a file on the way.
+**
+*/
+bool QOS_Forward(QOS_Class_t *Qos, uint8 Class, uint8 FrameType, const LORA_FRAME_Route_t *Route,
+                 const uint8 *Data, uint16 DataLen)
+{
+
+   QOS_Entry_t *Entry;
+
+   if (!atomic_load_explicit(&Qos->Active, memory_order_relaxed) || Class >= Qos->ClassCnt)
+   {
+      return false;
+   }
+
+   OS_MutSemTake(Qos->MutexId);
+
+   Qos->FwdInCnt++;
+
+   if (DataLen > QOS_MAX_FRAME_DATA || (Entry = AllocEntry(Qos, Qos->Class[Class].Priority)) == NULL)
+   {
+      Qos->FwdShedCnt++;
+      OS_MutSemGive(Qos->MutexId);
+      return false;
+   }
+
+   Entry->Mid          = QOS_MAX_MID;
+   Entry->Class        = Class;
+   Entry->FwdType      = FrameType;
+   Entry->MsgLen       = DataLen;
+   Entry->Tag          = 0;
+   Entry->DeadlineUsec = Entry->EnqueueUsec + (int64)Qos->Class[Class].DeadlineMs * 1000;
+   Entry->Route        = *Route;
+   memcpy(Entry->Msg, Data, DataLen);
+
+   OS_MutSemGive(Qos->MutexId);
+
+   OS_CountSemGive(Qos->TxSemaphore);
+
+   return true;
+
+} /* End QOS_Forward() */
+
+
+/******************************************************************************
+** Function: QOS_QueueLen
+**
+*/
+uint16 QOS_QueueLen(QOS_Class_t *Qos)
+{
+
+   return Qos->QueueLen;
+
+} /* End QOS_QueueLen() */
+
+
+/******************************************************************************
+** Function: QOS_NextTx
+**
+** Notes:
+**   1. The semaphore is given once for each queued message. Shed messages
+**      leave counts behind that only cause early wakeups.
+**   2. A message that doesn't fit a frame after compression is shed.
+**   3. The semaphore isn't waited on while there's a replay to send.
+**   4. A forwarded frame's payload is copied straight to TxMsg. It's sent
+**      while the link is down, the link state is this node's ground
+**      contact rather than the next hop.
+**
+*/
+bool QOS_NextTx(QOS_Class_t *Qos, QOS_TxMsg_t *TxMsg)
+{
+
+   uint32 Msg[(QOS_MAX_MSG_LEN+3)/4];
+   QOS_Entry_t *Best = NULL;
+   bool   LinkUp = true;
+   int16  StoreRank = -1;
+   uint16 MsgLen = 0;
+   int64  Now;
+   int64  WaitMs;
+   uint16 i;
+
+   if (Qos->UseStore)
+   {
+      LinkUp    = STORE_Poll(Qos->Store);
+      StoreRank = STORE_NextRank(Qos->Store);
+   }
+
+   if (LinkUp)
+   {
+      UpdateCredit(Qos);
+      if (Qos->AirCreditUsec <= 0)
+      {
+         WaitMs = -Qos->AirCreditUsec / Qos->AirtimePpt + 1;
+         OS_TaskDelay((WaitMs < QOS_TX_WAIT_MS) ? (uint32)WaitMs : QOS_TX_WAIT_MS);
+         return false;
+      }
+   }
+
+   if (StoreRank < 0)
+   {
+      OS_CountSemTimedWait(Qos->TxSemaphore, QOS_TX_WAIT_MS);
+   }
+
+   OS_MutSemTake(Qos->MutexId);
+
+   Now = NowUsec();
+   for (i=0; i < QOS_QUEUE_LEN; i++)
+   {
+      if (Qos->Queue[i].Valid)
+      {
+         if (Qos->Queue[i].DeadlineUsec < Now)
+         {
+            ShedEntry(Qos, &Qos->Queue[i]);
+            Qos->ExpiredCnt++;
+            Qos->PeriodShedCnt++;
+         }
+         else if (Best == NULL || Before(Qos, &Qos->Queue[i], Best))
+         {
+            Best = &Qos->Queue[i];
+         }
+      }
+   }
+
+   if (Best != NULL && StoreRank >= 0 && StoreRank <= Qos->Rank[Best->Class])
+   {
+      Best = NULL;
+   }
+
+   if (Best != NULL)
+   {
+      MsgLen         = Best->MsgLen;
+      TxMsg->Mid     = Best->Mid;
+      TxMsg->Tag     = Best->Tag;
+      TxMsg->FwdType = Best->FwdType;
+      TxMsg->EnqueueUsec = Best->EnqueueUsec;
+      if (Best->FwdType == 0)
+      {
+         TxMsg->MsgId = Qos->Mid[Best->Mid].MsgId;
+         memcpy(Msg, Best->Msg, MsgLen);
+      }
+      else
+      {
+         TxMsg->MsgId = CFE_SB_INVALID_MSG_ID;
+         TxMsg->Route = Best->Route;
+         memcpy(TxMsg->Data, Best->Msg, MsgLen);
+      }
+      Best->Valid = false;
+      Qos->QueueLen--;
+   }
+
+   OS_MutSemGive(Qos->MutexId);
+
+   if (Best == NULL)
+   {
+      return (StoreRank >= 0) ? NextReplay(Qos, TxMsg) : false;
+   }
+
+   if (TxMsg->FwdType != 0)
+   {
+      TxMsg->Stored  = false;
+      TxMsg->Resend  = false;
+      TxMsg->DataLen = MsgLen;
+      memset(&TxMsg->MsgTime, 0, sizeof(TxMsg->MsgTime));
+      return true;
+   }
+
+   MsgLen = TLM_PACK_Pack(&Qos->TlmPack, (CFE_MSG_Message_t *)Msg, MsgLen);
+
+   if (!LinkUp)
+   {
+      StoreMsg(Qos, TxMsg->Mid, Msg, MsgLen);
+      return false;
+   }
+
+   TxMsg->Stored = false;
+   TxMsg->Resend = false;
+   CFE_MSG_GetMsgTime((const CFE_MSG_Message_t *)Msg, &TxMsg->MsgTime);
+   TxMsg->DataLen = HDR_COMP_Compress(&Qos->HdrComp, (const uint8 *)Msg, MsgLen, TxMsg->Data, QOS_MAX_FRAME_DATA);
+
+   if (TxMsg->DataLen == 0)
+   {
+      OS_MutSemTake(Qos->MutexId);
+      Qos->Mid[TxMsg->Mid].ShedCnt++;
+      OS_MutSemGive(Qos->MutexId);
+      return false;
+   }
+
+   return true;
+
+} /* End QOS_NextTx() */
+
+
+/******************************************************************************
+** Function: QOS_RecordTx
+**
+** Notes:
+**   1. A failed send is charged its airtime, the radio may have been on the
+**      air before it failed.
+**   2. A failed replay is resent when the ack times out.
+**
+*/
+void QOS_RecordTx(QOS_Class_t *Qos, const QOS_TxMsg_t *TxMsg, bool Sent, uint32 AirUsec)
+{
+
+   QOS_Mid_t *Mid;
+
+   Qos->AirCreditUsec -= AirUsec;
+
+   if (TxMsg->FwdType != 0)
+   {
+      OS_MutSemTake(Qos->MutexId);
+      Qos->FwdAirUsec += AirUsec;
+      if (Sent)
+      {
+         Qos->FwdSentCnt++;
+      }
+      else
+      {
+         Qos->FwdErrCnt++;
+      }
+      OS_MutSemGive(Qos->MutexId);
+      return;
+   }
+
+   if (TxMsg->Mid >= Qos->MidCnt)
+   {
+      return;
+   }
+   Mid = &Qos->Mid[TxMsg->Mid];
+
+   OS_MutSemTake(Qos->MutexId);
+
+   Mid->AirUsec += AirUsec;
+   if (Sent)
+   {
+      Mid->SentCnt++;
+   }
+   else
+   {
+      Mid->ErrCnt++;
+   }
+
+   OS_MutSemGive(Qos->MutexId);
+
+} /* End QOS_RecordTx() */
+
+
+/******************************************************************************
+** Function: QOS_Manage
+**
+** Notes:
+**   1. Any shed message in the last period raises the shed level one step.
+**      It drops one step after a period with no shed messages and a queue
+**      that stayed under a quarter full, so the level settles where the
+**      offered load fits the link.
+**
+*/
+void QOS_Manage(QOS_Class_t *Qos)
+{
+
+   int64  Now = NowUsec();
+   int64  ElapsedUsec = Now - Qos->LastManageUsec;
+   uint64 AirUsec;
+   uint32 PeriodShedCnt;
+   uint16 PeriodQueuePeak;
+   uint8  ShedLevel = Qos->ShedLevel;
+   uint16 i;
+
+   Qos->LastManageUsec = Now;
+
+   if (!atomic_load_explicit(&Qos->Active, memory_order_relaxed))
+   {
+      return;
+   }
+
+   OS_MutSemTake(Qos->MutexId);
+
+   AirUsec = Qos->FwdAirUsec;
+   for (i=0; i < Qos->MidCnt; i++)
+   {
+      AirUsec += Qos->Mid[i].AirUsec;
+   }
+   PeriodShedCnt   = Qos->PeriodShedCnt;
+   PeriodQueuePeak = Qos->PeriodQueuePeak;
+   Qos->PeriodShedCnt   = 0;
+   Qos->PeriodQueuePeak = Qos->QueueLen;
+
+   OS_MutSemGive(Qos->MutexId);
+
+   Qos->AirUsedPpt  = (ElapsedUsec > 0) ? (uint16)(((AirUsec - Qos->LastAirUsec) * 1000) / ElapsedUsec) : 0;
+   Qos->LastAirUsec = AirUsec;
+
+   if (PeriodShedCnt > 0)
+   {
+      if (ShedLevel < QOS_MAX_SHED_LEVEL)
+      {
+         ShedLevel++;
+      }
+   }
+   else if (PeriodQueuePeak <= QOS_QUEUE_LEN/4 && ShedLevel > 0)
+   {
+      ShedLevel--;
+   }
+
+   if (ShedLevel != Qos->ShedLevel)
+   {
+      CFE_EVS_SendEvent(QOS_SHED_EID, CFE_EVS_EventType_INFORMATION,
+                        "Radio %u bridge shed level %u: %u messages shed, queue peak %u, airtime %u ppt",
+                        Qos->Radio, ShedLevel, PeriodShedCnt, PeriodQueuePeak, Qos->AirUsedPpt);
+      Qos->ShedLevel = ShedLevel;
+   }
+
+} /* End QOS_Manage() */
+
+
+/******************************************************************************
+** Function: QOS_ParseTuple
+**
+** Notes:
+**   1. See qos.h prototype.
+**
+*/
+bool QOS_ParseTuple(const char **Next, uint32 *Param, uint16 ParamCnt)
+{
+
+   const char *Str = *Next;
+   char  *End;
+   uint16 i;
+
+   for (i=0; i < ParamCnt; i++)
+   {
+      Param[i] = strtoul(Str, &End, 0);
+      if (End == Str || (i < ParamCnt-1 && *End != '/'))
+      {
+         break;
+      }
+      Str = (i < ParamCnt-1) ? End + 1 : End;
+   }
+
+   while (*Str != '\0' && *Str != ',')
+   {
+      Str++;
+   }
+   *Next = (*Str == ',') ? Str + 1 : Str;
+
+   return (i == ParamCnt);
+
+} /* End QOS_ParseTuple() */
+
+
+/******************************************************************************
+** Function: QOS_SendTlmCmd
+**
+*/
+bool QOS_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   QOS_Class_t *Qos = (QOS_Class_t *)ObjDataPtr;
+   LORA_QosTlm_Payload_t *Payload = &Qos->QosTlm.Payload;
+   const QOS_Mid_t *Mid;
+   uint16 i;
+
+   memset(Payload, 0, sizeof(LORA_QosTlm_Payload_t));
+
+   Payload->Active     = atomic_load_explicit(&Qos->Active, memory_order_relaxed);
+   Payload->Radio      = Qos->Radio;
+   Payload->ShedLevel  = Qos->ShedLevel;
+   Payload->MidCnt     = Qos->MidCnt;
+   Payload->AirtimePpt = Qos->AirtimePpt;
+   Payload->AirUsedPpt = Qos->AirUsedPpt;
+
+   Payload->HdrFullCnt  = Qos->HdrComp.FullCnt + Qos->HdrComp.RawCnt;
+   Payload->HdrCompCnt  = Qos->HdrComp.CompCnt;
+   Payload->MsgByteCnt  = (uint32)Qos->HdrComp.MsgByteCnt;
+   Payload->CompByteCnt = (uint32)Qos->HdrComp.CompByteCnt;
+
+   OS_MutSemTake(Qos->MutexId);
+
+   Payload->QueueLen   = Qos->QueueLen;
+   Payload->QueuePeak  = Qos->QueuePeak;
+   Payload->ExpiredCnt = Qos->ExpiredCnt;
+   Payload->EvictedCnt = Qos->EvictedCnt;
+   Payload->FwdInCnt   = Qos->FwdInCnt;
+   Payload->FwdSentCnt = Qos->FwdSentCnt;
+   Payload->FwdShedCnt = Qos->FwdShedCnt;
+   Payload->FwdErrCnt  = Qos->FwdErrCnt;
+   Payload->FwdAirMs   = (uint32)(Qos->FwdAirUsec / 1000);
+
+   for (i=0; i < Qos->MidCnt; i++)
+   {
+      Mid = &Qos->Mid[i];
+      Payload->Mid[i].TopicId        = Mid->TopicId;
+      Payload->Mid[i].Class          = Mid->Class;
+      Payload->Mid[i].Priority       = Qos->Class[Mid->Class].Priority;
+      Payload->Mid[i].InCnt          = Mid->InCnt;
+      Payload->Mid[i].SentCnt        = Mid->SentCnt;
+      Payload->Mid[i].DownsampledCnt = Mid->DownsampledCnt;
+      Payload->Mid[i].ShedCnt        = Mid->ShedCnt;
+      Payload->Mid[i].StoredCnt      = Mid->StoredCnt;
+      Payload->Mid[i].ErrCnt         = Mid->ErrCnt;
+      Payload->Mid[i].AirMs          = (uint32)(Mid->AirUsec / 1000);
+   }
+
+   OS_MutSemGive(Qos->MutexId);
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(Qos->QosTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(Qos->QosTlm.TelemetryHeader), true);
+
+   return true;
+
+} /* End QOS_SendTlmCmd() */
+
+
+/******************************************************************************
+** Function: AllocEntry
+**
+** Return a free queue entry for a message with Priority
+**
+** Notes:
+**   1. The caller holds the mutex and fills in the entry's message.
+**   2. A full queue evicts the entry that would be sent last if it's lower
+**      priority, otherwise NULL is returned.
+**
+*/
+static QOS_Entry_t *AllocEntry(QOS_Class_t *Qos, uint8 Priority)
+{
+
+   QOS_Entry_t *Entry = NULL;
+   QOS_Entry_t *Victim = NULL;
+   uint16 i;
+
+   for (i=0; i < QOS_QUEUE_LEN; i++)
+   {
+      if (!Qos->Queue[i].Valid)
+      {
+         Entry = &Qos->Queue[i];
+         break;
+      }
+      if (Victim == NULL || Before(Qos, Victim, &Qos->Queue[i]))
+      {
+         Victim = &Qos->Queue[i];
+      }
+   }
+
+   if (Entry == NULL)
+   {
+      if (Qos->Class[Victim->Class].Priority <= Priority)
+      {
+         return NULL;
+      }
+      ShedEntry(Qos, Victim);
+      Qos->EvictedCnt++;
+      Qos->PeriodShedCnt++;
+      Entry = Victim;
+   }
+
+   Entry->Valid       = true;
+   Entry->Order       = Qos->NextOrder++;
+   Entry->EnqueueUsec = NowUsec();
+
+   Qos->QueueLen++;
+   if (Qos->QueueLen > Qos->QueuePeak)
+   {
+      Qos->QueuePeak = Qos->QueueLen;
+   }
+   if (Qos->QueueLen > Qos->PeriodQueuePeak)
+   {
+      Qos->PeriodQueuePeak = Qos->QueueLen;
+   }
+
+   return Entry;
+
+} /* End AllocEntry() */
+
+
+/******************************************************************************
+** Function: Before
+**
+** Return true if A is sent before B
+**
+*/
+static bool Before(const QOS_Class_t *Qos, const QOS_Entry_t *A, const QOS_Entry_t *B)
+{
+
+   uint8 PriorityA;
+   uint8 PriorityB;
+
+   if (A->DeadlineUsec != B->DeadlineUsec)
+   {
+      return A->DeadlineUsec < B->DeadlineUsec;
+   }
+
+   PriorityA = Qos->Class[A->Class].Priority;
+   PriorityB = Qos->Class[B->Class].Priority;
+   if (PriorityA != PriorityB)
+   {
+      return PriorityA < PriorityB;
+   }
+
+   return (int32)(A->Order - B->Order) < 0;
+
+} /* End Before() */
+
+
+/******************************************************************************
+** Function: FindMid
+**
+** Return the index of MsgId's QOS_Mid_t or -1 if it isn't bridged
+**
+*/
+static int16 FindMid(const QOS_Class_t *Qos, CFE_SB_MsgId_t MsgId)
+{
+
+   int16 i;
+
+   for (i=0; i < Qos->MidCnt; i++)
+   {
+      if (CFE_SB_MsgId_Equal(MsgId, Qos->Mid[i].MsgId))
+      {
+         return i;
+      }
+   }
+
+   return -1;
+
+} /* End FindMid() */
+
+
+/******************************************************************************
+** Function: NextReplay
+**
+** Notes:
+**   1. A resend restarts the replay header contexts, the receiver may have
+**      lost the frames that set them up.
+**
+*/
+static bool NextReplay(QOS_Class_t *Qos, QOS_TxMsg_t *TxMsg)
+{
+
+   uint32 Msg[(STORE_MAX_MSG_LEN+3)/4];
+   uint16 MsgLen;
+   uint16 Seq;
+   bool   Resend;
+   int16  MidIdx;
+
+   if (!STORE_NextReplay(Qos->Store, (uint8 *)Msg, &MsgLen, &Seq, &Resend))
+   {
+      return false;
+   }
+
+   if (Resend)
+   {
+      HDR_COMP_Reset(&Qos->StoreHdrComp);
+   }
+
+   CFE_MSG_GetMsgId((const CFE_MSG_Message_t *)Msg, &TxMsg->MsgId);
+   CFE_MSG_GetMsgTime((const CFE_MSG_Message_t *)Msg, &TxMsg->MsgTime);
+   MidIdx = FindMid(Qos, TxMsg->MsgId);
+
+   TxMsg->Mid     = (MidIdx >= 0) ? (uint8)MidIdx : QOS_MAX_MID;
+   TxMsg->Tag     = 0;
+   TxMsg->Stored  = true;
+   TxMsg->Resend  = Resend;
+   TxMsg->FwdType = 0;
+   TxMsg->EnqueueUsec = 0;
+   TxMsg->Data[0] = (uint8)(Seq >> 8);
+   TxMsg->Data[1] = (uint8)Seq;
+   TxMsg->DataLen = HDR_COMP_Compress(&Qos->StoreHdrComp, (const uint8 *)Msg, MsgLen,
+                                      &TxMsg->Data[STORE_SEQ_LEN], QOS_MAX_FRAME_DATA - STORE_SEQ_LEN);
+
+   /* StoreMsg() only stores messages that always fit */
+   TxMsg->DataLen += STORE_SEQ_LEN;
+
+   return true;
+
+} /* End NextReplay() */
+
+
+/******************************************************************************
+** Function: NowUsec
+**
+*/
+static int64 NowUsec(void)
+{
+
+   OS_time_t Now;
+
+   OS_GetLocalTime(&Now);
+
+   return OS_TimeGetTotalMicroseconds(Now);
+
+} /* End NowUsec() */
+
+
+/******************************************************************************
+** Function: ParseClasses
+**
+** Notes:
+**   1. ClassStr is a comma separated list of Priority/DeadlineMs/Downsample
+**      triplets, for example "0/2000/1,2/10000/4". Class N is the Nth
+**      triplet.
+**
+*/
+static void ParseClasses(QOS_Class_t *Qos, const char *ClassStr)
+{
+
+   const char *Next = ClassStr;
+   uint32 Param[3];
+
+   while (*Next != '\0' && Qos->ClassCnt < QOS_MAX_CLASS)
+   {
+
+      if (QOS_ParseTuple(&Next, Param, 3) && Param[0] <= 0xFF && Param[1] > 0 &&
+          Param[2] > 0 && Param[2] <= 0xFFFF)
+      {
+         Qos->Class[Qos->ClassCnt].Priority   = (uint8)Param[0];
+         Qos->Class[Qos->ClassCnt].DeadlineMs = Param[1];
+         Qos->Class[Qos->ClassCnt].Downsample = (uint16)Param[2];
+         Qos->ClassCnt++;
+      }
+      else
+      {
+         CFE_EVS_SendEvent(QOS_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                           "Skipped invalid QoS class %d in \"%s\"", Qos->ClassCnt, ClassStr);
+      }
+
+   }
+
+} /* End ParseClasses() */
+
+
+/******************************************************************************
+** Function: ParseMidMap
+**
+** Notes:
+**   1. MapStr is a comma separated list of TopicId/Class pairs, for example
+**      "2164/0,2172/1".
+**
+*/
+static void ParseMidMap(QOS_Class_t *Qos, const char *MapStr)
+{
+
+   const char *Next = MapStr;
+   uint32 Param[2];
+
+   while (*Next != '\0' && Qos->MidCnt < QOS_MAX_MID)
+   {
+
+      if (QOS_ParseTuple(&Next, Param, 2) && Param[0] <= 0xFFFF && Param[1] < Qos->ClassCnt &&
+          FindMid(Qos, CFE_SB_ValueToMsgId(Param[0])) < 0)
+      {
+         Qos->Mid[Qos->MidCnt].MsgId   = CFE_SB_ValueToMsgId(Param[0]);
+         Qos->Mid[Qos->MidCnt].TopicId = (uint16)Param[0];
+         Qos->Mid[Qos->MidCnt].Class   = (uint8)Param[1];
+         Qos->MidCnt++;
+      }
+      else
+      {
+         CFE_EVS_SendEvent(QOS_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                           "Skipped invalid or repeated QoS topic %d in \"%s\"", Qos->MidCnt, MapStr);
+      }
+
+   }
+
+} /* End ParseMidMap() */
+
+
+/******************************************************************************
+** Function: ShedEntry
+**
+** Notes:
+**   1. The caller holds the mutex.
+**
+*/
+static void ShedEntry(QOS_Class_t *Qos, QOS_Entry_t *Entry)
+{
+
+   if (Entry->FwdType == 0)
+   {
+      Qos->Mid[Entry->Mid].ShedCnt++;
+   }
+   else
+   {
+      Qos->FwdShedCnt++;
+   }
+   Entry->Valid = false;
+   Qos->QueueLen--;
+
+} /* End ShedEntry() */
+
+
+/******************************************************************************
+** Function: StoreMsg
+**
+*/
+static void StoreMsg(QOS_Class_t *Qos, uint8 MidIdx, const uint32 *Msg, uint16 MsgLen)
+{
+
+   QOS_Mid_t *Mid = &Qos->Mid[MidIdx];
+   bool Stored = false;
+
+   if (MsgLen <= QOS_MAX_STORE_MSG_LEN)
+   {
+      Stored = STORE_Append(Qos->Store, Qos->Rank[Mid->Class], (const uint8 *)Msg, MsgLen);
+   }
+
+   OS_MutSemTake(Qos->MutexId);
+   if (Stored)
+   {
+      Mid->StoredCnt++;
+   }
+   else
+   {
+      Mid->ShedCnt++;
+   }
+   OS_MutSemGive(Qos->MutexId);
+
+} /* End StoreMsg() */
+
+
+/******************************************************************************
+** Function: UpdateCredit
+**
+*/
+static void UpdateCredit(QOS_Class_t *Qos)
+{
+
+   int64 Now = NowUsec();
+   int64 MaxCredit = (int64)Qos->AirtimePpt * 1000;
+
+   Qos->AirCreditUsec += ((Now - Qos->CreditTimeUsec) * Qos->AirtimePpt) / 1000;
+   if (Qos->AirCreditUsec > MaxCredit)
+   {
+      Qos->AirCreditUsec = MaxCredit;
+   }
+   Qos->CreditTimeUsec = Now;
+
+} /* End UpdateCredit() */
@@ -0,0 +1,391 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the bridged message quality of service scheduler
+**
+**  Notes:
+**    1. Software bus messages bridged over a radio share its airtime. Each
+**       bridged topic is mapped by QOS_MID_MAP to a class from QOS_CLASSES
+**       that sets its priority, its deadline and a downsample ratio. The
+**       app subscribes to the mapped topics and queues their messages
+**       while a Tx bridge is running, the load generator queues its
+**       forwarded messages the same way.
+**    2. The bridging radio's Tx task sends the queued message with the
+**       earliest deadline, ties go to the higher priority class and then
+**       to the older message. A message whose deadline passes while it's
+**       queued is shed, it's no longer worth its airtime.
+**    3. QOS_AIRTIME_PPT limits the share of each second the bridge spends
+**       on the air. The Tx task waits while the bridge has used up its
+**       budget so the messages stay queued and the earliest deadline is
+**       still picked when the budget allows the next frame.
+**    4. When the link can't keep up, messages miss their deadlines or find
+**       the queue full. QOS_Manage() then raises the shed level, each level
+**       doubles the downsample ratio of every class except priority 0, so
+**       health telemetry keeps flowing while low value streams are
+**       thinned. The level drops when a period has no misses and the queue
+**       stays short.
+**    5. A full queue evicts the queued message with the lowest priority and
+**       the latest deadline if it's lower priority than the new message.
+**    6. Message headers are compressed (hdr_comp.h) when a message is
+**       sent rather than when it's queued so a shed message never becomes
+**       a header reference the receiver doesn't have.
+**    7. The queue and the counters are protected by a mutex that's held
+**       for a message copy, never while the radio is on the air.
+**    8. A Tx bridge started by command stores its messages while the link
+**       is down (store.h) and replays them when it's back. A stored
+**       message's replay rank is the number of classes with a higher
+**       priority. A replay goes ahead of a live message with a lower rank
+**       and shares the airtime budget. Replays are compressed with their
+**       own header contexts since they're resent after a loss.
+**    9. A relay's Rx tasks queue the frames they forward with QOS_Forward()
+**       (relay.h). A forwarded frame is queued as received, it's never
+**       downsampled, compressed or stored, and its class is picked by its
+**       hop count rather than a topic.
+**   10. The app's status and radio telemetry payloads are bit-packed
+**       (tlm_pack.h) before they're compressed or stored.
+**
+*/
+
+#ifndef _qos_
+#define _qos_
+
+/*
+** Includes
+*/
+
+#include <stdatomic.h>
+#include "app_cfg.h"
+#include "hdr_comp.h"
+#include "lora_frame.h"
+#include "store.h"
+#include "tlm_pack.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define QOS_MAX_CLASS       4
+#define QOS_MAX_MID         8     /* Must match the QosMidStatsTbl length */
+#define QOS_QUEUE_LEN       16
+#define QOS_MAX_MSG_LEN     LORA_FRAME_MAX_LEN                           /* Queued message before compression */
+#define QOS_MAX_FRAME_DATA  (LORA_FRAME_MAX_LEN - LORA_FRAME_MAX_HDR_LEN)  /* Compressed message */
+#define QOS_MAX_SHED_LEVEL  4
+#define QOS_TX_WAIT_MS      100   /* Tx task wait for a message before checking for the end */
+#define QOS_MAX_STORE_MSG_LEN (QOS_MAX_FRAME_DATA - STORE_SEQ_LEN - HDR_COMP_MAX_OVERHEAD)
+
+
+/*
+** Event Message IDs
+*/
+
+#define QOS_CONSTRUCTOR_EID  (QOS_BASE_EID + 0)
+#define QOS_START_EID        (QOS_BASE_EID + 1)
+#define QOS_STOP_EID         (QOS_BASE_EID + 2)
+#define QOS_SHED_EID         (QOS_BASE_EID + 3)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+
+typedef struct
+{
+
+   uint8   Priority;      /* 0 is the highest and is never thinned */
+   uint32  DeadlineMs;
+   uint16  Downsample;    /* Send 1 of every Downsample messages */
+
+} QOS_ClassCfg_t;
+
+
+typedef struct
+{
+
+   CFE_SB_MsgId_t MsgId;
+   uint16  TopicId;
+   uint8   Class;
+
+   uint32  Count;         /* Downsample phase */
+   uint32  InCnt;
+   uint32  SentCnt;
+   uint32  DownsampledCnt;
+   uint32  ShedCnt;       /* Missed deadline, evicted, too long or queued when the bridge stopped */
+   uint32  StoredCnt;
+   uint32  ErrCnt;
+   uint64  AirUsec;
+
+} QOS_Mid_t;
+
+
+typedef struct
+{
+
+   bool       Valid;
+   uint8      Mid;        /* Index of the message's QOS_Mid_t, QOS_MAX_MID for a forwarded frame */
+   uint8      Class;
+   uint8      FwdType;    /* Frame type of a forwarded frame, 0 for a local message */
+   uint16     MsgLen;
+   uint32     Tag;
+   uint32     Order;      /* Queue order, breaks deadline ties */
+   int64      EnqueueUsec;
+   int64      DeadlineUsec;
+   LORA_FRAME_Route_t Route;   /* Forwarded frame's route */
+   uint32     Msg[(QOS_MAX_MSG_LEN+3)/4];   /* Aligned for the message header */
+
+} QOS_Entry_t;
+
+
+/*
+** A message picked for the radio
+*/
+typedef struct
+{
+
+   uint8   Mid;           /* QOS_MAX_MID for a forwarded frame or a replay of a topic that's no longer mapped */
+   uint32  Tag;
+   bool    Stored;        /* A replay, Data starts with the replay count */
+   bool    Resend;        /* A replay of a message that was sent before, see STORE_NextReplay() */
+   uint8   FwdType;       /* Frame type of a forwarded frame, Data is its payload. 0 for a local message */
+   LORA_FRAME_Route_t Route;   /* Forwarded frame's route for its next hop */
+   int64   EnqueueUsec;   /* Local time the message was queued, 0 for a replay */
+   CFE_SB_MsgId_t MsgId;
+   CFE_TIME_SysTime_t MsgTime;
+   uint16  DataLen;
+   uint8   Data[QOS_MAX_FRAME_DATA];
+
+} QOS_TxMsg_t;
+
+
+/******************************************************************************
+** QOS_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Telemetry Packets
+   */
+
+   LORA_QosTlm_t  QosTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   atomic_bool  Active;          /* A Tx bridge is running */
+   osal_id_t    MutexId;         /* Protects the queue and the counters */
+   osal_id_t    TxSemaphore;     /* Given for each queued message */
+   STORE_Class_t *Store;
+   bool         UseStore;
+
+   uint16          ClassCnt;
+   QOS_ClassCfg_t  Class[QOS_MAX_CLASS];
+   uint8           Rank[QOS_MAX_CLASS];   /* Store replay rank */
+   uint16          MidCnt;
+   QOS_Mid_t       Mid[QOS_MAX_MID];
+
+   uint16       AirtimePpt;
+   uint8        ShedLevel;
+   uint8        Radio;
+   uint32       NextOrder;
+   uint16       QueueLen;
+   uint16       QueuePeak;
+   uint16       PeriodQueuePeak;
+   uint32       ExpiredCnt;
+   uint32       EvictedCnt;
+   uint32       PeriodShedCnt;   /* Deadline misses and evictions since the last QOS_Manage() */
+   uint32       FwdInCnt;
+   uint32       FwdSentCnt;
+   uint32       FwdShedCnt;
+   uint32       FwdErrCnt;
+   uint64       FwdAirUsec;
+
+   /* Tx task */
+   int64        AirCreditUsec;
+   int64        CreditTimeUsec;
+   HDR_COMP_Class_t HdrComp;
+   HDR_COMP_Class_t StoreHdrComp;
+   TLM_PACK_Class_t TlmPack;
+
+   /* Main task */
+   uint64       LastAirUsec;
+   int64        LastManageUsec;
+   uint16       AirUsedPpt;
+
+   QOS_Entry_t  Queue[QOS_QUEUE_LEN];
+
+} QOS_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: QOS_Constructor
+**
+** Initialize the QoS object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**   2. Invalid QOS_CLASSES and QOS_MID_MAP entries are reported and
+**      skipped.
+**
+*/
+void QOS_Constructor(QOS_Class_t *Qos, INITBL_Class_t *IniTbl, STORE_Class_t *Store);
+
+
+/******************************************************************************
+** Function: QOS_Start
+**
+** Clear the queue and the counters for a Tx bridge on Radio
+**
+** Notes:
+**   1. Called by the main task before it wakes the radio's Tx task.
+**   2. UseStore enables store-and-forward, a load generator run doesn't
+**      use it.
+**   3. Relay allows a bridge without QOS_MID_MAP topics, it only sends
+**      forwarded frames.
+**   4. Returns false if another radio is bridging.
+**
+*/
+bool QOS_Start(QOS_Class_t *Qos, uint8 Radio, bool UseStore, bool Relay);
+
+
+/******************************************************************************
+** Function: QOS_Stop
+**
+** Notes:
+**   1. Called by the Tx task when its bridge loop ends. Messages still
+**      queued are shed.
+**
+*/
+void QOS_Stop(QOS_Class_t *Qos);
+
+
+/******************************************************************************
+** Function: QOS_Bridged
+**
+** Return true if MsgId is mapped to a QoS class
+**
+*/
+bool QOS_Bridged(const QOS_Class_t *Qos, CFE_SB_MsgId_t MsgId);
+
+
+/******************************************************************************
+** Function: QOS_Enqueue
+**
+** Queue a message to be bridged
+**
+** Notes:
+**   1. Only called by the main task. Tag is returned with the message when
+**      it's sent.
+**   2. Returns false if no bridge is running, the message isn't mapped, was
+**      downsampled or didn't find room in the queue.
+**
+*/
+bool QOS_Enqueue(QOS_Class_t *Qos, const CFE_MSG_Message_t *MsgPtr, uint32 Tag);
+
+
+/******************************************************************************
+** Function: QOS_Forward
+**
+** Queue a received frame's payload to be sent on its next hop
+**
+** Notes:
+**   1. Called by the Rx tasks, see relay.h. Class is a QOS_CLASSES index
+**      that sets the frame's deadline and priority.
+**   2. Returns false if no bridge is running, the payload is too long or
+**      it didn't find room in the queue.
+**
+*/
+bool QOS_Forward(QOS_Class_t *Qos, uint8 Class, uint8 FrameType, const LORA_FRAME_Route_t *Route,
+                 const uint8 *Data, uint16 DataLen);
+
+
+/******************************************************************************
+** Function: QOS_QueueLen
+**
+*/
+uint16 QOS_QueueLen(QOS_Class_t *Qos);
+
+
+/******************************************************************************
+** Function: QOS_NextTx
+**
+** Wait up to QOS_TX_WAIT_MS for the airtime budget and a queued message and
+** compress the earliest deadline message or the next replay into TxMsg
+**
+** Notes:
+**   1. Only called by the bridging radio's Tx task.
+**   2. Returns false if no message can be sent yet. While the link is down
+**      the picked message is stored and false is returned.
+**
+*/
+bool QOS_NextTx(QOS_Class_t *Qos, QOS_TxMsg_t *TxMsg);
+
+
+/******************************************************************************
+** Function: QOS_RecordTx
+**
+** Record the result and the airtime of sending a message
+**
+*/
+void QOS_RecordTx(QOS_Class_t *Qos, const QOS_TxMsg_t *TxMsg, bool Sent, uint32 AirUsec);
+
+
+/******************************************************************************
+** Function: QOS_Manage
+**
+** Adjust the shed level and measure the bridge's airtime
+**
+** Notes:
+**   1. Called by the main task once a second.
+**
+*/
+void QOS_Manage(QOS_Class_t *Qos);
+
+
+/******************************************************************************
+** Function: QOS_ParseTuple
+**
+** Parse ParamCnt slash separated numbers and skip past the next comma
+**
+** Notes:
+**   1. Shared by the QoS and relay JSON init file list parameters, for
+**      example "0x0882/1,0x0883/2". Returns false for a malformed tuple,
+**      *Next is moved past it either way so parsing can continue.
+**
+*/
+bool QOS_ParseTuple(const char **Next, uint32 *Param, uint16 ParamCnt);
+
+
+/******************************************************************************
+** Function: QOS_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**   2. Also sent when a bridge stops.
+*/
+bool QOS_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _qos_ */
@@ -0,0 +1,604 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the Radio Driver Class methods
+**
+**  Notes:
+**    1. See radio_drv.h file prologue.
+**    2. OS_GetLocalTime() is used for timing because it has microsecond
+**       resolution on Linux and doesn't depend on cFE time services.
+**    3. The backend is checked in each wrapper rather than through function
+**       pointers so the SX128X library signatures don't need to match.
+**    4. The SX128X library calls don't take a device so at most one driver
+**       object can use that backend. The app checks this at init.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "radio.h"
+#include "radio_drv.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/* Convenience macros */
+#define  INITBL_OBJ   (RadioDrv->IniTbl)
+
+#define  STATS_FILE_LINE_LEN  512
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void LoadCallStatsTlm(LORA_RadioCallStats_t *CallStatsTlm, const RADIO_DRV_CallStats_t *CallStats);
+static void RecordCall(RADIO_DRV_Class_t *RadioDrv, RADIO_DRV_Call_t Call, bool CallStatus,
+                       const OS_time_t *StartTime);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static const char *CallName[RADIO_DRV_CALL_CNT] =
+{
+   "SetStandbyMode",
+   "SetPowerRegulatorMode",
+   "SetLowNoiseAmpMode",
+   "SetPowerAmpRampTime",
+   "SetModulationParams",
+   "SetRadioFrequency",
+   "SetPreambleLength",
+   "SetHeaderType",
+   "SetRxDutyCycle",
+   "SendPayload",
+   "ReceivePayload"
+};
+
+/*
+** Calls implemented by the SX128X library. The SIM backend implements all
+** of them.
+*/
+static const bool Sx128xCall[RADIO_DRV_CALL_CNT] =
+{
+   true,    /* SetStandbyMode        */
+   true,    /* SetPowerRegulatorMode */
+   true,    /* SetLowNoiseAmpMode    */
+   true,    /* SetPowerAmpRampTime   */
+   true,    /* SetModulationParams   */
+   true,    /* SetRadioFrequency     */
+   false,   /* SetPreambleLength     */
+   false,   /* SetHeaderType         */
+   false,   /* SetRxDutyCycle        */
+   false,   /* SendPayload           */
+   false    /* ReceivePayload        */
+};
+
+
+/******************************************************************************
+** Function: RADIO_DRV_Constructor
+**
+** Initialize the Radio Driver object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void RADIO_DRV_Constructor(RADIO_DRV_Class_t *RadioDrv, INITBL_Class_t *IniTbl,
+                           const RADIO_INST_Cfg_t *Inst)
+{
+
+   memset(RadioDrv, 0, sizeof(RADIO_DRV_Class_t));
+
+   RadioDrv->IniTbl = IniTbl;
+   RadioDrv->Inst   = Inst;
+
+   RadioDrv->Backend = Inst->Backend;
+   if (RadioDrv->Backend == LORA_RadioBackend_SIM)
+   {
+      RADIO_SIM_Constructor(&RadioDrv->Sim, IniTbl, Inst);
+   }
+
+   RADIO_DRV_ResetStatus(RadioDrv);
+
+   CFE_MSG_Init(CFE_MSG_PTR(RadioDrv->StatsTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_LORA_RADIO_STATS_TLM_TOPICID)), sizeof(LORA_RadioStatsTlm_t));
+   RadioDrv->StatsTlm.Payload.Radio = Inst->Index;
+
+} /* End RADIO_DRV_Constructor() */
+
+
+/******************************************************************************
+** Function: RADIO_DRV_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+** Notes:
+**   1. All of the call statistics are cleared.
+**
+*/
+void RADIO_DRV_ResetStatus(RADIO_DRV_Class_t *RadioDrv)
+{
+
+   uint16 Call;
+
+   memset(RadioDrv->CallStats, 0, sizeof(RadioDrv->CallStats));
+
+   for (Call=0; Call < RADIO_DRV_CALL_CNT; Call++)
+   {
+      RadioDrv->CallStats[Call].MinUsec = UINT32_MAX;
+   }
+
+   if (RadioDrv->Backend == LORA_RadioBackend_SIM)
+   {
+      RADIO_SIM_ResetStatus(&RadioDrv->Sim);
+   }
+
+} /* End RADIO_DRV_ResetStatus() */
+
+
+/******************************************************************************
+** Function: RADIO_DRV_GetBackend
+**
+*/
+LORA_RadioBackend_Enum_t RADIO_DRV_GetBackend(const RADIO_DRV_Class_t *RadioDrv)
+{
+
+   return RadioDrv->Backend;
+
+} /* End RADIO_DRV_GetBackend() */
+
+
+/******************************************************************************
+** Function: RADIO_DRV_Supports
+**
+*/
+bool RADIO_DRV_Supports(const RADIO_DRV_Class_t *RadioDrv, RADIO_DRV_Call_t Call)
+{
+
+   if (Call >= RADIO_DRV_CALL_CNT)
+   {
+      return false;
+   }
+
+   return (RadioDrv->Backend == LORA_RadioBackend_SIM || Sx128xCall[Call]);
+
+} /* End RADIO_DRV_Supports() */
+
+
+/******************************************************************************
+** Function: RADIO_DRV_SendStatsTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool RADIO_DRV_SendStatsTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   RADIO_DRV_Class_t *RadioDrv = (RADIO_DRV_Class_t *)ObjDataPtr;
+   LORA_RadioStatsTlm_Payload_t *StatsTlmPayload = &RadioDrv->StatsTlm.Payload;
+
+   LoadCallStatsTlm(&StatsTlmPayload->SetStandbyMode,        &RadioDrv->CallStats[RADIO_DRV_CALL_SET_STANDBY_MODE]);
+   LoadCallStatsTlm(&StatsTlmPayload->SetPowerRegulatorMode, &RadioDrv->CallStats[RADIO_DRV_CALL_SET_POWER_REGULATOR_MODE]);
+   LoadCallStatsTlm(&StatsTlmPayload->SetLowNoiseAmpMode,    &RadioDrv->CallStats[RADIO_DRV_CALL_SET_LOW_NOISE_AMP_MODE]);
+   LoadCallStatsTlm(&StatsTlmPayload->SetPowerAmpRampTime,   &RadioDrv->CallStats[RADIO_DRV_CALL_SET_POWER_AMP_RAMP_TIME]);
+   LoadCallStatsTlm(&StatsTlmPayload->SetModulationParams,   &RadioDrv->CallStats[RADIO_DRV_CALL_SET_MODULATION_PARAMS]);
+   LoadCallStatsTlm(&StatsTlmPayload->SetRadioFrequency,     &RadioDrv->CallStats[RADIO_DRV_CALL_SET_RADIO_FREQUENCY]);
+   LoadCallStatsTlm(&StatsTlmPayload->SetPreambleLength,     &RadioDrv->CallStats[RADIO_DRV_CALL_SET_PREAMBLE_LENGTH]);
+   LoadCallStatsTlm(&StatsTlmPayload->SetHeaderType,         &RadioDrv->CallStats[RADIO_DRV_CALL_SET_HEADER_TYPE]);
+   LoadCallStatsTlm(&StatsTlmPayload->SetRxDutyCycle,        &RadioDrv->CallStats[RADIO_DRV_CALL_SET_RX_DUTY_CYCLE]);
+   LoadCallStatsTlm(&StatsTlmPayload->SendPayload,           &RadioDrv->CallStats[RADIO_DRV_CALL_SEND_PAYLOAD]);
+   LoadCallStatsTlm(&StatsTlmPayload->ReceivePayload,        &RadioDrv->CallStats[RADIO_DRV_CALL_RECEIVE_PAYLOAD]);
+
+   StatsTlmPayload->SimTxFrameCnt      = RadioDrv->Sim.Stats.TxFrameCnt;
+   StatsTlmPayload->SimRxFrameCnt      = RadioDrv->Sim.Stats.RxFrameCnt;
+   StatsTlmPayload->SimLostFrameCnt    = RadioDrv->Sim.Stats.LostFrameCnt;
+   StatsTlmPayload->SimIgnoredFrameCnt = RadioDrv->Sim.Stats.IgnoredFrameCnt;
+   StatsTlmPayload->SimDutyMissCnt     = RadioDrv->Sim.Stats.DutyMissCnt;
+   StatsTlmPayload->SimBurstCnt        = RadioDrv->Sim.Channel.BurstCnt;
+   StatsTlmPayload->SimLastSnr         = RadioDrv->Sim.Stats.LastSnr;
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(RadioDrv->StatsTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(RadioDrv->StatsTlm.TelemetryHeader), true);
+
+   CFE_EVS_SendEvent(RADIO_DRV_SEND_STATS_TLM_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                     "Sent radio %u driver statistics telemetry message", RadioDrv->Inst->Index);
+   return true;
+
+} /* End RADIO_DRV_SendStatsTlmCmd() */
+
+
+/******************************************************************************
+** Function: RADIO_DRV_WriteStatsFileCmd
+**
+** Write the call statistics to a CSV file with one row per driver call.
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**   2. Each row contains the call name, counters, min/avg/max latency in
+**      microseconds followed by the latency histogram bins.
+*/
+bool RADIO_DRV_WriteStatsFileCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   RADIO_DRV_Class_t *RadioDrv = (RADIO_DRV_Class_t *)ObjDataPtr;
+   const LORA_WriteRadioStatsFile_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_WriteRadioStatsFile_t);
+
+   bool      RetStatus = false;
+   int32     SysStatus;
+   osal_id_t FileHandle;
+   char      Line[STATS_FILE_LINE_LEN];
+   size_t    LineLen;
+   uint16    Call;
+   uint16    Bin;
+   const RADIO_DRV_CallStats_t *CallStats;
+
+   SysStatus = OS_OpenCreate(&FileHandle, Cmd->Filename, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_WRITE_ONLY);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+
+      LineLen = snprintf(Line, sizeof(Line), "Call,CallCnt,ErrCnt,MinUsec,AvgUsec,MaxUsec");
+      for (Bin=0; Bin < RADIO_DRV_LATENCY_BINS; Bin++)
+      {
+         LineLen += snprintf(&Line[LineLen], sizeof(Line)-LineLen, ",Ge%luUsec", (unsigned long)(1UL << Bin));
+      }
+      LineLen += snprintf(&Line[LineLen], sizeof(Line)-LineLen, "\n");
+      OS_write(FileHandle, Line, LineLen);
+
+      for (Call=0; Call < RADIO_DRV_CALL_CNT; Call++)
+      {
+
+         CallStats = &RadioDrv->CallStats[Call];
+
+         LineLen = snprintf(Line, sizeof(Line), "%s,%lu,%lu,%lu,%lu,%lu", CallName[Call],
+                            (unsigned long)CallStats->CallCnt, (unsigned long)CallStats->ErrCnt,
+                            (unsigned long)(CallStats->CallCnt ? CallStats->MinUsec : 0),
+                            (unsigned long)(CallStats->CallCnt ? CallStats->TotalUsec/CallStats->CallCnt : 0),
+                            (unsigned long)CallStats->MaxUsec);
+         for (Bin=0; Bin < RADIO_DRV_LATENCY_BINS; Bin++)
+         {
+            LineLen += snprintf(&Line[LineLen], sizeof(Line)-LineLen, ",%lu", (unsigned long)CallStats->LatencyHist[Bin]);
+         }
+         LineLen += snprintf(&Line[LineLen], sizeof(Line)-LineLen, "\n");
+         OS_write(FileHandle, Line, LineLen);
+
+      } /* End call loop */
+
+      OS_close(FileHandle);
+
+      RetStatus = true;
+      CFE_EVS_SendEvent(RADIO_DRV_WRITE_STATS_FILE_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                        "Wrote radio %u driver statistics to %s", RadioDrv->Inst->Index, Cmd->Filename);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(RADIO_DRV_WRITE_STATS_FILE_CMD_EID, CFE_EVS_EventType_ERROR,
+                        "Write radio driver statistics failed, error creating %s, Status = %d",
+                        Cmd->Filename, SysStatus);
+   }
+
+   return RetStatus;
+
+} /* End RADIO_DRV_WriteStatsFileCmd() */
+
+
+/******************************************************************************
+** Functions: Radio driver call wrappers
+**
+** Notes:
+**   1. Each wrapper captures the start time, makes the backend call and
+**      records the outcome.
+**   2. Wrappers for calls that are only supported by the SIM backend return
+**      false before the start time is captured on the SX128X backend.
+*/
+
+bool RADIO_DRV_SetStandbyMode(RADIO_DRV_Class_t *RadioDrv, SX128X_StandbyMode_Enum_t StandbyMode)
+{
+
+   bool      RetStatus;
+   OS_time_t StartTime;
+
+   OS_GetLocalTime(&StartTime);
+   if (RadioDrv->Backend == LORA_RadioBackend_SIM)
+   {
+      RetStatus = RADIO_SIM_SetStandbyMode(&RadioDrv->Sim, StandbyMode);
+   }
+   else
+   {
+      RetStatus = RADIO_SetStandbyMode(StandbyMode);
+   }
+   RecordCall(RadioDrv, RADIO_DRV_CALL_SET_STANDBY_MODE, RetStatus, &StartTime);
+
+   return RetStatus;
+
+} /* End RADIO_DRV_SetStandbyMode() */
+
+
+bool RADIO_DRV_SetPowerRegulatorMode(RADIO_DRV_Class_t *RadioDrv, SX128X_PowerRegulatorMode_Enum_t PowerRegulatorMode)
+{
+
+   bool      RetStatus;
+   OS_time_t StartTime;
+
+   OS_GetLocalTime(&StartTime);
+   if (RadioDrv->Backend == LORA_RadioBackend_SIM)
+   {
+      RetStatus = RADIO_SIM_SetPowerRegulatorMode(&RadioDrv->Sim, PowerRegulatorMode);
+   }
+   else
+   {
+      RetStatus = RADIO_SetPowerRegulatorMode(PowerRegulatorMode);
+   }
+   RecordCall(RadioDrv, RADIO_DRV_CALL_SET_POWER_REGULATOR_MODE, RetStatus, &StartTime);
+
+   return RetStatus;
+
+} /* End RADIO_DRV_SetPowerRegulatorMode() */
+
+
+bool RADIO_DRV_SetLowNoiseAmpMode(RADIO_DRV_Class_t *RadioDrv, SX128X_LowNoiseAmpMode_Enum_t LowNoiseAmpMode)
+{
+
+   bool      RetStatus;
+   OS_time_t StartTime;
+
+   OS_GetLocalTime(&StartTime);
+   if (RadioDrv->Backend == LORA_RadioBackend_SIM)
+   {
+      RetStatus = RADIO_SIM_SetLowNoiseAmpMode(&RadioDrv->Sim, LowNoiseAmpMode);
+   }
+   else
+   {
+      RetStatus = RADIO_SetLowNoiseAmpMode(LowNoiseAmpMode);
+   }
+   RecordCall(RadioDrv, RADIO_DRV_CALL_SET_LOW_NOISE_AMP_MODE, RetStatus, &StartTime);
+
+   return RetStatus;
+
+} /* End RADIO_DRV_SetLowNoiseAmpMode() */
+
+
+bool RADIO_DRV_SetPowerAmpRampTime(RADIO_DRV_Class_t *RadioDrv, SX128X_PowerAmpRampTime_Enum_t PowerAmpRampTime)
+{
+
+   bool      RetStatus;
+   OS_time_t StartTime;
+
+   OS_GetLocalTime(&StartTime);
+   if (RadioDrv->Backend == LORA_RadioBackend_SIM)
+   {
+      RetStatus = RADIO_SIM_SetPowerAmpRampTime(&RadioDrv->Sim, PowerAmpRampTime);
+   }
+   else
+   {
+      RetStatus = RADIO_SetPowerAmpRampTime(PowerAmpRampTime);
+   }
+   RecordCall(RadioDrv, RADIO_DRV_CALL_SET_POWER_AMP_RAMP_TIME, RetStatus, &StartTime);
+
+   return RetStatus;
+
+} /* End RADIO_DRV_SetPowerAmpRampTime() */
+
+
+bool RADIO_DRV_SetModulationParams(RADIO_DRV_Class_t *RadioDrv,
+                                   SX128X_ModulationSpreadingFactor_Enum_t SpreadingFactor,
+                                   SX128X_ModulationBandwidth_Enum_t       Bandwidth,
+                                   SX128X_ModulationCodingRate_Enum_t      CodingRate)
+{
+
+   bool      RetStatus;
+   OS_time_t StartTime;
+
+   OS_GetLocalTime(&StartTime);
+   if (RadioDrv->Backend == LORA_RadioBackend_SIM)
+   {
+      RetStatus = RADIO_SIM_SetModulationParams(&RadioDrv->Sim, SpreadingFactor, Bandwidth, CodingRate);
+   }
+   else
+   {
+      RetStatus = RADIO_SetModulationParams(SpreadingFactor, Bandwidth, CodingRate);
+   }
+   RecordCall(RadioDrv, RADIO_DRV_CALL_SET_MODULATION_PARAMS, RetStatus, &StartTime);
+
+   return RetStatus;
+
+} /* End RADIO_DRV_SetModulationParams() */
+
+
+bool RADIO_DRV_SetRadioFrequency(RADIO_DRV_Class_t *RadioDrv, uint32 Frequency)
+{
+
+   bool      RetStatus;
+   OS_time_t StartTime;
+
+   OS_GetLocalTime(&StartTime);
+   if (RadioDrv->Backend == LORA_RadioBackend_SIM)
+   {
+      RetStatus = RADIO_SIM_SetRadioFrequency(&RadioDrv->Sim, Frequency);
+   }
+   else
+   {
+      RetStatus = RADIO_SetRadioFrequency(Frequency);
+   }
+   RecordCall(RadioDrv, RADIO_DRV_CALL_SET_RADIO_FREQUENCY, RetStatus, &StartTime);
+
+   return RetStatus;
+
+} /* End RADIO_DRV_SetRadioFrequency() */
+
+
+bool RADIO_DRV_SetPreambleLength(RADIO_DRV_Class_t *RadioDrv, uint16 PreambleLen)
+{
+
+   bool      RetStatus;
+   OS_time_t StartTime;
+
+   if (!RADIO_DRV_Supports(RadioDrv, RADIO_DRV_CALL_SET_PREAMBLE_LENGTH))
+   {
+      return false;
+   }
+
+   OS_GetLocalTime(&StartTime);
+   RetStatus = RADIO_SIM_SetPreambleLength(&RadioDrv->Sim, PreambleLen);
+   RecordCall(RadioDrv, RADIO_DRV_CALL_SET_PREAMBLE_LENGTH, RetStatus, &StartTime);
+
+   return RetStatus;
+
+} /* End RADIO_DRV_SetPreambleLength() */
+
+
+bool RADIO_DRV_SetHeaderType(RADIO_DRV_Class_t *RadioDrv, LORA_HeaderType_Enum_t HeaderType, uint8 PayloadLen)
+{
+
+   bool      RetStatus;
+   OS_time_t StartTime;
+
+   if (!RADIO_DRV_Supports(RadioDrv, RADIO_DRV_CALL_SET_HEADER_TYPE))
+   {
+      return false;
+   }
+
+   OS_GetLocalTime(&StartTime);
+   RetStatus = RADIO_SIM_SetHeaderType(&RadioDrv->Sim, HeaderType, PayloadLen);
+   RecordCall(RadioDrv, RADIO_DRV_CALL_SET_HEADER_TYPE, RetStatus, &StartTime);
+
+   return RetStatus;
+
+} /* End RADIO_DRV_SetHeaderType() */
+
+
+bool RADIO_DRV_SetRxDutyCycle(RADIO_DRV_Class_t *RadioDrv, uint32 RxPeriodUsec, uint32 SleepPeriodUsec)
+{
+
+   bool      RetStatus;
+   OS_time_t StartTime;
+
+   if (!RADIO_DRV_Supports(RadioDrv, RADIO_DRV_CALL_SET_RX_DUTY_CYCLE))
+   {
+      return false;
+   }
+
+   OS_GetLocalTime(&StartTime);
+   RetStatus = RADIO_SIM_SetRxDutyCycle(&RadioDrv->Sim, RxPeriodUsec, SleepPeriodUsec);
+   RecordCall(RadioDrv, RADIO_DRV_CALL_SET_RX_DUTY_CYCLE, RetStatus, &StartTime);
+
+   return RetStatus;
+
+} /* End RADIO_DRV_SetRxDutyCycle() */
+
+
+bool RADIO_DRV_SendPayload(RADIO_DRV_Class_t *RadioDrv, const uint8 *Payload, uint8 PayloadLen, uint32 TimeoutMs)
+{
+
+   bool      RetStatus;
+   OS_time_t StartTime;
+
+   if (!RADIO_DRV_Supports(RadioDrv, RADIO_DRV_CALL_SEND_PAYLOAD))
+   {
+      return false;
+   }
+
+   OS_GetLocalTime(&StartTime);
+   RetStatus = RADIO_SIM_SendPayload(&RadioDrv->Sim, Payload, PayloadLen, TimeoutMs);
+   RecordCall(RadioDrv, RADIO_DRV_CALL_SEND_PAYLOAD, RetStatus, &StartTime);
+
+   return RetStatus;
+
+} /* End RADIO_DRV_SendPayload() */
+
+
+bool RADIO_DRV_ReceivePayload(RADIO_DRV_Class_t *RadioDrv, uint8 *Payload, uint8 *PayloadLen,
+                              uint8 MaxLen, int8 *RssiPkt, int8 *SnrPkt, uint32 TimeoutMs)
+{
+
+   bool      RetStatus;
+   OS_time_t StartTime;
+
+   if (!RADIO_DRV_Supports(RadioDrv, RADIO_DRV_CALL_RECEIVE_PAYLOAD))
+   {
+      return false;
+   }
+
+   OS_GetLocalTime(&StartTime);
+   RetStatus = RADIO_SIM_ReceivePayload(&RadioDrv->Sim, Payload, PayloadLen, MaxLen,
+                                        RssiPkt, SnrPkt, TimeoutMs);
+   RecordCall(RadioDrv, RADIO_DRV_CALL_RECEIVE_PAYLOAD, RetStatus, &StartTime);
+
+   return RetStatus;
+
+} /* End RADIO_DRV_ReceivePayload() */
+
+
+/******************************************************************************
+** Function: LoadCallStatsTlm
+**
+*/
+static void LoadCallStatsTlm(LORA_RadioCallStats_t *CallStatsTlm, const RADIO_DRV_CallStats_t *CallStats)
+{
+
+   CallStatsTlm->CallCnt = CallStats->CallCnt;
+   CallStatsTlm->ErrCnt  = CallStats->ErrCnt;
+   CallStatsTlm->MinUsec = CallStats->CallCnt ? CallStats->MinUsec : 0;
+   CallStatsTlm->AvgUsec = CallStats->CallCnt ? (uint32)(CallStats->TotalUsec/CallStats->CallCnt) : 0;
+   CallStatsTlm->MaxUsec = CallStats->MaxUsec;
+
+   memcpy(CallStatsTlm->LatencyHist, CallStats->LatencyHist, sizeof(CallStats->LatencyHist));
+
+} /* End LoadCallStatsTlm() */
+
+
+/******************************************************************************
+** Function: RecordCall
+**
+** Notes:
+**   1. The histogram bin is floor(log2(usec)) limited to the last bin.
+*/
+static void RecordCall(RADIO_DRV_Class_t *RadioDrv, RADIO_DRV_Call_t Call, bool CallStatus,
+                       const OS_time_t *StartTime)
+{
+
+   RADIO_DRV_CallStats_t *CallStats = &RadioDrv->CallStats[Call];
+   OS_time_t EndTime;
+   uint32    Usec;
+   uint32    Scaled;
+   uint16    Bin = 0;
+
+   OS_GetLocalTime(&EndTime);
+   Usec = (uint32)OS_TimeGetTotalMicroseconds(OS_TimeSubtract(EndTime, *StartTime));
+
+   CallStats->CallCnt++;
+   if (!CallStatus)
+   {
+      CallStats->ErrCnt++;
+   }
+
+   CallStats->TotalUsec += Usec;
+   if (Usec < CallStats->MinUsec) CallStats->MinUsec = Usec;
+   if (Usec > CallStats->MaxUsec) CallStats->MaxUsec = Usec;
+
+   for (Scaled = Usec; Scaled > 1 && Bin < (RADIO_DRV_LATENCY_BINS-1); Scaled >>= 1)
+   {
+      Bin++;
+   }
+   CallStats->LatencyHist[Bin]++;
+
+} /* End RecordCall() */
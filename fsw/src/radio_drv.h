@@ -0,0 +1,254 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the radio driver wrapper class
+**
+**  Notes:
+**    1. Every call the app makes into the SX128X library must go through
+**       this object. Each wrapper times the library call and records a call
+**       count, a failure count and a log2 latency histogram so slow links
+**       can be traced to a specific driver operation.
+**    2. The latency of a call includes everything the library does (SPI
+**       transfers and BUSY pin polling). The library doesn't report these
+**       separately so they can't be split here.
+**    3. The statistics are reported in the RadioStatsTlm message and can be
+**       written to a CSV file by command.
+**    4. The radio's RADIO_n_BACKEND JSON init file parameter selects whether
+**       calls go to the SX128X library ("SX128X") or to the simulated radio
+**       ("SIM").
+**    5. The SX128X library doesn't implement every call. The calls it's
+**       missing are only supported by the SIM backend and fail without
+**       touching the radio on the SX128X backend. Use RADIO_DRV_Supports()
+**       to reject a command before it's started.
+**
+*/
+
+#ifndef _radio_drv_
+#define _radio_drv_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "radio_sim.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Latency histogram bin N counts calls that took [2^N, 2^(N+1)) microseconds.
+** Bin 0 includes calls under 1us and the last bin includes everything over
+** its lower bound. Must match the LatencyHist array size in lora.xml.
+*/
+#define RADIO_DRV_LATENCY_BINS  24
+
+
+/*
+** Event Message IDs
+*/
+
+#define RADIO_DRV_SEND_STATS_TLM_CMD_EID    (RADIO_DRV_BASE_EID + 1)
+#define RADIO_DRV_WRITE_STATS_FILE_CMD_EID  (RADIO_DRV_BASE_EID + 2)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+/*
+** Driver calls that are measured. Used to index the call statistics table.
+*/
+typedef enum
+{
+
+   RADIO_DRV_CALL_SET_STANDBY_MODE = 0,
+   RADIO_DRV_CALL_SET_POWER_REGULATOR_MODE,
+   RADIO_DRV_CALL_SET_LOW_NOISE_AMP_MODE,
+   RADIO_DRV_CALL_SET_POWER_AMP_RAMP_TIME,
+   RADIO_DRV_CALL_SET_MODULATION_PARAMS,
+   RADIO_DRV_CALL_SET_RADIO_FREQUENCY,
+   RADIO_DRV_CALL_SET_PREAMBLE_LENGTH,
+   RADIO_DRV_CALL_SET_HEADER_TYPE,
+   RADIO_DRV_CALL_SET_RX_DUTY_CYCLE,
+   RADIO_DRV_CALL_SEND_PAYLOAD,
+   RADIO_DRV_CALL_RECEIVE_PAYLOAD,
+   RADIO_DRV_CALL_CNT
+
+} RADIO_DRV_Call_t;
+
+
+typedef struct
+{
+
+   uint32  CallCnt;
+   uint32  ErrCnt;
+   uint32  MinUsec;
+   uint32  MaxUsec;
+   uint64  TotalUsec;
+   uint32  LatencyHist[RADIO_DRV_LATENCY_BINS];
+
+} RADIO_DRV_CallStats_t;
+
+
+/******************************************************************************
+** RADIO_DRV_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Framework References
+   */
+
+   INITBL_Class_t *IniTbl;
+   const RADIO_INST_Cfg_t *Inst;
+
+   /*
+   ** Telemetry Packets
+   */
+
+   LORA_RadioStatsTlm_t  StatsTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   LORA_RadioBackend_Enum_t  Backend;
+   RADIO_SIM_Class_t         Sim;
+
+   RADIO_DRV_CallStats_t  CallStats[RADIO_DRV_CALL_CNT];
+
+} RADIO_DRV_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: RADIO_DRV_Constructor
+**
+** Initialize the Radio Driver object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void RADIO_DRV_Constructor(RADIO_DRV_Class_t *RadioDrv, INITBL_Class_t *IniTbl,
+                           const RADIO_INST_Cfg_t *Inst);
+
+
+/******************************************************************************
+** Function: RADIO_DRV_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+** Notes:
+**   1. All of the call statistics are cleared.
+**   2. The statistics are updated by the radio task so after construction
+**      this must only be called by the radio task. Other tasks request a
+**      reset with RADIO_TASK_ResetStatus().
+**
+*/
+void RADIO_DRV_ResetStatus(RADIO_DRV_Class_t *RadioDrv);
+
+
+/******************************************************************************
+** Function: RADIO_DRV_GetBackend
+**
+*/
+LORA_RadioBackend_Enum_t RADIO_DRV_GetBackend(const RADIO_DRV_Class_t *RadioDrv);
+
+
+/******************************************************************************
+** Function: RADIO_DRV_Supports
+**
+** Return true if the driver's backend implements a call.
+**
+** Notes:
+**   1. The backend is fixed at construction so any task can call this.
+**
+*/
+bool RADIO_DRV_Supports(const RADIO_DRV_Class_t *RadioDrv, RADIO_DRV_Call_t Call);
+
+
+/******************************************************************************
+** Function: RADIO_DRV_SendStatsTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool RADIO_DRV_SendStatsTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: RADIO_DRV_WriteStatsFileCmd
+**
+** Write the call statistics to a CSV file with one row per driver call.
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool RADIO_DRV_WriteStatsFileCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Functions: Radio driver call wrappers
+**
+** Each function has the same parameters following the object pointer and the
+** same return value as the SX128X library function with the same name suffix.
+**
+** Notes:
+**   1. A call that the backend doesn't support returns false without being
+**      counted in the call statistics.
+**   2. SendPayload returns after the txDone IRQ or the timeout.
+**   3. ReceivePayload waits up to the timeout for the rxDone IRQ of a frame
+**      with a valid CRC.
+**   4. SetPreambleLength sets the LoRa packet parameter preamble length in
+**      symbols.
+**   5. SetHeaderType sets the LoRa packet parameter header type. An implicit
+**      header sends and receives PayloadLen bytes, it's ignored for an
+**      explicit header.
+**   6. SetRxDutyCycle selects how ReceivePayload listens. A zero sleep period
+**      uses continuous receive (SetRx). Otherwise the radio alternates
+**      between RxPeriodUsec of receive and SleepPeriodUsec of sleep
+**      (SetRxDutyCycle) until a preamble is detected.
+**
+*/
+bool RADIO_DRV_SetStandbyMode(RADIO_DRV_Class_t *RadioDrv, SX128X_StandbyMode_Enum_t StandbyMode);
+bool RADIO_DRV_SetPowerRegulatorMode(RADIO_DRV_Class_t *RadioDrv, SX128X_PowerRegulatorMode_Enum_t PowerRegulatorMode);
+bool RADIO_DRV_SetLowNoiseAmpMode(RADIO_DRV_Class_t *RadioDrv, SX128X_LowNoiseAmpMode_Enum_t LowNoiseAmpMode);
+bool RADIO_DRV_SetPowerAmpRampTime(RADIO_DRV_Class_t *RadioDrv, SX128X_PowerAmpRampTime_Enum_t PowerAmpRampTime);
+bool RADIO_DRV_SetModulationParams(RADIO_DRV_Class_t *RadioDrv,
+                                   SX128X_ModulationSpreadingFactor_Enum_t SpreadingFactor,
+                                   SX128X_ModulationBandwidth_Enum_t       Bandwidth,
+                                   SX128X_ModulationCodingRate_Enum_t      CodingRate);
+bool RADIO_DRV_SetRadioFrequency(RADIO_DRV_Class_t *RadioDrv, uint32 Frequency);
+bool RADIO_DRV_SetPreambleLength(RADIO_DRV_Class_t *RadioDrv, uint16 PreambleLen);
+bool RADIO_DRV_SetHeaderType(RADIO_DRV_Class_t *RadioDrv, LORA_HeaderType_Enum_t HeaderType, uint8 PayloadLen);
+bool RADIO_DRV_SetRxDutyCycle(RADIO_DRV_Class_t *RadioDrv, uint32 RxPeriodUsec, uint32 SleepPeriodUsec);
+bool RADIO_DRV_SendPayload(RADIO_DRV_Class_t *RadioDrv, const uint8 *Payload, uint8 PayloadLen, uint32 TimeoutMs);
+bool RADIO_DRV_ReceivePayload(RADIO_DRV_Class_t *RadioDrv, uint8 *Payload, uint8 *PayloadLen,
+                              uint8 MaxLen, int8 *RssiPkt, int8 *SnrPkt, uint32 TimeoutMs);
+
+
+#endif /* _radio_drv_ */
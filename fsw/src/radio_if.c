@@ -23,7 +23,12 @@
 **    2. For each radio command, the Radio object in the SX128X library
 **       performs radio level validation checks. The Radio object does not
 **       have a cFE interface so these command functions issue events
-**       messages.
+**       messages. Library calls are made through radio_drv so they're
+**       included in the driver statistics.
+**    3. Radio commands are queued to the radio task so the command functions
+**       never wait for the radio. A command function's return status only
+**       indicates whether the command was queued. CmdCompletion() reports
+**       the radio call result.
 **    TODO: Determine which command validity checks should be implemented
 **    TODO: Detmerine what radio status can be provide in command failure events
 **    TODO: Determine how the radio state is maintained and reported in tlm.
@@ -35,8 +40,10 @@
 */
 
 #include <string.h>
-#include "radio.h"
+#include "lora_frame.h"
+#include "radio_drv.h"
 #include "radio_if.h"
+#include "rx_duty.h"
 
 
 /***********************/
@@ -47,17 +54,15 @@
 #define  INITBL_OBJ   (RadioIf->IniTbl)
 
 
-/**********************/
-/** Global File Data **/
-/**********************/
-
-static RADIO_IF_Class_t *RadioIf = NULL;
-
-
 /*******************************/
 /** Local Function Prototypes **/
 /*******************************/
 
+static void CmdCompletion(void *CplObj, const RADIO_TASK_Req_t *Req);
+static void InitCmdReq(RADIO_IF_Class_t *RadioIf, RADIO_TASK_Req_t *Req, RADIO_TASK_Op_t Op);
+static bool ValidPacketParams(const RADIO_IF_Class_t *RadioIf, const LORA_SetPacketParams_CmdPayload_t *Packet,
+                              uint16 EventId);
+
 
 /******************************************************************************
 ** Function: RADIO_IF_Constructor
@@ -68,20 +73,34 @@ static RADIO_IF_Class_t *RadioIf = NULL;
 **   1. This must be called prior to any other function.
 **
 */
-void RADIO_IF_Constructor(RADIO_IF_Class_t *RadioIfPtr, INITBL_Class_t *IniTbl)
+void RADIO_IF_Constructor(RADIO_IF_Class_t *RadioIf, INITBL_Class_t *IniTbl,
+                          const RADIO_INST_Cfg_t *Inst, RADIO_TASK_Class_t *RadioTask,
+                          RADIO_DRV_Class_t *RadioDrv, RX_DUTY_Class_t *RxDuty)
 {
    
-   RadioIf = RadioIfPtr;
-   
    memset(RadioIf, 0, sizeof(RADIO_IF_Class_t));
    
-   RadioIf->IniTbl = IniTbl;
+   RadioIf->IniTbl    = IniTbl;
+   RadioIf->Inst      = Inst;
+   RadioIf->RadioTask = RadioTask;
+   RadioIf->RadioDrv  = RadioDrv;
+   RadioIf->RxDuty    = RxDuty;
    
-   RadioIf->RadioConfig.Frequency = INITBL_GetIntConfig(INITBL_OBJ, CFG_RADIO_FREQUENCY);
+   RadioIf->RadioConfig.Frequency = INITBL_GetIntConfig(INITBL_OBJ, CFG_RADIO_FREQUENCY) + Inst->FreqOffset;
    
    RadioIf->RadioConfig.Modulation.SpreadingFactor = INITBL_GetIntConfig(INITBL_OBJ, CFG_RADIO_LORA_SF);
    RadioIf->RadioConfig.Modulation.Bandwidth       = INITBL_GetIntConfig(INITBL_OBJ, CFG_RADIO_LORA_BW);
    RadioIf->RadioConfig.Modulation.CodingRate      = INITBL_GetIntConfig(INITBL_OBJ, CFG_RADIO_LORA_CR);
+
+   RadioIf->RadioConfig.Packet.PreambleLen = INITBL_GetIntConfig(INITBL_OBJ, CFG_RADIO_LORA_PREAMBLE_LEN);
+   RadioIf->RadioConfig.Packet.HeaderType  = INITBL_GetIntConfig(INITBL_OBJ, CFG_RADIO_LORA_HEADER_TYPE);
+   RadioIf->RadioConfig.Packet.PayloadLen  = INITBL_GetIntConfig(INITBL_OBJ, CFG_RADIO_LORA_PAYLOAD_LEN);
+   if (!ValidPacketParams(RadioIf, &RadioIf->RadioConfig.Packet, RADIO_IF_CONSTRUCTOR_EID))
+   {
+      RadioIf->RadioConfig.Packet.PreambleLen = LORA_DEFAULT_PREAMBLE_LEN;
+      RadioIf->RadioConfig.Packet.HeaderType  = LORA_HeaderType_EXPLICIT;
+   }
+   RX_DUTY_SetBasePreambleLen(RxDuty, RadioIf->RadioConfig.Packet.PreambleLen);
       
    CFE_MSG_Init(CFE_MSG_PTR(RadioIf->RadioTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_LORA_RADIO_TLM_TOPICID)), sizeof(LORA_RadioTlm_t));
 
@@ -122,7 +141,7 @@ bool RADIO_IF_ChildTask(CHILDMGR_Class_t *ChildMgr)
 **      change the functional behavior should be reset.
 **
 */
-void RADIO_IF_ResetStatus(void)
+void RADIO_IF_ResetStatus(RADIO_IF_Class_t *RadioIf)
 {
 
    return;
@@ -130,6 +149,137 @@ void RADIO_IF_ResetStatus(void)
 } /* End RADIO_IF_ResetStatus() */
 
 
+/******************************************************************************
+** Function: RADIO_IF_InitRadio
+**
+** Load the radio with the current frequency and modulation configuration.
+**
+** Notes:
+**   1. Called by the demos before they start using the radio.
+**   2. The preamble length and receive duty cycle depend on the modulation
+**      so they're loaded after it.
+**   3. Always loads an explicit header, a demo file transfer switches to the
+**      configured implicit header itself.
+**
+*/
+bool RADIO_IF_InitRadio(RADIO_IF_Class_t *RadioIf, RADIO_TASK_Client_t Client)
+{
+
+   bool RetStatus;
+
+   RetStatus = RADIO_TASK_SetModulationParams(RadioIf->RadioTask, Client,
+                                              RadioIf->RadioConfig.Modulation.SpreadingFactor,
+                                              RadioIf->RadioConfig.Modulation.Bandwidth,
+                                              RadioIf->RadioConfig.Modulation.CodingRate);
+   if (RetStatus)
+   {
+      RetStatus = RADIO_TASK_SetRadioFrequency(RadioIf->RadioTask, Client,
+                                               RadioIf->RadioConfig.Frequency*1000000UL);
+   }
+   if (RetStatus)
+   {
+      RetStatus = RX_DUTY_ConfigRadio(RadioIf->RxDuty, Client, &RadioIf->RadioConfig.Modulation);
+   }
+   if (RetStatus)
+   {
+      RetStatus = RADIO_TASK_SetHeaderType(RadioIf->RadioTask, Client, LORA_HeaderType_EXPLICIT, 0);
+   }
+
+   if (RetStatus)
+   {
+      CFE_EVS_SendEvent(RADIO_IF_INIT_RADIO_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                        "Initialized radio %u: Frequency = %d Mhz, SF=%d, BW=%d, CR=%d",
+                        RadioIf->Inst->Index, RadioIf->RadioConfig.Frequency, RadioIf->RadioConfig.Modulation.SpreadingFactor,
+                        RadioIf->RadioConfig.Modulation.Bandwidth, RadioIf->RadioConfig.Modulation.CodingRate);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(RADIO_IF_INIT_RADIO_CMD_EID, CFE_EVS_EventType_ERROR,
+                        "Error initializing radio %u frequency and modulation parameters",
+                        RadioIf->Inst->Index);
+   }
+
+   return RetStatus;
+
+} /* End RADIO_IF_InitRadio() */
+
+
+/******************************************************************************
+** Function: RADIO_IF_TimeOnAir
+**
+** Return the time-on-air in microseconds of a frame with PayloadLen bytes
+** using the current modulation configuration.
+**
+** Notes:
+**   1. The simulated radio's time-on-air model matches the SX1280 so it's
+**      used for both backends.
+**   2. Includes the preamble lengthening of a duty-cycled receiver.
+**
+*/
+uint32 RADIO_IF_TimeOnAir(const RADIO_IF_Class_t *RadioIf, uint8 PayloadLen)
+{
+
+   return LORA_TOA_TimeOnAir(RadioIf->RadioConfig.Modulation.SpreadingFactor,
+                             RadioIf->RadioConfig.Modulation.Bandwidth,
+                             RadioIf->RadioConfig.Modulation.CodingRate,
+                             RADIO_IF_PreambleLen(RadioIf), PayloadLen);
+
+} /* End RADIO_IF_TimeOnAir() */
+
+
+/******************************************************************************
+** Function: RADIO_IF_ImplicitTimeOnAir
+**
+*/
+uint32 RADIO_IF_ImplicitTimeOnAir(const RADIO_IF_Class_t *RadioIf, uint8 PayloadLen)
+{
+
+   return LORA_TOA_FrameTimeOnAir(RadioIf->RadioConfig.Modulation.SpreadingFactor,
+                                  RadioIf->RadioConfig.Modulation.Bandwidth,
+                                  RadioIf->RadioConfig.Modulation.CodingRate,
+                                  RADIO_IF_PreambleLen(RadioIf), true, PayloadLen);
+
+} /* End RADIO_IF_ImplicitTimeOnAir() */
+
+
+/******************************************************************************
+** Function: RADIO_IF_PreambleLen
+**
+*/
+uint16 RADIO_IF_PreambleLen(const RADIO_IF_Class_t *RadioIf)
+{
+
+   return RX_DUTY_PreambleLen(RadioIf->RxDuty,
+                              RadioIf->RadioConfig.Modulation.SpreadingFactor,
+                              RadioIf->RadioConfig.Modulation.Bandwidth);
+
+} /* End RADIO_IF_PreambleLen() */
+
+
+/******************************************************************************
+** Function: RADIO_IF_GetModulation
+**
+*/
+const LORA_SetModulationParams_CmdPayload_t *RADIO_IF_GetModulation(const RADIO_IF_Class_t *RadioIf)
+{
+
+   return &RadioIf->RadioConfig.Modulation;
+
+} /* End RADIO_IF_GetModulation() */
+
+
+/******************************************************************************
+** Function: RADIO_IF_GetPacketParams
+**
+*/
+const LORA_SetPacketParams_CmdPayload_t *RADIO_IF_GetPacketParams(const RADIO_IF_Class_t *RadioIf)
+{
+
+   return &RadioIf->RadioConfig.Packet;
+
+} /* End RADIO_IF_GetPacketParams() */
+
+
 /******************************************************************************
 ** Function: RADIO_IF_SendRadioTlmCmd
 **
@@ -139,30 +289,37 @@ void RADIO_IF_ResetStatus(void)
 bool RADIO_IF_SendRadioTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
    
+   RADIO_IF_Class_t *RadioIf = (RADIO_IF_Class_t *)ObjDataPtr;
    LORA_RadioTlm_Payload_t *RadioTlmPayload = &RadioIf->RadioTlm.Payload;
+   const RADIO_INST_Cfg_t  *Inst = RadioIf->Inst;
    
-   strcpy(RadioTlmPayload->SpiDevStr, "TODO");   
+   RadioTlmPayload->Radio          = Inst->Index;
+   strncpy(RadioTlmPayload->SpiDevStr, Inst->SpiDev, sizeof(RadioTlmPayload->SpiDevStr)-1);
    RadioTlmPayload->SpiDevNum      = 0;
    RadioTlmPayload->SpiSpeed       = 0; //TODO: Get SPI setting
-   RadioTlmPayload->RadioPinBusy   = 1;
-   RadioTlmPayload->RadioPinNrst   = 2;
-   RadioTlmPayload->RadioPinNss    = 3;
-   RadioTlmPayload->RadioPinDio1   = 4;
-   RadioTlmPayload->RadioPinDio2   = 5;
-   RadioTlmPayload->RadioPinDio3   = 6;
-   RadioTlmPayload->RadioPinTxEn   = 7;
-   RadioTlmPayload->RadioPinRxEn   = 8;
-
+   RadioTlmPayload->RadioPinBusy   = Inst->Pin[RADIO_INST_PIN_BUSY];
+   RadioTlmPayload->RadioPinNrst   = Inst->Pin[RADIO_INST_PIN_NRST];
+   RadioTlmPayload->RadioPinNss    = Inst->Pin[RADIO_INST_PIN_NSS];
+   RadioTlmPayload->RadioPinDio1   = Inst->Pin[RADIO_INST_PIN_DIO1];
+   RadioTlmPayload->RadioPinDio2   = Inst->Pin[RADIO_INST_PIN_DIO2];
+   RadioTlmPayload->RadioPinDio3   = Inst->Pin[RADIO_INST_PIN_DIO3];
+   RadioTlmPayload->RadioPinTxEn   = Inst->Pin[RADIO_INST_PIN_TXEN];
+   RadioTlmPayload->RadioPinRxEn   = Inst->Pin[RADIO_INST_PIN_RXEN];
+
+   RadioTlmPayload->RadioBackend              = RADIO_DRV_GetBackend(RadioIf->RadioDrv);
    RadioTlmPayload->RadioFrequency            = RadioIf->RadioConfig.Frequency;
    RadioTlmPayload->ModulationSpreadingFactor = RadioIf->RadioConfig.Modulation.SpreadingFactor;
    RadioTlmPayload->ModulationBandwidth       = RadioIf->RadioConfig.Modulation.Bandwidth;
    RadioTlmPayload->ModulationCodingRate      = RadioIf->RadioConfig.Modulation.CodingRate;
+   RadioTlmPayload->PreambleLen               = RadioIf->RadioConfig.Packet.PreambleLen;
+   RadioTlmPayload->HeaderType                = RadioIf->RadioConfig.Packet.HeaderType;
+   RadioTlmPayload->PayloadLen                = RadioIf->RadioConfig.Packet.PayloadLen;
    
    CFE_SB_TimeStampMsg(CFE_MSG_PTR(RadioIf->RadioTlm.TelemetryHeader));
    CFE_SB_TransmitMsg(CFE_MSG_PTR(RadioIf->RadioTlm.TelemetryHeader), true);
 
    CFE_EVS_SendEvent(RADIO_IF_SEND_RADIO_TLM_CMD_EID, CFE_EVS_EventType_INFORMATION,
-                     "Sent Radio configuration telemetry message");
+                     "Sent radio %u configuration telemetry message", Inst->Index);
    return true;
    
 } /* RADIO_IF_SendRadioTlmCmd() */
@@ -177,29 +334,23 @@ bool RADIO_IF_SendRadioTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 bool RADIO_IF_SetLowNoiseAmpModeCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
    
+   RADIO_IF_Class_t *RadioIf = (RADIO_IF_Class_t *)ObjDataPtr;
    const LORA_SetLowNoiseAmpMode_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_SetLowNoiseAmpMode_t);
    bool RetStatus = false;
+   RADIO_TASK_Req_t Req;
 
    if (Cmd->LowNoiseAmpMode >= SX128X_LowNoiseAmpMode_Enum_t_MIN && Cmd->LowNoiseAmpMode <= SX128X_LowNoiseAmpMode_Enum_t_MAX)
    {
       RadioIf->RadioConfig.LowNoiseAmpMode = Cmd->LowNoiseAmpMode;
       
-      RetStatus = RADIO_SetLowNoiseAmpMode(Cmd->LowNoiseAmpMode);
-      if (RetStatus)
-      {
-         CFE_EVS_SendEvent(RADIO_IF_SET_LOW_NOISE_AMP_MODE_CMD_EID, CFE_EVS_EventType_INFORMATION,
-                           "Set radio power amp sensitivity mode succeeded: Mode = %d", Cmd->LowNoiseAmpMode);
-      }
-      else
-      {
-         CFE_EVS_SendEvent(RADIO_IF_SET_LOW_NOISE_AMP_MODE_CMD_EID, CFE_EVS_EventType_ERROR,
-                           "Set radio power amp sensitivity mode command failed");
-      }
+      InitCmdReq(RadioIf, &Req, RADIO_TASK_OP_SET_LOW_NOISE_AMP_MODE);
+      Req.Param.Mode = Cmd->LowNoiseAmpMode;
+      RetStatus = RADIO_TASK_SubmitCmd(RadioIf->RadioTask, &Req);
    }
    else
    {
       CFE_EVS_SendEvent(RADIO_IF_SET_LOW_NOISE_AMP_MODE_CMD_EID, CFE_EVS_EventType_ERROR,
-                           "Set radio power amp sensitivity mode command failed, invalid mode %d.",
+                           "Radio %u: set radio power amp sensitivity mode command failed, invalid mode %d.", RadioIf->Inst->Index,
                            Cmd->LowNoiseAmpMode);
    }
 
@@ -217,31 +368,70 @@ bool RADIO_IF_SetLowNoiseAmpModeCmd(void *ObjDataPtr, const CFE_MSG_Message_t *M
 bool RADIO_IF_SetModulationParamsCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
    
+   RADIO_IF_Class_t *RadioIf = (RADIO_IF_Class_t *)ObjDataPtr;
    const LORA_SetModulationParams_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_SetModulationParams_t);
    bool RetStatus = false;
+   RADIO_TASK_Req_t Req;
 
    RadioIf->RadioConfig.Modulation.SpreadingFactor = Cmd->SpreadingFactor;
    RadioIf->RadioConfig.Modulation.Bandwidth       = Cmd->Bandwidth;
    RadioIf->RadioConfig.Modulation.CodingRate      = Cmd->CodingRate;
 
-   RetStatus = RADIO_SetModulationParams(RadioIf->RadioConfig.Modulation.SpreadingFactor,
-                                         RadioIf->RadioConfig.Modulation.Bandwidth,
-                                         RadioIf->RadioConfig.Modulation.CodingRate);
-   if (RetStatus)
+   InitCmdReq(RadioIf, &Req, RADIO_TASK_OP_SET_MODULATION_PARAMS);
+   Req.Param.Modulation.SpreadingFactor = Cmd->SpreadingFactor;
+   Req.Param.Modulation.Bandwidth       = Cmd->Bandwidth;
+   Req.Param.Modulation.CodingRate      = Cmd->CodingRate;
+   RetStatus = RADIO_TASK_SubmitCmd(RadioIf->RadioTask, &Req);
+
+   return RetStatus;
+   
+} /* RADIO_IF_SetModulationParamsCmd() */
+
+
+/******************************************************************************
+** Function: RADIO_IF_SetPacketParamsCmd
+**
+** Notes:
+**   1. See radio_if.h for when the parameters are loaded into the radio.
+**   2. Parameters the driver backend can't load are rejected here rather
+**      than when a demo or link test starts.
+*/
+bool RADIO_IF_SetPacketParamsCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   RADIO_IF_Class_t *RadioIf = (RADIO_IF_Class_t *)ObjDataPtr;
+   const LORA_SetPacketParams_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_SetPacketParams_t);
+   bool RetStatus = false;
+
+   if (Cmd->PreambleLen != RadioIf->RadioConfig.Packet.PreambleLen &&
+       !RADIO_DRV_Supports(RadioIf->RadioDrv, RADIO_DRV_CALL_SET_PREAMBLE_LENGTH))
    {
-      CFE_EVS_SendEvent(RADIO_IF_SET_MODULATION_PARAMS_CMD_EID, CFE_EVS_EventType_INFORMATION,
-                        "Set modulation parameters command succeeded: SF=%d, BW=%d, RC=%d", Cmd->SpreadingFactor,
-                        Cmd->Bandwidth, Cmd->CodingRate);
+      CFE_EVS_SendEvent(RADIO_IF_SET_PACKET_PARAMS_CMD_EID, CFE_EVS_EventType_ERROR,
+                        "Radio %u: set packet parameters failed, the driver backend can't change the preamble length",
+                        RadioIf->Inst->Index);
    }
-   else
+   else if (Cmd->HeaderType == LORA_HeaderType_IMPLICIT &&
+            !RADIO_DRV_Supports(RadioIf->RadioDrv, RADIO_DRV_CALL_SET_HEADER_TYPE))
+   {
+      CFE_EVS_SendEvent(RADIO_IF_SET_PACKET_PARAMS_CMD_EID, CFE_EVS_EventType_ERROR,
+                        "Radio %u: set packet parameters failed, the driver backend can't use an implicit header",
+                        RadioIf->Inst->Index);
+   }
+   else if (ValidPacketParams(RadioIf, Cmd, RADIO_IF_SET_PACKET_PARAMS_CMD_EID))
    {
-      CFE_EVS_SendEvent(RADIO_IF_SET_MODULATION_PARAMS_CMD_EID, CFE_EVS_EventType_ERROR,
-                        "Set modulation parameters command failed");
+      RadioIf->RadioConfig.Packet = *Cmd;
+      RX_DUTY_SetBasePreambleLen(RadioIf->RxDuty, Cmd->PreambleLen);
+      RetStatus = true;
+      CFE_EVS_SendEvent(RADIO_IF_SET_PACKET_PARAMS_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                        "Radio %u: packet parameters set to preamble %d symbols, %s header, length %d. "
+                        "Applied when the next demo or link test starts",
+                        RadioIf->Inst->Index, Cmd->PreambleLen,
+                        (Cmd->HeaderType == LORA_HeaderType_IMPLICIT ? "implicit" : "explicit"), Cmd->PayloadLen);
    }
 
    return RetStatus;
-   
-} /* RADIO_IF_SetModulationParamsCmd() */
+
+} /* RADIO_IF_SetPacketParamsCmd() */
 
 
 /******************************************************************************
@@ -253,29 +443,23 @@ bool RADIO_IF_SetModulationParamsCmd(void *ObjDataPtr, const CFE_MSG_Message_t *
 bool RADIO_IF_SetPowerAmpRampTimeCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
    
+   RADIO_IF_Class_t *RadioIf = (RADIO_IF_Class_t *)ObjDataPtr;
    const LORA_SetPowerAmpRampTime_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_SetPowerAmpRampTime_t);
    bool RetStatus = false;
+   RADIO_TASK_Req_t Req;
 
    if (Cmd->PowerAmpRampTime >= SX128X_PowerAmpRampTime_Enum_t_MIN && Cmd->PowerAmpRampTime <= SX128X_PowerAmpRampTime_Enum_t_MAX)
    {
       RadioIf->RadioConfig.PowerAmpRampTime = Cmd->PowerAmpRampTime;
       
-      RetStatus = RADIO_SetLowNoiseAmpMode(Cmd->PowerAmpRampTime);
-      if (RetStatus)
-      {
-         CFE_EVS_SendEvent(RADIO_IF_SET_POWER_AMP_RAMP_TIME_CMD_EID, CFE_EVS_EventType_INFORMATION,
-                           "Set radio power amp ramp time succeeded: Mode = %d", Cmd->PowerAmpRampTime);
-      }
-      else
-      {
-         CFE_EVS_SendEvent(RADIO_IF_SET_POWER_AMP_RAMP_TIME_CMD_EID, CFE_EVS_EventType_ERROR,
-                           "Set radio power amp ramp time command failed");
-      }
+      InitCmdReq(RadioIf, &Req, RADIO_TASK_OP_SET_POWER_AMP_RAMP_TIME);
+      Req.Param.Mode = Cmd->PowerAmpRampTime;
+      RetStatus = RADIO_TASK_SubmitCmd(RadioIf->RadioTask, &Req);
    }
    else
    {
       CFE_EVS_SendEvent(RADIO_IF_SET_POWER_AMP_RAMP_TIME_CMD_EID, CFE_EVS_EventType_ERROR,
-                           "Set radio power amp ramp time command failed, invalid mode %d.",
+                           "Radio %u: set radio power amp ramp time command failed, invalid mode %d.", RadioIf->Inst->Index,
                            Cmd->PowerAmpRampTime);
    }
 
@@ -293,29 +477,23 @@ bool RADIO_IF_SetPowerAmpRampTimeCmd(void *ObjDataPtr, const CFE_MSG_Message_t *
 bool RADIO_IF_SetPowerRegulatorModeCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
    
+   RADIO_IF_Class_t *RadioIf = (RADIO_IF_Class_t *)ObjDataPtr;
    const LORA_SetPowerRegulatorMode_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_SetPowerRegulatorMode_t);
    bool RetStatus = false;
+   RADIO_TASK_Req_t Req;
 
    if (Cmd->PowerRegulatorMode >= SX128X_PowerRegulatorMode_Enum_t_MIN && Cmd->PowerRegulatorMode <= SX128X_PowerRegulatorMode_Enum_t_MAX)
    {
       RadioIf->RadioConfig.PowerRegulatorMode = Cmd->PowerRegulatorMode;
       
-      RetStatus = RADIO_SetPowerRegulatorMode(Cmd->PowerRegulatorMode);
-      if (RetStatus)
-      {
-         CFE_EVS_SendEvent(RADIO_IF_SET_POWER_REGULATOR_MODE_CMD_EID, CFE_EVS_EventType_INFORMATION,
-                           "Set radio power regulator mode succeeded: Mode = %d", Cmd->PowerRegulatorMode);
-      }
-      else
-      {
-         CFE_EVS_SendEvent(RADIO_IF_SET_POWER_REGULATOR_MODE_CMD_EID, CFE_EVS_EventType_ERROR,
-                           "Set radio power regulator mode command failed");
-      }
+      InitCmdReq(RadioIf, &Req, RADIO_TASK_OP_SET_POWER_REGULATOR_MODE);
+      Req.Param.Mode = Cmd->PowerRegulatorMode;
+      RetStatus = RADIO_TASK_SubmitCmd(RadioIf->RadioTask, &Req);
    }
    else
    {
       CFE_EVS_SendEvent(RADIO_IF_SET_POWER_REGULATOR_MODE_CMD_EID, CFE_EVS_EventType_ERROR,
-                           "Set radio power regulator mode command failed, invalid mode %d.",
+                           "Radio %u: set radio power regulator mode command failed, invalid mode %d.", RadioIf->Inst->Index,
                            Cmd->PowerRegulatorMode);
    }
 
@@ -333,29 +511,23 @@ bool RADIO_IF_SetPowerRegulatorModeCmd(void *ObjDataPtr, const CFE_MSG_Message_t
 bool RADIO_IF_SetRadioFrequencyCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
    
+   RADIO_IF_Class_t *RadioIf = (RADIO_IF_Class_t *)ObjDataPtr;
    const LORA_SetRadioFrequency_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_SetRadioFrequency_t);
    bool RetStatus = false;
+   RADIO_TASK_Req_t Req;
 
    if (Cmd->Frequency >= 0 && Cmd->Frequency <= 48000)
    {
       RadioIf->RadioConfig.Frequency = Cmd->Frequency;
       
-      RetStatus = RADIO_SetRadioFrequency(Cmd->Frequency*1000000UL);
-      if (RetStatus)
-      {
-         CFE_EVS_SendEvent(RADIO_IF_SET_RADIO_FREQUENCY_CMD_EID, CFE_EVS_EventType_INFORMATION,
-                           "Set radio frequency command succeeded: Frequency = %d Mhz", Cmd->Frequency);
-      }
-      else
-      {
-         CFE_EVS_SendEvent(RADIO_IF_SET_RADIO_FREQUENCY_CMD_EID, CFE_EVS_EventType_ERROR,
-                           "Set radio frequency command failed");
-      }
+      InitCmdReq(RadioIf, &Req, RADIO_TASK_OP_SET_RADIO_FREQUENCY);
+      Req.Param.Frequency = Cmd->Frequency*1000000UL;
+      RetStatus = RADIO_TASK_SubmitCmd(RadioIf->RadioTask, &Req);
    }
    else
    {
       CFE_EVS_SendEvent(RADIO_IF_SET_RADIO_FREQUENCY_CMD_EID, CFE_EVS_EventType_ERROR,
-                           "Set radio frequency command failed, invalid frequency %d.",
+                           "Radio %u: set radio frequency command failed, invalid frequency %d.", RadioIf->Inst->Index,
                            Cmd->Frequency);
    }
 
@@ -373,29 +545,23 @@ bool RADIO_IF_SetRadioFrequencyCmd(void *ObjDataPtr, const CFE_MSG_Message_t *Ms
 bool RADIO_IF_SetStandbyModeCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
    
+   RADIO_IF_Class_t *RadioIf = (RADIO_IF_Class_t *)ObjDataPtr;
    const LORA_SetStandbyMode_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_SetStandbyMode_t);
    bool RetStatus = false;
+   RADIO_TASK_Req_t Req;
 
    if (Cmd->StandbyMode >= SX128X_StandbyMode_Enum_t_MIN && Cmd->StandbyMode <= SX128X_StandbyMode_Enum_t_MAX)
    {
       RadioIf->RadioConfig.StandbyMode = Cmd->StandbyMode;
       
-      RetStatus = RADIO_SetStandbyMode(Cmd->StandbyMode);
-      if (RetStatus)
-      {
-         CFE_EVS_SendEvent(RADIO_IF_SET_STANDBY_MODE_CMD_EID, CFE_EVS_EventType_INFORMATION,
-                           "Set radio standby mode succeeded: Mode = %d", Cmd->StandbyMode);
-      }
-      else
-      {
-         CFE_EVS_SendEvent(RADIO_IF_SET_STANDBY_MODE_CMD_EID, CFE_EVS_EventType_ERROR,
-                           "Set radio standby mode command failed");
-      }
+      InitCmdReq(RadioIf, &Req, RADIO_TASK_OP_SET_STANDBY_MODE);
+      Req.Param.Mode = Cmd->StandbyMode;
+      RetStatus = RADIO_TASK_SubmitCmd(RadioIf->RadioTask, &Req);
    }
    else
    {
       CFE_EVS_SendEvent(RADIO_IF_SET_STANDBY_MODE_CMD_EID, CFE_EVS_EventType_ERROR,
-                           "Set radio standby mode command failed, invalid mode %d.",
+                           "Radio %u: set radio standby mode command failed, invalid mode %d.", RadioIf->Inst->Index,
                            Cmd->StandbyMode);
    }
 
@@ -404,3 +570,161 @@ bool RADIO_IF_SetStandbyModeCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPt
 } /* RADIO_IF_SetStandbyModeCmd() */
 
 
+/******************************************************************************
+** Function: CmdCompletion
+**
+** Report the result of a radio command executed by the radio task
+**
+** Notes:
+**   1. Called by RADIO_TASK_ProcessCmdCompletions() in the main task.
+*/
+static void CmdCompletion(void *CplObj, const RADIO_TASK_Req_t *Req)
+{
+
+   const RADIO_IF_Class_t *RadioIf = (const RADIO_IF_Class_t *)CplObj;
+
+   switch (Req->Op)
+   {
+      case RADIO_TASK_OP_SET_LOW_NOISE_AMP_MODE:
+         if (Req->Status)
+         {
+            CFE_EVS_SendEvent(RADIO_IF_SET_LOW_NOISE_AMP_MODE_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                              "Radio %u: set radio power amp sensitivity mode succeeded: Mode = %d", RadioIf->Inst->Index, Req->Param.Mode);
+         }
+         else
+         {
+            CFE_EVS_SendEvent(RADIO_IF_SET_LOW_NOISE_AMP_MODE_CMD_EID, CFE_EVS_EventType_ERROR,
+                              "Radio %u: set radio power amp sensitivity mode command failed", RadioIf->Inst->Index);
+         }
+         break;
+
+      case RADIO_TASK_OP_SET_MODULATION_PARAMS:
+         if (Req->Status)
+         {
+            CFE_EVS_SendEvent(RADIO_IF_SET_MODULATION_PARAMS_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                              "Radio %u: set modulation parameters command succeeded: SF=%d, BW=%d, RC=%d", RadioIf->Inst->Index,
+                              Req->Param.Modulation.SpreadingFactor, Req->Param.Modulation.Bandwidth,
+                              Req->Param.Modulation.CodingRate);
+         }
+         else
+         {
+            CFE_EVS_SendEvent(RADIO_IF_SET_MODULATION_PARAMS_CMD_EID, CFE_EVS_EventType_ERROR,
+                              "Radio %u: set modulation parameters command failed", RadioIf->Inst->Index);
+         }
+         break;
+
+      case RADIO_TASK_OP_SET_POWER_AMP_RAMP_TIME:
+         if (Req->Status)
+         {
+            CFE_EVS_SendEvent(RADIO_IF_SET_POWER_AMP_RAMP_TIME_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                              "Radio %u: set radio power amp ramp time succeeded: Mode = %d", RadioIf->Inst->Index, Req->Param.Mode);
+         }
+         else
+         {
+            CFE_EVS_SendEvent(RADIO_IF_SET_POWER_AMP_RAMP_TIME_CMD_EID, CFE_EVS_EventType_ERROR,
+                              "Radio %u: set radio power amp ramp time command failed", RadioIf->Inst->Index);
+         }
+         break;
+
+      case RADIO_TASK_OP_SET_POWER_REGULATOR_MODE:
+         if (Req->Status)
+         {
+            CFE_EVS_SendEvent(RADIO_IF_SET_POWER_REGULATOR_MODE_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                              "Radio %u: set radio power regulator mode succeeded: Mode = %d", RadioIf->Inst->Index, Req->Param.Mode);
+         }
+         else
+         {
+            CFE_EVS_SendEvent(RADIO_IF_SET_POWER_REGULATOR_MODE_CMD_EID, CFE_EVS_EventType_ERROR,
+                              "Radio %u: set radio power regulator mode command failed", RadioIf->Inst->Index);
+         }
+         break;
+
+      case RADIO_TASK_OP_SET_RADIO_FREQUENCY:
+         if (Req->Status)
+         {
+            CFE_EVS_SendEvent(RADIO_IF_SET_RADIO_FREQUENCY_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                              "Radio %u: set radio frequency command succeeded: Frequency = %d Mhz", RadioIf->Inst->Index,
+                              (int)(Req->Param.Frequency/1000000UL));
+         }
+         else
+         {
+            CFE_EVS_SendEvent(RADIO_IF_SET_RADIO_FREQUENCY_CMD_EID, CFE_EVS_EventType_ERROR,
+                              "Radio %u: set radio frequency command failed", RadioIf->Inst->Index);
+         }
+         break;
+
+      case RADIO_TASK_OP_SET_STANDBY_MODE:
+         if (Req->Status)
+         {
+            CFE_EVS_SendEvent(RADIO_IF_SET_STANDBY_MODE_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                              "Radio %u: set radio standby mode succeeded: Mode = %d", RadioIf->Inst->Index, Req->Param.Mode);
+         }
+         else
+         {
+            CFE_EVS_SendEvent(RADIO_IF_SET_STANDBY_MODE_CMD_EID, CFE_EVS_EventType_ERROR,
+                              "Radio %u: set radio standby mode command failed", RadioIf->Inst->Index);
+         }
+         break;
+
+      default:
+         break;
+   }
+
+} /* End CmdCompletion() */
+
+
+/******************************************************************************
+** Function: InitCmdReq
+**
+*/
+static void InitCmdReq(RADIO_IF_Class_t *RadioIf, RADIO_TASK_Req_t *Req, RADIO_TASK_Op_t Op)
+{
+
+   memset(Req, 0, sizeof(RADIO_TASK_Req_t));
+
+   Req->Op      = Op;
+   Req->CplFunc = CmdCompletion;
+   Req->CplObj  = RadioIf;
+
+} /* End InitCmdReq() */
+
+
+/******************************************************************************
+** Function: ValidPacketParams
+**
+** Notes:
+**   1. An implicit header frame must at least hold a frame header. Whether
+**      the demo file's packets fit is checked when a transfer starts since
+**      their header length depends on the hopping and latency settings.
+*/
+static bool ValidPacketParams(const RADIO_IF_Class_t *RadioIf, const LORA_SetPacketParams_CmdPayload_t *Packet,
+                              uint16 EventId)
+{
+
+   bool RetStatus = false;
+
+   if (Packet->PreambleLen < RADIO_IF_MIN_PREAMBLE_LEN || Packet->PreambleLen > RADIO_IF_MAX_PREAMBLE_LEN)
+   {
+      CFE_EVS_SendEvent(EventId, CFE_EVS_EventType_ERROR,
+                        "Radio %u: invalid preamble length %d symbols, must be %d to %d",
+                        RadioIf->Inst->Index, Packet->PreambleLen, RADIO_IF_MIN_PREAMBLE_LEN, RADIO_IF_MAX_PREAMBLE_LEN);
+   }
+   else if (Packet->HeaderType != LORA_HeaderType_EXPLICIT && Packet->HeaderType != LORA_HeaderType_IMPLICIT)
+   {
+      CFE_EVS_SendEvent(EventId, CFE_EVS_EventType_ERROR,
+                        "Radio %u: invalid header type %d", RadioIf->Inst->Index, Packet->HeaderType);
+   }
+   else if (Packet->HeaderType == LORA_HeaderType_IMPLICIT && Packet->PayloadLen <= LORA_FRAME_MIN_HDR_LEN)
+   {
+      CFE_EVS_SendEvent(EventId, CFE_EVS_EventType_ERROR,
+                        "Radio %u: invalid implicit header payload length %d, must be greater than %d",
+                        RadioIf->Inst->Index, Packet->PayloadLen, LORA_FRAME_MIN_HDR_LEN);
+   }
+   else
+   {
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End ValidPacketParams() */
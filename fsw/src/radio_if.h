@@ -38,12 +38,18 @@
 */
 
 #include "app_cfg.h"
+#include "radio_inst.h"
+#include "radio_task.h"
+#include "radio_drv.h"
+#include "rx_duty.h"
 
 
 /***********************/
 /** Macro Definitions **/
 /***********************/
 
+#define RADIO_IF_MIN_PREAMBLE_LEN  RX_DUTY_DETECT_SYMBOLS  /* Receiver needs this many to detect a frame */
+#define RADIO_IF_MAX_PREAMBLE_LEN  64                      /* Duty cycled receive lengthens it further   */
 
 /*
 ** Event Message IDs
@@ -59,6 +65,7 @@
 #define RADIO_IF_SET_POWER_REGULATOR_MODE_CMD_EID (RADIO_IF_BASE_EID + 7)
 #define RADIO_IF_SET_RADIO_FREQUENCY_CMD_EID      (RADIO_IF_BASE_EID + 8)
 #define RADIO_IF_SET_STANDBY_MODE_CMD_EID         (RADIO_IF_BASE_EID + 9)
+#define RADIO_IF_SET_PACKET_PARAMS_CMD_EID        (RADIO_IF_BASE_EID + 10)
 
 /**********************/
 /** Type Definitions **/
@@ -75,6 +82,7 @@ typedef struct
    SX128X_PowerRegulatorMode_Enum_t       PowerRegulatorMode;
    SX128X_StandbyMode_Enum_t              StandbyMode;
    LORA_SetModulationParams_CmdPayload_t  Modulation;
+   LORA_SetPacketParams_CmdPayload_t      Packet;
 
 } RADIO_IF_Config;
 
@@ -91,6 +99,15 @@ typedef struct
    
    INITBL_Class_t *IniTbl;
 
+   /*
+   ** Object References
+   */
+
+   const RADIO_INST_Cfg_t *Inst;
+   RADIO_TASK_Class_t     *RadioTask;
+   RADIO_DRV_Class_t      *RadioDrv;
+   RX_DUTY_Class_t        *RxDuty;
+
    /*
    ** Telemetry Packets
    */
@@ -121,7 +138,9 @@ typedef struct
 **   1. This must be called prior to any other function.
 **
 */
-void RADIO_IF_Constructor(RADIO_IF_Class_t *RadioIfPtr, INITBL_Class_t *IniTbl);
+void RADIO_IF_Constructor(RADIO_IF_Class_t *RadioIf, INITBL_Class_t *IniTbl,
+                          const RADIO_INST_Cfg_t *Inst, RADIO_TASK_Class_t *RadioTask,
+                          RADIO_DRV_Class_t *RadioDrv, RX_DUTY_Class_t *RxDuty);
 
 
 /******************************************************************************
@@ -134,7 +153,81 @@ void RADIO_IF_Constructor(RADIO_IF_Class_t *RadioIfPtr, INITBL_Class_t *IniTbl);
 **      change the functional behavior should be reset.
 **
 */
-void RADIO_IF_ResetStatus(void);
+void RADIO_IF_ResetStatus(RADIO_IF_Class_t *RadioIf);
+
+
+/******************************************************************************
+** Function: RADIO_IF_InitRadio
+**
+** Load the radio with the current frequency and modulation configuration.
+**
+** Notes:
+**   1. Called by the demos before they start using the radio.
+**   2. Blocks until the radio task has executed the calls so it must not be
+**      called by the main task.
+**
+*/
+bool RADIO_IF_InitRadio(RADIO_IF_Class_t *RadioIf, RADIO_TASK_Client_t Client);
+
+
+/******************************************************************************
+** Function: RADIO_IF_TimeOnAir
+**
+** Return the time-on-air in microseconds of a frame with PayloadLen bytes
+** using the current modulation configuration.
+**
+** Notes:
+**   1. Used by the demos to size receive timeouts and hop slots.
+**   2. Frames have an explicit header unless a demo file transfer has
+**      switched to the configured implicit header, see
+**      RADIO_IF_ImplicitTimeOnAir().
+**
+*/
+uint32 RADIO_IF_TimeOnAir(const RADIO_IF_Class_t *RadioIf, uint8 PayloadLen);
+
+
+/******************************************************************************
+** Function: RADIO_IF_ImplicitTimeOnAir
+**
+** Return the time-on-air in microseconds of an implicit header frame with
+** PayloadLen bytes using the current modulation configuration.
+**
+*/
+uint32 RADIO_IF_ImplicitTimeOnAir(const RADIO_IF_Class_t *RadioIf, uint8 PayloadLen);
+
+
+/******************************************************************************
+** Function: RADIO_IF_PreambleLen
+**
+** Return the preamble length in symbols used with the current modulation
+**
+** Notes:
+**   1. Includes the preamble lengthening of a duty-cycled receiver.
+**
+*/
+uint16 RADIO_IF_PreambleLen(const RADIO_IF_Class_t *RadioIf);
+
+
+/******************************************************************************
+** Function: RADIO_IF_GetModulation
+**
+** Return the configured modulation parameters
+**
+*/
+const LORA_SetModulationParams_CmdPayload_t *RADIO_IF_GetModulation(const RADIO_IF_Class_t *RadioIf);
+
+
+/******************************************************************************
+** Function: RADIO_IF_GetPacketParams
+**
+** Return the configured packet parameters
+**
+** Notes:
+**   1. The header type and payload length are for the demo file data
+**      frames. Every other frame uses an explicit header.
+**
+*/
+const LORA_SetPacketParams_CmdPayload_t *RADIO_IF_GetPacketParams(const RADIO_IF_Class_t *RadioIf);
 
 
 /******************************************************************************
@@ -165,6 +258,23 @@ bool RADIO_IF_SetLowNoiseAmpModeCmd(void *ObjDataPtr, const CFE_MSG_Message_t *M
 bool RADIO_IF_SetModulationParamsCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
 
 
+/******************************************************************************
+** Function: RADIO_IF_SetPacketParamsCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**   2. The preamble depends on the receive duty cycle so like the duty cycle
+**      period the parameters are loaded into the radio when the next demo or
+**      link test initializes it. Both ends of a link must use the same
+**      preamble length.
+**   3. An implicit header is only used for the demo file's fixed packets.
+**      The transmitter sends PayloadLen in its file start frame and both
+**      ends switch to an implicit header for the data frames, so only the
+**      transmitter's setting matters. See lora_tx.c SendDemoFile().
+*/
+bool RADIO_IF_SetPacketParamsCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
 /******************************************************************************
 ** Function: RADIO_IF_SetPowerRegulatorModeCmd
 **
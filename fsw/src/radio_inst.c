@@ -0,0 +1,252 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the radio instance configuration functions
+**
+**  Notes:
+**    1. See radio_inst.h file prologue.
+**    2. RADIO_n_PINS is a comma separated list of GPIO numbers in
+**       RADIO_INST_Pin_t order with -1 for a pin that isn't connected.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "radio_inst.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static bool ParsePins(RADIO_INST_Cfg_t *Inst, const char *PinStr);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+/*
+** Init file parameters indexed by radio. Radio 0 receives commands on
+** the app's command topic so it doesn't have a topic parameter.
+*/
+
+static const uint16 CfgBackend[LORA_RADIO_MAX] =
+{
+   CFG_RADIO_0_BACKEND, CFG_RADIO_1_BACKEND, CFG_RADIO_2_BACKEND, CFG_RADIO_3_BACKEND
+};
+
+static const uint16 CfgSpiDev[LORA_RADIO_MAX] =
+{
+   CFG_RADIO_0_SPI_DEV, CFG_RADIO_1_SPI_DEV, CFG_RADIO_2_SPI_DEV, CFG_RADIO_3_SPI_DEV
+};
+
+static const uint16 CfgPins[LORA_RADIO_MAX] =
+{
+   CFG_RADIO_0_PINS, CFG_RADIO_1_PINS, CFG_RADIO_2_PINS, CFG_RADIO_3_PINS
+};
+
+static const uint16 CfgSimLocalPort[LORA_RADIO_MAX] =
+{
+   CFG_RADIO_0_SIM_LOCAL_PORT, CFG_RADIO_1_SIM_LOCAL_PORT, CFG_RADIO_2_SIM_LOCAL_PORT, CFG_RADIO_3_SIM_LOCAL_PORT
+};
+
+static const uint16 CfgSimPeerPort[LORA_RADIO_MAX] =
+{
+   CFG_RADIO_0_SIM_PEER_PORT, CFG_RADIO_1_SIM_PEER_PORT, CFG_RADIO_2_SIM_PEER_PORT, CFG_RADIO_3_SIM_PEER_PORT
+};
+
+static const uint16 CfgFreqOffset[LORA_RADIO_MAX] =
+{
+   CFG_RADIO_0_FREQ_OFFSET, CFG_RADIO_1_FREQ_OFFSET, CFG_RADIO_2_FREQ_OFFSET, CFG_RADIO_3_FREQ_OFFSET
+};
+
+static const uint16 CfgCmdTopicId[LORA_RADIO_MAX] =
+{
+   CFG_LORA_CMD_TOPICID, CFG_RADIO_1_CMD_TOPICID, CFG_RADIO_2_CMD_TOPICID, CFG_RADIO_3_CMD_TOPICID
+};
+
+
+/******************************************************************************
+** Function: RADIO_INST_GetRadioCnt
+**
+*/
+uint8 RADIO_INST_GetRadioCnt(INITBL_Class_t *IniTbl)
+{
+
+   uint32 RadioCnt = INITBL_GetIntConfig(IniTbl, CFG_RADIO_CNT);
+
+   if (RadioCnt < 1 || RadioCnt > LORA_RADIO_MAX)
+   {
+      CFE_EVS_SendEvent(RADIO_INST_LOAD_EID, CFE_EVS_EventType_ERROR,
+                        "Invalid radio count %u, must be 1 to %u",
+                        (unsigned int)RadioCnt, LORA_RADIO_MAX);
+      RadioCnt = 0;
+   }
+
+   return (uint8)RadioCnt;
+
+} /* End RADIO_INST_GetRadioCnt() */
+
+
+/******************************************************************************
+** Function: RADIO_INST_Load
+**
+** Notes:
+**   1. The caller checks that no more than one radio uses the SX128X backend
+**      because that depends on the other radios.
+**
+*/
+bool RADIO_INST_Load(RADIO_INST_Cfg_t *Inst, uint8 Index, INITBL_Class_t *IniTbl)
+{
+
+   const char *BackendStr;
+
+   memset(Inst, 0, sizeof(RADIO_INST_Cfg_t));
+
+   Inst->Index = Index;
+
+   BackendStr = INITBL_GetStrConfig(IniTbl, CfgBackend[Index]);
+   if (strcmp(BackendStr, RADIO_INST_BACKEND_SIM_STR) == 0)
+   {
+      Inst->Backend = LORA_RadioBackend_SIM;
+   }
+   else if (strcmp(BackendStr, RADIO_INST_BACKEND_SX128X_STR) == 0)
+   {
+      Inst->Backend = LORA_RadioBackend_SX128X;
+   }
+   else
+   {
+      CFE_EVS_SendEvent(RADIO_INST_LOAD_EID, CFE_EVS_EventType_ERROR,
+                        "Radio %u invalid backend %s, must be %s or %s", Index, BackendStr,
+                        RADIO_INST_BACKEND_SX128X_STR, RADIO_INST_BACKEND_SIM_STR);
+      return false;
+   }
+
+   strncpy(Inst->SpiDev, INITBL_GetStrConfig(IniTbl, CfgSpiDev[Index]), sizeof(Inst->SpiDev)-1);
+
+   if (!ParsePins(Inst, INITBL_GetStrConfig(IniTbl, CfgPins[Index])))
+   {
+      return false;
+   }
+
+   Inst->SimLocalPort = (uint16)INITBL_GetIntConfig(IniTbl, CfgSimLocalPort[Index]);
+   Inst->SimPeerPort  = (uint16)INITBL_GetIntConfig(IniTbl, CfgSimPeerPort[Index]);
+   Inst->FreqOffset   = (uint16)INITBL_GetIntConfig(IniTbl, CfgFreqOffset[Index]);
+   Inst->CmdTopicId   = INITBL_GetIntConfig(IniTbl, CfgCmdTopicId[Index]);
+
+   return true;
+
+} /* End RADIO_INST_Load() */
+
+
+/******************************************************************************
+** Function: RADIO_INST_Name
+**
+*/
+const char *RADIO_INST_Name(char *Name, size_t NameLen, const char *BaseName,
+                            const RADIO_INST_Cfg_t *Inst)
+{
+
+   if (Inst->Index == 0)
+   {
+      snprintf(Name, NameLen, "%s", BaseName);
+   }
+   else
+   {
+      snprintf(Name, NameLen, "%s%u", BaseName, Inst->Index);
+   }
+
+   return Name;
+
+} /* End RADIO_INST_Name() */
+
+
+/******************************************************************************
+** Function: RADIO_INST_Path
+**
+** Notes:
+**   1. A '.' in a directory name isn't an extension so only the last path
+**      component is searched.
+**
+*/
+const char *RADIO_INST_Path(char *Path, size_t PathLen, const char *BasePath,
+                            const RADIO_INST_Cfg_t *Inst)
+{
+
+   const char *Slash = strrchr(BasePath, '/');
+   const char *Ext   = strrchr(BasePath, '.');
+
+   if (Inst->Index == 0)
+   {
+      snprintf(Path, PathLen, "%s", BasePath);
+   }
+   else if (Ext == NULL || (Slash != NULL && Ext < Slash))
+   {
+      snprintf(Path, PathLen, "%s_%u", BasePath, Inst->Index);
+   }
+   else
+   {
+      snprintf(Path, PathLen, "%.*s_%u%s", (int)(Ext - BasePath), BasePath, Inst->Index, Ext);
+   }
+
+   return Path;
+
+} /* End RADIO_INST_Path() */
+
+
+/******************************************************************************
+** Function: ParsePins
+**
+*/
+static bool ParsePins(RADIO_INST_Cfg_t *Inst, const char *PinStr)
+{
+
+   const char *Str = PinStr;
+   char  *End;
+   long   Pin;
+   uint16 i;
+
+   for (i=0; i < RADIO_INST_PIN_CNT; i++)
+   {
+
+      Pin = strtol(Str, &End, 10);
+      if (End == Str || Pin < RADIO_INST_PIN_NC || Pin > INT16_MAX ||
+          *End != (i < (RADIO_INST_PIN_CNT-1) ? ',' : '\0'))
+      {
+         CFE_EVS_SendEvent(RADIO_INST_LOAD_EID, CFE_EVS_EventType_ERROR,
+                           "Radio %u invalid pin list %s, expected %u comma separated GPIO numbers",
+                           Inst->Index, PinStr, RADIO_INST_PIN_CNT);
+         return false;
+      }
+
+      Inst->Pin[i] = (int16)Pin;
+      Str = End + 1;
+
+   }
+
+   return true;
+
+} /* End ParsePins() */
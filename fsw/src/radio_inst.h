@@ -0,0 +1,147 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the radio instance configuration
+**
+**  Notes:
+**    1. The app serves RADIO_CNT radios. Each radio has its own set of
+**       objects and child tasks and this configuration identifies the
+**       hardware, or simulated radio, behind them. It's loaded from the
+**       RADIO_n_* JSON init file parameters.
+**    2. Radio 0 keeps the names and file paths from the init file so a
+**       single radio configuration is unchanged. The other radios append
+**       their index to OS object names and insert "_n" before the file
+**       extension of output files.
+**    3. The SX128X library drives a single device so only one radio can
+**       use the SX128X backend. Any number can use the SIM backend.
+**
+*/
+
+#ifndef _radio_inst_
+#define _radio_inst_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define RADIO_INST_BACKEND_SX128X_STR  "SX128X"
+#define RADIO_INST_BACKEND_SIM_STR     "SIM"
+
+#define RADIO_INST_PIN_NC  (-1)   /* Pin not connected */
+
+
+/*
+** Event Message IDs
+*/
+
+#define RADIO_INST_LOAD_EID  (RADIO_INST_BASE_EID + 0)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/*
+** Pins in the order used by the SX128x_Linux constructor
+*/
+typedef enum
+{
+
+   RADIO_INST_PIN_BUSY = 0,
+   RADIO_INST_PIN_NRST,
+   RADIO_INST_PIN_NSS,
+   RADIO_INST_PIN_DIO1,
+   RADIO_INST_PIN_DIO2,
+   RADIO_INST_PIN_DIO3,
+   RADIO_INST_PIN_TXEN,
+   RADIO_INST_PIN_RXEN,
+   RADIO_INST_PIN_CNT
+
+} RADIO_INST_Pin_t;
+
+
+typedef struct
+{
+
+   uint8   Index;
+   LORA_RadioBackend_Enum_t Backend;
+   char    SpiDev[OS_MAX_PATH_LEN];
+   int16   Pin[RADIO_INST_PIN_CNT];
+   uint16  SimLocalPort;
+   uint16  SimPeerPort;
+   uint16  FreqOffset;   /* Mhz added to RADIO_FREQUENCY */
+   uint32  CmdTopicId;   /* Radio 0 uses the app's command topic */
+
+} RADIO_INST_Cfg_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: RADIO_INST_GetRadioCnt
+**
+** Return the number of radios configured in the init file
+**
+** Notes:
+**   1. Returns 0 and sends an event if RADIO_CNT isn't 1 to LORA_RADIO_MAX.
+**
+*/
+uint8 RADIO_INST_GetRadioCnt(INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: RADIO_INST_Load
+**
+** Load radio Index's configuration from the init file
+**
+** Notes:
+**   1. Returns false and sends an event if a parameter is invalid.
+**
+*/
+bool RADIO_INST_Load(RADIO_INST_Cfg_t *Inst, uint8 Index, INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: RADIO_INST_Name
+**
+** Create a unique OS object name for the radio from a base name
+**
+*/
+const char *RADIO_INST_Name(char *Name, size_t NameLen, const char *BaseName,
+                            const RADIO_INST_Cfg_t *Inst);
+
+
+/******************************************************************************
+** Function: RADIO_INST_Path
+**
+** Create a unique file path for the radio from a base path
+**
+*/
+const char *RADIO_INST_Path(char *Path, size_t PathLen, const char *BasePath,
+                            const RADIO_INST_Cfg_t *Inst);
+
+
+#endif /* _radio_inst_ */
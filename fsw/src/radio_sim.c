@@ -0,0 +1,424 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the simulated SX128x radio
+**
+**  Notes:
+**    1. See radio_sim.h file prologue.
+**    2. Datagram format: 'L','S', frequency (4 bytes, big endian), spreading
+**       factor, bandwidth, coding rate, preamble length (2 bytes, big
+**       endian), followed by the payload.
+**    3. Each radio adds its index to SIM_SEED so radios in one app don't
+**       share a loss pattern.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "radio_sim.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/* Convenience macros */
+#define  INITBL_OBJ   (RadioSim->IniTbl)
+
+#define  SIM_LOOPBACK_ADDR  "127.0.0.1"
+#define  SIM_HDR_LEN        13
+#define  SIM_MAGIC_0        'L'
+#define  SIM_MAGIC_1        'S'
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static uint32 ElapsedMs(const OS_time_t *StartTime);
+
+
+/******************************************************************************
+** Function: RADIO_SIM_Constructor
+**
+** Initialize the simulated radio and open its socket
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void RADIO_SIM_Constructor(RADIO_SIM_Class_t *RadioSim, INITBL_Class_t *IniTbl,
+                           const RADIO_INST_Cfg_t *Inst)
+{
+
+   int32 SysStatus;
+   OS_SockAddr_t LocalAddr;
+   uint16 LocalPort;
+   uint16 PeerPort;
+   SIM_CHAN_Cfg_t ChannelCfg;
+
+   memset(RadioSim, 0, sizeof(RADIO_SIM_Class_t));
+
+   RadioSim->IniTbl = IniTbl;
+
+   RadioSim->PreambleLen = RADIO_SIM_PREAMBLE_LEN;
+
+   ChannelCfg.LossPpt       = INITBL_GetIntConfig(INITBL_OBJ, CFG_SIM_LOSS_PPT);
+   ChannelCfg.BurstEnterPpt = INITBL_GetIntConfig(INITBL_OBJ, CFG_SIM_BURST_ENTER_PPT);
+   ChannelCfg.BurstExitPpt  = INITBL_GetIntConfig(INITBL_OBJ, CFG_SIM_BURST_EXIT_PPT);
+   ChannelCfg.BurstLossPpt  = INITBL_GetIntConfig(INITBL_OBJ, CFG_SIM_BURST_LOSS_PPT);
+   ChannelCfg.SnrMeanDb     = (int32)INITBL_GetIntConfig(INITBL_OBJ, CFG_SIM_SNR_MEAN_DB);
+   ChannelCfg.SnrStdDevDb   = (int32)INITBL_GetIntConfig(INITBL_OBJ, CFG_SIM_SNR_STD_DEV_DB);
+
+   SIM_CHAN_Constructor(&RadioSim->Channel, &ChannelCfg,
+                        INITBL_GetIntConfig(INITBL_OBJ, CFG_SIM_SEED) + Inst->Index);
+
+   LocalPort = Inst->SimLocalPort;
+   PeerPort  = Inst->SimPeerPort;
+
+   OS_SocketAddrInit(&LocalAddr, OS_SocketDomain_INET);
+   OS_SocketAddrFromString(&LocalAddr, SIM_LOOPBACK_ADDR);
+   OS_SocketAddrSetPort(&LocalAddr, LocalPort);
+
+   OS_SocketAddrInit(&RadioSim->PeerAddr, OS_SocketDomain_INET);
+   OS_SocketAddrFromString(&RadioSim->PeerAddr, SIM_LOOPBACK_ADDR);
+   OS_SocketAddrSetPort(&RadioSim->PeerAddr, PeerPort);
+
+   SysStatus = OS_SocketOpen(&RadioSim->SocketId, OS_SocketDomain_INET, OS_SocketType_DATAGRAM);
+   if (SysStatus == OS_SUCCESS)
+   {
+      SysStatus = OS_SocketBind(RadioSim->SocketId, &LocalAddr);
+   }
+
+   if (SysStatus == OS_SUCCESS)
+   {
+      RadioSim->SocketOpen = true;
+      CFE_EVS_SendEvent(RADIO_SIM_CONSTRUCTOR_EID, CFE_EVS_EventType_INFORMATION,
+                        "Simulated radio %u using UDP port %d with peer port %d",
+                        Inst->Index, LocalPort, PeerPort);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(RADIO_SIM_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Simulated radio %u error opening UDP port %d, Status = %d",
+                        Inst->Index, LocalPort, SysStatus);
+   }
+
+} /* End RADIO_SIM_Constructor() */
+
+
+/******************************************************************************
+** Function: RADIO_SIM_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+*/
+void RADIO_SIM_ResetStatus(RADIO_SIM_Class_t *RadioSim)
+{
+
+   memset(&RadioSim->Stats, 0, sizeof(RADIO_SIM_Stats_t));
+   RadioSim->Channel.BurstCnt = 0;
+
+} /* End RADIO_SIM_ResetStatus() */
+
+
+/******************************************************************************
+** Functions: Simulated radio configuration calls
+**
+** Notes:
+**   1. Only the settings that determine whether two instances can hear each
+**      other are retained.
+*/
+
+bool RADIO_SIM_SetStandbyMode(RADIO_SIM_Class_t *RadioSim, SX128X_StandbyMode_Enum_t StandbyMode)
+{
+   return true;
+}
+
+bool RADIO_SIM_SetPowerRegulatorMode(RADIO_SIM_Class_t *RadioSim, SX128X_PowerRegulatorMode_Enum_t PowerRegulatorMode)
+{
+   return true;
+}
+
+bool RADIO_SIM_SetLowNoiseAmpMode(RADIO_SIM_Class_t *RadioSim, SX128X_LowNoiseAmpMode_Enum_t LowNoiseAmpMode)
+{
+   return true;
+}
+
+bool RADIO_SIM_SetPowerAmpRampTime(RADIO_SIM_Class_t *RadioSim, SX128X_PowerAmpRampTime_Enum_t PowerAmpRampTime)
+{
+   return true;
+}
+
+bool RADIO_SIM_SetModulationParams(RADIO_SIM_Class_t *RadioSim,
+                                   SX128X_ModulationSpreadingFactor_Enum_t SpreadingFactor,
+                                   SX128X_ModulationBandwidth_Enum_t       Bandwidth,
+                                   SX128X_ModulationCodingRate_Enum_t      CodingRate)
+{
+
+   if (LORA_TOA_TimeOnAir(SpreadingFactor, Bandwidth, CodingRate, RADIO_SIM_PREAMBLE_LEN, 1) == 0)
+   {
+      return false;
+   }
+
+   RadioSim->SpreadingFactor = SpreadingFactor;
+   RadioSim->Bandwidth       = Bandwidth;
+   RadioSim->CodingRate      = CodingRate;
+
+   return true;
+
+} /* End RADIO_SIM_SetModulationParams() */
+
+
+bool RADIO_SIM_SetRadioFrequency(RADIO_SIM_Class_t *RadioSim, uint32 Frequency)
+{
+
+   RadioSim->Frequency = Frequency;
+
+   return true;
+
+} /* End RADIO_SIM_SetRadioFrequency() */
+
+
+bool RADIO_SIM_SetPreambleLength(RADIO_SIM_Class_t *RadioSim, uint16 PreambleLen)
+{
+
+   if (PreambleLen == 0)
+   {
+      return false;
+   }
+
+   RadioSim->PreambleLen = PreambleLen;
+
+   return true;
+
+} /* End RADIO_SIM_SetPreambleLength() */
+
+
+bool RADIO_SIM_SetHeaderType(RADIO_SIM_Class_t *RadioSim, LORA_HeaderType_Enum_t HeaderType, uint8 PayloadLen)
+{
+
+   if (HeaderType == LORA_HeaderType_IMPLICIT)
+   {
+      if (PayloadLen == 0)
+      {
+         return false;
+      }
+      RadioSim->ImplicitHeader = true;
+      RadioSim->ImplicitLen    = PayloadLen;
+   }
+   else
+   {
+      RadioSim->ImplicitHeader = false;
+      RadioSim->ImplicitLen    = 0;
+   }
+
+   return true;
+
+} /* End RADIO_SIM_SetHeaderType() */
+
+
+bool RADIO_SIM_SetRxDutyCycle(RADIO_SIM_Class_t *RadioSim, uint32 RxPeriodUsec, uint32 SleepPeriodUsec)
+{
+
+   if (SleepPeriodUsec > 0 && RxPeriodUsec == 0)
+   {
+      return false;
+   }
+
+   RadioSim->RxPeriodUsec    = RxPeriodUsec;
+   RadioSim->SleepPeriodUsec = SleepPeriodUsec;
+
+   return true;
+
+} /* End RADIO_SIM_SetRxDutyCycle() */
+
+
+/******************************************************************************
+** Function: RADIO_SIM_SendPayload
+**
+** Notes:
+**   1. Blocks for the frame's time-on-air before sending the datagram so the
+**      return models the txDone IRQ.
+**   2. The SX1280 sends the configured number of bytes with an implicit
+**      header whatever the payload length, a different length is rejected
+**      so a sender that doesn't pad its frames is caught.
+*/
+bool RADIO_SIM_SendPayload(RADIO_SIM_Class_t *RadioSim, const uint8 *Payload, uint8 PayloadLen, uint32 TimeoutMs)
+{
+
+   uint8  Datagram[SIM_HDR_LEN + RADIO_SIM_MAX_PAYLOAD_LEN];
+   uint32 ToaUsec;
+   int32  SysStatus;
+
+   if (!RadioSim->SocketOpen)
+   {
+      return false;
+   }
+
+   if (RadioSim->ImplicitHeader && PayloadLen != RadioSim->ImplicitLen)
+   {
+      return false;
+   }
+
+   ToaUsec = LORA_TOA_FrameTimeOnAir(RadioSim->SpreadingFactor, RadioSim->Bandwidth, RadioSim->CodingRate,
+                                     RadioSim->PreambleLen, RadioSim->ImplicitHeader, PayloadLen);
+   if (ToaUsec == 0 || ToaUsec/1000 > TimeoutMs)
+   {
+      return false;
+   }
+
+   Datagram[0] = SIM_MAGIC_0;
+   Datagram[1] = SIM_MAGIC_1;
+   Datagram[2] = (uint8)(RadioSim->Frequency >> 24);
+   Datagram[3] = (uint8)(RadioSim->Frequency >> 16);
+   Datagram[4] = (uint8)(RadioSim->Frequency >> 8);
+   Datagram[5] = (uint8)(RadioSim->Frequency);
+   Datagram[6] = RadioSim->SpreadingFactor;
+   Datagram[7] = RadioSim->Bandwidth;
+   Datagram[8] = RadioSim->CodingRate;
+   Datagram[9]  = (uint8)(RadioSim->PreambleLen >> 8);
+   Datagram[10] = (uint8)(RadioSim->PreambleLen);
+   Datagram[11] = RadioSim->ImplicitHeader;
+   Datagram[12] = RadioSim->ImplicitLen;
+   memcpy(&Datagram[SIM_HDR_LEN], Payload, PayloadLen);
+
+   OS_TaskDelay((ToaUsec + 999)/1000);
+
+   SysStatus = OS_SocketSendTo(RadioSim->SocketId, Datagram, SIM_HDR_LEN + PayloadLen, &RadioSim->PeerAddr);
+
+   RadioSim->Stats.TxFrameCnt++;
+
+   /* The peer may not be running which is the same as nobody listening */
+   return (SysStatus >= 0);
+
+} /* End RADIO_SIM_SendPayload() */
+
+
+/******************************************************************************
+** Function: RADIO_SIM_ReceivePayload
+**
+** Notes:
+**   1. Waits up to TimeoutMs for a frame that is heard and survives the
+**      channel model. Frames that don't are discarded and the wait
+**      continues.
+**   2. When duty cycling, the receiver wakes at an arbitrary point in its
+**      sleep period so a frame is only certain to be detected if its
+**      preamble spans a full sleep period plus a receive window. Shorter
+**      preambles are counted as duty cycle misses.
+*/
+bool RADIO_SIM_ReceivePayload(RADIO_SIM_Class_t *RadioSim, uint8 *Payload, uint8 *PayloadLen,
+                              uint8 MaxLen, int8 *RssiPkt, int8 *SnrPkt, uint32 TimeoutMs)
+{
+
+   uint8  Datagram[SIM_HDR_LEN + RADIO_SIM_MAX_PAYLOAD_LEN];
+   OS_SockAddr_t FromAddr;
+   OS_time_t     StartTime;
+   int32  RecvLen;
+   uint32 Frequency;
+   uint32 WaitMs;
+   uint32 ElapsedTime;
+   uint32 PreambleUsec;
+   int8   Snr;
+
+   if (!RadioSim->SocketOpen)
+   {
+      return false;
+   }
+
+   OS_GetLocalTime(&StartTime);
+   WaitMs = TimeoutMs;
+
+   while (true)
+   {
+
+      RecvLen = OS_SocketRecvFrom(RadioSim->SocketId, Datagram, sizeof(Datagram), &FromAddr, WaitMs);
+
+      if (RecvLen < SIM_HDR_LEN)
+      {
+         break;  /* Timeout or socket error */
+      }
+
+      Frequency = ((uint32)Datagram[2] << 24) | ((uint32)Datagram[3] << 16) |
+                  ((uint32)Datagram[4] << 8)  |  (uint32)Datagram[5];
+
+      PreambleUsec = (uint32)(((uint64)(((uint16)Datagram[9] << 8) | Datagram[10]) *
+                     LORA_TOA_SymbolNsec(RadioSim->SpreadingFactor, RadioSim->Bandwidth))/1000);
+
+      if (Datagram[0] != SIM_MAGIC_0 || Datagram[1] != SIM_MAGIC_1 ||
+          Frequency   != RadioSim->Frequency       ||
+          Datagram[6] != RadioSim->SpreadingFactor ||
+          Datagram[7] != RadioSim->Bandwidth       ||
+          Datagram[8] != RadioSim->CodingRate      ||
+          Datagram[11] != RadioSim->ImplicitHeader ||
+          Datagram[12] != RadioSim->ImplicitLen)
+      {
+         RadioSim->Stats.IgnoredFrameCnt++;
+      }
+      else if (RadioSim->SleepPeriodUsec > 0 &&
+               PreambleUsec < (RadioSim->SleepPeriodUsec + RadioSim->RxPeriodUsec))
+      {
+         RadioSim->Stats.DutyMissCnt++;
+      }
+      else if (!SIM_CHAN_Delivers(&RadioSim->Channel, RadioSim->SpreadingFactor, &Snr))
+      {
+         RadioSim->Stats.LostFrameCnt++;
+      }
+      else if ((RecvLen - SIM_HDR_LEN) <= MaxLen)
+      {
+
+         *PayloadLen = RecvLen - SIM_HDR_LEN;
+         memcpy(Payload, &Datagram[SIM_HDR_LEN], *PayloadLen);
+
+         *SnrPkt  = Snr;
+         *RssiPkt = (int8)(Snr + RADIO_SIM_NOISE_FLOOR_DBM);
+
+         RadioSim->Stats.RxFrameCnt++;
+         RadioSim->Stats.LastSnr = Snr;
+
+         return true;
+      }
+
+      ElapsedTime = ElapsedMs(&StartTime);
+      if (ElapsedTime >= TimeoutMs)
+      {
+         break;
+      }
+      WaitMs = TimeoutMs - ElapsedTime;
+
+   } /* End receive loop */
+
+   return false;
+
+} /* End RADIO_SIM_ReceivePayload() */
+
+
+/******************************************************************************
+** Function: ElapsedMs
+**
+*/
+static uint32 ElapsedMs(const OS_time_t *StartTime)
+{
+
+   OS_time_t CurrentTime;
+
+   OS_GetLocalTime(&CurrentTime);
+
+   return (uint32)OS_TimeGetTotalMilliseconds(OS_TimeSubtract(CurrentTime, *StartTime));
+
+} /* End ElapsedMs() */
@@ -0,0 +1,173 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define a simulated SX128x radio
+**
+**  Notes:
+**    1. Provides the same calls as the SX128X library's RADIO_* API so
+**       radio_drv can use it in place of the SX1280 hardware. It's selected
+**       at init time with the RADIO_n_BACKEND JSON init file parameter.
+**    2. Frames are exchanged with a peer instance as UDP datagrams on the
+**       loopback interface, so two cFS targets on one Linux host can talk
+**       to each other. A frame is only heard if the peer is on the same
+**       frequency with the same modulation parameters.
+**    3. Send blocks for the LoRa time-on-air of the frame which models the
+**       txDone IRQ. The receiver's rxDone occurs when the datagram arrives.
+**       The frame's preamble length is sent with it so a duty-cycled
+**       receiver only hears frames whose preamble spans its sleep period.
+**       Its header mode and implicit length are sent too and a receiver
+**       configured differently can't decode the frame so doesn't hear it.
+**    4. Received frames pass through the channel model in sim_chan.h.
+**
+*/
+
+#ifndef _radio_sim_
+#define _radio_sim_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "radio_inst.h"
+#include "lora_toa.h"
+#include "sim_chan.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define RADIO_SIM_MAX_PAYLOAD_LEN  255
+#define RADIO_SIM_PREAMBLE_LEN      12   /* Symbols, same as lora_tx.cpp */
+#define RADIO_SIM_NOISE_FLOOR_DBM (-105) /* Reported RSSI is SNR + noise floor */
+
+
+/*
+** Event Message IDs
+*/
+
+#define RADIO_SIM_CONSTRUCTOR_EID  (RADIO_SIM_BASE_EID + 0)
+#define RADIO_SIM_SOCKET_EID       (RADIO_SIM_BASE_EID + 1)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+typedef struct
+{
+
+   uint32  TxFrameCnt;
+   uint32  RxFrameCnt;
+   uint32  LostFrameCnt;     /* Dropped by the channel model               */
+   uint32  IgnoredFrameCnt;  /* Different frequency or modulation settings */
+   uint32  DutyMissCnt;      /* Preamble shorter than the RX duty cycle    */
+   int8    LastSnr;
+
+} RADIO_SIM_Stats_t;
+
+
+/******************************************************************************
+** RADIO_SIM_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Framework References
+   */
+
+   INITBL_Class_t *IniTbl;
+
+   /*
+   ** Class State Data
+   */
+
+   osal_id_t     SocketId;
+   OS_SockAddr_t PeerAddr;
+   bool          SocketOpen;
+
+   uint32  Frequency;
+   uint8   SpreadingFactor;
+   uint8   Bandwidth;
+   uint8   CodingRate;
+   uint16  PreambleLen;
+   bool    ImplicitHeader;
+   uint8   ImplicitLen;       /* Bytes sent and received with an implicit header */
+   uint32  RxPeriodUsec;
+   uint32  SleepPeriodUsec;   /* 0 is continuous receive */
+
+   SIM_CHAN_Class_t  Channel;
+
+   RADIO_SIM_Stats_t  Stats;
+
+} RADIO_SIM_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: RADIO_SIM_Constructor
+**
+** Initialize the simulated radio and open its socket
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void RADIO_SIM_Constructor(RADIO_SIM_Class_t *RadioSim, INITBL_Class_t *IniTbl,
+                           const RADIO_INST_Cfg_t *Inst);
+
+
+/******************************************************************************
+** Function: RADIO_SIM_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+*/
+void RADIO_SIM_ResetStatus(RADIO_SIM_Class_t *RadioSim);
+
+
+/******************************************************************************
+** Functions: Simulated SX128X library calls
+**
+** Each function has the same parameters following the object pointer and the
+** same return value as the SX128X library function with the same name suffix.
+**
+*/
+bool RADIO_SIM_SetStandbyMode(RADIO_SIM_Class_t *RadioSim, SX128X_StandbyMode_Enum_t StandbyMode);
+bool RADIO_SIM_SetPowerRegulatorMode(RADIO_SIM_Class_t *RadioSim, SX128X_PowerRegulatorMode_Enum_t PowerRegulatorMode);
+bool RADIO_SIM_SetLowNoiseAmpMode(RADIO_SIM_Class_t *RadioSim, SX128X_LowNoiseAmpMode_Enum_t LowNoiseAmpMode);
+bool RADIO_SIM_SetPowerAmpRampTime(RADIO_SIM_Class_t *RadioSim, SX128X_PowerAmpRampTime_Enum_t PowerAmpRampTime);
+bool RADIO_SIM_SetModulationParams(RADIO_SIM_Class_t *RadioSim,
+                                   SX128X_ModulationSpreadingFactor_Enum_t SpreadingFactor,
+                                   SX128X_ModulationBandwidth_Enum_t       Bandwidth,
+                                   SX128X_ModulationCodingRate_Enum_t      CodingRate);
+bool RADIO_SIM_SetRadioFrequency(RADIO_SIM_Class_t *RadioSim, uint32 Frequency);
+bool RADIO_SIM_SetPreambleLength(RADIO_SIM_Class_t *RadioSim, uint16 PreambleLen);
+bool RADIO_SIM_SetHeaderType(RADIO_SIM_Class_t *RadioSim, LORA_HeaderType_Enum_t HeaderType, uint8 PayloadLen);
+bool RADIO_SIM_SetRxDutyCycle(RADIO_SIM_Class_t *RadioSim, uint32 RxPeriodUsec, uint32 SleepPeriodUsec);
+bool RADIO_SIM_SendPayload(RADIO_SIM_Class_t *RadioSim, const uint8 *Payload, uint8 PayloadLen, uint32 TimeoutMs);
+bool RADIO_SIM_ReceivePayload(RADIO_SIM_Class_t *RadioSim, uint8 *Payload, uint8 *PayloadLen,
+                              uint8 MaxLen, int8 *RssiPkt, int8 *SnrPkt, uint32 TimeoutMs);
+
+
+#endif /* _radio_sim_ */
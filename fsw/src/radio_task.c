@@ -0,0 +1,801 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the Radio Task Class methods
+**
+**  Notes:
+**    1. See radio_task.h file prologue.
+**    2. The queue head and tail are free running counters. The release
+**       store of one index after copying an entry pairs with the acquire
+**       load of that index by the other side so the entry contents are
+**       visible before the index update.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "frame_trace.h"
+#include "lora_frame.h"
+#include "lora_metrics.h"
+#include "radio_drv.h"
+#include "radio_task.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static bool Call(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client, RADIO_TASK_Req_t *Req);
+static void ExecuteReq(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_ClientState_t *ClientState,
+                       RADIO_TASK_Req_t *Req);
+static bool QueueGet(RADIO_TASK_Queue_t *Queue, RADIO_TASK_Req_t *Req);
+static bool QueuePut(RADIO_TASK_Queue_t *Queue, const RADIO_TASK_Req_t *Req);
+static bool PeekOp(RADIO_TASK_Queue_t *Queue, RADIO_TASK_Op_t *Op);
+static bool ServeClient(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client);
+static void ServeOtherClients(RADIO_TASK_Class_t *RadioTask, const RADIO_TASK_ClientState_t *RxClientState);
+static bool Submit(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client, RADIO_TASK_Req_t *Req);
+static uint32 TimeOnAir(const RADIO_TASK_Class_t *RadioTask, uint8 PayloadLen);
+static void TracePayload(const RADIO_TASK_Class_t *RadioTask, const RADIO_TASK_Req_t *Req,
+                         const OS_time_t *StartTime, FRAME_TRACE_Stage_t WaitStage,
+                         FRAME_TRACE_Stage_t ExecStage);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static const char *CplSemName[RADIO_TASK_CLIENT_CNT] =
+{
+   "LORA_RDO_CPL_CMD",
+   "LORA_RDO_CPL_TX",
+   "LORA_RDO_CPL_RX"
+};
+
+
+/******************************************************************************
+** Function: RADIO_TASK_Constructor
+**
+** Initialize the Radio Task object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void RADIO_TASK_Constructor(RADIO_TASK_Class_t *RadioTask, INITBL_Class_t *IniTbl,
+                            const RADIO_INST_Cfg_t *Inst, RADIO_DRV_Class_t *RadioDrv)
+{
+
+   int32  SysStatus;
+   uint16 Client;
+   char   SemName[OS_MAX_API_NAME];
+
+   memset(RadioTask, 0, sizeof(RADIO_TASK_Class_t));
+
+   RadioTask->RadioDrv = RadioDrv;
+   RadioTask->Radio    = Inst->Index;
+
+   RadioTask->PreambleLen = LORA_DEFAULT_PREAMBLE_LEN;
+
+   RADIO_INST_Name(SemName, sizeof(SemName), INITBL_GetStrConfig(IniTbl, CFG_RADIO_CHILD_SEM_NAME), Inst);
+
+   SysStatus = OS_CountSemCreate(&RadioTask->WakeUpSemaphore, SemName, 0, 0);
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(RADIO_TASK_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Radio child error creating semaphore %s, Status = %d", SemName, SysStatus);
+   }
+
+   for (Client=0; Client < RADIO_TASK_CLIENT_CNT; Client++)
+   {
+      atomic_init(&RadioTask->Client[Client].ReqQueue.Head, 0);
+      atomic_init(&RadioTask->Client[Client].ReqQueue.Tail, 0);
+      atomic_init(&RadioTask->Client[Client].CplQueue.Head, 0);
+      atomic_init(&RadioTask->Client[Client].CplQueue.Tail, 0);
+      atomic_init(&RadioTask->Client[Client].ReqCnt, 0);
+      atomic_init(&RadioTask->Client[Client].RejectCnt, 0);
+
+      RADIO_INST_Name(SemName, sizeof(SemName), CplSemName[Client], Inst);
+      SysStatus = OS_CountSemCreate(&RadioTask->Client[Client].CplSemaphore, SemName, 0, 0);
+      if (SysStatus != OS_SUCCESS)
+      {
+         CFE_EVS_SendEvent(RADIO_TASK_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                           "Radio child error creating semaphore %s, Status = %d", SemName, SysStatus);
+      }
+   }
+
+} /* End RADIO_TASK_Constructor() */
+
+
+/******************************************************************************
+** Function: RADIO_TASK_ChildTask
+**
+** Notes:
+**   1. Returning false causes the child task to terminate.
+**   2. One semaphore count is given per request but each wakeup serves every
+**      client until all of the request queues are empty, so some wakeups
+**      find nothing to do.
+**   3. Clients are served round robin one request at a time so the main
+**      task's commands are interleaved with the Tx and Rx requests.
+*/
+bool RADIO_TASK_ChildTask(RADIO_TASK_Class_t *RadioTask)
+{
+
+   bool   ReqServed;
+   uint16 Client;
+
+   RadioTask->RunStatus = CFE_SUCCESS;
+
+   while (RadioTask->RunStatus == CFE_SUCCESS)
+   {
+
+      RadioTask->RunStatus = OS_CountSemTake(RadioTask->WakeUpSemaphore);
+
+      do
+      {
+         ReqServed = false;
+         for (Client=0; Client < RADIO_TASK_CLIENT_CNT; Client++)
+         {
+            ReqServed |= ServeClient(RadioTask, Client);
+         }
+      } while (ReqServed);
+
+   }
+
+   CFE_EVS_SendEvent(RADIO_TASK_CHILD_TASK_EID, CFE_EVS_EventType_ERROR,
+                     "Radio %u child task terminating, semaphore status = %d",
+                     RadioTask->Radio, RadioTask->RunStatus);
+
+   return true;
+
+} /* End RADIO_TASK_ChildTask() */
+
+
+/******************************************************************************
+** Function: RADIO_TASK_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+** Notes:
+**   1. Must only be called by the main task.
+**
+*/
+void RADIO_TASK_ResetStatus(RADIO_TASK_Class_t *RadioTask)
+{
+
+   RADIO_TASK_Req_t Req = { .Op = RADIO_TASK_OP_RESET_STATUS };
+   uint16 Client;
+
+   for (Client=0; Client < RADIO_TASK_CLIENT_CNT; Client++)
+   {
+      atomic_store_explicit(&RadioTask->Client[Client].ReqCnt, 0, memory_order_relaxed);
+      atomic_store_explicit(&RadioTask->Client[Client].RejectCnt, 0, memory_order_relaxed);
+   }
+
+   RADIO_TASK_SubmitCmd(RadioTask, &Req);
+
+} /* End RADIO_TASK_ResetStatus() */
+
+
+/******************************************************************************
+** Function: RADIO_TASK_CheckFrameSupport
+**
+** Return true if the radio's driver backend can send and receive frames.
+**
+*/
+bool RADIO_TASK_CheckFrameSupport(const RADIO_TASK_Class_t *RadioTask, const char *Activity)
+{
+
+   if (RADIO_DRV_Supports(RadioTask->RadioDrv, RADIO_DRV_CALL_SEND_PAYLOAD) &&
+       RADIO_DRV_Supports(RadioTask->RadioDrv, RADIO_DRV_CALL_RECEIVE_PAYLOAD))
+   {
+      return true;
+   }
+
+   CFE_EVS_SendEvent(RADIO_TASK_SUPPORT_EID, CFE_EVS_EventType_ERROR,
+                     "%s rejected, radio %u driver backend can't send or receive frames",
+                     Activity, RadioTask->Radio);
+
+   return false;
+
+} /* End RADIO_TASK_CheckFrameSupport() */
+
+
+/******************************************************************************
+** Function: RADIO_TASK_SubmitCmd
+**
+** Queue a request from the main task without waiting.
+**
+*/
+bool RADIO_TASK_SubmitCmd(RADIO_TASK_Class_t *RadioTask, const RADIO_TASK_Req_t *Req)
+{
+
+   RADIO_TASK_Req_t CmdReq = *Req;
+
+   if (!Submit(RadioTask, RADIO_TASK_CLIENT_CMD, &CmdReq))
+   {
+      CFE_EVS_SendEvent(RADIO_TASK_SUBMIT_EID, CFE_EVS_EventType_ERROR,
+                        "Radio %u command rejected, %d commands are already queued",
+                        RadioTask->Radio, RADIO_TASK_QUEUE_LEN);
+      return false;
+   }
+
+   return true;
+
+} /* End RADIO_TASK_SubmitCmd() */
+
+
+/******************************************************************************
+** Function: RADIO_TASK_ProcessCmdCompletions
+**
+** Call the completion functions of all completed main task requests.
+**
+*/
+void RADIO_TASK_ProcessCmdCompletions(RADIO_TASK_Class_t *RadioTask)
+{
+
+   RADIO_TASK_Req_t Req;
+
+   while (QueueGet(&RadioTask->Client[RADIO_TASK_CLIENT_CMD].CplQueue, &Req))
+   {
+      if (Req.CplFunc != NULL)
+      {
+         Req.CplFunc(Req.CplObj, &Req);
+      }
+   }
+
+} /* End RADIO_TASK_ProcessCmdCompletions() */
+
+
+/******************************************************************************
+** Functions: Blocking radio calls
+**
+*/
+bool RADIO_TASK_SetStandbyMode(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                               SX128X_StandbyMode_Enum_t StandbyMode)
+{
+
+   RADIO_TASK_Req_t Req = { .Op = RADIO_TASK_OP_SET_STANDBY_MODE, .Param.Mode = StandbyMode };
+
+   return Call(RadioTask, Client, &Req);
+
+} /* End RADIO_TASK_SetStandbyMode() */
+
+
+bool RADIO_TASK_SetPowerRegulatorMode(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                                      SX128X_PowerRegulatorMode_Enum_t PowerRegulatorMode)
+{
+
+   RADIO_TASK_Req_t Req = { .Op = RADIO_TASK_OP_SET_POWER_REGULATOR_MODE, .Param.Mode = PowerRegulatorMode };
+
+   return Call(RadioTask, Client, &Req);
+
+} /* End RADIO_TASK_SetPowerRegulatorMode() */
+
+
+bool RADIO_TASK_SetLowNoiseAmpMode(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                                   SX128X_LowNoiseAmpMode_Enum_t LowNoiseAmpMode)
+{
+
+   RADIO_TASK_Req_t Req = { .Op = RADIO_TASK_OP_SET_LOW_NOISE_AMP_MODE, .Param.Mode = LowNoiseAmpMode };
+
+   return Call(RadioTask, Client, &Req);
+
+} /* End RADIO_TASK_SetLowNoiseAmpMode() */
+
+
+bool RADIO_TASK_SetPowerAmpRampTime(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                                    SX128X_PowerAmpRampTime_Enum_t PowerAmpRampTime)
+{
+
+   RADIO_TASK_Req_t Req = { .Op = RADIO_TASK_OP_SET_POWER_AMP_RAMP_TIME, .Param.Mode = PowerAmpRampTime };
+
+   return Call(RadioTask, Client, &Req);
+
+} /* End RADIO_TASK_SetPowerAmpRampTime() */
+
+
+bool RADIO_TASK_SetModulationParams(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                                    SX128X_ModulationSpreadingFactor_Enum_t SpreadingFactor,
+                                    SX128X_ModulationBandwidth_Enum_t       Bandwidth,
+                                    SX128X_ModulationCodingRate_Enum_t      CodingRate)
+{
+
+   RADIO_TASK_Req_t Req = { .Op = RADIO_TASK_OP_SET_MODULATION_PARAMS };
+
+   Req.Param.Modulation.SpreadingFactor = SpreadingFactor;
+   Req.Param.Modulation.Bandwidth       = Bandwidth;
+   Req.Param.Modulation.CodingRate      = CodingRate;
+
+   return Call(RadioTask, Client, &Req);
+
+} /* End RADIO_TASK_SetModulationParams() */
+
+
+bool RADIO_TASK_SetRadioFrequency(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                                  uint32 Frequency)
+{
+
+   RADIO_TASK_Req_t Req = { .Op = RADIO_TASK_OP_SET_RADIO_FREQUENCY, .Param.Frequency = Frequency };
+
+   return Call(RadioTask, Client, &Req);
+
+} /* End RADIO_TASK_SetRadioFrequency() */
+
+
+bool RADIO_TASK_SetPreambleLength(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                                  uint16 PreambleLen)
+{
+
+   RADIO_TASK_Req_t Req = { .Op = RADIO_TASK_OP_SET_PREAMBLE_LENGTH, .Param.PreambleLen = PreambleLen };
+
+   return Call(RadioTask, Client, &Req);
+
+} /* End RADIO_TASK_SetPreambleLength() */
+
+
+bool RADIO_TASK_SetHeaderType(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                              LORA_HeaderType_Enum_t HeaderType, uint8 PayloadLen)
+{
+
+   RADIO_TASK_Req_t Req = { .Op = RADIO_TASK_OP_SET_HEADER_TYPE };
+
+   Req.Param.Header.HeaderType = HeaderType;
+   Req.Param.Header.PayloadLen = PayloadLen;
+
+   return Call(RadioTask, Client, &Req);
+
+} /* End RADIO_TASK_SetHeaderType() */
+
+
+bool RADIO_TASK_SetRxDutyCycle(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                               uint32 RxPeriodUsec, uint32 SleepPeriodUsec)
+{
+
+   RADIO_TASK_Req_t Req = { .Op = RADIO_TASK_OP_SET_RX_DUTY_CYCLE };
+
+   Req.Param.DutyCycle.RxPeriodUsec    = RxPeriodUsec;
+   Req.Param.DutyCycle.SleepPeriodUsec = SleepPeriodUsec;
+
+   return Call(RadioTask, Client, &Req);
+
+} /* End RADIO_TASK_SetRxDutyCycle() */
+
+
+bool RADIO_TASK_SendPayload(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                            const uint8 *Payload, uint8 PayloadLen, uint32 TimeoutMs)
+{
+
+   RADIO_TASK_Req_t Req = { .Op = RADIO_TASK_OP_SEND_PAYLOAD, .TimeoutMs = TimeoutMs };
+
+   Req.Param.Payload.Len = PayloadLen;
+   memcpy(Req.Param.Payload.Data, Payload, PayloadLen);
+
+   return Call(RadioTask, Client, &Req);
+
+} /* End RADIO_TASK_SendPayload() */
+
+
+bool RADIO_TASK_ReceivePayload(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                               uint8 *Payload, uint8 *PayloadLen, uint8 MaxLen,
+                               int8 *RssiPkt, int8 *SnrPkt, uint32 TimeoutMs)
+{
+
+   bool RetStatus;
+   RADIO_TASK_Req_t Req = { .Op = RADIO_TASK_OP_RECEIVE_PAYLOAD, .TimeoutMs = TimeoutMs };
+
+   Req.Param.Payload.MaxLen = MaxLen;
+
+   RetStatus = Call(RadioTask, Client, &Req);
+   if (RetStatus)
+   {
+      memcpy(Payload, Req.Param.Payload.Data, Req.Param.Payload.Len);
+      *PayloadLen = Req.Param.Payload.Len;
+      *RssiPkt    = Req.Param.Payload.Rssi;
+      *SnrPkt     = Req.Param.Payload.Snr;
+   }
+
+   return RetStatus;
+
+} /* End RADIO_TASK_ReceivePayload() */
+
+
+/******************************************************************************
+** Function: Call
+**
+** Submit a request and wait for its completion.
+**
+** Notes:
+**   1. A client has at most one request outstanding so the queues can't be
+**      full and the completion is always this request.
+*/
+static bool Call(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client, RADIO_TASK_Req_t *Req)
+{
+
+   RADIO_TASK_ClientState_t *ClientState = &RadioTask->Client[Client];
+
+   if (!Submit(RadioTask, Client, Req))
+   {
+      return false;
+   }
+
+   OS_CountSemTake(ClientState->CplSemaphore);
+
+   return (QueueGet(&ClientState->CplQueue, Req) && Req->Status);
+
+} /* End Call() */
+
+
+/******************************************************************************
+** Function: ExecuteReq
+**
+** Notes:
+**   1. Must only be called by the radio task.
+**   2. Receives are split into slices and the other clients' queued
+**      requests are executed between slices.
+*/
+static void ExecuteReq(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_ClientState_t *ClientState,
+                       RADIO_TASK_Req_t *Req)
+{
+
+   uint32    WaitUsec;
+   uint32    RemainingMs;
+   uint32    SliceMs;
+   uint16    Client;
+   OS_time_t StartTime;
+
+   OS_GetLocalTime(&StartTime);
+   WaitUsec = OS_TimeGetTotalMicroseconds(OS_TimeSubtract(StartTime, Req->SubmitTime));
+   if (WaitUsec > ClientState->MaxWaitUsec)
+   {
+      ClientState->MaxWaitUsec = WaitUsec;
+   }
+
+   switch (Req->Op)
+   {
+      case RADIO_TASK_OP_SET_STANDBY_MODE:
+         Req->Status = RADIO_DRV_SetStandbyMode(RadioTask->RadioDrv, Req->Param.Mode);
+         break;
+      case RADIO_TASK_OP_SET_POWER_REGULATOR_MODE:
+         Req->Status = RADIO_DRV_SetPowerRegulatorMode(RadioTask->RadioDrv, Req->Param.Mode);
+         break;
+      case RADIO_TASK_OP_SET_LOW_NOISE_AMP_MODE:
+         Req->Status = RADIO_DRV_SetLowNoiseAmpMode(RadioTask->RadioDrv, Req->Param.Mode);
+         break;
+      case RADIO_TASK_OP_SET_POWER_AMP_RAMP_TIME:
+         Req->Status = RADIO_DRV_SetPowerAmpRampTime(RadioTask->RadioDrv, Req->Param.Mode);
+         break;
+      case RADIO_TASK_OP_SET_MODULATION_PARAMS:
+         Req->Status = RADIO_DRV_SetModulationParams(RadioTask->RadioDrv,
+                                                     Req->Param.Modulation.SpreadingFactor,
+                                                     Req->Param.Modulation.Bandwidth,
+                                                     Req->Param.Modulation.CodingRate);
+         if (Req->Status)
+         {
+            RadioTask->SpreadingFactor = Req->Param.Modulation.SpreadingFactor;
+            RadioTask->Bandwidth       = Req->Param.Modulation.Bandwidth;
+            RadioTask->CodingRate      = Req->Param.Modulation.CodingRate;
+         }
+         break;
+      case RADIO_TASK_OP_SET_RADIO_FREQUENCY:
+         Req->Status = RADIO_DRV_SetRadioFrequency(RadioTask->RadioDrv, Req->Param.Frequency);
+         break;
+      case RADIO_TASK_OP_SET_PREAMBLE_LENGTH:
+         Req->Status = RADIO_DRV_SetPreambleLength(RadioTask->RadioDrv, Req->Param.PreambleLen);
+         if (Req->Status)
+         {
+            RadioTask->PreambleLen = Req->Param.PreambleLen;
+         }
+         break;
+      case RADIO_TASK_OP_SET_HEADER_TYPE:
+         Req->Status = RADIO_DRV_SetHeaderType(RadioTask->RadioDrv, Req->Param.Header.HeaderType,
+                                               Req->Param.Header.PayloadLen);
+         if (Req->Status)
+         {
+            RadioTask->ImplicitHeader = (Req->Param.Header.HeaderType == LORA_HeaderType_IMPLICIT);
+         }
+         break;
+      case RADIO_TASK_OP_SET_RX_DUTY_CYCLE:
+         Req->Status = RADIO_DRV_SetRxDutyCycle(RadioTask->RadioDrv,
+                                                Req->Param.DutyCycle.RxPeriodUsec,
+                                                Req->Param.DutyCycle.SleepPeriodUsec);
+         break;
+      case RADIO_TASK_OP_SEND_PAYLOAD:
+         Req->Status = RADIO_DRV_SendPayload(RadioTask->RadioDrv, Req->Param.Payload.Data,
+                                             Req->Param.Payload.Len, Req->TimeoutMs);
+         if (Req->Status)
+         {
+            LORA_METRICS_Add(RadioTask->Radio, LORA_METRICS_TASK_RADIO, LORA_METRICS_TX_AIR_USEC,
+                             TimeOnAir(RadioTask, Req->Param.Payload.Len));
+            TracePayload(RadioTask, Req, &StartTime, FRAME_TRACE_TX_RADIO_WAIT, FRAME_TRACE_TX_SEND);
+         }
+         break;
+      case RADIO_TASK_OP_RECEIVE_PAYLOAD:
+         RemainingMs = Req->TimeoutMs;
+         do
+         {
+            SliceMs = (RemainingMs < RADIO_TASK_RX_SLICE_MS) ? RemainingMs : RADIO_TASK_RX_SLICE_MS;
+            Req->Status = RADIO_DRV_ReceivePayload(RadioTask->RadioDrv, Req->Param.Payload.Data,
+                                                   &Req->Param.Payload.Len, Req->Param.Payload.MaxLen,
+                                                   &Req->Param.Payload.Rssi, &Req->Param.Payload.Snr,
+                                                   SliceMs);
+            RemainingMs -= SliceMs;
+            if (!Req->Status)
+            {
+               ServeOtherClients(RadioTask, ClientState);
+            }
+         } while (!Req->Status && RemainingMs > 0);
+         if (Req->Status)
+         {
+            LORA_METRICS_Add(RadioTask->Radio, LORA_METRICS_TASK_RADIO, LORA_METRICS_RX_AIR_USEC,
+                             TimeOnAir(RadioTask, Req->Param.Payload.Len));
+            TracePayload(RadioTask, Req, &StartTime, FRAME_TRACE_RX_RADIO_WAIT, FRAME_TRACE_RX_RECEIVE);
+         }
+         break;
+      case RADIO_TASK_OP_RESET_STATUS:
+         RADIO_DRV_ResetStatus(RadioTask->RadioDrv);
+         for (Client=0; Client < RADIO_TASK_CLIENT_CNT; Client++)
+         {
+            RadioTask->Client[Client].MaxWaitUsec = 0;
+         }
+         Req->Status = true;
+         break;
+      default:
+         Req->Status = false;
+         break;
+   }
+
+} /* End ExecuteReq() */
+
+
+/******************************************************************************
+** Function: PeekOp
+**
+** Notes:
+**   1. Returns false if the queue is empty.
+**   2. Must only be called by the consumer. The producer doesn't overwrite
+**      the entry at the tail until the consumer has advanced the tail.
+*/
+static bool PeekOp(RADIO_TASK_Queue_t *Queue, RADIO_TASK_Op_t *Op)
+{
+
+   unsigned int Tail = atomic_load_explicit(&Queue->Tail, memory_order_relaxed);
+   unsigned int Head = atomic_load_explicit(&Queue->Head, memory_order_acquire);
+
+   if (Head == Tail)
+   {
+      return false;
+   }
+
+   *Op = Queue->Entry[Tail & (RADIO_TASK_QUEUE_LEN-1)].Op;
+
+   return true;
+
+} /* End PeekOp() */
+
+
+/******************************************************************************
+** Function: QueueGet
+**
+** Notes:
+**   1. Returns false if the queue is empty.
+*/
+static bool QueueGet(RADIO_TASK_Queue_t *Queue, RADIO_TASK_Req_t *Req)
+{
+
+   unsigned int Tail = atomic_load_explicit(&Queue->Tail, memory_order_relaxed);
+   unsigned int Head = atomic_load_explicit(&Queue->Head, memory_order_acquire);
+
+   if (Head == Tail)
+   {
+      return false;
+   }
+
+   *Req = Queue->Entry[Tail & (RADIO_TASK_QUEUE_LEN-1)];
+   atomic_store_explicit(&Queue->Tail, Tail+1, memory_order_release);
+
+   return true;
+
+} /* End QueueGet() */
+
+
+/******************************************************************************
+** Function: QueuePut
+**
+** Notes:
+**   1. Returns false if the queue is full.
+*/
+static bool QueuePut(RADIO_TASK_Queue_t *Queue, const RADIO_TASK_Req_t *Req)
+{
+
+   unsigned int Head = atomic_load_explicit(&Queue->Head, memory_order_relaxed);
+   unsigned int Tail = atomic_load_explicit(&Queue->Tail, memory_order_acquire);
+
+   if ((Head - Tail) == RADIO_TASK_QUEUE_LEN)
+   {
+      return false;
+   }
+
+   Queue->Entry[Head & (RADIO_TASK_QUEUE_LEN-1)] = *Req;
+   atomic_store_explicit(&Queue->Head, Head+1, memory_order_release);
+
+   return true;
+
+} /* End QueuePut() */
+
+
+/******************************************************************************
+** Function: ServeClient
+**
+** Execute one queued request and return it as a completion.
+**
+** Notes:
+**   1. Returns false if the client's request queue is empty.
+**   2. The completion queue can't be full because Submit() limits the
+**      requests a client has outstanding, including completions it hasn't
+**      collected, to the queue length.
+*/
+static bool ServeClient(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client)
+{
+
+   RADIO_TASK_ClientState_t *ClientState = &RadioTask->Client[Client];
+   RADIO_TASK_Req_t Req;
+
+   if (!QueueGet(&ClientState->ReqQueue, &Req))
+   {
+      return false;
+   }
+
+   LORA_METRICS_SetPeak(RadioTask->Radio, LORA_METRICS_TASK_RADIO, LORA_METRICS_RADIO_QUEUE_PEAK,
+                        1 + atomic_load_explicit(&ClientState->ReqQueue.Head, memory_order_relaxed) -
+                            atomic_load_explicit(&ClientState->ReqQueue.Tail, memory_order_relaxed));
+
+   ExecuteReq(RadioTask, ClientState, &Req);
+
+   QueuePut(&ClientState->CplQueue, &Req);
+   if (Client != RADIO_TASK_CLIENT_CMD)
+   {
+      OS_CountSemGive(ClientState->CplSemaphore);
+   }
+
+   return true;
+
+} /* End ServeClient() */
+
+
+/******************************************************************************
+** Function: ServeOtherClients
+**
+** Execute the queued requests of every client except the one with a receive
+** in progress.
+**
+** Notes:
+**   1. A client's requests are served in order up to its first receive
+**      request. Receives aren't nested because the radio can only deliver a
+**      frame to one of them.
+*/
+static void ServeOtherClients(RADIO_TASK_Class_t *RadioTask, const RADIO_TASK_ClientState_t *RxClientState)
+{
+
+   RADIO_TASK_Op_t Op;
+   uint16 Client;
+
+   for (Client=0; Client < RADIO_TASK_CLIENT_CNT; Client++)
+   {
+      if (&RadioTask->Client[Client] != RxClientState)
+      {
+         while (PeekOp(&RadioTask->Client[Client].ReqQueue, &Op) && Op != RADIO_TASK_OP_RECEIVE_PAYLOAD)
+         {
+            ServeClient(RadioTask, Client);
+         }
+      }
+   }
+
+} /* End ServeOtherClients() */
+
+
+/******************************************************************************
+** Function: Submit
+**
+** Notes:
+**   1. The request queue head and the completion queue tail are both owned
+**      by the client so their difference is the number of requests that
+**      haven't been collected.
+*/
+static bool Submit(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client, RADIO_TASK_Req_t *Req)
+{
+
+   RADIO_TASK_ClientState_t *ClientState = &RadioTask->Client[Client];
+   unsigned int Outstanding = atomic_load_explicit(&ClientState->ReqQueue.Head, memory_order_relaxed) -
+                              atomic_load_explicit(&ClientState->CplQueue.Tail, memory_order_relaxed);
+
+   OS_GetLocalTime(&Req->SubmitTime);
+
+   if (Outstanding >= RADIO_TASK_QUEUE_LEN || !QueuePut(&ClientState->ReqQueue, Req))
+   {
+      atomic_fetch_add_explicit(&ClientState->RejectCnt, 1, memory_order_relaxed);
+      return false;
+   }
+
+   atomic_fetch_add_explicit(&ClientState->ReqCnt, 1, memory_order_relaxed);
+   OS_CountSemGive(RadioTask->WakeUpSemaphore);
+
+   return true;
+
+} /* End Submit() */
+
+
+/******************************************************************************
+** Function: TimeOnAir
+**
+** Return the time on air of a payload using the radio's current settings
+**
+** Notes:
+**   1. Only used for the airtime metric so the settings are tracked here
+**      rather than read back from the radio.
+*/
+static uint32 TimeOnAir(const RADIO_TASK_Class_t *RadioTask, uint8 PayloadLen)
+{
+
+   return LORA_TOA_FrameTimeOnAir(RadioTask->SpreadingFactor, RadioTask->Bandwidth, RadioTask->CodingRate,
+                                  RadioTask->PreambleLen, RadioTask->ImplicitHeader, PayloadLen);
+
+} /* End TimeOnAir() */
+
+
+/******************************************************************************
+** Function: TracePayload
+**
+** Record the time a payload request waited to be served and the time the
+** driver call took
+**
+** Notes:
+**   1. A sent frame also gets a TxDone instant when the call returns.
+*/
+static void TracePayload(const RADIO_TASK_Class_t *RadioTask, const RADIO_TASK_Req_t *Req,
+                         const OS_time_t *StartTime, FRAME_TRACE_Stage_t WaitStage,
+                         FRAME_TRACE_Stage_t ExecStage)
+{
+
+   LORA_FRAME_Hdr_t FrameHdr;
+
+   if (!FRAME_TRACE_Enabled())
+   {
+      return;
+   }
+
+   if (LORA_FRAME_DecodeHdr(Req->Param.Payload.Data, Req->Param.Payload.Len, &FrameHdr) == 0)
+   {
+      FrameHdr.Seq = 0;
+   }
+
+   FRAME_TRACE_RecordSpan(RadioTask->Radio, FRAME_TRACE_TASK_RADIO, WaitStage, FrameHdr.Seq,
+                          Req->Param.Payload.Len, &Req->SubmitTime, StartTime);
+   FRAME_TRACE_Record(RadioTask->Radio, FRAME_TRACE_TASK_RADIO, ExecStage, FrameHdr.Seq,
+                      Req->Param.Payload.Len, StartTime);
+   if (ExecStage == FRAME_TRACE_TX_SEND)
+   {
+      FRAME_TRACE_Record(RadioTask->Radio, FRAME_TRACE_TASK_RADIO, FRAME_TRACE_TX_DONE, FrameHdr.Seq,
+                         Req->Param.Payload.Len, NULL);
+   }
+
+} /* End TracePayload() */
@@ -0,0 +1,339 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the radio owner task class
+**
+**  Notes:
+**    1. The radio task's child task is the only task that calls RADIO_DRV_*
+**       functions for its radio so driver calls are never concurrent. Each
+**       radio has its own radio task object and child task.
+**    2. Each client (the app's main task and the Tx and Rx child tasks) has
+**       a single producer/single consumer request queue and completion queue.
+**       The queues are lock-free rings so the only blocking is the optional
+**       wait for a completion.
+**    3. The main task submits radio commands with RADIO_TASK_SubmitCmd() and
+**       never waits. Completed commands are returned to the main task by
+**       RADIO_TASK_ProcessCmdCompletions() which calls the completion
+**       function supplied with the request.
+**    4. The Tx and Rx child tasks use the blocking RADIO_TASK_* call
+**       functions that have the same signatures as the RADIO_DRV_* wrappers
+**       with a client identifier added.
+**    5. Receive requests are served in RADIO_TASK_RX_SLICE_MS slices and the
+**       other clients' queued requests are executed between slices so a
+**       ground command or a Tx frame doesn't wait for a full receive
+**       timeout. A queued receive waits for the current receive to finish
+**       so a frame is never delivered to the wrong client.
+**
+*/
+
+#ifndef _radio_task_
+#define _radio_task_
+
+/*
+** Includes
+*/
+
+#include <stdatomic.h>
+#include "app_cfg.h"
+#include "radio_drv.h"
+#include "radio_inst.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define RADIO_TASK_QUEUE_LEN          4    /* Must be a power of 2 */
+#define RADIO_TASK_MAX_PAYLOAD_LEN  255
+#define RADIO_TASK_RX_SLICE_MS      100
+
+
+/*
+** Event Message IDs
+*/
+
+#define RADIO_TASK_CONSTRUCTOR_EID  (RADIO_TASK_BASE_EID + 0)
+#define RADIO_TASK_CHILD_TASK_EID   (RADIO_TASK_BASE_EID + 1)
+#define RADIO_TASK_SUBMIT_EID       (RADIO_TASK_BASE_EID + 2)
+#define RADIO_TASK_SUPPORT_EID      (RADIO_TASK_BASE_EID + 3)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef enum
+{
+
+   RADIO_TASK_CLIENT_CMD = 0,   /* App main task, never blocks */
+   RADIO_TASK_CLIENT_TX,
+   RADIO_TASK_CLIENT_RX,
+   RADIO_TASK_CLIENT_CNT
+
+} RADIO_TASK_Client_t;
+
+
+typedef enum
+{
+
+   RADIO_TASK_OP_SET_STANDBY_MODE = 0,
+   RADIO_TASK_OP_SET_POWER_REGULATOR_MODE,
+   RADIO_TASK_OP_SET_LOW_NOISE_AMP_MODE,
+   RADIO_TASK_OP_SET_POWER_AMP_RAMP_TIME,
+   RADIO_TASK_OP_SET_MODULATION_PARAMS,
+   RADIO_TASK_OP_SET_RADIO_FREQUENCY,
+   RADIO_TASK_OP_SET_PREAMBLE_LENGTH,
+   RADIO_TASK_OP_SET_HEADER_TYPE,
+   RADIO_TASK_OP_SET_RX_DUTY_CYCLE,
+   RADIO_TASK_OP_SEND_PAYLOAD,
+   RADIO_TASK_OP_RECEIVE_PAYLOAD,
+   RADIO_TASK_OP_RESET_STATUS
+
+} RADIO_TASK_Op_t;
+
+
+/*
+** A request is returned as its own completion with Status set and, for
+** receive requests, the received payload filled in.
+*/
+
+typedef struct RADIO_TASK_Req RADIO_TASK_Req_t;
+
+typedef void (*RADIO_TASK_CplFunc_t)(void *CplObj, const RADIO_TASK_Req_t *Req);
+
+struct RADIO_TASK_Req
+{
+
+   RADIO_TASK_Op_t       Op;
+   bool                  Status;
+   uint32                TimeoutMs;
+   OS_time_t             SubmitTime;
+   RADIO_TASK_CplFunc_t  CplFunc;       /* RADIO_TASK_CLIENT_CMD only */
+   void                 *CplObj;        /* Passed to CplFunc */
+
+   union
+   {
+      uint8   Mode;                     /* All SX128X mode enumerations */
+      uint32  Frequency;                /* Hz */
+      uint16  PreambleLen;              /* Symbols */
+      struct
+      {
+         uint32  RxPeriodUsec;
+         uint32  SleepPeriodUsec;
+      } DutyCycle;
+      struct
+      {
+         uint8  HeaderType;
+         uint8  PayloadLen;
+      } Header;
+      struct
+      {
+         uint8  SpreadingFactor;
+         uint8  Bandwidth;
+         uint8  CodingRate;
+      } Modulation;
+      struct
+      {
+         uint8  Len;
+         uint8  MaxLen;
+         int8   Rssi;
+         int8   Snr;
+         uint8  Data[RADIO_TASK_MAX_PAYLOAD_LEN];
+      } Payload;
+   } Param;
+
+};
+
+
+typedef struct
+{
+
+   atomic_uint       Head;   /* Only written by the producer */
+   atomic_uint       Tail;   /* Only written by the consumer */
+   RADIO_TASK_Req_t  Entry[RADIO_TASK_QUEUE_LEN];
+
+} RADIO_TASK_Queue_t;
+
+
+typedef struct
+{
+
+   RADIO_TASK_Queue_t  ReqQueue;
+   RADIO_TASK_Queue_t  CplQueue;
+   osal_id_t           CplSemaphore;
+
+   atomic_uint         ReqCnt;        /* Updated by the client, reset by the main task */
+   atomic_uint         RejectCnt;
+   uint32              MaxWaitUsec;   /* Longest time a request waited to be served */
+
+} RADIO_TASK_ClientState_t;
+
+
+/******************************************************************************
+** RADIO_TASK_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Object References
+   */
+
+   RADIO_DRV_Class_t *RadioDrv;
+
+   /*
+   ** Class State Data
+   */
+
+   uint8      Radio;
+   int32      RunStatus;
+   osal_id_t  WakeUpSemaphore;
+
+   /* Radio settings for the airtime metric */
+   uint8      SpreadingFactor;
+   uint8      Bandwidth;
+   uint8      CodingRate;
+   uint16     PreambleLen;
+   bool       ImplicitHeader;
+
+   RADIO_TASK_ClientState_t  Client[RADIO_TASK_CLIENT_CNT];
+
+} RADIO_TASK_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: RADIO_TASK_Constructor
+**
+** Initialize the Radio Task object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**   2. The semaphore names are unique for each radio.
+**
+*/
+void RADIO_TASK_Constructor(RADIO_TASK_Class_t *RadioTask, INITBL_Class_t *IniTbl,
+                            const RADIO_INST_Cfg_t *Inst, RADIO_DRV_Class_t *RadioDrv);
+
+
+/******************************************************************************
+** Function: RADIO_TASK_ChildTask
+**
+*/
+bool RADIO_TASK_ChildTask(RADIO_TASK_Class_t *RadioTask);
+
+
+/******************************************************************************
+** Function: RADIO_TASK_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+** Notes:
+**   1. The driver statistics and the request wait times are updated by the
+**      radio task so they're reset by a queued request rather than here.
+**      They're cleared when the radio task serves the request.
+**   2. The request counts are updated by every client so they're atomics
+**      and a reset can't tear a client's update.
+**
+*/
+void RADIO_TASK_ResetStatus(RADIO_TASK_Class_t *RadioTask);
+
+
+/******************************************************************************
+** Function: RADIO_TASK_CheckFrameSupport
+**
+** Return true if the radio's driver backend can send and receive frames.
+**
+** Notes:
+**   1. Sends an error event naming the rejected activity when it can't so
+**      commands that start a frame exchange can fail before waking a child
+**      task.
+**
+*/
+bool RADIO_TASK_CheckFrameSupport(const RADIO_TASK_Class_t *RadioTask, const char *Activity);
+
+
+/******************************************************************************
+** Function: RADIO_TASK_SubmitCmd
+**
+** Queue a request from the main task without waiting.
+**
+** Notes:
+**   1. Req->CplFunc is called with Req->CplObj by
+**      RADIO_TASK_ProcessCmdCompletions() after the request has been
+**      executed.
+**   2. Returns false if the command queue is full.
+**
+*/
+bool RADIO_TASK_SubmitCmd(RADIO_TASK_Class_t *RadioTask, const RADIO_TASK_Req_t *Req);
+
+
+/******************************************************************************
+** Function: RADIO_TASK_ProcessCmdCompletions
+**
+** Call the completion functions of all completed main task requests.
+**
+** Notes:
+**   1. Must only be called by the main task.
+**
+*/
+void RADIO_TASK_ProcessCmdCompletions(RADIO_TASK_Class_t *RadioTask);
+
+
+/******************************************************************************
+** Functions: Blocking radio calls
+**
+** Each function has the same parameters following the client identifier and
+** the same return value as the RADIO_DRV_* function with the same suffix.
+** They execute the call on the radio task and wait for its completion.
+**
+** Notes:
+**   1. Must not be used by the main task (RADIO_TASK_CLIENT_CMD).
+**   2. Each client must only be used by one task.
+**
+*/
+bool RADIO_TASK_SetStandbyMode(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                               SX128X_StandbyMode_Enum_t StandbyMode);
+bool RADIO_TASK_SetPowerRegulatorMode(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                                      SX128X_PowerRegulatorMode_Enum_t PowerRegulatorMode);
+bool RADIO_TASK_SetLowNoiseAmpMode(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                                   SX128X_LowNoiseAmpMode_Enum_t LowNoiseAmpMode);
+bool RADIO_TASK_SetPowerAmpRampTime(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                                    SX128X_PowerAmpRampTime_Enum_t PowerAmpRampTime);
+bool RADIO_TASK_SetModulationParams(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                                    SX128X_ModulationSpreadingFactor_Enum_t SpreadingFactor,
+                                    SX128X_ModulationBandwidth_Enum_t       Bandwidth,
+                                    SX128X_ModulationCodingRate_Enum_t      CodingRate);
+bool RADIO_TASK_SetRadioFrequency(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                                  uint32 Frequency);
+bool RADIO_TASK_SetPreambleLength(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                                  uint16 PreambleLen);
+bool RADIO_TASK_SetHeaderType(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                              LORA_HeaderType_Enum_t HeaderType, uint8 PayloadLen);
+bool RADIO_TASK_SetRxDutyCycle(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                               uint32 RxPeriodUsec, uint32 SleepPeriodUsec);
+bool RADIO_TASK_SendPayload(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                            const uint8 *Payload, uint8 PayloadLen, uint32 TimeoutMs);
+bool RADIO_TASK_ReceivePayload(RADIO_TASK_Class_t *RadioTask, RADIO_TASK_Client_t Client,
+                               uint8 *Payload, uint8 *PayloadLen, uint8 MaxLen,
+                               int8 *RssiPkt, int8 *SnrPkt, uint32 TimeoutMs);
+
+
+#endif /* _radio_task_ */
@@ -0,0 +1,708 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the multi-hop relay
+**
+**  Notes:
+**    1. The route table and the seen cache are short so they're scanned,
+**       the seen cache is a ring that overwrites its oldest frame.
+**    2. This is distance vector routing without triggered updates, a
+**       changed route spreads one hop per beacon period. Split horizon
+**       and the hop limit keep a lost route from counting up for long.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "relay.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define RELAY_MUTEX_NAME  "LORA_RELAY_MUT"
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static int16  FindRoute(const RELAY_Class_t *Relay, uint8 Dst);
+static void   LearnRoute(RELAY_Class_t *Relay, uint8 Dst, uint8 NextHop, uint8 HopCnt, int64 Now);
+static int64  NowUsec(void);
+static void   ParseHopClasses(RELAY_Class_t *Relay, const char *ClassStr);
+static void   ParseRoutes(RELAY_Class_t *Relay, const char *RouteStr);
+static void   RecordBeacon(RELAY_Class_t *Relay, uint8 Src, const uint8 *Data, uint16 DataLen);
+static bool   SeenBefore(RELAY_Class_t *Relay, uint8 Src, uint16 MsgId);
+
+
+/******************************************************************************
+** Function: RELAY_Constructor
+**
+*/
+void RELAY_Constructor(RELAY_Class_t *Relay, INITBL_Class_t *IniTbl, QOS_Class_t *Qos)
+{
+
+   int32  SysStatus;
+   uint32 NodeId;
+   uint32 BridgeDst;
+   uint32 MaxHops;
+
+   memset(Relay, 0, sizeof(RELAY_Class_t));
+
+   Relay->Qos = Qos;
+
+   SysStatus = OS_MutSemCreate(&Relay->MutexId, RELAY_MUTEX_NAME, 0);
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(RELAY_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating relay mutex %s, Status = %d", RELAY_MUTEX_NAME, SysStatus);
+   }
+
+   NodeId = INITBL_GetIntConfig(IniTbl, CFG_RELAY_NODE_ID);
+   if (NodeId >= LORA_FRAME_NODE_BROADCAST)
+   {
+      CFE_EVS_SendEvent(RELAY_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Invalid RELAY_NODE_ID %u, relaying is disabled", NodeId);
+      NodeId = LORA_FRAME_NODE_NONE;
+   }
+   Relay->NodeId = (uint8)NodeId;
+
+   BridgeDst = INITBL_GetIntConfig(IniTbl, CFG_RELAY_BRIDGE_DST);
+   if (BridgeDst == LORA_FRAME_NODE_NONE || BridgeDst > LORA_FRAME_NODE_BROADCAST ||
+       (Relay->NodeId != LORA_FRAME_NODE_NONE && BridgeDst == Relay->NodeId))
+   {
+      CFE_EVS_SendEvent(RELAY_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Invalid RELAY_BRIDGE_DST %u, flooding bridged messages", BridgeDst);
+      BridgeDst = LORA_FRAME_NODE_BROADCAST;
+   }
+   Relay->BridgeDst = (uint8)BridgeDst;
+
+   MaxHops = INITBL_GetIntConfig(IniTbl, CFG_RELAY_MAX_HOPS);
+   if (MaxHops < RELAY_HOP_LIMIT_MIN || MaxHops > RELAY_HOP_LIMIT_MAX)
+   {
+      CFE_EVS_SendEvent(RELAY_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Invalid RELAY_MAX_HOPS %u, using %u", MaxHops, RELAY_HOP_LIMIT_MAX);
+      MaxHops = RELAY_HOP_LIMIT_MAX;
+   }
+   Relay->MaxHops = (uint8)MaxHops;
+
+   Relay->NextMsgId = (uint16)NowUsec();   /* See relay.h note 4 */
+
+   Relay->BeaconPeriodMs = INITBL_GetIntConfig(IniTbl, CFG_RELAY_BEACON_SEC) * 1000;
+   Relay->RouteTimeoutMs = INITBL_GetIntConfig(IniTbl, CFG_RELAY_ROUTE_TIMEOUT_SEC) * 1000;
+   if (Relay->BeaconPeriodMs > 0 && Relay->RouteTimeoutMs <= Relay->BeaconPeriodMs)
+   {
+      CFE_EVS_SendEvent(RELAY_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "RELAY_ROUTE_TIMEOUT_SEC %u doesn't exceed RELAY_BEACON_SEC, using %u",
+                        Relay->RouteTimeoutMs / 1000, 3 * Relay->BeaconPeriodMs / 1000 + 5);
+      Relay->RouteTimeoutMs = 3 * Relay->BeaconPeriodMs + 5000;
+   }
+
+   ParseHopClasses(Relay, INITBL_GetStrConfig(IniTbl, CFG_RELAY_HOP_CLASSES));
+   if (Relay->HopClassCnt == 0)
+   {
+      CFE_EVS_SendEvent(RELAY_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "RELAY_HOP_CLASSES has no valid classes, forwarding with class 0");
+      Relay->HopClass[0] = 0;
+      Relay->HopClassCnt = 1;
+   }
+
+   ParseRoutes(Relay, INITBL_GetStrConfig(IniTbl, CFG_RELAY_ROUTES));
+
+   CFE_MSG_Init(CFE_MSG_PTR(Relay->RelayTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_LORA_RELAY_TLM_TOPICID)), sizeof(LORA_RelayTlm_t));
+
+} /* End RELAY_Constructor() */
+
+
+/******************************************************************************
+** Function: RELAY_Enabled
+**
+*/
+bool RELAY_Enabled(const RELAY_Class_t *Relay)
+{
+
+   return (Relay->NodeId != LORA_FRAME_NODE_NONE);
+
+} /* End RELAY_Enabled() */
+
+
+/******************************************************************************
+** Function: RELAY_Originate
+**
+** Notes:
+**   1. The frame is added to the seen cache so a flooded copy that comes
+**      back is dropped.
+**
+*/
+bool RELAY_Originate(RELAY_Class_t *Relay, LORA_FRAME_Route_t *Route)
+{
+
+   int16 RouteIdx;
+
+   if (Relay->NodeId == LORA_FRAME_NODE_NONE)
+   {
+      return false;
+   }
+
+   Route->Src    = Relay->NodeId;
+   Route->Dst    = Relay->BridgeDst;
+   Route->HopCnt = 0;
+   Route->MsgId  = ++Relay->NextMsgId;
+
+   OS_MutSemTake(Relay->MutexId);
+
+   RouteIdx = FindRoute(Relay, Route->Dst);
+   if (Route->Dst == LORA_FRAME_NODE_BROADCAST || RouteIdx < 0)
+   {
+      Route->NextHop = Route->Dst;
+   }
+   else
+   {
+      Route->NextHop = Relay->Route[RouteIdx].NextHop;
+   }
+
+   SeenBefore(Relay, Route->Src, Route->MsgId);
+   Relay->OrigCnt++;
+
+   OS_MutSemGive(Relay->MutexId);
+
+   return true;
+
+} /* End RELAY_Originate() */
+
+
+/******************************************************************************
+** Function: RELAY_NextBeacon
+**
+** Notes:
+**   1. Routes at the hop limit aren't advertised, a receiver couldn't use
+**      them.
+**
+*/
+bool RELAY_NextBeacon(RELAY_Class_t *Relay, LORA_FRAME_Route_t *Route, uint8 *Data, uint16 *DataLen)
+{
+
+   int64  Now;
+   uint16 i;
+
+   if (Relay->NodeId == LORA_FRAME_NODE_NONE || Relay->BeaconPeriodMs == 0)
+   {
+      return false;
+   }
+
+   Now = NowUsec();
+   if (Now < Relay->NextBeaconUsec)
+   {
+      return false;
+   }
+   Relay->NextBeaconUsec = Now + (int64)Relay->BeaconPeriodMs * 1000;
+
+   Route->Src     = Relay->NodeId;
+   Route->Dst     = LORA_FRAME_NODE_BROADCAST;
+   Route->NextHop = LORA_FRAME_NODE_BROADCAST;
+   Route->HopCnt  = 0;
+   Route->MsgId   = ++Relay->NextMsgId;
+
+   *DataLen = 0;
+
+   OS_MutSemTake(Relay->MutexId);
+
+   for (i=0; i < RELAY_MAX_ROUTE; i++)
+   {
+      if (Relay->Route[i].Dst != LORA_FRAME_NODE_NONE && Relay->Route[i].HopCnt < Relay->MaxHops)
+      {
+         Data[(*DataLen)++] = Relay->Route[i].Dst;
+         Data[(*DataLen)++] = Relay->Route[i].HopCnt;
+         Data[(*DataLen)++] = Relay->Route[i].NextHop;
+      }
+   }
+
+   OS_MutSemGive(Relay->MutexId);
+
+   return true;
+
+} /* End RELAY_NextBeacon() */
+
+
+/******************************************************************************
+** Function: RELAY_RecordBeaconTx
+**
+*/
+void RELAY_RecordBeaconTx(RELAY_Class_t *Relay, bool Sent)
+{
+
+   if (Sent)
+   {
+      OS_MutSemTake(Relay->MutexId);
+      Relay->BeaconTxCnt++;
+      OS_MutSemGive(Relay->MutexId);
+   }
+
+} /* End RELAY_RecordBeaconTx() */
+
+
+/******************************************************************************
+** Function: RELAY_Receive
+**
+** Notes:
+**   1. A frame that arrived after HopCnt + 1 hops would take its
+**      HopCnt + 2nd hop when forwarded.
+**   2. A flooded frame is delivered and forwarded, the seen cache stops
+**      it at every node it has already passed.
+**
+*/
+bool RELAY_Receive(RELAY_Class_t *Relay, const LORA_FRAME_Hdr_t *FrameHdr, const uint8 *Data, uint16 DataLen)
+{
+
+   LORA_FRAME_Route_t Route = FrameHdr->Route;
+   int16 RouteIdx = -1;
+   bool  Deliver  = false;
+   bool  Forward  = false;
+   uint8 Class;
+
+   if (FrameHdr->Type == LORA_FRAME_TYPE_BEACON)
+   {
+      if (Relay->NodeId != LORA_FRAME_NODE_NONE)
+      {
+         RecordBeacon(Relay, Route.Src, Data, DataLen);
+      }
+      return false;
+   }
+
+   if (Relay->NodeId == LORA_FRAME_NODE_NONE)
+   {
+      return true;
+   }
+
+   OS_MutSemTake(Relay->MutexId);
+
+   if (Route.NextHop != Relay->NodeId && Route.NextHop != LORA_FRAME_NODE_BROADCAST)
+   {
+      Relay->OverheardCnt++;
+   }
+   else if (SeenBefore(Relay, Route.Src, Route.MsgId))
+   {
+      Relay->DupCnt++;
+   }
+   else
+   {
+
+      if (Route.Dst == Relay->NodeId || Route.Dst == LORA_FRAME_NODE_BROADCAST)
+      {
+         Relay->DeliverCnt++;
+         Deliver = true;
+      }
+
+      if (Route.Dst != Relay->NodeId)
+      {
+         if (Route.HopCnt + 2 > Relay->MaxHops)
+         {
+            Relay->HopLimitCnt++;
+         }
+         else if (Route.Dst == LORA_FRAME_NODE_BROADCAST)
+         {
+            Forward = true;
+         }
+         else if ((RouteIdx = FindRoute(Relay, Route.Dst)) < 0)
+         {
+            Relay->NoRouteCnt++;
+         }
+         else
+         {
+            Route.NextHop = Relay->Route[RouteIdx].NextHop;
+            Forward = true;
+         }
+      }
+
+      if (Forward)
+      {
+         Route.HopCnt++;
+         Class = Relay->HopClass[(Route.HopCnt < Relay->HopClassCnt) ? Route.HopCnt - 1 : Relay->HopClassCnt - 1];
+         if (QOS_Forward(Relay->Qos, Class, FrameHdr->Type, &Route, Data, DataLen))
+         {
+            Relay->FwdCnt++;
+            if (RouteIdx >= 0)
+            {
+               Relay->Route[RouteIdx].FwdCnt++;
+            }
+         }
+         else
+         {
+            Relay->FwdDropCnt++;
+         }
+      }
+
+   } /* End if new frame */
+
+   OS_MutSemGive(Relay->MutexId);
+
+   return Deliver;
+
+} /* End RELAY_Receive() */
+
+
+/******************************************************************************
+** Function: RELAY_Manage
+**
+*/
+void RELAY_Manage(RELAY_Class_t *Relay)
+{
+
+   int64  Now;
+   uint16 i;
+   RELAY_Route_t *Route;
+
+   if (Relay->NodeId == LORA_FRAME_NODE_NONE)
+   {
+      return;
+   }
+
+   Now = NowUsec();
+
+   OS_MutSemTake(Relay->MutexId);
+
+   for (i=0; i < RELAY_MAX_ROUTE; i++)
+   {
+      Route = &Relay->Route[i];
+      if (Route->Dst != LORA_FRAME_NODE_NONE && !Route->Static &&
+          (Now - Route->HeardUsec) > (int64)Relay->RouteTimeoutMs * 1000)
+      {
+         CFE_EVS_SendEvent(RELAY_ROUTE_EID, CFE_EVS_EventType_INFORMATION,
+                           "Route to node %u via %u expired", Route->Dst, Route->NextHop);
+         Route->Dst = LORA_FRAME_NODE_NONE;
+      }
+   }
+
+   OS_MutSemGive(Relay->MutexId);
+
+} /* End RELAY_Manage() */
+
+
+/******************************************************************************
+** Function: RELAY_SendTlmCmd
+**
+*/
+bool RELAY_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   RELAY_Class_t *Relay = (RELAY_Class_t *)ObjDataPtr;
+   LORA_RelayTlm_Payload_t *Payload = &Relay->RelayTlm.Payload;
+   const RELAY_Route_t *Route;
+   int64  Now = NowUsec();
+   int64  AgeSec;
+   uint16 i;
+
+   memset(Payload, 0, sizeof(LORA_RelayTlm_Payload_t));
+
+   Payload->NodeId    = Relay->NodeId;
+   Payload->BridgeDst = Relay->BridgeDst;
+   Payload->MaxHops   = Relay->MaxHops;
+
+   OS_MutSemTake(Relay->MutexId);
+
+   Payload->OrigCnt      = Relay->OrigCnt;
+   Payload->DeliverCnt   = Relay->DeliverCnt;
+   Payload->FwdCnt       = Relay->FwdCnt;
+   Payload->DupCnt       = Relay->DupCnt;
+   Payload->OverheardCnt = Relay->OverheardCnt;
+   Payload->NoRouteCnt   = Relay->NoRouteCnt;
+   Payload->HopLimitCnt  = Relay->HopLimitCnt;
+   Payload->FwdDropCnt   = Relay->FwdDropCnt;
+   Payload->BeaconTxCnt  = Relay->BeaconTxCnt;
+   Payload->BeaconRxCnt  = Relay->BeaconRxCnt;
+
+   for (i=0; i < RELAY_MAX_ROUTE; i++)
+   {
+      Route = &Relay->Route[i];
+      if (Route->Dst != LORA_FRAME_NODE_NONE)
+      {
+         AgeSec = Route->Static ? 0 : (Now - Route->HeardUsec) / 1000000;
+         Payload->Route[Payload->RouteCnt].Dst     = Route->Dst;
+         Payload->Route[Payload->RouteCnt].NextHop = Route->NextHop;
+         Payload->Route[Payload->RouteCnt].HopCnt  = Route->HopCnt;
+         Payload->Route[Payload->RouteCnt].Static  = Route->Static;
+         Payload->Route[Payload->RouteCnt].AgeSec  = (uint16)((AgeSec > 0xFFFF) ? 0xFFFF : AgeSec);
+         Payload->Route[Payload->RouteCnt].FwdCnt  = Route->FwdCnt;
+         Payload->RouteCnt++;
+      }
+   }
+
+   OS_MutSemGive(Relay->MutexId);
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(Relay->RelayTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(Relay->RelayTlm.TelemetryHeader), true);
+
+   return true;
+
+} /* End RELAY_SendTlmCmd() */
+
+
+/******************************************************************************
+** Function: FindRoute
+**
+** Return the route table index for Dst, -1 if there's no route
+**
+*/
+static int16 FindRoute(const RELAY_Class_t *Relay, uint8 Dst)
+{
+
+   int16 i;
+
+   for (i=0; i < RELAY_MAX_ROUTE; i++)
+   {
+      if (Relay->Route[i].Dst != LORA_FRAME_NODE_NONE && Relay->Route[i].Dst == Dst)
+      {
+         return i;
+      }
+   }
+
+   return -1;
+
+} /* End FindRoute() */
+
+
+/******************************************************************************
+** Function: LearnRoute
+**
+** Notes:
+**   1. The caller holds the mutex.
+**   2. A route through the same neighbour is refreshed even if it got
+**      longer, the neighbour's beacon is the latest news about it. A route
+**      through another neighbour must be shorter to replace it.
+**   3. A full table gives up its longest learned route for a shorter one.
+**
+*/
+static void LearnRoute(RELAY_Class_t *Relay, uint8 Dst, uint8 NextHop, uint8 HopCnt, int64 Now)
+{
+
+   RELAY_Route_t *Route = NULL;
+   int16  RouteIdx;
+   uint16 i;
+
+   RouteIdx = FindRoute(Relay, Dst);
+   if (RouteIdx >= 0)
+   {
+      Route = &Relay->Route[RouteIdx];
+      if (Route->Static || (Route->NextHop != NextHop && HopCnt >= Route->HopCnt))
+      {
+         return;
+      }
+      if (Route->NextHop != NextHop)
+      {
+         Route->FwdCnt = 0;
+      }
+   }
+   else
+   {
+      for (i=0; i < RELAY_MAX_ROUTE; i++)
+      {
+         if (Relay->Route[i].Dst == LORA_FRAME_NODE_NONE)
+         {
+            Route = &Relay->Route[i];
+            break;
+         }
+         if (!Relay->Route[i].Static && Relay->Route[i].HopCnt > HopCnt &&
+             (Route == NULL || Relay->Route[i].HopCnt > Route->HopCnt))
+         {
+            Route = &Relay->Route[i];
+         }
+      }
+      if (Route == NULL)
+      {
+         return;
+      }
+      Route->FwdCnt = 0;
+   }
+
+   if (Route->Dst != Dst || Route->NextHop != NextHop || Route->HopCnt != HopCnt)
+   {
+      CFE_EVS_SendEvent(RELAY_ROUTE_EID, CFE_EVS_EventType_INFORMATION,
+                        "Route to node %u via %u, %u hops", Dst, NextHop, HopCnt);
+   }
+
+   Route->Dst       = Dst;
+   Route->NextHop   = NextHop;
+   Route->HopCnt    = HopCnt;
+   Route->Static    = false;
+   Route->HeardUsec = Now;
+
+} /* End LearnRoute() */
+
+
+/******************************************************************************
+** Function: NowUsec
+**
+*/
+static int64 NowUsec(void)
+{
+
+   OS_time_t Now;
+
+   OS_GetLocalTime(&Now);
+
+   return OS_TimeGetTotalMicroseconds(Now);
+
+} /* End NowUsec() */
+
+
+/******************************************************************************
+** Function: ParseHopClasses
+**
+** Notes:
+**   1. ClassStr is a comma separated list of QoS classes, for example
+**      "1,0". The Nth class is used by a frame's Nth relay and the last
+**      class by every relay after it.
+**
+*/
+static void ParseHopClasses(RELAY_Class_t *Relay, const char *ClassStr)
+{
+
+   const char *Next = ClassStr;
+   uint32 Param[1];
+
+   while (*Next != '\0' && Relay->HopClassCnt < RELAY_MAX_HOP_CLASS)
+   {
+
+      if (QOS_ParseTuple(&Next, Param, 1) && Param[0] < Relay->Qos->ClassCnt)
+      {
+         Relay->HopClass[Relay->HopClassCnt] = (uint8)Param[0];
+         Relay->HopClassCnt++;
+      }
+      else
+      {
+         CFE_EVS_SendEvent(RELAY_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                           "Skipped invalid relay hop class %d in \"%s\"", Relay->HopClassCnt, ClassStr);
+      }
+
+   }
+
+} /* End ParseHopClasses() */
+
+
+/******************************************************************************
+** Function: ParseRoutes
+**
+** Notes:
+**   1. RouteStr is a comma separated list of Dst/NextHop pairs, for example
+**      "3/2,4/2".
+**
+*/
+static void ParseRoutes(RELAY_Class_t *Relay, const char *RouteStr)
+{
+
+   const char *Next = RouteStr;
+   uint32 Param[2];
+   uint16 RouteCnt = 0;
+
+   while (*Next != '\0' && RouteCnt < RELAY_MAX_ROUTE)
+   {
+
+      if (QOS_ParseTuple(&Next, Param, 2) &&
+          Param[0] > LORA_FRAME_NODE_NONE && Param[0] < LORA_FRAME_NODE_BROADCAST && Param[0] != Relay->NodeId &&
+          Param[1] > LORA_FRAME_NODE_NONE && Param[1] < LORA_FRAME_NODE_BROADCAST && Param[1] != Relay->NodeId &&
+          FindRoute(Relay, (uint8)Param[0]) < 0)
+      {
+         Relay->Route[RouteCnt].Dst     = (uint8)Param[0];
+         Relay->Route[RouteCnt].NextHop = (uint8)Param[1];
+         Relay->Route[RouteCnt].HopCnt  = (Param[0] == Param[1]) ? 1 : 2;
+         Relay->Route[RouteCnt].Static  = true;
+         RouteCnt++;
+      }
+      else
+      {
+         CFE_EVS_SendEvent(RELAY_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                           "Skipped invalid or repeated relay route %d in \"%s\"", RouteCnt, RouteStr);
+      }
+
+   }
+
+} /* End ParseRoutes() */
+
+
+/******************************************************************************
+** Function: RecordBeacon
+**
+** Notes:
+**   1. The sender is a neighbour. Its entries through this node are
+**      skipped (split horizon), they'd only route frames back here.
+**
+*/
+static void RecordBeacon(RELAY_Class_t *Relay, uint8 Src, const uint8 *Data, uint16 DataLen)
+{
+
+   int64  Now = NowUsec();
+   uint16 i;
+
+   if (Src == LORA_FRAME_NODE_NONE || Src == LORA_FRAME_NODE_BROADCAST || Src == Relay->NodeId)
+   {
+      return;
+   }
+
+   OS_MutSemTake(Relay->MutexId);
+
+   Relay->BeaconRxCnt++;
+
+   LearnRoute(Relay, Src, Src, 1, Now);
+
+   for (i=0; i + RELAY_BEACON_ENTRY_LEN <= DataLen; i += RELAY_BEACON_ENTRY_LEN)
+   {
+      if (Data[i] != LORA_FRAME_NODE_NONE && Data[i] != LORA_FRAME_NODE_BROADCAST &&
+          Data[i] != Relay->NodeId && Data[i] != Src && Data[i+2] != Relay->NodeId &&
+          Data[i+1] > 0 && Data[i+1] < Relay->MaxHops)
+      {
+         LearnRoute(Relay, Data[i], Src, Data[i+1] + 1, Now);
+      }
+   }
+
+   OS_MutSemGive(Relay->MutexId);
+
+} /* End RecordBeacon() */
+
+
+/******************************************************************************
+** Function: SeenBefore
+**
+** Return true if the frame is in the seen cache, otherwise add it
+**
+** Notes:
+**   1. The caller holds the mutex.
+**
+*/
+static bool SeenBefore(RELAY_Class_t *Relay, uint8 Src, uint16 MsgId)
+{
+
+   uint32 Key = ((uint32)Src << 16) | MsgId;
+   uint16 i;
+
+   for (i=0; i < RELAY_SEEN_LEN; i++)
+   {
+      if (Relay->Seen[i] == Key)
+      {
+         return true;
+      }
+   }
+
+   Relay->Seen[Relay->SeenNext] = Key;
+   Relay->SeenNext = (Relay->SeenNext + 1) % RELAY_SEEN_LEN;
+
+   return false;
+
+} /* End SeenBefore() */
+
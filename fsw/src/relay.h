@@ -0,0 +1,266 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the multi-hop relay
+**
+**  Notes:
+**    1. Nodes beyond a single hop's range are reached through relays. With
+**       RELAY_NODE_ID set, a Tx bridge's frames carry a route field (see
+**       lora_frame.h) addressed to RELAY_BRIDGE_DST and a node running an
+**       Rx bridge forwards the frames whose next hop it is. A relay runs
+**       both bridges, on one radio or on two.
+**    2. The next hop to a destination comes from RELAY_ROUTES or is learned
+**       from beacons. A Tx bridge sends a beacon every RELAY_BEACON_SEC
+**       listing the nodes it reaches and their hop counts. A receiver
+**       learns the sender as a neighbour and every listed node one hop
+**       further through it, except the nodes the sender reaches through
+**       the receiver. A shorter route replaces a learned one and a learned
+**       route that no beacon confirms for RELAY_ROUTE_TIMEOUT_SEC is
+**       dropped. Static routes are never replaced, they're advertised as 1
+**       hop when the next hop is the destination and 2 otherwise.
+**    3. A forwarded frame goes from the Rx task's frame to a QoS queue
+**       entry and from there to the Tx task's frame, it never passes
+**       through the software bus or a file. Its QoS class comes from
+**       RELAY_HOP_CLASSES by the number of relays it has been through so a
+**       frame that has already used more airtime gets the earlier
+**       deadline. See qos.h.
+**    4. A seen cache of the last RELAY_SEEN_LEN frames' source and message
+**       ID drops frames that arrive twice, over two paths or because a
+**       flooded frame came back. The message ID sequence starts from the
+**       boot time's microseconds so a rebooted node doesn't reuse the IDs
+**       its neighbours still hold in their seen caches.
+**    5. A frame is dropped once it has taken RELAY_MAX_HOPS hops, routing
+**       loops while routes change can't keep it on the air.
+**    6. Routed frames come from any neighbour, each with its own frame
+**       sequence. The Rx bridge doesn't drop them as out of sequence
+**       unless it's hopping, a hopping receiver follows one transmitter.
+**    7. The route table and the seen cache are protected by a mutex. Rx
+**       tasks queue forwarded frames while holding it so the lock order is
+**       always relay then QoS.
+**
+*/
+
+#ifndef _relay_
+#define _relay_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "lora_frame.h"
+#include "qos.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define RELAY_MAX_ROUTE      8     /* Must match the RelayRouteTbl length */
+#define RELAY_MAX_HOP_CLASS  4
+#define RELAY_SEEN_LEN       32
+#define RELAY_HOP_LIMIT_MIN  2     /* RELAY_MAX_HOPS range */
+#define RELAY_HOP_LIMIT_MAX  15
+#define RELAY_BEACON_ENTRY_LEN  3  /* Dst, HopCnt, NextHop */
+#define RELAY_MAX_BEACON_LEN (RELAY_BEACON_ENTRY_LEN * RELAY_MAX_ROUTE)
+
+
+/*
+** Event Message IDs
+*/
+
+#define RELAY_CONSTRUCTOR_EID  (RELAY_BASE_EID + 0)
+#define RELAY_ROUTE_EID        (RELAY_BASE_EID + 1)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+
+typedef struct
+{
+
+   uint8   Dst;          /* LORA_FRAME_NODE_NONE for an unused entry */
+   uint8   NextHop;
+   uint8   HopCnt;       /* Hops to Dst, 1 is a neighbour */
+   bool    Static;       /* From RELAY_ROUTES */
+   int64   HeardUsec;    /* Last beacon that confirmed a learned route */
+   uint32  FwdCnt;
+
+} RELAY_Route_t;
+
+
+/******************************************************************************
+** RELAY_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Telemetry Packets
+   */
+
+   LORA_RelayTlm_t  RelayTlm;
+
+   /*
+   ** Object References
+   */
+
+   QOS_Class_t  *Qos;
+
+   /*
+   ** Class State Data
+   */
+
+   osal_id_t  MutexId;        /* Protects the routes, the seen cache and the counters */
+
+   uint8   NodeId;
+   uint8   BridgeDst;
+   uint8   MaxHops;
+   uint8   HopClassCnt;
+   uint8   HopClass[RELAY_MAX_HOP_CLASS];
+   uint32  BeaconPeriodMs;
+   uint32  RouteTimeoutMs;
+
+   RELAY_Route_t  Route[RELAY_MAX_ROUTE];
+
+   uint32  Seen[RELAY_SEEN_LEN];   /* Src << 16 | MsgId, 0 is unused */
+   uint16  SeenNext;
+
+   uint32  OrigCnt;
+   uint32  DeliverCnt;
+   uint32  FwdCnt;
+   uint32  DupCnt;
+   uint32  OverheardCnt;
+   uint32  NoRouteCnt;
+   uint32  HopLimitCnt;
+   uint32  FwdDropCnt;
+   uint32  BeaconTxCnt;
+   uint32  BeaconRxCnt;
+
+   /* Tx task */
+   uint16  NextMsgId;
+   int64   NextBeaconUsec;
+
+} RELAY_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: RELAY_Constructor
+**
+** Initialize the relay object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function and after
+**      QOS_Constructor(), RELAY_HOP_CLASSES indexes QOS_CLASSES.
+**   2. Invalid RELAY_ROUTES and RELAY_HOP_CLASSES entries are reported
+**      and skipped.
+**
+*/
+void RELAY_Constructor(RELAY_Class_t *Relay, INITBL_Class_t *IniTbl, QOS_Class_t *Qos);
+
+
+/******************************************************************************
+** Function: RELAY_Enabled
+**
+*/
+bool RELAY_Enabled(const RELAY_Class_t *Relay);
+
+
+/******************************************************************************
+** Function: RELAY_Originate
+**
+** Address a bridged message sent by this node
+**
+** Notes:
+**   1. Only called by the bridging radio's Tx task.
+**   2. Returns false if routing is disabled and the frame has no route
+**      field. A destination without a route is assumed to be a neighbour.
+**
+*/
+bool RELAY_Originate(RELAY_Class_t *Relay, LORA_FRAME_Route_t *Route);
+
+
+/******************************************************************************
+** Function: RELAY_NextBeacon
+**
+** Build this node's beacon when one is due
+**
+** Notes:
+**   1. Only called by the bridging radio's Tx task.
+**   2. Returns false if no beacon is due. Data must have room for
+**      RELAY_MAX_BEACON_LEN bytes.
+**   3. Beacons are a few bytes every RELAY_BEACON_SEC and aren't charged
+**      to the bridge's airtime budget.
+**
+*/
+bool RELAY_NextBeacon(RELAY_Class_t *Relay, LORA_FRAME_Route_t *Route, uint8 *Data, uint16 *DataLen);
+
+
+/******************************************************************************
+** Function: RELAY_RecordBeaconTx
+**
+*/
+void RELAY_RecordBeaconTx(RELAY_Class_t *Relay, bool Sent);
+
+
+/******************************************************************************
+** Function: RELAY_Receive
+**
+** Route a received frame that has a route field
+**
+** Notes:
+**   1. Called by the Rx bridge tasks. Data is the frame's payload.
+**   2. Beacons update the route table. Frames whose next hop is this node
+**      are queued for their next hop unless they're addressed to it.
+**   3. Returns true if the frame is addressed to this node or is flooded
+**      and should be delivered. Beacons and duplicates return false. With
+**      routing disabled every other frame is delivered.
+**
+*/
+bool RELAY_Receive(RELAY_Class_t *Relay, const LORA_FRAME_Hdr_t *FrameHdr, const uint8 *Data, uint16 DataLen);
+
+
+/******************************************************************************
+** Function: RELAY_Manage
+**
+** Drop learned routes that no beacon has confirmed
+**
+** Notes:
+**   1. Called by the main task once a second.
+**
+*/
+void RELAY_Manage(RELAY_Class_t *Relay);
+
+
+/******************************************************************************
+** Function: RELAY_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**
+*/
+bool RELAY_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _relay_ */
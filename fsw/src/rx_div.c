@@ -0,0 +1,210 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the receive diversity combiner class
+**
+**  Notes:
+**    1. The contribution counts are kept current as copies arrive rather
+**       than when a window entry is reused so telemetry is exact at any
+**       time.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "rx_div.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define RX_DIV_MUTEX_NAME  "LORA_RX_DIV_MUT"
+
+
+/******************************************************************************
+** Function: RX_DIV_Constructor
+**
+*/
+void RX_DIV_Constructor(RX_DIV_Class_t *RxDiv, INITBL_Class_t *IniTbl)
+{
+
+   int32 SysStatus;
+
+   memset(RxDiv, 0, sizeof(RX_DIV_Class_t));
+
+   SysStatus = OS_MutSemCreate(&RxDiv->MutexId, RX_DIV_MUTEX_NAME, 0);
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(RX_DIV_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating receive diversity mutex %s, Status = %d", RX_DIV_MUTEX_NAME, SysStatus);
+   }
+
+   CFE_MSG_Init(CFE_MSG_PTR(RxDiv->RxDivTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_LORA_RX_DIV_TLM_TOPICID)), sizeof(LORA_RxDivTlm_t));
+
+} /* End RX_DIV_Constructor() */
+
+
+/******************************************************************************
+** Function: RX_DIV_Start
+**
+*/
+void RX_DIV_Start(RX_DIV_Class_t *RxDiv)
+{
+
+   OS_MutSemTake(RxDiv->MutexId);
+   memset(RxDiv->Window, 0, sizeof(RxDiv->Window));
+   OS_MutSemGive(RxDiv->MutexId);
+
+} /* End RX_DIV_Start() */
+
+
+/******************************************************************************
+** Function: RX_DIV_Accept
+**
+** Notes:
+**   1. A frame older than the window's entry for its slot can't be checked.
+**      It's passed on without replacing the newer entry and the transfer
+**      handles it, for example the striped receive's packet map.
+**
+*/
+bool RX_DIV_Accept(RX_DIV_Class_t *RxDiv, uint8 Radio, uint16 Seq, int8 Snr)
+{
+
+   RX_DIV_Entry_t *Entry = &RxDiv->Window[Seq & (RX_DIV_WINDOW_LEN-1)];
+   RX_DIV_Radio_t *DivRadio = &RxDiv->Radio[Radio];
+   bool Pass = true;
+
+   OS_MutSemTake(RxDiv->MutexId);
+
+   DivRadio->RxCnt++;
+   DivRadio->SnrSum += Snr;
+
+   if (Entry->Used && Entry->Seq == Seq)
+   {
+
+      Pass = false;
+      RxDiv->DupCnt++;
+
+      if (Entry->CopyCnt < UINT8_MAX && ++Entry->CopyCnt == 2)
+      {
+         RxDiv->Radio[Entry->FirstRadio].SoleCnt--;
+      }
+
+      if (Snr > Entry->BestSnr)
+      {
+         RxDiv->Radio[Entry->BestRadio].BestCnt--;
+         DivRadio->BestCnt++;
+         RxDiv->BestSnrSum += Snr - Entry->BestSnr;
+         Entry->BestSnr   = Snr;
+         Entry->BestRadio = Radio;
+      }
+
+   }
+   else if (Entry->Used && (int16)(Seq - Entry->Seq) < 0)
+   {
+
+      RxDiv->StaleCnt++;
+
+   }
+   else
+   {
+
+      Entry->Used       = true;
+      Entry->Seq        = Seq;
+      Entry->FirstRadio = Radio;
+      Entry->BestRadio  = Radio;
+      Entry->BestSnr    = Snr;
+      Entry->CopyCnt    = 1;
+
+      RxDiv->FrameCnt++;
+      RxDiv->BestSnrSum += Snr;
+      DivRadio->FirstCnt++;
+      DivRadio->BestCnt++;
+      DivRadio->SoleCnt++;
+
+   }
+
+   OS_MutSemGive(RxDiv->MutexId);
+
+   return Pass;
+
+} /* End RX_DIV_Accept() */
+
+
+/******************************************************************************
+** Function: RX_DIV_ResetStatus
+**
+*/
+void RX_DIV_ResetStatus(RX_DIV_Class_t *RxDiv)
+{
+
+   OS_MutSemTake(RxDiv->MutexId);
+
+   RxDiv->FrameCnt   = 0;
+   RxDiv->DupCnt     = 0;
+   RxDiv->StaleCnt   = 0;
+   RxDiv->BestSnrSum = 0;
+   memset(RxDiv->Radio, 0, sizeof(RxDiv->Radio));
+
+   /* Copies of frames already in the window must not change the new counts */
+   memset(RxDiv->Window, 0, sizeof(RxDiv->Window));
+
+   OS_MutSemGive(RxDiv->MutexId);
+
+} /* End RX_DIV_ResetStatus() */
+
+
+/******************************************************************************
+** Function: RX_DIV_SendTlmCmd
+**
+*/
+bool RX_DIV_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   RX_DIV_Class_t *RxDiv = (RX_DIV_Class_t *)ObjDataPtr;
+   LORA_RxDivTlm_Payload_t *Payload = &RxDiv->RxDivTlm.Payload;
+   const RX_DIV_Radio_t *DivRadio;
+   uint16 i;
+
+   OS_MutSemTake(RxDiv->MutexId);
+
+   Payload->WindowLen  = RX_DIV_WINDOW_LEN;
+   Payload->FrameCnt   = RxDiv->FrameCnt;
+   Payload->DupCnt     = RxDiv->DupCnt;
+   Payload->StaleCnt   = RxDiv->StaleCnt;
+   Payload->BestSnrAvg = (RxDiv->FrameCnt > 0) ? (int8)(RxDiv->BestSnrSum / (int32)RxDiv->FrameCnt) : 0;
+
+   for (i=0; i < LORA_RADIO_MAX; i++)
+   {
+      DivRadio = &RxDiv->Radio[i];
+      Payload->RadioRxCnt[i]    = DivRadio->RxCnt;
+      Payload->RadioFirstCnt[i] = DivRadio->FirstCnt;
+      Payload->RadioBestCnt[i]  = DivRadio->BestCnt;
+      Payload->RadioSoleCnt[i]  = DivRadio->SoleCnt;
+      Payload->RadioSnrAvg[i]   = (DivRadio->RxCnt > 0) ? (int8)(DivRadio->SnrSum / (int32)DivRadio->RxCnt) : 0;
+   }
+
+   OS_MutSemGive(RxDiv->MutexId);
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(RxDiv->RxDivTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(RxDiv->RxDivTlm.TelemetryHeader), true);
+
+   return true;
+
+} /* End RX_DIV_SendTlmCmd() */
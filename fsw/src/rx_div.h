@@ -0,0 +1,185 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the receive diversity combiner class
+**
+**  Notes:
+**    1. When several receiving radios are on the same channel, for example
+**       ground radios on different antennas, each frame can be received
+**       more than once. The combiner passes on one copy of each frame and
+**       drops the others so a frame is only lost if every radio lost it.
+**    2. Duplicates are found in a window of the last RX_DIV_WINDOW_LEN
+**       sequence numbers indexed by the sequence number's low bits, so a
+**       check is one array lookup. The copies of a frame arrive within a
+**       few milliseconds of each other so a small window is enough.
+**    3. The radio drops frames that fail the CRC so every copy has the same
+**       data. The first copy is passed on without waiting for the others and
+**       the copy with the best SNR is kept as the frame's record. The best
+**       SNR and the radio it came from are used for the link statistics and
+**       the per-radio contribution counts.
+**    4. The combiner is used by the striped receive, see stripe.h. Striped
+**       radios on the same RADIO_n_FREQ_OFFSET channel receive the same
+**       frames, radios on different channels receive different frames and
+**       the combiner has nothing to drop.
+**
+*/
+
+#ifndef _rx_div_
+#define _rx_div_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define RX_DIV_WINDOW_LEN  64   /* Must be a power of 2 */
+
+
+/*
+** Event Message IDs
+*/
+
+#define RX_DIV_CONSTRUCTOR_EID  (RX_DIV_BASE_EID + 0)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+
+typedef struct
+{
+
+   bool    Used;
+   uint16  Seq;
+   uint8   FirstRadio;
+   uint8   BestRadio;
+   int8    BestSnr;
+   uint8   CopyCnt;
+
+} RX_DIV_Entry_t;
+
+
+typedef struct
+{
+
+   uint32  RxCnt;
+   uint32  FirstCnt;
+   uint32  BestCnt;
+   uint32  SoleCnt;
+   int32   SnrSum;
+
+} RX_DIV_Radio_t;
+
+
+/******************************************************************************
+** RX_DIV_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Telemetry Packets
+   */
+
+   LORA_RxDivTlm_t  RxDivTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   osal_id_t  MutexId;     /* The radios' Rx tasks share the window */
+
+   uint32     FrameCnt;
+   uint32     DupCnt;
+   uint32     StaleCnt;
+   int32      BestSnrSum;  /* Adjusted when a better copy replaces a frame's best */
+
+   RX_DIV_Radio_t Radio[LORA_RADIO_MAX];
+   RX_DIV_Entry_t Window[RX_DIV_WINDOW_LEN];
+
+} RX_DIV_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: RX_DIV_Constructor
+**
+** Initialize the Rx Diversity object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void RX_DIV_Constructor(RX_DIV_Class_t *RxDiv, INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: RX_DIV_Start
+**
+** Clear the window for a new transfer
+**
+** Notes:
+**   1. Sequence numbers restart with each transfer so a copy of a frame
+**      from the last transfer must not hide a frame of the new one.
+**
+*/
+void RX_DIV_Start(RX_DIV_Class_t *RxDiv);
+
+
+/******************************************************************************
+** Function: RX_DIV_Accept
+**
+** Record a frame copy received by Radio and return whether it should be
+** passed on
+**
+** Notes:
+**   1. Returns true for the first copy of a frame and for frames older than
+**      the window, false for the other copies.
+**
+*/
+bool RX_DIV_Accept(RX_DIV_Class_t *RxDiv, uint8 Radio, uint16 Seq, int8 Snr);
+
+
+/******************************************************************************
+** Function: RX_DIV_ResetStatus
+**
+*/
+void RX_DIV_ResetStatus(RX_DIV_Class_t *RxDiv);
+
+
+/******************************************************************************
+** Function: RX_DIV_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool RX_DIV_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _rx_div_ */
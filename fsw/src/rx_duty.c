@@ -0,0 +1,352 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the Duty-cycled Receive Class methods
+**
+**  Notes:
+**    1. See rx_duty.h file prologue.
+**    2. Charge in pC multiplied by the supply in mV is energy in fJ.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "radio_drv.h"
+#include "rx_duty.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/* Convenience macros */
+#define  INITBL_OBJ   (RxDuty->IniTbl)
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static bool ComputeDutyCycle(const RX_DUTY_Class_t *RxDuty, uint8 SpreadingFactor, uint8 Bandwidth,
+                             uint16 *PreambleLen, uint32 *RxWindowUsec, uint32 *SleepUsec);
+
+
+/******************************************************************************
+** Function: RX_DUTY_Constructor
+**
+** Initialize the Duty-cycled Receive object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void RX_DUTY_Constructor(RX_DUTY_Class_t *RxDuty, INITBL_Class_t *IniTbl,
+                         const RADIO_INST_Cfg_t *Inst, RADIO_TASK_Class_t *RadioTask)
+{
+
+   uint32 PeriodMs;
+
+   memset(RxDuty, 0, sizeof(RX_DUTY_Class_t));
+
+   RxDuty->IniTbl    = IniTbl;
+   RxDuty->RadioTask = RadioTask;
+
+   PeriodMs = INITBL_GetIntConfig(INITBL_OBJ, CFG_RX_DUTY_PERIOD_MS);
+   if (PeriodMs > RX_DUTY_MAX_PERIOD_MS)
+   {
+      CFE_EVS_SendEvent(RX_DUTY_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Invalid receive duty cycle period %d ms, must be less than %d. Using continuous receive",
+                        PeriodMs, RX_DUTY_MAX_PERIOD_MS);
+      PeriodMs = 0;
+   }
+   RxDuty->PeriodMs = PeriodMs;
+
+   RxDuty->BasePreambleLen = LORA_DEFAULT_PREAMBLE_LEN;
+   RxDuty->PreambleLen     = LORA_DEFAULT_PREAMBLE_LEN;
+   RxDuty->IdleCurrentUa = RX_DUTY_RX_CURRENT_UA;
+
+   CFE_MSG_Init(CFE_MSG_PTR(RxDuty->RxDutyTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_LORA_RX_DUTY_TLM_TOPICID)), sizeof(LORA_RxDutyTlm_t));
+   RxDuty->RxDutyTlm.Payload.Radio = Inst->Index;
+
+} /* End RX_DUTY_Constructor() */
+
+
+/******************************************************************************
+** Function: RX_DUTY_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+*/
+void RX_DUTY_ResetStatus(RX_DUTY_Class_t *RxDuty)
+{
+
+   RxDuty->ListenUsec = 0;
+   RxDuty->ChargePc   = 0;
+   RxDuty->RxFrameCnt = 0;
+   RxDuty->RxByteCnt  = 0;
+
+} /* End RX_DUTY_ResetStatus() */
+
+
+/******************************************************************************
+** Function: RX_DUTY_SetBasePreambleLen
+**
+*/
+void RX_DUTY_SetBasePreambleLen(RX_DUTY_Class_t *RxDuty, uint16 PreambleLen)
+{
+
+   RxDuty->BasePreambleLen = PreambleLen;
+
+} /* End RX_DUTY_SetBasePreambleLen() */
+
+
+/******************************************************************************
+** Function: RX_DUTY_PreambleLen
+**
+*/
+uint16 RX_DUTY_PreambleLen(const RX_DUTY_Class_t *RxDuty, uint8 SpreadingFactor, uint8 Bandwidth)
+{
+
+   uint16 PreambleLen;
+   uint32 RxWindowUsec;
+   uint32 SleepUsec;
+
+   ComputeDutyCycle(RxDuty, SpreadingFactor, Bandwidth, &PreambleLen, &RxWindowUsec, &SleepUsec);
+
+   return PreambleLen;
+
+} /* End RX_DUTY_PreambleLen() */
+
+
+/******************************************************************************
+** Function: RX_DUTY_ConfigRadio
+**
+** Load the radio with the preamble length and receive duty cycle for the
+** commanded period and the modulation.
+**
+*/
+bool RX_DUTY_ConfigRadio(RX_DUTY_Class_t *RxDuty, RADIO_TASK_Client_t Client,
+                         const LORA_SetModulationParams_CmdPayload_t *Modulation)
+{
+
+   bool   RetStatus;
+   uint16 PreambleLen;
+   uint32 RxWindowUsec;
+   uint32 SleepUsec;
+
+   if (!ComputeDutyCycle(RxDuty, Modulation->SpreadingFactor, Modulation->Bandwidth,
+                         &PreambleLen, &RxWindowUsec, &SleepUsec) && RxDuty->PeriodMs > 0)
+   {
+      CFE_EVS_SendEvent(RX_DUTY_CONFIG_RADIO_EID, CFE_EVS_EventType_INFORMATION,
+                        "Receive duty cycle period %d ms is too short for SF=%d, BW=%d. Using continuous receive",
+                        RxDuty->PeriodMs, Modulation->SpreadingFactor, Modulation->Bandwidth);
+   }
+
+   RetStatus = RADIO_TASK_SetPreambleLength(RxDuty->RadioTask, Client, PreambleLen);
+   if (RetStatus)
+   {
+      RetStatus = RADIO_TASK_SetRxDutyCycle(RxDuty->RadioTask, Client, RxWindowUsec, SleepUsec);
+   }
+
+   if (RetStatus)
+   {
+      RxDuty->Modulation    = *Modulation;
+      RxDuty->PreambleLen   = PreambleLen;
+      RxDuty->RxWindowUsec  = RxWindowUsec;
+      RxDuty->SleepUsec     = SleepUsec;
+      RxDuty->IdleCurrentUa = RX_DUTY_RX_CURRENT_UA;
+      if (SleepUsec > 0)
+      {
+         RxDuty->IdleCurrentUa = (uint32)(((uint64)RX_DUTY_RX_CURRENT_UA*RxWindowUsec +
+                                           (uint64)RX_DUTY_SLEEP_CURRENT_UA*SleepUsec) /
+                                          (RxWindowUsec + SleepUsec));
+      }
+   }
+   else
+   {
+      CFE_EVS_SendEvent(RX_DUTY_CONFIG_RADIO_EID, CFE_EVS_EventType_ERROR,
+                        "Error loading radio preamble length %d and receive duty cycle %d/%d usec",
+                        PreambleLen, RxWindowUsec, SleepUsec);
+   }
+
+   return RetStatus;
+
+} /* End RX_DUTY_ConfigRadio() */
+
+
+/******************************************************************************
+** Function: RX_DUTY_RecordListen
+**
+** Account for the energy of one receive call
+**
+** Notes:
+**   1. The radio wakes at a uniformly distributed point in a frame's
+**      preamble so on average it receives for the frame's time-on-air less
+**      half a period.
+**
+*/
+void RX_DUTY_RecordListen(RX_DUTY_Class_t *RxDuty, uint32 ListenUsec, uint8 FrameLen)
+{
+
+   uint32 FrameRxUsec = 0;
+   uint32 HalfPeriodUsec;
+
+   if (FrameLen > 0)
+   {
+
+      FrameRxUsec = LORA_TOA_TimeOnAir(RxDuty->Modulation.SpreadingFactor, RxDuty->Modulation.Bandwidth,
+                                       RxDuty->Modulation.CodingRate, RxDuty->PreambleLen, FrameLen);
+      if (RxDuty->SleepUsec > 0)
+      {
+         HalfPeriodUsec = (RxDuty->RxWindowUsec + RxDuty->SleepUsec) / 2;
+         FrameRxUsec = (FrameRxUsec > HalfPeriodUsec) ? (FrameRxUsec - HalfPeriodUsec) : 0;
+      }
+      if (FrameRxUsec > ListenUsec)
+      {
+         FrameRxUsec = ListenUsec;
+      }
+
+      RxDuty->RxFrameCnt++;
+      RxDuty->RxByteCnt += FrameLen;
+   }
+
+   RxDuty->ListenUsec += ListenUsec;
+   RxDuty->ChargePc   += (uint64)FrameRxUsec * RX_DUTY_RX_CURRENT_UA +
+                         (uint64)(ListenUsec - FrameRxUsec) * RxDuty->IdleCurrentUa;
+
+} /* End RX_DUTY_RecordListen() */
+
+
+/******************************************************************************
+** Function: RX_DUTY_SetPeriodCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool RX_DUTY_SetPeriodCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   RX_DUTY_Class_t *RxDuty = (RX_DUTY_Class_t *)ObjDataPtr;
+   const LORA_SetRxDutyCycle_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_SetRxDutyCycle_t);
+   bool RetStatus = false;
+
+   if (Cmd->PeriodMs > 0 && !RADIO_DRV_Supports(RxDuty->RadioTask->RadioDrv, RADIO_DRV_CALL_SET_RX_DUTY_CYCLE))
+   {
+      CFE_EVS_SendEvent(RX_DUTY_SET_PERIOD_CMD_EID, CFE_EVS_EventType_ERROR,
+                        "Set receive duty cycle command failed, radio %u driver backend only supports continuous receive",
+                        RxDuty->RadioTask->Radio);
+   }
+   else if (Cmd->PeriodMs <= RX_DUTY_MAX_PERIOD_MS)
+   {
+      RxDuty->PeriodMs = Cmd->PeriodMs;
+      RetStatus = true;
+      CFE_EVS_SendEvent(RX_DUTY_SET_PERIOD_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                        "Receive duty cycle period set to %d ms, applied when the next demo or link test starts",
+                        RxDuty->PeriodMs);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(RX_DUTY_SET_PERIOD_CMD_EID, CFE_EVS_EventType_ERROR,
+                        "Set receive duty cycle command failed, period %d ms is greater than %d",
+                        Cmd->PeriodMs, RX_DUTY_MAX_PERIOD_MS);
+   }
+
+   return RetStatus;
+
+} /* End RX_DUTY_SetPeriodCmd() */
+
+
+/******************************************************************************
+** Function: RX_DUTY_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool RX_DUTY_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   RX_DUTY_Class_t *RxDuty = (RX_DUTY_Class_t *)ObjDataPtr;
+   LORA_RxDutyTlm_Payload_t *RxDutyTlmPayload = &RxDuty->RxDutyTlm.Payload;
+   uint64 EnergyFj = RxDuty->ChargePc * RX_DUTY_SUPPLY_MV;
+   uint32 SymbolNsec = LORA_TOA_SymbolNsec(RxDuty->Modulation.SpreadingFactor, RxDuty->Modulation.Bandwidth);
+
+   RxDutyTlmPayload->PeriodMs       = RxDuty->PeriodMs;
+   RxDutyTlmPayload->PreambleLen    = RxDuty->PreambleLen;
+   RxDutyTlmPayload->RxWindowUsec   = RxDuty->RxWindowUsec;
+   RxDutyTlmPayload->SleepUsec      = RxDuty->SleepUsec;
+   RxDutyTlmPayload->IdleCurrentUa  = RxDuty->IdleCurrentUa;
+   RxDutyTlmPayload->ContinuousRxUa = RX_DUTY_RX_CURRENT_UA;
+   RxDutyTlmPayload->ListenMs       = (uint32)(RxDuty->ListenUsec / 1000);
+   RxDutyTlmPayload->RxFrameCnt     = RxDuty->RxFrameCnt;
+   RxDutyTlmPayload->RxByteCnt      = RxDuty->RxByteCnt;
+   RxDutyTlmPayload->EnergyUj       = (uint32)(EnergyFj / 1000000000);
+   RxDutyTlmPayload->EnergyPerByteNj  = RxDuty->RxByteCnt ? (uint32)(EnergyFj / 1000000 / RxDuty->RxByteCnt) : 0;
+   RxDutyTlmPayload->AddedLatencyUsec = 0;
+   if (RxDuty->PreambleLen > RxDuty->BasePreambleLen)
+   {
+      RxDutyTlmPayload->AddedLatencyUsec = (uint32)(((uint64)(RxDuty->PreambleLen - RxDuty->BasePreambleLen) * SymbolNsec) / 1000);
+   }
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(RxDuty->RxDutyTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(RxDuty->RxDutyTlm.TelemetryHeader), true);
+
+   CFE_EVS_SendEvent(RX_DUTY_SEND_TLM_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                     "Sent receive duty cycle telemetry message");
+   return true;
+
+} /* End RX_DUTY_SendTlmCmd() */
+
+
+/******************************************************************************
+** Function: ComputeDutyCycle
+**
+** Notes:
+**   1. Returns false and the continuous receive settings if duty cycling is
+**      disabled or the period isn't longer than the receive window.
+**   2. The preamble covers a full period plus a receive window so a sleeping
+**      receiver always wakes with enough preamble left to detect it.
+*/
+static bool ComputeDutyCycle(const RX_DUTY_Class_t *RxDuty, uint8 SpreadingFactor, uint8 Bandwidth,
+                             uint16 *PreambleLen, uint32 *RxWindowUsec, uint32 *SleepUsec)
+{
+
+   uint32 SymbolNsec = LORA_TOA_SymbolNsec(SpreadingFactor, Bandwidth);
+   uint32 PeriodUsec = (uint32)RxDuty->PeriodMs * 1000;
+   uint32 WindowUsec = (RX_DUTY_DETECT_SYMBOLS * SymbolNsec + 999) / 1000;
+   uint32 Symbols;
+
+   *PreambleLen  = RxDuty->BasePreambleLen;
+   *RxWindowUsec = 0;
+   *SleepUsec    = 0;
+
+   if (SymbolNsec == 0 || PeriodUsec <= WindowUsec)
+   {
+      return false;
+   }
+
+   Symbols = (uint32)(((uint64)PeriodUsec * 1000 + SymbolNsec - 1) / SymbolNsec) + RX_DUTY_DETECT_SYMBOLS;
+   if (Symbols > RxDuty->BasePreambleLen)
+   {
+      *PreambleLen = (uint16)Symbols;
+   }
+   *RxWindowUsec = WindowUsec;
+   *SleepUsec    = PeriodUsec - WindowUsec;
+
+   return true;
+
+} /* End ComputeDutyCycle() */
@@ -0,0 +1,232 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the duty-cycled receive class
+**
+**  Notes:
+**    1. When the period is non-zero the receiver uses the SX1280 RX duty
+**       cycle mode. It listens for RX_DUTY_DETECT_SYMBOLS symbols and
+**       sleeps for the rest of each period until a preamble is detected.
+**    2. A frame is only certain to be detected if its preamble spans a full
+**       period so the preamble is lengthened to the period plus the
+**       detection window. The transmitter must use the same period, which
+**       is why both ends take it from the RX_DUTY_PERIOD_MS JSON init file
+**       parameter. The longer preamble is the added latency of each frame.
+**    3. The base preamble is the radio's configured preamble length, see
+**       RADIO_IF_SetPacketParamsCmd(). Duty cycling only ever lengthens it.
+**    4. The period can be changed by command. It's applied to the radio the
+**       next time a demo or link test initializes the radio so it never
+**       changes in the middle of a transfer.
+**    5. The energy estimate uses SX1280 datasheet typical currents and
+**       doesn't include the sleep to receive transition time. Listening
+**       time comes from the receive calls and a received frame is charged
+**       at the full receive current from the average wakeup point in its
+**       preamble to its end.
+**
+*/
+
+#ifndef _rx_duty_
+#define _rx_duty_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "radio_task.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define RX_DUTY_MAX_PERIOD_MS     500   /* Keeps a frame within the send and receive timeouts */
+#define RX_DUTY_DETECT_SYMBOLS      8   /* Receive window needed to detect a preamble */
+
+#define RX_DUTY_RX_CURRENT_UA    5500   /* SX1280 LoRa receive, DC-DC regulator */
+#define RX_DUTY_SLEEP_CURRENT_UA    1   /* SX1280 sleep with buffer retention   */
+#define RX_DUTY_SUPPLY_MV        3300
+
+
+/*
+** Event Message IDs
+*/
+
+#define RX_DUTY_CONSTRUCTOR_EID       (RX_DUTY_BASE_EID + 0)
+#define RX_DUTY_SET_PERIOD_CMD_EID    (RX_DUTY_BASE_EID + 1)
+#define RX_DUTY_CONFIG_RADIO_EID      (RX_DUTY_BASE_EID + 2)
+#define RX_DUTY_SEND_TLM_CMD_EID      (RX_DUTY_BASE_EID + 3)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+
+/******************************************************************************
+** RX_DUTY_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Framework References
+   */
+
+   INITBL_Class_t *IniTbl;
+
+   /*
+   ** Object References
+   */
+
+   RADIO_TASK_Class_t *RadioTask;
+
+   /*
+   ** Telemetry Packets
+   */
+
+   LORA_RxDutyTlm_t  RxDutyTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   uint16  PeriodMs;        /* Commanded period, 0 is continuous receive */
+   uint16  BasePreambleLen; /* Symbols without duty cycling */
+
+   /* Settings loaded into the radio by the last RX_DUTY_ConfigRadio() */
+   LORA_SetModulationParams_CmdPayload_t Modulation;
+   uint16  PreambleLen;
+   uint32  RxWindowUsec;
+   uint32  SleepUsec;
+   uint32  IdleCurrentUa;
+
+   /* Energy accounting, charge is in uA*usec (pC) */
+   uint64  ListenUsec;
+   uint64  ChargePc;
+   uint32  RxFrameCnt;
+   uint32  RxByteCnt;
+
+} RX_DUTY_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: RX_DUTY_Constructor
+**
+** Initialize the Duty-cycled Receive object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void RX_DUTY_Constructor(RX_DUTY_Class_t *RxDuty, INITBL_Class_t *IniTbl,
+                         const RADIO_INST_Cfg_t *Inst, RADIO_TASK_Class_t *RadioTask);
+
+
+/******************************************************************************
+** Function: RX_DUTY_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+** Notes:
+**   1. Clears the energy accounting.
+**
+*/
+void RX_DUTY_ResetStatus(RX_DUTY_Class_t *RxDuty);
+
+
+/******************************************************************************
+** Function: RX_DUTY_SetBasePreambleLen
+**
+** Set the preamble length in symbols used without duty cycling
+**
+** Notes:
+**   1. Like the period it's loaded into the radio by the next
+**      RX_DUTY_ConfigRadio().
+**
+*/
+void RX_DUTY_SetBasePreambleLen(RX_DUTY_Class_t *RxDuty, uint16 PreambleLen);
+
+
+/******************************************************************************
+** Function: RX_DUTY_PreambleLen
+**
+** Return the preamble length in symbols for the commanded period and the
+** modulation.
+**
+** Notes:
+**   1. Returns the base preamble length if duty cycling is disabled or
+**      the period is too short for the modulation.
+**
+*/
+uint16 RX_DUTY_PreambleLen(const RX_DUTY_Class_t *RxDuty, uint8 SpreadingFactor, uint8 Bandwidth);
+
+
+/******************************************************************************
+** Function: RX_DUTY_ConfigRadio
+**
+** Load the radio with the preamble length and receive duty cycle for the
+** commanded period and the modulation.
+**
+** Notes:
+**   1. Must be called whenever the modulation changes because the preamble
+**      and receive window are measured in symbols.
+**   2. Blocks until the radio task has executed the calls so it must not be
+**      called by the main task.
+**
+*/
+bool RX_DUTY_ConfigRadio(RX_DUTY_Class_t *RxDuty, RADIO_TASK_Client_t Client,
+                         const LORA_SetModulationParams_CmdPayload_t *Modulation);
+
+
+/******************************************************************************
+** Function: RX_DUTY_RecordListen
+**
+** Account for the energy of one receive call
+**
+** Notes:
+**   1. FrameLen is 0 if the call timed out.
+**
+*/
+void RX_DUTY_RecordListen(RX_DUTY_Class_t *RxDuty, uint32 ListenUsec, uint8 FrameLen);
+
+
+/******************************************************************************
+** Function: RX_DUTY_SetPeriodCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool RX_DUTY_SetPeriodCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: RX_DUTY_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+*/
+bool RX_DUTY_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _rx_duty_ */
@@ -0,0 +1,578 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the received file writer class
+**
+**  Notes:
+**    1. The free blocks are a stack so a recently written block, likely
+**       still in cache, is filled next.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "rx_writer.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define RX_WRITER_MUTEX_NAME  "LORA_RXW_MUT"
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void  CloseStreams(RX_WRITER_Class_t *RxWriter);
+static bool  FillBlock(RX_WRITER_Class_t *RxWriter, RX_WRITER_Stream_t *Stream, uint8 StreamIdx);
+static int64 NowUsec(void);
+static void  QueueFill(RX_WRITER_Class_t *RxWriter, RX_WRITER_Stream_t *Stream);
+static void  WriteBlock(RX_WRITER_Class_t *RxWriter, RX_WRITER_Block_t *Block);
+
+
+/******************************************************************************
+** Function: RX_WRITER_Constructor
+**
+*/
+void RX_WRITER_Constructor(RX_WRITER_Class_t *RxWriter, INITBL_Class_t *IniTbl)
+{
+
+   int32 SysStatus;
+   const char *SemName = INITBL_GetStrConfig(IniTbl, CFG_RX_WRITER_CHILD_SEM_NAME);
+   uint16 i;
+
+   memset(RxWriter, 0, sizeof(RX_WRITER_Class_t));
+
+   for (i=0; i < RX_WRITER_STREAM_CNT; i++)
+   {
+      atomic_init(&RxWriter->Stream[i].Open, false);
+      atomic_init(&RxWriter->Stream[i].Closing, false);
+   }
+
+   RxWriter->BlockCnt = INITBL_GetIntConfig(IniTbl, CFG_RX_WRITER_BLOCK_CNT);
+   RxWriter->FlushMs  = INITBL_GetIntConfig(IniTbl, CFG_RX_WRITER_FLUSH_MS);
+   if (RxWriter->BlockCnt < 2 || RxWriter->BlockCnt > RX_WRITER_MAX_BLOCKS)
+   {
+      CFE_EVS_SendEvent(RX_WRITER_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Invalid RX_WRITER_BLOCK_CNT %u, must be 2 to %u, using %u",
+                        RxWriter->BlockCnt, RX_WRITER_MAX_BLOCKS, RX_WRITER_MAX_BLOCKS);
+      RxWriter->BlockCnt = RX_WRITER_MAX_BLOCKS;
+   }
+
+   for (i=0; i < RxWriter->BlockCnt; i++)
+   {
+      RxWriter->Free[i] = &RxWriter->Block[i];
+   }
+   RxWriter->FreeCnt = RxWriter->BlockCnt;
+
+   SysStatus = OS_MutSemCreate(&RxWriter->MutexId, RX_WRITER_MUTEX_NAME, 0);
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(RX_WRITER_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating Rx writer mutex %s, Status = %d", RX_WRITER_MUTEX_NAME, SysStatus);
+   }
+
+   SysStatus = OS_CountSemCreate(&RxWriter->WakeUpSemaphore, SemName, 0, 0);
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(RX_WRITER_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Rx writer child error creating semaphore %s, Status = %d", SemName, SysStatus);
+   }
+
+   CFE_MSG_Init(CFE_MSG_PTR(RxWriter->RxWriterTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_LORA_RX_WRITER_TLM_TOPICID)), sizeof(LORA_RxWriterTlm_t));
+
+} /* End RX_WRITER_Constructor() */
+
+
+/******************************************************************************
+** Function: RX_WRITER_ChildTask
+**
+** Notes:
+**   1. Returning false causes the child task to terminate.
+**   2. One block is written for each semaphore count. A close gives the
+**      semaphore too so it's handled even when the stream had no data.
+**
+*/
+bool RX_WRITER_ChildTask(RX_WRITER_Class_t *RxWriter)
+{
+
+   RX_WRITER_Block_t *Block;
+
+   RxWriter->RunStatus = CFE_SUCCESS;
+
+   while (RxWriter->RunStatus == CFE_SUCCESS)
+   {
+
+      RxWriter->RunStatus = OS_CountSemTake(RxWriter->WakeUpSemaphore);
+
+      if (RxWriter->RunStatus == OS_SUCCESS)
+      {
+
+         Block = NULL;
+
+         OS_MutSemTake(RxWriter->MutexId);
+         if (RxWriter->QueueLen > 0)
+         {
+            Block = RxWriter->Queue[RxWriter->QueueHead];
+            RxWriter->QueueHead = (RxWriter->QueueHead + 1) % RX_WRITER_MAX_BLOCKS;
+            RxWriter->QueueLen--;
+         }
+         OS_MutSemGive(RxWriter->MutexId);
+
+         if (Block != NULL)
+         {
+            WriteBlock(RxWriter, Block);
+         }
+
+         CloseStreams(RxWriter);
+
+      }
+
+   }
+
+   CFE_EVS_SendEvent(RX_WRITER_CHILD_TASK_EID, CFE_EVS_EventType_ERROR,
+                     "Rx writer child task terminating, semaphore status = %d", RxWriter->RunStatus);
+
+   return false;
+
+} /* End RX_WRITER_ChildTask() */
+
+
+/******************************************************************************
+** Function: RX_WRITER_Open
+**
+*/
+bool RX_WRITER_Open(RX_WRITER_Class_t *RxWriter, uint8 StreamIdx, const char *Path)
+{
+
+   RX_WRITER_Stream_t *Stream = &RxWriter->Stream[StreamIdx];
+   int32 SysStatus;
+
+   if (atomic_load_explicit(&Stream->Open, memory_order_acquire))
+   {
+      CFE_EVS_SendEvent(RX_WRITER_FILE_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating %s, the writer is still writing %s", Path, Stream->Path);
+      return false;
+   }
+
+   SysStatus = OS_OpenCreate(&Stream->FileHandle, Path, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_WRITE_ONLY);
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(RX_WRITER_FILE_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating receive file %s, Status = %d", Path, SysStatus);
+      return false;
+   }
+
+   strncpy(Stream->Path, Path, OS_MAX_PATH_LEN-1);
+   Stream->Fill    = NULL;
+   Stream->FilePos = 0;
+   atomic_store_explicit(&Stream->Closing, false, memory_order_relaxed);
+   atomic_store_explicit(&Stream->Open, true, memory_order_release);
+
+   return true;
+
+} /* End RX_WRITER_Open() */
+
+
+/******************************************************************************
+** Function: RX_WRITER_Write
+**
+** Notes:
+**   1. Data that crosses an RX_WRITER_BLOCK_LEN file offset is split there
+**      so the next block starts aligned.
+**
+*/
+bool RX_WRITER_Write(RX_WRITER_Class_t *RxWriter, uint8 StreamIdx, uint32 Offset,
+                     const uint8 *Data, uint16 Len)
+{
+
+   RX_WRITER_Stream_t *Stream = &RxWriter->Stream[StreamIdx];
+   RX_WRITER_Block_t  *Fill;
+   RX_WRITER_Run_t    *Run;
+   bool   FirstDrop;
+   uint16 Room;
+   uint16 Chunk;
+
+   while (Len > 0)
+   {
+
+      if (Stream->Fill == NULL && !FillBlock(RxWriter, Stream, StreamIdx))
+      {
+         OS_MutSemTake(RxWriter->MutexId);
+         FirstDrop = (RxWriter->DropByteCnt == 0);
+         RxWriter->DropByteCnt += Len;
+         OS_MutSemGive(RxWriter->MutexId);
+         if (FirstDrop)
+         {
+            CFE_EVS_SendEvent(RX_WRITER_DROP_EID, CFE_EVS_EventType_ERROR,
+                              "Rx writer has no free block, dropping %s data. Storage is slower than the link",
+                              Stream->Path);
+         }
+         return false;
+      }
+      Fill = Stream->Fill;
+      Run  = (Fill->RunCnt > 0) ? &Fill->Run[Fill->RunCnt-1] : NULL;
+
+      if (Run == NULL || Offset != Run->Offset + Run->Len)
+      {
+         if (Fill->RunCnt == RX_WRITER_MAX_RUNS)
+         {
+            QueueFill(RxWriter, Stream);
+            continue;
+         }
+         Run = &Fill->Run[Fill->RunCnt++];
+         Run->Offset = Offset;
+         Run->Len    = 0;
+      }
+
+      Room  = RX_WRITER_BLOCK_LEN - Fill->DataLen;
+      Chunk = RX_WRITER_BLOCK_LEN - (Offset % RX_WRITER_BLOCK_LEN);
+      if (Chunk > Room)
+      {
+         Chunk = Room;
+      }
+      if (Chunk > Len)
+      {
+         Chunk = Len;
+      }
+
+      memcpy(&Fill->Data[Fill->DataLen], Data, Chunk);
+      Fill->DataLen += Chunk;
+      Run->Len      += Chunk;
+      Offset += Chunk;
+      Data   += Chunk;
+      Len    -= Chunk;
+
+      if (Fill->DataLen == RX_WRITER_BLOCK_LEN || (Offset % RX_WRITER_BLOCK_LEN) == 0)
+      {
+         QueueFill(RxWriter, Stream);
+      }
+
+   } /* End while data */
+
+   RX_WRITER_Poll(RxWriter, StreamIdx);
+
+   return true;
+
+} /* End RX_WRITER_Write() */
+
+
+/******************************************************************************
+** Function: RX_WRITER_Poll
+**
+*/
+void RX_WRITER_Poll(RX_WRITER_Class_t *RxWriter, uint8 StreamIdx)
+{
+
+   RX_WRITER_Stream_t *Stream = &RxWriter->Stream[StreamIdx];
+
+   if (Stream->Fill != NULL && (NowUsec() - Stream->Fill->StartUsec) >= (int64)RxWriter->FlushMs * 1000)
+   {
+      QueueFill(RxWriter, Stream);
+   }
+
+} /* End RX_WRITER_Poll() */
+
+
+/******************************************************************************
+** Function: RX_WRITER_Close
+**
+*/
+void RX_WRITER_Close(RX_WRITER_Class_t *RxWriter, uint8 StreamIdx)
+{
+
+   RX_WRITER_Stream_t *Stream = &RxWriter->Stream[StreamIdx];
+
+   if (!atomic_load_explicit(&Stream->Open, memory_order_relaxed))
+   {
+      return;
+   }
+
+   if (Stream->Fill != NULL)
+   {
+      QueueFill(RxWriter, Stream);
+   }
+
+   atomic_store_explicit(&Stream->Closing, true, memory_order_release);
+   OS_CountSemGive(RxWriter->WakeUpSemaphore);
+
+} /* End RX_WRITER_Close() */
+
+
+/******************************************************************************
+** Function: RX_WRITER_ResetStatus
+**
+*/
+void RX_WRITER_ResetStatus(RX_WRITER_Class_t *RxWriter)
+{
+
+   OS_MutSemTake(RxWriter->MutexId);
+
+   RxWriter->QueuePeak   = RxWriter->QueueLen;
+   RxWriter->WriteCnt    = 0;
+   RxWriter->ByteCnt     = 0;
+   RxWriter->DropByteCnt = 0;
+   RxWriter->ErrCnt      = 0;
+   RxWriter->MaxLagMs    = 0;
+   RxWriter->MaxWriteMs  = 0;
+
+   OS_MutSemGive(RxWriter->MutexId);
+
+} /* End RX_WRITER_ResetStatus() */
+
+
+/******************************************************************************
+** Function: RX_WRITER_SendTlmCmd
+**
+*/
+bool RX_WRITER_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   RX_WRITER_Class_t *RxWriter = (RX_WRITER_Class_t *)ObjDataPtr;
+   LORA_RxWriterTlm_Payload_t *Payload = &RxWriter->RxWriterTlm.Payload;
+   uint16 i;
+
+   Payload->OpenCnt = 0;
+   for (i=0; i < RX_WRITER_STREAM_CNT; i++)
+   {
+      if (atomic_load_explicit(&RxWriter->Stream[i].Open, memory_order_relaxed))
+      {
+         Payload->OpenCnt++;
+      }
+   }
+
+   OS_MutSemTake(RxWriter->MutexId);
+
+   Payload->BlockCnt      = RxWriter->BlockCnt;
+   Payload->FreeCnt       = RxWriter->FreeCnt;
+   Payload->QueueLen      = RxWriter->QueueLen;
+   Payload->QueuePeak     = RxWriter->QueuePeak;
+   Payload->QueuedByteCnt = RxWriter->QueuedByteCnt;
+   Payload->WriteCnt      = RxWriter->WriteCnt;
+   Payload->ByteCnt       = RxWriter->ByteCnt;
+   Payload->DropByteCnt   = RxWriter->DropByteCnt;
+   Payload->ErrCnt        = RxWriter->ErrCnt;
+   Payload->LastLagMs     = RxWriter->LastLagMs;
+   Payload->MaxLagMs      = RxWriter->MaxLagMs;
+   Payload->MaxWriteMs    = RxWriter->MaxWriteMs;
+
+   OS_MutSemGive(RxWriter->MutexId);
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(RxWriter->RxWriterTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(RxWriter->RxWriterTlm.TelemetryHeader), true);
+
+   return true;
+
+} /* End RX_WRITER_SendTlmCmd() */
+
+
+/******************************************************************************
+** Function: CloseStreams
+**
+** Close the files of closing streams that have no blocks left in the queue
+**
+*/
+static void CloseStreams(RX_WRITER_Class_t *RxWriter)
+{
+
+   RX_WRITER_Stream_t *Stream;
+   bool   Queued;
+   uint16 i;
+   uint16 j;
+
+   for (i=0; i < RX_WRITER_STREAM_CNT; i++)
+   {
+
+      Stream = &RxWriter->Stream[i];
+      if (!atomic_load_explicit(&Stream->Closing, memory_order_acquire))
+      {
+         continue;
+      }
+
+      Queued = false;
+      OS_MutSemTake(RxWriter->MutexId);
+      for (j=0; j < RxWriter->QueueLen; j++)
+      {
+         if (RxWriter->Queue[(RxWriter->QueueHead + j) % RX_WRITER_MAX_BLOCKS]->Stream == i)
+         {
+            Queued = true;
+            break;
+         }
+      }
+      OS_MutSemGive(RxWriter->MutexId);
+
+      if (!Queued)
+      {
+         OS_close(Stream->FileHandle);
+         atomic_store_explicit(&Stream->Closing, false, memory_order_relaxed);
+         atomic_store_explicit(&Stream->Open, false, memory_order_release);
+      }
+
+   } /* End stream loop */
+
+} /* End CloseStreams() */
+
+
+/******************************************************************************
+** Function: FillBlock
+**
+** Take a free block for the stream to fill, returns false if none is free
+**
+*/
+static bool FillBlock(RX_WRITER_Class_t *RxWriter, RX_WRITER_Stream_t *Stream, uint8 StreamIdx)
+{
+
+   RX_WRITER_Block_t *Block = NULL;
+
+   OS_MutSemTake(RxWriter->MutexId);
+   if (RxWriter->FreeCnt > 0)
+   {
+      Block = RxWriter->Free[--RxWriter->FreeCnt];
+   }
+   OS_MutSemGive(RxWriter->MutexId);
+
+   if (Block == NULL)
+   {
+      return false;
+   }
+
+   Block->Stream    = StreamIdx;
+   Block->RunCnt    = 0;
+   Block->DataLen   = 0;
+   Block->StartUsec = NowUsec();
+   Stream->Fill     = Block;
+
+   return true;
+
+} /* End FillBlock() */
+
+
+/******************************************************************************
+** Function: NowUsec
+**
+*/
+static int64 NowUsec(void)
+{
+
+   OS_time_t Now;
+
+   OS_GetLocalTime(&Now);
+
+   return OS_TimeGetTotalMicroseconds(Now);
+
+} /* End NowUsec() */
+
+
+/******************************************************************************
+** Function: QueueFill
+**
+** Queue the stream's fill block for the writer
+**
+*/
+static void QueueFill(RX_WRITER_Class_t *RxWriter, RX_WRITER_Stream_t *Stream)
+{
+
+   RX_WRITER_Block_t *Block = Stream->Fill;
+
+   Stream->Fill = NULL;
+
+   OS_MutSemTake(RxWriter->MutexId);
+
+   RxWriter->Queue[(RxWriter->QueueHead + RxWriter->QueueLen) % RX_WRITER_MAX_BLOCKS] = Block;
+   RxWriter->QueueLen++;
+   RxWriter->QueuedByteCnt += Block->DataLen;
+   if (RxWriter->QueueLen > RxWriter->QueuePeak)
+   {
+      RxWriter->QueuePeak = RxWriter->QueueLen;
+   }
+
+   OS_MutSemGive(RxWriter->MutexId);
+
+   OS_CountSemGive(RxWriter->WakeUpSemaphore);
+
+} /* End QueueFill() */
+
+
+/******************************************************************************
+** Function: WriteBlock
+**
+** Write a block's runs and return it to the free list
+**
+*/
+static void WriteBlock(RX_WRITER_Class_t *RxWriter, RX_WRITER_Block_t *Block)
+{
+
+   RX_WRITER_Stream_t *Stream = &RxWriter->Stream[Block->Stream];
+   const uint8 *Data = Block->Data;
+   int64  StartUsec = NowUsec();
+   int64  EndUsec;
+   uint32 ErrCnt = 0;
+   uint32 LagMs;
+   uint32 WriteMs;
+   uint16 i;
+
+   for (i=0; i < Block->RunCnt; i++)
+   {
+      if (Block->Run[i].Offset != Stream->FilePos)
+      {
+         OS_lseek(Stream->FileHandle, Block->Run[i].Offset, OS_SEEK_SET);
+      }
+      if (OS_write(Stream->FileHandle, Data, Block->Run[i].Len) == Block->Run[i].Len)
+      {
+         Stream->FilePos = Block->Run[i].Offset + Block->Run[i].Len;
+      }
+      else
+      {
+         Stream->FilePos = UINT32_MAX;   /* Position unknown, seek next time */
+         ErrCnt++;
+      }
+      Data += Block->Run[i].Len;
+   }
+
+   EndUsec = NowUsec();
+   LagMs   = (uint32)((EndUsec - Block->StartUsec) / 1000);
+   WriteMs = (uint32)((EndUsec - StartUsec) / 1000);
+
+   if (ErrCnt > 0)
+   {
+      CFE_EVS_SendEvent(RX_WRITER_FILE_EID, CFE_EVS_EventType_ERROR,
+                        "Error writing %u of %u runs to %s", ErrCnt, Block->RunCnt, Stream->Path);
+   }
+
+   OS_MutSemTake(RxWriter->MutexId);
+
+   RxWriter->QueuedByteCnt -= Block->DataLen;
+   RxWriter->WriteCnt++;
+   RxWriter->ByteCnt += Block->DataLen;
+   RxWriter->ErrCnt  += ErrCnt;
+   RxWriter->LastLagMs = LagMs;
+   if (LagMs > RxWriter->MaxLagMs)
+   {
+      RxWriter->MaxLagMs = LagMs;
+   }
+   if (WriteMs > RxWriter->MaxWriteMs)
+   {
+      RxWriter->MaxWriteMs = WriteMs;
+   }
+   RxWriter->Free[RxWriter->FreeCnt++] = Block;
+
+   OS_MutSemGive(RxWriter->MutexId);
+
+} /* End WriteBlock() */
@@ -0,0 +1,261 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the received file writer class
+**
+**  Notes:
+**    1. The Rx tasks don't write received files themselves, an SD card
+**       write can stall for hundreds of milliseconds while the card
+**       collects garbage and frames arriving meanwhile would be missed.
+**       An Rx task copies received data into a block and the writer child
+**       task writes full blocks, so the radio path never waits on storage.
+**    2. Each open file is a stream with a fill block owned by its producer.
+**       Contiguous writes extend the block's last run, other writes start a
+**       new run. The block is queued when it's full, when its data reaches
+**       an RX_WRITER_BLOCK_LEN file offset so a steady transfer is written
+**       in whole aligned blocks, or when it's been filling for
+**       RX_WRITER_FLUSH_MS.
+**    3. RX_WRITER_BLOCK_CNT blocks are shared by the streams. When none is
+**       free the data is dropped and counted rather than waiting for the
+**       writer, the transfer's packet accounting sees it as lost.
+**    4. The writer only seeks when a run doesn't start where the last one
+**       ended. OSAL has no fsync so the flush interval bounds how long
+**       received data stays in memory.
+**    5. A stream has one producer at a time, striped radios write through
+**       the stripe object's mutex. The block queue's mutex is only held to
+**       move a block, never during a write.
+**    6. Closing a stream queues its fill block, the writer closes the file
+**       once the stream's queued blocks are written. A stream can't be
+**       reopened until then.
+**
+*/
+
+#ifndef _rx_writer_
+#define _rx_writer_
+
+/*
+** Includes
+*/
+
+#include <stdatomic.h>
+#include "app_cfg.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define RX_WRITER_BLOCK_LEN    4096
+#define RX_WRITER_MAX_BLOCKS   32
+#define RX_WRITER_MAX_RUNS     16     /* Separate file ranges in a block */
+#define RX_WRITER_STREAM_CNT   (LORA_RADIO_MAX + 1)
+#define RX_WRITER_STRIPE       LORA_RADIO_MAX   /* Stream of the striped receive file, radio n uses stream n */
+
+
+/*
+** Event Message IDs
+*/
+
+#define RX_WRITER_CONSTRUCTOR_EID  (RX_WRITER_BASE_EID + 0)
+#define RX_WRITER_CHILD_TASK_EID   (RX_WRITER_BASE_EID + 1)
+#define RX_WRITER_FILE_EID         (RX_WRITER_BASE_EID + 2)
+#define RX_WRITER_DROP_EID         (RX_WRITER_BASE_EID + 3)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+
+typedef struct
+{
+
+   uint32  Offset;
+   uint16  Len;
+
+} RX_WRITER_Run_t;
+
+
+typedef struct
+{
+
+   uint8   Stream;
+   uint16  RunCnt;
+   uint16  DataLen;
+   int64   StartUsec;     /* First data copied in, the writer lag is measured from here */
+   RX_WRITER_Run_t Run[RX_WRITER_MAX_RUNS];
+   uint8   Data[RX_WRITER_BLOCK_LEN];
+
+} RX_WRITER_Block_t;
+
+
+typedef struct
+{
+
+   atomic_bool  Open;          /* Cleared by the writer when the file is closed */
+   atomic_bool  Closing;
+   osal_id_t    FileHandle;
+   char         Path[OS_MAX_PATH_LEN];
+
+   /* Producer */
+   RX_WRITER_Block_t *Fill;
+
+   /* Writer task */
+   uint32       FilePos;
+
+} RX_WRITER_Stream_t;
+
+
+/******************************************************************************
+** RX_WRITER_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Telemetry Packets
+   */
+
+   LORA_RxWriterTlm_t  RxWriterTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   int32      RunStatus;
+   osal_id_t  WakeUpSemaphore;   /* Given for each queued block and close */
+   osal_id_t  MutexId;           /* Protects the free list, the queue and the counters */
+   uint16     BlockCnt;
+   uint32     FlushMs;
+
+   uint16     FreeCnt;
+   uint16     QueueHead;
+   uint16     QueueLen;
+   uint16     QueuePeak;
+   RX_WRITER_Block_t *Free[RX_WRITER_MAX_BLOCKS];
+   RX_WRITER_Block_t *Queue[RX_WRITER_MAX_BLOCKS];
+
+   uint32     QueuedByteCnt;     /* Bytes queued or being written */
+   uint32     WriteCnt;
+   uint32     ByteCnt;
+   uint32     DropByteCnt;
+   uint32     ErrCnt;
+   uint32     LastLagMs;         /* Time from a block's first data to its write */
+   uint32     MaxLagMs;
+   uint32     MaxWriteMs;
+
+   RX_WRITER_Stream_t Stream[RX_WRITER_STREAM_CNT];
+   RX_WRITER_Block_t  Block[RX_WRITER_MAX_BLOCKS];
+
+} RX_WRITER_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: RX_WRITER_Constructor
+**
+** Initialize the writer to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void RX_WRITER_Constructor(RX_WRITER_Class_t *RxWriter, INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: RX_WRITER_ChildTask
+**
+** Notes:
+**   1. Called by the app's child manager callback.
+**
+*/
+bool RX_WRITER_ChildTask(RX_WRITER_Class_t *RxWriter);
+
+
+/******************************************************************************
+** Function: RX_WRITER_Open
+**
+** Create a stream's file
+**
+** Notes:
+**   1. Called before a transfer starts, not from the receive loop.
+**   2. Returns false if the file can't be created or the stream's last
+**      file hasn't been closed by the writer yet.
+**
+*/
+bool RX_WRITER_Open(RX_WRITER_Class_t *RxWriter, uint8 Stream, const char *Path);
+
+
+/******************************************************************************
+** Function: RX_WRITER_Write
+**
+** Copy data to be written at a file offset
+**
+** Notes:
+**   1. Never waits for storage. Returns false if the data was dropped.
+**
+*/
+bool RX_WRITER_Write(RX_WRITER_Class_t *RxWriter, uint8 Stream, uint32 Offset,
+                     const uint8 *Data, uint16 Len);
+
+
+/******************************************************************************
+** Function: RX_WRITER_Poll
+**
+** Queue the stream's fill block if it's been filling for RX_WRITER_FLUSH_MS
+**
+** Notes:
+**   1. Called by the producer when it's idle, for example on a receive
+**      timeout.
+**
+*/
+void RX_WRITER_Poll(RX_WRITER_Class_t *RxWriter, uint8 Stream);
+
+
+/******************************************************************************
+** Function: RX_WRITER_Close
+**
+** Queue the stream's fill block and close the file once it's written
+**
+*/
+void RX_WRITER_Close(RX_WRITER_Class_t *RxWriter, uint8 Stream);
+
+
+/******************************************************************************
+** Function: RX_WRITER_ResetStatus
+**
+*/
+void RX_WRITER_ResetStatus(RX_WRITER_Class_t *RxWriter);
+
+
+/******************************************************************************
+** Function: RX_WRITER_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**
+*/
+bool RX_WRITER_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _rx_writer_ */
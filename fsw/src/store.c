@@ -0,0 +1,982 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the store-and-forward queue for bridged messages
+**
+**  Notes:
+**    1. The segments are a ring of slots from the oldest to the newest. A
+**       deleted segment's slot is reused once the oldest slot reaches it.
+**    2. A record that's still in the write buffer is replayed from the
+**       buffer so a replay never forces a small write.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "store.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define STORE_FILE_PREFIX  "lora_store_"
+#define STORE_FILE_SUFFIX  ".dat"
+#define STORE_REC_SYNC     0xA5
+
+#define STORE_REC_PENDING   0x00
+#define STORE_REC_INFLIGHT  0x40
+#define STORE_REC_DONE      0x80
+#define STORE_REC_STATE     0xC0
+#define STORE_REC_RANK      0x03
+
+#define STORE_MAX_DIR_FILES (2*STORE_MAX_SEGMENTS)
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void   AckRecord(STORE_Class_t *Store, const STORE_InFlight_t *InFlight);
+static void   DeleteSegment(STORE_Class_t *Store, uint16 Slot);
+static void   DropRecord(STORE_Class_t *Store, uint16 Slot, uint16 Rec);
+static void   FileError(STORE_Class_t *Store, const char *Op, uint32 Num, int32 Status);
+static int16  FindSlot(const STORE_Class_t *Store, uint32 Num);
+static void   Load(STORE_Class_t *Store);
+static void   LoadSegment(STORE_Class_t *Store, uint32 Num);
+static uint16 NewestSlot(const STORE_Class_t *Store);
+static int64  NowUsec(void);
+static void   ProcessAck(STORE_Class_t *Store, uint16 Seq, int64 Now);
+static bool   ReadRecord(STORE_Class_t *Store, uint16 Slot, uint16 Rec, uint8 *Msg, uint16 *MsgLen);
+static bool   Rotate(STORE_Class_t *Store);
+static void   SegPath(const STORE_Class_t *Store, uint32 Num, char *Path);
+
+
+/******************************************************************************
+** Function: STORE_Constructor
+**
+*/
+void STORE_Constructor(STORE_Class_t *Store, INITBL_Class_t *IniTbl)
+{
+
+   memset(Store, 0, sizeof(STORE_Class_t));
+
+   atomic_init(&Store->AckCnt, 0);
+   atomic_init(&Store->AckSeq, 0);
+
+   strncpy(Store->Dir, INITBL_GetStrConfig(IniTbl, CFG_STORE_DIR), OS_MAX_PATH_LEN-1);
+   Store->SegmentCnt    = INITBL_GetIntConfig(IniTbl, CFG_STORE_SEGMENT_CNT);
+   Store->SyncCnt       = INITBL_GetIntConfig(IniTbl, CFG_STORE_SYNC_CNT);
+   Store->SyncMs        = INITBL_GetIntConfig(IniTbl, CFG_STORE_SYNC_MS);
+   Store->AckTimeoutMs  = INITBL_GetIntConfig(IniTbl, CFG_STORE_ACK_TIMEOUT_MS);
+   Store->LinkTimeoutMs = INITBL_GetIntConfig(IniTbl, CFG_STORE_LINK_TIMEOUT_MS);
+
+   if (Store->SegmentCnt > STORE_MAX_SEGMENTS)
+   {
+      CFE_EVS_SendEvent(STORE_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "STORE_SEGMENT_CNT %u is more than the maximum %u, using %u",
+                        Store->SegmentCnt, STORE_MAX_SEGMENTS, STORE_MAX_SEGMENTS);
+      Store->SegmentCnt = STORE_MAX_SEGMENTS;
+   }
+   if (Store->SyncCnt == 0)
+   {
+      Store->SyncCnt = 1;
+   }
+
+   Store->AckedSeq  = 0;
+   Store->NextSeq   = 1;
+   Store->ResendSeq = 1;
+   Store->NextNum   = 1;
+
+   CFE_MSG_Init(CFE_MSG_PTR(Store->StoreTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_LORA_STORE_TLM_TOPICID)), sizeof(LORA_StoreTlm_t));
+
+   if (Store->SegmentCnt > 0)
+   {
+      Store->Enabled = true;
+      Load(Store);
+   }
+
+} /* End STORE_Constructor() */
+
+
+/******************************************************************************
+** Function: STORE_Poll
+**
+*/
+bool STORE_Poll(STORE_Class_t *Store)
+{
+
+   int64  Now;
+   uint32 AckCnt;
+
+   if (!Store->Enabled)
+   {
+      return true;
+   }
+
+   Now    = NowUsec();
+   AckCnt = atomic_load_explicit(&Store->AckCnt, memory_order_acquire);
+
+   if (AckCnt != Store->LastAckCnt)
+   {
+
+      Store->LastAckCnt  = AckCnt;
+      Store->LastAckUsec = Now;
+      ProcessAck(Store, (uint16)atomic_load_explicit(&Store->AckSeq, memory_order_relaxed), Now);
+
+      if (!Store->LinkUp)
+      {
+         Store->LinkUp       = true;
+         Store->ResendSeq    = Store->AckedSeq + 1;
+         Store->ProgressUsec = Now;
+         CFE_EVS_SendEvent(STORE_LINK_EID, CFE_EVS_EventType_INFORMATION,
+                           "Store link up, %u records to replay and %u to resend",
+                           Store->PendingCnt, (uint16)(Store->NextSeq - Store->ResendSeq));
+      }
+
+   }
+   else if (Store->LinkUp && (Now - Store->LastAckUsec) > (int64)Store->LinkTimeoutMs * 1000)
+   {
+      Store->LinkUp = false;
+      CFE_EVS_SendEvent(STORE_LINK_EID, CFE_EVS_EventType_INFORMATION,
+                        "Store link down, no ack for %u ms", Store->LinkTimeoutMs);
+   }
+
+   if (Store->LinkUp && Store->ResendSeq == Store->NextSeq &&
+       (uint16)(Store->NextSeq - Store->AckedSeq - 1) > 0 &&
+       (Now - Store->ProgressUsec) > (int64)Store->AckTimeoutMs * 1000)
+   {
+      Store->ResendSeq    = Store->AckedSeq + 1;
+      Store->ProgressUsec = Now;
+   }
+
+   if (Store->WriteBufRecCnt > 0 && (Now - Store->WriteBufUsec) >= (int64)Store->SyncMs * 1000)
+   {
+      STORE_Flush(Store);
+   }
+
+   return Store->LinkUp;
+
+} /* End STORE_Poll() */
+
+
+/******************************************************************************
+** Function: STORE_Append
+**
+*/
+bool STORE_Append(STORE_Class_t *Store, uint8 Rank, const uint8 *Msg, uint16 MsgLen)
+{
+
+   STORE_Segment_t *Seg;
+   uint8  *Rec;
+   uint16 RecLen = STORE_REC_HDR_LEN + MsgLen;
+
+   if (!Store->Enabled || Rank >= STORE_MAX_RANK || MsgLen > STORE_MAX_MSG_LEN)
+   {
+      return false;
+   }
+
+   Seg = &Store->Seg[NewestSlot(Store)];
+   if (!Store->WriteOpen || (Seg->Len + RecLen) > STORE_SEGMENT_LEN || Seg->RecCnt >= STORE_MAX_SEG_RECORDS)
+   {
+      if (!Rotate(Store))
+      {
+         Store->DroppedCnt++;
+         return false;
+      }
+      Seg = &Store->Seg[NewestSlot(Store)];
+   }
+
+   if ((Store->WriteBufLen + RecLen) > STORE_WRITE_BUF_LEN)
+   {
+      STORE_Flush(Store);
+   }
+   if (Store->WriteBufRecCnt == 0)
+   {
+      Store->WriteBufUsec = NowUsec();
+   }
+
+   Rec = &Store->WriteBuf[Store->WriteBufLen];
+   Rec[0] = STORE_REC_SYNC;
+   Rec[1] = Rank;
+   Rec[2] = (uint8)(MsgLen >> 8);
+   Rec[3] = (uint8)MsgLen;
+   memcpy(&Rec[STORE_REC_HDR_LEN], Msg, MsgLen);
+   Store->WriteBufLen += RecLen;
+   Store->WriteBufRecCnt++;
+
+   Seg->RecOffset[Seg->RecCnt] = (uint16)Seg->Len;
+   Seg->RecState[Seg->RecCnt]  = STORE_REC_PENDING | Rank;
+   Seg->RecCnt++;
+   Seg->PendingCnt[Rank]++;
+   Seg->Len += RecLen;
+   Store->PendingCnt++;
+   Store->StoredCnt++;
+
+   if (Store->WriteBufRecCnt >= Store->SyncCnt)
+   {
+      STORE_Flush(Store);
+   }
+
+   return true;
+
+} /* End STORE_Append() */
+
+
+/******************************************************************************
+** Function: STORE_NextRank
+**
+*/
+int16 STORE_NextRank(STORE_Class_t *Store)
+{
+
+   uint16 Rank;
+   uint16 i;
+
+   if (!Store->Enabled || !Store->LinkUp)
+   {
+      return -1;
+   }
+   if (Store->ResendSeq != Store->NextSeq)
+   {
+      return 0;
+   }
+   if (Store->PendingCnt == 0 || (uint16)(Store->NextSeq - Store->AckedSeq - 1) >= STORE_WINDOW)
+   {
+      return -1;
+   }
+
+   for (Rank=0; Rank < STORE_MAX_RANK; Rank++)
+   {
+      for (i=0; i < Store->SlotCnt; i++)
+      {
+         if (Store->Seg[(Store->OldestSlot + i) % Store->SegmentCnt].PendingCnt[Rank] > 0)
+         {
+            return Rank;
+         }
+      }
+   }
+
+   return -1;
+
+} /* End STORE_NextRank() */
+
+
+/******************************************************************************
+** Function: STORE_NextReplay
+**
+** Notes:
+**   1. A pending record that can't be read is dropped and the next one is
+**      tried. An in flight record that can't be read still uses its
+**      sequence number, the receiver stalls until its bridge is restarted.
+**
+*/
+bool STORE_NextReplay(STORE_Class_t *Store, uint8 *Msg, uint16 *MsgLen, uint16 *Seq, bool *Resend)
+{
+
+   STORE_InFlight_t *InFlight;
+   STORE_Segment_t  *Seg = NULL;
+   int16  Slot = 0;
+   int16  Rank;
+   uint16 i;
+   uint16 Rec;
+
+   if (Store->ResendSeq != Store->NextSeq)
+   {
+
+      InFlight = &Store->InFlight[Store->ResendSeq & (STORE_WINDOW-1)];
+      *Seq     = Store->ResendSeq++;
+      *Resend  = true;
+
+      Slot = FindSlot(Store, InFlight->Num);
+      if (Slot >= 0 && ReadRecord(Store, Slot, InFlight->Rec, Msg, MsgLen))
+      {
+         Store->ResendCnt++;
+         return true;
+      }
+      return false;
+
+   }
+
+   while ((Rank = STORE_NextRank(Store)) >= 0)
+   {
+
+      for (i=0; i < Store->SlotCnt; i++)
+      {
+         Slot = (Store->OldestSlot + i) % Store->SegmentCnt;
+         Seg  = &Store->Seg[Slot];
+         if (Seg->InUse && Seg->PendingCnt[Rank] > 0)
+         {
+            break;
+         }
+      }
+
+      for (Rec = Seg->NextRec[Rank]; Rec < Seg->RecCnt; Rec++)
+      {
+         if (Seg->RecState[Rec] == (STORE_REC_PENDING | Rank))
+         {
+            break;
+         }
+      }
+      Seg->NextRec[Rank] = Rec + 1;
+
+      if (!ReadRecord(Store, Slot, Rec, Msg, MsgLen))
+      {
+         DropRecord(Store, Slot, Rec);
+         continue;
+      }
+
+      Seg->RecState[Rec] = STORE_REC_INFLIGHT | Rank;
+      Seg->PendingCnt[Rank]--;
+      Seg->InFlightCnt++;
+      Store->PendingCnt--;
+      Store->ReplayedCnt++;
+
+      InFlight = &Store->InFlight[Store->NextSeq & (STORE_WINDOW-1)];
+      InFlight->Num = Seg->Num;
+      InFlight->Rec = Rec;
+      *Seq    = Store->NextSeq++;
+      *Resend = false;
+      Store->ResendSeq = Store->NextSeq;
+      if ((uint16)(Store->NextSeq - Store->AckedSeq - 1) == 1)
+      {
+         Store->ProgressUsec = NowUsec();
+      }
+
+      return true;
+
+   } /* End while pending */
+
+   return false;
+
+} /* End STORE_NextReplay() */
+
+
+/******************************************************************************
+** Function: STORE_Flush
+**
+*/
+void STORE_Flush(STORE_Class_t *Store)
+{
+
+   int32 Status;
+
+   if (Store->WriteBufLen == 0)
+   {
+      return;
+   }
+
+   Status = OS_write(Store->WriteFd, Store->WriteBuf, Store->WriteBufLen);
+   if (Status != Store->WriteBufLen)
+   {
+      FileError(Store, "write", Store->Seg[NewestSlot(Store)].Num, Status);
+   }
+
+   Store->WriteCnt++;
+   Store->WriteBufLen    = 0;
+   Store->WriteBufRecCnt = 0;
+
+} /* End STORE_Flush() */
+
+
+/******************************************************************************
+** Function: STORE_RecordRx
+**
+*/
+void STORE_RecordRx(STORE_Class_t *Store, uint16 Seq)
+{
+
+   Store->RxSeq = Seq;
+
+} /* End STORE_RecordRx() */
+
+
+/******************************************************************************
+** Function: STORE_AckCmd
+**
+** Notes:
+**   1. No event is sent, the ground sends an ack every few seconds during
+**      a contact.
+**
+*/
+bool STORE_AckCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   STORE_Class_t *Store = (STORE_Class_t *)ObjDataPtr;
+   const LORA_AckStore_CmdPayload_t *Cmd = CMDMGR_PAYLOAD_PTR(MsgPtr, LORA_AckStore_t);
+
+   if (!Store->Enabled)
+   {
+      CFE_EVS_SendEvent(STORE_ACK_EID, CFE_EVS_EventType_ERROR,
+                        "Store ack ignored, the store is disabled");
+      return false;
+   }
+
+   atomic_store_explicit(&Store->AckSeq, Cmd->Seq, memory_order_relaxed);
+   atomic_fetch_add_explicit(&Store->AckCnt, 1, memory_order_release);
+
+   return true;
+
+} /* End STORE_AckCmd() */
+
+
+/******************************************************************************
+** Function: STORE_SendTlmCmd
+**
+*/
+bool STORE_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   STORE_Class_t *Store = (STORE_Class_t *)ObjDataPtr;
+   LORA_StoreTlm_Payload_t *Payload = &Store->StoreTlm.Payload;
+   uint16 SegmentsUsed = 0;
+   uint32 ByteCnt = 0;
+   uint16 i;
+
+   for (i=0; i < Store->SegmentCnt; i++)
+   {
+      if (Store->Seg[i].InUse)
+      {
+         SegmentsUsed++;
+         ByteCnt += Store->Seg[i].Len;
+      }
+   }
+
+   Payload->Enabled      = Store->Enabled;
+   Payload->LinkUp       = Store->LinkUp;
+   Payload->SegmentCnt   = Store->SegmentCnt;
+   Payload->SegmentsUsed = SegmentsUsed;
+   Payload->ByteCnt      = ByteCnt;
+   Payload->PendingCnt   = Store->PendingCnt;
+   Payload->InFlightCnt  = (uint16)(Store->NextSeq - Store->AckedSeq - 1);
+   Payload->AckedSeq     = Store->AckedSeq;
+   Payload->NextSeq      = Store->NextSeq;
+   Payload->RxSeq        = (uint16)Store->RxSeq;
+   Payload->StoredCnt    = Store->StoredCnt;
+   Payload->ReplayedCnt  = Store->ReplayedCnt;
+   Payload->ResendCnt    = Store->ResendCnt;
+   Payload->AckedCnt     = Store->AckedCnt;
+   Payload->DroppedCnt   = Store->DroppedCnt;
+   Payload->WriteCnt     = Store->WriteCnt;
+   Payload->FileErrCnt   = Store->FileErrCnt;
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(Store->StoreTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(Store->StoreTlm.TelemetryHeader), true);
+
+   return true;
+
+} /* End STORE_SendTlmCmd() */
+
+
+/******************************************************************************
+** Function: AckRecord
+**
+*/
+static void AckRecord(STORE_Class_t *Store, const STORE_InFlight_t *InFlight)
+{
+
+   STORE_Segment_t *Seg;
+   int16 Slot = FindSlot(Store, InFlight->Num);
+
+   if (Slot < 0)
+   {
+      return;
+   }
+
+   Seg = &Store->Seg[Slot];
+   Seg->RecState[InFlight->Rec] = STORE_REC_DONE | (Seg->RecState[InFlight->Rec] & STORE_REC_RANK);
+   Seg->InFlightCnt--;
+   Seg->DoneCnt++;
+
+   if (Seg->DoneCnt == Seg->RecCnt && !(Store->WriteOpen && Slot == NewestSlot(Store)))
+   {
+      DeleteSegment(Store, Slot);
+   }
+
+} /* End AckRecord() */
+
+
+/******************************************************************************
+** Function: DeleteSegment
+**
+** Delete a segment's file and free the slots at the old end of the ring
+**
+*/
+static void DeleteSegment(STORE_Class_t *Store, uint16 Slot)
+{
+
+   STORE_Segment_t *Seg = &Store->Seg[Slot];
+   char  Path[OS_MAX_PATH_LEN];
+   int32 Status;
+
+   if (Store->ReadOpen && Store->ReadNum == Seg->Num)
+   {
+      OS_close(Store->ReadFd);
+      Store->ReadOpen = false;
+   }
+
+   SegPath(Store, Seg->Num, Path);
+   Status = OS_remove(Path);
+   if (Status != OS_SUCCESS)
+   {
+      FileError(Store, "remove", Seg->Num, Status);
+   }
+   Seg->InUse = false;
+
+   while (Store->SlotCnt > 0 && !Store->Seg[Store->OldestSlot].InUse)
+   {
+      Store->OldestSlot = (Store->OldestSlot + 1) % Store->SegmentCnt;
+      Store->SlotCnt--;
+   }
+
+} /* End DeleteSegment() */
+
+
+/******************************************************************************
+** Function: DropRecord
+**
+** Give up on a pending record that can't be read
+**
+*/
+static void DropRecord(STORE_Class_t *Store, uint16 Slot, uint16 Rec)
+{
+
+   STORE_Segment_t *Seg = &Store->Seg[Slot];
+   uint8 Rank = Seg->RecState[Rec] & STORE_REC_RANK;
+
+   Seg->RecState[Rec] = STORE_REC_DONE | Rank;
+   Seg->PendingCnt[Rank]--;
+   Seg->DoneCnt++;
+   Store->PendingCnt--;
+   Store->DroppedCnt++;
+
+   if (Seg->DoneCnt == Seg->RecCnt && !(Store->WriteOpen && Slot == NewestSlot(Store)))
+   {
+      DeleteSegment(Store, Slot);
+   }
+
+} /* End DropRecord() */
+
+
+/******************************************************************************
+** Function: FileError
+**
+** Notes:
+**   1. A failing SD card fails every access so only every 100th error
+**      sends an event.
+**
+*/
+static void FileError(STORE_Class_t *Store, const char *Op, uint32 Num, int32 Status)
+{
+
+   if ((Store->FileErrCnt++ % 100) == 0)
+   {
+      CFE_EVS_SendEvent(STORE_FILE_EID, CFE_EVS_EventType_ERROR,
+                        "Store segment %u %s error, status = %d, %u errors",
+                        Num, Op, Status, Store->FileErrCnt);
+   }
+
+} /* End FileError() */
+
+
+/******************************************************************************
+** Function: FindSlot
+**
+** Return the slot of segment Num or -1 if it was deleted
+**
+*/
+static int16 FindSlot(const STORE_Class_t *Store, uint32 Num)
+{
+
+   int16 i;
+
+   for (i=0; i < Store->SegmentCnt; i++)
+   {
+      if (Store->Seg[i].InUse && Store->Seg[i].Num == Num)
+      {
+         return i;
+      }
+   }
+
+   return -1;
+
+} /* End FindSlot() */
+
+
+/******************************************************************************
+** Function: Load
+**
+** Read back the segments in STORE_DIR oldest first
+**
+** Notes:
+**   1. If there are more segments than STORE_SEGMENT_CNT, for example after
+**      it was lowered, the oldest ones are deleted.
+**
+*/
+static void Load(STORE_Class_t *Store)
+{
+
+   osal_id_t   DirId;
+   os_dirent_t DirEntry;
+   const char *Name;
+   char   *End;
+   char   Path[OS_MAX_PATH_LEN];
+   uint32 Num[STORE_MAX_DIR_FILES];
+   uint32 Swap;
+   uint16 NumCnt = 0;
+   uint16 i;
+   uint16 j;
+   int32  Status;
+
+   OS_mkdir(Store->Dir, 0);
+
+   Status = OS_DirectoryOpen(&DirId, Store->Dir);
+   if (Status != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(STORE_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Store disabled, error opening directory %s, status = %d", Store->Dir, Status);
+      Store->Enabled = false;
+      return;
+   }
+
+   while (OS_DirectoryRead(DirId, &DirEntry) == OS_SUCCESS && NumCnt < STORE_MAX_DIR_FILES)
+   {
+      Name = OS_DIRENTRY_NAME(DirEntry);
+      if (strncmp(Name, STORE_FILE_PREFIX, strlen(STORE_FILE_PREFIX)) == 0)
+      {
+         Num[NumCnt] = strtoul(&Name[strlen(STORE_FILE_PREFIX)], &End, 10);
+         if (strcmp(End, STORE_FILE_SUFFIX) == 0 && Num[NumCnt] > 0)
+         {
+            NumCnt++;
+         }
+      }
+   }
+   OS_DirectoryClose(DirId);
+
+   /* Few files so an insertion sort */
+   for (i=1; i < NumCnt; i++)
+   {
+      for (j=i; j > 0 && Num[j-1] > Num[j]; j--)
+      {
+         Swap = Num[j];
+         Num[j] = Num[j-1];
+         Num[j-1] = Swap;
+      }
+   }
+
+   for (i=0; i < NumCnt; i++)
+   {
+      if ((NumCnt - i) > Store->SegmentCnt)
+      {
+         SegPath(Store, Num[i], Path);
+         OS_remove(Path);
+         CFE_EVS_SendEvent(STORE_CONSTRUCTOR_EID, CFE_EVS_EventType_INFORMATION,
+                           "Deleted store segment %u, more than STORE_SEGMENT_CNT segments", Num[i]);
+      }
+      else
+      {
+         LoadSegment(Store, Num[i]);
+      }
+      Store->NextNum = Num[i] + 1;
+   }
+
+   CFE_EVS_SendEvent(STORE_CONSTRUCTOR_EID, CFE_EVS_EventType_INFORMATION,
+                     "Store %s has %u records to replay in %u segments",
+                     Store->Dir, Store->PendingCnt, Store->SlotCnt);
+
+} /* End Load() */
+
+
+/******************************************************************************
+** Function: LoadSegment
+**
+** Notes:
+**   1. The records are indexed up to the first one that's invalid or cut
+**      short by a lost write, a segment is never appended to after a
+**      restart.
+**
+*/
+static void LoadSegment(STORE_Class_t *Store, uint32 Num)
+{
+
+   uint16 Slot = (Store->OldestSlot + Store->SlotCnt) % Store->SegmentCnt;
+   STORE_Segment_t *Seg = &Store->Seg[Slot];
+   char       Path[OS_MAX_PATH_LEN];
+   os_fstat_t FileStat;
+   osal_id_t  Fd;
+   uint8      Hdr[STORE_REC_HDR_LEN];
+   uint32     FileLen;
+   uint32     Offset = 0;
+   uint16     MsgLen;
+   uint8      Rank;
+
+   SegPath(Store, Num, Path);
+   if (OS_stat(Path, &FileStat) != OS_SUCCESS ||
+       OS_OpenCreate(&Fd, Path, OS_FILE_FLAG_NONE, OS_READ_ONLY) != OS_SUCCESS)
+   {
+      FileError(Store, "open", Num, OS_ERROR);
+      return;
+   }
+   FileLen = OS_FILESTAT_SIZE(FileStat);
+
+   memset(Seg, 0, sizeof(STORE_Segment_t));
+
+   while (Seg->RecCnt < STORE_MAX_SEG_RECORDS && (Offset + STORE_REC_HDR_LEN) <= FileLen &&
+          OS_read(Fd, Hdr, STORE_REC_HDR_LEN) == STORE_REC_HDR_LEN)
+   {
+      Rank   = Hdr[1];
+      MsgLen = (Hdr[2] << 8) | Hdr[3];
+      if (Hdr[0] != STORE_REC_SYNC || Rank >= STORE_MAX_RANK || MsgLen > STORE_MAX_MSG_LEN ||
+          (Offset + STORE_REC_HDR_LEN + MsgLen) > FileLen || Offset >= STORE_SEGMENT_LEN)
+      {
+         break;
+      }
+      Seg->RecOffset[Seg->RecCnt] = (uint16)Offset;
+      Seg->RecState[Seg->RecCnt]  = STORE_REC_PENDING | Rank;
+      Seg->RecCnt++;
+      Seg->PendingCnt[Rank]++;
+      Offset += STORE_REC_HDR_LEN + MsgLen;
+      OS_lseek(Fd, Offset, OS_SEEK_SET);
+   }
+   OS_close(Fd);
+
+   if (Seg->RecCnt == 0)
+   {
+      OS_remove(Path);
+      return;
+   }
+
+   Seg->InUse = true;
+   Seg->Num   = Num;
+   Seg->Len   = Offset;
+   Store->PendingCnt += Seg->RecCnt;
+   Store->SlotCnt++;
+
+} /* End LoadSegment() */
+
+
+/******************************************************************************
+** Function: NewestSlot
+**
+*/
+static uint16 NewestSlot(const STORE_Class_t *Store)
+{
+
+   return (Store->SlotCnt > 0) ? ((Store->OldestSlot + Store->SlotCnt - 1) % Store->SegmentCnt) : Store->OldestSlot;
+
+} /* End NewestSlot() */
+
+
+/******************************************************************************
+** Function: NowUsec
+**
+*/
+static int64 NowUsec(void)
+{
+
+   OS_time_t Now;
+
+   OS_GetLocalTime(&Now);
+
+   return OS_TimeGetTotalMicroseconds(Now);
+
+} /* End NowUsec() */
+
+
+/******************************************************************************
+** Function: ProcessAck
+**
+** Notes:
+**   1. An ack outside the window is a repeat or is from before a restart,
+**      it only shows the link is up.
+**
+*/
+static void ProcessAck(STORE_Class_t *Store, uint16 Seq, int64 Now)
+{
+
+   uint16 InFlightCnt = Store->NextSeq - Store->AckedSeq - 1;
+   uint16 AckCnt = Seq - Store->AckedSeq;
+   uint16 i;
+
+   if (AckCnt == 0 || AckCnt > InFlightCnt)
+   {
+      return;
+   }
+
+   for (i=1; i <= AckCnt; i++)
+   {
+      AckRecord(Store, &Store->InFlight[(uint16)(Store->AckedSeq + i) & (STORE_WINDOW-1)]);
+   }
+
+   if ((uint16)(Store->ResendSeq - Store->AckedSeq - 1) < AckCnt)
+   {
+      Store->ResendSeq = Seq + 1;
+   }
+   Store->AckedSeq     = Seq;
+   Store->AckedCnt    += AckCnt;
+   Store->ProgressUsec = Now;
+
+} /* End ProcessAck() */
+
+
+/******************************************************************************
+** Function: ReadRecord
+**
+*/
+static bool ReadRecord(STORE_Class_t *Store, uint16 Slot, uint16 Rec, uint8 *Msg, uint16 *MsgLen)
+{
+
+   STORE_Segment_t *Seg = &Store->Seg[Slot];
+   uint32 Offset = Seg->RecOffset[Rec];
+   uint32 FileLen = Seg->Len;
+   uint8  Hdr[STORE_REC_HDR_LEN];
+   char   Path[OS_MAX_PATH_LEN];
+   int32  Status;
+
+   if (Store->WriteOpen && Slot == NewestSlot(Store))
+   {
+      FileLen -= Store->WriteBufLen;
+      if (Offset >= FileLen)
+      {
+         const uint8 *Buf = &Store->WriteBuf[Offset - FileLen];
+         *MsgLen = (Buf[2] << 8) | Buf[3];
+         memcpy(Msg, &Buf[STORE_REC_HDR_LEN], *MsgLen);
+         return true;
+      }
+   }
+
+   if (!Store->ReadOpen || Store->ReadNum != Seg->Num)
+   {
+      if (Store->ReadOpen)
+      {
+         OS_close(Store->ReadFd);
+         Store->ReadOpen = false;
+      }
+      SegPath(Store, Seg->Num, Path);
+      Status = OS_OpenCreate(&Store->ReadFd, Path, OS_FILE_FLAG_NONE, OS_READ_ONLY);
+      if (Status != OS_SUCCESS)
+      {
+         FileError(Store, "open", Seg->Num, Status);
+         return false;
+      }
+      Store->ReadOpen = true;
+      Store->ReadNum  = Seg->Num;
+   }
+
+   if (OS_lseek(Store->ReadFd, Offset, OS_SEEK_SET) < 0 ||
+       OS_read(Store->ReadFd, Hdr, STORE_REC_HDR_LEN) != STORE_REC_HDR_LEN || Hdr[0] != STORE_REC_SYNC)
+   {
+      FileError(Store, "read", Seg->Num, OS_ERROR);
+      return false;
+   }
+
+   *MsgLen = (Hdr[2] << 8) | Hdr[3];
+   if (*MsgLen > STORE_MAX_MSG_LEN || OS_read(Store->ReadFd, Msg, *MsgLen) != *MsgLen)
+   {
+      FileError(Store, "read", Seg->Num, OS_ERROR);
+      return false;
+   }
+
+   return true;
+
+} /* End ReadRecord() */
+
+
+/******************************************************************************
+** Function: Rotate
+**
+** Close the newest segment and start a new one
+**
+** Notes:
+**   1. When the store is full the oldest segment is dropped, unless it has
+**      records in flight. Then the new record is dropped instead so the
+**      receiver never waits for a sequence number that can't be resent.
+**
+*/
+static bool Rotate(STORE_Class_t *Store)
+{
+
+   STORE_Segment_t *Seg;
+   char   Path[OS_MAX_PATH_LEN];
+   uint16 Slot;
+   uint16 Rank;
+   int32  Status;
+
+   if (Store->WriteOpen)
+   {
+      STORE_Flush(Store);
+      OS_close(Store->WriteFd);
+      Store->WriteOpen = false;
+      Slot = NewestSlot(Store);
+      if (Store->Seg[Slot].DoneCnt == Store->Seg[Slot].RecCnt)
+      {
+         DeleteSegment(Store, Slot);
+      }
+   }
+
+   if (Store->SlotCnt == Store->SegmentCnt)
+   {
+      Seg = &Store->Seg[Store->OldestSlot];
+      if (Seg->InFlightCnt > 0)
+      {
+         return false;
+      }
+      for (Rank=0; Rank < STORE_MAX_RANK; Rank++)
+      {
+         Store->DroppedCnt += Seg->PendingCnt[Rank];
+         Store->PendingCnt -= Seg->PendingCnt[Rank];
+      }
+      CFE_EVS_SendEvent(STORE_FILE_EID, CFE_EVS_EventType_INFORMATION,
+                        "Store full, dropped segment %u with %u records", Seg->Num, Seg->RecCnt - Seg->DoneCnt);
+      DeleteSegment(Store, Store->OldestSlot);
+   }
+
+   Slot = (Store->OldestSlot + Store->SlotCnt) % Store->SegmentCnt;
+   Seg  = &Store->Seg[Slot];
+   memset(Seg, 0, sizeof(STORE_Segment_t));
+   Seg->Num = Store->NextNum++;
+
+   SegPath(Store, Seg->Num, Path);
+   Status = OS_OpenCreate(&Store->WriteFd, Path, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_WRITE_ONLY);
+   if (Status != OS_SUCCESS)
+   {
+      FileError(Store, "create", Seg->Num, Status);
+      return false;
+   }
+
+   Seg->InUse = true;
+   Store->SlotCnt++;
+   Store->WriteOpen = true;
+
+   return true;
+
+} /* End Rotate() */
+
+
+/******************************************************************************
+** Function: SegPath
+**
+*/
+static void SegPath(const STORE_Class_t *Store, uint32 Num, char *Path)
+{
+
+   snprintf(Path, OS_MAX_PATH_LEN, "%s/%s%08u%s", Store->Dir, STORE_FILE_PREFIX, (unsigned int)Num, STORE_FILE_SUFFIX);
+
+} /* End SegPath() */
@@ -0,0 +1,303 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the store-and-forward queue for bridged messages
+**
+**  Notes:
+**    1. While the link is down the QoS scheduler (qos.h) stores the
+**       messages it would have sent rather than sending them into the void.
+**       When the link returns they're replayed, highest priority first and
+**       oldest first within a priority, sharing the radio with the live
+**       messages.
+**    2. The store is a log of segment files in STORE_DIR. Records are only
+**       ever appended to the newest segment and a segment is rotated when
+**       it's full. STORE_SEGMENT_CNT segments bound the store's size, when
+**       it's full the oldest segment is dropped. A record is a 4 byte
+**       header (sync, rank, big endian length) and the message.
+**    3. Appends collect in a write buffer that's written with one
+**       sequential OS_write() after STORE_SYNC_CNT records or STORE_SYNC_MS,
+**       so an SD card sees few large writes. OSAL has no memory mapping or
+**       fsync so the buffer is the batching unit. A record that's still
+**       buffered when the app stops is lost.
+**    4. The ground acknowledges replayed records with the AckStore command.
+**       Replayed frames are LORA_FRAME_TYPE_SB_STORED frames that carry a
+**       replay count ahead of the message. The receiving bridge republishes
+**       them in count order and reports the last one in its StoreTlm, that's
+**       the count the ground sends back. Acks are cumulative.
+**    5. The link is up while AckStore commands arrive within
+**       STORE_LINK_TIMEOUT_MS, the ground keeps sending them during a
+**       contact even when nothing new has arrived. A link starts down.
+**    6. At most STORE_WINDOW records are in flight. When the acks stop
+**       advancing for STORE_ACK_TIMEOUT_MS, or the link comes back, the
+**       unacknowledged records are resent with their original sequence
+**       numbers (go-back-N) so the receiver can drop copies.
+**    7. A segment whose records have all been acknowledged is deleted.
+**       After a restart the remaining segments are read back and all their
+**       records are replayed, so delivery across a restart is at least
+**       once. The replay count restarts at 1 and the receiving bridge
+**       always takes count 1 as the start of a new sequence.
+**    8. Everything except the ack command and telemetry runs in the
+**       bridging radio's Tx task so the store has no lock.
+**
+*/
+
+#ifndef _store_
+#define _store_
+
+/*
+** Includes
+*/
+
+#include <stdatomic.h>
+#include "app_cfg.h"
+#include "lora_frame.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define STORE_MAX_SEGMENTS     16
+#define STORE_SEGMENT_LEN      65536   /* Bytes, records don't span segments */
+#define STORE_MAX_SEG_RECORDS  1024
+#define STORE_MAX_RANK         4       /* Replay priorities, 0 is first */
+#define STORE_REC_HDR_LEN      4
+#define STORE_MAX_MSG_LEN      LORA_FRAME_MAX_LEN
+#define STORE_WRITE_BUF_LEN    4096
+#define STORE_WINDOW           64      /* Records in flight, must be a power of 2 */
+#define STORE_SEQ_LEN          2       /* Replay count ahead of a stored frame's message */
+
+
+/*
+** Event Message IDs
+*/
+
+#define STORE_CONSTRUCTOR_EID  (STORE_BASE_EID + 0)
+#define STORE_FILE_EID         (STORE_BASE_EID + 1)
+#define STORE_LINK_EID         (STORE_BASE_EID + 2)
+#define STORE_ACK_EID          (STORE_BASE_EID + 3)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+
+typedef struct
+{
+
+   bool     InUse;         /* False once the segment is deleted */
+   uint32   Num;           /* File name number, increases with age */
+   uint32   Len;           /* Bytes appended, including buffered records */
+   uint16   RecCnt;
+   uint16   DoneCnt;       /* Acknowledged records */
+   uint16   InFlightCnt;
+   uint16   PendingCnt[STORE_MAX_RANK];
+   uint16   NextRec[STORE_MAX_RANK];           /* Replay scan start for each rank */
+   uint16   RecOffset[STORE_MAX_SEG_RECORDS];
+   uint8    RecState[STORE_MAX_SEG_RECORDS];   /* STORE_REC_* state and rank */
+
+} STORE_Segment_t;
+
+
+typedef struct
+{
+
+   uint32   Num;           /* Segment, records in a dropped segment are skipped */
+   uint16   Rec;
+
+} STORE_InFlight_t;
+
+
+/******************************************************************************
+** STORE_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Telemetry Packets
+   */
+
+   LORA_StoreTlm_t  StoreTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   bool     Enabled;
+   char     Dir[OS_MAX_PATH_LEN];
+   uint16   SegmentCnt;
+   uint16   SyncCnt;
+   uint32   SyncMs;
+   uint32   AckTimeoutMs;
+   uint32   LinkTimeoutMs;
+
+   /* Ack command, main task */
+   atomic_uint  AckCnt;
+   atomic_uint  AckSeq;
+   uint32       RxSeq;             /* Receiving bridge's last in sequence record */
+
+   /* Tx task */
+   bool     LinkUp;
+   uint32   LastAckCnt;
+   int64    LastAckUsec;
+   int64    ProgressUsec;         /* Last ack that advanced or resend */
+   uint16   AckedSeq;
+   uint16   NextSeq;
+   uint16   ResendSeq;            /* Equals NextSeq when not resending */
+   STORE_InFlight_t InFlight[STORE_WINDOW];
+
+   uint16   OldestSlot;
+   uint16   SlotCnt;              /* Slots from the oldest to the newest segment */
+   uint32   NextNum;
+   bool     WriteOpen;
+   osal_id_t WriteFd;
+   bool     ReadOpen;
+   osal_id_t ReadFd;
+   uint32   ReadNum;
+   uint16   WriteBufLen;
+   uint16   WriteBufRecCnt;
+   int64    WriteBufUsec;         /* Time of the oldest buffered record */
+
+   uint32   PendingCnt;
+   uint32   StoredCnt;
+   uint32   ReplayedCnt;
+   uint32   ResendCnt;
+   uint32   AckedCnt;
+   uint32   DroppedCnt;           /* Records lost to a full store */
+   uint32   WriteCnt;
+   uint32   FileErrCnt;
+
+   uint8    WriteBuf[STORE_WRITE_BUF_LEN];
+   STORE_Segment_t Seg[STORE_MAX_SEGMENTS];
+
+} STORE_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: STORE_Constructor
+**
+** Initialize the store and read back the segments left by an earlier run
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**   2. STORE_SEGMENT_CNT 0 disables the store, the link is always up.
+**
+*/
+void STORE_Constructor(STORE_Class_t *Store, INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: STORE_Poll
+**
+** Process the acks, resend timeouts and buffered writes, and return whether
+** the link is up
+**
+** Notes:
+**   1. Called by the bridging Tx task before each message.
+**
+*/
+bool STORE_Poll(STORE_Class_t *Store);
+
+
+/******************************************************************************
+** Function: STORE_Append
+**
+** Store a message with a replay priority Rank
+**
+** Notes:
+**   1. Returns false if the message couldn't be stored.
+**
+*/
+bool STORE_Append(STORE_Class_t *Store, uint8 Rank, const uint8 *Msg, uint16 MsgLen);
+
+
+/******************************************************************************
+** Function: STORE_NextRank
+**
+** Return the rank of the next record to replay or -1 if there's none
+**
+** Notes:
+**   1. Resends return rank 0, they hold up the receiver.
+**   2. Returns -1 while the window is full.
+**
+*/
+int16 STORE_NextRank(STORE_Class_t *Store);
+
+
+/******************************************************************************
+** Function: STORE_NextReplay
+**
+** Read the next record to replay into Msg
+**
+** Notes:
+**   1. Msg must have room for STORE_MAX_MSG_LEN bytes.
+**   2. Resend is set when the record was sent before, the caller restarts
+**      its header compression so the receiver doesn't need the lost frames'
+**      headers.
+**   3. Returns false if there's nothing to replay.
+**
+*/
+bool STORE_NextReplay(STORE_Class_t *Store, uint8 *Msg, uint16 *MsgLen, uint16 *Seq, bool *Resend);
+
+
+/******************************************************************************
+** Function: STORE_Flush
+**
+** Write the buffered records
+**
+*/
+void STORE_Flush(STORE_Class_t *Store);
+
+
+/******************************************************************************
+** Function: STORE_RecordRx
+**
+** Record the receiving bridge's last in sequence stored record
+**
+*/
+void STORE_RecordRx(STORE_Class_t *Store, uint16 Seq);
+
+
+/******************************************************************************
+** Function: STORE_AckCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**
+*/
+bool STORE_AckCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: STORE_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**
+*/
+bool STORE_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _store_ */
@@ -0,0 +1,540 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the striped transfer class
+**
+**  Notes:
+**    1. The radio tasks call into this object concurrently. The file and
+**       the transfer state are protected by a mutex that is only held for
+**       a packet read or write, never while a radio is on the air.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stripe.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define STRIPE_MUTEX_NAME  "LORA_STRIPE_MUT"
+
+#define STRIPE_PKT_CNT_TEXT_LEN  12
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static uint32 ElapsedMs(const STRIPE_Class_t *Stripe);
+static void   EndTransfer(STRIPE_Class_t *Stripe);
+
+
+/******************************************************************************
+** Function: STRIPE_Constructor
+**
+*/
+void STRIPE_Constructor(STRIPE_Class_t *Stripe, INITBL_Class_t *IniTbl, RX_WRITER_Class_t *RxWriter)
+{
+
+   int32 SysStatus;
+
+   memset(Stripe, 0, sizeof(STRIPE_Class_t));
+
+   Stripe->RxWriter = RxWriter;
+
+   atomic_init(&Stripe->Active, false);
+   Stripe->Role = LORA_StripeRole_NONE;
+
+   strncpy(Stripe->TxFile, INITBL_GetStrConfig(IniTbl, CFG_TX_DEMO_FILE), OS_MAX_PATH_LEN-1);
+   strncpy(Stripe->RxFile, INITBL_GetStrConfig(IniTbl, CFG_STRIPE_RX_FILE), OS_MAX_PATH_LEN-1);
+
+   SysStatus = OS_MutSemCreate(&Stripe->MutexId, STRIPE_MUTEX_NAME, 0);
+   if (SysStatus != OS_SUCCESS)
+   {
+      CFE_EVS_SendEvent(STRIPE_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating stripe mutex %s, Status = %d", STRIPE_MUTEX_NAME, SysStatus);
+   }
+
+   CFE_MSG_Init(CFE_MSG_PTR(Stripe->StripeTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_LORA_STRIPE_TLM_TOPICID)), sizeof(LORA_StripeTlm_t));
+
+} /* End STRIPE_Constructor() */
+
+
+/******************************************************************************
+** Function: STRIPE_Start
+**
+** Notes:
+**   1. The transfer is busy until its last radio is done, not just until
+**      it's inactive, because the file stays open until then.
+**
+*/
+bool STRIPE_Start(STRIPE_Class_t *Stripe, LORA_StripeRole_Enum_t Role, uint8 RadioMask)
+{
+
+   bool       RetStatus = false;
+   int32      SysStatus;
+   os_fstat_t FileStats;
+   uint32     PktCnt = 0;
+   uint16     i;
+
+   OS_MutSemTake(Stripe->MutexId);
+
+   if (Stripe->ActiveRadioCnt > 0)
+   {
+      CFE_EVS_SendEvent(STRIPE_START_EID, CFE_EVS_EventType_ERROR,
+                        "Start striped transfer rejected, a striped transfer is active");
+      OS_MutSemGive(Stripe->MutexId);
+      return false;
+   }
+
+   if (Role == LORA_StripeRole_TX)
+   {
+      SysStatus = OS_stat(Stripe->TxFile, &FileStats);
+      if (SysStatus == OS_SUCCESS)
+      {
+         PktCnt = (OS_FILESTAT_SIZE(FileStats) + LORA_DEMO_PACKET_SIZE - 1) / LORA_DEMO_PACKET_SIZE;
+         if (PktCnt > STRIPE_MAX_PKT_CNT)
+         {
+            CFE_EVS_SendEvent(STRIPE_FILE_EID, CFE_EVS_EventType_ERROR,
+                              "Start striped transfer rejected, %s has %u packets and the limit is %u",
+                              Stripe->TxFile, (unsigned int)PktCnt, STRIPE_MAX_PKT_CNT);
+            OS_MutSemGive(Stripe->MutexId);
+            return false;
+         }
+         SysStatus = OS_OpenCreate(&Stripe->FileHandle, Stripe->TxFile, OS_FILE_FLAG_NONE, OS_READ_ONLY);
+      }
+      if (SysStatus != OS_SUCCESS)
+      {
+         CFE_EVS_SendEvent(STRIPE_FILE_EID, CFE_EVS_EventType_ERROR,
+                           "Error opening striped transmit file %s, Status = %d", Stripe->TxFile, SysStatus);
+      }
+   }
+   else
+   {
+      SysStatus = RX_WRITER_Open(Stripe->RxWriter, RX_WRITER_STRIPE, Stripe->RxFile) ? OS_SUCCESS : OS_ERROR;
+   }
+
+   if (SysStatus == OS_SUCCESS)
+   {
+
+      Stripe->Role       = Role;
+      Stripe->RadioMask  = RadioMask;
+      Stripe->PktCnt     = PktCnt;
+      Stripe->NextPkt    = 1;
+      Stripe->DonePktCnt = 0;
+      Stripe->DupPktCnt  = 0;
+      Stripe->ByteCnt    = 0;
+      memset(Stripe->Radio, 0, sizeof(Stripe->Radio));
+      PKT_MAP_Clear(&Stripe->RcvdMap);
+
+      Stripe->ActiveRadioCnt = 0;
+      for (i=0; i < LORA_RADIO_MAX; i++)
+      {
+         if (RadioMask & (1 << i))
+         {
+            Stripe->Radio[i].Active = true;
+            Stripe->ActiveRadioCnt++;
+         }
+      }
+
+      OS_GetLocalTime(&Stripe->StartTime);
+      atomic_store(&Stripe->Active, true);
+      RetStatus = true;
+
+      if (Role == LORA_StripeRole_TX)
+      {
+         CFE_EVS_SendEvent(STRIPE_START_EID, CFE_EVS_EventType_INFORMATION,
+                           "Sending %u packets from %s striped over radio mask 0x%02X",
+                           (unsigned int)PktCnt, Stripe->TxFile, RadioMask);
+      }
+      else
+      {
+         CFE_EVS_SendEvent(STRIPE_START_EID, CFE_EVS_EventType_INFORMATION,
+                           "Receiving a striped transfer into %s on radio mask 0x%02X",
+                           Stripe->RxFile, RadioMask);
+      }
+
+   }
+
+   OS_MutSemGive(Stripe->MutexId);
+
+   return RetStatus;
+
+} /* End STRIPE_Start() */
+
+
+/******************************************************************************
+** Function: STRIPE_Active
+**
+*/
+bool STRIPE_Active(STRIPE_Class_t *Stripe)
+{
+
+   return atomic_load(&Stripe->Active);
+
+} /* End STRIPE_Active() */
+
+
+/******************************************************************************
+** Function: STRIPE_NextTxPkt
+**
+** Notes:
+**   1. Each radio sends a file start frame before its first packet, see
+**      stripe.h.
+**   2. Packets are claimed in order so the file is read sequentially.
+**
+*/
+bool STRIPE_NextTxPkt(STRIPE_Class_t *Stripe, uint8 Radio, uint8 *Type, uint16 *Seq,
+                      uint8 *Data, uint16 *DataLen)
+{
+
+   STRIPE_Radio_t *StripeRadio = &Stripe->Radio[Radio];
+   bool  RetStatus = false;
+   int32 ReadLen;
+
+   if (!atomic_load(&Stripe->Active))
+   {
+      return false;
+   }
+
+   OS_MutSemTake(Stripe->MutexId);
+
+   if (!StripeRadio->StartSent)
+   {
+      *Type    = LORA_FRAME_TYPE_FILE_START;
+      *Seq     = 0;
+      *DataLen = snprintf((char *)Data, STRIPE_PKT_CNT_TEXT_LEN, "%u", (unsigned int)Stripe->PktCnt);
+      StripeRadio->StartSent = true;
+      RetStatus = true;
+   }
+   else if (Stripe->NextPkt <= Stripe->PktCnt)
+   {
+      ReadLen = OS_read(Stripe->FileHandle, Data, LORA_DEMO_PACKET_SIZE);
+      if (ReadLen > 0)
+      {
+         *Type    = LORA_FRAME_TYPE_FILE_DATA;
+         *Seq     = (uint16)Stripe->NextPkt++;
+         *DataLen = (uint16)ReadLen;
+         RetStatus = true;
+      }
+   }
+
+   OS_MutSemGive(Stripe->MutexId);
+
+   return RetStatus;
+
+} /* End STRIPE_NextTxPkt() */
+
+
+/******************************************************************************
+** Function: STRIPE_RecordTx
+**
+*/
+void STRIPE_RecordTx(STRIPE_Class_t *Stripe, uint8 Radio, uint16 Seq, bool Sent, uint16 DataLen, uint32 AirUsec)
+{
+
+   STRIPE_Radio_t *StripeRadio = &Stripe->Radio[Radio];
+
+   OS_MutSemTake(Stripe->MutexId);
+
+   if (Sent)
+   {
+      StripeRadio->AirUsec += AirUsec;
+      if (Seq > 0)
+      {
+         StripeRadio->FrameCnt++;
+         Stripe->DonePktCnt++;
+         Stripe->ByteCnt += DataLen;
+      }
+   }
+   else
+   {
+      StripeRadio->ErrCnt++;
+   }
+
+   OS_MutSemGive(Stripe->MutexId);
+
+} /* End STRIPE_RecordTx() */
+
+
+/******************************************************************************
+** Function: STRIPE_RecordRx
+**
+** Notes:
+**   1. Packet N is written at file offset (N-1)*LORA_DEMO_PACKET_SIZE so
+**      the order the radios deliver packets in doesn't matter.
+**   2. Packets received before the file start frame are written because
+**      the packet count only bounds the sequence numbers.
+**
+*/
+void STRIPE_RecordRx(STRIPE_Class_t *Stripe, uint8 Radio, const LORA_FRAME_Hdr_t *FrameHdr,
+                     const uint8 *Data, uint16 DataLen, uint32 AirUsec)
+{
+
+   STRIPE_Radio_t *StripeRadio = &Stripe->Radio[Radio];
+   uint16 Seq = FrameHdr->Seq;
+   uint32 PktCnt;
+   char   PktCntText[STRIPE_PKT_CNT_TEXT_LEN];
+
+   if (!atomic_load(&Stripe->Active))
+   {
+      return;
+   }
+
+   OS_MutSemTake(Stripe->MutexId);
+
+   StripeRadio->AirUsec += AirUsec;
+
+   if (FrameHdr->Type == LORA_FRAME_TYPE_FILE_START)
+   {
+      if (Stripe->PktCnt == 0)
+      {
+         snprintf(PktCntText, sizeof(PktCntText), "%.*s", (int)DataLen, (const char *)Data);
+         PktCnt = strtoul(PktCntText, NULL, 10);
+         if (PktCnt > 0 && PktCnt <= STRIPE_MAX_PKT_CNT)
+         {
+            Stripe->PktCnt = PktCnt;
+            CFE_EVS_SendEvent(STRIPE_FILE_EID, CFE_EVS_EventType_INFORMATION,
+                              "Radio %u received the striped file start, expecting %u packets",
+                              Radio, (unsigned int)PktCnt);
+         }
+         else
+         {
+            StripeRadio->ErrCnt++;
+         }
+      }
+   }
+   else if (FrameHdr->Type == LORA_FRAME_TYPE_FILE_DATA && Seq > 0 &&
+            (Stripe->PktCnt == 0 || Seq <= Stripe->PktCnt))
+   {
+      if (PKT_MAP_Test(&Stripe->RcvdMap, Seq))
+      {
+         Stripe->DupPktCnt++;
+      }
+      else
+      {
+         if (RX_WRITER_Write(Stripe->RxWriter, RX_WRITER_STRIPE, (Seq-1)*LORA_DEMO_PACKET_SIZE, Data, DataLen))
+         {
+            PKT_MAP_Set(&Stripe->RcvdMap, Seq);
+            Stripe->DonePktCnt++;
+            Stripe->ByteCnt += DataLen;
+            StripeRadio->FrameCnt++;
+         }
+         else
+         {
+            StripeRadio->ErrCnt++;
+         }
+      }
+   }
+   else
+   {
+      StripeRadio->ErrCnt++;
+   }
+
+   if (Stripe->PktCnt > 0 && Stripe->DonePktCnt == Stripe->PktCnt)
+   {
+      atomic_store(&Stripe->Active, false);
+   }
+
+   OS_MutSemGive(Stripe->MutexId);
+
+} /* End STRIPE_RecordRx() */
+
+
+/******************************************************************************
+** Function: STRIPE_PollRx
+**
+*/
+void STRIPE_PollRx(STRIPE_Class_t *Stripe)
+{
+
+   OS_MutSemTake(Stripe->MutexId);
+
+   if (atomic_load(&Stripe->Active) && Stripe->Role == LORA_StripeRole_RX)
+   {
+      RX_WRITER_Poll(Stripe->RxWriter, RX_WRITER_STRIPE);
+   }
+
+   OS_MutSemGive(Stripe->MutexId);
+
+} /* End STRIPE_PollRx() */
+
+
+/******************************************************************************
+** Function: STRIPE_RadioDone
+**
+*/
+void STRIPE_RadioDone(STRIPE_Class_t *Stripe, uint8 Radio)
+{
+
+   bool Ended = false;
+
+   OS_MutSemTake(Stripe->MutexId);
+
+   if (Stripe->Radio[Radio].Active)
+   {
+      Stripe->Radio[Radio].Active = false;
+      if (--Stripe->ActiveRadioCnt == 0)
+      {
+         EndTransfer(Stripe);
+         Ended = true;
+      }
+   }
+
+   OS_MutSemGive(Stripe->MutexId);
+
+   if (Ended)
+   {
+      STRIPE_SendTlmCmd(Stripe, NULL);
+   }
+
+} /* End STRIPE_RadioDone() */
+
+
+/******************************************************************************
+** Function: STRIPE_StopCmd
+**
+*/
+bool STRIPE_StopCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   STRIPE_Class_t *Stripe = (STRIPE_Class_t *)ObjDataPtr;
+
+   atomic_store(&Stripe->Active, false);
+   CFE_EVS_SendEvent(STRIPE_STOP_EID, CFE_EVS_EventType_INFORMATION,
+                     "Striped transfer stop requested");
+
+   return true;
+
+} /* End STRIPE_StopCmd() */
+
+
+/******************************************************************************
+** Function: STRIPE_SendTlmCmd
+**
+** Notes:
+**   1. Utilization is airtime usec per elapsed msec which is parts per
+**      thousand.
+**
+*/
+bool STRIPE_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   STRIPE_Class_t *Stripe = (STRIPE_Class_t *)ObjDataPtr;
+   LORA_StripeTlm_Payload_t *Payload = &Stripe->StripeTlm.Payload;
+   uint32 Elapsed;
+   uint64 UtilPpt;
+   uint16 i;
+
+   OS_MutSemTake(Stripe->MutexId);
+
+   Elapsed = ElapsedMs(Stripe);
+
+   Payload->Active     = atomic_load(&Stripe->Active);
+   Payload->Role       = Stripe->Role;
+   Payload->RadioMask  = Stripe->RadioMask;
+   Payload->PktCnt     = Stripe->PktCnt;
+   Payload->DonePktCnt = Stripe->DonePktCnt;
+   Payload->DupPktCnt  = Stripe->DupPktCnt;
+   Payload->ElapsedMs  = Elapsed;
+   Payload->GoodputBps = (Elapsed > 0) ? (uint32)(Stripe->ByteCnt * 8 * 1000 / Elapsed) : 0;
+
+   for (i=0; i < LORA_RADIO_MAX; i++)
+   {
+      UtilPpt = (Elapsed > 0) ? (Stripe->Radio[i].AirUsec / Elapsed) : 0;
+      Payload->RadioFrameCnt[i] = Stripe->Radio[i].FrameCnt;
+      Payload->RadioErrCnt[i]   = Stripe->Radio[i].ErrCnt;
+      Payload->RadioUtilPpt[i]  = (UtilPpt > 1000) ? 1000 : (uint16)UtilPpt;
+   }
+
+   OS_MutSemGive(Stripe->MutexId);
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(Stripe->StripeTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(Stripe->StripeTlm.TelemetryHeader), true);
+
+   return true;
+
+} /* End STRIPE_SendTlmCmd() */
+
+
+/******************************************************************************
+** Function: ElapsedMs
+**
+** Notes:
+**   1. Must be called with the mutex held.
+**
+*/
+static uint32 ElapsedMs(const STRIPE_Class_t *Stripe)
+{
+
+   OS_time_t EndTime = Stripe->EndTime;
+
+   if (Stripe->Role == LORA_StripeRole_NONE)
+   {
+      return 0;
+   }
+
+   if (Stripe->ActiveRadioCnt > 0)
+   {
+      OS_GetLocalTime(&EndTime);
+   }
+
+   return (uint32)OS_TimeGetTotalMilliseconds(OS_TimeSubtract(EndTime, Stripe->StartTime));
+
+} /* End ElapsedMs() */
+
+
+/******************************************************************************
+** Function: EndTransfer
+**
+** Notes:
+**   1. Must be called with the mutex held.
+**
+*/
+static void EndTransfer(STRIPE_Class_t *Stripe)
+{
+
+   uint32 Elapsed;
+
+   atomic_store(&Stripe->Active, false);
+   OS_GetLocalTime(&Stripe->EndTime);
+   if (Stripe->Role == LORA_StripeRole_TX)
+   {
+      OS_close(Stripe->FileHandle);
+   }
+   else
+   {
+      RX_WRITER_Close(Stripe->RxWriter, RX_WRITER_STRIPE);
+   }
+
+   Elapsed = ElapsedMs(Stripe);
+
+   CFE_EVS_SendEvent(STRIPE_FILE_EID, CFE_EVS_EventType_INFORMATION,
+                     "Striped %s %s: %u of %u packets, %u duplicates, %u bps",
+                     (Stripe->Role == LORA_StripeRole_TX ? "transmit" : "receive"),
+                     (Stripe->PktCnt > 0 && Stripe->DonePktCnt == Stripe->PktCnt ? "complete" : "stopped"),
+                     (unsigned int)Stripe->DonePktCnt, (unsigned int)Stripe->PktCnt,
+                     (unsigned int)Stripe->DupPktCnt,
+                     (Elapsed > 0) ? (unsigned int)(Stripe->ByteCnt * 8 * 1000 / Elapsed) : 0);
+
+} /* End EndTransfer() */
@@ -0,0 +1,265 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the striped transfer class
+**
+**  Notes:
+**    1. A striped transfer sends one file over several radios at once. Each
+**       radio runs on its own channel (RADIO_n_FREQ_OFFSET) so the radios
+**       don't collide and the aggregate goodput grows with the number of
+**       radios.
+**    2. The file is divided into LORA_DEMO_PACKET_SIZE packets and uses the
+**       demo framing: packet N is sent in a file data frame with sequence
+**       number N. Each transmitting radio starts with a file start frame so
+**       the receiver learns the packet count from any of the radios.
+**    3. A transmitting radio's Tx task claims the next packet when its
+**       previous frame is done. The packet goes to the radio that becomes
+**       free first so each radio carries a share proportional to its frame
+**       rate. A radio with a longer time-on-air or a deeper radio task queue
+**       claims fewer packets and no radio has more than one packet waiting.
+**    4. The receiving radios' Rx tasks write packets into one file at the
+**       packet's offset through the Rx writer's stripe stream (rx_writer.h),
+**       the mutex makes them the stream's single producer. Copies of a frame received on more than one radio
+**       are dropped by the receive diversity combiner (rx_div.h) and a map
+**       of received packets drops copies that arrive after its window.
+**    5. The per-radio utilization is the radio's airtime over the elapsed
+**       transfer time. Radios with equal modulations should be close to
+**       each other, a low radio shows the scheduler is unbalanced.
+**    6. Frequency hopping follows one radio's frame sequence so it can't be
+**       used by a striped radio.
+**
+*/
+
+#ifndef _stripe_
+#define _stripe_
+
+/*
+** Includes
+*/
+
+#include <stdatomic.h>
+#include "app_cfg.h"
+#include "lora_frame.h"
+#include "pkt_map.h"
+#include "rx_writer.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define STRIPE_MAX_PKT_CNT  PKT_MAP_MAX_PKT_CNT   /* Sequence number 0 is the file start */
+
+
+/*
+** Event Message IDs
+*/
+
+#define STRIPE_CONSTRUCTOR_EID  (STRIPE_BASE_EID + 0)
+#define STRIPE_START_EID        (STRIPE_BASE_EID + 1)
+#define STRIPE_STOP_EID         (STRIPE_BASE_EID + 2)
+#define STRIPE_FILE_EID         (STRIPE_BASE_EID + 3)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+// Command and Telemetry packets are defined in lora.xml
+
+
+typedef struct
+{
+
+   bool    Active;      /* Radio's task hasn't finished the transfer */
+   bool    StartSent;
+   uint32  FrameCnt;    /* Tx: packets sent, Rx: packets written to the file */
+   uint32  ErrCnt;
+   uint64  AirUsec;
+
+} STRIPE_Radio_t;
+
+
+/******************************************************************************
+** STRIPE_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Telemetry Packets
+   */
+
+   LORA_StripeTlm_t  StripeTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   atomic_bool  Active;
+   osal_id_t    MutexId;     /* Protects everything below */
+   RX_WRITER_Class_t *RxWriter;
+
+   LORA_StripeRole_Enum_t Role;
+   uint8      RadioMask;
+   uint8      ActiveRadioCnt;
+   osal_id_t  FileHandle;    /* Tx, the Rx file is the Rx writer's */
+   char       TxFile[OS_MAX_PATH_LEN];
+   char       RxFile[OS_MAX_PATH_LEN];
+
+   uint32     PktCnt;        /* Rx: 0 until a file start frame is received */
+   uint32     NextPkt;       /* Tx: next packet to claim */
+   uint32     DonePktCnt;
+   uint32     DupPktCnt;
+   uint64     ByteCnt;
+   OS_time_t  StartTime;
+   OS_time_t  EndTime;
+
+   STRIPE_Radio_t Radio[LORA_RADIO_MAX];
+
+   PKT_MAP_Class_t RcvdMap;  /* Rx: packets written to the file */
+
+} STRIPE_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: STRIPE_Constructor
+**
+** Initialize the Stripe object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void STRIPE_Constructor(STRIPE_Class_t *Stripe, INITBL_Class_t *IniTbl, RX_WRITER_Class_t *RxWriter);
+
+
+/******************************************************************************
+** Function: STRIPE_Start
+**
+** Open the transfer file and start a transfer over the radios in RadioMask
+**
+** Notes:
+**   1. Called by the app's start stripe commands after they check the
+**      radios. The caller then starts each radio's task and calls
+**      STRIPE_RadioDone() for a radio that couldn't be started.
+**   2. Returns false if a transfer is active or the file can't be opened.
+**
+*/
+bool STRIPE_Start(STRIPE_Class_t *Stripe, LORA_StripeRole_Enum_t Role, uint8 RadioMask);
+
+
+/******************************************************************************
+** Function: STRIPE_Active
+**
+** Notes:
+**   1. Checked by the radio tasks' transfer loops.
+**
+*/
+bool STRIPE_Active(STRIPE_Class_t *Stripe);
+
+
+/******************************************************************************
+** Function: STRIPE_NextTxPkt
+**
+** Claim the next frame for a transmitting radio
+**
+** Notes:
+**   1. Data must have room for LORA_DEMO_PACKET_SIZE bytes.
+**   2. Returns false when there are no more packets or the transfer has
+**      been stopped.
+**
+*/
+bool STRIPE_NextTxPkt(STRIPE_Class_t *Stripe, uint8 Radio, uint8 *Type, uint16 *Seq,
+                      uint8 *Data, uint16 *DataLen);
+
+
+/******************************************************************************
+** Function: STRIPE_RecordTx
+**
+** Record the result of sending a claimed frame
+**
+** Notes:
+**   1. A packet that couldn't be sent isn't claimed again, the receiver's
+**      file has a gap like it would for a packet lost on the air.
+**
+*/
+void STRIPE_RecordTx(STRIPE_Class_t *Stripe, uint8 Radio, uint16 Seq, bool Sent, uint16 DataLen, uint32 AirUsec);
+
+
+/******************************************************************************
+** Function: STRIPE_RecordRx
+**
+** Write a received frame's packet into the file
+**
+** Notes:
+**   1. Ends the transfer when all of the packets have been received.
+**
+*/
+void STRIPE_RecordRx(STRIPE_Class_t *Stripe, uint8 Radio, const LORA_FRAME_Hdr_t *FrameHdr,
+                     const uint8 *Data, uint16 DataLen, uint32 AirUsec);
+
+
+/******************************************************************************
+** Function: STRIPE_PollRx
+**
+** Let the Rx writer queue received data that's waited too long
+**
+** Notes:
+**   1. Called by a receiving radio's Rx task on a receive timeout.
+**
+*/
+void STRIPE_PollRx(STRIPE_Class_t *Stripe);
+
+
+/******************************************************************************
+** Function: STRIPE_RadioDone
+**
+** A radio's task has finished its part of the transfer
+**
+** Notes:
+**   1. The transfer ends when the last radio is done.
+**
+*/
+void STRIPE_RadioDone(STRIPE_Class_t *Stripe, uint8 Radio);
+
+
+/******************************************************************************
+** Function: STRIPE_StopCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**   2. The radios finish their current frame before they stop.
+*/
+bool STRIPE_StopCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: STRIPE_SendTlmCmd
+**
+** Notes:
+**   1. Must match CMDMGR_CmdFuncPtr_t function signature
+**   2. Also sent when a transfer ends.
+*/
+bool STRIPE_SendTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _stripe_ */
@@ -0,0 +1,163 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Implement the Telemetry Packer Class methods
+**
+**  Notes:
+**    1. See tlm_pack.h file prologue.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "lora_eds_pack.h"
+#include "tlm_pack.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define TLM_PACK_HDR_LEN  sizeof(CFE_MSG_TelemetryHeader_t)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef union
+{
+
+   LORA_StatusTlm_Payload_t  Status;
+   LORA_RadioTlm_Payload_t   Radio;
+
+} TlmPayload_t;
+
+
+/******************************************************************************
+** Function: TLM_PACK_Constructor
+**
+*/
+void TLM_PACK_Constructor(TLM_PACK_Class_t *TlmPack, INITBL_Class_t *IniTbl)
+{
+
+   memset(TlmPack, 0, sizeof(TLM_PACK_Class_t));
+
+   TlmPack->StatusTlmMid = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_LORA_STATUS_TLM_TOPICID));
+   TlmPack->RadioTlmMid  = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_LORA_RADIO_TLM_TOPICID));
+
+} /* End TLM_PACK_Constructor() */
+
+
+/******************************************************************************
+** Function: TLM_PACK_Pack
+**
+** Notes:
+**   1. The packed payload is limited to one byte less than the payload so
+**      the receiver can tell it's packed. It's encoded into a separate
+**      buffer because an encoder that fails part way has already written
+**      some of it.
+**
+*/
+uint16 TLM_PACK_Pack(const TLM_PACK_Class_t *TlmPack, CFE_MSG_Message_t *Msg, uint16 MsgLen)
+{
+
+   uint8  *Payload = (uint8 *)Msg + TLM_PACK_HDR_LEN;
+   uint8  Packed[sizeof(TlmPayload_t)];
+   uint16 PackedLen = 0;
+   TlmPayload_t   Unpacked;
+   CFE_SB_MsgId_t MsgId = CFE_SB_INVALID_MSG_ID;
+
+   CFE_MSG_GetMsgId(Msg, &MsgId);
+
+   if (CFE_SB_MsgId_Equal(MsgId, TlmPack->StatusTlmMid) && MsgLen == sizeof(LORA_StatusTlm_t))
+   {
+      memcpy(&Unpacked.Status, Payload, sizeof(Unpacked.Status));
+      PackedLen = LORA_PACK_EncodeStatusTlm_Payload(&Unpacked.Status, Packed, sizeof(Unpacked.Status) - 1);
+   }
+   else if (CFE_SB_MsgId_Equal(MsgId, TlmPack->RadioTlmMid) && MsgLen == sizeof(LORA_RadioTlm_t))
+   {
+      memcpy(&Unpacked.Radio, Payload, sizeof(Unpacked.Radio));
+      PackedLen = LORA_PACK_EncodeRadioTlm_Payload(&Unpacked.Radio, Packed, sizeof(Unpacked.Radio) - 1);
+   }
+
+   if (PackedLen > 0)
+   {
+      memcpy(Payload, Packed, PackedLen);
+      MsgLen = TLM_PACK_HDR_LEN + PackedLen;
+      CFE_MSG_SetSize(Msg, MsgLen);
+   }
+
+   return MsgLen;
+
+} /* End TLM_PACK_Pack() */
+
+
+/******************************************************************************
+** Function: TLM_PACK_Unpack
+**
+** Notes:
+**   1. A packed payload must be decoded from exactly its bytes, anything
+**      else means the message isn't one the sender packed.
+**
+*/
+uint16 TLM_PACK_Unpack(const TLM_PACK_Class_t *TlmPack, CFE_MSG_Message_t *Msg, uint16 MsgLen, uint16 MsgMax)
+{
+
+   uint8  *Payload = (uint8 *)Msg + TLM_PACK_HDR_LEN;
+   uint16 PackedLen;
+   uint16 DecodedLen;
+   uint16 UnpackedLen;
+   TlmPayload_t   Unpacked;
+   CFE_SB_MsgId_t MsgId = CFE_SB_INVALID_MSG_ID;
+
+   if (MsgLen <= TLM_PACK_HDR_LEN)
+   {
+      return MsgLen;
+   }
+
+   CFE_MSG_GetMsgId(Msg, &MsgId);
+   PackedLen = MsgLen - TLM_PACK_HDR_LEN;
+   memset(&Unpacked, 0, sizeof(Unpacked));   /* Zero the padding the decoder doesn't write */
+
+   if (CFE_SB_MsgId_Equal(MsgId, TlmPack->StatusTlmMid) && MsgLen < sizeof(LORA_StatusTlm_t))
+   {
+      UnpackedLen = sizeof(LORA_StatusTlm_t);
+      DecodedLen  = LORA_PACK_DecodeStatusTlm_Payload(&Unpacked.Status, Payload, PackedLen);
+   }
+   else if (CFE_SB_MsgId_Equal(MsgId, TlmPack->RadioTlmMid) && MsgLen < sizeof(LORA_RadioTlm_t))
+   {
+      UnpackedLen = sizeof(LORA_RadioTlm_t);
+      DecodedLen  = LORA_PACK_DecodeRadioTlm_Payload(&Unpacked.Radio, Payload, PackedLen);
+   }
+   else
+   {
+      return MsgLen;
+   }
+
+   if (DecodedLen != PackedLen || UnpackedLen > MsgMax)
+   {
+      return 0;
+   }
+
+   memcpy(Payload, &Unpacked, UnpackedLen - TLM_PACK_HDR_LEN);
+   CFE_MSG_SetSize(Msg, UnpackedLen);
+
+   return UnpackedLen;
+
+} /* End TLM_PACK_Unpack() */
@@ -0,0 +1,111 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Define the bridged telemetry packer class
+**
+**  Notes:
+**    1. The app's StatusTlm and RadioTlm messages are bridged with their
+**       payloads bit-packed by the encoders tools/eds_pack_gen.py generates
+**       from lora.xml. Their flags and enumerations take a few bits and
+**       RadioTlm's device path is sent up to its NUL.
+**    2. A packed message is still a software bus message. Its length field
+**       is set to the packed length so the header compressor handles it
+**       like any other message. The receiver knows a message is packed
+**       because it's shorter than its structure, a payload is only packed
+**       when that makes it shorter.
+**    3. A payload the encoder rejects, for example with a field outside its
+**       EDS range, is sent unpacked.
+**    4. An object is used in one direction by one task, the QoS scheduler
+**       packs for the Tx task and the Rx bridge unpacks.
+**
+*/
+
+#ifndef _tlm_pack_
+#define _tlm_pack_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** TLM_PACK_Class
+*/
+typedef struct
+{
+
+   /*
+   ** Class State Data
+   */
+
+   CFE_SB_MsgId_t  StatusTlmMid;
+   CFE_SB_MsgId_t  RadioTlmMid;
+
+} TLM_PACK_Class_t;
+
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: TLM_PACK_Constructor
+**
+** Initialize the Telemetry Packer object to a known state
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**
+*/
+void TLM_PACK_Constructor(TLM_PACK_Class_t *TlmPack, INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: TLM_PACK_Pack
+**
+** Pack the payload of the MsgLen byte message Msg in place and return the
+** message's new length
+**
+** Notes:
+**   1. Returns MsgLen for a message that isn't packed.
+**
+*/
+uint16 TLM_PACK_Pack(const TLM_PACK_Class_t *TlmPack, CFE_MSG_Message_t *Msg, uint16 MsgLen);
+
+
+/******************************************************************************
+** Function: TLM_PACK_Unpack
+**
+** Unpack the payload of the MsgLen byte message Msg in place and return the
+** message's length
+**
+** Notes:
+**   1. Returns MsgLen for a message that isn't packed and 0 for a packed
+**      payload that can't be decoded or doesn't fit MsgMax bytes.
+**
+*/
+uint16 TLM_PACK_Unpack(const TLM_PACK_Class_t *TlmPack, CFE_MSG_Message_t *Msg, uint16 MsgLen, uint16 MsgMax);
+
+
+#endif /* _tlm_pack_ */
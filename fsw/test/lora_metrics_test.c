@@ -0,0 +1,208 @@
+/*
+**  This program is free software: you can redistribute it and/or modify
+**  it under the terms of the GNU Lesser General Public License as
+**  published by the Free Software Foundation, either version 3 of the
+**  License, or (at your option) any later version.
+**
+**  This program is distributed in the hope that it will be useful,
+**  but WITHOUT ANY WARRANTY; without even the implied warranty of
+**  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**  GNU Lesser General Public License for more details.
+**
+**  You should have received a copy of the GNU Lesser General Public License
+**  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+**
+**  Purpose:
+**    Host unit tests for the metrics registry
+**
+**  Notes:
+**    1. Run by ctest, see the app's CMakeLists.txt. Each failed check
+**       prints its location and the program exits with a failure status.
+**    2. OS_GetLocalTime() is replaced by a test clock so the sample
+**       intervals are exact.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdio.h>
+
+#include "lora_metrics.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define CHECK(Cond)  Check((Cond), #Cond, __FILE__, __LINE__)
+
+#define TEST_INTERVAL_USEC  1000000
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void Check(bool Cond, const char *CondStr, const char *File, int Line);
+static void SampleAfter(LORA_METRICS_Sample_t *Sample, int64 Usec);
+static void TestRetransmit(void);
+static void TestRates(void);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static LORA_METRICS_Class_t LoraMetrics;
+
+static OS_time_t TestTime;
+
+static unsigned CheckCnt = 0;
+static unsigned FailCnt  = 0;
+
+
+/******************************************************************************
+** Function: main
+**
+*/
+int main(void)
+{
+
+   TestRetransmit();
+   TestRates();
+
+   printf("lora_metrics_test: %u checks, %u failed\n", CheckCnt, FailCnt);
+
+   return (FailCnt == 0) ? 0 : 1;
+
+} /* End main() */
+
+
+/******************************************************************************
+** Function: OS_GetLocalTime
+**
+** Test clock, see file prologue
+**
+*/
+int32 OS_GetLocalTime(OS_time_t *time_struct)
+{
+
+   *time_struct = TestTime;
+
+   return OS_SUCCESS;
+
+} /* End OS_GetLocalTime() */
+
+
+/******************************************************************************
+** Function: TestRetransmit
+**
+** The retransmit counter reaches the sample as parts per thousand of the
+** frames sent in the interval, summed over every radio
+**
+*/
+static void TestRetransmit(void)
+{
+
+   LORA_METRICS_Sample_t Sample;
+
+   LORA_METRICS_Constructor(&LoraMetrics);
+
+   SampleAfter(&Sample, TEST_INTERVAL_USEC);
+   CHECK(Sample.TxFrameCnt == 0);
+   CHECK(Sample.RetransmitPpt == 0);
+
+   LORA_METRICS_Add(0, LORA_METRICS_TASK_TX, LORA_METRICS_TX_FRAME, 6);
+   LORA_METRICS_Add(1, LORA_METRICS_TASK_TX, LORA_METRICS_TX_FRAME, 2);
+   LORA_METRICS_Add(0, LORA_METRICS_TASK_TX, LORA_METRICS_TX_RETRANSMIT, 1);
+   LORA_METRICS_Add(1, LORA_METRICS_TASK_TX, LORA_METRICS_TX_RETRANSMIT, 1);
+
+   SampleAfter(&Sample, TEST_INTERVAL_USEC);
+   CHECK(Sample.TxFrameCnt == 8);
+   CHECK(Sample.RetransmitPpt == 250);
+
+   /* Rates only cover the interval since the previous sample */
+   LORA_METRICS_Add(0, LORA_METRICS_TASK_TX, LORA_METRICS_TX_FRAME, 4);
+
+   SampleAfter(&Sample, TEST_INTERVAL_USEC);
+   CHECK(Sample.TxFrameCnt == 12);
+   CHECK(Sample.RetransmitPpt == 0);
+
+   LORA_METRICS_Add(0, LORA_METRICS_TASK_TX, LORA_METRICS_TX_FRAME, 1);
+   LORA_METRICS_Add(0, LORA_METRICS_TASK_TX, LORA_METRICS_TX_RETRANSMIT, 1);
+
+   SampleAfter(&Sample, TEST_INTERVAL_USEC);
+   CHECK(Sample.RetransmitPpt == 1000);
+
+   LORA_METRICS_ResetStatus();
+
+   SampleAfter(&Sample, TEST_INTERVAL_USEC);
+   CHECK(Sample.TxFrameCnt == 0);
+   CHECK(Sample.RetransmitPpt == 0);
+
+} /* End TestRetransmit() */
+
+
+/******************************************************************************
+** Function: TestRates
+**
+*/
+static void TestRates(void)
+{
+
+   LORA_METRICS_Sample_t Sample;
+
+   LORA_METRICS_Constructor(&LoraMetrics);
+
+   LORA_METRICS_Add(0, LORA_METRICS_TASK_TX, LORA_METRICS_TX_DATA_BYTE, 500);
+   LORA_METRICS_Add(0, LORA_METRICS_TASK_RADIO, LORA_METRICS_TX_AIR_USEC, 200000);
+   LORA_METRICS_Add(0, LORA_METRICS_TASK_RADIO, LORA_METRICS_RX_AIR_USEC, 50000);
+   LORA_METRICS_SetPeak(0, LORA_METRICS_TASK_RADIO, LORA_METRICS_RADIO_QUEUE_PEAK, 3);
+   LORA_METRICS_SetPeak(1, LORA_METRICS_TASK_RADIO, LORA_METRICS_RADIO_QUEUE_PEAK, 2);
+
+   SampleAfter(&Sample, TEST_INTERVAL_USEC);
+   CHECK(Sample.TxGoodputBps == 4000);
+   CHECK(Sample.AirtimePpt == 250);
+   CHECK(Sample.RadioQueuePeak == 3);
+
+   /* The sampler clears the gauges */
+   SampleAfter(&Sample, TEST_INTERVAL_USEC);
+   CHECK(Sample.TxGoodputBps == 0);
+   CHECK(Sample.RadioQueuePeak == 0);
+
+} /* End TestRates() */
+
+
+/******************************************************************************
+** Function: SampleAfter
+**
+** Advance the test clock by Usec and take a sample
+**
+*/
+static void SampleAfter(LORA_METRICS_Sample_t *Sample, int64 Usec)
+{
+
+   TestTime = OS_TimeAdd(TestTime, OS_TimeFromTotalMicroseconds(Usec));
+
+   LORA_METRICS_Sample(Sample);
+
+} /* End SampleAfter() */
+
+
+/******************************************************************************
+** Function: Check
+**
+*/
+static void Check(bool Cond, const char *CondStr, const char *File, int Line)
+{
+
+   CheckCnt++;
+   if (!Cond)
+   {
+      FailCnt++;
+      printf("%s:%d: check failed: %s\n", File, Line, CondStr);
+   }
+
+} /* End Check() */
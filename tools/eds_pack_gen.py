@@ -0,0 +1,693 @@
+#!/usr/bin/env python3
+#
+#  This program is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU Lesser General Public License as
+#  published by the Free Software Foundation, either version 3 of the
+#  License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU Lesser General Public License for more details.
+#
+#  You should have received a copy of the GNU Lesser General Public License
+#  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+#  Purpose:
+#    Generate bit-packed encoders and decoders for an EDS package's payload
+#    containers
+#
+#  Notes:
+#    1. Usage:
+#         eds_pack_gen.py [-o OUT_DIR] [--test] [--typedefs] PKG_EDS [DEP_EDS ...]
+#       writes <pkg>_eds_pack.h and <pkg>_eds_pack.c for every container in
+#       PKG_EDS that isn't derived from another container, i.e. the command
+#       and telemetry payloads and the containers they use. DEP_EDS are the
+#       EDS files of the packages PKG_EDS refers to (APP_C_FW, SX128X). The
+#       BASE_TYPES integers and strings are built in.
+#    2. Each field is packed in the fewest bits its EDS type allows:
+#       - An enumeration with consecutive values is sent as the offset from
+#         its lowest value, otherwise as the index of its label. SX128X
+#         spreading factors 0x50-0xC0 take 3 bits.
+#       - An integer type with a Range is sent as the offset from its
+#         minimum, a BASE_TYPES integer in its full width.
+#       - A string is sent up to its terminating NUL.
+#    3. The fields' widths are constants in the generated code so each
+#       field is a specialized inline call of bit_pack.h, there's no table
+#       walked at run time.
+#    4. An encoder returns 0 for a field outside its type's range so the
+#       caller can send the payload unpacked. A decoder returns 0 for a
+#       value outside the range or a short input.
+#    5. --test also writes <pkg>_eds_pack_test.c, a program that round-trips
+#       every container with each field at its minimum, at its maximum and
+#       at each enumeration value, and checks that out of range fields,
+#       short buffers and short inputs are rejected.
+#    6. --typedefs also writes <pkg>_eds_typedefs.h with the containers' C
+#       structures and the cFE integer type names so the encoders and the
+#       test build on a host without the EDS tool chain. The link core test
+#       uses it with link_core/test/pack_test.xml.
+#
+
+import argparse
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+NS = '{http://www.ccsds.org/schema/sois/seds}'
+
+
+def int_limits(bits, signed):
+    return (-(1 << (bits - 1)), (1 << (bits - 1)) - 1) if signed else (0, (1 << bits) - 1)
+
+
+class IntType:
+    def __init__(self, bits, signed, lo=None, hi=None):
+        self.bits, self.signed = bits, signed
+        tlo, thi = int_limits(bits, signed)
+        self.lo = lo if lo is not None else tlo
+        self.hi = hi if hi is not None else thi
+        self.ranged = lo is not None or hi is not None
+
+
+class EnumType:
+    def __init__(self, name, values, bits=32, signed=True):
+        self.name, self.values = name, sorted(set(values))
+        self.bits, self.signed = bits, signed   # C type, see note 6
+
+
+class FloatType:
+    def __init__(self, bits):
+        self.bits = bits
+
+
+class StringType:
+    def __init__(self, length=None):
+        self.length = length
+
+
+class ArrayType:
+    def __init__(self, elem, size):
+        self.elem, self.size = elem, size
+
+
+class ContainerType:
+    def __init__(self, pkg, name, entries):
+        self.pkg, self.name, self.entries = pkg, name, entries
+
+    @property
+    def cname(self):
+        return '%s_%s_t' % (self.pkg, self.name)
+
+
+BASE_TYPES = {
+    'uint8':  IntType(8, False),  'int8':  IntType(8, True),
+    'uint16': IntType(16, False), 'int16': IntType(16, True),
+    'uint32': IntType(32, False), 'int32': IntType(32, True),
+    'uint64': IntType(64, False), 'int64': IntType(64, True),
+    'float':  FloatType(32),      'double': FloatType(64),
+    'PathName': StringType(64), 'FileName': StringType(64), 'ApiName': StringType(20),
+}
+
+
+def width(span):
+    """Bits needed for the values 0 to span"""
+    return max(1, span.bit_length())
+
+
+def c_int(v):
+    """C literal of an integer value of any width"""
+    if v == -(1 << 63):
+        return '(-%dLL - 1)' % ((1 << 63) - 1)
+    if v > (1 << 63) - 1:
+        return '%dULL' % v
+    if v < -(1 << 31) or v > (1 << 31) - 1:
+        return '%dLL' % v
+    return '%d' % v
+
+
+def sweep_cnt(t):
+    """Most enumeration values of any field in a type"""
+    if isinstance(t, EnumType):
+        return len(t.values)
+    if isinstance(t, ArrayType):
+        return sweep_cnt(t.elem)
+    if isinstance(t, ContainerType):
+        return max([1] + [sweep_cnt(et) for _, et in t.entries])
+    return 1
+
+
+class Eds:
+
+    def __init__(self, files):
+        self.elems = {}   # (Package, Name) -> DataTypeSet element
+        self.types = {}
+        self.pkgs = []
+        for f in files:
+            root = ET.parse(f).getroot()
+            for pkg in root.iter(NS + 'Package'):
+                self.pkgs.append(pkg.get('name'))
+                dts = pkg.find(NS + 'DataTypeSet')
+                for e in (dts if dts is not None else []):
+                    self.elems[(pkg.get('name'), e.get('name'))] = e
+
+    def resolve(self, ref, pkg):
+        p, _, n = ref.rpartition('/')
+        p = p or pkg
+        if p == 'BASE_TYPES' and (p, n) not in self.elems:
+            if n not in BASE_TYPES:
+                sys.exit('eds_pack_gen: unsupported base type %s' % ref)
+            return BASE_TYPES[n]
+        key = (p, n)
+        if key not in self.types:
+            if key not in self.elems:
+                sys.exit('eds_pack_gen: %s/%s not found, add its package EDS file' % key)
+            self.types[key] = self.build(self.elems[key], p)
+        return self.types[key]
+
+    def build(self, e, pkg):
+        tag, name = e.tag[len(NS):], e.get('name')
+        if tag == 'IntegerDataType':
+            enc = e.find(NS + 'IntegerDataEncoding')
+            bits = int(enc.get('sizeInBits'))
+            signed = enc.get('encoding', 'unsigned') != 'unsigned'
+            lo = hi = None
+            rng = e.find(NS + 'Range/' + NS + 'MinMaxRange')
+            if rng is not None:
+                kind = rng.get('rangeType', 'inclusiveMinInclusiveMax')
+                if rng.get('min') is not None:
+                    lo = int(rng.get('min'), 0) + (0 if kind.startswith('inclusiveMin') else 1)
+                if rng.get('max') is not None:
+                    hi = int(rng.get('max'), 0) - (0 if kind.endswith('InclusiveMax') else 1)
+            return IntType(bits, signed, lo, hi)
+        if tag == 'EnumeratedDataType':
+            vals = [int(x.get('value'), 0) for x in e.iter(NS + 'Enumeration')]
+            enc = e.find(NS + 'IntegerDataEncoding')
+            if enc is None:
+                return EnumType('%s_%s' % (pkg, name), vals)
+            return EnumType('%s_%s' % (pkg, name), vals, int(enc.get('sizeInBits')),
+                            enc.get('encoding', 'unsigned') != 'unsigned')
+        if tag == 'BooleanDataType':
+            enc = e.find(NS + 'BooleanDataEncoding')
+            return EnumType('%s_%s' % (pkg, name), [0, 1], int(enc.get('sizeInBits')) if enc is not None else 8, False)
+        if tag == 'FloatDataType':
+            enc = e.find(NS + 'FloatDataEncoding')
+            return FloatType(64 if enc is not None and enc.get('encodingAndPrecision', '').endswith('Double') else 32)
+        if tag == 'StringDataType':
+            return StringType(int(e.get('length'), 0) if e.get('length') else None)
+        if tag == 'ArrayDataType':
+            dims = e.findall(NS + 'DimensionList/' + NS + 'Dimension')
+            if len(dims) != 1:
+                sys.exit('eds_pack_gen: %s/%s must have one dimension' % (pkg, name))
+            return ArrayType(self.resolve(e.get('dataTypeRef'), pkg), int(dims[0].get('size'), 0))
+        if tag == 'ContainerDataType':
+            entries = []
+            el = e.find(NS + 'EntryList')
+            for en in (el if el is not None else []):
+                etag = en.tag[len(NS):]
+                if etag == 'PaddingEntry':
+                    continue
+                if etag != 'Entry':
+                    sys.exit('eds_pack_gen: %s/%s %s entries are not supported' % (pkg, name, etag))
+                entries.append((en.get('name'), self.resolve(en.get('type'), pkg)))
+            return ContainerType(pkg, name, entries)
+        sys.exit('eds_pack_gen: %s/%s %s is not supported' % (pkg, name, tag))
+
+
+class Gen:
+
+    def __init__(self, pkg):
+        self.pkg = pkg
+        self.tables = {}   # Sparse enumeration value tables used by the decoders
+
+    def bits(self, t):
+        """Packed bits of a fixed length type, None for a string"""
+        if isinstance(t, IntType):
+            return width(t.hi - t.lo) if t.ranged else t.bits
+        if isinstance(t, EnumType):
+            return width(self.span(t))
+        if isinstance(t, FloatType):
+            return t.bits
+        if isinstance(t, ArrayType):
+            b = self.bits(t.elem)
+            return None if b is None else b * t.size
+        if isinstance(t, ContainerType):
+            total = 0
+            for _, et in t.entries:
+                b = self.bits(et)
+                if b is None:
+                    return None
+                total += b
+            return total
+        return None
+
+    @staticmethod
+    def consecutive(t):
+        return t.values[-1] - t.values[0] + 1 == len(t.values)
+
+    def span(self, t):
+        return t.values[-1] - t.values[0] if self.consecutive(t) else len(t.values) - 1
+
+    def put(self, w, value, bits, out):
+        if bits <= 32:
+            out.append('%sBIT_PACK_Put(W, (uint32)(%s), %d);' % (w, value, bits))
+        else:
+            out.append('%sBIT_PACK_Put(W, (uint32)((uint64)(%s) >> 32), %d);' % (w, value, bits - 32))
+            out.append('%sBIT_PACK_Put(W, (uint32)(%s), 32);' % (w, value))
+
+    def get(self, w, var, bits, out):
+        """Read a field into var, a 64 bit field's halves in separate statements so they're read in order"""
+        if bits <= 32:
+            out.append('%s%s = BIT_PACK_Get(R, %d);' % (w, var, bits))
+        else:
+            out.append('%s%s = (uint64)BIT_PACK_Get(R, %d) << 32;' % (w, var, bits - 32))
+            out.append('%s%s |= BIT_PACK_Get(R, 32);' % (w, var))
+
+    def range_check(self, w, x, lo, hi, tlo, thi, out):
+        """Check the bounds that are tighter than the C type's tlo and thi"""
+        conds = []
+        if lo > tlo:
+            conds.append('%s < %s' % (x, c_int(lo)))
+        if hi < thi:
+            conds.append('%s > %s' % (x, c_int(hi)))
+        if conds:
+            out.append('%sif (%s) return false;' % (w, ' || '.join(conds)))
+
+    def encode(self, t, x, w, depth, out):
+        if isinstance(t, IntType):
+            if t.ranged:
+                self.range_check(w, x, t.lo, t.hi, *int_limits(t.bits, t.signed), out=out)
+                self.put(w, '%s - %s' % (x, c_int(t.lo)) if t.lo else x, self.bits(t), out)
+            else:
+                self.put(w, x, t.bits, out)
+        elif isinstance(t, EnumType):
+            lo, bits = t.values[0], self.bits(t)
+            if self.consecutive(t):
+                tlo = 0 if lo >= 0 else lo - 1
+                self.range_check(w, x, lo, t.values[-1], tlo, t.values[-1] + 1, out)
+                self.put(w, '%s - %d' % (x, lo) if lo else x, bits, out)
+            else:
+                out.append('%sswitch (%s)' % (w, x))
+                out.append('%s{' % w)
+                for i, v in enumerate(t.values):
+                    out.append('%s   case %d: V = %d; break;' % (w, v, i))
+                out.append('%s   default: return false;' % w)
+                out.append('%s}' % w)
+                self.put(w, 'V', bits, out)
+        elif isinstance(t, FloatType):
+            ut = 'uint32' if t.bits == 32 else 'uint64'
+            out.append('%s{ %s F; memcpy(&F, &%s, sizeof(F));' % (w, ut, x))
+            self.put(w + '  ', 'F', t.bits, out)
+            out.append('%s}' % w)
+        elif isinstance(t, StringType):
+            out.append('%sfor (i = 0; i < sizeof(%s) && %s[i] != \'\\0\'; i++) BIT_PACK_Put(W, (uint8)%s[i], 8);' % (w, x, x, x))
+            out.append('%sif (i < sizeof(%s)) BIT_PACK_Put(W, 0, 8);' % (w, x))
+        elif isinstance(t, ArrayType):
+            i = 'i%d' % depth
+            out.append('%sfor (%s = 0; %s < %d; %s++)' % (w, i, i, t.size, i))
+            out.append('%s{' % w)
+            self.encode(t.elem, '%s[%s]' % (x, i), w + '   ', depth + 1, out)
+            out.append('%s}' % w)
+        elif isinstance(t, ContainerType):
+            out.append('%sif (!Pack%s(W, &%s)) return false;' % (w, self.fname(t), x))
+
+    def decode(self, t, x, w, depth, out):
+        if isinstance(t, IntType):
+            bits = self.bits(t)
+            if t.ranged:
+                self.get(w, 'V', bits, out)
+                if (1 << bits) - 1 > t.hi - t.lo:
+                    out.append('%sif (V > %s) return false;' % (w, c_int(t.hi - t.lo)))
+                out.append('%s%s = (int64)V + %s;' % (w, x, c_int(t.lo)) if t.lo else '%s%s = V;' % (w, x))
+            elif t.signed:
+                self.get(w, 'V', bits, out)
+                out.append('%s%s = (int%d)V;' % (w, x, t.bits))
+            elif bits > 32:
+                self.get(w, 'V', bits, out)
+                out.append('%s%s = V;' % (w, x))
+            else:
+                self.get(w, x, bits, out)
+        elif isinstance(t, EnumType):
+            bits = self.bits(t)
+            self.get(w, 'V', bits, out)
+            if (1 << bits) - 1 > self.span(t):
+                out.append('%sif (V > %d) return false;' % (w, self.span(t)))
+            if self.consecutive(t):
+                lo = t.values[0]
+                out.append('%s%s = (int64)V + %d;' % (w, x, lo) if lo else '%s%s = V;' % (w, x))
+            else:
+                self.tables[t.name] = t.values
+                out.append('%s%s = %s_Val[V];' % (w, x, t.name))
+        elif isinstance(t, FloatType):
+            ut = 'uint32' if t.bits == 32 else 'uint64'
+            out.append('%s{ %s F;' % (w, ut))
+            self.get(w + '  ', 'F', t.bits, out)
+            out.append('%s  memcpy(&%s, &F, sizeof(F));' % (w, x))
+            out.append('%s}' % w)
+        elif isinstance(t, StringType):
+            out.append('%sfor (i = 0; i < sizeof(%s); i++)' % (w, x))
+            out.append('%s{' % w)
+            out.append('%s   %s[i] = (char)BIT_PACK_Get(R, 8);' % (w, x))
+            out.append('%s   if (%s[i] == \'\\0\') break;' % (w, x))
+            out.append('%s}' % w)
+            out.append('%sfor (; i < sizeof(%s); i++) %s[i] = \'\\0\';' % (w, x, x))
+        elif isinstance(t, ArrayType):
+            i = 'i%d' % depth
+            out.append('%sfor (%s = 0; %s < %d; %s++)' % (w, i, i, t.size, i))
+            out.append('%s{' % w)
+            self.decode(t.elem, '%s[%s]' % (x, i), w + '   ', depth + 1, out)
+            out.append('%s}' % w)
+        elif isinstance(t, ContainerType):
+            out.append('%sif (!Unpack%s(R, &%s)) return false;' % (w, self.fname(t), x))
+
+    @staticmethod
+    def locals(body, out):
+        """Declare the loop and value variables a function body uses"""
+        text = '\n'.join(body)
+        idx = sorted(set(re.findall(r'\b(i\d+)\b', text)))
+        if re.search(r'\bi\b', text):
+            idx.insert(0, 'i')
+        if idx:
+            out.append('   uint32 %s;' % ', '.join(idx))
+        if re.search(r'\bV = \(uint64\)', text):
+            out.append('   uint64 V;')
+        elif re.search(r'\bV\b', text):
+            out.append('   uint32 V;')
+        if idx or re.search(r'\bV\b', text):
+            out.append('')
+
+    def fname(self, c):
+        return c.name if c.pkg == self.pkg else '%s_%s' % (c.pkg, c.name)
+
+    def container_funcs(self, c):
+        n = self.fname(c)
+        enc, dec = [], []
+        for name, t in c.entries:
+            self.encode(t, 'In->' + name, '   ', 0, enc)
+            self.decode(t, 'Out->' + name, '   ', 0, dec)
+        out = ['static bool Pack%s(BIT_PACK_Writer_t *W, const %s *In)' % (n, c.cname), '{', '']
+        self.locals(enc, out)
+        out += enc + ['', '   return true;', '', '} /* End Pack%s() */' % n, '', '']
+        out += ['static bool Unpack%s(BIT_PACK_Reader_t *R, %s *Out)' % (n, c.cname), '{', '']
+        self.locals(dec, out)
+        out += dec + ['', '   return true;', '', '} /* End Unpack%s() */' % n, '', '']
+        return out
+
+
+class TestGen:
+    """Round-trip test program, see note 5"""
+
+    def __init__(self, gen):
+        self.gen = gen
+        self.tables = {}   # Enumeration values the fill functions pick from
+
+    def fill(self, t, x, w, depth, out):
+        """Set a field to its minimum for fill 0, its maximum for fill 1 and sweep the enumerations after that"""
+        if isinstance(t, IntType):
+            out.append('%s%s = (k & 1) ? %s : %s;' % (w, x, c_int(t.hi), c_int(t.lo)))
+        elif isinstance(t, EnumType):
+            n = len(t.values)
+            self.tables[t.name] = t.values
+            out.append('%s%s = %s_Val[k < 2 ? k * %d : (k - 2) %% %d];' % (w, x, t.name, n - 1, n))
+        elif isinstance(t, FloatType):
+            out.append('%s%s = (k & 1) ? 3.25e10 : -1.5 - (double)k;' % (w, x))
+        elif isinstance(t, StringType):
+            out.append('%sFillString(%s, sizeof(%s), k);' % (w, x, x))
+        elif isinstance(t, ArrayType):
+            i = 'i%d' % depth
+            out.append('%sfor (%s = 0; %s < %d; %s++)' % (w, i, i, t.size, i))
+            out.append('%s{' % w)
+            self.fill(t.elem, '%s[%s]' % (x, i), w + '   ', depth + 1, out)
+            out.append('%s}' % w)
+        elif isinstance(t, ContainerType):
+            out.append('%sFill%s(&%s, k);' % (w, self.gen.fname(t), x))
+
+    def bad(self, t, x, cases):
+        """Out of range values the encoder must reject as (field, value)"""
+        if isinstance(t, IntType) and t.ranged:
+            tlo, thi = int_limits(t.bits, t.signed)
+            if t.lo > tlo:
+                cases.append((x, t.lo - 1))
+            if t.hi < thi:
+                cases.append((x, t.hi + 1))
+        elif isinstance(t, EnumType):
+            if t.values[0] != 0:
+                cases.append((x, t.values[0] - 1))
+            gaps = [v for v in range(t.values[0], t.values[-1]) if v not in t.values]
+            if gaps:
+                cases.append((x, gaps[0]))
+            cases.append((x, t.values[-1] + 1))
+        elif isinstance(t, ArrayType):
+            self.bad(t.elem, '%s[0]' % x, cases)
+        elif isinstance(t, ContainerType):
+            for name, et in t.entries:
+                self.bad(et, '%s.%s' % (x, name), cases)
+
+    def fill_func(self, c):
+        n = self.gen.fname(c)
+        body = []
+        for name, t in c.entries:
+            self.fill(t, 'Payload->' + name, '   ', 0, body)
+        out = ['static void Fill%s(%s *Payload, uint32 k)' % (n, c.cname), '{', '']
+        Gen.locals(body, out)
+        if not body:
+            body = ['   (void)Payload;', '   (void)k;']
+        out += body + ['', '} /* End Fill%s() */' % n, '', '']
+        return out
+
+    def len_check(self, c):
+        b = self.gen.bits(c)
+        return 'Len > 0' if b is None else 'Len == %d' % ((b + 7) // 8)
+
+    def test_func(self, P, c):
+        cases = []
+        for name, t in c.entries:
+            self.bad(t, 'In.' + name, cases)
+        out = ['static void Test%s(void)' % c.name, '{', '',
+               '   %s In;' % c.cname,
+               '   %s Out;' % c.cname,
+               '   uint8  Buf[sizeof(%s)];' % c.cname,
+               '   uint16 Len;',
+               '   uint32 k;', '',
+               '   for (k = 0; k < %d; k++)' % (2 + sweep_cnt(c)),
+               '   {',
+               '      memset(&In, 0, sizeof(In));',
+               '      memset(&Out, 0, sizeof(Out));',
+               '      Fill%s(&In, k);' % self.gen.fname(c),
+               '      Len = %s_PACK_Encode%s(&In, Buf, sizeof(Buf));' % (P, c.name),
+               '      Check(%s, "%s", "encode", k);' % (self.len_check(c), c.name),
+               '      Check(%s_PACK_Decode%s(&Out, Buf, Len) == Len, "%s", "decode", k);' % (P, c.name, c.name),
+               '      Check(memcmp(&In, &Out, sizeof(In)) == 0, "%s", "round trip", k);' % c.name,
+               '      if (Len > 1)',
+               '      {',
+               '         Check(%s_PACK_Encode%s(&In, Buf, Len - 1) == 0, "%s", "short buffer", k);' % (P, c.name, c.name),
+               '         Check(%s_PACK_Decode%s(&Out, Buf, Len - 1) == 0, "%s", "short input", k);' % (P, c.name, c.name),
+               '      }',
+               '   }']
+        for x, v in cases:
+            cast = 'uint64' if v > (1 << 63) - 1 else 'int64'
+            out += ['',
+                    '   memset(&In, 0, sizeof(In));',
+                    '   Fill%s(&In, 0);' % self.gen.fname(c),
+                    '   %s = %s;' % (x, c_int(v)),
+                    '   if ((%s)%s == %s)' % (cast, x, c_int(v)),
+                    '   {',
+                    '      Check(%s_PACK_Encode%s(&In, Buf, sizeof(Buf)) == 0, "%s", "%s = %d rejected", 0);'
+                    % (P, c.name, c.name, x[3:], v),
+                    '   }']
+        out += ['', '} /* End Test%s() */' % c.name, '', '']
+        return out
+
+    def source(self, P, pkg, src, containers, used):
+        fills, tests = [], []
+        for c in used:
+            fills += self.fill_func(c)
+        for c in containers:
+            tests += self.test_func(P, c)
+        s = banner('Round-trip test of the %s bit-packed payload encoders and decoders' % P, src)
+        s += ['#include <stdio.h>', '#include <string.h>', '#include "%s_eds_pack.h"' % pkg.lower(), '', '']
+        for name, vals in sorted(self.tables.items()):
+            s.append('static const int64 %s_Val[] = { %s };' % (name, ', '.join(c_int(v) for v in vals)))
+        if self.tables:
+            s += ['', '']
+        s += ['static uint32 CheckCnt;', 'static uint32 FailCnt;', '', '']
+        s += ['static void Check(bool Pass, const char *Container, const char *What, uint32 k)', '{', '',
+              '   CheckCnt++;',
+              '   if (!Pass)',
+              '   {',
+              '      FailCnt++;',
+              '      printf("FAIL %s: %s, fill %u\\n", Container, What, (unsigned)k);',
+              '   }', '',
+              '} /* End Check() */', '', '']
+        s += ['/* No characters for fill 0, all of them with no NUL for fill 1 */',
+              'static void FillString(char *Str, uint32 Size, uint32 k)', '{', '',
+              '   uint32 Len = (k == 0) ? 0 : (k == 1) ? Size : (k - 2) % (Size + 1);',
+              '   uint32 i;', '',
+              '   memset(Str, 0, Size);',
+              '   for (i = 0; i < Len; i++) Str[i] = (char)(\'A\' + i % 26);', '',
+              '} /* End FillString() */', '', '']
+        for c in used:
+            s.append('static void Fill%s(%s *Payload, uint32 k);' % (self.gen.fname(c), c.cname))
+        s += ['', ''] + fills + tests
+        s += ['int main(void)', '{', '']
+        s += ['   Test%s();' % c.name for c in containers]
+        s += ['',
+              '   printf("%s_eds_pack_test: %%u checks, %%u failed\\n", (unsigned)CheckCnt, (unsigned)FailCnt);' % pkg.lower(),
+              '',
+              '   return (FailCnt == 0) ? 0 : 1;', '',
+              '} /* End main() */']
+        return s
+
+
+def cdecl(gen, t, name):
+    """C declaration of a structure member"""
+    dims = ''
+    while isinstance(t, ArrayType):
+        dims += '[%d]' % t.size
+        t = t.elem
+    if isinstance(t, (IntType, EnumType)):
+        ctype = '%sint%d' % ('' if t.signed else 'u', t.bits)
+    elif isinstance(t, FloatType):
+        ctype = 'float' if t.bits == 32 else 'double'
+    elif isinstance(t, StringType):
+        if t.length is None:
+            sys.exit('eds_pack_gen: --typedefs needs the length of every string type')
+        ctype, dims = 'char', dims + '[%d]' % t.length
+    else:
+        ctype = t.cname
+    return '   %-8s %s%s;' % (ctype, name, dims)
+
+
+def typedefs(gen, pkg, src, used):
+    """Host build structures, see note 6"""
+    order = []
+
+    def visit(c):
+        if c in order:
+            return
+        for _, t in c.entries:
+            while isinstance(t, ArrayType):
+                t = t.elem
+            if isinstance(t, ContainerType):
+                visit(t)
+        order.append(c)
+
+    for c in used:
+        visit(c)
+
+    guard = '_%s_eds_typedefs_' % pkg.lower()
+    h = banner('Define the %s payload structures for a host build without the EDS tool chain' % pkg.upper(), src)
+    h += ['#ifndef %s' % guard, '#define %s' % guard, '',
+          '#include <stdbool.h>', '#include <stdint.h>', '', '',
+          '/* cFE common_types.h names */']
+    for bits in (8, 16, 32, 64):
+        h.append('typedef %-9s uint%d;' % ('uint%d_t' % bits, bits))
+        h.append('typedef %-9s int%d;' % ('int%d_t' % bits, bits))
+    h += ['', '']
+    for c in order:
+        h += ['typedef struct', '{']
+        h += [cdecl(gen, t, name) for name, t in c.entries] or ['   uint8    Spare;']
+        h += ['} %s;' % c.cname, '', '']
+    h += ['#endif /* %s */' % guard]
+    return h
+
+
+def banner(purpose, src):
+    return ['/*',
+            '** Purpose:',
+            '**   %s' % purpose,
+            '**',
+            '** Notes:',
+            '**   1. Generated by tools/eds_pack_gen.py from %s, do not edit.' % src,
+            '**',
+            '*/', '']
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Generate bit-packed EDS payload encoders and decoders')
+    ap.add_argument('-o', '--out-dir', default='.')
+    ap.add_argument('--test', action='store_true', help='also write the round-trip test program')
+    ap.add_argument('--typedefs', action='store_true', help='also write host build structures')
+    ap.add_argument('pkg_eds')
+    ap.add_argument('dep_eds', nargs='*')
+    args = ap.parse_args()
+
+    eds = Eds([args.pkg_eds] + args.dep_eds)
+    pkg = eds.pkgs[0]
+    P = pkg.upper()
+    src = os.path.basename(args.pkg_eds)
+
+    containers = [eds.resolve(n, pkg) for (p, n), e in eds.elems.items()
+                  if p == pkg and e.tag == NS + 'ContainerDataType' and e.get('baseType') is None]
+
+    # Containers of other packages used by the payloads get local functions
+    used = list(containers)
+    for c in used:
+        for _, t in c.entries:
+            while isinstance(t, ArrayType):
+                t = t.elem
+            if isinstance(t, ContainerType) and t not in used:
+                used.append(t)
+
+    gen = Gen(pkg)
+    funcs = []
+    for c in used:
+        funcs += gen.container_funcs(c)
+
+    guard = '_%s_eds_pack_' % pkg.lower()
+    h = banner('Define the %s bit-packed payload encoders and decoders' % P, src)
+    h += ['#ifndef %s' % guard, '#define %s' % guard, '',
+          '#include "%s_eds_typedefs.h"' % pkg.lower(), '', '']
+    h += ['/*',
+          '** Encode returns the packed length or 0 if a field is out of its range or',
+          '** the packed payload is longer than BufLen. Decode returns the number of',
+          '** bytes read or 0 if the input is short or a field is out of its range.',
+          '** A packed payload is never longer than its structure.',
+          '*/', '']
+    for c in containers:
+        b = gen.bits(c)
+        size = ('%d bit' if b == 1 else '%d bits') % b if b is not None else 'variable length'
+        h.append('/* %s_%s: %s */' % (P, c.name, size))
+        h.append('uint16 %s_PACK_Encode%s(const %s *Payload, uint8 *Buf, uint16 BufLen);' % (P, c.name, c.cname))
+        h.append('uint16 %s_PACK_Decode%s(%s *Payload, const uint8 *Buf, uint16 BufLen);' % (P, c.name, c.cname))
+        h.append('')
+    h += ['', '#endif /* %s */' % guard]
+
+    s = banner('Implement the %s bit-packed payload encoders and decoders' % P, src)
+    s += ['#include <string.h>', '#include "bit_pack.h"', '#include "%s_eds_pack.h"' % pkg.lower(), '', '']
+    for name, vals in sorted(gen.tables.items()):
+        s.append('static const int32 %s_Val[] = { %s };' % (name, ', '.join(str(v) for v in vals)))
+    if gen.tables:
+        s += ['', '']
+    for c in used:
+        s.append('static bool Pack%s(BIT_PACK_Writer_t *W, const %s *In);' % (gen.fname(c), c.cname))
+        s.append('static bool Unpack%s(BIT_PACK_Reader_t *R, %s *Out);' % (gen.fname(c), c.cname))
+    s += ['', '']
+    for c in containers:
+        s += ['uint16 %s_PACK_Encode%s(const %s *Payload, uint8 *Buf, uint16 BufLen)' % (P, c.name, c.cname), '{', '',
+              '   BIT_PACK_Writer_t W;', '',
+              '   BIT_PACK_WriterInit(&W, Buf, BufLen);', '',
+              '   return Pack%s(&W, Payload) ? BIT_PACK_WriterEnd(&W) : 0;' % c.name, '',
+              '} /* End %s_PACK_Encode%s() */' % (P, c.name), '', '']
+        s += ['uint16 %s_PACK_Decode%s(%s *Payload, const uint8 *Buf, uint16 BufLen)' % (P, c.name, c.cname), '{', '',
+              '   BIT_PACK_Reader_t R;', '',
+              '   BIT_PACK_ReaderInit(&R, Buf, BufLen);', '',
+              '   return Unpack%s(&R, Payload) ? BIT_PACK_ReaderEnd(&R) : 0;' % c.name, '',
+              '} /* End %s_PACK_Decode%s() */' % (P, c.name), '', '']
+    s += funcs
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    with open(os.path.join(args.out_dir, '%s_eds_pack.h' % pkg.lower()), 'w') as f:
+        f.write('\n'.join(h) + '\n')
+    with open(os.path.join(args.out_dir, '%s_eds_pack.c' % pkg.lower()), 'w') as f:
+        f.write('\n'.join(s) + '\n')
+    if args.test:
+        with open(os.path.join(args.out_dir, '%s_eds_pack_test.c' % pkg.lower()), 'w') as f:
+            f.write('\n'.join(TestGen(gen).source(P, pkg, src, containers, used)) + '\n')
+    if args.typedefs:
+        with open(os.path.join(args.out_dir, '%s_eds_typedefs.h' % pkg.lower()), 'w') as f:
+            f.write('\n'.join(typedefs(gen, pkg, src, used)) + '\n')
+
+
+if __name__ == '__main__':
+    main()